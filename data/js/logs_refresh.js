@@ -12,7 +12,8 @@ class LogViewer {
 		
 		this.autoScrollEnabled = false;
 		this.autoRefreshInterval = null;
-		this.lastTimestamp = 0;
+		this.eventSource = null;
+		this.lastSequence = 0;
 		
 		this.initializeEventListeners();
 		this.loadLogs();
@@ -50,10 +51,8 @@ class LogViewer {
 			this.displayLogs(data.logs || []);
 			this.updateStatus(data.stats || {});
 			
-			// Update last timestamp for incremental updates
-			if (data.logs && data.logs.length > 0) {
-				this.lastTimestamp = Math.max(...data.logs.map(log => log.timestamp));
-			}
+			// Remember the last sequence for incremental updates
+			this.lastSequence = data.last_sequence || 0;
 			
 		} catch (error) {
 			console.error('Error loading logs:', error);
@@ -62,6 +61,74 @@ class LogViewer {
 		}
 	}
 	
+	async fetchNewLogs() {
+		try {
+			const response = await fetch(`/api/logs?cursor=${this.lastSequence}&limit=200`);
+			if (!response.ok) {
+				throw new Error(`HTTP ${response.status}: ${response.statusText}`);
+			}
+			
+			const data = await response.json();
+			this.hideError();
+			this.appendLogs(data.logs || []);
+			this.updateStatus(data.stats || {});
+			
+			if (data.next_cursor !== undefined) {
+				this.lastSequence = data.next_cursor;
+			}
+			
+		} catch (error) {
+			console.error('Error fetching new logs:', error);
+			this.showError(`Failed to fetch new logs: ${error.message}`);
+		}
+	}
+	
+	createLogElement(log) {
+		const logEntry = document.createElement('div');
+		
+		const timestamp = this.formatTimestamp(log.timestamp);
+		const message = this.escapeHtml(log.message || '');
+		const levelName = this.getLevelName(log.level);
+		
+		logEntry.className = `log-entry log-level-${levelName}`;
+		logEntry.innerHTML = `<span class="log-timestamp">[${timestamp}]</span><span class="log-level">[${levelName}]</span><span class="log-message">${message}</span>`;
+		
+		return logEntry;
+	}
+	
+	appendLogs(logs) {
+		// Ignore entries already displayed (stream replay after reconnect)
+		const newLogs = logs.filter(log => log.sequence > this.lastSequence);
+		if (newLogs.length === 0) {
+			return;
+		}
+		
+		const wasAtBottom = this.isScrolledToBottom();
+		
+		// Drop the "loading" / "no logs" placeholder
+		const placeholder = this.logsContainer.querySelector('.loading');
+		if (placeholder) {
+			placeholder.remove();
+		}
+		
+		const fragment = document.createDocumentFragment();
+		newLogs.forEach(log => fragment.appendChild(this.createLogElement(log)));
+		this.logsContainer.appendChild(fragment);
+		this.lastSequence = newLogs[newLogs.length - 1].sequence;
+		
+		// Keep at most the selected number of entries
+		const maxEntries = parseInt(this.maxEntriesSelect.value);
+		if (maxEntries > 0) {
+			while (this.logsContainer.childElementCount > maxEntries) {
+				this.logsContainer.firstElementChild.remove();
+			}
+		}
+		
+		if (this.autoScrollEnabled && wasAtBottom) {
+			this.scrollToBottom();
+		}
+	}
+	
 	displayLogs(logs) {
 		if (!logs || logs.length === 0) {
 			this.logsContainer.innerHTML = '<div class="loading">No logs available</div>';
@@ -73,18 +140,9 @@ class LogViewer {
 		
 		this.logsContainer.innerHTML = '';
 		
-		logs.forEach(log => {
-			const logEntry = document.createElement('div');
-			
-			const timestamp = this.formatTimestamp(log.timestamp);
-			const message = this.escapeHtml(log.message || '');
-			const levelName = this.getLevelName(log.level);
-
-			logEntry.className = `log-entry log-level-${levelName}`;
-			logEntry.innerHTML = `<span class="log-timestamp">[${timestamp}]</span><span class="log-level">[${levelName}]</span><span class="log-message">${message}</span>`;
-			
-			this.logsContainer.appendChild(logEntry);
-		});
+		const fragment = document.createDocumentFragment();
+		logs.forEach(log => fragment.appendChild(this.createLogElement(log)));
+		this.logsContainer.appendChild(fragment);
 		
 		// Auto-scroll to bottom if enabled and was at bottom
 		if (this.autoScrollEnabled && wasAtBottom) {
@@ -118,7 +176,6 @@ class LogViewer {
 			}
 			
 			this.logsContainer.innerHTML = '<div class="loading">Logs cleared</div>';
-			this.lastTimestamp = 0;
 			setTimeout(() => this.loadLogs(), 1000);
 			
 		} catch (error) {
@@ -147,11 +204,32 @@ class LogViewer {
 			this.autoRefreshInterval = null;
 		}
 		
-		const seconds = parseInt(this.autoRefreshSelect.value);
+		// Close existing live stream
+		if (this.eventSource) {
+			this.eventSource.close();
+			this.eventSource = null;
+		}
+		
+		const value = this.autoRefreshSelect.value;
+		const seconds = parseInt(value);
 		const statusElement = document.getElementById('autoRefreshStatus');
 		
-		if (seconds > 0) {
-			this.autoRefreshInterval = setInterval(() => this.loadLogs(), seconds * 1000);
+		if (value === 'live' && window.EventSource) {
+			this.eventSource = new EventSource('/api/logs/stream');
+			this.eventSource.addEventListener('log', (event) => {
+				this.appendLogs([JSON.parse(event.data)]);
+				document.getElementById('lastUpdate').textContent = new Date().toLocaleTimeString();
+			});
+			this.eventSource.onopen = () => {
+				this.hideError();
+				statusElement.textContent = 'Live';
+			};
+			this.eventSource.onerror = () => {
+				statusElement.textContent = 'Live (reconnecting...)';
+			};
+			statusElement.textContent = 'Live (connecting...)';
+		} else if (seconds > 0) {
+			this.autoRefreshInterval = setInterval(() => this.fetchNewLogs(), seconds * 1000);
 			statusElement.textContent = `Every ${seconds} seconds`;
 		} else {
 			statusElement.textContent = 'Disabled';
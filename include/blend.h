@@ -0,0 +1,82 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Jérôme SONRIER
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * This file is part of emfao-light_control.
+ *
+ * emfao-light_control is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * emfao-light_control is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with emfao-light_control.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @file  blend.h
+ * @brief Blend modes of the layer stacks
+ *
+ * 12-bit fixed point, no division and no allocation: blending runs for
+ * every layered channel each time its PWM duty is computed. Only integer
+ * arithmetic, no hardware access: the same code runs in the host tests
+ * (test/test_layer).
+ *
+ * @author  Jérôme SONRIER <jsid@emor3j.fr.eu.org>
+ * @date    2025-10-17
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+
+/**
+ * @enum BlendMode
+ * @brief Combination of a layer with the layers below it
+ */
+enum BlendMode : uint8_t {
+	BLEND_MAX = 0,          ///< Brighter of both
+	BLEND_MULTIPLY = 1,     ///< Scaled by the layer (4095 = unchanged)
+	BLEND_ADD = 2,          ///< Sum, clamped to full brightness
+	BLEND_OVERRIDE = 3      ///< The layer replaces the levels below while above 0
+};
+
+/**
+ * @class LayerBlend
+ * @brief Blending of two 12-bit levels
+ *
+ * @note All methods are static
+ */
+class LayerBlend {
+	public:
+		/// Full brightness level
+		static constexpr uint16_t LEVEL_MAX = 4095;
+
+		/**
+		 * @brief Blend a layer over the levels below it
+		 *
+		 * @param mode Blend mode
+		 * @param lower Level of the layers below (0-4095)
+		 * @param upper Level of the layer (0-4095)
+		 * @return Blended level (0-4095), lower for an unknown mode
+		 */
+		static inline uint16_t blend(uint8_t mode, uint16_t lower, uint16_t upper) {
+			switch (mode) {
+				case BLEND_MAX:
+					return lower > upper ? lower : upper;
+				case BLEND_MULTIPLY:
+					// (upper + 1) / 4096 keeps 4095 exact without a division
+					return (static_cast<uint32_t>(lower) * (upper + 1)) >> 12;
+				case BLEND_ADD:
+					return lower + upper > LEVEL_MAX ? static_cast<uint16_t>(LEVEL_MAX) : lower + upper;
+				case BLEND_OVERRIDE:
+					return upper ? upper : lower;
+				default:
+					return lower;
+			}
+		}
+};
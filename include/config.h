@@ -27,6 +27,18 @@
 
 #include <Arduino.h>
 
+#include "curve.h"
+
+
+/**
+ * @enum PowerMode
+ * @brief How LED intensities are scaled down when the power budget is exceeded
+ */
+enum PowerMode : uint8_t {
+	POWER_FAIR = 0,      ///< Every LED is scaled by the same factor
+	POWER_PRIORITY = 1   ///< Lower priority LEDs are dimmed first
+};
+
 
 /**
  * @brief Configuration class for ESP32 LED controller system
@@ -35,9 +47,35 @@
  * LED controller that manages PWM LEDs through PCA9685 modules via I2C bus.
  */
 class Config {
+	public:
+		// === Constantes ===
+
+		/// I2C Standard-mode clock (Hz)
+		static constexpr uint32_t I2C_CLOCK_STANDARD = 100000;
+		/// I2C Fast-mode clock (Hz)
+		static constexpr uint32_t I2C_CLOCK_FAST = 400000;
+		/// I2C Fast-mode Plus clock (Hz), the PCA9685 maximum
+		static constexpr uint32_t I2C_CLOCK_FAST_PLUS = 1000000;
+		/// Pin value disabling the second I2C bus
+		static constexpr uint8_t I2C_PIN_NONE = 0xFF;
+		/// Number of PCA9685 broadcast groups (SUBADR1 and SUBADR2)
+		static constexpr uint8_t BROADCAST_GROUP_COUNT = 2;
+		/// Highest configurable power budget (mA)
+		static constexpr uint32_t POWER_BUDGET_MAX_MA = 200000;
+
 	private:
 		uint8_t i2c_pin_sda_;        ///< I2C SDA pin number
 		uint8_t i2c_pin_scl_;        ///< I2C SCL pin number
+		uint8_t i2c1_pin_sda_;       ///< Second I2C bus SDA pin number (I2C_PIN_NONE if unused)
+		uint8_t i2c1_pin_scl_;       ///< Second I2C bus SCL pin number (I2C_PIN_NONE if unused)
+		uint32_t i2c_clock_hz_;      ///< Highest I2C clock tried at bring-up (Hz)
+		uint8_t broadcast_group_addr_[BROADCAST_GROUP_COUNT];	///< I2C address of each broadcast group
+		bool phase_stagger_;         ///< Spread channel ON times across the PWM period
+		bool linked_frames_;         ///< Write all modules of a bus in one I2C transaction
+		bool hotplug_scan_;          ///< Probe the buses in the background for added modules
+		CurveType default_curve_;    ///< Transfer curve of modules without their own
+		uint32_t power_budget_ma_;   ///< Highest estimated LED current in mA (0 = no limit)
+		PowerMode power_mode_;       ///< How intensities are scaled down over budget
 		uint8_t pca9685_addr_min_;   ///< Minimum PCA9685 I2C address
 		uint8_t pca9685_addr_max_;   ///< Maximum PCA9685 I2C address
 		uint8_t pca9685_module_max_; ///< Maximum number of PCA9685 modules supported
@@ -59,7 +97,13 @@ class Config {
 		 * 
 		 * Initializes the configuration with commonly used default values:
 		 * - I2C pins: SDA=21, SCL=22 (standard ESP32 pins)
+		 * - Second I2C bus: disabled
+		 * - I2C clock: up to 1 MHz (Fast-mode Plus), lowered at bring-up if needed
 		 * - PCA9685 address range: 0x40-0x7F (standard I2C address range)
+		 * - Broadcast groups: 0x71 and 0x72 (PCA9685 SUBADR1/SUBADR2 defaults)
+		 * - Phase staggering: enabled
+		 * - Linked frames: disabled (one transaction per module)
+		 * - Power budget: no limit, fair scaling
 		 * - Maximum 16 modules with 16 LEDs each
 		 * - LED name maximum length: 64 characters
 		 */
@@ -93,6 +137,30 @@ class Config {
 		 */
 		uint8_t getI2cSclPin() const { return i2c_pin_scl_; }
 
+		/**
+		 * @brief Get highest I2C clock tried at bring-up
+		 * @return Clock frequency in Hz
+		 */
+		uint32_t getI2cClockHz() const { return i2c_clock_hz_; }
+
+		/**
+		 * @brief Get second I2C bus SDA pin number
+		 * @return SDA pin number, I2C_PIN_NONE if the bus is unused
+		 */
+		uint8_t getI2c1SdaPin() const { return i2c1_pin_sda_; }
+
+		/**
+		 * @brief Get second I2C bus SCL pin number
+		 * @return SCL pin number, I2C_PIN_NONE if the bus is unused
+		 */
+		uint8_t getI2c1SclPin() const { return i2c1_pin_scl_; }
+
+		/**
+		 * @brief Check if the second I2C bus is used
+		 * @return true if second bus pins are set
+		 */
+		bool isI2c1Enabled() const { return i2c1_pin_sda_ != I2C_PIN_NONE && i2c1_pin_scl_ != I2C_PIN_NONE; }
+
 		/**
 		 * @brief Get minimum PCA9685 I2C address
 		 * @return Minimum I2C address
@@ -105,6 +173,58 @@ class Config {
 		 */
 		uint8_t getPca9685AddrMax() const { return pca9685_addr_max_; }
 
+		/**
+		 * @brief Get I2C address of a broadcast group
+		 * @param group Broadcast group (1 to BROADCAST_GROUP_COUNT)
+		 * @return 7-bit I2C address, 0 for an invalid group
+		 */
+		uint8_t getBroadcastGroupAddress(uint8_t group) const {
+			return group >= 1 && group <= BROADCAST_GROUP_COUNT ? broadcast_group_addr_[group - 1] : 0;
+		}
+
+		/**
+		 * @brief Check if a GPIO can read a signal without disturbing the I2C buses
+		 * @param pin GPIO pin number to check (input-only pins accepted)
+		 * @return true if the pin exists and is not an I2C pin
+		 */
+		bool isFreeInputPin(uint8_t pin) const;
+
+		/**
+		 * @brief Check if channel ON times are spread across the PWM period
+		 * @return true if phase staggering is enabled
+		 */
+		bool isPhaseStaggerEnabled() const { return phase_stagger_; }
+
+		/**
+		 * @brief Check if all modules of a bus are written in one transaction
+		 * @return true if linked frames are enabled
+		 */
+		bool isLinkedFramesEnabled() const { return linked_frames_; }
+
+		/**
+		 * @brief Check if the buses are scanned in the background for added modules
+		 * @return true if hot-plug scanning is enabled
+		 */
+		bool isHotplugScanEnabled() const { return hotplug_scan_; }
+
+		/**
+		 * @brief Get the global transfer curve
+		 * @return Curve used by modules set to CURVE_DEFAULT
+		 */
+		CurveType getDefaultCurve() const { return default_curve_; }
+
+		/**
+		 * @brief Get the LED power budget
+		 * @return Highest estimated LED current in mA (0 = no limit)
+		 */
+		uint32_t getPowerBudget() const { return power_budget_ma_; }
+
+		/**
+		 * @brief Get the power budget scaling mode
+		 * @return Power mode
+		 */
+		PowerMode getPowerMode() const { return power_mode_; }
+
 		/**
 		 * @brief Get maximum number of PCA9685 modules supported
 		 * @return Maximum module count
@@ -139,6 +259,106 @@ class Config {
 		 */
 		bool setI2cSclPin(uint8_t pin);
 
+		/**
+		 * @brief Set highest I2C clock tried at bring-up
+		 * 
+		 * The bus starts at this speed and falls back to slower ones when
+		 * modules do not answer reliably (long cables, weak pull-ups).
+		 * 
+		 * @param clock_hz I2C_CLOCK_STANDARD, I2C_CLOCK_FAST or I2C_CLOCK_FAST_PLUS
+		 * @return true if value is valid and set successfully
+		 */
+		bool setI2cClockHz(uint32_t clock_hz);
+
+		/**
+		 * @brief Set second I2C bus pins
+		 * 
+		 * Modules found on the second bus (ESP32 I2C controller 1) are
+		 * flushed in parallel with the first bus.
+		 * 
+		 * @param sda_pin SDA pin number, I2C_PIN_NONE to disable the bus
+		 * @param scl_pin SCL pin number, I2C_PIN_NONE to disable the bus
+		 * @return true if pins are valid, distinct from the first bus and set successfully
+		 */
+		bool setI2c1Pins(uint8_t sda_pin, uint8_t scl_pin);
+
+		/**
+		 * @brief Check if an I2C clock is supported
+		 * @param clock_hz Clock frequency in Hz
+		 * @return true for 100 kHz, 400 kHz and 1 MHz
+		 */
+		static bool isValidI2cClock(uint32_t clock_hz);
+
+		/**
+		 * @brief Set I2C address of a broadcast group
+		 * 
+		 * Modules of the group answer this address in addition to their own
+		 * one. It must not be used by a module.
+		 * 
+		 * @param group Broadcast group (1 to BROADCAST_GROUP_COUNT)
+		 * @param address 7-bit I2C address, distinct from "All Call" and other groups
+		 * @return true if value is valid and set successfully
+		 */
+		bool setBroadcastGroupAddress(uint8_t group, uint8_t address);
+
+		/**
+		 * @brief Enable or disable phase staggering
+		 * 
+		 * Staggered channels do not all switch on at the start of the PWM
+		 * period, which lowers power supply current peaks.
+		 * 
+		 * @param enabled true to spread channel ON times
+		 */
+		void setPhaseStagger(bool enabled) { phase_stagger_ = enabled; }
+
+		/**
+		 * @brief Enable or disable linked frames
+		 * 
+		 * Linked frames write every module of a bus in a single I2C
+		 * transaction (repeated START between modules, one STOP), so that
+		 * the outputs of all modules change in the same PWM period. A
+		 * module that does not answer delays the whole frame until the
+		 * per-module retry.
+		 * 
+		 * @param enabled true to link module writes
+		 */
+		void setLinkedFrames(bool enabled) { linked_frames_ = enabled; }
+
+		/**
+		 * @brief Enable or disable hot-plug scanning
+		 * 
+		 * The background scan probes a few addresses per step between
+		 * frames, so modules plugged in or powered after boot are attached
+		 * without a reboot.
+		 * 
+		 * @param enabled true to scan in the background
+		 */
+		void setHotplugScan(bool enabled) { hotplug_scan_ = enabled; }
+
+		/**
+		 * @brief Set the global transfer curve
+		 * @param curve Curve used by modules set to CURVE_DEFAULT
+		 * @return true if the curve is valid (CURVE_DEFAULT is not)
+		 */
+		bool setDefaultCurve(CurveType curve);
+
+		/**
+		 * @brief Set the LED power budget
+		 * 
+		 * When the estimated current of all LEDs exceeds the budget, LED
+		 * intensities are scaled down in the next frame.
+		 * 
+		 * @param budget_ma Highest estimated LED current in mA (0 = no limit)
+		 * @return true if the budget is valid (up to POWER_BUDGET_MAX_MA)
+		 */
+		bool setPowerBudget(uint32_t budget_ma);
+
+		/**
+		 * @brief Set the power budget scaling mode
+		 * @param mode Power mode
+		 */
+		void setPowerMode(PowerMode mode) { power_mode_ = mode; }
+
 		/**
 		 * @brief Set PCA9685 address range
 		 * @param min_addr Minimum I2C address
@@ -0,0 +1,179 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Jérôme SONRIER
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * This file is part of emfao-light_control.
+ *
+ * emfao-light_control is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * emfao-light_control is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with emfao-light_control.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @file  curve.h
+ * @brief Brightness transfer curves
+ *
+ * LED brightness values set from the web interface and by programs are
+ * perceptual levels: equal steps look like equal changes. The PCA9685 duty
+ * cycle is linear in light output, which the eye sees as rushing through
+ * the low end. A transfer curve converts perceptual levels into PWM duty
+ * when the output frame is built.
+ *
+ * Gamma 2.2 and CIE L* tables are computed at compile time and live in
+ * flash; the custom table is interpolated once from control points when it
+ * is set. Converting a level is a single table lookup.
+ *
+ * Tables hold 16-bit intensities: 12-bit PWM duty with FRACTION_BITS of
+ * fraction. The fraction is either rounded away or rendered by temporal
+ * dithering (see ditherStep()).
+ *
+ * @author  Jérôme SONRIER <jsid@emor3j.fr.eu.org>
+ * @date    2025-10-17
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+
+/**
+ * @enum CurveType
+ * @brief Transfer curve from perceptual brightness to PWM duty
+ */
+enum CurveType : uint8_t {
+	CURVE_DEFAULT = 0,  ///< Inherited: LEDs use their module curve, modules the global curve
+	CURVE_LINEAR = 1,   ///< Duty proportional to brightness (no correction)
+	CURVE_GAMMA22 = 2,  ///< Power law with exponent 2.2
+	CURVE_CIE = 3,      ///< CIE 1976 L* lightness
+	CURVE_CUSTOM = 4    ///< User table interpolated from control points
+};
+
+
+/**
+ * @class BrightnessCurve
+ * @brief Lookup tables converting perceptual brightness into PWM duty
+ *
+ * @note All methods are static as the tables are shared by every LED
+ */
+class BrightnessCurve {
+	public:
+		/// Number of input levels (12-bit brightness)
+		static constexpr uint16_t LEVELS = 4096;
+
+		/// Highest input level
+		static constexpr uint16_t LEVEL_MAX = LEVELS - 1;
+
+		/// Number of control points of the custom curve
+		static constexpr uint8_t CUSTOM_POINTS = 17;
+
+		/// Input distance between two custom control points (last point is at 4095)
+		static constexpr uint16_t CUSTOM_POINT_STEP = LEVELS / (CUSTOM_POINTS - 1);
+
+		/// Number of curve types, CURVE_DEFAULT included
+		static constexpr uint8_t CURVE_TYPE_COUNT = 5;
+
+		/// Fraction bits of an intensity below one PWM duty step
+		static constexpr uint8_t FRACTION_BITS = 4;
+
+		/// Intensity of one PWM duty step
+		static constexpr uint16_t FRACTION_ONE = 1u << FRACTION_BITS;
+
+		/// Intensity of full duty (4095 << FRACTION_BITS)
+		static constexpr uint16_t INTENSITY_MAX = (LEVELS - 1) << FRACTION_BITS;
+
+		/**
+		 * @brief Convert a perceptual brightness into PWM duty
+		 *
+		 * Any non-zero brightness gives a non-zero duty, so an LED that is
+		 * on never goes dark because of the curve.
+		 *
+		 * @param curve Curve to apply (CURVE_DEFAULT is handled as linear)
+		 * @param level Perceptual brightness (0-4095)
+		 * @return PWM duty (0-4095)
+		 */
+		static uint16_t apply(CurveType curve, uint16_t level);
+
+		/**
+		 * @brief Convert a perceptual brightness into a 16-bit intensity
+		 *
+		 * @param curve Curve to apply (CURVE_DEFAULT is handled as linear)
+		 * @param level Perceptual brightness (0-4095)
+		 * @return Intensity (0 to INTENSITY_MAX, PWM duty << FRACTION_BITS)
+		 */
+		static uint16_t applyIntensity(CurveType curve, uint16_t level);
+
+		/**
+		 * @brief Round an intensity to the nearest PWM duty
+		 *
+		 * A non-zero intensity gives at least one duty step.
+		 *
+		 * @param intensity Intensity (0 to INTENSITY_MAX)
+		 * @return PWM duty (0-4095)
+		 */
+		static uint16_t toDuty(uint16_t intensity) {
+			uint16_t duty = (intensity + FRACTION_ONE / 2) >> FRACTION_BITS;
+			return (intensity > 0 && duty == 0) ? 1 : duty;
+		}
+
+		/**
+		 * @brief Advance first order sigma-delta dithering by one frame
+		 *
+		 * The fraction of the intensity is accumulated in error; each time
+		 * it reaches a full step, the frame gets one more duty step. Over
+		 * FRACTION_ONE frames the average duty equals the intensity.
+		 *
+		 * @param intensity Intensity (0 to INTENSITY_MAX)
+		 * @param error Accumulated fraction of the channel (0 to FRACTION_ONE - 1)
+		 * @return PWM duty of this frame (0-4095)
+		 */
+		static uint16_t ditherStep(uint16_t intensity, uint8_t& error) {
+			error += intensity & (FRACTION_ONE - 1);
+			uint16_t duty = intensity >> FRACTION_BITS;
+			if (error >= FRACTION_ONE) {
+				error -= FRACTION_ONE;
+				duty++;
+			}
+			return duty;
+		}
+
+		/**
+		 * @brief Get the name of a curve
+		 * @param curve Curve type
+		 * @return Curve name ("default", "linear", "gamma22", "cie", "custom")
+		 */
+		static const char* getName(CurveType curve);
+
+		/**
+		 * @brief Find a curve by name
+		 * @param name Curve name as returned by getName()
+		 * @param curve Set to the curve type when found
+		 * @return true if the name is known
+		 */
+		static bool fromName(const char* name, CurveType& curve);
+
+		/**
+		 * @brief Define the custom curve
+		 *
+		 * Point i is the duty for input i * CUSTOM_POINT_STEP (4095 for the
+		 * last one); inputs in between are linearly interpolated into the
+		 * table here, not at lookup time, with FRACTION_BITS of fraction.
+		 *
+		 * @param points CUSTOM_POINTS duty values (0-4095)
+		 * @return true if the curve was set, false if a point is out of
+		 *         range or the table cannot be allocated
+		 */
+		static bool setCustomPoints(const uint16_t* points);
+
+		/**
+		 * @brief Get the control points of the custom curve
+		 * @return CUSTOM_POINTS duty values (a straight line if never set)
+		 */
+		static const uint16_t* getCustomPoints();
+};
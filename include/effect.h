@@ -0,0 +1,216 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Jérôme SONRIER
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * This file is part of emfao-light_control.
+ *
+ * emfao-light_control is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * emfao-light_control is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with emfao-light_control.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @file  effect.h
+ * @brief User-defined keyframe effects interpreted from bytecode
+ *
+ * Effects are small programs uploaded through the API, so that new lighting
+ * sequences need no firmware rebuild. The bytecode is a list of fixed size
+ * instructions (6 bytes, little endian):
+ *
+ *     op (u8) | arg (u8) | value (u16) | param (u16)
+ *
+ * | op | name   | arg          | value            | param                  |
+ * |----|--------|--------------|------------------|------------------------|
+ * | 0  | end    | -            | -                | -                      |
+ * | 1  | set    | -            | level            | -                      |
+ * | 2  | ramp   | -            | target level     | duration (ms)          |
+ * | 3  | hold   | -            | duration (ms)    | random extra (ms)      |
+ * | 4  | random | -            | minimum level    | maximum level          |
+ * | 5  | loop   | counter 0-3  | target index     | count (0 = forever)    |
+ * | 6  | jump   | percent      | target index     | -                      |
+ *
+ * "loop" runs the instructions from the target up to itself count times;
+ * "jump" goes to the target with the given probability (100 = always).
+ *
+ * A program is validated once when it is compiled: operands in range,
+ * targets inside the program, no way to run past the last instruction and
+ * no loop that could run without a timed instruction. The interpreter then
+ * works on the decoded instructions without any allocation, executing at
+ * most the program budget of instructions per update.
+ *
+ * No hardware access: the compiler and the interpreter also run in the
+ * host tests (test/test_effect).
+ *
+ * @author  Jérôme SONRIER <jsid@emor3j.fr.eu.org>
+ * @date    2025-10-17
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+/**
+ * @enum EffectOp
+ * @brief Effect bytecode operations
+ */
+enum EffectOp : uint8_t {
+	EFFECT_END = 0,       ///< Stop the effect, the LED keeps its level
+	EFFECT_SET = 1,       ///< Set the level at once
+	EFFECT_RAMP = 2,      ///< Fade linearly to a level
+	EFFECT_HOLD = 3,      ///< Keep the level for a (randomized) duration
+	EFFECT_RANDOM = 4,    ///< Set a random level within a range
+	EFFECT_LOOP = 5,      ///< Repeat a block a number of times
+	EFFECT_JUMP = 6       ///< Go to an instruction with a probability
+};
+
+
+/**
+ * @struct EffectInstruction
+ * @brief Decoded effect instruction
+ */
+struct EffectInstruction {
+	uint8_t op;        ///< Operation (EffectOp)
+	uint8_t arg;       ///< Loop counter or jump probability
+	uint16_t value;    ///< Level, duration or target index
+	uint16_t param;    ///< Duration, extra duration, maximum level or count
+};
+
+
+/**
+ * @class EffectVM
+ * @brief Compiler and interpreter of effect bytecode
+ *
+ * @note All methods are static: programs and states are owned by the
+ *       program manager
+ */
+class EffectVM {
+	public:
+		/// Size of one encoded instruction (bytes)
+		static constexpr size_t INSTRUCTION_SIZE = 6;
+		/// Maximum number of instructions of a program
+		static constexpr uint8_t INSTRUCTIONS_MAX = 64;
+		/// Number of loop counters of a running effect
+		static constexpr uint8_t LOOP_COUNTERS = 4;
+		/// Default number of instructions executed per update
+		static constexpr uint8_t BUDGET_DEFAULT = 16;
+		/// Maximum number of instructions executed per update
+		static constexpr uint8_t BUDGET_MAX = 64;
+		/// Maximum effect name length
+		static constexpr size_t NAME_MAX = 23;
+		/// Lateness after which timing restarts from now instead of catching up (milliseconds)
+		static constexpr uint32_t RESYNC_MS = 1000;
+		/// Highest level of an effect
+		static constexpr uint16_t LEVEL_MAX = 4095;
+		/// Size of a compilation error message buffer (with terminator)
+		static constexpr size_t ERROR_MAX = 64;
+
+		/**
+		 * @brief Validated and decoded effect program
+		 */
+		struct Program {
+			EffectInstruction code[INSTRUCTIONS_MAX];   ///< Decoded instructions
+			uint8_t length;                             ///< Number of instructions (0 = empty)
+			uint8_t budget;                             ///< Instructions executed per update at most
+			char name[NAME_MAX + 1];                    ///< User name
+		};
+
+		/**
+		 * @brief Execution state of an effect on one LED
+		 */
+		struct State {
+			const Program* program;             ///< Program run (nullptr = stopped)
+			uint8_t pc;                         ///< Index of the next instruction
+			bool waiting;                       ///< A ramp or hold is in progress
+			bool ramping;                       ///< The timed instruction is a ramp
+			bool halted;                        ///< The program reached "end"
+			uint16_t counters[LOOP_COUNTERS];   ///< Loop iteration counters
+			uint16_t from;                      ///< Level at the start of the ramp
+			uint16_t to;                        ///< Level at the end of the ramp
+			unsigned long start;                ///< millis() at which the current instruction started
+			uint32_t duration;                  ///< Duration of the timed instruction (milliseconds)
+		};
+
+		/**
+		 * @brief Execution counters of a program
+		 */
+		struct Stats {
+			uint32_t updates;          ///< Updates that ran instructions
+			uint32_t instructions;     ///< Instructions executed
+			uint32_t overruns;         ///< Updates stopped by the budget
+			uint8_t max_per_update;    ///< Most instructions executed by one update
+		};
+
+		/**
+		 * @brief Validate bytecode and decode it into a program
+		 *
+		 * @param bytes Encoded instructions
+		 * @param size Number of bytes (multiple of INSTRUCTION_SIZE)
+		 * @param budget Instructions executed per update at most (1 to BUDGET_MAX)
+		 * @param program Decoded program, set only on success
+		 * @param error Buffer receiving the reason of the rejection
+		 * @param error_size Size of the error buffer (ERROR_MAX is enough)
+		 * @return true if the bytecode is valid
+		 */
+		static bool compile(const uint8_t* bytes, size_t size, uint8_t budget, Program& program, char* error, size_t error_size);
+
+		/**
+		 * @brief Encode a program back into bytecode
+		 *
+		 * @param program Decoded program
+		 * @param out Buffer of at least length * INSTRUCTION_SIZE bytes
+		 * @return Number of bytes written
+		 */
+		static size_t encode(const Program& program, uint8_t* out);
+
+		/**
+		 * @brief Decode a hexadecimal string (whitespace allowed)
+		 *
+		 * @param hex Hexadecimal string
+		 * @param out Output buffer
+		 * @param max Size of the output buffer
+		 * @param size Number of bytes decoded
+		 * @return true if the string is valid and fits
+		 */
+		static bool parseHex(const char* hex, uint8_t* out, size_t max, size_t& size);
+
+		/**
+		 * @brief Get the mnemonic of an operation
+		 *
+		 * @param op Operation
+		 * @return Name ("end", "set", "ramp", "hold", "random", "loop", "jump")
+		 */
+		static const char* getOpName(uint8_t op);
+
+		/**
+		 * @brief Start a program from its first instruction
+		 *
+		 * @param state Effect state of the LED
+		 * @param program Program to run (nullptr to stop)
+		 * @param now Current time (milliseconds)
+		 */
+		static void start(State& state, const Program* program, unsigned long now);
+
+		/**
+		 * @brief Run an effect up to now
+		 *
+		 * Completes timed instructions that ended (catching up on their end
+		 * time, so that effects do not drift), then executes instructions
+		 * until the next timed one, "end" or the program budget.
+		 *
+		 * @param state Effect state of the LED
+		 * @param level Current LED level
+		 * @param now Current time (milliseconds)
+		 * @param stats Counters of the program (nullptr to skip)
+		 * @return New LED level
+		 */
+		static uint16_t step(State& state, uint16_t level, unsigned long now, Stats* stats);
+};
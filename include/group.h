@@ -0,0 +1,415 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Jérôme SONRIER
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * This file is part of emfao-light_control.
+ *
+ * emfao-light_control is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * emfao-light_control is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with emfao-light_control.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @file  group.h
+ * @brief Named LED groups and scenes
+ *
+ * An LED group is a named set of LEDs of any module, for example all the
+ * street lights of a layout. Its members are stored as a bitset over the
+ * global channel index (module * LED_MAX + LED), kept as one 16-bit word
+ * per module, so that an operation on the group visits only the modules
+ * having members and marks each of them dirty once for the next flush.
+ *
+ * A scene is a snapshot of the state (enabled, brightness, program) of
+ * some groups, recalled at once: "night" turns the street lights on and
+ * starts the candles in the houses. Operations and recalls requested by
+ * the web server are queued and applied by the main loop just before the
+ * frame is flushed, so that a scene always appears within a single frame.
+ * Group edits and changes of a single LED take the same queue, so that
+ * the group masks, program states and transitions are only written by the
+ * main loop.
+ *
+ * @note These groups are unrelated to the PCA9685 broadcast groups, which
+ *       are hardware subaddresses shared by whole modules.
+ *
+ * @author  Jérôme SONRIER <jsid@emor3j.fr.eu.org>
+ * @date    2025-10-17
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <memory>
+
+#include "pca9685.h"
+#include "program.h"
+
+
+/**
+ * @class GroupManager
+ * @brief Owner of the LED groups and scenes
+ */
+class GroupManager {
+	public:
+		/// Maximum number of LED groups
+		static constexpr uint8_t GROUP_MAX = 16;
+		/// Maximum number of scenes
+		static constexpr uint8_t SCENE_MAX = 16;
+		/// Maximum group or scene name length
+		static constexpr size_t NAME_MAX = 23;
+		/// Number of global channel indexes (bits of a group)
+		static constexpr uint16_t CHANNEL_COUNT = PCA9685Module::MODULE_MAX * PCA9685Module::LED_MAX;
+
+		/**
+		 * @brief Named set of LEDs
+		 */
+		struct Group {
+			char name[NAME_MAX + 1];                          ///< User name (empty = free slot)
+			uint16_t masks[PCA9685Module::MODULE_MAX];        ///< Members, bit n of word m = LED n of module m
+		};
+
+		/**
+		 * @brief State of one group in a scene
+		 */
+		struct SceneEntry {
+			uint8_t group;          ///< Group index
+			bool enabled;           ///< LEDs enabled
+			uint16_t brightness;    ///< Brightness (0-4095)
+			uint8_t program;        ///< Program (ProgramType)
+		};
+
+		/**
+		 * @brief Named snapshot of some groups
+		 */
+		struct Scene {
+			char name[NAME_MAX + 1];            ///< User name (empty = free slot)
+			uint8_t count;                      ///< Number of entries
+			SceneEntry entries[GROUP_MAX];      ///< Groups of the scene, applied in order
+		};
+
+		/**
+		 * @brief Change applied to every LED of a group
+		 */
+		struct Action {
+			uint8_t group;              ///< Group index
+			bool set_enabled;           ///< Change the enabled state
+			bool enabled;               ///< New enabled state
+			bool set_brightness;        ///< Change the brightness
+			uint16_t brightness;        ///< New brightness (0-4095)
+			bool set_program;           ///< Change the program
+			uint8_t program;            ///< New program (ProgramType)
+			uint32_t transition_ms;     ///< Crossfade duration (0 = at once)
+			uint8_t easing;             ///< Crossfade curve (TransitionEasing)
+		};
+
+		/**
+		 * @brief Change applied to one LED, validated by the caller
+		 */
+		struct LedUpdate {
+			uint8_t module;             ///< Module index
+			uint8_t led;                ///< LED index within the module
+			bool set_name;              ///< Change the name
+			String name;                ///< New name
+			bool set_enabled;           ///< Change the enabled state
+			bool enabled;               ///< New enabled state
+			bool set_program;           ///< Change the program
+			uint8_t program;            ///< New program (ProgramType)
+			bool set_effect;            ///< Run a user effect (implies PROGRAM_CUSTOM)
+			uint8_t effect_slot;        ///< Effect slot
+			bool set_params;            ///< Change the program parameters
+			ProgramParams params;       ///< New parameters, merged with the current ones
+			bool set_phase;             ///< Change the phase group
+			uint8_t phase_group;        ///< New phase group (0 to leave)
+			uint16_t phase_offset;      ///< New offset in the cycle (degrees)
+			bool set_curve;             ///< Change the transfer curve
+			uint8_t curve;              ///< New curve (CurveType)
+			bool set_dither;            ///< Change temporal dithering
+			bool dither;                ///< New dithering state
+			bool set_rated;             ///< Change the rated current
+			uint16_t rated_ma;          ///< New rated current (mA, 0 = module rating)
+			bool set_priority;          ///< Change the power budget priority
+			uint8_t priority;           ///< New priority
+			bool set_brightness;        ///< Change the brightness
+			uint16_t brightness;        ///< New brightness (0-4095)
+			uint32_t transition_ms;     ///< Crossfade duration (0 = at once)
+			uint8_t easing;             ///< Crossfade curve (TransitionEasing)
+		};
+
+		/**
+		 * @brief Timing of the applied operations
+		 */
+		struct Stats {
+			uint32_t operations;        ///< Group operations and scene recalls applied
+			uint16_t last_leds;         ///< LEDs changed by the last one
+			uint32_t last_us;           ///< Duration of the last one (microseconds)
+			uint32_t max_us;            ///< Longest one (microseconds)
+		};
+
+		// === Constructor ===
+
+		/**
+		 * @brief Constructor, all group and scene slots free
+		 */
+		GroupManager();
+
+		// === Groups ===
+
+		/**
+		 * @brief Define or remove a group
+		 *
+		 * @param index Group slot
+		 * @param group Group, an empty name removes it (scenes keep their entries)
+		 * @return true if the slot is valid
+		 */
+		bool setGroup(uint8_t index, const Group& group);
+
+		/**
+		 * @brief Get a group
+		 *
+		 * @param index Group slot
+		 * @return Group, or nullptr if the slot is free or invalid
+		 */
+		const Group* getGroup(uint8_t index) const;
+
+		/**
+		 * @brief Add or remove an LED of a group description
+		 *
+		 * @param group Group to change
+		 * @param module_index Module index
+		 * @param led_index LED index within the module
+		 * @param member true to add the LED, false to remove it
+		 * @return true if the LED index is valid
+		 */
+		static bool setMember(Group& group, uint8_t module_index, uint8_t led_index, bool member);
+
+		/**
+		 * @brief Count the LEDs of a group
+		 *
+		 * @param group Group
+		 * @return Number of members
+		 */
+		static uint16_t countMembers(const Group& group);
+
+		// === Scenes ===
+
+		/**
+		 * @brief Define or remove a scene
+		 *
+		 * @param index Scene slot
+		 * @param scene Scene, an empty name removes it
+		 * @return true if the slot and the entries are valid
+		 */
+		bool setScene(uint8_t index, const Scene& scene);
+
+		/**
+		 * @brief Get a scene
+		 *
+		 * @param index Scene slot
+		 * @return Scene, or nullptr if the slot is free or invalid
+		 */
+		const Scene* getScene(uint8_t index) const;
+
+		/**
+		 * @brief Take the current state of a group as a scene entry
+		 *
+		 * The state of the first member stands for the whole group.
+		 *
+		 * @param group Group index
+		 * @param entry Entry, set only on success
+		 * @return true if the group exists and has a member
+		 */
+		bool captureEntry(uint8_t group, SceneEntry& entry) const;
+
+		// === Requests (applied by handle()) ===
+
+		/**
+		 * @brief Queue an operation on a group
+		 *
+		 * @param action Change to apply
+		 * @return false if the group is free or another request is pending
+		 */
+		bool requestAction(const Action& action);
+
+		/**
+		 * @brief Queue the recall of a scene
+		 *
+		 * @param index Scene slot
+		 * @param transition_ms Crossfade duration (0 = at once)
+		 * @param easing Crossfade curve
+		 * @return false if the scene is free or another request is pending
+		 */
+		bool requestScene(uint8_t index, uint32_t transition_ms = 0, TransitionEasing easing = EASING_LINEAR);
+
+		/**
+		 * @brief Queue the definition or removal of a group
+		 *
+		 * The group is saved and the jittered schedule events using it get
+		 * new firings once it is applied.
+		 *
+		 * @param index Group slot
+		 * @param group Group, an empty name removes it
+		 * @return false if the slot is invalid or another request is pending
+		 */
+		bool requestGroup(uint8_t index, const Group& group);
+
+		/**
+		 * @brief Queue a change of one LED
+		 *
+		 * Program states, parameters and transitions are only changed from
+		 * the main loop, which updates the programs.
+		 *
+		 * @param update Change to apply
+		 * @return false if the LED is unknown or another request is pending
+		 */
+		bool requestLed(const LedUpdate& update);
+
+		/**
+		 * @brief Check if a request is waiting for handle()
+		 *
+		 * @return true if pending
+		 */
+		bool isPending() const { return pending_ != PendingType::NONE; }
+
+		/**
+		 * @brief Apply the pending request
+		 *
+		 * Called from the main loop right before ModuleManager::handle(), so
+		 * that every change of the request is part of the same frame.
+		 */
+		void handle();
+
+		/**
+		 * @brief Get the timing of the applied requests
+		 *
+		 * @return Statistics
+		 */
+		const Stats& getStats() const { return stats_; }
+
+		// === Immediate Operations (main loop only) ===
+
+		/**
+		 * @brief Apply a change to a group at once
+		 *
+		 * Used by the model clock schedules, which run in the main loop
+		 * right before handle() and may fire several changes per frame.
+		 *
+		 * @param action Change to apply, with its own transition
+		 * @param masks LEDs to change per module within the group, nullptr for all
+		 * @return Number of LEDs changed
+		 */
+		uint16_t applyNow(const Action& action, const uint16_t* masks = nullptr);
+
+		/**
+		 * @brief Apply a change to a group at once, within a running transition
+		 *
+		 * Lets the batches of a jittered schedule event share one
+		 * transition; action.transition_ms is not used.
+		 *
+		 * @param action Change to apply
+		 * @param masks LEDs to change per module within the group, nullptr for all
+		 * @param transition Transition slot from ProgramManager::begin_transition() (0 = at once)
+		 * @return Number of LEDs changed
+		 */
+		uint16_t applyNow(const Action& action, const uint16_t* masks, uint8_t transition);
+
+		/**
+		 * @brief Recall a scene at once
+		 *
+		 * @param index Scene slot
+		 * @param transition_ms Crossfade duration (0 = at once)
+		 * @param easing Crossfade curve
+		 * @return Number of LEDs changed
+		 */
+		uint16_t recallNow(uint8_t index, uint32_t transition_ms, TransitionEasing easing);
+
+		/**
+		 * @brief Apply a change to any set of LEDs at once
+		 *
+		 * Used by the show player, whose events name their channels
+		 * directly. The group of the action is ignored.
+		 *
+		 * @param action Change to apply, with its own transition
+		 * @param masks LEDs to change per module (MODULE_MAX entries)
+		 * @return Number of LEDs changed
+		 */
+		uint16_t applyMasksNow(const Action& action, const uint16_t* masks);
+
+	private:
+		/**
+		 * @brief Type of the pending request
+		 */
+		enum class PendingType : uint8_t {
+			NONE,
+			ACTION,
+			SCENE,
+			GROUP,
+			LED
+		};
+
+		Group groups_[GROUP_MAX];                   ///< Group slots
+		Scene scenes_[SCENE_MAX];                   ///< Scene slots
+		Action pending_action_;                     ///< Operation queued by requestAction()
+		uint8_t pending_scene_;                     ///< Scene queued by requestScene()
+		uint32_t pending_transition_ms_;            ///< Crossfade of the queued scene
+		TransitionEasing pending_easing_;           ///< Crossfade curve of the queued scene
+		uint8_t pending_group_index_;               ///< Slot of the group queued by requestGroup()
+		Group pending_group_;                       ///< Group queued by requestGroup()
+		LedUpdate pending_led_;                     ///< LED change queued by requestLed()
+		volatile PendingType pending_;              ///< Type of the queued request
+		Stats stats_;                               ///< Timing of the applied requests
+
+		/**
+		 * @brief Apply a change to every LED of a group
+		 *
+		 * Visits the modules having members, changes their LEDs and marks
+		 * each module dirty once.
+		 *
+		 * @param action Change to apply
+		 * @param transition Transition the LEDs fade with (0 = at once)
+		 * @param masks LEDs to change per module within the group, nullptr for all
+		 * @return Number of LEDs changed
+		 */
+		uint16_t applyAction(const Action& action, uint8_t transition, const uint16_t* masks = nullptr);
+
+		/**
+		 * @brief Apply a change to some LEDs of one module
+		 *
+		 * @param action Change to apply
+		 * @param module_index Module index
+		 * @param mask LEDs to change
+		 * @param transition Transition the LEDs fade with (0 = at once)
+		 * @return Number of LEDs changed
+		 */
+		uint16_t applyToModule(const Action& action, uint8_t module_index, uint16_t mask, uint8_t transition);
+
+		/**
+		 * @brief Apply every entry of a scene
+		 *
+		 * @param index Scene slot
+		 * @param transition Transition the LEDs fade with (0 = at once)
+		 * @return Number of LEDs changed
+		 */
+		uint16_t recallScene(uint8_t index, uint8_t transition);
+
+		/**
+		 * @brief Apply a change of one LED
+		 *
+		 * @param update Change to apply
+		 * @return true if every setting was applied
+		 */
+		bool applyLed(const LedUpdate& update);
+};
+
+// Global instance
+/**
+ * @brief Global GroupManager instance
+ *
+ * Created in setup() after the modules and LED configurations are loaded.
+ */
+extern std::unique_ptr<GroupManager> group_manager;
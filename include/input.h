@@ -0,0 +1,405 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Jérôme SONRIER
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * This file is part of emfao-light_control.
+ *
+ * emfao-light_control is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * emfao-light_control is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with emfao-light_control.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @file  input.h
+ * @brief Layout inputs and the programs and scenes they trigger
+ *
+ * Inputs are track occupancy detectors, reed switches or push buttons,
+ * wired to ESP32 GPIOs or to MCP23017 I2C expanders. Each edge of an
+ * input looks up a trigger table that starts, stops or restarts the
+ * program of an LED group, or recalls a scene: the French level crossing
+ * starts when a train reaches the crossing and stops some seconds after
+ * it left.
+ *
+ * GPIO edges and expander INT lines raise interrupts whose handlers only
+ * push a timestamped event into a FreeRTOS queue. The main loop drains
+ * the queue at the start of each iteration, debounces the inputs (the
+ * first edge is taken at once, then the input is locked for the debounce
+ * time and checked again) and applies the triggers before the frame is
+ * flushed, so a light reacts within the frame following the edge.
+ *
+ * @author  Jérôme SONRIER <jsid@emor3j.fr.eu.org>
+ * @date    2025-10-17
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <memory>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+
+#include "group.h"
+
+
+/**
+ * @enum TriggerEdge
+ * @brief Input change firing a trigger
+ */
+enum TriggerEdge : uint8_t {
+	EDGE_ACTIVE,        ///< The input becomes active (train detected)
+	EDGE_INACTIVE,      ///< The input becomes inactive (train gone)
+	EDGE_CHANGE         ///< Both
+};
+
+/**
+ * @enum TriggerAction
+ * @brief What a trigger does to its target
+ */
+enum TriggerAction : uint8_t {
+	TRIGGER_START,      ///< Enable the group LEDs and start the program, unless already running
+	TRIGGER_STOP,       ///< Stop the program of the group LEDs and switch them off
+	TRIGGER_RETRIGGER,  ///< Start the program of the group LEDs again from its beginning
+	TRIGGER_SCENE       ///< Recall a scene
+};
+
+/**
+ * @class InputManager
+ * @brief Owner of the inputs, their interrupt queue and the trigger table
+ */
+class InputManager {
+	public:
+		/// Maximum number of MCP23017 expanders
+		static constexpr uint8_t EXPANDER_MAX = 4;
+		/// Maximum number of inputs
+		static constexpr uint8_t INPUT_MAX = 16;
+		/// Maximum number of triggers
+		static constexpr uint8_t TRIGGER_MAX = 32;
+		/// Maximum input name length
+		static constexpr size_t NAME_MAX = 15;
+		/// Input source of a GPIO input (otherwise the expander index)
+		static constexpr uint8_t SOURCE_GPIO = 0xFF;
+		/// Expander without INT line, read at POLL_INTERVAL_MS
+		static constexpr uint8_t INT_PIN_NONE = 0xFF;
+		/// Default debounce time (milliseconds)
+		static constexpr uint16_t DEBOUNCE_DEFAULT_MS = 20;
+		/// Longest debounce time (milliseconds)
+		static constexpr uint16_t DEBOUNCE_MAX_MS = 1000;
+		/// Longest trigger delay (milliseconds)
+		static constexpr uint32_t DELAY_MAX_MS = 600000;
+		/// Read interval of the expanders without INT line (milliseconds)
+		static constexpr unsigned long POLL_INTERVAL_MS = 20;
+		/// First MCP23017 address (A2..A0 select the next seven)
+		static constexpr uint8_t MCP23017_ADDRESS = 0x20;
+		/// Length of the interrupt event queue
+		static constexpr uint8_t QUEUE_LENGTH = 32;
+
+		/**
+		 * @brief MCP23017 I2C expander, 16 inputs
+		 */
+		struct Expander {
+			uint8_t address;        ///< I2C address (0x20-0x27)
+			uint8_t bus;            ///< I2C bus (shared with the PCA9685 modules)
+			uint8_t int_pin;        ///< GPIO wired to INTA (open drain, mirrored), or INT_PIN_NONE
+		};
+
+		/**
+		 * @brief Digital input
+		 */
+		struct Input {
+			char name[NAME_MAX + 1];    ///< User name
+			uint8_t source;             ///< SOURCE_GPIO or expander index
+			uint8_t pin;                ///< GPIO number, or expander pin (0-15 for GPA0..GPB7)
+			bool active_low;            ///< Active when low, with the internal pull-up enabled
+			uint16_t debounce_ms;       ///< Debounce time (milliseconds)
+		};
+
+		/**
+		 * @brief Entry of the trigger table
+		 */
+		struct Trigger {
+			uint8_t input;          ///< Input index
+			uint8_t edge;           ///< Input change (TriggerEdge)
+			uint8_t action;         ///< Action (TriggerAction)
+			uint8_t target;         ///< Group index, or scene index for TRIGGER_SCENE
+			uint8_t program;        ///< Program started (ProgramType)
+			uint32_t delay_ms;      ///< Delay before the action, restarted by each edge (0 = at once)
+		};
+
+		/**
+		 * @brief Complete input wiring and trigger table
+		 */
+		struct Wiring {
+			Expander expanders[EXPANDER_MAX];   ///< Expanders
+			uint8_t expander_count;             ///< Number of expanders
+			Input inputs[INPUT_MAX];            ///< Inputs
+			uint8_t input_count;                ///< Number of inputs
+			Trigger triggers[TRIGGER_MAX];      ///< Triggers, applied in order
+			uint8_t trigger_count;              ///< Number of triggers
+		};
+
+		/**
+		 * @brief Input counters
+		 */
+		struct Stats {
+			uint32_t interrupts;        ///< Events taken from the interrupt queue
+			uint32_t edges;             ///< Debounced input changes
+			uint32_t bounces;           ///< Edges ignored during a debounce time
+			uint32_t triggers;          ///< Trigger actions applied
+			uint32_t overflows;         ///< Events lost because the queue was full
+			uint32_t expander_errors;   ///< Failed expander reads
+			uint32_t last_latency_us;   ///< Interrupt to action delay of the last trigger (microseconds)
+			uint32_t max_latency_us;    ///< Longest interrupt to action delay (microseconds)
+		};
+
+		// === Constructor and Destructor ===
+
+		/**
+		 * @brief Constructor, creates the interrupt queue
+		 */
+		InputManager();
+
+		/**
+		 * @brief Destructor, detaches the interrupts
+		 */
+		~InputManager();
+
+		// === Wiring ===
+
+		/**
+		 * @brief Check a wiring
+		 *
+		 * @param wiring Wiring
+		 * @param error Set to the reason of the failure
+		 * @return true if every expander, input and trigger is valid
+		 */
+		static bool isValidWiring(const Wiring& wiring, String& error);
+
+		/**
+		 * @brief Apply a wiring at once
+		 *
+		 * For setup(), before the main loop runs. Configures the expanders
+		 * and the pins and attaches the interrupts.
+		 *
+		 * @param wiring Wiring
+		 * @return false if the wiring is invalid
+		 */
+		bool setWiring(const Wiring& wiring);
+
+		/**
+		 * @brief Queue a new wiring
+		 *
+		 * @param wiring Wiring
+		 * @return false if the wiring is invalid or a request is pending
+		 */
+		bool requestWiring(const Wiring& wiring);
+
+		/**
+		 * @brief Get the wiring
+		 *
+		 * @return Wiring
+		 */
+		const Wiring& getWiring() const { return wiring_; }
+
+		/**
+		 * @brief Get the debounced state of an input
+		 *
+		 * @param index Input index
+		 * @return true if active
+		 */
+		bool isActive(uint8_t index) const;
+
+		/**
+		 * @brief Check if a request is waiting for handle()
+		 *
+		 * @return true if pending
+		 */
+		bool isPending() const { return pending_; }
+
+		// === Main Loop ===
+
+		/**
+		 * @brief Process the input events and apply the triggers
+		 *
+		 * Called at the start of the main loop, before the programs are
+		 * updated and the frame is flushed.
+		 *
+		 * @return true if a trigger was applied, the programs should be
+		 *         updated in this iteration
+		 */
+		bool handle();
+
+		/**
+		 * @brief Get the input counters
+		 *
+		 * @return Statistics
+		 */
+		const Stats& getStats() const { return stats_; }
+
+		// === Names ===
+
+		/**
+		 * @brief Get the name of a trigger edge
+		 *
+		 * @param edge Edge
+		 * @return "active", "inactive" or "change"
+		 */
+		static const char* getEdgeName(TriggerEdge edge);
+
+		/**
+		 * @brief Find a trigger edge by name
+		 *
+		 * @param name Edge name
+		 * @param edge Set to the edge, only on success
+		 * @return true if the name is known
+		 */
+		static bool edgeFromName(const char* name, TriggerEdge& edge);
+
+		/**
+		 * @brief Get the name of a trigger action
+		 *
+		 * @param action Action
+		 * @return "start", "stop", "retrigger" or "scene"
+		 */
+		static const char* getActionName(TriggerAction action);
+
+		/**
+		 * @brief Find a trigger action by name
+		 *
+		 * @param name Action name
+		 * @param action Set to the action, only on success
+		 * @return true if the name is known
+		 */
+		static bool actionFromName(const char* name, TriggerAction& action);
+
+	private:
+		/**
+		 * @brief Event pushed by an interrupt handler
+		 */
+		struct Event {
+			uint8_t source;         ///< Input index, or INPUT_MAX + expander index
+			uint8_t level;          ///< GPIO level read in the handler
+			uint32_t time_us;       ///< micros() in the handler
+		};
+
+		/**
+		 * @brief Argument of an interrupt handler
+		 */
+		struct IsrContext {
+			uint8_t source;         ///< Input index, or INPUT_MAX + expander index
+			uint8_t pin;            ///< GPIO to read
+		};
+
+		/**
+		 * @brief Debounce state of an input
+		 */
+		struct InputState {
+			bool active;            ///< Debounced state
+			bool locked;            ///< Within the debounce time of the last edge
+			unsigned long unlock;   ///< millis() at the end of the debounce time
+		};
+
+		/**
+		 * @brief Runtime state of an expander
+		 */
+		struct ExpanderState {
+			bool ready;             ///< Configured successfully
+			uint16_t levels;        ///< Last pin levels read (bit n = pin n)
+			unsigned long last_poll;    ///< millis() of the last read
+		};
+
+		Wiring wiring_;                                     ///< Active wiring
+		InputState inputs_[INPUT_MAX];                      ///< Debounce states
+		ExpanderState expanders_[EXPANDER_MAX];             ///< Expander states
+		bool armed_[TRIGGER_MAX];                           ///< Delayed trigger waiting
+		unsigned long due_[TRIGGER_MAX];                    ///< millis() the delayed trigger is due
+		uint32_t armed_time_us_[TRIGGER_MAX];               ///< Interrupt time of the edge that armed it
+		uint8_t armed_count_;                               ///< Number of delayed triggers waiting
+		bool attached_[INPUT_MAX + EXPANDER_MAX];           ///< Interrupt attached per source
+		IsrContext contexts_[INPUT_MAX + EXPANDER_MAX];     ///< Interrupt handler arguments
+		Wiring pending_wiring_;                             ///< Wiring queued by requestWiring()
+		volatile bool pending_;                             ///< A wiring is queued
+		bool triggered_;                                    ///< A trigger was applied in this handle()
+		Stats stats_;                                       ///< Input counters
+
+		static QueueHandle_t queue_;                        ///< Interrupt event queue
+		static volatile uint32_t overflows_;                ///< Events lost by the interrupt handlers
+
+		/**
+		 * @brief Interrupt handler of the GPIO inputs and expander INT lines
+		 *
+		 * @param arg IsrContext of the source
+		 */
+		static void IRAM_ATTR onInterrupt(void* arg);
+
+		/**
+		 * @brief Detach every interrupt
+		 */
+		void detachAll();
+
+		/**
+		 * @brief Configure an expander for interrupt-on-change
+		 *
+		 * @param index Expander index
+		 * @return true if the expander answered
+		 */
+		bool setupExpander(uint8_t index);
+
+		/**
+		 * @brief Read the pins of an expander and handle their changes
+		 *
+		 * Reading the GPIO registers also releases the INT line.
+		 *
+		 * @param index Expander index
+		 * @param time_us Interrupt time (micros())
+		 */
+		void readExpander(uint8_t index, uint32_t time_us);
+
+		/**
+		 * @brief Read the current level of an input
+		 *
+		 * @param index Input index
+		 * @return true if active
+		 */
+		bool readInput(uint8_t index);
+
+		/**
+		 * @brief Debounce a level of an input
+		 *
+		 * @param index Input index
+		 * @param active Level read (true = active)
+		 * @param time_us Interrupt time (micros())
+		 */
+		void onLevel(uint8_t index, bool active, uint32_t time_us);
+
+		/**
+		 * @brief Fire or arm the triggers of an input edge
+		 *
+		 * @param index Input index
+		 * @param active New state
+		 * @param time_us Interrupt time (micros())
+		 */
+		void onEdge(uint8_t index, bool active, uint32_t time_us);
+
+		/**
+		 * @brief Apply the action of a trigger
+		 *
+		 * @param index Trigger index
+		 * @param time_us Interrupt time of the edge (micros())
+		 */
+		void apply(uint8_t index, uint32_t time_us);
+};
+
+// Global instance
+/**
+ * @brief Global InputManager instance
+ *
+ * Created in setup() after the LED groups and scenes are loaded.
+ */
+extern std::unique_ptr<InputManager> input_manager;
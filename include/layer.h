@@ -0,0 +1,320 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Jérôme SONRIER
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * This file is part of emfao-light_control.
+ *
+ * emfao-light_control is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * emfao-light_control is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with emfao-light_control.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @file  layer.h
+ * @brief Layer stacks blending programs and masters over LED channels
+ *
+ * A LED runs one program. A layer stack adds two layers over it:
+ * - overlay: a second program (a welding flash over a firebox glow)
+ * - master: a shared level (the day/night dimmer of a whole district)
+ *
+ * Each layer is blended over the result of the layers below with its own
+ * mode. The blend runs in 12-bit fixed point when the PWM duty of the
+ * channel is computed, so that a master change reaches every channel using
+ * it in the next frame without touching their programs.
+ *
+ * @author  Jérôme SONRIER <jsid@emor3j.fr.eu.org>
+ * @date    2025-10-17
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <memory>
+
+#include "blend.h"
+#include "led.h"
+
+
+static_assert(LayerBlend::LEVEL_MAX == LED::MAX_BRIGHTNESS, "Blend levels must match the LED brightness range");
+
+/**
+ * @class LayerStack
+ * @brief Owner of the layer stacks and of the master levels
+ */
+class LayerStack {
+	public:
+		/// Maximum number of channels with a layer stack
+		static constexpr uint8_t STACK_MAX = 32;
+		/// Number of master levels
+		static constexpr uint8_t MASTER_MAX = 8;
+		/// No master layer
+		static constexpr uint8_t MASTER_NONE = 0xFF;
+		/// Layers of a full stack (base, overlay, master)
+		static constexpr uint8_t LAYER_MAX = 3;
+		/// Maximum number of benchmark rounds
+		static constexpr uint16_t BENCH_ROUNDS_MAX = 1000;
+
+		/**
+		 * @brief Layers of one channel
+		 */
+		struct Layers {
+			uint8_t module;             ///< Module index
+			uint8_t led;                ///< LED index within the module
+			uint8_t overlay_program;    ///< Overlay program (ProgramType, PROGRAM_NONE = no overlay)
+			uint8_t overlay_blend;      ///< Blend of the overlay (BlendMode)
+			uint8_t master;             ///< Master index, MASTER_NONE for no master layer
+			uint8_t master_blend;       ///< Blend of the master (BlendMode)
+		};
+
+		/**
+		 * @brief Every layer stack, with the master levels at boot
+		 */
+		struct Setup {
+			Layers stacks[STACK_MAX];       ///< Layer stacks
+			uint8_t count;                  ///< Number of layer stacks
+			uint16_t masters[MASTER_MAX];   ///< Master levels (0-4095)
+		};
+
+		/**
+		 * @brief Blend cost measured by the benchmark
+		 */
+		struct Bench {
+			uint16_t rounds;                ///< Rounds over STACK_MAX channels (0 if never run)
+			uint32_t elapsed_us[LAYER_MAX]; ///< Time of the rounds with 1 to LAYER_MAX layers
+			int32_t heap_delta;             ///< Free heap change during the benchmark (bytes)
+			uint16_t checksum;              ///< Sum of the blended levels, keeps the work observable
+		};
+
+		// === Constructor ===
+
+		/**
+		 * @brief Constructor, no layer stack and every master at full level
+		 */
+		LayerStack();
+
+		// === Blending ===
+
+		/**
+		 * @brief Blend the layers of a channel over its base level
+		 *
+		 * @param layers Layers of the channel
+		 * @param base Base level (LED brightness or program output)
+		 * @param overlay Overlay program output
+		 * @param masters Master levels
+		 * @return Output level (0-4095)
+		 */
+		static inline uint16_t composeLevels(const Layers& layers, uint16_t base, uint16_t overlay, const uint16_t* masters) {
+			uint16_t level = base;
+			if (layers.overlay_program != PROGRAM_NONE) {
+				level = LayerBlend::blend(layers.overlay_blend, level, overlay);
+			}
+			if (layers.master != MASTER_NONE) {
+				level = LayerBlend::blend(layers.master_blend, level, masters[layers.master]);
+			}
+			return level;
+		}
+
+		/**
+		 * @brief Output level of a channel, called when its PWM duty is computed
+		 *
+		 * @param slot Layer stack slot of the LED (1-based)
+		 * @param base Effective brightness of the LED
+		 * @return Output level (0-4095)
+		 */
+		uint16_t compose(uint8_t slot, uint16_t base) const {
+			const Stack& stack = stacks_[slot - 1];
+			return composeLevels(stack.layers, base, stack.overlay.getBrightness(), masters_);
+		}
+
+		// === Layer Stacks ===
+
+		/**
+		 * @brief Check a setup
+		 *
+		 * @param setup Layer stacks and master levels
+		 * @param error Set to the reason of a failure
+		 * @return true if valid
+		 */
+		static bool isValidSetup(const Setup& setup, String& error);
+
+		/**
+		 * @brief Replace the layer stacks and the master levels at once
+		 *
+		 * For setup(), after the modules and programs are initialized.
+		 *
+		 * @param setup Layer stacks and master levels
+		 * @return false if the setup is invalid
+		 */
+		bool setSetup(const Setup& setup);
+
+		/**
+		 * @brief Queue new layer stacks and master levels
+		 *
+		 * @param setup Layer stacks and master levels, checked by isValidSetup()
+		 * @return false if the setup is invalid or a request is pending
+		 */
+		bool requestSetup(const Setup& setup);
+
+		/**
+		 * @brief Get the layer stacks and the master levels at boot
+		 *
+		 * @return Setup
+		 */
+		const Setup& getSetup() const { return setup_; }
+
+		/**
+		 * @brief Queue a master level change
+		 *
+		 * Not saved: the setup holds the level at boot.
+		 *
+		 * @param index Master index
+		 * @param level New level (0-4095)
+		 * @return false if out of range or a request is pending
+		 */
+		bool requestMaster(uint8_t index, uint16_t level);
+
+		/**
+		 * @brief Get a master level
+		 *
+		 * @param index Master index
+		 * @return Level (0-4095), 0 if out of range
+		 */
+		uint16_t getMaster(uint8_t index) const { return index < MASTER_MAX ? masters_[index] : 0; }
+
+		/**
+		 * @brief Get the overlay program output of a layer stack
+		 *
+		 * @param index Layer stack index (0-based)
+		 * @return Level (0-4095), 0 if out of range
+		 */
+		uint16_t getOverlayLevel(uint8_t index) const { return index < setup_.count ? stacks_[index].overlay.getBrightness() : 0; }
+
+		// === Main Loop ===
+
+		/**
+		 * @brief Run the overlay programs
+		 *
+		 * Called by ProgramManager::update() after the base programs.
+		 *
+		 * @param current_millis Current system time in milliseconds
+		 */
+		void updateOverlays(unsigned long current_millis);
+
+		/**
+		 * @brief Apply the pending request and run a requested benchmark
+		 *
+		 * Called from the main loop before the frame flush.
+		 */
+		void handle();
+
+		/**
+		 * @brief Check if a request is waiting for handle()
+		 *
+		 * @return true if pending
+		 */
+		bool isPending() const { return pending_ != PendingType::NONE; }
+
+		// === Benchmark ===
+
+		/**
+		 * @brief Queue a blend benchmark
+		 *
+		 * Blends STACK_MAX synthetic channels with 1, 2 and 3 layers, every
+		 * blend mode in turn, and checks that the free heap is unchanged.
+		 *
+		 * @param rounds Rounds per layer count (1 to BENCH_ROUNDS_MAX)
+		 * @return false if out of range or a request is pending
+		 */
+		bool requestBench(uint16_t rounds);
+
+		/**
+		 * @brief Get the result of the last benchmark
+		 *
+		 * @return Benchmark result
+		 */
+		const Bench& getBench() const { return bench_; }
+
+		// === Names ===
+
+		/**
+		 * @brief Get the name of a blend mode
+		 *
+		 * @param mode Blend mode
+		 * @return "max", "multiply", "add" or "override"
+		 */
+		static const char* getBlendName(BlendMode mode);
+
+		/**
+		 * @brief Parse a blend mode name
+		 *
+		 * @param name Name returned by getBlendName()
+		 * @param mode Set to the blend mode
+		 * @return false if the name is unknown
+		 */
+		static bool blendFromName(const char* name, BlendMode& mode);
+
+	private:
+		/**
+		 * @brief Type of the pending request
+		 */
+		enum class PendingType : uint8_t {
+			NONE,
+			SETUP,
+			MASTER,
+			BENCH
+		};
+
+		/**
+		 * @brief Layers of a channel with the LED running its overlay program
+		 */
+		struct Stack {
+			Layers layers;              ///< Layers of the channel
+			LED overlay;                ///< Overlay program output, not a module channel
+		};
+
+		Setup setup_;                               ///< Layer stacks and master levels at boot
+		Stack stacks_[STACK_MAX];                   ///< Layer stacks in use
+		uint16_t masters_[MASTER_MAX];              ///< Live master levels
+
+		Setup pending_setup_;                       ///< Setup queued by requestSetup()
+		uint8_t pending_master_;                    ///< Master queued by requestMaster()
+		uint16_t pending_level_;                    ///< Level of the queued master
+		uint16_t pending_rounds_;                   ///< Rounds of the queued benchmark
+		volatile PendingType pending_;              ///< Type of the queued request
+		Bench bench_;                               ///< Result of the last benchmark
+
+		/**
+		 * @brief Detach every channel and stop the overlay programs
+		 */
+		void detach();
+
+		/**
+		 * @brief Mark the channels using a master dirty
+		 *
+		 * @param index Master index
+		 */
+		void applyMaster(uint8_t index);
+
+		/**
+		 * @brief Run the blend benchmark
+		 *
+		 * @param rounds Rounds per layer count
+		 */
+		void runBench(uint16_t rounds);
+};
+
+// Global instance
+/**
+ * @brief Global LayerStack instance
+ *
+ * Created in setup() after the program manager, which runs the overlay
+ * programs.
+ */
+extern std::unique_ptr<LayerStack> layer_stack;
@@ -27,6 +27,7 @@
 
 #include <Arduino.h>
 
+#include "curve.h"
 #include "program.h"
 
 
@@ -44,6 +45,14 @@ class LED {
 		bool enabled_;                    ///< Enable/disable state of the LED
 		ProgramType program_type_;        ///< Type of program currently running
 		ProgramState* program_state_;     ///< Pointer to current program state
+		CurveType curve_;                 ///< Transfer curve (CURVE_DEFAULT = module curve)
+		bool dither_;                     ///< Temporal dithering of the fractional PWM duty
+		uint16_t rated_ma_;               ///< Current at full duty in mA (0 = module rating)
+		uint8_t priority_;                ///< Power budget priority (higher is dimmed last)
+		uint8_t transition_;              ///< Running transition slot (0 = none)
+		uint16_t fade_from_;              ///< Output level when the transition started
+		uint16_t fade_delay_;             ///< Time between the transition start and the LED joining it (ms)
+		uint8_t layers_;                  ///< Layer stack slot blended over the brightness (0 = none)
 
 	public:
 		// === Constructor and Destructor ===
@@ -57,6 +66,10 @@ class LED {
 		 * - Enabled: false
 		 * - Program: PROGRAM_NONE
 		 * - Program state: nullptr
+		 * - Curve: CURVE_DEFAULT
+		 * - Dithering: disabled
+		 * - Rated current: module rating
+		 * - Power priority: 0
 		 */
 		LED();
 
@@ -107,6 +120,9 @@ class LED {
 		/**
 		 * @brief Get current brightness level
 		 * 
+		 * Perceptual level, converted into PWM duty by the LED transfer
+		 * curve when the output frame is built.
+		 * 
 		 * @return Brightness value (0-4095)
 		 */
 		uint16_t getBrightness() const { return brightness_; }
@@ -132,6 +148,55 @@ class LED {
 		 */
 		ProgramState* getProgramState() const { return program_state_; }
 
+		/**
+		 * @brief Get transfer curve
+		 * 
+		 * @return Curve of this LED (CURVE_DEFAULT if the module curve is used)
+		 */
+		CurveType getCurve() const { return curve_; }
+
+		/**
+		 * @brief Check if temporal dithering is enabled
+		 * 
+		 * @return true if the fractional PWM duty is dithered across frames
+		 */
+		bool isDitherEnabled() const { return dither_; }
+
+		/**
+		 * @brief Get rated current
+		 * 
+		 * @return Current drawn at full duty in mA (0 if the module rating is used)
+		 */
+		uint16_t getRatedCurrent() const { return rated_ma_; }
+
+		/**
+		 * @brief Get power budget priority
+		 * 
+		 * @return Priority (0 to PRIORITY_MAX, higher is dimmed last)
+		 */
+		uint8_t getPriority() const { return priority_; }
+
+		/**
+		 * @brief Get the transition the LED is fading with
+		 * 
+		 * @return Transition slot (0 = none)
+		 */
+		uint8_t getTransition() const { return transition_; }
+
+		/**
+		 * @brief Get when the LED joined its transition
+		 * 
+		 * @return Milliseconds after the transition start
+		 */
+		uint16_t getFadeDelay() const { return fade_delay_; }
+
+		/**
+		 * @brief Get the layer stack blended over the LED
+		 * 
+		 * @return Layer stack slot (0 = none)
+		 */
+		uint8_t getLayers() const { return layers_; }
+
 
 		// === Setters ===
 
@@ -167,6 +232,59 @@ class LED {
 		void setProgram(ProgramType program_type = PROGRAM_NONE,
 			ProgramState* program_state = nullptr);
 
+		/**
+		 * @brief Set transfer curve
+		 * 
+		 * @param curve New curve (CURVE_DEFAULT to use the module curve)
+		 */
+		void setCurve(CurveType curve) { curve_ = curve; }
+
+		/**
+		 * @brief Enable or disable temporal dithering
+		 * 
+		 * When enabled, the fraction of PWM duty the transfer curve gives
+		 * below one 12-bit step is rendered by alternating the two nearest
+		 * duties across frames, smoothing deep dimming.
+		 * 
+		 * @param dither New dithering state
+		 */
+		void setDither(bool dither) { dither_ = dither; }
+
+		/**
+		 * @brief Set rated current
+		 * 
+		 * @param rated_ma Current drawn at full duty in mA (0 to use the module rating)
+		 * @return true if the current is valid (up to RATED_MA_MAX)
+		 */
+		bool setRatedCurrent(uint16_t rated_ma);
+
+		/**
+		 * @brief Set power budget priority
+		 * 
+		 * When the power budget is exceeded in priority mode, LEDs of lower
+		 * priority are dimmed first.
+		 * 
+		 * @param priority Priority (0 to PRIORITY_MAX)
+		 * @return true if the priority is valid
+		 */
+		bool setPriority(uint8_t priority);
+
+		/**
+		 * @brief Attach the LED to a transition
+		 * 
+		 * @param slot Transition slot (0 to stop fading)
+		 * @param from Output level the transition starts from
+		 * @param delay Milliseconds between the transition start and now
+		 */
+		void setTransition(uint8_t slot, uint16_t from, uint16_t delay = 0) { transition_ = slot; fade_from_ = from; fade_delay_ = delay; }
+
+		/**
+		 * @brief Attach the LED to a layer stack
+		 * 
+		 * @param slot Layer stack slot (0 to detach)
+		 */
+		void setLayers(uint8_t slot) { layers_ = slot; }
+
 		
 		// === Utility Methods ===
 
@@ -214,9 +332,24 @@ class LED {
 		 */
 		uint16_t getEffectiveBrightness() const;
 
+		/**
+		 * @brief Get output brightness
+		 * 
+		 * Effective brightness with its overlay and master layers blended
+		 * over it, crossfaded from the start level while a transition is
+		 * running.
+		 * 
+		 * @return Brightness written to the PWM channel (0-4095)
+		 */
+		uint16_t getOutputBrightness() const;
+
 
 		// === Static Constants ===
 		
 		static constexpr uint16_t MIN_BRIGHTNESS = 0;      ///< Minimum brightness value
 		static constexpr uint16_t MAX_BRIGHTNESS = 4095;   ///< Maximum brightness value (12-bit PWM)
+		static constexpr uint16_t RATED_MA_MAX = 1000;     ///< Maximum rated current of a channel (mA)
+		static constexpr uint8_t PRIORITY_MAX = 3;         ///< Highest power budget priority
+
+		static_assert(MAX_BRIGHTNESS == BrightnessCurve::LEVEL_MAX, "LED levels are the curve inputs");
 };
\ No newline at end of file
@@ -32,6 +32,8 @@
  * - Timestamped log entries
  * - Web API integration for real-time log viewing
  * - Hardware Serial preservation for development
+ * - Compile-time level filtering (LOG_MIN_LEVEL build flag)
+ * - Per-tag runtime levels checked before any formatting
  * 
  * @author  Jérôme SONRIER <jsid@emor3j.fr.eu.org>
  * @date    2025-09-20
@@ -42,6 +44,21 @@
 #include <Arduino.h>
 #include <vector>
 #include <string>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+/**
+ * @def LOG_MIN_LEVEL
+ * @brief Compile-time minimum log level
+ * 
+ * LOG_* macros below this level expand to nothing, so neither the
+ * formatting nor the evaluation of their arguments is compiled in.
+ * Values match LogLevel: 0=DEBUG, 1=INFO, 2=WARNING, 3=ERROR.
+ * Override with a build flag, e.g. -DLOG_MIN_LEVEL=1 in platformio.ini.
+ */
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL 0
+#endif
 
 /**
  * @enum LogLevel
@@ -51,7 +68,8 @@ enum class LogLevel {
     DEBUG = 0,
     INFO = 1,
     WARNING = 2,
-    ERROR = 3
+    ERROR = 3,
+    NONE = 4      ///< Runtime level only: silences a tag completely
 };
 
 /**
@@ -59,12 +77,13 @@ enum class LogLevel {
  * @brief Structure representing a single log entry
  */
 struct LogEntry {
+    uint32_t sequence;         ///< Monotonic sequence number (first entry is 1)
     unsigned long timestamp;    ///< Timestamp in milliseconds since boot
     LogLevel level;            ///< Log level
     std::string message;       ///< Complete log message
     
-    LogEntry(unsigned long ts, LogLevel lvl, const std::string& msg) 
-        : timestamp(ts), level(lvl), message(msg) {}
+    LogEntry(uint32_t seq, unsigned long ts, LogLevel lvl, const std::string& msg) 
+        : sequence(seq), timestamp(ts), level(lvl), message(msg) {}
 };
 
 /**
@@ -85,6 +104,21 @@ struct LogEntry {
  * - Configurable buffer size and retention
  */
 class LogManager {
+public:
+    /// Maximum number of tags with a dedicated runtime level
+    static constexpr size_t TAG_LEVEL_MAX = 24;
+    /// Maximum tag length, without brackets
+    static constexpr size_t TAG_LENGTH_MAX = 15;
+
+    /**
+     * @struct TagLevel
+     * @brief Runtime level override for one log tag (e.g. "PROGRAMMGR")
+     */
+    struct TagLevel {
+        char tag[TAG_LENGTH_MAX + 1];      ///< Tag name without brackets
+        LogLevel level;                    ///< Minimum level logged for this tag
+    };
+
 private:
     static LogManager* instance_;           ///< Singleton instance
     
@@ -92,8 +126,16 @@ private:
     size_t buffer_size_;                   ///< Maximum buffer entries
     size_t current_index_;                 ///< Current write position in circular buffer
     bool buffer_full_;                     ///< Flag indicating if buffer has wrapped
+    uint32_t next_sequence_;               ///< Sequence number of the next entry
+    SemaphoreHandle_t buffer_mutex_;       ///< Guards log_buffer_ and tag_levels_ between tasks
     
     std::string temp_buffer_;              ///< Temporary buffer for formatting
+    
+    LogLevel default_level_;               ///< Runtime level for untagged or unlisted tags
+    TagLevel tag_levels_[TAG_LEVEL_MAX];   ///< Per-tag runtime levels
+    size_t tag_level_count_;               ///< Number of used tag_levels_ entries
+    LogLevel lowest_level_;                ///< Lowest level among default and tag levels
+    LogLevel highest_level_;               ///< Highest level among default and tag levels
 
 public:
     /**
@@ -149,6 +191,93 @@ public:
      */
     void log(LogLevel level, const char* message);
     
+    // === Runtime Level Filtering ===
+    
+    /**
+     * @brief Check whether a message would be logged, before formatting it
+     * 
+     * The tag is read from the "[TAG]" prefix of the format string. Levels
+     * above every configured level or below all of them are decided without
+     * looking at the tag at all.
+     * 
+     * @param level Log level of the message
+     * @param format Format string (or message) starting with an optional "[TAG]"
+     * @return true if the message must be formatted and stored
+     */
+    bool isEnabled(LogLevel level, const char* format) const {
+        if (level >= highest_level_) {
+            return true;
+        }
+        if (level < lowest_level_) {
+            return false;
+        }
+        return level >= getLevelForFormat(format);
+    }
+    
+    /**
+     * @brief Check whether any tag could log a level, without a message
+     * 
+     * Cheap pre-check for callers that would have to build the message
+     * before isEnabled() can read its tag.
+     * 
+     * @param level Log level of the message
+     * @return false if the level is below every configured level
+     */
+    bool isLevelEnabled(LogLevel level) const { return level >= lowest_level_; }
+    
+    /**
+     * @brief Set the runtime level of a tag
+     * @param tag Tag name, with or without brackets (e.g. "WEBSERVER")
+     * @param level Minimum level to log for this tag
+     * @return false if the tag is invalid or the tag table is full
+     */
+    bool setTagLevel(const char* tag, LogLevel level);
+    
+    /**
+     * @brief Remove the runtime level of a tag (falls back to default level)
+     * @param tag Tag name, with or without brackets
+     * @return true if the tag had a dedicated level
+     */
+    bool clearTagLevel(const char* tag);
+    
+    /**
+     * @brief Set the runtime level used for tags without a dedicated level
+     * @param level Minimum level to log
+     */
+    void setDefaultLevel(LogLevel level);
+    
+    /**
+     * @brief Get the runtime level used for tags without a dedicated level
+     * @return Default runtime level
+     */
+    LogLevel getDefaultLevel() const { return default_level_; }
+    
+    /**
+     * @brief Copy the table of per-tag runtime levels
+     * 
+     * The table is copied under the buffer mutex, since clearTagLevel()
+     * compacts it while other tasks may log.
+     * 
+     * @param out Array of at least TAG_LEVEL_MAX entries
+     * @return Number of entries copied
+     */
+    size_t getTagLevels(TagLevel* out) const;
+    
+    /**
+     * @brief Get log level string representation
+     * @param level Log level to convert
+     * @return String representation of log level
+     */
+    static const char* getLevelString(LogLevel level);
+    
+    /**
+     * @brief Parse a level name ("DEBUG", "INFO", "WARN", "WARNING", "ERROR", "NONE")
+     * @param name Level name, case sensitive
+     * @param level Parsed level
+     * @return true if the name is a known level
+     */
+    static bool parseLevel(const char* name, LogLevel& level);
+    
     // === Log Retrieval Methods ===
     
     /**
@@ -171,6 +300,27 @@ public:
      */
     std::vector<LogEntry> getLogsSince(unsigned long since_timestamp) const;
     
+    /**
+     * @brief Copy entries newer than a cursor
+     * 
+     * Only the requested entries are copied, oldest first, so the cost is
+     * proportional to the number of new entries rather than to the buffer size.
+     * If the cursor is older than the oldest retained entry, copying starts
+     * at the oldest entry (the caller can detect the gap from the sequence).
+     * 
+     * @param cursor Sequence number of the last entry already seen (0 for none)
+     * @param max_count Maximum number of entries to copy
+     * @param out Vector the entries are appended to
+     * @return Number of entries appended
+     */
+    size_t getLogsAfter(uint32_t cursor, size_t max_count, std::vector<LogEntry>& out) const;
+    
+    /**
+     * @brief Get the sequence number of the most recent entry
+     * @return Last sequence number, 0 if nothing was ever logged
+     */
+    uint32_t getLastSequence() const { return next_sequence_ - 1; }
+    
     /**
      * @brief Clear all stored logs
      */
@@ -197,55 +347,129 @@ private:
     void addLogEntry(LogLevel level, const std::string& message);
     
     /**
-     * @brief Get log level string representation
-     * @param level Log level to convert
-     * @return String representation of log level
+     * @brief Get the runtime level applying to a format string's tag
+     * @param format Format string starting with an optional "[TAG]"
+     * @return Tag level if the tag has one, default level otherwise
      */
-    static const char* getLevelString(LogLevel level);
+    LogLevel getLevelForFormat(const char* format) const;
+    
+    /**
+     * @brief Find a tag in the tag level table
+     * @param tag Tag name without brackets
+     * @param length Tag name length
+     * @return Index of the entry, or TAG_LEVEL_MAX if not found
+     */
+    size_t findTag(const char* tag, size_t length) const;
+    
+    /**
+     * @brief Get physical buffer index of the n-th oldest entry
+     * @param n Position from the oldest entry (0 = oldest)
+     * @return Index in log_buffer_
+     */
+    size_t physicalIndex(size_t n) const;
+    
+    /**
+     * @brief Take the buffer mutex
+     */
+    void lockBuffer() const;
+    
+    /**
+     * @brief Release the buffer mutex
+     */
+    void unlockBuffer() const;
+    
+    /**
+     * @brief Recompute lowest_level_ and highest_level_ after a level change
+     */
+    void updateLevelBounds();
 };
 
 // === CONVENIENT LOGGING MACROS ===
 
+/**
+ * @brief Log a message if its level and tag pass the runtime filter
+ * 
+ * Arguments are only evaluated and formatted when the message is enabled.
+ * 
+ * @param level Log level
+ * @param format Printf-style format string
+ * @param ... Arguments for formatting
+ */
+#define LOG_AT_LEVEL(level, format, ...) \
+    do { \
+        if (LogManager::getInstance().isEnabled(level, format)) { \
+            LogManager::getInstance().log(level, format, ##__VA_ARGS__); \
+        } \
+    } while (0)
+
 /**
  * @brief Log debug message with printf-style formatting
  * @param format Printf-style format string
  * @param ... Arguments for formatting
  */
-#define LOG_DEBUG(format, ...) LogManager::getInstance().log(LogLevel::DEBUG, format, ##__VA_ARGS__)
+#if LOG_MIN_LEVEL <= 0
+#define LOG_DEBUG(format, ...) LOG_AT_LEVEL(LogLevel::DEBUG, format, ##__VA_ARGS__)
+#else
+#define LOG_DEBUG(format, ...) do {} while (0)
+#endif
 
 /**
  * @brief Log info message with printf-style formatting
  * @param format Printf-style format string
  * @param ... Arguments for formatting
  */
-#define LOG_INFO(format, ...) LogManager::getInstance().log(LogLevel::INFO, format, ##__VA_ARGS__)
+#if LOG_MIN_LEVEL <= 1
+#define LOG_INFO(format, ...) LOG_AT_LEVEL(LogLevel::INFO, format, ##__VA_ARGS__)
+#else
+#define LOG_INFO(format, ...) do {} while (0)
+#endif
 
 /**
  * @brief Log warning message with printf-style formatting
  * @param format Printf-style format string
  * @param ... Arguments for formatting
  */
-#define LOG_WARNING(format, ...) LogManager::getInstance().log(LogLevel::WARNING, format, ##__VA_ARGS__)
+#if LOG_MIN_LEVEL <= 2
+#define LOG_WARNING(format, ...) LOG_AT_LEVEL(LogLevel::WARNING, format, ##__VA_ARGS__)
+#else
+#define LOG_WARNING(format, ...) do {} while (0)
+#endif
 
 /**
  * @brief Log error message with printf-style formatting
  * @param format Printf-style format string
  * @param ... Arguments for formatting
  */
-#define LOG_ERROR(format, ...) LogManager::getInstance().log(LogLevel::ERROR, format, ##__VA_ARGS__)
+#if LOG_MIN_LEVEL <= 3
+#define LOG_ERROR(format, ...) LOG_AT_LEVEL(LogLevel::ERROR, format, ##__VA_ARGS__)
+#else
+#define LOG_ERROR(format, ...) do {} while (0)
+#endif
 
 /**
  * @brief General log message with printf-style formatting (INFO level)
  * @param format Printf-style format string
  * @param ... Arguments for formatting
  */
-#define LOG_PRINTF(format, ...) LogManager::getInstance().log(LogLevel::INFO, format, ##__VA_ARGS__)
+#define LOG_PRINTF(format, ...) LOG_INFO(format, ##__VA_ARGS__)
 
 /**
  * @brief Simple string logging (INFO level)
  * @param message String message to log
  */
-#define LOG_PRINTLN(message) LogManager::getInstance().log(LogLevel::INFO, std::string(message) + "\n")
+#if LOG_MIN_LEVEL <= 1
+#define LOG_PRINTLN(message) \
+    do { \
+        if (LogManager::getInstance().isLevelEnabled(LogLevel::INFO)) { \
+            std::string log_line_(message); \
+            if (LogManager::getInstance().isEnabled(LogLevel::INFO, log_line_.c_str())) { \
+                LogManager::getInstance().log(LogLevel::INFO, log_line_ + "\n"); \
+            } \
+        } \
+    } while (0)
+#else
+#define LOG_PRINTLN(message) do {} while (0)
+#endif
 
 /**
  * @brief Global LogManager instance for direct access
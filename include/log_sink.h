@@ -0,0 +1,262 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Jérôme SONRIER
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * This file is part of emfao-light_control.
+ *
+ * emfao-light_control is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * emfao-light_control is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with emfao-light_control.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @file  log_sink.h
+ * @brief Persistent log sinks surviving resets
+ *
+ * The LogManager buffer lives in RAM and is lost on every reset. This file
+ * provides two additional destinations fed by LogManager:
+ * - RtcLogTail: the last log lines kept in RTC slow memory, which is not
+ *   cleared by software resets, panics, watchdogs or brownouts. The tail of
+ *   the previous boot is snapshotted before being overwritten.
+ * - FileLogSink: an optional rotating log file on LittleFS, written in large
+ *   blocks by a background task so that logging never waits for the flash.
+ *
+ * @author  Jérôme SONRIER <jsid@emor3j.fr.eu.org>
+ * @date    2025-10-17
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <esp_system.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "log.h"
+
+
+/**
+ * @class RtcLogTail
+ * @brief Last log lines kept in RTC slow memory across resets
+ *
+ * Entries are stored in a small fixed ring of truncated messages placed in
+ * RTC_NOINIT memory. On the first use after boot, a valid ring left by the
+ * previous boot is copied aside together with the reset reason, then the
+ * ring is restarted for the current boot.
+ *
+ * @note All methods are static as the RTC area is unique
+ * @note append() is called by LogManager with its buffer lock held
+ */
+class RtcLogTail {
+	public:
+		/// Number of entries kept in RTC memory
+		static constexpr size_t SLOT_COUNT = 32;
+		/// Maximum stored message length (longer messages are truncated)
+		static constexpr size_t MESSAGE_MAX = 80;
+
+		/**
+		 * @brief Snapshot the previous boot tail and restart the ring
+		 *
+		 * Called automatically on the first append; calling it explicitly
+		 * early in setup() is harmless.
+		 */
+		static void begin();
+
+		/**
+		 * @brief Store a log entry in RTC memory
+		 * @param sequence Entry sequence number
+		 * @param timestamp Timestamp in milliseconds since boot
+		 * @param level Log level
+		 * @param message Message (truncated to MESSAGE_MAX characters)
+		 */
+		static void append(uint32_t sequence, unsigned long timestamp, LogLevel level, const std::string& message);
+
+		/**
+		 * @brief Check whether a tail from the previous boot was recovered
+		 * @return true if the previous boot left a valid tail
+		 */
+		static bool hasPreviousBoot();
+
+		/**
+		 * @brief Copy the tail of the previous boot, oldest first
+		 * @param out Vector the entries are appended to
+		 * @return Number of entries appended
+		 */
+		static size_t getPreviousBoot(std::vector<LogEntry>& out);
+
+		/**
+		 * @brief Get the reset reason of the current boot
+		 * @return ESP-IDF reset reason
+		 */
+		static esp_reset_reason_t getResetReason();
+
+		/**
+		 * @brief Get a readable name for a reset reason
+		 * @param reason ESP-IDF reset reason
+		 * @return Reset reason name (e.g. "BROWNOUT")
+		 */
+		static const char* getResetReasonString(esp_reset_reason_t reason);
+
+		/**
+		 * @brief Get the number of boots recorded in RTC memory
+		 *
+		 * Restarted from 1 after a power-on reset or a corrupted area.
+		 *
+		 * @return Boot counter
+		 */
+		static uint32_t getBootCount();
+};
+
+
+/**
+ * @class FileLogSink
+ * @brief Rotating LittleFS log file written by a background task
+ *
+ * Log lines are appended to one of two RAM blocks. When the active block is
+ * full (or every FLUSH_INTERVAL_MS), blocks are swapped and a low priority
+ * task on the other core writes the full block with a single file write.
+ * When both blocks are busy, new lines are dropped and counted rather than
+ * waiting for the flash.
+ *
+ * When the current file exceeds FILE_SIZE_MAX, it is renamed to the previous
+ * file (replacing it) and a new file is started.
+ *
+ * Line format: "<sequence> <timestamp_ms> <LEVEL> <message>"
+ */
+class FileLogSink {
+	public:
+		/// Size of each RAM block written in one operation
+		static constexpr size_t BLOCK_SIZE = 4096;
+		/// Size above which the current file is rotated
+		static constexpr size_t FILE_SIZE_MAX = 64 * 1024;
+		/// Maximum delay before a partially filled block is written
+		static constexpr unsigned long FLUSH_INTERVAL_MS = 5000;
+		/// Directory containing log files
+		static const char* DIRECTORY;
+		/// Path of the file being written
+		static const char* CURRENT_PATH;
+		/// Path of the previous (rotated) file
+		static const char* PREVIOUS_PATH;
+
+		/**
+		 * @brief Constructor
+		 */
+		FileLogSink();
+
+		/**
+		 * @brief Destructor, stops the writer task
+		 */
+		~FileLogSink();
+
+		/**
+		 * @brief Mount LittleFS, open the log file and start the writer task
+		 * @return true if the sink is running, false if it failed or is still stopping
+		 */
+		bool begin();
+
+		/**
+		 * @brief Write pending lines and stop the writer task
+		 *
+		 * Waits for the writer task to exit: not for the web server task,
+		 * which uses requestStop().
+		 */
+		void end();
+
+		/**
+		 * @brief Ask the writer task to write pending lines and stop
+		 *
+		 * Returns at once; the task closes the file and exits on its own.
+		 */
+		void requestStop();
+
+		/**
+		 * @brief Check whether the sink is running
+		 * @return true if lines are being written to the file
+		 */
+		bool isRunning() const { return task_ != nullptr; }
+
+		/**
+		 * @brief Check whether the writer task is finishing after requestStop()
+		 * @return true until the task has exited
+		 */
+		bool isStopping() const { return task_ != nullptr && stop_requested_; }
+
+		/**
+		 * @brief Queue a log line for writing
+		 *
+		 * Only copies the line to the active RAM block; never touches the
+		 * file system. Lines are ignored once a stop is requested, so that
+		 * none is queued after the final write.
+		 *
+		 * @param sequence Entry sequence number
+		 * @param timestamp Timestamp in milliseconds since boot
+		 * @param level Log level
+		 * @param message Message
+		 */
+		void append(uint32_t sequence, unsigned long timestamp, LogLevel level, const std::string& message);
+
+		/**
+		 * @brief Get the number of lines dropped because both blocks were busy
+		 * @return Dropped line count
+		 */
+		uint32_t getDroppedCount() const { return dropped_; }
+
+		/**
+		 * @brief Get the number of bytes written to files since begin()
+		 * @return Written byte count
+		 */
+		uint32_t getWrittenBytes() const { return written_bytes_; }
+
+	private:
+		std::unique_ptr<char[]> blocks_;	///< Two consecutive blocks of BLOCK_SIZE bytes
+		size_t fill_[2];			///< Used bytes of each block
+		uint8_t active_;			///< Index of the block receiving lines
+		bool pending_;				///< Inactive block is waiting to be written
+		SemaphoreHandle_t mutex_;		///< Guards blocks, indexes and the task handle
+		TaskHandle_t task_;			///< Writer task handle, cleared under mutex_ when it exits
+		volatile bool stop_requested_;		///< Asks the writer task to exit
+		uint32_t dropped_;			///< Dropped line counter
+		uint32_t written_bytes_;		///< Written byte counter
+		File file_;				///< Current log file
+
+		/**
+		 * @brief Writer task entry point
+		 * @param param FileLogSink instance
+		 */
+		static void taskEntry(void* param);
+
+		/**
+		 * @brief Writer task main loop
+		 */
+		void taskLoop();
+
+		/**
+		 * @brief Write the pending block, swapping a partial block if needed
+		 * @param force Swap the active block even if it is not full
+		 */
+		void writePending(bool force);
+
+		/**
+		 * @brief Rotate the current file when it is too large
+		 */
+		void rotateIfNeeded();
+};
+
+/**
+ * @brief Global FileLogSink instance
+ *
+ * Created in setup(); null while the file sink has never been created.
+ */
+extern std::unique_ptr<FileLogSink> file_log_sink;
@@ -27,10 +27,16 @@
 
 #include <Arduino.h>
 #include <Adafruit_PWMServoDriver.h>
+#include <Wire.h>
+#include <atomic>
 #include <memory>
 #include <vector>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
 
 #include "led.h"
+#include "pwm_phase.h"
 #include "driver/i2c.h"
 
 
@@ -89,15 +95,183 @@ class PCA9685Module {
 		 * to drive LEDs or servos.
 		 */
 		static constexpr uint8_t LED_MAX = 16;
+
+		/**
+		 * @var BUS_COUNT
+		 * @brief Number of I2C buses (ESP32 I2C controllers) modules can use.
+		 */
+		static constexpr uint8_t BUS_COUNT = 2;
+
+		/// MODE1 register address
+		static constexpr uint8_t REG_MODE1 = 0x00;
+
+		/// MODE2 register address
+		static constexpr uint8_t REG_MODE2 = 0x01;
+
+		/// SUBADR1 register address (I2C sub-address of broadcast group 1)
+		static constexpr uint8_t REG_SUBADR1 = 0x02;
+
+		/// SUBADR2 register address (I2C sub-address of broadcast group 2)
+		static constexpr uint8_t REG_SUBADR2 = 0x03;
+
+		/// SUBADR3 register address (I2C sub-address 3, free for read/write checks)
+		static constexpr uint8_t REG_SUBADR3 = 0x04;
+
+		/// ALLCALLADR register address (I2C "All Call" address)
+		static constexpr uint8_t REG_ALLCALLADR = 0x05;
+
+		/// LED0_ON_L register address, each channel uses 4 registers from here
+		static constexpr uint8_t REG_LED0_ON_L = 0x06;
+
+		/// ALL_LED_ON_L register address, writes the 4 registers of every channel at once
+		static constexpr uint8_t REG_ALL_LED_ON_L = 0xFA;
+
+		/// PRE_SCALE register address (writable only in sleep mode)
+		static constexpr uint8_t REG_PRESCALE = 0xFE;
+
+		/// MODE1 bits
+		static constexpr uint8_t MODE1_RESTART = 0x80;
+		static constexpr uint8_t MODE1_AI = 0x20;
+		static constexpr uint8_t MODE1_SLEEP = 0x10;
+		static constexpr uint8_t MODE1_SUB1 = 0x08;
+		static constexpr uint8_t MODE1_SUB2 = 0x04;
+		static constexpr uint8_t MODE1_ALLCALL = 0x01;
+
+		/// MODE2 bits
+		static constexpr uint8_t MODE2_OCH = 0x08;      ///< Outputs change on ACK (cleared: on STOP)
+		static constexpr uint8_t MODE2_OUTDRV = 0x04;   ///< Totem pole outputs (power-on default)
+
+		/**
+		 * @brief MODE2 value of every module
+		 *
+		 * OCH cleared: LED registers written in a transaction take effect at
+		 * its STOP, so every channel of a burst changes in the same PWM period.
+		 */
+		static constexpr uint8_t MODE2_DEFAULT = MODE2_OUTDRV;
+
+		/**
+		 * @brief MODE1 value of every module in normal operation
+		 *
+		 * Identical on all modules so that MODE1 can be written by broadcast;
+		 * broadcast group membership is selected by the SUBADRx values.
+		 */
+		static constexpr uint8_t MODE1_DEFAULT = MODE1_AI | MODE1_SUB1 | MODE1_SUB2 | MODE1_ALLCALL;
+
+		/// Number of broadcast groups (SUBADR1 and SUBADR2, SUBADR3 is kept for register checks)
+		static constexpr uint8_t BROADCAST_GROUP_COUNT = 2;
+
+		/// Internal oscillator frequency assumed for prescale computation (Hz)
+		static constexpr uint32_t OSCILLATOR_FREQUENCY = 27000000;
+
+		/// Lowest accepted oscillator calibration (Hz)
+		static constexpr uint32_t OSCILLATOR_MIN = 20000000;
+
+		/// Highest accepted oscillator calibration (Hz)
+		static constexpr uint32_t OSCILLATOR_MAX = 30000000;
+
+		/// Default PWM output frequency, good for LEDs (Hz)
+		static constexpr uint16_t PWM_FREQUENCY = 1600;
+
+		/// Lowest configurable PWM frequency (Hz)
+		static constexpr uint16_t PWM_FREQUENCY_MIN = 24;
+
+		/// Highest configurable PWM frequency (Hz)
+		static constexpr uint16_t PWM_FREQUENCY_MAX = 1600;
+
+		/// Lowest prescale accepted by the chip (highest PWM frequency)
+		static constexpr uint8_t PRESCALE_MIN = 3;
+
+		/// PWM periods averaged by oscillator calibration
+		static constexpr uint8_t CALIBRATION_PERIODS = 16;
+
+		/// Timeout of one pulse measurement during calibration (microseconds)
+		static constexpr unsigned long CALIBRATION_PULSE_TIMEOUT_US = 100000;
+
+		/// PWM counter steps per period (12-bit counter)
+		static constexpr uint16_t PWM_STEPS = PwmPhase::STEPS;
+
+		/// Timeout of one native driver transaction (milliseconds)
+		static constexpr uint32_t TRANSACTION_TIMEOUT_MS = 10;
+
+		/// Consecutive failed transactions before a module is backed off
+		static constexpr uint8_t FAILURE_THRESHOLD = 3;
+
+		/// First back-off delay of a failing module (milliseconds)
+		static constexpr uint32_t BACKOFF_MIN_MS = 250;
+
+		/// Longest back-off delay of a failing module (milliseconds)
+		static constexpr uint32_t BACKOFF_MAX_MS = 10000;
+
+		/// Default rated current of a channel at full duty (mA)
+		static constexpr uint16_t RATED_MA_DEFAULT = 20;
+
+		/// Number of power budget priorities
+		static constexpr uint8_t POWER_PRIORITIES = LED::PRIORITY_MAX + 1;
+
+		/// Power scale leaving intensities unchanged (Q16 fixed point 1.0)
+		static constexpr uint32_t POWER_SCALE_ONE = 1u << 16;
+
+		/**
+		 * @brief Register access path used to write the PCA9685
+		 */
+		enum class Driver : uint8_t {
+			NATIVE = 0,     ///< ESP-IDF command links, one burst per module and flush
+			ADAFRUIT = 1    ///< Adafruit_PWMServoDriver over Wire, one transaction per channel
+		};
+
+		/**
+		 * @brief Bus health of a module
+		 */
+		enum class Health : uint8_t {
+			OK = 0,         ///< Last transaction succeeded
+			DEGRADED = 1,   ///< Recent transactions failed, still written every frame
+			OFFLINE = 2     ///< Backed off: skipped by frames until a health check succeeds
+		};
+
+		/**
+		 * @brief Transaction and recovery counters of a module
+		 */
+		struct HealthStats {
+			uint32_t errors;            ///< Failed transactions (all causes)
+			uint32_t nacks;             ///< Transactions not acknowledged by the chip
+			uint32_t timeouts;          ///< Transactions that timed out (bus stuck or busy)
+			uint32_t resets;            ///< Chip resets detected by MODE1 readback
+			uint32_t reinits;           ///< Successful re-initializations
+			uint8_t consecutive;        ///< Consecutive failed transactions
+		};
 		
 	private:
 		uint8_t address_;                                    ///< I2C address of the module
+		uint8_t bus_;                                        ///< I2C bus index (0 = Wire, 1 = Wire1)
+		TwoWire* wire_;                                      ///< I2C controller of the bus
 		bool detected_;                                      ///< Whether module was detected during scan
 		bool initialized_;                                   ///< Whether module is properly initialized
 		String name_;                                        ///< User-friendly name for the module
 		uint8_t led_count_;                                  ///< Number of LEDs on this module
 		std::unique_ptr<LED[]> leds_;                        ///< Array of LED objects
 		std::unique_ptr<Adafruit_PWMServoDriver> driver_;    ///< PCA9685 driver instance
+		std::atomic<uint16_t> dirty_mask_;                   ///< Channels to write on next flush (bit per LED)
+		Driver driver_type_;                                 ///< Register access path in use
+		uint8_t broadcast_groups_;                           ///< Broadcast group membership (bit 0 = group 1)
+		volatile bool broadcast_hold_;                       ///< Outputs set by a broadcast, flush suspended
+		uint16_t phase_offsets_[LED_MAX];                    ///< ON tick of each channel within the PWM period
+		uint8_t frame_regs_[LED_MAX][4];                     ///< Output frame: LEDn_ON_L..LEDn_OFF_H of each channel
+		uint16_t frame_mask_;                                ///< Channels of the output frame not written yet
+		Health health_;                                      ///< Bus health
+		HealthStats health_stats_;                           ///< Transaction and recovery counters
+		uint8_t expected_mode1_;                             ///< MODE1 value after initialization (RESTART bit ignored)
+		uint32_t backoff_ms_;                                ///< Current back-off delay (milliseconds)
+		unsigned long retry_at_;                             ///< millis() at which an offline module is checked again
+		uint16_t pwm_frequency_;                             ///< Configured PWM frequency (Hz)
+		uint32_t oscillator_hz_;                             ///< Calibrated oscillator frequency (Hz)
+		bool camera_mode_;                                   ///< Force the maximum PWM frequency regardless of pwm_frequency_
+		uint8_t prescale_;                                   ///< Prescale written to the chip (0 = not written yet)
+		CurveType curve_;                                    ///< Transfer curve of LEDs without their own (CURVE_DEFAULT = global curve)
+		uint8_t dither_error_[LED_MAX];                      ///< Sigma-delta accumulated fraction of each channel
+		uint16_t dither_mask_;                               ///< Channels with a fractional intensity, updated every frame
+		uint16_t rated_ma_;                                  ///< Current of a channel at full duty (mA), unless set on the LED
+		uint32_t power_demand_[POWER_PRIORITIES];            ///< Unscaled current per priority (mA * INTENSITY_MAX)
+		uint32_t power_scale_[POWER_PRIORITIES];             ///< Intensity scale per priority (Q16, POWER_SCALE_ONE = unscaled)
 
 	public:
 		// === Constructor and Destructor ===
@@ -107,8 +281,9 @@ class PCA9685Module {
 		 * 
 		 * @param address I2C address of the module
 		 * @param led_count Number of LEDs connected to this module
+		 * @param bus I2C bus index the module is connected to
 		 */
-		PCA9685Module(uint8_t address, uint8_t led_count);
+		PCA9685Module(uint8_t address, uint8_t led_count, uint8_t bus = 0);
 		
 		/**
 		 * @brief Destructor
@@ -152,226 +327,1533 @@ class PCA9685Module {
 		 * @return I2C address
 		 */
 		uint8_t getAddress() const { return address_; }
-		
+
 		/**
-		 * @brief Get number of LEDs on this module
+		 * @brief Get module I2C bus index
 		 * 
-		 * @return LED count
+		 * @return Bus index (0 = Wire, 1 = Wire1)
 		 */
-		uint8_t getLedCount() const { return led_count_; }
-		
+		uint8_t getBus() const { return bus_; }
+
 		/**
-		 * @brief Get LED at specified index
+		 * @brief Check if channels are waiting for the next flush
 		 * 
-		 * @param led_index LED index (0-based)
-		 * @return Pointer to LED object, nullptr if invalid index
+		 * @return true if at least one channel is dirty
 		 */
-		LED* getLED(uint8_t led_index);
-		
+		bool hasPendingWrites() const { return dirty_mask_.load() != 0 || frame_mask_ != 0; }
+
 		/**
-		 * @brief Get LED at specified index (const version)
+		 * @brief Check if channels changed since the last commit
 		 * 
-		 * @param led_index LED index (0-based)
-		 * @return Pointer to LED object, nullptr if invalid index
+		 * Unlike hasPendingWrites(), does not read the output frame, which
+		 * the bus task owns while writing.
+		 * 
+		 * @return true if at least one channel is dirty
 		 */
-		const LED* getLED(uint8_t led_index) const;
+		bool hasDirtyChannels() const { return dirty_mask_.load() != 0; }
 
-		// === Setters ===
+		/**
+		 * @brief Check if the output frame has channels to write
+		 * 
+		 * @return true if writeFrame() has work to do
+		 */
+		bool hasFrameToWrite() const { return frame_mask_ != 0; }
 
 		/**
-		 * @brief Set module name
+		 * @brief Get register access path in use
 		 * 
-		 * @param name New name for the module
+		 * @return Driver type
 		 */
-		void setName(const String& name) { name_ = name; }
-		
+		Driver getDriver() const { return driver_type_; }
+
 		/**
-		 * @brief Set detected status
+		 * @brief Get register access path name
 		 * 
-		 * @param detected Detection status
+		 * @return "native" or "adafruit"
 		 */
-		void setDetected(bool detected) { detected_ = detected; }
+		const char* getDriverName() const { return driver_type_ == Driver::NATIVE ? "native" : "adafruit"; }
 
-		// === Other functions ===
+		/**
+		 * @brief Get broadcast group membership
+		 * 
+		 * @return Group mask (bit 0 = group 1)
+		 */
+		uint8_t getBroadcastGroups() const { return broadcast_groups_; }
 
 		/**
-		 * @brief Initialize the PCA9685 module
+		 * @brief Get module transfer curve
 		 * 
-		 * @return true if initialization successful, false otherwise
+		 * @return Curve of LEDs set to CURVE_DEFAULT (CURVE_DEFAULT if the global curve is used)
 		 */
-		bool initialize();
+		CurveType getCurve() const { return curve_; }
 
 		/**
-		 * @brief Apply LED brightness to hardware
+		 * @brief Get the transfer curve applied to one LED
 		 * 
-		 * Updates the PCA9685 PWM registers for the specified LED
+		 * Resolves CURVE_DEFAULT: LED curve, else module curve, else the
+		 * global curve.
 		 * 
-		 * @param led_index LED index to update
-		 * @return true if successful, false otherwise
+		 * @param led_index LED index within the module
+		 * @return Curve applied when the output frame is built
 		 */
-		bool applyLedBrightness(uint8_t led_index);
-		
+		CurveType getLedCurve(uint8_t led_index) const;
+
 		/**
-		 * @brief Set up default LED configuration
+		 * @brief Get configured PWM frequency
 		 * 
-		 * Initializes all LEDs with default names and states
+		 * @return PWM frequency (Hz), ignored in camera mode
+		 */
+		uint16_t getPwmFrequency() const { return pwm_frequency_; }
+
+		/**
+		 * @brief Get calibrated oscillator frequency
 		 * 
-		 * @param module_index Module index for naming convention
+		 * @return Oscillator frequency used for prescale computation (Hz)
 		 */
-		void setupDefaultLeds(uint8_t module_index);
-		
+		uint32_t getOscillatorFrequency() const { return oscillator_hz_; }
+
 		/**
-		 * @brief Check if this address corresponds to a PCA9685 device
+		 * @brief Check if camera mode is enabled
 		 * 
-		 * @param address I2C address to check
-		 * @return true if it's a PCA9685 device, false otherwise
+		 * @return true if the maximum PWM frequency is forced
 		 */
-		static bool isPCA9685Device(uint8_t address);
+		bool isCameraMode() const { return camera_mode_; }
 
-	private:
-		// === Private functions ===
+		/**
+		 * @brief Check if camera mode overrides the configured frequency
+		 * 
+		 * @return true if camera mode is enabled and pwm_frequency_ is below the maximum
+		 */
+		bool isFrequencyForced() const { return camera_mode_ && computePrescale(oscillator_hz_, pwm_frequency_) != PRESCALE_MIN; }
 
 		/**
-		 * @brief Generate default name for module
+		 * @brief Get prescale written to the chip
 		 * 
-		 * @return Default name based on address
+		 * @return Prescale register value (0 if not written yet)
 		 */
-		String generateDefaultName() const;
-};
+		uint8_t getPrescale() const { return prescale_; }
 
+		/**
+		 * @brief Get rated current of the channels
+		 * 
+		 * @return Current of a channel at full duty in mA, for LEDs without their own
+		 */
+		uint16_t getRatedCurrent() const { return rated_ma_; }
 
-/**
- * @brief Manager class for all PCA9685 modules
- * 
- * This class handles scanning, initialization, and management of multiple
- * PCA9685 modules connected to the I2C bus.
- */
-class ModuleManager {
-	private:
-		std::vector<std::unique_ptr<PCA9685Module>> modules_;   ///< Vector of managed modules
+		/**
+		 * @brief Get unscaled current per power priority
+		 * 
+		 * Computed by updatePowerDemand(), in mA * BrightnessCurve::INTENSITY_MAX
+		 * so that no division is needed per LED.
+		 * 
+		 * @return POWER_PRIORITIES demands
+		 */
+		const uint32_t* getPowerDemand() const { return power_demand_; }
 
-	public:
-		// === Constructor and Destructor ===
+		/**
+		 * @brief Get estimated current requested by the LEDs
+		 * 
+		 * @return Current before power budget scaling (mA)
+		 */
+		uint32_t getDemandCurrent() const;
 
 		/**
-		 * @brief Constructor
+		 * @brief Get estimated current drawn by the LEDs
+		 * 
+		 * @return Current after power budget scaling (mA)
 		 */
-		ModuleManager();
-		
+		uint32_t getEstimatedCurrent() const;
+
 		/**
-		 * @brief Destructor
+		 * @brief Get prescale matching the current settings
+		 * 
+		 * Differs from getPrescale() until applyPwmFrequency() is called.
+		 * 
+		 * @return Prescale register value
 		 */
-		~ModuleManager() = default;
-		
-		// Copy constructor and assignment operator (deleted for safety)
-		ModuleManager(const ModuleManager&) = delete;
-		ModuleManager& operator=(const ModuleManager&) = delete;
+		uint8_t getTargetPrescale() const { return camera_mode_ ? PRESCALE_MIN : computePrescale(oscillator_hz_, pwm_frequency_); }
 
-		// === Getters ===
+		/**
+		 * @brief Get PWM frequency actually produced by the chip
+		 * 
+		 * The prescaler only divides by integers, so the output frequency
+		 * is the closest achievable one, not the configured one.
+		 * 
+		 * @return Output frequency with the calibrated oscillator (Hz)
+		 */
+		float getActualPwmFrequency() const { return getPrescaleFrequency(oscillator_hz_, prescale_ ? prescale_ : getTargetPrescale()); }
 
 		/**
-		 * @brief Get total number of detected modules
+		 * @brief Check if the module answers a broadcast target
 		 * 
-		 * @return Number of detected modules
+		 * @param group Broadcast group (1-based), 0 for "All Call"
+		 * @return true if the module is part of the target
 		 */
-		uint8_t getModuleCount() const { return modules_.size(); }
-		
+		bool isInBroadcastGroup(uint8_t group) const { return group == 0 || (group <= BROADCAST_GROUP_COUNT && (broadcast_groups_ & (1 << (group - 1)))); }
+
 		/**
-		 * @brief Get module at specified index
+		 * @brief Check if outputs are currently set by a broadcast
 		 * 
-		 * @param index Module index (0-based)
-		 * @return Pointer to module, nullptr if invalid index
+		 * @return true while flushes are suspended
 		 */
-		PCA9685Module* getModule(uint8_t index);
-		
+		bool isBroadcastHeld() const { return broadcast_hold_; }
+
 		/**
-		 * @brief Get module at specified index (const version)
+		 * @brief Get bus health
 		 * 
-		 * @param index Module index (0-based)
-		 * @return Pointer to module, nullptr if invalid index
+		 * @return Health state
 		 */
-		const PCA9685Module* getModule(uint8_t index) const;
-		
+		Health getHealth() const { return health_; }
+
 		/**
-		 * @brief Get LED from specific module and LED index
+		 * @brief Get bus health name
 		 * 
-		 * @param module_index Module index
-		 * @param led_index LED index within the module
-		 * @return Pointer to LED object, nullptr if invalid indices
+		 * @return "ok", "degraded" or "offline"
 		 */
-		LED* getLED(uint8_t module_index, uint8_t led_index);
-		
+		const char* getHealthName() const;
+
 		/**
-		 * @brief Get LED from specific module and LED index (const version)
+		 * @brief Get transaction and recovery counters
 		 * 
-		 * @param module_index Module index
-		 * @param led_index LED index within the module
-		 * @return Pointer to LED object, nullptr if invalid indices
+		 * @return Health counters
 		 */
-		const LED* getLED(uint8_t module_index, uint8_t led_index) const;
+		const HealthStats& getHealthStats() const { return health_stats_; }
 
 		/**
-		 * @brief Get total number of LEDs across all modules
+		 * @brief Check if an offline module is due for a health check
 		 * 
-		 * @return Total LED count
+		 * @return true if the module is offline and its back-off has expired
 		 */
-		uint16_t getTotalLedCount() const;
-		
+		bool isRetryDue() const { return health_ == Health::OFFLINE && static_cast<long>(millis() - retry_at_) >= 0; }
+
 		/**
-		 * @brief Get number of initialized modules
+		 * @brief Get remaining back-off time of an offline module
 		 * 
-		 * @return Count of successfully initialized modules
+		 * @return Milliseconds before the next health check, 0 if not backed off
 		 */
-		uint8_t getInitializedModuleCount() const;
-		
+		uint32_t getRetryInMs() const { return health_ == Health::OFFLINE && !isRetryDue() ? retry_at_ - millis() : 0; }
+
 		/**
-		 * @brief Get number of enabled LEDs across all modules
+		 * @brief Get the phase offset of a channel
 		 * 
-		 * @return Count of enabled LEDs
+		 * @param led_index LED index
+		 * @return ON tick within the PWM period (0 to PWM_STEPS - 1)
 		 */
-		uint16_t getEnabledLedCount() const;
+		uint16_t getPhaseOffset(uint8_t led_index) const { return led_index < LED_MAX ? phase_offsets_[led_index] : 0; }
 
-		// === Other functions ===
-		
 		/**
-		 * @brief Initialize the module manager
+		 * @brief Get ON/OFF counts of a channel from its LED state
 		 * 
-		 * This will scan for modules and initialize them
+		 * Used by every flush path, so the phase offset is always applied.
+		 * For a dithered LED, advances its sigma-delta state by one frame:
+		 * call once per output frame.
 		 * 
-		 * @return true if initialization successful, false otherwise
+		 * @param led_index LED index
+		 * @param on ON count (4096 = full on)
+		 * @param off OFF count (4096 = full off)
 		 */
-		bool initialize();
+		void getChannelPwm(uint8_t led_index, uint16_t& on, uint16_t& off);
 		
 		/**
-		 * @brief Apply LED brightness to hardware
+		 * @brief Get number of LEDs on this module
 		 * 
-		 * @param module_index Module index
-		 * @param led_index LED index within the module
-		 * @return true if successful, false otherwise
+		 * @return LED count
 		 */
-		bool applyLedBrightness(uint8_t module_index, uint8_t led_index);
+		uint8_t getLedCount() const { return led_count_; }
 		
 		/**
-		 * @brief Print module information to Serial
+		 * @brief Get LED at specified index
+		 * 
+		 * @param led_index LED index (0-based)
+		 * @return Pointer to LED object, nullptr if invalid index
 		 */
-		void printModuleInfo() const;
+		LED* getLED(uint8_t led_index);
+		
+		/**
+		 * @brief Get LED at specified index (const version)
+		 * 
+		 * @param led_index LED index (0-based)
+		 * @return Pointer to LED object, nullptr if invalid index
+		 */
+		const LED* getLED(uint8_t led_index) const;
 
-	private:
-		// === Private functions ===
+		// === Setters ===
 
 		/**
-		 * @brief Scan I2C bus for PCA9685 modules
+		 * @brief Set module name
 		 * 
-		 * @return Number of modules found
+		 * @param name New name for the module
 		 */
-		uint8_t scanModules();
+		void setName(const String& name) { name_ = name; }
 		
 		/**
-		 * @brief Initialize all detected modules
+		 * @brief Set detected status
 		 * 
-		 * @return Number of modules successfully initialized
+		 * @param detected Detection status
 		 */
-		uint8_t initializeModules();
+		void setDetected(bool detected) { detected_ = detected; }
+
+		/**
+		 * @brief Select the register access path
+		 * 
+		 * Both paths write the same registers, so switching needs no
+		 * re-initialization. Must be called from the task flushing the bus.
+		 * 
+		 * @param driver Driver type
+		 */
+		void setDriver(Driver driver) { driver_type_ = driver; }
+
+		/**
+		 * @brief Set module transfer curve
+		 * 
+		 * Takes effect on the next flush of each LED; call
+		 * ModuleManager::refreshAllLeds() to rewrite them at once.
+		 * 
+		 * @param curve Curve of LEDs set to CURVE_DEFAULT (CURVE_DEFAULT for the global curve)
+		 */
+		void setCurve(CurveType curve) { curve_ = curve; }
+
+		/**
+		 * @brief Set rated current of the channels
+		 * 
+		 * @param rated_ma Current of a channel at full duty in mA (1 to LED::RATED_MA_MAX)
+		 * @return true if the current is valid
+		 */
+		bool setRatedCurrent(uint16_t rated_ma);
+
+		/**
+		 * @brief Set power budget scales
+		 * 
+		 * Every channel is rewritten when a scale changes. Must be called
+		 * from the task committing frames.
+		 * 
+		 * @param scales POWER_PRIORITIES Q16 intensity scales
+		 */
+		void setPowerScales(const uint32_t* scales);
+
+		/**
+		 * @brief Set PWM frequency
+		 * 
+		 * Only stored; the chip is updated by applyPwmFrequency().
+		 * 
+		 * @param frequency PWM frequency (PWM_FREQUENCY_MIN to PWM_FREQUENCY_MAX Hz)
+		 * @return true if the frequency is valid
+		 */
+		bool setPwmFrequency(uint16_t frequency);
+
+		/**
+		 * @brief Set calibrated oscillator frequency
+		 * 
+		 * Only stored; the chip is updated by applyPwmFrequency().
+		 * 
+		 * @param oscillator_hz Oscillator frequency (OSCILLATOR_MIN to OSCILLATOR_MAX Hz)
+		 * @return true if the frequency is valid
+		 */
+		bool setOscillatorFrequency(uint32_t oscillator_hz);
+
+		/**
+		 * @brief Enable or disable camera mode
+		 * 
+		 * Camera mode forces the maximum PWM frequency (prescale
+		 * PRESCALE_MIN) regardless of pwm_frequency_, so that short
+		 * exposures integrate as many PWM periods as possible and rolling
+		 * shutters show finer, fainter bands. The configured frequency is
+		 * kept for when camera mode is turned off. At the default
+		 * PWM_FREQUENCY, already the maximum, it changes nothing (see
+		 * isFrequencyForced()). Only stored; the chip is updated by
+		 * applyPwmFrequency().
+		 * 
+		 * @param enabled true for camera mode
+		 */
+		void setCameraMode(bool enabled) { camera_mode_ = enabled; }
+
+		/**
+		 * @brief Set broadcast group membership
+		 * 
+		 * Only stored; the chip is updated by applyBroadcastGroups().
+		 * 
+		 * @param groups Group mask (bit 0 = group 1)
+		 */
+		void setBroadcastGroups(uint8_t groups) { broadcast_groups_ = groups & ((1 << BROADCAST_GROUP_COUNT) - 1); }
+
+		/**
+		 * @brief Suspend or resume flushes after a broadcast
+		 * 
+		 * While held, LED changes stay dirty. Releasing marks every channel
+		 * dirty so that the next flush restores the current frame.
+		 * 
+		 * @param hold true to suspend flushes
+		 */
+		void setBroadcastHold(bool hold);
+
+		/**
+		 * @brief Set the phase offset of a channel
+		 * 
+		 * The channel turns on at this tick of each PWM period instead of
+		 * tick 0. The channel is marked dirty when the offset changes.
+		 * 
+		 * @param led_index LED index
+		 * @param offset ON tick within the PWM period (0 to PWM_STEPS - 1)
+		 */
+		void setPhaseOffset(uint8_t led_index, uint16_t offset);
+
+		// === Other functions ===
+
+		/**
+		 * @brief Initialize the PCA9685 module
+		 * 
+		 * @return true if initialization successful, false otherwise
+		 */
+		bool initialize();
+
+		/**
+		 * @brief Apply LED brightness to hardware
+		 * 
+		 * Marks the LED channel dirty; its PWM registers are written by the
+		 * next flush(). Safe to call from any task.
+		 * 
+		 * @param led_index LED index to update
+		 * @return true if successful, false otherwise
+		 */
+		bool applyLedBrightness(uint8_t led_index);
+
+		/**
+		 * @brief Apply the brightness of several LEDs to hardware
+		 * 
+		 * Same as applyLedBrightness() for every LED of the mask, with a
+		 * single update of the dirty mask.
+		 * 
+		 * @param mask Bit mask of the LEDs to update (bit n = LED n)
+		 * @return true if successful, false otherwise
+		 */
+		bool applyLedMask(uint16_t mask);
+
+		/**
+		 * @brief Write dirty channels to the PCA9685
+		 * 
+		 * Commits then writes the frame from the calling task. Channels
+		 * whose write failed are retried by the next write.
+		 * 
+		 * @return true if every dirty channel was written
+		 */
+		bool flush();
+
+		/**
+		 * @brief Estimate the current requested by each power priority
+		 * 
+		 * Sums rated current times intensity after the transfer curve, in
+		 * integers, for every enabled LED.
+		 */
+		void updatePowerDemand();
+
+		/**
+		 * @brief Copy dirty channels into the output frame
+		 * 
+		 * Encodes the current LED states of dirty channels into the output
+		 * frame registers, so that LEDs can change again while the frame is
+		 * written. Dithered channels are encoded on every call and only
+		 * added to the frame when their duty changes. Does nothing while a
+		 * broadcast holds the outputs.
+		 * Must not run while writeFrame() runs.
+		 * 
+		 * @return true if the output frame has channels to write
+		 */
+		bool commitFrame();
+
+		/**
+		 * @brief Write the output frame to the PCA9685
+		 * 
+		 * With the native driver, all pending channels are written in one
+		 * burst and take effect together at its STOP.
+		 * 
+		 * @return true if every pending channel was written
+		 */
+		bool writeFrame();
+
+		/**
+		 * @brief Encode the output frame as one register burst
+		 * 
+		 * @param out Buffer of at least 1 + 4 * LED_MAX bytes, receives the
+		 *            first register address followed by the values
+		 * @return Number of bytes written to out, 0 if nothing is pending
+		 */
+		size_t encodeFrame(uint8_t* out) const;
+
+		/**
+		 * @brief Mark the output frame as written
+		 * 
+		 * Used when the frame was sent by a multi-module transaction.
+		 */
+		void markFrameWritten() { frame_mask_ = 0; }
+
+		/**
+		 * @brief Update health after a transaction
+		 * 
+		 * Failures are counted by cause. FAILURE_THRESHOLD consecutive
+		 * failures take the module offline with an exponential back-off.
+		 * 
+		 * @param err ESP-IDF result of the transaction (ESP_FAIL = NACK)
+		 */
+		void recordTransaction(esp_err_t err);
+
+		/**
+		 * @brief Check that the chip still runs with its configuration
+		 * 
+		 * Reads MODE1 back: a value other than the one written at
+		 * initialization means the chip was reset (brownout, power glitch),
+		 * it is then re-initialized with recover(). An offline module that
+		 * answers again is replayed as well, as frames skipped it.
+		 * Must be called from the task flushing the bus.
+		 * 
+		 * @return true if the module is healthy after the check
+		 */
+		bool checkHealth();
+
+		/**
+		 * @brief Re-initialize the chip and replay its shadow registers
+		 * 
+		 * Rewrites mode, prescaler and broadcast addresses, then every
+		 * channel from the output frame, without touching other modules.
+		 * Must be called from the task flushing the bus.
+		 * 
+		 * @return true if the chip answered and every channel was written
+		 */
+		bool recover();
+
+		/**
+		 * @brief Write the prescale matching the current settings
+		 * 
+		 * Only restarts the oscillator of this module: output registers
+		 * are kept and PWM resumes with them. Must be called while the bus
+		 * is idle.
+		 * 
+		 * @return true if the prescaler was written
+		 */
+		bool applyPwmFrequency();
+
+		/**
+		 * @brief Measure the real oscillator frequency of the chip
+		 * 
+		 * Drives one channel at 50% duty and times CALIBRATION_PERIODS
+		 * PWM periods on a GPIO wired to that channel output, then
+		 * derives the oscillator from the prescale in use. The channel is
+		 * restored from the output frame afterwards. Blocks for up to
+		 * 2 * CALIBRATION_PERIODS PWM periods; must be called while the
+		 * bus is idle.
+		 * 
+		 * @param led_index Channel wired to the GPIO
+		 * @param pin GPIO reading the channel output (3.3 V levels)
+		 * @return Measured oscillator frequency (Hz), 0 on failure
+		 */
+		uint32_t calibrateOscillator(uint8_t led_index, uint8_t pin);
+
+		/**
+		 * @brief Compute the prescale for a PWM frequency
+		 * 
+		 * Same rounding as Adafruit_PWMServoDriver::setPWMFreq().
+		 * 
+		 * @param oscillator_hz Oscillator frequency (Hz)
+		 * @param frequency PWM frequency (Hz)
+		 * @return Prescale register value (PRESCALE_MIN to 255)
+		 */
+		static uint8_t computePrescale(uint32_t oscillator_hz, uint16_t frequency);
+
+		/**
+		 * @brief Compute the PWM frequency produced by a prescale
+		 * 
+		 * @param oscillator_hz Oscillator frequency (Hz)
+		 * @param prescale Prescale register value
+		 * @return PWM frequency (Hz)
+		 */
+		static float getPrescaleFrequency(uint32_t oscillator_hz, uint8_t prescale) { return static_cast<float>(oscillator_hz) / (PWM_STEPS * (prescale + 1.0f)); }
+		
+		/**
+		 * @brief Set up default LED configuration
+		 * 
+		 * Initializes all LEDs with default names and states
+		 * 
+		 * @param module_index Module index for naming convention
+		 */
+		void setupDefaultLeds(uint8_t module_index);
+		
+		/**
+		 * @brief Check if this address corresponds to a PCA9685 device
+		 * 
+		 * @param address I2C address to check
+		 * @param wire I2C controller of the bus to check
+		 * @return true if it's a PCA9685 device, false otherwise
+		 */
+		static bool isPCA9685Device(uint8_t address, TwoWire& wire = Wire);
+
+		/**
+		 * @brief Get the I2C controller of a bus
+		 * 
+		 * @param bus Bus index (0 = Wire, 1 = Wire1)
+		 * @return I2C controller
+		 */
+		static TwoWire& getBusWire(uint8_t bus);
+
+		/**
+		 * @brief Check register access at the current bus speed
+		 * 
+		 * Reads MODE1, then writes test patterns to SUBADR3 and reads them
+		 * back before restoring the original value. Used to validate a bus
+		 * speed: a marginal bus usually fails on readback first.
+		 * 
+		 * @return true if every read and readback succeeded
+		 */
+		bool verifyRegisters();
+
+		/**
+		 * @brief Program the broadcast addresses the chip answers
+		 * 
+		 * Writes the configured group address to SUBADRx for each group the
+		 * module belongs to, and the module's own address otherwise, so that
+		 * MODE1 stays identical on every module. Modules on the Adafruit
+		 * fallback driver are programmed through Wire.
+		 * 
+		 * @return true if every register write succeeded
+		 */
+		bool applyBroadcastGroups();
+
+		/**
+		 * @brief Write consecutive registers to any address of a bus
+		 * 
+		 * Used for broadcast addresses, which every member acknowledges.
+		 * Must be called from the task flushing the bus.
+		 * 
+		 * @param bus Bus index
+		 * @param address 7-bit I2C address
+		 * @param data First register address followed by the values
+		 * @param length Number of bytes in data (register address included)
+		 * @return ESP_OK on success, ESP-IDF error otherwise
+		 */
+		static esp_err_t writeBurstTo(uint8_t bus, uint8_t address, const uint8_t* data, size_t length);
+
+		/**
+		 * @brief Encode a brightness level as PCA9685 ON/OFF counts
+		 * 
+		 * See PwmPhase::encode().
+		 * 
+		 * @param level Brightness level (0 to LED::MAX_BRIGHTNESS)
+		 * @param offset ON tick within the PWM period
+		 * @param on ON count (4096 = full on)
+		 * @param off OFF count (4096 = full off)
+		 */
+		static void encodePwm(uint16_t level, uint16_t offset, uint16_t& on, uint16_t& off) { PwmPhase::encode(level, offset, on, off); }
+
+	private:
+		// === Private functions ===
+
+		/**
+		 * @brief Generate default name for module
+		 * 
+		 * @return Default name based on address
+		 */
+		String generateDefaultName() const;
+
+		/**
+		 * @brief Configure the chip with the selected driver
+		 * 
+		 * Used by initialize() and recover(). Records the MODE1 value
+		 * checked by checkHealth().
+		 * 
+		 * The native driver is only given up at first attach, when the port
+		 * has no ESP-IDF driver. A chip that does not answer (NACK, timeout)
+		 * keeps its driver: the health backoff retries it.
+		 * 
+		 * @param first_attach Allow the fallback to the Adafruit driver
+		 * @return true if the chip was configured
+		 */
+		bool configureChip(bool first_attach);
+
+		/**
+		 * @brief Read MODE1 with the selected driver
+		 * 
+		 * @param value Read value
+		 * @return ESP_OK on success, ESP-IDF error otherwise
+		 */
+		esp_err_t readMode1(uint8_t& value);
+
+		/**
+		 * @brief Initialize the chip through the native driver
+		 * 
+		 * Sets the prescaler for the module PWM frequency and enables
+		 * register auto-increment, as Adafruit_PWMServoDriver does.
+		 * 
+		 * @return ESP_OK if every register access succeeded, the first error otherwise
+		 */
+		esp_err_t initializeNative();
+
+		/**
+		 * @brief Write the prescaler through the native driver
+		 * 
+		 * Puts the oscillator to sleep (required to write PRESCALE), writes
+		 * the prescale, then wakes and restarts PWM with MODE1_DEFAULT.
+		 * 
+		 * @param prescale Prescale register value
+		 * @return ESP_OK on success, ESP-IDF error otherwise
+		 */
+		esp_err_t writePrescale(uint8_t prescale);
+
+		/**
+		 * @brief Write pending frame channels with one native burst
+		 * 
+		 * Writes the contiguous register range from the first to the last
+		 * pending channel in a single transaction.
+		 * 
+		 * @return Mask of channels that were not written
+		 */
+		uint16_t writeFrameNative();
+
+		/**
+		 * @brief Write pending frame channels through Adafruit_PWMServoDriver
+		 * 
+		 * One transaction per channel, so channels change one after the other.
+		 * 
+		 * @return Mask of channels that were not written
+		 */
+		uint16_t writeFrameAdafruit();
+
+		/**
+		 * @brief Write consecutive registers in one native transaction
+		 * 
+		 * @param data First register address followed by the values
+		 * @param length Number of bytes in data (register address included)
+		 * @return ESP_OK on success, ESP-IDF error otherwise
+		 */
+		esp_err_t writeBurst(const uint8_t* data, size_t length);
+
+		/**
+		 * @brief Write one register through the native driver
+		 * 
+		 * @param reg Register address
+		 * @param value Register value
+		 * @return ESP_OK on success, ESP-IDF error otherwise
+		 */
+		esp_err_t writeRegister(uint8_t reg, uint8_t value);
+
+		/**
+		 * @brief Read one register through the native driver
+		 * 
+		 * @param reg Register address
+		 * @param value Read value
+		 * @return ESP_OK on success, ESP-IDF error otherwise
+		 */
+		esp_err_t readRegister(uint8_t reg, uint8_t& value);
+
+		/**
+		 * @brief Write one register through Wire
+		 * 
+		 * For the registers the Adafruit driver does not expose, on modules
+		 * using the fallback driver.
+		 * 
+		 * @param reg Register address
+		 * @param value Register value
+		 * @return ESP_OK on success, ESP-IDF error otherwise
+		 */
+		esp_err_t writeWireRegister(uint8_t reg, uint8_t value);
+};
+
+
+/**
+ * @brief Manager class for all PCA9685 modules
+ * 
+ * This class handles scanning, initialization, and management of multiple
+ * PCA9685 modules connected to one or two I2C buses. LED changes are only
+ * marked dirty and written by flush(), once per frame.
+ */
+class ModuleManager {
+	public:
+		/**
+		 * @brief Bring-up result for one I2C bus speed
+		 */
+		struct BusSpeedResult {
+			uint32_t clock_hz;     ///< Bus clock (Hz)
+			bool tested;           ///< Speed was tried (not above the configured maximum)
+			bool verified;         ///< Every module passed the register check
+			uint32_t flush_us;     ///< Time to write all LED channels (microseconds, 0 if not verified)
+		};
+
+		/// Number of bus speeds tried at bring-up
+		static constexpr size_t BUS_SPEED_COUNT = 3;
+
+		/// Register check rounds per module and speed
+		static constexpr uint8_t BUS_VERIFY_ROUNDS = 3;
+
+		/**
+		 * @brief Native versus Adafruit driver flush timings for one bus
+		 */
+		struct DriverBenchResult {
+			bool run;              ///< Bench was run on this bus
+			uint32_t clock_hz;     ///< Bus clock during the bench (Hz)
+			uint16_t rounds;       ///< Full frame flushes per driver
+			uint32_t native_us;    ///< Average full frame flush time with the native driver (microseconds)
+			uint32_t adafruit_us;  ///< Average full frame flush time with Adafruit (microseconds)
+		};
+
+		/**
+		 * @brief Frame output statistics of one bus
+		 */
+		struct FrameStats {
+			uint32_t frames;           ///< Frames written by the bus task
+			uint32_t late;             ///< Frames with changes held back because the previous one was still being written
+			uint32_t linked_failures;  ///< Multi-module transactions that failed and were retried per module
+			uint32_t last_write_us;    ///< Duration of the last frame write (microseconds)
+		};
+
+		/**
+		 * @brief Background scan progress of a bus
+		 */
+		struct ScanStats {
+			uint8_t next_address;      ///< Next address to probe
+			uint32_t passes;           ///< Complete passes over the address range
+			uint32_t probes;           ///< Addresses probed
+			uint32_t found;            ///< PCA9685 found at an address without a working module
+			uint32_t last_step_us;     ///< Duration of the last scan step (microseconds)
+		};
+
+		/**
+		 * @brief Power budget state of the last frame
+		 */
+		struct PowerStats {
+			uint32_t demand_ma;        ///< Estimated current requested by every LED (mA)
+			uint32_t estimated_ma;     ///< Estimated current after scaling (mA)
+			bool limited;              ///< Intensities are currently scaled down
+			uint32_t limited_frames;   ///< Frames over budget since boot
+		};
+
+		/**
+		 * @brief Last oscillator calibration
+		 */
+		struct CalibrationResult {
+			bool run;                  ///< Calibration was run
+			bool success;              ///< Oscillator was measured and applied
+			uint8_t module;            ///< Calibrated module index
+			uint8_t led;               ///< Channel wired to the GPIO
+			uint8_t pin;               ///< GPIO reading the channel
+			uint32_t oscillator_hz;    ///< Measured oscillator frequency (Hz, 0 on failure)
+		};
+
+		/// Interval between two module health checks on a bus (milliseconds)
+		static constexpr uint32_t HEALTH_CHECK_INTERVAL_MS = 500;
+
+		/// Interval between two background scan steps on a bus (milliseconds)
+		static constexpr uint32_t SCAN_INTERVAL_MS = 250;
+
+		/// Maximum addresses probed by one scan step
+		static constexpr uint8_t SCAN_PROBES_PER_STEP = 4;
+
+		/// Bus time after which a scan step stops probing (microseconds)
+		static constexpr uint32_t SCAN_BUDGET_US = 1000;
+
+		/// Maximum wait for a bus task to finish its frame (milliseconds)
+		static constexpr uint32_t FLUSH_IDLE_TIMEOUT_MS = 200;
+
+		/// Time for a power scale to recover from 0 to 1 once under budget (milliseconds)
+		static constexpr uint32_t POWER_RELEASE_MS = 500;
+
+		/// Broadcast target of every module ("All Call")
+		static constexpr uint8_t BROADCAST_ALL = 0;
+
+		/// No module waiting to be forgotten
+		static constexpr uint8_t FORGET_NONE = 0xFF;
+
+		/**
+		 * @brief Broadcast operation queued for handle()
+		 */
+		enum class BroadcastAction : uint8_t {
+			NONE = 0,           ///< Nothing pending
+			LEVEL = 1,          ///< Set every channel of the target to one level
+			RELEASE = 2,        ///< Restore the current frame on the target
+			SYNC = 3,           ///< Restart the PWM counters of the target together
+			APPLY_GROUPS = 4    ///< Reprogram broadcast group addresses of every module
+		};
+
+	private:
+		std::vector<std::unique_ptr<PCA9685Module>> modules_;   ///< Managed modules, indexed by persistent module ID (nullptr = free ID)
+		std::vector<std::unique_ptr<PCA9685Module>> retired_modules_;   ///< Forgotten modules, kept until reboot for pointers held by other tasks
+		volatile uint8_t forget_requested_;                     ///< Module to forget in handle() (FORGET_NONE = none)
+		uint32_t bus_clock_hz_[PCA9685Module::BUS_COUNT];       ///< I2C clock selected at bring-up per bus (Hz)
+		BusSpeedResult bus_speed_results_[PCA9685Module::BUS_COUNT][BUS_SPEED_COUNT];   ///< Bring-up results per bus, fastest first
+		volatile bool bus_negotiation_requested_;               ///< Bus speed negotiation pending for handle()
+		/**
+		 * @brief Parameter of a bus flush task
+		 */
+		struct FlushTaskContext {
+			ModuleManager* manager;    ///< Owning manager
+			uint8_t bus;               ///< Bus written by the task
+		};
+
+		TaskHandle_t flush_tasks_[PCA9685Module::BUS_COUNT];    ///< Task writing the output frames of each bus
+		SemaphoreHandle_t flush_done_[PCA9685Module::BUS_COUNT];        ///< Given by each bus task when its frame is written
+		FlushTaskContext flush_contexts_[PCA9685Module::BUS_COUNT];     ///< Parameters of the bus tasks
+		FrameStats frame_stats_[PCA9685Module::BUS_COUNT];      ///< Frame output statistics per bus
+		bool late_counted_[PCA9685Module::BUS_COUNT];           ///< The frame being written already held back changes
+		std::unique_ptr<uint8_t[]> linked_tx_[PCA9685Module::BUS_COUNT];        ///< Burst data of a multi-module transaction
+		std::unique_ptr<uint32_t[]> linked_cmd_[PCA9685Module::BUS_COUNT];      ///< Command link buffer of a multi-module transaction (word aligned)
+		size_t linked_cmd_size_[PCA9685Module::BUS_COUNT];      ///< Size of linked_cmd_ in bytes
+		std::vector<PCA9685Module*> linked_modules_[PCA9685Module::BUS_COUNT];  ///< Modules sent by the current multi-module transaction
+		unsigned long last_health_check_[PCA9685Module::BUS_COUNT];     ///< millis() of the last health check per bus
+		uint8_t health_cursor_[PCA9685Module::BUS_COUNT];       ///< Module index of the next round-robin health check per bus
+		unsigned long last_scan_step_[PCA9685Module::BUS_COUNT];        ///< millis() of the last background scan step per bus
+		ScanStats scan_stats_[PCA9685Module::BUS_COUNT];        ///< Background scan progress per bus
+		uint32_t scan_found_[PCA9685Module::BUS_COUNT][4];      ///< Addresses found by the bus tasks, waiting for handle() (one bit per address)
+		volatile bool scan_pending_[PCA9685Module::BUS_COUNT];  ///< scan_found_ has bits set
+		DriverBenchResult bench_results_[PCA9685Module::BUS_COUNT];     ///< Last driver bench per bus
+		volatile uint16_t bench_rounds_requested_;              ///< Driver bench pending for handle() (0 = none)
+		volatile BroadcastAction broadcast_action_;             ///< Broadcast pending for handle()
+		uint8_t broadcast_group_;                               ///< Target of the pending broadcast
+		uint16_t broadcast_level_;                              ///< Level of the pending LEVEL broadcast
+		volatile bool phase_allocation_requested_;              ///< Phase offsets to recompute in handle()
+		volatile bool pwm_update_requested_;                    ///< Prescalers to rewrite in handle()
+		volatile bool calibration_requested_;                   ///< Oscillator calibration pending for handle()
+		CalibrationResult calibration_;                         ///< Pending or last oscillator calibration
+		uint32_t power_scale_[PCA9685Module::POWER_PRIORITIES]; ///< Applied intensity scale per priority (Q16)
+		unsigned long last_power_update_;                       ///< millis() of the last power budget update
+		PowerStats power_stats_;                                ///< Power budget state of the last frame
+
+	public:
+		// === Constructor and Destructor ===
+
+		/**
+		 * @brief Constructor
+		 */
+		ModuleManager();
+		
+		/**
+		 * @brief Destructor
+		 */
+		~ModuleManager();
+		
+		// Copy constructor and assignment operator (deleted for safety)
+		ModuleManager(const ModuleManager&) = delete;
+		ModuleManager& operator=(const ModuleManager&) = delete;
+
+		// === Getters ===
+
+		/**
+		 * @brief Get total number of module IDs
+		 * 
+		 * Safe to call from other tasks (web server): the table is
+		 * reserved to its maximum size at setup and never reallocated,
+		 * and IDs are never removed, only freed.
+		 * 
+		 * @return Number of module IDs, free IDs included
+		 */
+		uint8_t getModuleCount() const { return modules_.size(); }
+		
+		/**
+		 * @brief Get module at specified index
+		 * 
+		 * Safe to call from other tasks: a forgotten module is retired
+		 * instead of deleted, so a returned pointer stays valid until
+		 * reboot. Its state may change while it is read.
+		 * 
+		 * @param index Module index (0-based)
+		 * @return Pointer to module, nullptr if invalid index or free ID
+		 */
+		PCA9685Module* getModule(uint8_t index);
+		
+		/**
+		 * @brief Get module at specified index (const version)
+		 * 
+		 * @param index Module index (0-based)
+		 * @return Pointer to module, nullptr if invalid index or free ID
+		 */
+		const PCA9685Module* getModule(uint8_t index) const;
+		
+		/**
+		 * @brief Get LED from specific module and LED index
+		 * 
+		 * @param module_index Module index
+		 * @param led_index LED index within the module
+		 * @return Pointer to LED object, nullptr if invalid indices
+		 */
+		LED* getLED(uint8_t module_index, uint8_t led_index);
+		
+		/**
+		 * @brief Get LED from specific module and LED index (const version)
+		 * 
+		 * @param module_index Module index
+		 * @param led_index LED index within the module
+		 * @return Pointer to LED object, nullptr if invalid indices
+		 */
+		const LED* getLED(uint8_t module_index, uint8_t led_index) const;
+
+		/**
+		 * @brief Get total number of LEDs across all modules
+		 * 
+		 * @return Total LED count
+		 */
+		uint16_t getTotalLedCount() const;
+		
+		/**
+		 * @brief Get number of initialized modules
+		 * 
+		 * @return Count of successfully initialized modules
+		 */
+		uint8_t getInitializedModuleCount() const;
+		
+		/**
+		 * @brief Get number of enabled LEDs across all modules
+		 * 
+		 * @return Count of enabled LEDs
+		 */
+		uint16_t getEnabledLedCount() const;
+
+		/**
+		 * @brief Check if an I2C bus is configured
+		 * 
+		 * @param bus Bus index
+		 * @return true for bus 0, and for bus 1 when its pins are set
+		 */
+		static bool isBusEnabled(uint8_t bus);
+
+		/**
+		 * @brief Get number of modules on an I2C bus
+		 * 
+		 * @param bus Bus index
+		 * @return Module count
+		 */
+		uint8_t getBusModuleCount(uint8_t bus) const;
+
+		/**
+		 * @brief Get I2C clock selected at bring-up
+		 * 
+		 * @param bus Bus index
+		 * @return Clock frequency in Hz
+		 */
+		uint32_t getBusClockHz(uint8_t bus = 0) const { return bus < PCA9685Module::BUS_COUNT ? bus_clock_hz_[bus] : 0; }
+
+		/**
+		 * @brief Get bring-up results for each bus speed
+		 * 
+		 * @param bus Bus index
+		 * @param count Number of entries in the returned table
+		 * @return Results, fastest speed first
+		 */
+		const BusSpeedResult* getBusSpeedResults(uint8_t bus, size_t& count) const {
+			count = bus < PCA9685Module::BUS_COUNT ? BUS_SPEED_COUNT : 0;
+			return bus < PCA9685Module::BUS_COUNT ? bus_speed_results_[bus] : nullptr;
+		}
+
+		/**
+		 * @brief Get frame output statistics of a bus
+		 * 
+		 * @param bus Bus index
+		 * @return Frame statistics
+		 */
+		const FrameStats& getFrameStats(uint8_t bus) const { return frame_stats_[bus < PCA9685Module::BUS_COUNT ? bus : 0]; }
+
+		/**
+		 * @brief Get the background scan progress of a bus
+		 * 
+		 * @param bus Bus index
+		 * @return Scan statistics
+		 */
+		const ScanStats& getScanStats(uint8_t bus) const { return scan_stats_[bus < PCA9685Module::BUS_COUNT ? bus : 0]; }
+
+		// === Other functions ===
+		
+		/**
+		 * @brief Initialize the module manager
+		 * 
+		 * Modules of the saved module map are restored first so that each
+		 * keeps its module ID, then each enabled bus is scanned for modules.
+		 * Known modules that do not answer are kept as missing. Detected
+		 * modules are initialized and each bus speed is negotiated
+		 * independently.
+		 * 
+		 * @return true if initialization successful, false otherwise
+		 */
+		bool initialize();
+		
+		/**
+		 * @brief Mark every LED of every module for the next flush
+		 * 
+		 * Used when a transfer curve changes, as the brightness values
+		 * themselves did not.
+		 */
+		void refreshAllLeds();
+
+		/**
+		 * @brief Apply LED brightness to hardware
+		 * 
+		 * @param module_index Module index
+		 * @param led_index LED index within the module
+		 * @return true if successful, false otherwise
+		 */
+		bool applyLedBrightness(uint8_t module_index, uint8_t led_index);
+
+		/**
+		 * @brief Select the fastest reliable speed of an I2C bus
+		 * 
+		 * Tries every supported speed up to the configured maximum. A speed
+		 * is verified when every initialized module of the bus passes its
+		 * register check; the full frame flush time is then measured. The
+		 * fastest verified speed is kept, 100 kHz if none passed.
+		 * 
+		 * @param bus Bus index
+		 * @return Selected clock frequency in Hz
+		 */
+		uint32_t negotiateBusSpeed(uint8_t bus);
+
+		/**
+		 * @brief Ask for a bus speed negotiation from the main loop
+		 * 
+		 * Used by the web API so that bus traffic stays in the loop task.
+		 */
+		void requestBusNegotiation() { bus_negotiation_requested_ = true; }
+
+		/**
+		 * @brief Ask for a driver bench from the main loop
+		 * 
+		 * @param rounds Full frame flushes per driver and bus
+		 */
+		void requestDriverBench(uint16_t rounds) { bench_rounds_requested_ = rounds; }
+
+		/**
+		 * @brief Compare native and Adafruit flush time on a bus
+		 * 
+		 * Times full frame flushes with each driver at the current bus
+		 * speed, then restores each module's driver.
+		 * 
+		 * @param bus Bus index
+		 * @param rounds Full frame flushes per driver
+		 */
+		void runDriverBench(uint8_t bus, uint16_t rounds);
+
+		/**
+		 * @brief Get last driver bench of a bus
+		 * 
+		 * @param bus Bus index
+		 * @return Bench result (run is false if never run)
+		 */
+		const DriverBenchResult& getDriverBenchResult(uint8_t bus) const { return bench_results_[bus < PCA9685Module::BUS_COUNT ? bus : 0]; }
+
+		/**
+		 * @brief Ask handle() to rewrite the prescaler of modules whose PWM settings changed
+		 * 
+		 * Only modules whose target prescale differs from the written one
+		 * are restarted; the others keep running.
+		 */
+		void requestPwmUpdate() { pwm_update_requested_ = true; }
+
+		/**
+		 * @brief Ask handle() to forget a missing module
+		 * 
+		 * Frees the module ID and removes its saved module and LED
+		 * configuration, so that a module removed for good no longer
+		 * takes a slot of the module map. A new module may reuse the ID.
+		 * 
+		 * @param index Module index
+		 * @return true if queued, false if the module is present, unknown or a request is pending
+		 */
+		bool requestForget(uint8_t index);
+
+		/**
+		 * @brief Ask handle() to calibrate the oscillator of a module
+		 * 
+		 * On success the measured frequency is applied and saved.
+		 * 
+		 * @param module_index Module index
+		 * @param led_index Channel wired to the GPIO
+		 * @param pin GPIO reading the channel output
+		 */
+		void requestOscillatorCalibration(uint8_t module_index, uint8_t led_index, uint8_t pin);
+
+		/**
+		 * @brief Get the pending or last oscillator calibration
+		 * 
+		 * @return Calibration result (run is false while pending or if never run)
+		 */
+		const CalibrationResult& getCalibrationResult() const { return calibration_; }
+
+		/**
+		 * @brief Get the power budget state of the last frame
+		 * 
+		 * @return Power statistics
+		 */
+		const PowerStats& getPowerStats() const { return power_stats_; }
+
+		/**
+		 * @brief Get the applied intensity scale of a power priority
+		 * 
+		 * @param priority Power priority (0 to LED::PRIORITY_MAX)
+		 * @return Q16 scale (PCA9685Module::POWER_SCALE_ONE = unscaled)
+		 */
+		uint32_t getPowerScale(uint8_t priority) const { return priority < PCA9685Module::POWER_PRIORITIES ? power_scale_[priority] : 0; }
+
+		/**
+		 * @brief Set every channel of a broadcast target to one level
+		 * 
+		 * One ALL_LED write per bus, whatever the number of modules. Used for
+		 * blackout (0), all on (LED::MAX_BRIGHTNESS) and master dimming
+		 * steps. Flushes of the target are suspended until releaseBroadcast().
+		 * The level goes through the global transfer curve, then is lowered
+		 * if needed to keep the target within the power budget.
+		 * 
+		 * @param level Perceptual brightness level (0 to LED::MAX_BRIGHTNESS)
+		 * @param group Broadcast group (1-based), BROADCAST_ALL for every module
+		 * @return true if the write succeeded on every bus with members
+		 */
+		bool broadcastLevel(uint16_t level, uint8_t group = BROADCAST_ALL);
+
+		/**
+		 * @brief Restore the current frame on a broadcast target
+		 * 
+		 * @param group Broadcast group (1-based), BROADCAST_ALL for every module
+		 */
+		void releaseBroadcast(uint8_t group = BROADCAST_ALL);
+
+		/**
+		 * @brief Restart the PWM counters of a broadcast target together
+		 * 
+		 * Puts the oscillators of the target to sleep and restarts them with
+		 * broadcast MODE1 writes, so every channel period starts at the same
+		 * time on every module of a bus.
+		 * 
+		 * @param group Broadcast group (1-based), BROADCAST_ALL for every module
+		 * @return true if the writes succeeded on every bus with members
+		 */
+		bool syncPwmPhase(uint8_t group = BROADCAST_ALL);
+
+		/**
+		 * @brief Reprogram broadcast group addresses of every module
+		 * 
+		 * @return true if every module was updated
+		 */
+		bool applyBroadcastGroups();
+
+		/**
+		 * @brief Queue a broadcast operation for the main loop
+		 * 
+		 * Used by the web API so that bus traffic stays in the loop task.
+		 * 
+		 * @param action Operation
+		 * @param group Broadcast group (1-based), BROADCAST_ALL for every module
+		 * @param level Level for BroadcastAction::LEVEL
+		 */
+		void requestBroadcast(BroadcastAction action, uint8_t group = BROADCAST_ALL, uint16_t level = 0);
+
+		/**
+		 * @brief Get the I2C address of a broadcast target
+		 * 
+		 * @param group Broadcast group (1-based), BROADCAST_ALL for every module
+		 * @return 7-bit address, 0 for an invalid group
+		 */
+		static uint8_t getBroadcastAddress(uint8_t group);
+
+		/**
+		 * @brief Spread channel ON times across the PWM period
+		 * 
+		 * Every channel of every module gets an evenly spaced offset in
+		 * module order, so that channels do not all switch on at tick 0.
+		 * All offsets are 0 when phase staggering is disabled.
+		 */
+		void allocatePhaseOffsets();
+
+		/**
+		 * @brief Ask for a phase offset allocation from the main loop
+		 */
+		void requestPhaseAllocation() { phase_allocation_requested_ = true; }
+
+		/**
+		 * @brief Time a full frame flush of a bus at its current speed
+		 * 
+		 * Writes every LED channel of every initialized module of the bus.
+		 * 
+		 * @param bus Bus index
+		 * @return Elapsed time in microseconds
+		 */
+		uint32_t measureFlushTime(uint8_t bus);
+
+		/**
+		 * @brief Hand the current frame over to the bus tasks
+		 * 
+		 * Double buffered: dirty channels are copied into each module's
+		 * output frame and written by the bus tasks while the caller goes
+		 * on rendering the next frame. Both controllers transfer at the same
+		 * time. A bus still writing the previous frame skips this one; its
+		 * changes stay dirty and go out with the next frame. Does not wait
+		 * for the writes.
+		 */
+		void flush();
+
+		/**
+		 * @brief Wait until no bus task is writing a frame
+		 * 
+		 * Required before any other bus traffic from the calling task. On a
+		 * timeout the bus task may still be using the bus and the shared
+		 * transaction buffers: the caller must not touch any bus.
+		 * 
+		 * @return false if a bus task did not finish within FLUSH_IDLE_TIMEOUT_MS
+		 */
+		bool waitFlushIdle();
+
+		/**
+		 * @brief Periodic processing, to be called from loop()
+		 * 
+		 * Runs a requested bus speed negotiation, driver bench or broadcast,
+		 * then flushes dirty channels.
+		 */
+		void handle();
+		
+		/**
+		 * @brief Print module information to Serial
+		 */
+		void printModuleInfo() const;
+
+	private:
+		// === Private functions ===
+
+		/**
+		 * @brief Scan an I2C bus for PCA9685 modules
+		 * 
+		 * @param bus Bus index
+		 * @return Number of modules found
+		 */
+		uint8_t scanModules(uint8_t bus);
+		
+		/**
+		 * @brief Initialize all detected modules
+		 * 
+		 * Missing modules get their default LEDs too, so that their
+		 * configuration can be loaded and kept until they come back.
+		 * 
+		 * @return Number of modules successfully initialized
+		 */
+		uint8_t initializeModules();
+
+		/**
+		 * @brief Create a missing module for each entry of the saved module map
+		 * 
+		 * @return Number of modules restored
+		 */
+		uint8_t restoreModuleMap();
+
+		/**
+		 * @brief Find the module at an address
+		 * 
+		 * @param bus Bus index
+		 * @param address I2C address
+		 * @return Module index, -1 if no module uses this address
+		 */
+		int findModule(uint8_t bus, uint8_t address) const;
+
+		/**
+		 * @brief Find the ID for a new module
+		 * 
+		 * @return First free ID, the next ID if none is free, -1 if the table is full
+		 */
+		int findFreeModuleIndex() const;
+
+		/**
+		 * @brief Forget a missing module (see requestForget())
+		 * 
+		 * Must be called while the bus tasks are idle.
+		 * 
+		 * @param index Module index
+		 * @return true if the module was forgotten
+		 */
+		bool forgetModule(uint8_t index);
+
+		/**
+		 * @brief Check if a broadcast group has members on a bus
+		 * 
+		 * @param bus Bus index
+		 * @param group Broadcast group (1-based), BROADCAST_ALL for every module
+		 * @return true if an initialized module of the bus answers the group
+		 */
+		bool isGroupInUse(uint8_t bus, uint8_t group) const;
+
+		/**
+		 * @brief Get the broadcast group using an address
+		 * 
+		 * @param address I2C address
+		 * @return Broadcast group (1-based), 0 if the address is not a group address
+		 */
+		static uint8_t getBroadcastGroupOf(uint8_t address);
+
+		/**
+		 * @brief Check if the background scan should probe an address
+		 * 
+		 * Addresses of working modules, the "All Call" address (answered by
+		 * every PCA9685 from power-on), group addresses with members on the
+		 * bus and new addresses once the module table is full are skipped.
+		 * A group address without members is probed like any other, since
+		 * boards may be strapped at 0x71 or 0x72.
+		 * 
+		 * @param bus Bus index
+		 * @param address I2C address
+		 * @return true if the address may hold a module to attach
+		 */
+		bool isScanCandidate(uint8_t bus, uint8_t address) const;
+
+		/**
+		 * @brief Probe the next addresses of a bus when due
+		 * 
+		 * Every SCAN_INTERVAL_MS, probes up to SCAN_PROBES_PER_STEP
+		 * addresses, stopping early once SCAN_BUDGET_US of bus time is
+		 * used. Found modules are only recorded; handle() attaches them.
+		 * Called by the task flushing the bus, after the frame.
+		 * 
+		 * @param bus Bus index
+		 */
+		void serviceScan(uint8_t bus);
+
+		/**
+		 * @brief Attach the modules found by the background scan
+		 * 
+		 * Must be called while the bus tasks are idle.
+		 * 
+		 * @return Number of modules attached
+		 */
+		uint8_t attachFoundModules();
+
+		/**
+		 * @brief Attach a module found at runtime
+		 * 
+		 * A missing module keeps its ID, LED configuration and programs;
+		 * its frame is written again once initialized. A new module takes
+		 * the first free ID and the module map is saved, so existing LED
+		 * indices never move.
+		 * 
+		 * @param bus Bus index
+		 * @param address I2C address
+		 * @return true if the module is initialized
+		 */
+		bool attachModule(uint8_t bus, uint8_t address);
+
+		/**
+		 * @brief Check register access of every initialized module of a bus
+		 * 
+		 * @param bus Bus index
+		 * @param rounds Number of checks per module
+		 * @return true if every check passed
+		 */
+		bool verifyAllModules(uint8_t bus, uint8_t rounds);
+
+		/**
+		 * @brief Commit then write the frame of one bus from the calling task
+		 * 
+		 * @param bus Bus index
+		 */
+		void flushBus(uint8_t bus);
+
+		/**
+		 * @brief Copy dirty channels of the modules of one bus into their output frames
+		 * 
+		 * @param bus Bus index
+		 */
+		void commitBus(uint8_t bus);
+
+		/**
+		 * @brief Check if a module of a bus has channels to commit
+		 * 
+		 * @param bus Bus index
+		 * @return true if at least one channel is dirty
+		 */
+		bool hasDirtyChannels(uint8_t bus) const;
+
+		/**
+		 * @brief Write the output frames of the modules of one bus
+		 * 
+		 * Uses a single multi-module transaction when linked frames are
+		 * enabled, one burst per module otherwise.
+		 * 
+		 * @param bus Bus index
+		 */
+		void writeBus(uint8_t bus);
+
+		/**
+		 * @brief Write the output frames of one bus in a single transaction
+		 * 
+		 * One repeated START per module and a single STOP, so the outputs of
+		 * every native module change together. Falls back to per-module
+		 * writes if the transaction fails.
+		 * 
+		 * @param bus Bus index
+		 */
+		void writeBusLinked(uint8_t bus);
+
+		/**
+		 * @brief Check the health of one module of a bus when due
+		 * 
+		 * Every HEALTH_CHECK_INTERVAL_MS, checks an offline module whose
+		 * back-off expired, or else the next module in round-robin order,
+		 * so checks cost at most one register read per interval and bus.
+		 * Called by the task flushing the bus, after the frame.
+		 * 
+		 * @param bus Bus index
+		 */
+		void serviceHealth(uint8_t bus);
+
+		/**
+		 * @brief Allocate multi-module transaction buffers of a bus
+		 * 
+		 * @param bus Bus index
+		 */
+		void allocateLinkedBuffers(uint8_t bus);
+
+		/**
+		 * @brief Rewrite the prescaler of modules whose target prescale changed
+		 */
+		void updatePwmFrequencies();
+
+		/**
+		 * @brief Run the requested oscillator calibration
+		 */
+		void runOscillatorCalibration();
+
+		/**
+		 * @brief Estimate LED current and scale intensities to the power budget
+		 * 
+		 * Called by flush() before committing a frame with changes, so that
+		 * the cost follows the frame rate rather than loop(). Over budget,
+		 * every LED (fair mode) or the lowest priorities first (priority
+		 * mode) are scaled down at once; back under budget, scales recover
+		 * within POWER_RELEASE_MS (a changed scale marks the channels
+		 * dirty, which keeps the recovery going frame after frame).
+		 */
+		void updatePowerBudget();
+
+		/**
+		 * @brief Limit a broadcast intensity to the power budget
+		 * 
+		 * A broadcast drives every LED of the target at the same intensity,
+		 * bypassing the per-LED scales: the intensity is lowered so that the
+		 * target LEDs at full rating, plus the estimated current of the
+		 * other modules, stay within the budget.
+		 * 
+		 * @param intensity Requested intensity (0 to BrightnessCurve::INTENSITY_MAX)
+		 * @param group Broadcast group, BROADCAST_ALL for every module
+		 * @return Intensity to write
+		 */
+		uint16_t limitBroadcastIntensity(uint16_t intensity, uint8_t group) const;
+
+		/**
+		 * @brief Write the same registers once per bus to a broadcast target
+		 * 
+		 * @param group Broadcast group (1-based), BROADCAST_ALL for every module
+		 * @param data First register address followed by the values
+		 * @param length Number of bytes in data (register address included)
+		 * @return true if the write succeeded on every bus with members
+		 */
+		bool writeBroadcast(uint8_t group, const uint8_t* data, size_t length);
+
+		/**
+		 * @brief Start a flush task for each bus with modules
+		 */
+		void startFlushTasks();
+
+		/**
+		 * @brief Bus flush task entry point
+		 * 
+		 * @param param FlushTaskContext of the bus
+		 */
+		static void flushTaskEntry(void* param);
 };
 
 // Global instance
@@ -1,376 +1,967 @@
-/**
- * SPDX-FileCopyrightText: 2025 Jérôme SONRIER
- * SPDX-License-Identifier: GPL-3.0-or-later
- *
- * This file is part of emfao-light_control.
- *
- * emfao-light_control is free software: you can redistribute it and/or modify
- * it under the terms of the GNU General Public License as published by
- * the Free Software Foundation, either version 3 of the License, or
- * (at your option) any later version.
- *
- * emfao-light_control is distributed in the hope that it will be useful,
- * but WITHOUT ANY WARRANTY; without even the implied warranty of
- * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
- * GNU General Public License for more details.
- *
- * You should have received a copy of the GNU General Public License
- * along with emfao-light_control.  If not, see <https://www.gnu.org/licenses/>.
- *
- * @file    program.h
- * @brief   Declaration of the ProgramManager class.
- * 
- * This header defines the program management system that allows assigning
- * and controlling various animated effects to individual LEDs connected
- * to PCA9685 PWM controllers.
- * 
- * @author  Jérôme SONRIER <jsid@emor3j.fr.eu.org>
- * @date    2025-09-10
- */
-
-#pragma once
-
-#include <Arduino.h>
-#include <ArduinoJson.h>
-#include <memory>
-
-
-/**
- * @enum ProgramType
- * @brief Enumeration of available LED program types
- * 
- * Defines the different types of animated programs that can be assigned
- * to LEDs for creating various visual effects.
- */
-enum ProgramType {
-	PROGRAM_NONE = 0,           ///< No program assigned
-	PROGRAM_WELDING = 1,        ///< Welding arc simulation with random flashes
-	PROGRAM_HEARTBEAT = 2,      ///< Heartbeat rhythm with double pulse pattern
-	PROGRAM_BREATHING = 3,      ///< Breathing effect with smooth fade in/out
-	PROGRAM_SIMPLE_BLINK = 4,   ///< Simple 1 second on/off blinking
-	PROGRAM_TV_FLICKER = 5,     ///< TV screen flicker simulation
-	PROGRAM_FIREBOX_GLOW = 6,   ///< Firebox glow simulation
-	PROGRAM_CANDLE_FLICKER = 7, ///< Candle flame flickering simulation
-	PROGRAM_FRENCH_CROSSING = 8 ///< French level crossing light with filament bulb effect
-};
-
-/**
- * @struct ProgramState
- * @brief State information for a running LED program
- * 
- * Contains all the runtime state information needed to manage
- * the execution of an LED program, including timing, intensity,
- * and custom parameters.
- */
-struct ProgramState {
-	unsigned long last_update;    ///< Timestamp of last program update
-	unsigned long next_event;     ///< Timestamp for next scheduled event
-	bool active;                  ///< Whether the program is currently active
-	unsigned long start_time;     ///< Program start timestamp for cycle calculations
-	uint16_t current_intensity;   ///< Current LED intensity (0-4095)
-	JsonDocument parameters;      ///< Custom program parameters (extensible)
-};
-
-/**
- * @class ProgramManager
- * @brief Static class for managing LED programs across all modules
- * 
- * The ProgramManager provides a centralized system for assigning, updating,
- * and managing animated LED programs. It works directly with the LED objects
- * in the PCA9685 modules and handles all timing and state management.
- * 
- * @note All methods are static as there should be only one program manager
- *       instance in the system.
- */
-class ProgramManager {
-	public:
-		/**
-		 * @brief Initialize the program manager
-		 * 
-		 * Sets up the program manager and prepares it for operation.
-		 * Must be called once during system initialization.
-		 * 
-		 * @return true if initialization successful, false otherwise
-		 */
-		static bool initialize();
-		
-		/**
-		 * @brief Update all active LED programs
-		 * 
-		 * This method should be called regularly (typically in the main loop)
-		 * to update all active LED programs. It handles timing, state transitions,
-		 * and applies brightness changes to the hardware.
-		 * 
-		 * @param current_millis Current system time in milliseconds
-		 * 
-		 * @note Recommended call frequency: 100Hz (every 10ms) for smooth effects
-		 */
-		static void update(unsigned long current_millis);
-		
-		// === Program Assignment Management ===
-		
-		/**
-		 * @brief Assign a program to a specific LED
-		 * 
-		 * Assigns the specified program type to the LED at the given module
-		 * and LED coordinates. Automatically initializes the program state
-		 * and starts execution if the LED is enabled.
-		 * 
-		 * @param module_id PCA9685 module index (0-based)
-		 * @param led_id LED index within the module (0-based)
-		 * @param program_type Type of program to assign
-		 * 
-		 * @return true if assignment successful, false if invalid coordinates
-		 *         or program type
-		 * 
-		 * @note If a program is already assigned to the LED, it will be
-		 *       replaced and its state cleaned up
-		 */
-		static bool assign_program(uint8_t module_id, uint8_t led_id, ProgramType program_type);
-		
-		/**
-		 * @brief Remove program assignment from a specific LED
-		 * 
-		 * Unassigns any program from the specified LED, cleans up its state,
-		 * and sets the LED to no program (PROGRAM_NONE).
-		 * 
-		 * @param module_id PCA9685 module index (0-based)
-		 * @param led_id LED index within the module (0-based)
-		 * 
-		 * @return true if unassignment successful, false if invalid coordinates
-		 */
-		static bool unassign_program(uint8_t module_id, uint8_t led_id);
-		
-		/**
-		 * @brief Check if a program is assigned to a specific LED
-		 * 
-		 * @param module_id PCA9685 module index (0-based)
-		 * @param led_id LED index within the module (0-based)
-		 * 
-		 * @return true if a program (other than PROGRAM_NONE) is assigned,
-		 *         false otherwise or if invalid coordinates
-		 */
-		static bool is_program_assigned(uint8_t module_id, uint8_t led_id);
-		
-		/**
-		 * @brief Get the program type assigned to a specific LED
-		 * 
-		 * @param module_id PCA9685 module index (0-based)
-		 * @param led_id LED index within the module (0-based)
-		 * 
-		 * @return ProgramType assigned to the LED, or PROGRAM_NONE if no program
-		 *         is assigned or coordinates are invalid
-		 */
-		static ProgramType get_program_type(uint8_t module_id, uint8_t led_id);
-		
-		// === Program Information ===
-		
-		/**
-		 * @brief Get information about all available program types
-		 * 
-		 * Returns a JSON document containing information about all supported
-		 * program types, including their IDs, names, and descriptions.
-		 * 
-		 * @return JsonDocument with structure:
-		 *         {
-		 *           "programs": [
-		 *             {
-		 *               "id": <program_id>,
-		 *               "name": "<program_name>",
-		 *               "description": "<program_description>"
-		 *             },
-		 *             ...
-		 *           ],
-		 *           "total": <count>
-		 *         }
-		 */
-		static JsonDocument get_available_programs();
-		
-		/**
-		 * @brief Get information about all currently assigned programs
-		 * 
-		 * Returns a JSON document containing information about all LEDs
-		 * that currently have programs assigned to them.
-		 * 
-		 * @return JsonDocument with structure:
-		 *         {
-		 *           "assigned_programs": [
-		 *             {
-		 *               "module_id": <module_id>,
-		 *               "led_id": <led_id>,
-		 *               "program_type": <program_type_id>,
-		 *               "program_name": "<program_name>",
-		 *               "enabled": <boolean>
-		 *             },
-		 *             ...
-		 *           ],
-		 *           "total": <count>
-		 *         }
-		 */
-		static JsonDocument get_assigned_programs();
-		
-		/**
-		 * @brief Get human-readable name for a program type
-		 * 
-		 * @param type Program type to get name for
-		 * @return String containing the program name, or "None" for PROGRAM_NONE
-		 */
-		static String get_program_name(ProgramType type);
-		
-		/**
-		 * @brief Get description for a program type
-		 * 
-		 * @param type Program type to get description for
-		 * @return String containing the program description
-		 */
-		static String get_program_description(ProgramType type);
-		
-		// === Persistence ===
-		
-		/**
-		 * @brief Clear all program assignments
-		 * 
-		 * Removes all program assignments from all LEDs and cleans up
-		 * their associated state.
-		 */
-		static void clear_programs();
-
-		/**
-		 * @brief Initialize program state of a LED
-		 * 
-		 * Sets up program state for a LED.
-		 * 
-		 * @param module_id PCA9685 module index
-		 * @param led_id LED index within module
-		 */
-		static bool initialize_led_state(uint8_t module_id, uint8_t led_id);
-	
-	private:
-		// === Program Update Methods ===
-		
-		/**
-		 * @brief Update welding program for a specific LED
-		 * 
-		 * Handles the welding arc simulation with random intensity flashes
-		 * and realistic timing patterns.
-		 * 
-		 * @param module_id PCA9685 module index
-		 * @param led_id LED index within module
-		 * @param current_millis Current system time in milliseconds
-		 */
-		static void update_welding_program(uint8_t module_id, uint8_t led_id, unsigned long current_millis);
-		
-		/**
-		 * @brief Update heartbeat program for a specific LED
-		 * 
-		 * Handles the double-pulse heartbeat rhythm with systole/diastole pattern.
-		 * 
-		 * @param module_id PCA9685 module index
-		 * @param led_id LED index within module
-		 * @param current_millis Current system time in milliseconds
-		 */
-		static void update_heartbeat_program(uint8_t module_id, uint8_t led_id, unsigned long current_millis);
-		
-		/**
-		 * @brief Update breathing program for a specific LED
-		 * 
-		 * Handles the smooth breathing effect with sinusoidal fade in/out
-		 * pattern including inhale, hold, exhale, and pause phases.
-		 * 
-		 * @param module_id PCA9685 module index
-		 * @param led_id LED index within module
-		 * @param current_millis Current system time in milliseconds
-		 */
-		static void update_breathing_program(uint8_t module_id, uint8_t led_id, unsigned long current_millis);
-
-		/**
-		 * @brief Update simple blink program for a specific LED
-		 * 
-		 * Handles simple on/off blinking with 1 second intervals.
-		 * 
-		 * @param module_id PCA9685 module index
-		 * @param led_id LED index within module
-		 * @param current_millis Current system time in milliseconds
-		 */
-		static void update_simple_blink_program(uint8_t module_id, uint8_t led_id, unsigned long current_millis);
-
-		/**
-		 * @brief Update TV flicker program for a specific LED
-		 * 
-		 * Simulates the random flickering of a television screen with
-		 * blue-tinted light and irregular intensity changes.
-		 * 
-		 * @param module_id PCA9685 module index
-		 * @param led_id LED index within module
-		 * @param current_millis Current system time in milliseconds
-		 */
-		static void update_tv_flicker_program(uint8_t module_id, uint8_t led_id, unsigned long current_millis);
-
-		/**
-		 * @brief Firebox glow program for a specific LED
-		 * 
-		 * Simulates a wood fire with crackling flames, ember pops,
-		 * and natural burning variations with wind effects.
-		 * 
-		 * @param module_id PCA9685 module index
-		 * @param led_id LED index within module
-		 * @param current_millis Current system time in milliseconds
-		 */
-		static void update_firebox_glow_program(uint8_t module_id, uint8_t led_id, unsigned long current_millis);
-
-		/**
-		 * @brief Update candle flicker program for a specific LED
-		 * 
-		 * Simulates the gentle flickering of a candle or gas lamp flame
-		 * with organic variations and occasional stronger flickers.
-		 * 
-		 * @param module_id PCA9685 module index
-		 * @param led_id LED index within module
-		 * @param current_millis Current system time in milliseconds
-		 */
-		static void update_candle_flicker_program(uint8_t module_id, uint8_t led_id, unsigned long current_millis);
-
-		/**
-		 * @brief Update French level crossing program for a specific LED
-		 * 
-		 * Simulates a French railway level crossing warning light with
-		 * realistic filament bulb behavior: gradual warm-up and instant extinction.
-		 * Follows the French standard of 1Hz blinking (0.5s ON, 0.5s OFF).
-		 * 
-		 * @param module_id PCA9685 module index
-		 * @param led_id LED index within module
-		 * @param current_millis Current system time in milliseconds
-		 */
-		static void update_french_crossing_program(uint8_t module_id, uint8_t led_id, unsigned long current_millis);
-		
-		// === State Initialization Methods ===
-		
-		/**
-		 * @brief Initialize default program state
-		 * 
-		 * Sets up initial state for default program.
-		 * 
-		 * @param state Pointer to ProgramState to initialize
-		 */
-		static void initialize_default_state(ProgramState* state);
-
-		/**
-		 * @brief Initialize welding program state
-		 * 
-		 * Sets up initial state for welding program including random
-		 * timing for the first flash.
-		 * 
-		 * @param state Pointer to ProgramState to initialize
-		 */
-		static void initialize_welding_state(ProgramState* state);		
-};
-
-/// Global instance of the program manager
-/**
- * @brief Global ProgramManager instance
- * 
- * This global instance provides access to the program system
- * throughout the application. It should be initialized early in
- * the setup() function.
- */
+/**
+ * SPDX-FileCopyrightText: 2025 Jérôme SONRIER
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * This file is part of emfao-light_control.
+ *
+ * emfao-light_control is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * emfao-light_control is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with emfao-light_control.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @file    program.h
+ * @brief   Declaration of the ProgramManager class.
+ * 
+ * This header defines the program management system that allows assigning
+ * and controlling various animated effects to individual LEDs connected
+ * to PCA9685 PWM controllers.
+ * 
+ * @author  Jérôme SONRIER <jsid@emor3j.fr.eu.org>
+ * @date    2025-09-10
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <memory>
+
+#include "effect.h"
+
+
+/**
+ * @enum ProgramType
+ * @brief Enumeration of available LED program types
+ * 
+ * Defines the different types of animated programs that can be assigned
+ * to LEDs for creating various visual effects.
+ */
+enum ProgramType {
+	PROGRAM_NONE = 0,           ///< No program assigned
+	PROGRAM_WELDING = 1,        ///< Welding arc simulation with random flashes
+	PROGRAM_HEARTBEAT = 2,      ///< Heartbeat rhythm with double pulse pattern
+	PROGRAM_BREATHING = 3,      ///< Breathing effect with smooth fade in/out
+	PROGRAM_SIMPLE_BLINK = 4,   ///< Simple 1 second on/off blinking
+	PROGRAM_TV_FLICKER = 5,     ///< TV screen flicker simulation
+	PROGRAM_FIREBOX_GLOW = 6,   ///< Firebox glow simulation
+	PROGRAM_CANDLE_FLICKER = 7, ///< Candle flame flickering simulation
+	PROGRAM_FRENCH_CROSSING = 8,///< French level crossing light with filament bulb effect
+	PROGRAM_CUSTOM = 9          ///< User-defined effect from an effect slot
+};
+
+/**
+ * @enum TransitionEasing
+ * @brief Progress curve of a transition
+ */
+enum TransitionEasing : uint8_t {
+	EASING_LINEAR = 0,      ///< Constant speed
+	EASING_IN = 1,          ///< Starts slowly (quadratic)
+	EASING_OUT = 2,         ///< Ends slowly (quadratic)
+	EASING_IN_OUT = 3       ///< Starts and ends slowly (smoothstep)
+};
+
+/**
+ * @struct ProgramParams
+ * @brief Per-LED tuning of a program
+ * 
+ * Programs are written with fixed constants; parameters scale them for one
+ * LED so that LEDs running the same program do not all look identical.
+ * The fixed-point factors used by the programs are resolved once when the
+ * parameters are set, never per update. Every LED left at the defaults
+ * points to the shared read-only DEFAULTS instance.
+ */
+struct ProgramParams {
+	/// Highest intensity scale (percent)
+	static constexpr uint8_t INTENSITY_MAX = 200;
+	/// Highest probability scale (percent)
+	static constexpr uint8_t PROBABILITY_MAX = 200;
+	/// Slowest program speed (percent)
+	static constexpr uint16_t SPEED_MIN = 10;
+	/// Fastest program speed (percent)
+	static constexpr uint16_t SPEED_MAX = 1000;
+
+	uint8_t intensity_percent;     ///< Scale of program levels (0-200, 100 = unchanged)
+	uint8_t probability_percent;   ///< Scale of random event probabilities (0-200, 100 = unchanged)
+	uint16_t speed_percent;        ///< Program speed (10-1000, 100 = unchanged)
+	uint16_t min_level;            ///< Lowest level set by the program (0-4095)
+	uint16_t max_level;            ///< Highest level set by the program (0-4095)
+
+	uint16_t intensity_q8;         ///< Resolved level factor (256 = 1)
+	uint16_t probability_q8;       ///< Resolved probability factor (256 = 1)
+	uint16_t time_q8;              ///< Resolved program time per millisecond (256 = 1)
+	uint16_t interval_q8;          ///< Resolved milliseconds per program millisecond (256 = 1)
+
+	/// Parameters of every LED without overrides
+	static const ProgramParams DEFAULTS;
+};
+
+/**
+ * @struct ProgramState
+ * @brief State information for a running LED program
+ * 
+ * Contains all the runtime state information needed to manage
+ * the execution of an LED program, including timing, intensity,
+ * and custom parameters.
+ */
+struct ProgramState {
+	unsigned long last_update;    ///< Timestamp of last program update
+	unsigned long next_event;     ///< Timestamp for next scheduled event
+	bool active;                  ///< Whether the program is currently active
+	unsigned long start_time;     ///< Program start timestamp for cycle calculations
+	uint16_t current_intensity;   ///< Current LED intensity (0-4095)
+	JsonDocument parameters;      ///< Custom program parameters (extensible)
+	uint8_t effect_slot;          ///< Effect slot run by PROGRAM_CUSTOM
+	EffectVM::State effect;       ///< Effect interpreter state of PROGRAM_CUSTOM
+	uint16_t output_level;        ///< Last level computed by the program, before parameters
+	const ProgramParams* params = &ProgramParams::DEFAULTS;  ///< Resolved parameters (owned unless DEFAULTS)
+	uint8_t phase_group = 0;      ///< Phase group sharing the timebase (0 = own timebase)
+	uint16_t phase_offset = 0;    ///< Offset in the cycle of the group (Q16 fraction of a cycle)
+
+	ProgramState() = default;
+	ProgramState(const ProgramState&) = delete;
+	ProgramState& operator=(const ProgramState&) = delete;
+
+	/**
+	 * @brief Destructor, frees parameters overridden for this LED
+	 */
+	~ProgramState();
+};
+
+class LED;
+
+/**
+ * @class ProgramManager
+ * @brief Static class for managing LED programs across all modules
+ * 
+ * The ProgramManager provides a centralized system for assigning, updating,
+ * and managing animated LED programs. It works directly with the LED objects
+ * in the PCA9685 modules and handles all timing and state management.
+ * 
+ * @note All methods are static as there should be only one program manager
+ *       instance in the system.
+ */
+class ProgramManager {
+	public:
+		/// Number of user effect slots
+		static constexpr uint8_t EFFECT_SLOTS = 8;
+		/// Number of native programs compared by the effect benchmark
+		static constexpr uint8_t EFFECT_BENCH_COUNT = 3;
+		/// Default number of updates timed per program by the effect benchmark
+		static constexpr uint16_t EFFECT_BENCH_ROUNDS = 2000;
+		/// Maximum number of updates timed per program by the effect benchmark
+		static constexpr uint16_t EFFECT_BENCH_ROUNDS_MAX = 20000;
+		/// Highest accepted ratio between effect and native update time
+		static constexpr float EFFECT_BENCH_RATIO_MAX = 2.0f;
+		/// Number of transitions running at the same time
+		static constexpr uint8_t TRANSITION_SLOTS = 8;
+		/// Longest transition (milliseconds)
+		static constexpr uint32_t TRANSITION_MS_MAX = 3600000;
+		/// Transition weight of the target output (Q16)
+		static constexpr uint32_t TRANSITION_WEIGHT_ONE = 1u << 16;
+		/// Latest a LED can join a running transition (milliseconds after its start)
+		static constexpr uint32_t TRANSITION_JOIN_MS_MAX = 65535;
+		/// Number of phase groups
+		static constexpr uint8_t PHASE_GROUPS = 8;
+		/// Entries of the shared level table (power of two)
+		static constexpr uint8_t SHARED_LEVEL_SLOTS = 32;
+
+		/**
+		 * @struct EffectBenchResult
+		 * @brief Update time of a native program and of its bytecode equivalent
+		 */
+		struct EffectBenchResult {
+			const char* name;       ///< Native program name
+			uint32_t native_us;     ///< Time of the native updates (microseconds)
+			uint32_t effect_us;     ///< Time of the effect updates (microseconds)
+		};
+
+		/**
+		 * @brief Initialize the program manager
+		 * 
+		 * Sets up the program manager and prepares it for operation.
+		 * Must be called once during system initialization.
+		 * 
+		 * @return true if initialization successful, false otherwise
+		 */
+		static bool initialize();
+		
+		/**
+		 * @brief Update all active LED programs
+		 * 
+		 * This method should be called regularly (typically in the main loop)
+		 * to update all active LED programs. It handles timing, state transitions,
+		 * and applies brightness changes to the hardware.
+		 * 
+		 * @param current_millis Current system time in milliseconds
+		 * 
+		 * @note Recommended call frequency: 100Hz (every 10ms) for smooth effects
+		 */
+		static void update(unsigned long current_millis);
+		
+		// === Program Assignment Management ===
+		
+		/**
+		 * @brief Assign a program to a specific LED
+		 * 
+		 * Assigns the specified program type to the LED at the given module
+		 * and LED coordinates. Automatically initializes the program state
+		 * and starts execution if the LED is enabled.
+		 * 
+		 * @param module_id PCA9685 module index (0-based)
+		 * @param led_id LED index within the module (0-based)
+		 * @param program_type Type of program to assign
+		 * @param quiet Do not log the assignment (bulk group operations)
+		 * 
+		 * @return true if assignment successful, false if invalid coordinates
+		 *         or program type
+		 * 
+		 * @note If a program is already assigned to the LED, it will be
+		 *       replaced and its state cleaned up
+		 */
+		static bool assign_program(uint8_t module_id, uint8_t led_id, ProgramType program_type, bool quiet = false);
+		
+		/**
+		 * @brief Remove program assignment from a specific LED
+		 * 
+		 * Unassigns any program from the specified LED, cleans up its state,
+		 * and sets the LED to no program (PROGRAM_NONE).
+		 * 
+		 * @param module_id PCA9685 module index (0-based)
+		 * @param led_id LED index within the module (0-based)
+		 * @param quiet Do not log the removal (bulk group operations)
+		 * 
+		 * @return true if unassignment successful, false if invalid coordinates
+		 */
+		static bool unassign_program(uint8_t module_id, uint8_t led_id, bool quiet = false);
+
+		/**
+		 * @brief Start a program on a LED that is not a module channel
+		 * 
+		 * Used by the overlay layers, whose LED only holds the program
+		 * output blended over a channel.
+		 * 
+		 * @param led_info LED receiving the program
+		 * @param program_type Program to start (PROGRAM_NONE stops it)
+		 * @return false if the program type is invalid
+		 */
+		static bool start_program(LED* led_info, ProgramType program_type);
+
+		/**
+		 * @brief Stop the program of a LED started by start_program()
+		 * 
+		 * @param led_info LED running the program
+		 */
+		static void stop_program(LED* led_info);
+
+		/**
+		 * @brief Run one update of the program of a LED
+		 * 
+		 * @param led_info LED the program writes to
+		 * @param module_id Module of the channel marked dirty on changes
+		 * @param led_id Channel marked dirty on changes
+		 * @param current_millis Current system time in milliseconds
+		 */
+		static void run_program(LED* led_info, uint8_t module_id, uint8_t led_id, unsigned long current_millis);
+		
+		/**
+		 * @brief Check if a program is assigned to a specific LED
+		 * 
+		 * @param module_id PCA9685 module index (0-based)
+		 * @param led_id LED index within the module (0-based)
+		 * 
+		 * @return true if a program (other than PROGRAM_NONE) is assigned,
+		 *         false otherwise or if invalid coordinates
+		 */
+		static bool is_program_assigned(uint8_t module_id, uint8_t led_id);
+		
+		/**
+		 * @brief Get the program type assigned to a specific LED
+		 * 
+		 * @param module_id PCA9685 module index (0-based)
+		 * @param led_id LED index within the module (0-based)
+		 * 
+		 * @return ProgramType assigned to the LED, or PROGRAM_NONE if no program
+		 *         is assigned or coordinates are invalid
+		 */
+		static ProgramType get_program_type(uint8_t module_id, uint8_t led_id);
+		
+		// === Program Information ===
+		
+		/**
+		 * @brief Get information about all available program types
+		 * 
+		 * Returns a JSON document containing information about all supported
+		 * program types, including their IDs, names, and descriptions.
+		 * 
+		 * @return JsonDocument with structure:
+		 *         {
+		 *           "programs": [
+		 *             {
+		 *               "id": <program_id>,
+		 *               "name": "<program_name>",
+		 *               "description": "<program_description>"
+		 *             },
+		 *             ...
+		 *           ],
+		 *           "total": <count>
+		 *         }
+		 */
+		static JsonDocument get_available_programs();
+		
+		/**
+		 * @brief Get information about all currently assigned programs
+		 * 
+		 * Returns a JSON document containing information about all LEDs
+		 * that currently have programs assigned to them.
+		 * 
+		 * @return JsonDocument with structure:
+		 *         {
+		 *           "assigned_programs": [
+		 *             {
+		 *               "module_id": <module_id>,
+		 *               "led_id": <led_id>,
+		 *               "program_type": <program_type_id>,
+		 *               "program_name": "<program_name>",
+		 *               "enabled": <boolean>
+		 *             },
+		 *             ...
+		 *           ],
+		 *           "total": <count>
+		 *         }
+		 */
+		static JsonDocument get_assigned_programs();
+		
+		/**
+		 * @brief Get human-readable name for a program type
+		 * 
+		 * @param type Program type to get name for
+		 * @return String containing the program name, or "None" for PROGRAM_NONE
+		 */
+		static String get_program_name(ProgramType type);
+		
+		/**
+		 * @brief Get description for a program type
+		 * 
+		 * @param type Program type to get description for
+		 * @return String containing the program description
+		 */
+		static String get_program_description(ProgramType type);
+		
+		// === Persistence ===
+		
+		/**
+		 * @brief Clear all program assignments
+		 * 
+		 * Removes all program assignments from all LEDs and cleans up
+		 * their associated state.
+		 */
+		static void clear_programs();
+
+		/**
+		 * @brief Initialize program state of a LED
+		 * 
+		 * Sets up program state for a LED.
+		 * 
+		 * @param module_id PCA9685 module index
+		 * @param led_id LED index within module
+		 */
+		static bool initialize_led_state(uint8_t module_id, uint8_t led_id);
+
+		// === Program Parameters ===
+
+		/**
+		 * @brief Set the parameters of the program assigned to a LED
+		 * 
+		 * Parameters are validated and resolved here. They follow the LED
+		 * when its program is reassigned.
+		 * 
+		 * @param module_id PCA9685 module index (0-based)
+		 * @param led_id LED index within the module (0-based)
+		 * @param params Parameter settings (resolved factors are ignored)
+		 * @return false if the LED has no program or a setting is out of range
+		 */
+		static bool set_program_params(uint8_t module_id, uint8_t led_id, const ProgramParams& params);
+
+		/**
+		 * @brief Get the parameters of the program assigned to a LED
+		 * 
+		 * @param module_id PCA9685 module index (0-based)
+		 * @param led_id LED index within the module (0-based)
+		 * @return Parameters, DEFAULTS if the LED has no program or no override
+		 */
+		static const ProgramParams& get_program_params(uint8_t module_id, uint8_t led_id);
+
+		/**
+		 * @brief Update parameter settings from JSON
+		 * 
+		 * Reads "intensity", "speed", "probability" (percent), "min" and
+		 * "max" (levels); missing keys keep their value.
+		 * 
+		 * @param json JSON object
+		 * @param params Settings to update
+		 * @return false if a present value has the wrong type
+		 */
+		static bool params_from_json(JsonObjectConst json, ProgramParams& params);
+
+		/**
+		 * @brief Write parameter settings to JSON
+		 * 
+		 * @param params Parameters
+		 * @param json JSON object to fill with the keys read by params_from_json()
+		 */
+		static void params_to_json(const ProgramParams& params, JsonObject json);
+
+		/**
+		 * @brief Check if parameters keep every program constant unchanged
+		 * 
+		 * @param params Parameters
+		 * @return true if the settings equal DEFAULTS
+		 */
+		static bool is_default_params(const ProgramParams& params);
+
+		/**
+		 * @brief Validate parameter settings and compute their factors
+		 * 
+		 * @param params Parameters to resolve
+		 * @return false if a setting is out of range
+		 */
+		static bool resolve_params(ProgramParams& params);
+
+		// === Phase Groups ===
+
+		/**
+		 * @brief Put the program of a LED in a phase group
+		 * 
+		 * Members of a group run their cycle on the timebase of the group
+		 * instead of their assignment time, shifted by their offset: two
+		 * crossing lights at 0 and 180 degrees alternate, whenever they
+		 * were assigned. The position in the cycle is computed once per
+		 * group and update, and members update on the same frames. Applies
+		 * to the cyclic programs (heartbeat, breathing, blink, French
+		 * crossing); membership follows the LED when its program is
+		 * reassigned.
+		 * 
+		 * @param module_id PCA9685 module index (0-based)
+		 * @param led_id LED index within the module (0-based)
+		 * @param group Phase group (1 to PHASE_GROUPS, 0 to leave)
+		 * @param offset_degrees Offset in the cycle (0 to 359 degrees)
+		 * @return false if the LED has no program or a setting is out of range
+		 */
+		static bool set_phase_group(uint8_t module_id, uint8_t led_id, uint8_t group, uint16_t offset_degrees);
+
+		/**
+		 * @brief Get the phase group of a LED
+		 * 
+		 * @param module_id PCA9685 module index (0-based)
+		 * @param led_id LED index within the module (0-based)
+		 * @param offset_degrees Set to the offset in the cycle (degrees)
+		 * @return Phase group (0 if none or no program)
+		 */
+		static uint8_t get_phase_group(uint8_t module_id, uint8_t led_id, uint16_t& offset_degrees);
+
+		// === Shared Evaluation ===
+
+		/**
+		 * @brief Counters of the shared curve evaluation
+		 */
+		struct SharedStats {
+			uint32_t evaluations;       ///< Levels computed from the program curve
+			uint32_t reuses;            ///< Levels copied from an LED of the same frame
+		};
+
+		/**
+		 * @brief Get the counters of the shared curve evaluation
+		 * 
+		 * The deterministic programs (heartbeat, breathing, blink) compute
+		 * their level once per update for all the LEDs at the same point of
+		 * the same curve with the same level parameters, typically the
+		 * members of a phase group at the same offset, and copy it to the
+		 * others.
+		 * 
+		 * @return Counters since boot
+		 */
+		static SharedStats get_shared_stats();
+
+		// === User Effects ===
+
+		/**
+		 * @brief Store an effect in a slot at once
+		 *
+		 * Used while loading the configuration, before programs run. LEDs
+		 * running the slot restart the new effect.
+		 *
+		 * @param slot Effect slot (0 to EFFECT_SLOTS - 1)
+		 * @param effect Compiled effect (length 0 clears the slot)
+		 * @return true if the slot exists
+		 */
+		static bool set_effect(uint8_t slot, const EffectVM::Program& effect);
+
+		/**
+		 * @brief Queue an effect for a slot
+		 *
+		 * The effect is copied and installed by the next update(), so that a
+		 * slot never changes while LEDs are running it.
+		 *
+		 * @param slot Effect slot (0 to EFFECT_SLOTS - 1)
+		 * @param effect Compiled effect (length 0 clears the slot)
+		 * @return false if the slot does not exist or an effect is already queued
+		 */
+		static bool request_effect(uint8_t slot, const EffectVM::Program& effect);
+
+		/**
+		 * @brief Get the effect of a slot
+		 * @param slot Effect slot
+		 * @return Compiled effect, or nullptr if the slot is empty or does not exist
+		 */
+		static const EffectVM::Program* get_effect(uint8_t slot);
+
+		/**
+		 * @brief Get the execution counters of a slot
+		 * @param slot Effect slot
+		 * @return Counters since the effect was installed (zero if the slot does not exist)
+		 */
+		static EffectVM::Stats get_effect_stats(uint8_t slot);
+
+		/**
+		 * @brief Run an effect slot on a LED
+		 *
+		 * Assigns PROGRAM_CUSTOM to the LED if needed and restarts the
+		 * effect from its first instruction.
+		 *
+		 * @param module_id PCA9685 module index (0-based)
+		 * @param led_id LED index within the module (0-based)
+		 * @param slot Effect slot (0 to EFFECT_SLOTS - 1)
+		 * @return true if the effect was assigned
+		 */
+		static bool assign_effect(uint8_t module_id, uint8_t led_id, uint8_t slot);
+
+		/**
+		 * @brief Queue the effect benchmark
+		 *
+		 * The next update() times the heartbeat, breathing and blink programs
+		 * against equivalent effects on the first LED, then restores it.
+		 *
+		 * @param rounds Number of updates timed per program (1 to EFFECT_BENCH_ROUNDS_MAX)
+		 * @return false if the number of rounds is invalid
+		 */
+		static bool request_effect_bench(uint16_t rounds);
+
+		/**
+		 * @brief Check if the effect benchmark is queued
+		 * @return true until the benchmark has run
+		 */
+		static bool is_effect_bench_pending() { return effect_bench_pending_; }
+
+		/**
+		 * @brief Get the last effect benchmark results
+		 * @param rounds Set to the number of updates timed per program (0 if never run)
+		 * @return EFFECT_BENCH_COUNT results
+		 */
+		static const EffectBenchResult* get_effect_bench(uint16_t& rounds);
+
+		// === Transitions ===
+
+		/**
+		 * @brief Start a transition
+		 *
+		 * LEDs added with add_to_transition() fade from their output at that
+		 * time to their live output (static brightness or running program)
+		 * over the duration. The eased weight is computed once per update
+		 * for the whole transition; each LED only mixes its two levels when
+		 * its PWM duty is computed.
+		 *
+		 * @param duration_ms Duration (1 to TRANSITION_MS_MAX milliseconds)
+		 * @param easing Progress curve
+		 * @return Transition slot (1 to TRANSITION_SLOTS), 0 if the duration
+		 *         is invalid or every slot is in use (changes then apply at once)
+		 *
+		 * @note Main loop only, like add_to_transition(): update() releases
+		 *       and hands out the slots. Web requests queue their changes
+		 *       (GroupManager::requestAction(), requestScene(), requestLed()).
+		 */
+		static uint8_t begin_transition(uint32_t duration_ms, TransitionEasing easing);
+
+		/**
+		 * @brief Add a LED to a transition
+		 *
+		 * Must be called before the LED state is changed: the current output
+		 * is the start level. A LED already fading starts from its mixed
+		 * output, so that transitions chain without a jump.
+		 *
+		 * A LED added after the start fades over the full duration from
+		 * when it joins, and the slot runs until its fade ends: jittered
+		 * changes share one slot instead of one per batch.
+		 *
+		 * @param slot Transition slot returned by begin_transition()
+		 * @param module_id PCA9685 module index (0-based)
+		 * @param led_id LED index within the module (0-based)
+		 * @return true if the LED was added, false if the slot is not running
+		 *         or started more than TRANSITION_JOIN_MS_MAX ago
+		 *
+		 * @note Main loop only, in the same pass as begin_transition(), so
+		 *       that the slot cannot be released in between
+		 */
+		static bool add_to_transition(uint8_t slot, uint8_t module_id, uint8_t led_id);
+
+		/**
+		 * @brief Get the current weight of a LED fade
+		 * @param slot Transition slot
+		 * @param delay Time between the transition start and the LED joining (milliseconds)
+		 * @return Q16 weight of the target output (TRANSITION_WEIGHT_ONE if
+		 *         the slot is not running)
+		 */
+		static uint32_t get_transition_weight(uint8_t slot, uint16_t delay = 0);
+
+		/**
+		 * @brief Get the serial of a running transition
+		 *
+		 * Each begin_transition() gets a new serial, so that a holder of a
+		 * slot can tell whether it was ended and reused since.
+		 *
+		 * @param slot Transition slot
+		 * @return Serial, 0 if the slot is not running
+		 */
+		static uint16_t get_transition_serial(uint8_t slot);
+
+		/**
+		 * @brief Check whether LEDs can still join a transition
+		 * @param slot Transition slot
+		 * @param serial Serial read when the slot was started
+		 * @return true if the same transition still runs and can be joined
+		 */
+		static bool can_join_transition(uint8_t slot, uint16_t serial);
+
+		/**
+		 * @brief Get the number of running transitions
+		 * @return Slots in use
+		 */
+		static uint8_t get_transition_count();
+
+		/**
+		 * @brief Get the name of an easing
+		 * @param easing Easing
+		 * @return Name ("linear", "in", "out", "in_out")
+		 */
+		static const char* get_easing_name(TransitionEasing easing);
+
+		/**
+		 * @brief Find an easing from its name
+		 * @param name Name as returned by get_easing_name()
+		 * @param easing Set to the easing when found
+		 * @return true if the name is known
+		 */
+		static bool easing_from_name(const char* name, TransitionEasing& easing);
+	
+	private:
+		// === Program Update Methods ===
+		
+		/**
+		 * @brief Update welding program for a specific LED
+		 * 
+		 * Handles the welding arc simulation with random intensity flashes
+		 * and realistic timing patterns.
+		 * 
+		 * @param led_info LED the program writes to
+		 * @param module_id PCA9685 module index
+		 * @param led_id LED index within module
+		 * @param current_millis Current system time in milliseconds
+		 */
+		static void update_welding_program(LED* led_info, uint8_t module_id, uint8_t led_id, unsigned long current_millis);
+		
+		/**
+		 * @brief Update heartbeat program for a specific LED
+		 * 
+		 * Handles the double-pulse heartbeat rhythm with systole/diastole pattern.
+		 * 
+		 * @param led_info LED the program writes to
+		 * @param module_id PCA9685 module index
+		 * @param led_id LED index within module
+		 * @param current_millis Current system time in milliseconds
+		 */
+		static void update_heartbeat_program(LED* led_info, uint8_t module_id, uint8_t led_id, unsigned long current_millis);
+		
+		/**
+		 * @brief Update breathing program for a specific LED
+		 * 
+		 * Handles the smooth breathing effect with sinusoidal fade in/out
+		 * pattern including inhale, hold, exhale, and pause phases.
+		 * 
+		 * @param led_info LED the program writes to
+		 * @param module_id PCA9685 module index
+		 * @param led_id LED index within module
+		 * @param current_millis Current system time in milliseconds
+		 */
+		static void update_breathing_program(LED* led_info, uint8_t module_id, uint8_t led_id, unsigned long current_millis);
+
+		/**
+		 * @brief Update simple blink program for a specific LED
+		 * 
+		 * Handles simple on/off blinking with 1 second intervals.
+		 * 
+		 * @param led_info LED the program writes to
+		 * @param module_id PCA9685 module index
+		 * @param led_id LED index within module
+		 * @param current_millis Current system time in milliseconds
+		 */
+		static void update_simple_blink_program(LED* led_info, uint8_t module_id, uint8_t led_id, unsigned long current_millis);
+
+		/**
+		 * @brief Update TV flicker program for a specific LED
+		 * 
+		 * Simulates the random flickering of a television screen with
+		 * blue-tinted light and irregular intensity changes.
+		 * 
+		 * @param led_info LED the program writes to
+		 * @param module_id PCA9685 module index
+		 * @param led_id LED index within module
+		 * @param current_millis Current system time in milliseconds
+		 */
+		static void update_tv_flicker_program(LED* led_info, uint8_t module_id, uint8_t led_id, unsigned long current_millis);
+
+		/**
+		 * @brief Firebox glow program for a specific LED
+		 * 
+		 * Simulates a wood fire with crackling flames, ember pops,
+		 * and natural burning variations with wind effects.
+		 * 
+		 * @param led_info LED the program writes to
+		 * @param module_id PCA9685 module index
+		 * @param led_id LED index within module
+		 * @param current_millis Current system time in milliseconds
+		 */
+		static void update_firebox_glow_program(LED* led_info, uint8_t module_id, uint8_t led_id, unsigned long current_millis);
+
+		/**
+		 * @brief Update candle flicker program for a specific LED
+		 * 
+		 * Simulates the gentle flickering of a candle or gas lamp flame
+		 * with organic variations and occasional stronger flickers.
+		 * 
+		 * @param led_info LED the program writes to
+		 * @param module_id PCA9685 module index
+		 * @param led_id LED index within module
+		 * @param current_millis Current system time in milliseconds
+		 */
+		static void update_candle_flicker_program(LED* led_info, uint8_t module_id, uint8_t led_id, unsigned long current_millis);
+
+		/**
+		 * @brief Update French level crossing program for a specific LED
+		 * 
+		 * Simulates a French railway level crossing warning light with
+		 * realistic filament bulb behavior: gradual warm-up and instant extinction.
+		 * Follows the French standard of 1Hz blinking (0.5s ON, 0.5s OFF).
+		 * 
+		 * @param led_info LED the program writes to
+		 * @param module_id PCA9685 module index
+		 * @param led_id LED index within module
+		 * @param current_millis Current system time in milliseconds
+		 */
+		static void update_french_crossing_program(LED* led_info, uint8_t module_id, uint8_t led_id, unsigned long current_millis);
+
+		/**
+		 * @brief Update custom effect program for a specific LED
+		 *
+		 * Runs the effect interpreter of the LED up to now.
+		 *
+		 * @param led_info LED the program writes to
+		 * @param module_id PCA9685 module index
+		 * @param led_id LED index within module
+		 * @param current_millis Current system time in milliseconds
+		 */
+		static void update_custom_program(LED* led_info, uint8_t module_id, uint8_t led_id, unsigned long current_millis);
+
+		// === State Management ===
+
+		/**
+		 * @brief Create a program state replacing a previous one
+		 * 
+		 * The effect slot and the parameters move to the new state, then
+		 * the previous state is deleted.
+		 * 
+		 * @param previous Previous state of the LED (can be nullptr)
+		 * @return New state
+		 */
+		static ProgramState* create_state(ProgramState* previous);
+
+		// === User Effect Management ===
+
+		/**
+		 * @brief Restart the effect on every LED running a slot
+		 * @param slot Effect slot
+		 */
+		static void restart_effect(uint8_t slot);
+
+		/**
+		 * @brief Install the queued effect, if any
+		 */
+		static void apply_pending_effect();
+
+		/**
+		 * @brief Time native programs against equivalent effects
+		 */
+		static void run_effect_bench();
+
+		static EffectVM::Program effects_[EFFECT_SLOTS];            ///< Effect slots
+		static EffectVM::Stats effect_stats_[EFFECT_SLOTS];         ///< Execution counters per slot
+		static EffectVM::Program pending_effect_;                   ///< Effect queued by request_effect()
+		static uint8_t pending_effect_slot_;                        ///< Slot of the queued effect
+		static volatile bool effect_pending_;                       ///< An effect is queued
+		static EffectBenchResult effect_bench_[EFFECT_BENCH_COUNT]; ///< Last benchmark results
+		static uint16_t effect_bench_rounds_;                       ///< Rounds of the queued or last benchmark
+		static volatile bool effect_bench_pending_;                 ///< The benchmark is queued
+
+		// === Transition Management ===
+
+		/**
+		 * @brief Running transition
+		 */
+		struct Transition {
+			unsigned long start;            ///< millis() at begin_transition()
+			uint32_t duration;              ///< Duration of each LED fade (milliseconds)
+			uint32_t span;                  ///< Time from start to the end of the last LED fade (milliseconds)
+			uint32_t elapsed;               ///< Time since start at the last update (milliseconds)
+			TransitionEasing easing;        ///< Progress curve
+			uint32_t weight;                ///< Q16 weight of the LEDs added at start
+			uint16_t serial;                ///< Tells this transition apart from earlier ones in the slot
+			bool finished;                  ///< Every LED fade ended, LEDs are released
+			volatile bool active;           ///< Slot in use
+		};
+
+		/**
+		 * @brief Compute the weight of every running transition
+		 * @param current_millis Current system time in milliseconds
+		 */
+		static void update_transitions(unsigned long current_millis);
+
+		/**
+		 * @brief Apply an easing curve
+		 * @param easing Progress curve
+		 * @param t Q16 elapsed fraction (0 to TRANSITION_WEIGHT_ONE)
+		 * @return Q16 weight
+		 */
+		static uint32_t ease(TransitionEasing easing, uint32_t t);
+
+		static Transition transitions_[TRANSITION_SLOTS];           ///< Transition slots (slot n at index n - 1)
+		static uint16_t transition_serial_;                         ///< Serial of the last started transition
+
+		// === Phase Group Management ===
+
+		/**
+		 * @brief Shared timebase of a phase group
+		 */
+		struct PhaseGroup {
+			unsigned long start;        ///< millis() when the first member joined
+			bool started;               ///< The timebase is set
+			unsigned long frame;        ///< Update time of the cached phase
+			uint32_t cycle;             ///< Cycle length of the cached phase (program milliseconds)
+			uint16_t time_q8;           ///< Speed factor of the cached phase
+			uint16_t phase;             ///< Cached position in the cycle (Q16)
+		};
+
+		/**
+		 * @brief Get the position of a LED in its program cycle
+		 * 
+		 * Uses the group timebase and offset for members of a phase group,
+		 * the assignment time otherwise.
+		 * 
+		 * @param state Program state
+		 * @param current_millis Current system time in milliseconds
+		 * @param cycle Cycle length (program milliseconds)
+		 * @return Time in the cycle (program milliseconds, below cycle)
+		 */
+		static unsigned long get_cycle_time(const ProgramState* state, unsigned long current_millis, unsigned long cycle);
+
+		/**
+		 * @brief Check if a cyclic program is due for an update
+		 * 
+		 * Members of a phase group update on the boundaries of the group
+		 * timebase, so that they change on the same frame.
+		 * 
+		 * @param state Program state
+		 * @param current_millis Current system time in milliseconds
+		 * @param interval Update interval (milliseconds)
+		 * @return true if the program should update now
+		 */
+		static bool is_update_due(const ProgramState* state, unsigned long current_millis, unsigned long interval);
+
+		static PhaseGroup phase_groups_[PHASE_GROUPS];              ///< Phase groups (group n at index n - 1)
+
+		// === Shared Evaluation Management ===
+
+		/**
+		 * @brief Level computed for one point of a program curve
+		 */
+		struct SharedLevel {
+			unsigned long frame;        ///< Update time of the level
+			uint32_t cycle_time;        ///< Time in the cycle (program milliseconds)
+			uint16_t intensity_q8;      ///< Level factor the level was scaled with
+			uint16_t min_level;         ///< Lower bound the level was clamped to
+			uint16_t max_level;         ///< Upper bound the level was clamped to
+			uint16_t level;             ///< Level set to the LEDs (0-4095)
+			uint8_t program;            ///< Program (ProgramType)
+		};
+
+		/**
+		 * @brief Get the level of a deterministic program, computed once per frame
+		 * 
+		 * Looks the point of the curve up in a small table of the levels
+		 * of the current update; on a miss the curve is evaluated and the
+		 * entry replaced.
+		 * 
+		 * @param program Heartbeat, breathing or simple blink
+		 * @param params Resolved parameters of the LED
+		 * @param current_millis Current system time in milliseconds
+		 * @param cycle_time Time in the cycle (program milliseconds)
+		 * @return Level to set (0-4095)
+		 */
+		static uint16_t get_shared_level(ProgramType program, const ProgramParams* params, unsigned long current_millis, unsigned long cycle_time);
+
+		static SharedLevel shared_levels_[SHARED_LEVEL_SLOTS];      ///< Levels of the current update
+		static SharedStats shared_stats_;                           ///< Shared evaluation counters
+		
+		// === State Initialization Methods ===
+		
+		/**
+		 * @brief Initialize the program state of a LED, whatever its channel
+		 * 
+		 * @param led_info LED with a program state
+		 */
+		static void initialize_state(LED* led_info);
+
+		/**
+		 * @brief Initialize default program state
+		 * 
+		 * Sets up initial state for default program.
+		 * 
+		 * @param state Pointer to ProgramState to initialize
+		 */
+		static void initialize_default_state(ProgramState* state);
+
+		/**
+		 * @brief Initialize welding program state
+		 * 
+		 * Sets up initial state for welding program including random
+		 * timing for the first flash.
+		 * 
+		 * @param state Pointer to ProgramState to initialize
+		 */
+		static void initialize_welding_state(ProgramState* state);		
+};
+
+/// Global instance of the program manager
+/**
+ * @brief Global ProgramManager instance
+ * 
+ * This global instance provides access to the program system
+ * throughout the application. It should be initialized early in
+ * the setup() function.
+ */
 extern std::unique_ptr<ProgramManager> program_manager;
\ No newline at end of file
@@ -0,0 +1,87 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Jérôme SONRIER
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * This file is part of emfao-light_control.
+ *
+ * emfao-light_control is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * emfao-light_control is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with emfao-light_control.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @file  pwm_phase.h
+ * @brief PWM phase offsets of the PCA9685 channels
+ *
+ * With every ON time at tick 0, all channels switch on at the same instant
+ * of each PWM period and the supply sees one large current step per period.
+ * Spreading the ON ticks evenly over the period keeps the number of
+ * channels on at once close to the average load.
+ *
+ * Only integer arithmetic, no hardware access: the same code runs in the
+ * host tests (test/test_pwm_phase).
+ *
+ * @author  Jérôme SONRIER <jsid@emor3j.fr.eu.org>
+ * @date    2025-10-17
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+
+/**
+ * @class PwmPhase
+ * @brief ON/OFF encoding and phase offsets of PWM channels
+ *
+ * @note All methods are static
+ */
+class PwmPhase {
+	public:
+		/// PWM counter steps per period (12-bit counter)
+		static constexpr uint16_t STEPS = 4096;
+
+		/// Level of a channel always on
+		static constexpr uint16_t LEVEL_MAX = STEPS - 1;
+
+		/**
+		 * @brief Encode a brightness level as PCA9685 ON/OFF counts
+		 *
+		 * 0 and LEVEL_MAX use the full off/full on bits. Other levels turn
+		 * on at the offset tick; OFF wraps around the period.
+		 *
+		 * @param level Brightness level (0 to LEVEL_MAX)
+		 * @param offset ON tick within the PWM period
+		 * @param on ON count (STEPS = full on)
+		 * @param off OFF count (STEPS = full off)
+		 */
+		static void encode(uint16_t level, uint16_t offset, uint16_t& on, uint16_t& off);
+
+		/**
+		 * @brief Get the evenly spaced offset of a channel
+		 *
+		 * @param index Channel index over every module (0 to channels - 1)
+		 * @param channels Channel count
+		 * @return ON tick within the PWM period (0 to STEPS - 1)
+		 */
+		static uint16_t getOffset(uint16_t index, uint16_t channels);
+
+		/**
+		 * @brief Get the highest number of channels on at once for a uniform level
+		 *
+		 * With evenly spaced offsets, at most ceil(channels * level / STEPS)
+		 * channels overlap, plus one for rounding of the offsets.
+		 *
+		 * @param channels Channel count
+		 * @param level Level applied to every channel
+		 * @return Highest acceptable peak
+		 */
+		static uint16_t getExpectedPeak(uint16_t channels, uint16_t level);
+};
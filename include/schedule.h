@@ -0,0 +1,330 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Jérôme SONRIER
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * This file is part of emfao-light_control.
+ *
+ * emfao-light_control is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * emfao-light_control is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with emfao-light_control.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @file  schedule.h
+ * @brief Model clock and time-of-day schedules
+ *
+ * Model railways run a compressed day: the model clock advances by the
+ * speed ratio times real time (60 = one model hour per real minute) and
+ * wraps at model midnight. Schedule events recall a scene or change an
+ * LED group at a model time of day; a group event may spread its LEDs
+ * over a random delay (jitter) so that the windows of a street light up
+ * one after the other.
+ *
+ * Events are expanded once per model day into a list of firings sorted by
+ * model time, one per LED for jittered events, with fresh random delays
+ * each day. The main loop only compares the model time with the firing
+ * under the next-event pointer, so an idle frame costs one comparison
+ * whatever the number of events, and a frame firing k LEDs costs O(k).
+ *
+ * @author  Jérôme SONRIER <jsid@emor3j.fr.eu.org>
+ * @date    2025-10-17
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <memory>
+
+#include "group.h"
+
+
+/**
+ * @class ScheduleManager
+ * @brief Owner of the model clock and of the schedule events
+ */
+class ScheduleManager {
+	public:
+		/// Maximum number of schedule events
+		static constexpr uint8_t EVENT_MAX = 32;
+		/// Maximum number of firings per model day
+		static constexpr uint16_t FIRING_MAX = 256;
+		/// Length of a model day (model milliseconds)
+		static constexpr uint32_t DAY_MS = 86400000;
+		/// Default speed ratio (one model hour per real minute)
+		static constexpr uint16_t RATIO_DEFAULT = 60;
+		/// Highest speed ratio (one model hour per real second)
+		static constexpr uint16_t RATIO_MAX = 3600;
+		/// Longest LED spread of a group event (model minutes)
+		static constexpr uint8_t JITTER_MAX = 240;
+
+		/**
+		 * @brief Scene recall or group change at a model time of day
+		 */
+		struct Event {
+			uint16_t minute;                ///< Model time of day (minutes, 0-1439)
+			uint8_t jitter;                 ///< Random delay of each group LED (model minutes, 0 = together)
+			bool scene;                     ///< Recall a scene instead of changing a group
+			uint8_t scene_index;            ///< Scene to recall
+			GroupManager::Action action;    ///< Group change, its transition also applies to scenes
+		};
+
+		/**
+		 * @brief Settings of the model clock
+		 */
+		struct Clock {
+			uint32_t time_ms;       ///< Model time of day (model milliseconds)
+			uint16_t ratio;         ///< Model time per real time (1 to RATIO_MAX)
+			bool running;           ///< The clock advances
+		};
+
+		/**
+		 * @brief Schedule counters
+		 */
+		struct Stats {
+			uint32_t fired;         ///< Firings executed since boot
+			uint16_t firings;       ///< Firings of the current model day
+			uint16_t dropped;       ///< Jittered LEDs left out of the current day (list full)
+			uint32_t last_us;       ///< Duration of the last frame that fired (microseconds)
+			uint32_t max_us;        ///< Longest frame that fired (microseconds)
+		};
+
+		// === Constructor ===
+
+		/**
+		 * @brief Constructor, clock stopped at midnight and no events
+		 */
+		ScheduleManager();
+
+		// === Model Clock ===
+
+		/**
+		 * @brief Get the model time of day
+		 *
+		 * @return Model time (model milliseconds, below DAY_MS)
+		 */
+		uint32_t getTime() const;
+
+		/**
+		 * @brief Get the clock settings, with the current model time
+		 *
+		 * @return Clock settings
+		 */
+		Clock getClock() const;
+
+		/**
+		 * @brief Set the model clock at once
+		 *
+		 * For setup(), before the main loop runs. Events between the old
+		 * and new time are skipped.
+		 *
+		 * @param clock Clock settings
+		 * @return false if a setting is out of range
+		 */
+		bool setClock(const Clock& clock);
+
+		/**
+		 * @brief Queue new clock settings
+		 *
+		 * @param clock Clock settings
+		 * @return false if a setting is out of range or a request is pending
+		 */
+		bool requestClock(const Clock& clock);
+
+		// === Schedule ===
+
+		/**
+		 * @brief Replace the schedule events at once
+		 *
+		 * For setup(), after the groups and scenes are loaded.
+		 *
+		 * @param events Events, in any order
+		 * @param count Number of events
+		 * @return false if there are too many events or one is out of range
+		 */
+		bool setEvents(const Event* events, uint8_t count);
+
+		/**
+		 * @brief Queue new schedule events
+		 *
+		 * @param events Events, in any order
+		 * @param count Number of events
+		 * @return false if the events are invalid or a request is pending
+		 */
+		bool requestEvents(const Event* events, uint8_t count);
+
+		/**
+		 * @brief Draw new firings after a group changed
+		 *
+		 * Jittered events have one firing per member, drawn when the firings
+		 * are built: new members would get none until model midnight. Main
+		 * loop only, like setEvents().
+		 *
+		 * @param group Group index
+		 */
+		void refreshGroup(uint8_t group);
+
+		/**
+		 * @brief Get the schedule events
+		 *
+		 * @param count Set to the number of events
+		 * @return Events
+		 */
+		const Event* getEvents(uint8_t& count) const { count = event_count_; return events_; }
+
+		/**
+		 * @brief Get the model time of the next firing
+		 *
+		 * @param time_ms Set to the model time of day (model milliseconds)
+		 * @return false if nothing fires before model midnight
+		 */
+		bool getNextTime(uint32_t& time_ms) const;
+
+		/**
+		 * @brief Check if a request is waiting for handle()
+		 *
+		 * @return true if pending
+		 */
+		bool isPending() const { return pending_ != PendingType::NONE; }
+
+		/**
+		 * @brief Apply the pending request and execute the due firings
+		 *
+		 * Called from the main loop right before GroupManager::handle(), so
+		 * that the changes of an event are part of the same frame.
+		 */
+		void handle();
+
+		/**
+		 * @brief Get the schedule counters
+		 *
+		 * @return Statistics
+		 */
+		const Stats& getStats() const { return stats_; }
+
+		// === Time Formatting ===
+
+		/**
+		 * @brief Parse a model time of day
+		 *
+		 * @param text "HH:MM" or "HH:MM:SS"
+		 * @param time_ms Set to the model time (model milliseconds)
+		 * @return false if the text is not a valid time of day
+		 */
+		static bool parseTime(const char* text, uint32_t& time_ms);
+
+		/**
+		 * @brief Format a model time of day as "HH:MM:SS"
+		 *
+		 * @param time_ms Model time (model milliseconds)
+		 * @param buffer Output buffer
+		 * @param size Buffer size (9 bytes or more)
+		 */
+		static void formatTime(uint32_t time_ms, char* buffer, size_t size);
+
+	private:
+		/**
+		 * @brief Type of the pending request
+		 */
+		enum class PendingType : uint8_t {
+			NONE,
+			CLOCK,
+			EVENTS
+		};
+
+		/**
+		 * @brief One execution of an event on a model day
+		 */
+		struct Firing {
+			uint32_t time;          ///< Model time of day (model milliseconds)
+			uint8_t event;          ///< Event index
+			uint8_t module;         ///< Module of the LED (jittered events)
+			uint8_t led;            ///< LED within the module, WHOLE_EVENT for the whole event
+		};
+
+		/// Firing executing a whole event
+		static constexpr uint8_t WHOLE_EVENT = 0xFF;
+
+		/**
+		 * @brief Transition shared by the firings of an event
+		 */
+		struct EventTransition {
+			uint8_t slot;           ///< Transition slot (0 = none)
+			uint16_t serial;        ///< Serial of the transition when it was started
+		};
+
+		uint32_t anchor_time_;                      ///< Model time at anchor_millis_
+		unsigned long anchor_millis_;               ///< millis() of the last clock change
+		uint16_t ratio_;                            ///< Model time per real time
+		bool running_;                              ///< The clock advances
+		uint32_t last_time_;                        ///< Model time of the previous handle()
+
+		Event events_[EVENT_MAX];                   ///< Schedule events
+		uint8_t event_count_;                       ///< Number of events
+		Firing firings_[FIRING_MAX];                ///< Firings of the model day, sorted by time
+		uint16_t firing_count_;                     ///< Number of firings
+		uint16_t next_;                             ///< First firing not executed yet
+		EventTransition transitions_[EVENT_MAX];    ///< Running transition of each event, joined by its later batches
+
+		Clock pending_clock_;                       ///< Clock queued by requestClock()
+		Event pending_events_[EVENT_MAX];           ///< Events queued by requestEvents()
+		uint8_t pending_count_;                     ///< Number of queued events
+		volatile PendingType pending_;              ///< Type of the queued request
+		Stats stats_;                               ///< Schedule counters
+
+		/**
+		 * @brief Check the settings of an event
+		 *
+		 * @param event Event
+		 * @return true if valid
+		 */
+		static bool isValidEvent(const Event& event);
+
+		/**
+		 * @brief Expand the events into the sorted firings of a model day
+		 *
+		 * Draws new random delays for the jittered events and points to the
+		 * first firing after the current model time.
+		 */
+		void buildFirings();
+
+		/**
+		 * @brief Point to the first firing after a model time
+		 *
+		 * @param time_ms Model time (model milliseconds)
+		 */
+		void seek(uint32_t time_ms);
+
+		/**
+		 * @brief Execute the firings before a model time
+		 *
+		 * Consecutive firings of the same jittered event are merged into
+		 * one group change. The batches of an event share one transition.
+		 *
+		 * @param limit Model time (model milliseconds, excluded)
+		 * @return Number of firings executed
+		 */
+		uint16_t fireUntil(uint32_t limit);
+
+		/**
+		 * @brief Execute an event
+		 *
+		 * @param index Event index
+		 * @param masks LEDs to change per module, nullptr for the whole group
+		 */
+		void execute(uint8_t index, const uint16_t* masks);
+};
+
+// Global instance
+/**
+ * @brief Global ScheduleManager instance
+ *
+ * Created in setup() after the LED groups and scenes are loaded.
+ */
+extern std::unique_ptr<ScheduleManager> schedule_manager;
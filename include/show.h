@@ -0,0 +1,337 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Jérôme SONRIER
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * This file is part of emfao-light_control.
+ *
+ * emfao-light_control is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * emfao-light_control is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with emfao-light_control.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @file  show.h
+ * @brief Scripted light shows streamed from LittleFS
+ *
+ * A show is a timeline of events compiled on the host by
+ * tools/show_compiler.py and uploaded to /shows on LittleFS. Each event
+ * sets, fades, stops or starts a program on any set of channels at a time
+ * relative to the start of the show, so that a show can follow a
+ * soundtrack.
+ *
+ * File format (little endian):
+ * - Header (16 bytes): "EMSH", version (1), flags, reserved (2 bytes),
+ *   event count (4 bytes), duration in milliseconds (4 bytes)
+ * - Events sorted by time, each a 12 byte record followed by its channels:
+ *   time in milliseconds (4 bytes), transition in milliseconds (2 bytes),
+ *   value (2 bytes), action, easing, channel count, reserved, then per
+ *   channel entry a module index (1 byte) and an LED mask (2 bytes)
+ *
+ * The file is never loaded whole: a reader task on the other core keeps
+ * two small buffers filled while the main loop consumes the events due in
+ * each frame, so shows larger than RAM play with frame accurate timing.
+ *
+ * @author  Jérôme SONRIER <jsid@emor3j.fr.eu.org>
+ * @date    2025-10-17
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <memory>
+
+
+/**
+ * @enum ShowAction
+ * @brief Change applied by a show event
+ */
+enum ShowAction : uint8_t {
+	SHOW_SET = 0,           ///< Steady brightness (value), program stopped
+	SHOW_PROGRAM = 1,       ///< Start a program (value = ProgramType)
+	SHOW_OFF = 2            ///< Disable the LEDs
+};
+
+/**
+ * @class ShowPlayer
+ * @brief Streaming player of the shows stored on LittleFS
+ */
+class ShowPlayer {
+	public:
+		/// Size of each of the two read buffers
+		static constexpr size_t BUFFER_SIZE = 512;
+		/// Size of the file header
+		static constexpr size_t HEADER_SIZE = 16;
+		/// Size of an event record, without its channel entries
+		static constexpr size_t RECORD_SIZE = 12;
+		/// Size of a channel entry
+		static constexpr size_t CHANNEL_SIZE = 3;
+		/// File format version
+		static constexpr uint8_t VERSION = 1;
+		/// Longest show name
+		static constexpr uint8_t NAME_MAX = 31;
+		/// Delay after which an event counts as late (one frame)
+		static constexpr uint32_t LATE_MS = 20;
+		/// Directory containing the shows
+		static const char* DIRECTORY;
+		/// Extension of the show files
+		static const char* EXTENSION;
+
+		/**
+		 * @brief State of the playback
+		 */
+		struct Status {
+			bool playing;                   ///< A show is playing
+			bool loop;                      ///< The show restarts at its end
+			char name[NAME_MAX + 1];        ///< Name of the show
+			uint32_t position_ms;           ///< Position in the current pass
+			uint32_t duration_ms;           ///< Length of one pass
+			uint32_t event_count;           ///< Events per pass
+			uint32_t events_played;         ///< Events applied since the start
+			uint32_t passes;                ///< Completed passes (loop)
+		};
+
+		/**
+		 * @brief Playback counters, reset when a show starts
+		 */
+		struct Stats {
+			uint32_t underruns;             ///< Frames waiting for the reader task
+			uint32_t refills;               ///< Buffers read from the file
+			uint32_t late_events;           ///< Events applied more than LATE_MS late
+			uint32_t max_late_ms;           ///< Latest event
+			uint32_t errors;                ///< Invalid events skipped
+		};
+
+		// === Constructor ===
+
+		/**
+		 * @brief Constructor, no show playing
+		 */
+		ShowPlayer();
+
+		/**
+		 * @brief Destructor, stops the show
+		 */
+		~ShowPlayer();
+
+		// === Playback (main loop only) ===
+
+		/**
+		 * @brief Start a show at once
+		 *
+		 * Opens the file, checks its header, fills both buffers and starts
+		 * the reader task. The events before the start position are applied
+		 * without transition so that the layout matches the timeline.
+		 *
+		 * @param name Show name (file name without directory and extension)
+		 * @param loop Restart the show at its end
+		 * @param start_ms Start position (milliseconds into the show)
+		 * @return false if the file is missing or invalid
+		 */
+		bool play(const char* name, bool loop, uint32_t start_ms);
+
+		/**
+		 * @brief Stop the show, the LEDs keep their state
+		 */
+		void stop();
+
+		// === Requests ===
+
+		/**
+		 * @brief Queue the start of a show
+		 *
+		 * @param name Show name
+		 * @param loop Restart the show at its end
+		 * @param start_ms Start position (milliseconds into the show)
+		 * @return false if the name is invalid or a request is pending
+		 */
+		bool requestPlay(const char* name, bool loop, uint32_t start_ms);
+
+		/**
+		 * @brief Queue the stop of the show
+		 *
+		 * @return false if a request is pending
+		 */
+		bool requestStop();
+
+		/**
+		 * @brief Apply the pending request and the events due
+		 *
+		 * Called from the main loop right before GroupManager::handle(), so
+		 * that the changes of an event are part of the same frame.
+		 */
+		void handle();
+
+		// === Status ===
+
+		/**
+		 * @brief Check if a show is playing
+		 *
+		 * @return true if playing
+		 */
+		bool isPlaying() const { return playing_; }
+
+		/**
+		 * @brief Check if a show is playing from a file
+		 *
+		 * @param name Show name
+		 * @return true if this show is playing
+		 */
+		bool isPlaying(const char* name) const { return playing_ && strcmp(name_, name) == 0; }
+
+		/**
+		 * @brief Get the state of the playback
+		 *
+		 * @return Status
+		 */
+		Status getStatus() const;
+
+		/**
+		 * @brief Get the playback counters
+		 *
+		 * @return Statistics
+		 */
+		const Stats& getStats() const { return stats_; }
+
+		// === Files ===
+
+		/**
+		 * @brief Check a show name
+		 *
+		 * @param name Show name
+		 * @return true if 1 to NAME_MAX letters, digits, '-' or '_'
+		 */
+		static bool isValidName(const char* name);
+
+		/**
+		 * @brief Build the path of a show file
+		 *
+		 * @param name Show name
+		 * @param buffer Output buffer
+		 * @param size Buffer size
+		 */
+		static void makePath(const char* name, char* buffer, size_t size);
+
+		/**
+		 * @brief Check the header of a show file
+		 *
+		 * @param header First HEADER_SIZE bytes of the file
+		 * @param event_count Set to the number of events
+		 * @param duration_ms Set to the duration
+		 * @return true if the header is valid
+		 */
+		static bool parseHeader(const uint8_t* header, uint32_t& event_count, uint32_t& duration_ms);
+
+	private:
+		/**
+		 * @brief Type of the pending request
+		 */
+		enum class PendingType : uint8_t {
+			NONE,
+			PLAY,
+			STOP
+		};
+
+		/**
+		 * @brief Result of reading the next event
+		 */
+		enum class ReadResult : uint8_t {
+			READY,          ///< The whole event is buffered
+			WAIT,           ///< The reader task has not filled the next buffer yet
+			END             ///< The file ends before the event
+		};
+
+		File file_;                                 ///< Show file, read by the task
+		std::unique_ptr<uint8_t[]> buffers_;        ///< Two read buffers
+		volatile size_t fill_[2];                   ///< Bytes in each buffer
+		volatile bool ready_[2];                    ///< Buffer filled, owned by the main loop
+		volatile bool eof_;                         ///< The task reached the end of the file
+		uint8_t front_;                             ///< Buffer being consumed
+		size_t position_;                           ///< Read position in the front buffer
+		uint8_t next_fill_;                         ///< Next buffer the task fills
+		TaskHandle_t task_;                         ///< Reader task, nullptr when stopped
+		volatile bool stop_requested_;              ///< Asks the reader task to stop
+
+		bool playing_;                              ///< A show is playing
+		bool loop_;                                 ///< The show restarts at its end
+		char name_[NAME_MAX + 1];                   ///< Name of the show
+		uint32_t event_count_;                      ///< Events per pass
+		uint32_t duration_ms_;                      ///< Length of one pass
+		unsigned long start_millis_;                ///< millis() at position 0 of the first pass
+		uint32_t start_ms_;                         ///< Start position, earlier events are caught up
+		uint32_t pass_start_ms_;                    ///< Show time at the start of the current pass
+		uint32_t consumed_;                         ///< Events read in the current pass
+		uint32_t played_;                           ///< Events applied since the start
+		uint32_t passes_;                           ///< Completed passes
+
+		char pending_name_[NAME_MAX + 1];           ///< Show queued by requestPlay()
+		bool pending_loop_;                         ///< Loop of the queued show
+		uint32_t pending_start_ms_;                 ///< Start position of the queued show
+		volatile PendingType pending_;              ///< Type of the queued request
+		Stats stats_;                               ///< Playback counters
+
+		/**
+		 * @brief Copy buffered bytes without consuming them
+		 *
+		 * @param out Destination
+		 * @param length Number of bytes
+		 * @return READY, or why the bytes are not available
+		 */
+		ReadResult peek(uint8_t* out, size_t length);
+
+		/**
+		 * @brief Consume buffered bytes, handing emptied buffers to the task
+		 *
+		 * @param length Number of bytes, as checked by peek()
+		 */
+		void consume(size_t length);
+
+		/**
+		 * @brief Apply one event
+		 *
+		 * @param record Event record followed by its channel entries
+		 * @param transition Apply the transition of the event
+		 */
+		void execute(const uint8_t* record, bool transition);
+
+		/**
+		 * @brief Fill a buffer from the file, wrapping to the first event when looping
+		 *
+		 * @param index Buffer index
+		 */
+		void fillBuffer(uint8_t index);
+
+		/**
+		 * @brief Stop the reader task and close the file
+		 */
+		void stopReader();
+
+		/**
+		 * @brief Reader task entry point
+		 *
+		 * @param param ShowPlayer instance
+		 */
+		static void taskEntry(void* param);
+
+		/**
+		 * @brief Reader task body, fills the buffers emptied by the main loop
+		 */
+		void taskLoop();
+};
+
+// Global instance
+/**
+ * @brief Global ShowPlayer instance
+ *
+ * Created in setup() after the LED groups.
+ */
+extern std::unique_ptr<ShowPlayer> show_player;
@@ -41,6 +41,12 @@
 #include <Preferences.h>
 #include <ArduinoJson.h>
 #include <memory>
+#include <vector>
+
+#include "effect.h"
+#include "schedule.h"
+#include "input.h"
+#include "layer.h"
 
 
 /**
@@ -76,6 +82,16 @@ class StorageManager {
 		static const char* NAMESPACE_MODULES;
 		/// Namespace for individual LED configurations
 		static const char* NAMESPACE_LEDS;
+		/// Namespace for user effect programs
+		static const char* NAMESPACE_EFFECTS;
+		/// Namespace for LED groups and scenes
+		static const char* NAMESPACE_GROUPS;
+		/// Namespace for the model clock and schedules
+		static const char* NAMESPACE_SCHEDULE;
+		/// Namespace for the layout inputs and triggers
+		static const char* NAMESPACE_INPUTS;
+		/// Namespace for the layer stacks and master levels
+		static const char* NAMESPACE_LAYERS;
 		
 		/// @}
 		
@@ -220,6 +236,35 @@ class StorageManager {
 		 *         or load failed
 		 */
 		static bool load_module_config(uint8_t module_index);
+
+		/**
+		 * @brief Save the module map (bus and address of each module ID)
+		 * 
+		 * The map lets each module keep its ID, and so its saved module and
+		 * LED configuration, across reboots and hardware changes.
+		 * 
+		 * @return true if the map saved successfully
+		 */
+		static bool save_module_map();
+
+		/**
+		 * @brief Load the module map
+		 * 
+		 * @param entries Filled with one entry per module ID: bus in bit 7,
+		 *                I2C address in bits 0-6 (0 = free ID)
+		 * @return true if a saved map was found
+		 */
+		static bool load_module_map(std::vector<uint8_t>& entries);
+
+		/**
+		 * @brief Remove the saved module and LED configuration of a module ID
+		 * 
+		 * Used when a module is forgotten, so that a new module taking the
+		 * ID starts from defaults.
+		 * 
+		 * @param module_index Module ID (0-based)
+		 */
+		static void clear_module_config(uint8_t module_index);
 		
 		// === LED Configuration Management ===
 		
@@ -292,6 +337,201 @@ class StorageManager {
 		 * @return true if credentials cleared successfully
 		 */
 		static bool clear_wifi_credentials();
+
+		// === I2C Configuration Management ===
+
+		/**
+		 * @brief Save I2C bus settings of the global configuration
+		 * 
+		 * Saves the highest I2C clock tried at bring-up and the second bus pins.
+		 * 
+		 * @return true if settings saved successfully
+		 */
+		static bool save_i2c_config();
+
+		/**
+		 * @brief Load I2C bus settings into the global configuration
+		 * 
+		 * Must be called before the module manager is initialized. Invalid
+		 * or missing values keep the current configuration.
+		 * 
+		 * @return true if saved settings were found and applied
+		 */
+		static bool load_i2c_config();
+
+		// === Curve Configuration Management ===
+
+		/**
+		 * @brief Save the global transfer curve and the custom curve points
+		 * 
+		 * @return true if settings saved successfully
+		 */
+		static bool save_curve_config();
+
+		/**
+		 * @brief Load the global transfer curve and the custom curve points
+		 * 
+		 * Must be called before LED configurations are loaded. Invalid or
+		 * missing values keep the current configuration.
+		 * 
+		 * @return true if saved settings were found and applied
+		 */
+		static bool load_curve_config();
+
+		// === Power Configuration Management ===
+
+		/**
+		 * @brief Save the LED power budget and its scaling mode
+		 * 
+		 * @return true if settings saved successfully
+		 */
+		static bool save_power_config();
+
+		/**
+		 * @brief Load the LED power budget and its scaling mode
+		 * 
+		 * Invalid or missing values keep the current configuration.
+		 * 
+		 * @return true if saved settings were found and applied
+		 */
+		static bool load_power_config();
+
+		// === Effect Management ===
+
+		/**
+		 * @brief Save a user effect slot
+		 * 
+		 * The effect is stored as its bytecode, recompiled when loaded. An
+		 * empty effect removes the slot.
+		 * 
+		 * @param slot Effect slot (0 to ProgramManager::EFFECT_SLOTS - 1)
+		 * @param effect Compiled effect
+		 * @return true if the slot was saved successfully
+		 */
+		static bool save_effect(uint8_t slot, const EffectVM::Program& effect);
+
+		/**
+		 * @brief Load every saved user effect into the program manager
+		 * 
+		 * Must be called before LED configurations are loaded. Effects that
+		 * no longer compile are skipped.
+		 * 
+		 * @return Number of effects loaded
+		 */
+		static uint8_t load_effects();
+
+		// === Group and Scene Management ===
+
+		/**
+		 * @brief Save an LED group slot from the group manager
+		 * 
+		 * A free slot removes the saved group.
+		 * 
+		 * @param index Group slot (0 to GroupManager::GROUP_MAX - 1)
+		 * @return true if the slot was saved successfully
+		 */
+		static bool save_group(uint8_t index);
+
+		/**
+		 * @brief Save a scene slot from the group manager
+		 * 
+		 * A free slot removes the saved scene.
+		 * 
+		 * @param index Scene slot (0 to GroupManager::SCENE_MAX - 1)
+		 * @return true if the slot was saved successfully
+		 */
+		static bool save_scene(uint8_t index);
+
+		/**
+		 * @brief Load every saved group and scene into the group manager
+		 * 
+		 * @return Number of groups and scenes loaded
+		 */
+		static uint8_t load_groups();
+
+		// === Model Clock and Schedule Management ===
+
+		/**
+		 * @brief Save the model clock settings
+		 * 
+		 * The model clock starts again from the saved time at boot.
+		 * 
+		 * @param clock Clock settings
+		 * @return true if the settings were saved successfully
+		 */
+		static bool save_model_clock(const ScheduleManager::Clock& clock);
+
+		/**
+		 * @brief Save the schedule events
+		 * 
+		 * @param events Events
+		 * @param count Number of events (0 removes the saved schedule)
+		 * @return true if the events were saved successfully
+		 */
+		static bool save_schedule(const ScheduleManager::Event* events, uint8_t count);
+
+		/**
+		 * @brief Load the model clock and the schedule into the schedule manager
+		 * 
+		 * Must be called after the groups and scenes are loaded, jittered
+		 * events are expanded over the group members.
+		 * 
+		 * @return Number of events loaded
+		 */
+		static uint8_t load_schedule();
+
+		// === Input Management ===
+
+		/**
+		 * @brief Save the input wiring and trigger table
+		 * 
+		 * @param wiring Wiring
+		 * @return true if the wiring was saved successfully
+		 */
+		static bool save_inputs(const InputManager::Wiring& wiring);
+
+		/**
+		 * @brief Load the input wiring into the input manager
+		 * 
+		 * Must be called after the groups and scenes are loaded.
+		 * 
+		 * @return true if a valid wiring was loaded
+		 */
+		static bool load_inputs();
+
+		/**
+		 * @brief Save the layer stacks and the master levels at boot
+		 * 
+		 * @param setup Layer stacks and master levels
+		 * @return true if the setup was saved successfully
+		 */
+		static bool save_layers(const LayerStack::Setup& setup);
+
+		/**
+		 * @brief Load the layer stacks into the layer stack manager
+		 * 
+		 * Must be called after the modules and programs are initialized.
+		 * 
+		 * @return true if a valid setup was loaded
+		 */
+		static bool load_layers();
+
+		// === Log Configuration Management ===
+
+		/**
+		 * @brief Save whether logs are written to the LittleFS log file
+		 * 
+		 * @param enabled true to start the file log sink at boot
+		 * @return true if the setting was saved successfully
+		 */
+		static bool save_log_file_enabled(bool enabled);
+
+		/**
+		 * @brief Load whether logs are written to the LittleFS log file
+		 * 
+		 * @return true if the file log sink must be started (false if unset)
+		 */
+		static bool load_log_file_enabled();
 };
 
 /**
@@ -48,6 +48,10 @@
 #include <ESPAsyncWebServer.h>
 #include <AsyncTCP.h>
 #include <ArduinoJson.h>
+#include <LittleFS.h>
+#include <vector>
+
+#include "log.h"
 
 /**
  * @class WebServer
@@ -77,6 +81,26 @@ class WebServer {
 		uint16_t port_;			///< TCP port number for HTTP server
 		bool server_running_;		///< Flag indicating if server is currently running
 		bool initialized_;		///< Flag indicating if server has been initialized
+		
+		AsyncEventSource log_events_;			///< Server-Sent Events source for live logs
+		uint32_t log_stream_cursor_;			///< Sequence of the last log entry pushed to stream clients
+		unsigned long last_log_push_;			///< Timestamp of the last log stream push (millis)
+		std::vector<LogEntry> log_stream_batch_;	///< Reused batch of new entries for the stream
+
+		File show_upload_;				///< Show file being uploaded (temporary path)
+		String show_upload_name_;			///< Name of the show being uploaded
+		String show_upload_error_;			///< Error of the current show upload, empty if none
+
+		/// Minimum interval between two log stream pushes (milliseconds)
+		static constexpr unsigned long LOG_STREAM_INTERVAL_MS = 100;
+		/// Maximum entries pushed per stream update
+		static constexpr size_t LOG_STREAM_BATCH_MAX = 20;
+		/// Maximum entries replayed to a (re)connecting stream client
+		static constexpr size_t LOG_STREAM_REPLAY_MAX = 50;
+		/// Default number of timed frames per driver for the I2C bench
+		static constexpr uint16_t I2C_BENCH_ROUNDS_DEFAULT = 20;
+		/// Maximum number of timed frames per driver for the I2C bench
+		static constexpr uint16_t I2C_BENCH_ROUNDS_MAX = 200;
 
 	public:
 		// === Constructor and Destructor ===
@@ -160,6 +184,15 @@ class WebServer {
 		 */
 		uint16_t getPort() const { return port_; }
 		
+		/**
+		 * @brief Periodic processing, to be called from loop()
+		 * 
+		 * Pushes log entries created since the last call to the connected
+		 * log stream clients. Only new entries are copied, and nothing is
+		 * done while no client is connected.
+		 */
+		void handle();
+		
 	private:
 		// === Server Setup Methods ===
 		
@@ -234,6 +267,68 @@ class WebServer {
 		 * @param request AsyncWebServerRequest object containing HTTP request details
 		 */
 		void handleGetModules(AsyncWebServerRequest *request);
+
+		/**
+		 * @brief Handle requests to forget a missing module
+		 * 
+		 * Endpoint: DELETE /api/modules?module=2
+		 * 
+		 * Frees the module ID and removes its saved configuration. Only
+		 * a missing module can be forgotten; the main loop applies it.
+		 * 
+		 * @param request AsyncWebServerRequest object containing HTTP request details
+		 */
+		void handleForgetModule(AsyncWebServerRequest *request);
+
+		/**
+		 * @brief Handle module PWM configuration requests
+		 * 
+		 * Endpoint: POST /api/modules/pwm
+		 * Content-Type: application/json
+		 * 
+		 * Body: {"module": 0, "frequency": 200, "oscillator_hz": 25000000,
+		 * "camera_mode": false}, every field but "module" optional. Settings
+		 * are saved and only the prescaler of that module is restarted,
+		 * from the main loop. Camera mode forces the maximum frequency
+		 * regardless of "frequency"; "frequency_forced" in the response
+		 * tells whether it overrides the configured one.
+		 * 
+		 * @param request AsyncWebServerRequest object containing HTTP request details
+		 * @param data Pointer to JSON request body data
+		 * @param len Length of the request body data
+		 * @param index Current chunk index for large uploads
+		 * @param total Total size of the request body
+		 */
+		void handleUpdateModulePwm(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total);
+
+		/**
+		 * @brief Handle oscillator calibration requests
+		 * 
+		 * Endpoint: POST /api/modules/calibrate
+		 * Content-Type: application/json
+		 * 
+		 * Body: {"module": 0, "led": 15, "pin": 34}, the channel output
+		 * being wired to the GPIO. Runs from the main loop; the result is
+		 * reported by GET /api/modules/calibrate.
+		 * 
+		 * @param request AsyncWebServerRequest object containing HTTP request details
+		 * @param data Pointer to JSON request body data
+		 * @param len Length of the request body data
+		 * @param index Current chunk index for large uploads
+		 * @param total Total size of the request body
+		 */
+		void handleModuleCalibrate(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total);
+
+		/**
+		 * @brief Handle oscillator calibration result requests
+		 * 
+		 * Endpoint: GET /api/modules/calibrate
+		 * 
+		 * Returns the pending or last calibration.
+		 * 
+		 * @param request AsyncWebServerRequest object containing HTTP request details
+		 */
+		void handleGetModuleCalibration(AsyncWebServerRequest *request);
 		
 		/**
 		 * @brief Handle LED status information requests
@@ -254,7 +349,20 @@ class WebServer {
 		 * Content-Type: application/json
 		 * 
 		 * Updates LED configuration including brightness, enable state,
-		 * and program assignments through a unified interface.
+		 * transfer curve ("curve": name), temporal dithering ("dither"),
+		 * power budget rating ("rated_ma", 0 for the module rating) and
+		 * priority ("priority", 0-3) and program assignments through a
+		 * unified interface. "effect_slot" runs a user effect; "params"
+		 * ({"intensity", "speed", "probability" in percent, "min", "max"
+		 * levels}) tunes the assigned program, missing keys are kept.
+		 * "phase_group" (1-8, 0 to leave) and "phase_offset" (degrees)
+		 * run the program on the timebase shared by the group.
+		 * "transition_ms" and "easing" ("linear", "in", "out", "in_out")
+		 * crossfade from the current output to the result of the changes.
+		 * Invalid values are rejected with 400 before anything changes.
+		 * The update is applied by the main loop right before the next
+		 * frame (409 while another one is pending); GET /api/leds reports
+		 * the result.
 		 * 
 		 * @param request AsyncWebServerRequest object containing HTTP request details
 		 * @param data Pointer to JSON request body data
@@ -263,111 +371,132 @@ class WebServer {
 		 * @param total Total size of the request body
 		 */
 		void handleUpdateLed(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total);
-		
-		// === Program Management API Handlers ===
-		
+
 		/**
-		 * @brief Handle program information requests
+		 * @brief Handle I2C bus status requests
 		 * 
-		 * Endpoint: GET /api/programs
+		 * Endpoint: GET /api/i2c
 		 * 
-		 * Returns information about available programs and current
-		 * program assignments across all LEDs.
+		 * Returns the configured maximum clock and, for each bus, its pins,
+		 * module count, the clock selected at bring-up, frame output
+		 * statistics and, for each speed, whether it passed the register
+		 * check and the measured full frame flush time.
 		 * 
 		 * @param request AsyncWebServerRequest object containing HTTP request details
 		 */
-		void handleGetPrograms(AsyncWebServerRequest *request);
-		
-		// === OTA (Over-The-Air) Update API Handlers ===
-		
+		void handleGetI2c(AsyncWebServerRequest *request);
+
 		/**
-		 * @brief Handle OTA system status requests
+		 * @brief Handle I2C bus configuration requests
 		 * 
-		 * Endpoint: GET /api/ota/status
+		 * Endpoint: POST /api/i2c
+		 * Content-Type: application/json
 		 * 
-		 * Provides detailed OTA system status including readiness
-		 * checks and current operation state.
+		 * Body: {"clock_hz": 400000, "bus1_sda_pin": 25, "bus1_scl_pin": 26,
+		 * "phase_stagger": true, "linked_frames": false}. Settings are saved. A new clock is
+		 * renegotiated and phase offsets are reallocated from the main loop;
+		 * second bus pins ({"bus1_enabled": false} to disable) are applied at
+		 * next boot.
 		 * 
 		 * @param request AsyncWebServerRequest object containing HTTP request details
+		 * @param data Pointer to JSON request body data
+		 * @param len Length of the request body data
+		 * @param index Current chunk index for large uploads
+		 * @param total Total size of the request body
 		 */
-		void handleOtaStatus(AsyncWebServerRequest *request);
-		
+		void handleUpdateI2c(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total);
+
 		/**
-		 * @brief Handle OTA firmware upload requests
+		 * @brief Handle PCA9685 driver benchmark requests
 		 * 
-		 * Endpoint: POST /api/ota/upload
-		 * Content-Type: application/octet-stream
+		 * Endpoint: POST /api/i2c/bench
+		 * Content-Type: application/json
 		 * 
-		 * Processes firmware uploads with validation, progress monitoring,
-		 * and automatic system restart on successful completion.
+		 * Body (optional): {"rounds": 20}. Full frame flushes are timed with
+		 * the native and Adafruit drivers on each bus from the main loop;
+		 * results are reported in the "bench" object of GET /api/i2c.
 		 * 
 		 * @param request AsyncWebServerRequest object containing HTTP request details
-		 * @param filename Name of the uploaded firmware file
-		 * @param index Current chunk offset in bytes
-		 * @param data Pointer to chunk data buffer
-		 * @param len Length of current chunk
-		 * @param final True if this is the last chunk of the upload
-		 * 
-		 * @warning System automatically restarts after successful update
+		 * @param data Pointer to JSON request body data
+		 * @param len Length of the request body data
+		 * @param index Current chunk index for large uploads
+		 * @param total Total size of the request body
 		 */
-		void handleOtaUpload(AsyncWebServerRequest *request, String filename, size_t index, uint8_t *data, size_t len, bool final);
+		void handleI2cBench(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total);
 
 		/**
-		 * @brief Handle system logs requests
+		 * @brief Handle broadcast group status requests
 		 * 
-		 * Endpoint: GET /api/logs
-		 * Query parameters:
-		 * - count: number of recent entries to return (optional)
-		 * - since: timestamp to get logs since (optional)
+		 * Endpoint: GET /api/broadcast
 		 * 
-		 * Returns JSON array of log entries with timestamps and messages.
+		 * Returns the "All Call" address, each broadcast group address with
+		 * its member modules, and the modules whose outputs are currently
+		 * set by a broadcast.
 		 * 
 		 * @param request AsyncWebServerRequest object containing HTTP request details
 		 */
-		void handleGetLogs(AsyncWebServerRequest *request);
+		void handleGetBroadcast(AsyncWebServerRequest *request);
 
 		/**
-		 * @brief Handle log clearing requests
+		 * @brief Handle broadcast operation requests
 		 * 
-		 * Endpoint: DELETE /api/logs
+		 * Endpoint: POST /api/broadcast
+		 * Content-Type: application/json
 		 * 
-		 * Clears all stored log entries from the buffer.
+		 * Body: {"action": "off"|"on"|"level"|"release"|"sync", "group": 0,
+		 * "level": 2048}. Group 0 targets every module. "off", "on" and
+		 * "level" hold the outputs until "release"; "sync" restarts the PWM
+		 * counters together. Executed from the main loop.
 		 * 
 		 * @param request AsyncWebServerRequest object containing HTTP request details
+		 * @param data Pointer to JSON request body data
+		 * @param len Length of the request body data
+		 * @param index Current chunk index for large uploads
+		 * @param total Total size of the request body
 		 */
-		void handleClearLogs(AsyncWebServerRequest *request);
-
-		// === Configuration handlers ===
+		void handleBroadcastAction(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total);
 
 		/**
-		 * @brief Handle WiFi configuration page request
+		 * @brief Handle broadcast group configuration requests
 		 * 
-		 * Endpoint: GET /config
+		 * Endpoint: POST /api/broadcast/groups
+		 * Content-Type: application/json
 		 * 
-		 * Serves the WiFi configuration page for system setup.
+		 * Body: {"group": 1, "address": 113} to change a group address,
+		 * and/or {"module": 0, "groups": [1, 2]} to set module membership.
+		 * Settings are saved and applied to the chips from the main loop.
 		 * 
 		 * @param request AsyncWebServerRequest object containing HTTP request details
+		 * @param data Pointer to JSON request body data
+		 * @param len Length of the request body data
+		 * @param index Current chunk index for large uploads
+		 * @param total Total size of the request body
 		 */
-		void handleConfigPage(AsyncWebServerRequest *request);
+		void handleUpdateBroadcastGroups(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total);
 
 		/**
-		 * @brief Handle WiFi scan request
+		 * @brief Handle brightness curve status requests
 		 * 
-		 * Endpoint: GET /api/wifi/scan
+		 * Endpoint: GET /api/curves
 		 * 
-		 * Returns list of available WiFi networks.
+		 * Returns the global default curve, the available curve names and
+		 * the control points of the custom curve.
 		 * 
 		 * @param request AsyncWebServerRequest object containing HTTP request details
 		 */
-		void handleWifiScan(AsyncWebServerRequest *request);
+		void handleGetCurves(AsyncWebServerRequest *request);
 
 		/**
-		 * @brief Handle WiFi configuration update
+		 * @brief Handle brightness curve configuration requests
 		 * 
-		 * Endpoint: POST /api/wifi/config
+		 * Endpoint: POST /api/curves
 		 * Content-Type: application/json
 		 * 
-		 * Updates WiFi configuration with new credentials.
+		 * Body: {"default": "cie"} to change the global curve, {"custom":
+		 * [0, ..., 4095]} (17 points) to define the custom curve and/or
+		 * {"module": 0, "curve": "gamma22"} to set a module curve ("default"
+		 * inherits the global one). Settings are saved and every LED is
+		 * rewritten with the new curves.
 		 * 
 		 * @param request AsyncWebServerRequest object containing HTTP request details
 		 * @param data Pointer to JSON request body data
@@ -375,104 +504,1017 @@ class WebServer {
 		 * @param index Current chunk index for large uploads
 		 * @param total Total size of the request body
 		 */
-		void handleWifiConfig(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total);
+		void handleUpdateCurves(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total);
 
 		/**
-		 * @brief Handle WiFi status request
+		 * @brief Handle power budget status requests
 		 * 
-		 * Endpoint: GET /api/wifi/status
+		 * Endpoint: GET /api/power
 		 * 
-		 * Returns current WiFi connection status and network information.
+		 * Returns the budget, the estimated current requested by the LEDs
+		 * and drawn after scaling, in total and per module, and the scale
+		 * currently applied to each priority.
 		 * 
 		 * @param request AsyncWebServerRequest object containing HTTP request details
 		 */
-		void handleWifiStatus(AsyncWebServerRequest *request);
+		void handleGetPower(AsyncWebServerRequest *request);
 
 		/**
-		 * @brief Save current configuration 
+		 * @brief Handle power budget configuration requests
 		 * 
-		 * Endpoint: GET /api/save
+		 * Endpoint: POST /api/power
+		 * Content-Type: application/json
 		 * 
-		 * Returns save operation status
+		 * Body: {"budget_ma": 5000, "mode": "fair"|"priority"} (0 for no
+		 * limit) and/or {"module": 0, "rated_ma": 20} to set the channel
+		 * rating of a module. Settings are saved and used from the next
+		 * frame.
 		 * 
 		 * @param request AsyncWebServerRequest object containing HTTP request details
+		 * @param data Pointer to JSON request body data
+		 * @param len Length of the request body data
+		 * @param index Current chunk index for large uploads
+		 * @param total Total size of the request body
 		 */
-		void handleSave(AsyncWebServerRequest *request);
+		void handleUpdatePower(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total);
 
+		// === Program Management API Handlers ===
+		
 		/**
-		 * @brief Load saved configuration 
+		 * @brief Handle program information requests
 		 * 
-		 * Endpoint: GET /api/load
+		 * Endpoint: GET /api/programs
 		 * 
-		 * Returns save operation status
+		 * Returns information about available programs and current
+		 * program assignments across all LEDs.
 		 * 
 		 * @param request AsyncWebServerRequest object containing HTTP request details
 		 */
-		void handleLoad(AsyncWebServerRequest *request);
-		
-		// === Static Lambda Wrapper Methods ===
-		// These methods provide static context for AsyncWebServer callbacks
-		
+		void handleGetPrograms(AsyncWebServerRequest *request);
+
 		/**
-		 * @brief Create lambda wrapper for health endpoint
-		 * @return Lambda function compatible with AsyncWebServer
+		 * @brief Handle user effect information requests
+		 * 
+		 * Endpoint: GET /api/effects
+		 * 
+		 * Returns every effect slot with its name, budget, bytecode (hex),
+		 * disassembly and execution counters.
+		 * 
+		 * @param request AsyncWebServerRequest object containing HTTP request details
 		 */
-		std::function<void(AsyncWebServerRequest*)> createHealthHandler();
-		
+		void handleGetEffects(AsyncWebServerRequest *request);
+
 		/**
-		 * @brief Create lambda wrapper for system info endpoint
-		 * @return Lambda function compatible with AsyncWebServer
+		 * @brief Handle user effect upload requests
+		 * 
+		 * Endpoint: POST /api/effects
+		 * Content-Type: application/json
+		 * 
+		 * Body: {"slot": 0, "name": "Beacon", "budget": 16, "code": "01 00 ff0f 0000 ..."}
+		 * The bytecode (see effect.h) is validated here; it is saved and
+		 * installed by the program manager from the next update. An empty
+		 * code clears the slot.
+		 * 
+		 * @param request AsyncWebServerRequest object containing HTTP request details
+		 * @param data Pointer to JSON request body data
+		 * @param len Length of the request body data
+		 * @param index Current chunk index for large uploads
+		 * @param total Total size of the request body
 		 */
-		std::function<void(AsyncWebServerRequest*)> createSystemHandler();
-		
+		void handleUpdateEffect(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total);
+
 		/**
-		 * @brief Create lambda wrapper for modules endpoint
-		 * @return Lambda function compatible with AsyncWebServer
+		 * @brief Handle effect benchmark result requests
+		 * 
+		 * Endpoint: GET /api/effects/bench
+		 * 
+		 * Returns the update time of the native heartbeat, breathing and
+		 * blink programs and of their bytecode equivalents. The benchmark
+		 * passes when every effect stays within EFFECT_BENCH_RATIO_MAX
+		 * times its native program.
+		 * 
+		 * @param request AsyncWebServerRequest object containing HTTP request details
 		 */
-		std::function<void(AsyncWebServerRequest*)> createModulesHandler();
-		
+		void handleGetEffectBench(AsyncWebServerRequest *request);
+
 		/**
-		 * @brief Create lambda wrapper for LEDs endpoint
-		 * @return Lambda function compatible with AsyncWebServer
+		 * @brief Handle effect benchmark requests
+		 * 
+		 * Endpoint: POST /api/effects/bench
+		 * Content-Type: application/json
+		 * 
+		 * Body (optional): {"rounds": 2000}. The benchmark runs from the
+		 * main loop on the first LED, which is restored afterwards.
+		 * 
+		 * @param request AsyncWebServerRequest object containing HTTP request details
+		 * @param data Pointer to JSON request body data
+		 * @param len Length of the request body data
+		 * @param index Current chunk index for large uploads
+		 * @param total Total size of the request body
 		 */
-		std::function<void(AsyncWebServerRequest*)> createLedsHandler();
-		
+		void handleEffectBench(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total);
+
+		// === LED Group and Scene API Handlers ===
+
 		/**
-		 * @brief Create lambda wrapper for LED update endpoint
-		 * @return Lambda function compatible with AsyncWebServer body handler
+		 * @brief Handle LED group information requests
+		 * 
+		 * Endpoint: GET /api/groups
+		 * 
+		 * Returns every group slot with its name and members as
+		 * [module, led] pairs, and the timing of the last group operation
+		 * or scene recall.
+		 * 
+		 * @param request AsyncWebServerRequest object containing HTTP request details
 		 */
-		std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> createUpdateLedHandler();
-		
+		void handleGetGroups(AsyncWebServerRequest *request);
+
 		/**
-		 * @brief Create lambda wrapper for programs endpoint
-		 * @return Lambda function compatible with AsyncWebServer
+		 * @brief Handle LED group definition requests
+		 * 
+		 * Endpoint: POST /api/groups
+		 * Content-Type: application/json
+		 * 
+		 * Body: {"index": 0, "name": "Streets", "members": [[0, 1], [2, 15]]}.
+		 * An empty or missing name removes the group. The group is applied
+		 * and saved by the main loop (409 while a group operation is
+		 * pending).
+		 * 
+		 * @param request AsyncWebServerRequest object containing HTTP request details
+		 * @param data Pointer to JSON request body data
+		 * @param len Length of the request body data
+		 * @param index Current chunk index for large uploads
+		 * @param total Total size of the request body
 		 */
-		std::function<void(AsyncWebServerRequest*)> createProgramsHandler();
-		
+		void handleUpdateGroup(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total);
+
 		/**
-		 * @brief Create lambda wrapper for OTA status endpoint
-		 * @return Lambda function compatible with AsyncWebServer
+		 * @brief Handle group-wide LED changes
+		 * 
+		 * Endpoint: POST /api/groups/apply
+		 * Content-Type: application/json
+		 * 
+		 * Body: {"group": 0} with any of "enabled", "brightness" and
+		 * "program_type", and optionally "transition_ms" and "easing". The
+		 * change is applied by the main loop to every member within a
+		 * single frame, or crossfaded over the transition.
+		 * 
+		 * @param request AsyncWebServerRequest object containing HTTP request details
+		 * @param data Pointer to JSON request body data
+		 * @param len Length of the request body data
+		 * @param index Current chunk index for large uploads
+		 * @param total Total size of the request body
 		 */
-		std::function<void(AsyncWebServerRequest*)> createOtaStatusHandler();
-		
+		void handleApplyGroup(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total);
+
 		/**
-		 * @brief Create lambda wrapper for OTA upload endpoint
-		 * @return Lambda function compatible with AsyncWebServer upload handler
+		 * @brief Handle scene information requests
+		 * 
+		 * Endpoint: GET /api/scenes
+		 * 
+		 * @param request AsyncWebServerRequest object containing HTTP request details
 		 */
-		std::function<void(AsyncWebServerRequest*, String, size_t, uint8_t*, size_t, bool)> createOtaUploadHandler();
+		void handleGetScenes(AsyncWebServerRequest *request);
 
 		/**
-		 * @brief Create lambda wrapper for logs endpoint
-		 * @return Lambda function compatible with AsyncWebServer
+		 * @brief Handle scene definition requests
+		 * 
+		 * Endpoint: POST /api/scenes
+		 * Content-Type: application/json
+		 * 
+		 * Body: {"index": 0, "name": "Night", "entries": [{"group": 0,
+		 * "enabled": true, "brightness": 2048, "program_type": 0}]}. Fields
+		 * missing from an entry are taken from the current state of the
+		 * group. An empty or missing name removes the scene.
+		 * 
+		 * @param request AsyncWebServerRequest object containing HTTP request details
+		 * @param data Pointer to JSON request body data
+		 * @param len Length of the request body data
+		 * @param index Current chunk index for large uploads
+		 * @param total Total size of the request body
 		 */
-		std::function<void(AsyncWebServerRequest*)> createLogsHandler();
+		void handleUpdateScene(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total);
 
 		/**
-		 * @brief Create lambda wrapper for clear logs endpoint
-		 * @return Lambda function compatible with AsyncWebServer
+		 * @brief Handle scene recall requests
+		 * 
+		 * Endpoint: POST /api/scenes/recall
+		 * Content-Type: application/json
+		 * 
+		 * Body: {"index": 0}, optionally "transition_ms" and "easing". The
+		 * scene is applied by the main loop within a single frame, all its
+		 * groups sharing one transition.
+		 * 
+		 * @param request AsyncWebServerRequest object containing HTTP request details
+		 * @param data Pointer to JSON request body data
+		 * @param len Length of the request body data
+		 * @param index Current chunk index for large uploads
+		 * @param total Total size of the request body
+		 */
+		void handleRecallScene(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total);
+
+		// === Model Clock and Schedule API Handlers ===
+
+		/**
+		 * @brief Handle model clock information requests
+		 * 
+		 * Endpoint: GET /api/clock
+		 * 
+		 * Returns the model time ("HH:MM:SS" and milliseconds of the model
+		 * day), the speed ratio, the running state and the model time of
+		 * the next schedule firing.
+		 * 
+		 * @param request AsyncWebServerRequest object containing HTTP request details
+		 */
+		void handleGetClock(AsyncWebServerRequest *request);
+
+		/**
+		 * @brief Handle model clock settings
+		 * 
+		 * Endpoint: POST /api/clock
+		 * Content-Type: application/json
+		 * 
+		 * Body: any of {"time": "18:30", "ratio": 60, "running": true}. The
+		 * ratio is the model time per real time (60 = one model hour per
+		 * real minute). Events between the old and the new time are skipped.
+		 * 
+		 * @param request AsyncWebServerRequest object containing HTTP request details
+		 * @param data Pointer to JSON request body data
+		 * @param len Length of the request body data
+		 * @param index Current chunk index for large uploads
+		 * @param total Total size of the request body
+		 */
+		void handleUpdateClock(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total);
+
+		/**
+		 * @brief Handle schedule information requests
+		 * 
+		 * Endpoint: GET /api/schedule
+		 * 
+		 * Returns the events and the firing counters of the model day.
+		 * 
+		 * @param request AsyncWebServerRequest object containing HTTP request details
+		 */
+		void handleGetSchedule(AsyncWebServerRequest *request);
+
+		/**
+		 * @brief Handle schedule definition requests
+		 * 
+		 * Endpoint: POST /api/schedule
+		 * Content-Type: application/json
+		 * 
+		 * Body: {"events": [{"time": "19:00", "scene": 1}, {"time": "19:30",
+		 * "group": 2, "enabled": true, "jitter": 30}]} replaces every event.
+		 * A scene event takes "transition_ms" and "easing"; a group event
+		 * takes the fields of POST /api/groups/apply and "jitter", the
+		 * longest random delay of each LED (model minutes).
+		 * 
+		 * @param request AsyncWebServerRequest object containing HTTP request details
+		 * @param data Pointer to JSON request body data
+		 * @param len Length of the request body data
+		 * @param index Current chunk index for large uploads
+		 * @param total Total size of the request body
+		 */
+		void handleUpdateSchedule(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total);
+
+		// === Input API Handlers ===
+
+		/**
+		 * @brief Handle input information requests
+		 * 
+		 * Endpoint: GET /api/inputs
+		 * 
+		 * Returns the expanders, the inputs with their debounced state, the
+		 * trigger table and the input counters, including the delay from
+		 * the interrupt to the trigger action.
+		 * 
+		 * @param request AsyncWebServerRequest object containing HTTP request details
+		 */
+		void handleGetInputs(AsyncWebServerRequest *request);
+
+		/**
+		 * @brief Handle input wiring and trigger table definition
+		 * 
+		 * Endpoint: POST /api/inputs
+		 * Content-Type: application/json
+		 * 
+		 * Body: {"expanders": [{"address": 32, "bus": 0, "int_pin": 27}],
+		 * "inputs": [{"name": "Crossing", "gpio": 25, "active_low": true,
+		 * "debounce_ms": 20}, {"name": "Block 2", "expander": 0, "pin": 3}],
+		 * "triggers": [{"input": 0, "edge": "active", "action": "start",
+		 * "group": 1, "program_type": 8}, {"input": 0, "edge": "inactive",
+		 * "action": "stop", "group": 1, "delay_ms": 5000}]} replaces the
+		 * whole wiring. Edges are "active", "inactive" or "change"; actions
+		 * are "start", "stop", "retrigger" (on a group) or "scene" (with
+		 * "scene" instead of "group").
+		 * 
+		 * @param request AsyncWebServerRequest object containing HTTP request details
+		 * @param data Pointer to JSON request body data
+		 * @param len Length of the request body data
+		 * @param index Current chunk index for large uploads
+		 * @param total Total size of the request body
+		 */
+		void handleUpdateInputs(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total);
+		
+		// === Show API Handlers ===
+
+		/**
+		 * @brief Handle show list requests
+		 * 
+		 * Endpoint: GET /api/shows
+		 * 
+		 * Returns the shows stored in /shows with their size, event count
+		 * and duration, the playback status and the playback counters
+		 * (reader underruns and late events).
+		 * 
+		 * @param request AsyncWebServerRequest object containing HTTP request details
+		 */
+		void handleGetShows(AsyncWebServerRequest *request);
+
+		/**
+		 * @brief Handle show start requests
+		 * 
+		 * Endpoint: POST /api/shows/play
+		 * Content-Type: application/json
+		 * 
+		 * Body: {"name": "evening", "loop": false, "start_ms": 0}. The
+		 * start position lets the show join a soundtrack already playing.
+		 * 
+		 * @param request AsyncWebServerRequest object containing HTTP request details
+		 * @param data Pointer to JSON request body data
+		 * @param len Length of the request body data
+		 * @param index Current chunk index for large uploads
+		 * @param total Total size of the request body
+		 */
+		void handlePlayShow(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total);
+
+		/**
+		 * @brief Handle show stop requests
+		 * 
+		 * Endpoint: POST /api/shows/stop
+		 * 
+		 * @param request AsyncWebServerRequest object containing HTTP request details
+		 */
+		void handleStopShow(AsyncWebServerRequest *request);
+
+		/**
+		 * @brief Handle show deletion requests
+		 * 
+		 * Endpoint: DELETE /api/shows?name=evening
+		 * 
+		 * @param request AsyncWebServerRequest object containing HTTP request details
+		 */
+		void handleDeleteShow(AsyncWebServerRequest *request);
+
+		/**
+		 * @brief Handle show file upload chunks
+		 * 
+		 * Endpoint: POST /api/shows/upload
+		 * Content-Type: multipart/form-data
+		 * 
+		 * Stores a file compiled by tools/show_compiler.py. The show is
+		 * named after the uploaded file name without its extension. The
+		 * file is written to a temporary path and replaces the previous
+		 * version only when complete, and a playing show cannot be replaced.
+		 * 
+		 * @param request AsyncWebServerRequest object containing HTTP request details
+		 * @param filename Name of the uploaded file
+		 * @param index Current chunk offset in bytes
+		 * @param data Pointer to chunk data buffer
+		 * @param len Length of current chunk
+		 * @param final True if this is the last chunk of the upload
+		 */
+		void handleShowUpload(AsyncWebServerRequest *request, String filename, size_t index, uint8_t *data, size_t len, bool final);
+
+		/**
+		 * @brief Send the result of a show upload
+		 * 
+		 * @param request AsyncWebServerRequest object containing HTTP request details
+		 */
+		void handleShowUploaded(AsyncWebServerRequest *request);
+
+		// === Layer API Handlers ===
+
+		/**
+		 * @brief Handle layer stack information requests
+		 * 
+		 * Endpoint: GET /api/layers
+		 * 
+		 * Returns the layer stacks, the master levels at boot and live, and
+		 * the current output of each overlay program.
+		 * 
+		 * @param request AsyncWebServerRequest object containing HTTP request details
+		 */
+		void handleGetLayers(AsyncWebServerRequest *request);
+
+		/**
+		 * @brief Handle layer stack definition
+		 * 
+		 * Endpoint: POST /api/layers
+		 * Content-Type: application/json
+		 * 
+		 * Replaces every layer stack, example body:
+		 * {"stacks": [{"module": 0, "led": 3, "overlay_program": 1,
+		 * "overlay_blend": "add", "master": 0, "master_blend": "multiply"}],
+		 * "masters": [4095, 2048]}. Missing layers are left out of the stack,
+		 * missing masters are at full level.
+		 * 
+		 * @param request AsyncWebServerRequest object containing HTTP request details
+		 * @param data Pointer to JSON request body data
+		 * @param len Length of the request body data
+		 * @param index Current chunk index for large uploads
+		 * @param total Total size of the request body
+		 */
+		void handleUpdateLayers(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total);
+
+		/**
+		 * @brief Handle master level changes
+		 * 
+		 * Endpoint: POST /api/layers/master
+		 * Content-Type: application/json
+		 * 
+		 * Body: {"master": 0, "level": 1024}. Not saved, the level at boot
+		 * is part of the layer stack definition.
+		 * 
+		 * @param request AsyncWebServerRequest object containing HTTP request details
+		 * @param data Pointer to JSON request body data
+		 * @param len Length of the request body data
+		 * @param index Current chunk index for large uploads
+		 * @param total Total size of the request body
+		 */
+		void handleLayerMaster(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total);
+
+		/**
+		 * @brief Handle blend benchmark result requests
+		 * 
+		 * Endpoint: GET /api/layers/bench
+		 * 
+		 * Returns the time per blended channel with 1, 2 and 3 layers, the
+		 * cost of each added layer and the free heap change, which must be 0.
+		 * 
+		 * @param request AsyncWebServerRequest object containing HTTP request details
+		 */
+		void handleGetLayerBench(AsyncWebServerRequest *request);
+
+		/**
+		 * @brief Handle blend benchmark requests
+		 * 
+		 * Endpoint: POST /api/layers/bench
+		 * Content-Type: application/json
+		 * 
+		 * Optional body: {"rounds": 200}. The benchmark runs from the main
+		 * loop, results are read with GET /api/layers/bench.
+		 * 
+		 * @param request AsyncWebServerRequest object containing HTTP request details
+		 * @param data Pointer to JSON request body data
+		 * @param len Length of the request body data
+		 * @param index Current chunk index for large uploads
+		 * @param total Total size of the request body
+		 */
+		void handleLayerBench(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total);
+
+		// === OTA (Over-The-Air) Update API Handlers ===
+		
+		/**
+		 * @brief Handle OTA system status requests
+		 * 
+		 * Endpoint: GET /api/ota/status
+		 * 
+		 * Provides detailed OTA system status including readiness
+		 * checks and current operation state.
+		 * 
+		 * @param request AsyncWebServerRequest object containing HTTP request details
+		 */
+		void handleOtaStatus(AsyncWebServerRequest *request);
+		
+		/**
+		 * @brief Handle OTA firmware upload requests
+		 * 
+		 * Endpoint: POST /api/ota/upload
+		 * Content-Type: application/octet-stream
+		 * 
+		 * Processes firmware uploads with validation, progress monitoring,
+		 * and automatic system restart on successful completion.
+		 * 
+		 * @param request AsyncWebServerRequest object containing HTTP request details
+		 * @param filename Name of the uploaded firmware file
+		 * @param index Current chunk offset in bytes
+		 * @param data Pointer to chunk data buffer
+		 * @param len Length of current chunk
+		 * @param final True if this is the last chunk of the upload
+		 * 
+		 * @warning System automatically restarts after successful update
+		 */
+		void handleOtaUpload(AsyncWebServerRequest *request, String filename, size_t index, uint8_t *data, size_t len, bool final);
+
+		/**
+		 * @brief Handle system logs requests
+		 * 
+		 * Endpoint: GET /api/logs
+		 * Query parameters:
+		 * - cursor: sequence of the last entry already received (optional)
+		 * - limit: maximum entries returned with cursor (optional, default 100)
+		 * - count: number of recent entries to return (optional)
+		 * - since: timestamp to get logs since (optional)
+		 * - source: "ram" (default), "rtc" for the tail of the previous boot
+		 *   kept in RTC memory, or "file" for the LittleFS log file as text
+		 *   (with file=previous for the rotated file)
+		 * 
+		 * Returns JSON array of log entries with sequence numbers, timestamps
+		 * and messages. With a cursor, only newer entries are copied and
+		 * "next_cursor" gives the value to pass on the next call.
+		 * 
+		 * @param request AsyncWebServerRequest object containing HTTP request details
+		 */
+		void handleGetLogs(AsyncWebServerRequest *request);
+
+		/**
+		 * @brief Handle log clearing requests
+		 * 
+		 * Endpoint: DELETE /api/logs
+		 * 
+		 * Clears all stored log entries from the buffer.
+		 * 
+		 * @param request AsyncWebServerRequest object containing HTTP request details
+		 */
+		void handleClearLogs(AsyncWebServerRequest *request);
+
+		/**
+		 * @brief Handle a new log stream client
+		 * 
+		 * Endpoint: GET /api/logs/stream (text/event-stream)
+		 * 
+		 * Replays the entries following the client's Last-Event-ID (or the
+		 * most recent ones for a new client). Each entry is sent as a "log"
+		 * event whose id is the entry sequence number.
+		 * 
+		 * @param client Connected event source client
+		 */
+		void handleLogStreamConnect(AsyncEventSourceClient *client);
+
+		/**
+		 * @brief Handle log level information requests
+		 * 
+		 * Endpoint: GET /api/logs/levels
+		 * 
+		 * Returns the compile-time minimum level, the runtime default level
+		 * and all per-tag runtime levels.
+		 * 
+		 * @param request AsyncWebServerRequest object containing HTTP request details
+		 */
+		void handleGetLogLevels(AsyncWebServerRequest *request);
+
+		/**
+		 * @brief Handle log level update requests
+		 * 
+		 * Endpoint: POST /api/logs/levels
+		 * Content-Type: application/json
+		 * 
+		 * Body: {"default": "INFO"} and/or {"tag": "PROGRAMMGR", "level": "DEBUG"}.
+		 * A null level removes the tag override.
+		 * 
+		 * @param request AsyncWebServerRequest object containing HTTP request details
+		 * @param data Pointer to JSON request body data
+		 * @param len Length of the request body data
+		 * @param index Current chunk index for large uploads
+		 * @param total Total size of the request body
+		 */
+		void handleUpdateLogLevels(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total);
+
+		/**
+		 * @brief Handle log file sink status request
+		 * 
+		 * Endpoint: GET /api/logs/file
+		 * 
+		 * Returns whether the LittleFS log file is enabled and running,
+		 * the file sizes and the written/dropped counters.
+		 * 
+		 * @param request AsyncWebServerRequest object containing HTTP request details
+		 */
+		void handleGetLogFile(AsyncWebServerRequest *request);
+
+		/**
+		 * @brief Handle log file sink enable/disable request
+		 * 
+		 * Endpoint: POST /api/logs/file
+		 * Content-Type: application/json
+		 * 
+		 * Body: {"enabled": true}. The setting is persisted and applied at boot.
+		 * 
+		 * @param request AsyncWebServerRequest object containing HTTP request details
+		 * @param data Pointer to JSON request body data
+		 * @param len Length of the request body data
+		 * @param index Current chunk index for large uploads
+		 * @param total Total size of the request body
+		 */
+		void handleUpdateLogFile(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total);
+
+		// === Configuration handlers ===
+
+		/**
+		 * @brief Handle WiFi configuration page request
+		 * 
+		 * Endpoint: GET /config
+		 * 
+		 * Serves the WiFi configuration page for system setup.
+		 * 
+		 * @param request AsyncWebServerRequest object containing HTTP request details
+		 */
+		void handleConfigPage(AsyncWebServerRequest *request);
+
+		/**
+		 * @brief Handle WiFi scan request
+		 * 
+		 * Endpoint: GET /api/wifi/scan
+		 * 
+		 * Returns list of available WiFi networks.
+		 * 
+		 * @param request AsyncWebServerRequest object containing HTTP request details
+		 */
+		void handleWifiScan(AsyncWebServerRequest *request);
+
+		/**
+		 * @brief Handle WiFi configuration update
+		 * 
+		 * Endpoint: POST /api/wifi/config
+		 * Content-Type: application/json
+		 * 
+		 * Updates WiFi configuration with new credentials.
+		 * 
+		 * @param request AsyncWebServerRequest object containing HTTP request details
+		 * @param data Pointer to JSON request body data
+		 * @param len Length of the request body data
+		 * @param index Current chunk index for large uploads
+		 * @param total Total size of the request body
+		 */
+		void handleWifiConfig(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total);
+
+		/**
+		 * @brief Handle WiFi status request
+		 * 
+		 * Endpoint: GET /api/wifi/status
+		 * 
+		 * Returns current WiFi connection status and network information.
+		 * 
+		 * @param request AsyncWebServerRequest object containing HTTP request details
+		 */
+		void handleWifiStatus(AsyncWebServerRequest *request);
+
+		/**
+		 * @brief Save current configuration 
+		 * 
+		 * Endpoint: GET /api/save
+		 * 
+		 * Returns save operation status
+		 * 
+		 * @param request AsyncWebServerRequest object containing HTTP request details
+		 */
+		void handleSave(AsyncWebServerRequest *request);
+
+		/**
+		 * @brief Load saved configuration 
+		 * 
+		 * Endpoint: GET /api/load
+		 * 
+		 * Returns save operation status
+		 * 
+		 * @param request AsyncWebServerRequest object containing HTTP request details
+		 */
+		void handleLoad(AsyncWebServerRequest *request);
+		
+		// === Static Lambda Wrapper Methods ===
+		// These methods provide static context for AsyncWebServer callbacks
+		
+		/**
+		 * @brief Create lambda wrapper for health endpoint
+		 * @return Lambda function compatible with AsyncWebServer
+		 */
+		std::function<void(AsyncWebServerRequest*)> createHealthHandler();
+		
+		/**
+		 * @brief Create lambda wrapper for system info endpoint
+		 * @return Lambda function compatible with AsyncWebServer
+		 */
+		std::function<void(AsyncWebServerRequest*)> createSystemHandler();
+		
+		/**
+		 * @brief Create lambda wrapper for modules endpoint
+		 * @return Lambda function compatible with AsyncWebServer
+		 */
+		std::function<void(AsyncWebServerRequest*)> createModulesHandler();
+
+		/**
+		 * @brief Create lambda wrapper for module forget endpoint
+		 * @return Lambda function compatible with AsyncWebServer
+		 */
+		std::function<void(AsyncWebServerRequest*)> createForgetModuleHandler();
+
+		/**
+		 * @brief Create lambda wrapper for module PWM configuration endpoint
+		 * @return Lambda function compatible with AsyncWebServer body handler
+		 */
+		std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> createUpdateModulePwmHandler();
+
+		/**
+		 * @brief Create lambda wrapper for oscillator calibration endpoint
+		 * @return Lambda function compatible with AsyncWebServer body handler
+		 */
+		std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> createModuleCalibrateHandler();
+
+		/**
+		 * @brief Create lambda wrapper for oscillator calibration result endpoint
+		 * @return Lambda function compatible with AsyncWebServer
+		 */
+		std::function<void(AsyncWebServerRequest*)> createModuleCalibrationHandler();
+		
+		/**
+		 * @brief Create lambda wrapper for LEDs endpoint
+		 * @return Lambda function compatible with AsyncWebServer
+		 */
+		std::function<void(AsyncWebServerRequest*)> createLedsHandler();
+		
+		/**
+		 * @brief Create lambda wrapper for LED update endpoint
+		 * @return Lambda function compatible with AsyncWebServer body handler
+		 */
+		std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> createUpdateLedHandler();
+		
+		/**
+		 * @brief Create lambda wrapper for programs endpoint
+		 * @return Lambda function compatible with AsyncWebServer
+		 */
+		std::function<void(AsyncWebServerRequest*)> createProgramsHandler();
+
+		/**
+		 * @brief Create lambda wrapper for user effects endpoint
+		 * @return Lambda function compatible with AsyncWebServer
+		 */
+		std::function<void(AsyncWebServerRequest*)> createEffectsHandler();
+
+		/**
+		 * @brief Create lambda wrapper for user effect upload endpoint
+		 * @return Lambda function compatible with AsyncWebServer body handler
+		 */
+		std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> createUpdateEffectHandler();
+
+		/**
+		 * @brief Create lambda wrapper for effect benchmark results endpoint
+		 * @return Lambda function compatible with AsyncWebServer
+		 */
+		std::function<void(AsyncWebServerRequest*)> createEffectBenchResultsHandler();
+
+		/**
+		 * @brief Create lambda wrapper for effect benchmark endpoint
+		 * @return Lambda function compatible with AsyncWebServer body handler
+		 */
+		std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> createEffectBenchHandler();
+
+		/**
+		 * @brief Create lambda wrapper for LED groups endpoint
+		 * @return Lambda function compatible with AsyncWebServer
+		 */
+		std::function<void(AsyncWebServerRequest*)> createGroupsHandler();
+
+		/**
+		 * @brief Create lambda wrapper for LED group definition endpoint
+		 * @return Lambda function compatible with AsyncWebServer body handler
+		 */
+		std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> createUpdateGroupHandler();
+
+		/**
+		 * @brief Create lambda wrapper for group-wide change endpoint
+		 * @return Lambda function compatible with AsyncWebServer body handler
+		 */
+		std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> createApplyGroupHandler();
+
+		/**
+		 * @brief Create lambda wrapper for scenes endpoint
+		 * @return Lambda function compatible with AsyncWebServer
+		 */
+		std::function<void(AsyncWebServerRequest*)> createScenesHandler();
+
+		/**
+		 * @brief Create lambda wrapper for scene definition endpoint
+		 * @return Lambda function compatible with AsyncWebServer body handler
+		 */
+		std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> createUpdateSceneHandler();
+
+		/**
+		 * @brief Create lambda wrapper for scene recall endpoint
+		 * @return Lambda function compatible with AsyncWebServer body handler
+		 */
+		std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> createRecallSceneHandler();
+
+		/**
+		 * @brief Create lambda wrapper for model clock endpoint
+		 * @return Lambda function compatible with AsyncWebServer
+		 */
+		std::function<void(AsyncWebServerRequest*)> createClockHandler();
+
+		/**
+		 * @brief Create lambda wrapper for model clock settings endpoint
+		 * @return Lambda function compatible with AsyncWebServer body handler
+		 */
+		std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> createUpdateClockHandler();
+
+		/**
+		 * @brief Create lambda wrapper for schedule endpoint
+		 * @return Lambda function compatible with AsyncWebServer
+		 */
+		std::function<void(AsyncWebServerRequest*)> createScheduleHandler();
+
+		/**
+		 * @brief Create lambda wrapper for schedule definition endpoint
+		 * @return Lambda function compatible with AsyncWebServer body handler
+		 */
+		std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> createUpdateScheduleHandler();
+
+		/**
+		 * @brief Create lambda wrapper for inputs endpoint
+		 * @return Lambda function compatible with AsyncWebServer
+		 */
+		std::function<void(AsyncWebServerRequest*)> createInputsHandler();
+
+		/**
+		 * @brief Create lambda wrapper for input wiring endpoint
+		 * @return Lambda function compatible with AsyncWebServer body handler
+		 */
+		std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> createUpdateInputsHandler();
+
+		/**
+		 * @brief Create lambda wrapper for shows endpoint
+		 * @return Lambda function compatible with AsyncWebServer
+		 */
+		std::function<void(AsyncWebServerRequest*)> createShowsHandler();
+
+		/**
+		 * @brief Create lambda wrapper for show start endpoint
+		 * @return Lambda function compatible with AsyncWebServer body handler
+		 */
+		std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> createPlayShowHandler();
+
+		/**
+		 * @brief Create lambda wrapper for show stop endpoint
+		 * @return Lambda function compatible with AsyncWebServer
+		 */
+		std::function<void(AsyncWebServerRequest*)> createStopShowHandler();
+
+		/**
+		 * @brief Create lambda wrapper for show deletion endpoint
+		 * @return Lambda function compatible with AsyncWebServer
+		 */
+		std::function<void(AsyncWebServerRequest*)> createDeleteShowHandler();
+
+		/**
+		 * @brief Create lambda wrapper for show upload endpoint
+		 * @return Lambda function compatible with AsyncWebServer upload handler
+		 */
+		std::function<void(AsyncWebServerRequest*, String, size_t, uint8_t*, size_t, bool)> createShowUploadHandler();
+
+		/**
+		 * @brief Create lambda wrapper for show upload completion
+		 * @return Lambda function compatible with AsyncWebServer
+		 */
+		std::function<void(AsyncWebServerRequest*)> createShowUploadedHandler();
+
+		/**
+		 * @brief Create lambda wrapper for layers endpoint
+		 * @return Lambda function compatible with AsyncWebServer
+		 */
+		std::function<void(AsyncWebServerRequest*)> createLayersHandler();
+
+		/**
+		 * @brief Create lambda wrapper for layer stack definition endpoint
+		 * @return Lambda function compatible with AsyncWebServer body handler
+		 */
+		std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> createUpdateLayersHandler();
+
+		/**
+		 * @brief Create lambda wrapper for master level endpoint
+		 * @return Lambda function compatible with AsyncWebServer body handler
+		 */
+		std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> createLayerMasterHandler();
+
+		/**
+		 * @brief Create lambda wrapper for blend benchmark results endpoint
+		 * @return Lambda function compatible with AsyncWebServer
+		 */
+		std::function<void(AsyncWebServerRequest*)> createLayerBenchResultsHandler();
+
+		/**
+		 * @brief Create lambda wrapper for blend benchmark endpoint
+		 * @return Lambda function compatible with AsyncWebServer body handler
+		 */
+		std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> createLayerBenchHandler();
+
+		/**
+		 * @brief Create lambda wrapper for I2C status endpoint
+		 * @return Lambda function compatible with AsyncWebServer
+		 */
+		std::function<void(AsyncWebServerRequest*)> createI2cHandler();
+
+		/**
+		 * @brief Create lambda wrapper for I2C configuration endpoint
+		 * @return Lambda function compatible with AsyncWebServer body handler
+		 */
+		std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> createUpdateI2cHandler();
+
+		/**
+		 * @brief Create lambda wrapper for driver benchmark endpoint
+		 * @return Lambda function compatible with AsyncWebServer body handler
+		 */
+		std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> createI2cBenchHandler();
+
+		/**
+		 * @brief Create lambda wrapper for broadcast status endpoint
+		 * @return Lambda function compatible with AsyncWebServer
+		 */
+		std::function<void(AsyncWebServerRequest*)> createBroadcastHandler();
+
+		/**
+		 * @brief Create lambda wrapper for broadcast operation endpoint
+		 * @return Lambda function compatible with AsyncWebServer body handler
+		 */
+		std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> createBroadcastActionHandler();
+
+		/**
+		 * @brief Create lambda wrapper for broadcast group configuration endpoint
+		 * @return Lambda function compatible with AsyncWebServer body handler
+		 */
+		std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> createUpdateBroadcastGroupsHandler();
+		
+		/**
+		 * @brief Create lambda wrapper for brightness curve status endpoint
+		 * @return Lambda function compatible with AsyncWebServer
+		 */
+		std::function<void(AsyncWebServerRequest*)> createCurvesHandler();
+		
+		/**
+		 * @brief Create lambda wrapper for brightness curve configuration endpoint
+		 * @return Lambda function compatible with AsyncWebServer body handler
+		 */
+		std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> createUpdateCurvesHandler();
+		
+		/**
+		 * @brief Create lambda wrapper for power budget status endpoint
+		 * @return Lambda function compatible with AsyncWebServer
+		 */
+		std::function<void(AsyncWebServerRequest*)> createPowerHandler();
+		
+		/**
+		 * @brief Create lambda wrapper for power budget configuration endpoint
+		 * @return Lambda function compatible with AsyncWebServer body handler
+		 */
+		std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> createUpdatePowerHandler();
+		
+		/**
+		 * @brief Create lambda wrapper for OTA status endpoint
+		 * @return Lambda function compatible with AsyncWebServer
+		 */
+		std::function<void(AsyncWebServerRequest*)> createOtaStatusHandler();
+		
+		/**
+		 * @brief Create lambda wrapper for OTA upload endpoint
+		 * @return Lambda function compatible with AsyncWebServer upload handler
+		 */
+		std::function<void(AsyncWebServerRequest*, String, size_t, uint8_t*, size_t, bool)> createOtaUploadHandler();
+
+		/**
+		 * @brief Create lambda wrapper for logs endpoint
+		 * @return Lambda function compatible with AsyncWebServer
+		 */
+		std::function<void(AsyncWebServerRequest*)> createLogsHandler();
+
+		/**
+		 * @brief Create lambda wrapper for clear logs endpoint
+		 * @return Lambda function compatible with AsyncWebServer
 		 */
 		std::function<void(AsyncWebServerRequest*)> createClearLogsHandler();
 
+		/**
+		 * @brief Create lambda wrapper for log levels endpoint
+		 * @return Lambda function compatible with AsyncWebServer
+		 */
+		std::function<void(AsyncWebServerRequest*)> createLogLevelsHandler();
+
+		/**
+		 * @brief Create lambda wrapper for log levels update endpoint
+		 * @return Lambda function compatible with AsyncWebServer body handler
+		 */
+		std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> createUpdateLogLevelsHandler();
+
+		/**
+		 * @brief Create lambda wrapper for log file status endpoint
+		 * @return Lambda function compatible with AsyncWebServer
+		 */
+		std::function<void(AsyncWebServerRequest*)> createLogFileHandler();
+
+		/**
+		 * @brief Create lambda wrapper for log file update endpoint
+		 * @return Lambda function compatible with AsyncWebServer body handler
+		 */
+		std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> createUpdateLogFileHandler();
+
 		/**
 		 * @brief Create lambda wrapper for config page endpoint
 		 * @return Lambda function compatible with AsyncWebServer
@@ -28,6 +28,16 @@ Config config;
 Config::Config() : 
 	i2c_pin_sda_(21),
 	i2c_pin_scl_(22),
+	i2c1_pin_sda_(I2C_PIN_NONE),
+	i2c1_pin_scl_(I2C_PIN_NONE),
+	i2c_clock_hz_(I2C_CLOCK_FAST_PLUS),
+	broadcast_group_addr_{0x71, 0x72},
+	phase_stagger_(true),
+	linked_frames_(false),
+	hotplug_scan_(true),
+	default_curve_(CURVE_CIE),
+	power_budget_ma_(0),
+	power_mode_(POWER_FAIR),
 	pca9685_addr_min_(PCA9685Module::ADDR_MIN),
 	pca9685_addr_max_(PCA9685Module::ADDR_MAX),
 	pca9685_module_max_(PCA9685Module::MODULE_MAX),
@@ -45,6 +55,16 @@ Config::Config(
 	size_t name_max) :
 	i2c_pin_sda_(sda_pin),
 	i2c_pin_scl_(scl_pin),
+	i2c1_pin_sda_(I2C_PIN_NONE),
+	i2c1_pin_scl_(I2C_PIN_NONE),
+	i2c_clock_hz_(I2C_CLOCK_FAST_PLUS),
+	broadcast_group_addr_{0x71, 0x72},
+	phase_stagger_(true),
+	linked_frames_(false),
+	hotplug_scan_(true),
+	default_curve_(CURVE_CIE),
+	power_budget_ma_(0),
+	power_mode_(POWER_FAIR),
 	pca9685_addr_min_(addr_min),
 	pca9685_addr_max_(addr_max),
 	pca9685_module_max_(module_max),
@@ -72,6 +92,52 @@ bool Config::setI2cSclPin(uint8_t pin) {
 	return false;
 }
 
+bool Config::setI2cClockHz(uint32_t clock_hz) {
+	if (isValidI2cClock(clock_hz)) {
+		i2c_clock_hz_ = clock_hz;
+		return true;
+	}
+
+	return false;
+}
+
+bool Config::setI2c1Pins(uint8_t sda_pin, uint8_t scl_pin) {
+	// Both pins unset disables the second bus
+	if (sda_pin == I2C_PIN_NONE && scl_pin == I2C_PIN_NONE) {
+		i2c1_pin_sda_ = I2C_PIN_NONE;
+		i2c1_pin_scl_ = I2C_PIN_NONE;
+		return true;
+	}
+
+	if (isValidGpioPin(sda_pin) && isValidGpioPin(scl_pin) &&
+		sda_pin != scl_pin &&
+		sda_pin != i2c_pin_sda_ && sda_pin != i2c_pin_scl_ &&
+		scl_pin != i2c_pin_sda_ && scl_pin != i2c_pin_scl_) {
+		i2c1_pin_sda_ = sda_pin;
+		i2c1_pin_scl_ = scl_pin;
+		return true;
+	}
+
+	return false;
+}
+
+bool Config::setBroadcastGroupAddress(uint8_t group, uint8_t address) {
+	if (group < 1 || group > BROADCAST_GROUP_COUNT ||
+		address < PCA9685Module::ADDR_MIN || address > PCA9685Module::ADDR_MAX ||
+		address == PCA9685Module::ADDR_RESERVED_ALL_CALL) {
+		return false;
+	}
+
+	for (uint8_t other = 1; other <= BROADCAST_GROUP_COUNT; other++) {
+		if (other != group && broadcast_group_addr_[other - 1] == address) {
+			return false;
+		}
+	}
+
+	broadcast_group_addr_[group - 1] = address;
+	return true;
+}
+
 bool Config::setPca9685AddressRange(uint8_t min_addr, uint8_t max_addr) {
 	if (min_addr <= max_addr && min_addr >= 0x08 && max_addr <= 0x77) {
 		pca9685_addr_min_ = min_addr;
@@ -117,6 +183,8 @@ bool Config::isValid() const {
 	return isValidGpioPin(i2c_pin_sda_) &&
 		isValidGpioPin(i2c_pin_scl_) &&
 		i2c_pin_sda_ != i2c_pin_scl_ &&
+		isValidI2cClock(i2c_clock_hz_) &&
+		(!isI2c1Enabled() || (isValidGpioPin(i2c1_pin_sda_) && isValidGpioPin(i2c1_pin_scl_) && i2c1_pin_sda_ != i2c1_pin_scl_)) &&
 		pca9685_addr_min_ <= pca9685_addr_max_ &&
 		pca9685_addr_min_ >= PCA9685Module::ADDR_MIN &&
 		pca9685_addr_max_ <= PCA9685Module::ADDR_MAX &&
@@ -135,16 +203,58 @@ void Config::reset() {
 // Debug output
 void Config::printConfiguration() const {
 	LOG_INFO("[CONFIG] Current configuration:");
-	LOG_INFO("[CONFIG] I2C - SDA: %d, SCL: %d\n", i2c_pin_sda_, i2c_pin_scl_);
+	LOG_INFO("[CONFIG] I2C - SDA: %d, SCL: %d, max clock: %lu Hz\n", i2c_pin_sda_, i2c_pin_scl_, (unsigned long)i2c_clock_hz_);
+	if (isI2c1Enabled()) {
+		LOG_INFO("[CONFIG] I2C bus 1 - SDA: %d, SCL: %d\n", i2c1_pin_sda_, i2c1_pin_scl_);
+	}
 	LOG_INFO("[CONFIG] PCA9685 - Addr range: 0x%02X-0x%02X\n", pca9685_addr_min_, pca9685_addr_max_);
+	LOG_INFO("[CONFIG] PCA9685 - Broadcast groups: 0x%02X, 0x%02X\n", broadcast_group_addr_[0], broadcast_group_addr_[1]);
+	LOG_INFO("[CONFIG] PCA9685 - Phase stagger: %s, linked frames: %s, hot-plug scan: %s\n", phase_stagger_ ? "enabled" : "disabled", linked_frames_ ? "enabled" : "disabled", hotplug_scan_ ? "enabled" : "disabled");
+	LOG_INFO("[CONFIG] LED - Transfer curve: %s\n", BrightnessCurve::getName(default_curve_));
+	if (power_budget_ma_ > 0) {
+		LOG_INFO("[CONFIG] LED - Power budget: %lu mA (%s)\n", (unsigned long)power_budget_ma_, power_mode_ == POWER_PRIORITY ? "priority" : "fair");
+	} else {
+		LOG_INFO("[CONFIG] LED - Power budget: no limit\n");
+	}
 	LOG_INFO("[CONFIG] Limits - Modules: %d, LEDs/module: %d\n", pca9685_module_max_, pca9685_led_max_);
 	LOG_INFO("[CONFIG] LED name max length: %zu\n", led_name_max_);
 	LOG_INFO("[CONFIG] Configuration is %s\n", isValid() ? "VALID" : "INVALID");
 }
 
 
+// === Static methods ===
+
+bool Config::isValidI2cClock(uint32_t clock_hz) {
+	return clock_hz == I2C_CLOCK_STANDARD ||
+		clock_hz == I2C_CLOCK_FAST ||
+		clock_hz == I2C_CLOCK_FAST_PLUS;
+}
+
 // === Private static method ===
 
+bool Config::setDefaultCurve(CurveType curve) {
+	if (curve == CURVE_DEFAULT || curve >= BrightnessCurve::CURVE_TYPE_COUNT) {
+		return false;
+	}
+	default_curve_ = curve;
+	return true;
+}
+
+bool Config::setPowerBudget(uint32_t budget_ma) {
+	if (budget_ma > POWER_BUDGET_MAX_MA) {
+		return false;
+	}
+	power_budget_ma_ = budget_ma;
+	return true;
+}
+
+bool Config::isFreeInputPin(uint8_t pin) const {
+	// GPIO 34-39 are input-only, fine for reading
+	return (isValidGpioPin(pin) || (pin >= 34 && pin <= 39)) &&
+		pin != i2c_pin_sda_ && pin != i2c_pin_scl_ &&
+		pin != i2c1_pin_sda_ && pin != i2c1_pin_scl_;
+}
+
 bool Config::isValidGpioPin(uint8_t pin) {
 	// ESP32 valid GPIO pins (excluding input-only and special pins)
 	return (
@@ -0,0 +1,195 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Jérôme SONRIER
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * @file curve.cpp
+ * @brief Implementation of the brightness transfer curves
+ *
+ * This file computes the gamma 2.2 and CIE L* tables at compile time and
+ * builds the custom table from its control points.
+ *
+ * See curve.h for API documentation.
+ *
+ * @author  Jérôme SONRIER <jsid@emor3j.fr.eu.org>
+ * @date    2025-10-17
+ */
+
+#include <memory>
+#include <new>
+#include <string.h>
+
+#include "curve.h"
+
+
+// === Compile-time tables ===
+
+/// One intensity (PWM duty << FRACTION_BITS) per input level
+struct CurveTable {
+	uint16_t values[BrightnessCurve::LEVELS];
+};
+
+/**
+ * @brief Fifth root by Newton iterations, usable in constant expressions
+ * @param x Value in [0, 1]
+ * @return x^(1/5)
+ */
+static constexpr double fifthRoot(double x) {
+	// Starting above the root, iterations decrease monotonically towards it
+	double y = 1.0;
+	for (int i = 0; i < 48; i++) {
+		double y4 = y * y * y * y;
+		y = (4.0 * y + x / y4) / 5.0;
+	}
+	return y;
+}
+
+/**
+ * @brief Round a relative light output to an intensity, keeping lit inputs lit
+ * @param y Relative light output in [0, 1]
+ * @param input Input level the output was computed for
+ * @return Intensity (0 to INTENSITY_MAX)
+ */
+static constexpr uint16_t toIntensity(double y, uint16_t input) {
+	uint16_t intensity = static_cast<uint16_t>(y * BrightnessCurve::INTENSITY_MAX + 0.5);
+	return (input > 0 && intensity == 0) ? 1 : intensity;
+}
+
+/**
+ * @brief Build the gamma 2.2 table (x^2.2 = x^2 * x^(1/5))
+ */
+static constexpr CurveTable makeGammaTable() {
+	CurveTable table{};
+	for (uint16_t i = 0; i < BrightnessCurve::LEVELS; i++) {
+		double x = static_cast<double>(i) / BrightnessCurve::LEVEL_MAX;
+		table.values[i] = toIntensity(x * x * fifthRoot(x), i);
+	}
+	return table;
+}
+
+/**
+ * @brief Build the CIE 1976 L* table (input is L* from 0 to 100)
+ */
+static constexpr CurveTable makeCieTable() {
+	CurveTable table{};
+	for (uint16_t i = 0; i < BrightnessCurve::LEVELS; i++) {
+		double lightness = 100.0 * i / BrightnessCurve::LEVEL_MAX;
+		double t = (lightness + 16.0) / 116.0;
+		double y = lightness <= 8.0 ? lightness / 903.3 : t * t * t;
+		table.values[i] = toIntensity(y, i);
+	}
+	return table;
+}
+
+/// Gamma 2.2 table, in flash
+static constexpr CurveTable GAMMA22_TABLE = makeGammaTable();
+/// CIE L* table, in flash
+static constexpr CurveTable CIE_TABLE = makeCieTable();
+
+static_assert(GAMMA22_TABLE.values[0] == 0 && GAMMA22_TABLE.values[1] == 1 &&
+	GAMMA22_TABLE.values[2048] == 14267 && GAMMA22_TABLE.values[4095] == BrightnessCurve::INTENSITY_MAX, "Unexpected gamma 2.2 table");
+static_assert(CIE_TABLE.values[0] == 0 && CIE_TABLE.values[1] == 2 &&
+	CIE_TABLE.values[2048] == 12075 && CIE_TABLE.values[4095] == BrightnessCurve::INTENSITY_MAX, "Unexpected CIE L* table");
+
+// === Custom table ===
+
+/// Custom table, allocated when first set (shared by every LED)
+static std::unique_ptr<uint16_t[]> custom_table;
+/// Control points of the custom table
+static uint16_t custom_points[BrightnessCurve::CUSTOM_POINTS];
+/// Whether custom_points holds user points
+static bool custom_points_set = false;
+
+// === Public functions ===
+
+uint16_t BrightnessCurve::apply(CurveType curve, uint16_t level) {
+	uint16_t duty = toDuty(applyIntensity(curve, level));
+	return (level > 0 && duty == 0) ? 1 : duty;
+}
+
+uint16_t BrightnessCurve::applyIntensity(CurveType curve, uint16_t level) {
+	if (level > LEVEL_MAX) {
+		level = LEVEL_MAX;
+	}
+
+	switch (curve) {
+		case CURVE_GAMMA22:
+			return GAMMA22_TABLE.values[level];
+		case CURVE_CIE:
+			return CIE_TABLE.values[level];
+		case CURVE_CUSTOM:
+			if (custom_table) {
+				return custom_table[level];
+			}
+			return level << FRACTION_BITS;
+		default:
+			return level << FRACTION_BITS;
+	}
+}
+
+const char* BrightnessCurve::getName(CurveType curve) {
+	switch (curve) {
+		case CURVE_DEFAULT:  return "default";
+		case CURVE_LINEAR:   return "linear";
+		case CURVE_GAMMA22:  return "gamma22";
+		case CURVE_CIE:      return "cie";
+		case CURVE_CUSTOM:   return "custom";
+		default:             return "unknown";
+	}
+}
+
+bool BrightnessCurve::fromName(const char* name, CurveType& curve) {
+	if (!name) {
+		return false;
+	}
+
+	for (uint8_t i = 0; i < CURVE_TYPE_COUNT; i++) {
+		if (strcmp(name, getName(static_cast<CurveType>(i))) == 0) {
+			curve = static_cast<CurveType>(i);
+			return true;
+		}
+	}
+	return false;
+}
+
+bool BrightnessCurve::setCustomPoints(const uint16_t* points) {
+	if (!points) {
+		return false;
+	}
+	for (uint8_t i = 0; i < CUSTOM_POINTS; i++) {
+		if (points[i] > LEVEL_MAX) {
+			return false;
+		}
+	}
+
+	if (!custom_table) {
+		custom_table.reset(new (std::nothrow) uint16_t[LEVELS]);
+		if (!custom_table) {
+			return false;
+		}
+	}
+
+	// Written in place: a frame built meanwhile mixes both curves, harmless
+	for (uint8_t i = 0; i + 1 < CUSTOM_POINTS; i++) {
+		uint16_t x0 = i * CUSTOM_POINT_STEP;
+		uint16_t x1 = (i + 2 == CUSTOM_POINTS) ? static_cast<uint16_t>(LEVEL_MAX) : x0 + CUSTOM_POINT_STEP;
+		int32_t y0 = points[i] << FRACTION_BITS;
+		int32_t y1 = points[i + 1] << FRACTION_BITS;
+		for (uint16_t x = x0; x <= x1; x++) {
+			custom_table[x] = static_cast<uint16_t>(y0 + ((y1 - y0) * (x - x0) + (x1 - x0) / 2) / (x1 - x0));
+		}
+	}
+
+	memcpy(custom_points, points, sizeof(custom_points));
+	custom_points_set = true;
+
+	return true;
+}
+
+const uint16_t* BrightnessCurve::getCustomPoints() {
+	if (!custom_points_set) {
+		for (uint8_t i = 0; i < CUSTOM_POINTS; i++) {
+			custom_points[i] = (i + 1 == CUSTOM_POINTS) ? static_cast<uint16_t>(LEVEL_MAX) : i * CUSTOM_POINT_STEP;
+		}
+	}
+	return custom_points;
+}
@@ -0,0 +1,378 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Jérôme SONRIER
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * @file effect.cpp
+ * @brief Implementation of the effect bytecode compiler and interpreter
+ *
+ * This file validates uploaded bytecode once, and runs the decoded programs
+ * without allocation from the program manager update.
+ *
+ * See effect.h for API documentation.
+ *
+ * @author  Jérôme SONRIER <jsid@emor3j.fr.eu.org>
+ * @date    2025-10-17
+ */
+
+#include "effect.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#endif
+
+
+// === Helpers ===
+
+/**
+ * @brief Check if an instruction may complete without waiting
+ * @param ins Instruction
+ * @return true unless the instruction always takes some time
+ */
+static bool isZeroTime(const EffectInstruction& ins) {
+	switch (ins.op) {
+		case EFFECT_RAMP:
+			return ins.param == 0;
+		case EFFECT_HOLD:
+			// The random extra may be zero, only the fixed part counts
+			return ins.value == 0;
+		default:
+			return true;
+	}
+}
+
+/**
+ * @brief Check if an instruction may continue with the next one
+ * @param ins Instruction
+ * @return true if the next instruction can be reached from this one
+ */
+static bool fallsThrough(const EffectInstruction& ins) {
+	switch (ins.op) {
+		case EFFECT_END:
+			return false;
+		case EFFECT_LOOP:
+			return ins.param != 0;
+		case EFFECT_JUMP:
+			return ins.arg < 100;
+		default:
+			return true;
+	}
+}
+
+/**
+ * @brief Get the branch target of an instruction
+ * @param ins Instruction
+ * @return Target index, or -1 if the instruction does not branch
+ */
+static int branchTarget(const EffectInstruction& ins) {
+	if (ins.op == EFFECT_LOOP || (ins.op == EFFECT_JUMP && ins.arg > 0)) {
+		return ins.value;
+	}
+	return -1;
+}
+
+/**
+ * @brief Draw a random number
+ * @param low Lowest value
+ * @param high Highest value + 1
+ * @return Value in [low, high)
+ */
+static long randomRange(long low, long high) {
+#ifdef ARDUINO
+	return random(low, high);
+#else
+	// Host tests
+	return low + rand() % (high - low);
+#endif
+}
+
+/**
+ * @brief Decode one hexadecimal digit
+ * @param c Character
+ * @return Digit value, or -1 if not a hexadecimal digit
+ */
+static int hexDigit(char c) {
+	if (c >= '0' && c <= '9') return c - '0';
+	if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+	if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+	return -1;
+}
+
+// === Compilation ===
+
+bool EffectVM::compile(const uint8_t* bytes, size_t size, uint8_t budget, Program& program, char* error, size_t error_size) {
+	if (!bytes || size == 0 || size % INSTRUCTION_SIZE != 0) {
+		snprintf(error, error_size, "Code size must be a non-zero multiple of %u bytes", static_cast<unsigned>(INSTRUCTION_SIZE));
+		return false;
+	}
+	size_t length = size / INSTRUCTION_SIZE;
+	if (length > INSTRUCTIONS_MAX) {
+		snprintf(error, error_size, "Too many instructions (max %u)", static_cast<unsigned>(INSTRUCTIONS_MAX));
+		return false;
+	}
+	if (budget == 0 || budget > BUDGET_MAX) {
+		snprintf(error, error_size, "Budget must be between 1 and %u", static_cast<unsigned>(BUDGET_MAX));
+		return false;
+	}
+
+	EffectInstruction code[INSTRUCTIONS_MAX];
+	for (size_t i = 0; i < length; i++) {
+		const uint8_t* p = bytes + i * INSTRUCTION_SIZE;
+		EffectInstruction& ins = code[i];
+		ins.op = p[0];
+		ins.arg = p[1];
+		ins.value = p[2] | (p[3] << 8);
+		ins.param = p[4] | (p[5] << 8);
+
+		const char* reason = nullptr;
+		switch (ins.op) {
+			case EFFECT_END:
+			case EFFECT_HOLD:
+				break;
+			case EFFECT_SET:
+			case EFFECT_RAMP:
+				if (ins.value > LEVEL_MAX) reason = "level out of range";
+				break;
+			case EFFECT_RANDOM:
+				if (ins.value > ins.param || ins.param > LEVEL_MAX) reason = "invalid level range";
+				break;
+			case EFFECT_LOOP:
+				if (ins.arg >= LOOP_COUNTERS || ins.value > i) reason = "invalid loop counter or target";
+				break;
+			case EFFECT_JUMP:
+				if (ins.arg > 100 || ins.value >= length) reason = "invalid probability or target";
+				break;
+			default:
+				snprintf(error, error_size, "Instruction %u: unknown operation %u", static_cast<unsigned>(i), ins.op);
+				return false;
+		}
+		if (!reason && fallsThrough(ins) && i + 1 == length) {
+			reason = "runs past the end of the program";
+		}
+		if (reason) {
+			snprintf(error, error_size, "Instruction %u: %s", static_cast<unsigned>(i), reason);
+			return false;
+		}
+	}
+
+	// A cycle of zero-time instructions would spin forever: prune every
+	// instruction whose successors are all timed or pruned, anything left
+	// is such a cycle (at most 64 passes over 64 instructions)
+	bool alive[INSTRUCTIONS_MAX];
+	for (size_t i = 0; i < length; i++) {
+		alive[i] = isZeroTime(code[i]);
+	}
+	bool changed = true;
+	while (changed) {
+		changed = false;
+		for (size_t i = 0; i < length; i++) {
+			if (!alive[i]) {
+				continue;
+			}
+			bool next_alive = fallsThrough(code[i]) && alive[i + 1];
+			int target = branchTarget(code[i]);
+			bool target_alive = target >= 0 && alive[target];
+			if (!next_alive && !target_alive) {
+				alive[i] = false;
+				changed = true;
+			}
+		}
+	}
+	for (size_t i = 0; i < length; i++) {
+		if (alive[i]) {
+			snprintf(error, error_size, "Instruction %u: loop without ramp or hold", static_cast<unsigned>(i));
+			return false;
+		}
+	}
+
+	memcpy(program.code, code, length * sizeof(EffectInstruction));
+	program.length = static_cast<uint8_t>(length);
+	program.budget = budget;
+	return true;
+}
+
+size_t EffectVM::encode(const Program& program, uint8_t* out) {
+	for (uint8_t i = 0; i < program.length; i++) {
+		const EffectInstruction& ins = program.code[i];
+		uint8_t* p = out + i * INSTRUCTION_SIZE;
+		p[0] = ins.op;
+		p[1] = ins.arg;
+		p[2] = ins.value & 0xFF;
+		p[3] = ins.value >> 8;
+		p[4] = ins.param & 0xFF;
+		p[5] = ins.param >> 8;
+	}
+	return program.length * INSTRUCTION_SIZE;
+}
+
+bool EffectVM::parseHex(const char* hex, uint8_t* out, size_t max, size_t& size) {
+	size = 0;
+	if (!hex) {
+		return false;
+	}
+
+	int high = -1;
+	for (const char* c = hex; *c; c++) {
+		if (isspace(static_cast<unsigned char>(*c))) {
+			continue;
+		}
+		int digit = hexDigit(*c);
+		if (digit < 0) {
+			return false;
+		}
+		if (high < 0) {
+			high = digit;
+			continue;
+		}
+		if (size >= max) {
+			return false;
+		}
+		out[size++] = static_cast<uint8_t>((high << 4) | digit);
+		high = -1;
+	}
+
+	return high < 0;
+}
+
+const char* EffectVM::getOpName(uint8_t op) {
+	switch (op) {
+		case EFFECT_END:     return "end";
+		case EFFECT_SET:     return "set";
+		case EFFECT_RAMP:    return "ramp";
+		case EFFECT_HOLD:    return "hold";
+		case EFFECT_RANDOM:  return "random";
+		case EFFECT_LOOP:    return "loop";
+		case EFFECT_JUMP:    return "jump";
+		default:             return "unknown";
+	}
+}
+
+// === Execution ===
+
+void EffectVM::start(State& state, const Program* program, unsigned long now) {
+	state.program = (program && program->length > 0) ? program : nullptr;
+	state.pc = 0;
+	state.waiting = false;
+	state.ramping = false;
+	state.halted = false;
+	memset(state.counters, 0, sizeof(state.counters));
+	state.from = 0;
+	state.to = 0;
+	state.start = now;
+	state.duration = 0;
+}
+
+uint16_t EffectVM::step(State& state, uint16_t level, unsigned long now, Stats* stats) {
+	const Program* program = state.program;
+	if (!program || state.halted) {
+		return level;
+	}
+
+	uint8_t executed = 0;
+	bool overrun = false;
+	for (;;) {
+		if (state.waiting) {
+			uint32_t elapsed = now - state.start;
+			if (elapsed < state.duration) {
+				if (state.ramping) {
+					int32_t delta = static_cast<int32_t>(state.to) - state.from;
+					level = state.from + static_cast<int32_t>(static_cast<int64_t>(delta) * elapsed / state.duration);
+				}
+				break;
+			}
+
+			// Next instruction starts when this one ended, unless far behind
+			if (state.ramping) {
+				level = state.to;
+			}
+			state.waiting = false;
+			state.start = (elapsed - state.duration < RESYNC_MS) ? state.start + state.duration : now;
+		}
+
+		if (executed >= program->budget) {
+			overrun = true;
+			break;
+		}
+
+		const EffectInstruction& ins = program->code[state.pc];
+		executed++;
+
+		switch (ins.op) {
+			case EFFECT_SET:
+				level = ins.value;
+				state.pc++;
+				break;
+
+			case EFFECT_RANDOM:
+				level = randomRange(ins.value, ins.param + 1);
+				state.pc++;
+				break;
+
+			case EFFECT_RAMP:
+			case EFFECT_HOLD: {
+				bool ramp = ins.op == EFFECT_RAMP;
+				uint32_t duration = ramp ? ins.param : ins.value;
+				if (!ramp && ins.param > 0) {
+					duration += randomRange(0, ins.param + 1);
+				}
+				state.pc++;
+				if (duration == 0) {
+					if (ramp) {
+						level = ins.value;
+					}
+					break;
+				}
+				state.waiting = true;
+				state.ramping = ramp;
+				state.from = level;
+				state.to = ramp ? ins.value : level;
+				state.duration = duration;
+				break;
+			}
+
+			case EFFECT_LOOP: {
+				uint16_t& counter = state.counters[ins.arg];
+				if (ins.param == 0 || ++counter < ins.param) {
+					state.pc = ins.value;
+				} else {
+					counter = 0;
+					state.pc++;
+				}
+				break;
+			}
+
+			case EFFECT_JUMP:
+				if (ins.arg >= 100 || (ins.arg > 0 && randomRange(0, 100) < ins.arg)) {
+					state.pc = ins.value;
+				} else {
+					state.pc++;
+				}
+				break;
+
+			default:
+				state.halted = true;
+				break;
+		}
+
+		if (state.halted) {
+			break;
+		}
+	}
+
+	if (stats && executed > 0) {
+		stats->updates++;
+		stats->instructions += executed;
+		if (executed > stats->max_per_update) {
+			stats->max_per_update = executed;
+		}
+		if (overrun) {
+			stats->overruns++;
+		}
+	}
+
+	return level;
+}
@@ -0,0 +1,444 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Jérôme SONRIER
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * @file group.cpp
+ * @brief Implementation of LED groups and scenes
+ *
+ * This file keeps the group bitsets and scene snapshots, and applies the
+ * queued group operations from the main loop.
+ *
+ * See group.h for API documentation.
+ *
+ * @author  Jérôme SONRIER <jsid@emor3j.fr.eu.org>
+ * @date    2025-10-17
+ */
+
+#include "group.h"
+#include "led.h"
+#include "log.h"
+#include "schedule.h"
+#include "storage.h"
+
+
+/// Global instance
+std::unique_ptr<GroupManager> group_manager;
+
+
+// === Constructor ===
+
+GroupManager::GroupManager()
+	: groups_()
+	, scenes_()
+	, pending_action_()
+	, pending_scene_(0)
+	, pending_transition_ms_(0)
+	, pending_easing_(EASING_LINEAR)
+	, pending_group_index_(0)
+	, pending_group_()
+	, pending_led_()
+	, pending_(PendingType::NONE)
+	, stats_() {
+}
+
+// === Groups ===
+
+bool GroupManager::setGroup(uint8_t index, const Group& group) {
+	if (index >= GROUP_MAX) {
+		return false;
+	}
+
+	groups_[index] = group;
+	groups_[index].name[NAME_MAX] = '\0';
+	if (groups_[index].name[0] == '\0') {
+		memset(groups_[index].masks, 0, sizeof(groups_[index].masks));
+	}
+	return true;
+}
+
+const GroupManager::Group* GroupManager::getGroup(uint8_t index) const {
+	if (index >= GROUP_MAX || groups_[index].name[0] == '\0') {
+		return nullptr;
+	}
+	return &groups_[index];
+}
+
+bool GroupManager::setMember(Group& group, uint8_t module_index, uint8_t led_index, bool member) {
+	if (module_index >= PCA9685Module::MODULE_MAX || led_index >= PCA9685Module::LED_MAX) {
+		return false;
+	}
+
+	uint16_t bit = static_cast<uint16_t>(1u << led_index);
+	if (member) {
+		group.masks[module_index] |= bit;
+	} else {
+		group.masks[module_index] &= ~bit;
+	}
+	return true;
+}
+
+uint16_t GroupManager::countMembers(const Group& group) {
+	uint16_t count = 0;
+	for (uint8_t m = 0; m < PCA9685Module::MODULE_MAX; m++) {
+		count += __builtin_popcount(group.masks[m]);
+	}
+	return count;
+}
+
+// === Scenes ===
+
+bool GroupManager::setScene(uint8_t index, const Scene& scene) {
+	if (index >= SCENE_MAX || scene.count > GROUP_MAX) {
+		return false;
+	}
+
+	for (uint8_t i = 0; i < scene.count; i++) {
+		const SceneEntry& entry = scene.entries[i];
+		if (entry.group >= GROUP_MAX || entry.brightness > LED::MAX_BRIGHTNESS || entry.program > PROGRAM_CUSTOM) {
+			return false;
+		}
+	}
+
+	scenes_[index] = scene;
+	scenes_[index].name[NAME_MAX] = '\0';
+	if (scenes_[index].name[0] == '\0') {
+		scenes_[index].count = 0;
+	}
+	return true;
+}
+
+const GroupManager::Scene* GroupManager::getScene(uint8_t index) const {
+	if (index >= SCENE_MAX || scenes_[index].name[0] == '\0') {
+		return nullptr;
+	}
+	return &scenes_[index];
+}
+
+bool GroupManager::captureEntry(uint8_t group, SceneEntry& entry) const {
+	const Group* info = getGroup(group);
+	if (!info || !module_manager) {
+		return false;
+	}
+
+	for (uint8_t m = 0; m < PCA9685Module::MODULE_MAX; m++) {
+		if (!info->masks[m]) {
+			continue;
+		}
+		const LED* led = module_manager->getLED(m, __builtin_ctz(info->masks[m]));
+		if (!led) {
+			continue;
+		}
+		entry.group = group;
+		entry.enabled = led->isEnabled();
+		entry.brightness = led->getBrightness();
+		entry.program = led->getProgramType();
+		return true;
+	}
+	return false;
+}
+
+// === Requests ===
+
+bool GroupManager::requestAction(const Action& action) {
+	if (pending_ != PendingType::NONE || !getGroup(action.group) ||
+		(action.set_brightness && action.brightness > LED::MAX_BRIGHTNESS) ||
+		(action.set_program && action.program > PROGRAM_CUSTOM) ||
+		action.transition_ms > ProgramManager::TRANSITION_MS_MAX || action.easing > EASING_IN_OUT) {
+		return false;
+	}
+
+	pending_action_ = action;
+	pending_ = PendingType::ACTION;
+	return true;
+}
+
+bool GroupManager::requestScene(uint8_t index, uint32_t transition_ms, TransitionEasing easing) {
+	if (pending_ != PendingType::NONE || !getScene(index) || transition_ms > ProgramManager::TRANSITION_MS_MAX) {
+		return false;
+	}
+
+	pending_scene_ = index;
+	pending_transition_ms_ = transition_ms;
+	pending_easing_ = easing;
+	pending_ = PendingType::SCENE;
+	return true;
+}
+
+bool GroupManager::requestGroup(uint8_t index, const Group& group) {
+	if (pending_ != PendingType::NONE || index >= GROUP_MAX) {
+		return false;
+	}
+
+	pending_group_index_ = index;
+	pending_group_ = group;
+	pending_ = PendingType::GROUP;
+	return true;
+}
+
+bool GroupManager::requestLed(const LedUpdate& update) {
+	if (pending_ != PendingType::NONE || !module_manager || !module_manager->getLED(update.module, update.led)) {
+		return false;
+	}
+
+	pending_led_ = update;
+	pending_ = PendingType::LED;
+	return true;
+}
+
+void GroupManager::handle() {
+	PendingType type = pending_;
+	if (type == PendingType::NONE) {
+		return;
+	}
+
+	if (type == PendingType::GROUP) {
+		setGroup(pending_group_index_, pending_group_);
+		StorageManager::save_group(pending_group_index_);
+		if (schedule_manager) {
+			schedule_manager->refreshGroup(pending_group_index_);
+		}
+		pending_ = PendingType::NONE;
+		return;
+	}
+
+	if (type == PendingType::LED) {
+		if (!applyLed(pending_led_)) {
+			LOG_WARNING("[GROUPMGR] LED %d:%d partly updated, its program changed meanwhile\n",
+				pending_led_.module, pending_led_.led);
+		}
+		pending_led_.name = String();
+		pending_ = PendingType::NONE;
+		return;
+	}
+
+	// One transition for the whole request
+	uint32_t transition_ms = (type == PendingType::ACTION) ? pending_action_.transition_ms : pending_transition_ms_;
+	TransitionEasing easing = (type == PendingType::ACTION) ? static_cast<TransitionEasing>(pending_action_.easing) : pending_easing_;
+	
+	unsigned long start = micros();
+	uint8_t transition = transition_ms ? ProgramManager::begin_transition(transition_ms, easing) : 0;
+	uint16_t leds = (type == PendingType::ACTION) ? applyAction(pending_action_, transition) : recallScene(pending_scene_, transition);
+	uint32_t elapsed = micros() - start;
+
+	stats_.operations++;
+	stats_.last_leds = leds;
+	stats_.last_us = elapsed;
+	if (elapsed > stats_.max_us) {
+		stats_.max_us = elapsed;
+	}
+
+	if (type == PendingType::SCENE) {
+		LOG_INFO("[GROUPMGR] Scene %d(%s) recalled: %d LEDs in %lu us\n",
+			pending_scene_, scenes_[pending_scene_].name, leds, static_cast<unsigned long>(elapsed));
+	} else {
+		LOG_DEBUG("[GROUPMGR] Group %d changed: %d LEDs in %lu us\n",
+			pending_action_.group, leds, static_cast<unsigned long>(elapsed));
+	}
+
+	pending_ = PendingType::NONE;
+}
+
+// === Immediate Operations ===
+
+uint16_t GroupManager::applyNow(const Action& action, const uint16_t* masks) {
+	if (!getGroup(action.group) || action.transition_ms > ProgramManager::TRANSITION_MS_MAX) {
+		return 0;
+	}
+
+	TransitionEasing easing = static_cast<TransitionEasing>(action.easing);
+	uint8_t transition = action.transition_ms ? ProgramManager::begin_transition(action.transition_ms, easing) : 0;
+	return applyAction(action, transition, masks);
+}
+
+uint16_t GroupManager::applyNow(const Action& action, const uint16_t* masks, uint8_t transition) {
+	if (!getGroup(action.group)) {
+		return 0;
+	}
+
+	return applyAction(action, transition, masks);
+}
+
+uint16_t GroupManager::recallNow(uint8_t index, uint32_t transition_ms, TransitionEasing easing) {
+	if (!getScene(index) || transition_ms > ProgramManager::TRANSITION_MS_MAX) {
+		return 0;
+	}
+
+	uint8_t transition = transition_ms ? ProgramManager::begin_transition(transition_ms, easing) : 0;
+	return recallScene(index, transition);
+}
+
+uint16_t GroupManager::applyMasksNow(const Action& action, const uint16_t* masks) {
+	if (!module_manager || action.transition_ms > ProgramManager::TRANSITION_MS_MAX) {
+		return 0;
+	}
+
+	TransitionEasing easing = static_cast<TransitionEasing>(action.easing);
+	uint8_t transition = action.transition_ms ? ProgramManager::begin_transition(action.transition_ms, easing) : 0;
+	uint16_t changed = 0;
+	for (uint8_t m = 0; m < module_manager->getModuleCount() && m < PCA9685Module::MODULE_MAX; m++) {
+		if (masks[m]) {
+			changed += applyToModule(action, m, masks[m], transition);
+		}
+	}
+	return changed;
+}
+
+// === Application ===
+
+uint16_t GroupManager::applyAction(const Action& action, uint8_t transition, const uint16_t* masks) {
+	if (action.group >= GROUP_MAX || !module_manager) {
+		return 0;
+	}
+
+	const Group& group = groups_[action.group];
+	uint16_t changed = 0;
+	for (uint8_t m = 0; m < module_manager->getModuleCount() && m < PCA9685Module::MODULE_MAX; m++) {
+		uint16_t mask = masks ? (group.masks[m] & masks[m]) : group.masks[m];
+		if (mask) {
+			changed += applyToModule(action, m, mask, transition);
+		}
+	}
+
+	return changed;
+}
+
+uint16_t GroupManager::applyToModule(const Action& action, uint8_t module_index, uint16_t mask, uint8_t transition) {
+	PCA9685Module* module = module_manager->getModule(module_index);
+	if (!module) {
+		return 0;
+	}
+
+	// Walk the set bits only, program-driven LEDs are written by their program
+	uint16_t apply = 0;
+	uint16_t changed = 0;
+	for (uint16_t bits = mask; bits; bits &= bits - 1) {
+		uint8_t l = __builtin_ctz(bits);
+		LED* led = module->getLED(l);
+		if (!led) {
+			continue;
+		}
+		if (transition) {
+			ProgramManager::add_to_transition(transition, module_index, l);
+		}
+
+		if (action.set_enabled) {
+			led->setEnabled(action.enabled);
+			if (!action.enabled) {
+				led->setBrightness(0);
+			}
+		}
+		if (action.set_program && led->getProgramType() != action.program) {
+			ProgramManager::assign_program(module_index, l, static_cast<ProgramType>(action.program), true);
+		}
+		if (action.set_brightness && led->isEnabled()) {
+			led->setBrightness(action.brightness);
+		}
+
+		if (action.set_enabled || led->getProgramType() == PROGRAM_NONE) {
+			apply |= static_cast<uint16_t>(1u << l);
+		}
+		changed++;
+	}
+
+	if (apply) {
+		module->applyLedMask(apply);
+	}
+	return changed;
+}
+
+uint16_t GroupManager::recallScene(uint8_t index, uint8_t transition) {
+	if (index >= SCENE_MAX) {
+		return 0;
+	}
+
+	const Scene& scene = scenes_[index];
+	uint16_t changed = 0;
+	for (uint8_t i = 0; i < scene.count; i++) {
+		const SceneEntry& entry = scene.entries[i];
+		if (!getGroup(entry.group)) {
+			continue;
+		}
+
+		Action action = {};
+		action.group = entry.group;
+		action.set_enabled = true;
+		action.enabled = entry.enabled;
+		action.set_brightness = true;
+		action.brightness = entry.brightness;
+		action.set_program = true;
+		action.program = entry.program;
+		changed += applyAction(action, transition);
+	}
+
+	return changed;
+}
+
+bool GroupManager::applyLed(const LedUpdate& update) {
+	LED* led = module_manager ? module_manager->getLED(update.module, update.led) : nullptr;
+	if (!led) {
+		return false;
+	}
+
+	// Fade from the current output to whatever the changes below produce
+	if (update.transition_ms > 0) {
+		uint8_t transition = ProgramManager::begin_transition(update.transition_ms, static_cast<TransitionEasing>(update.easing));
+		ProgramManager::add_to_transition(transition, update.module, update.led);
+	}
+
+	if (update.set_name) {
+		led->setName(update.name);
+	}
+	if (update.set_enabled) {
+		led->setEnabled(update.enabled);
+		if (!update.enabled) {
+			led->setBrightness(0);
+		}
+		module_manager->applyLedBrightness(update.module, update.led);
+	}
+
+	if (update.set_program) {
+		// PROGRAM_NONE unassigns
+		ProgramManager::assign_program(update.module, update.led, static_cast<ProgramType>(update.program));
+	}
+	if (update.set_effect) {
+		ProgramManager::assign_effect(update.module, update.led, update.effect_slot);
+	}
+
+	// Parameters and phase were checked against the program this update leaves
+	bool applied = true;
+	if (update.set_params) {
+		applied = ProgramManager::set_program_params(update.module, update.led, update.params) && applied;
+	}
+	if (update.set_phase) {
+		applied = ProgramManager::set_phase_group(update.module, update.led, update.phase_group, update.phase_offset) && applied;
+	}
+
+	if (update.set_curve) {
+		led->setCurve(static_cast<CurveType>(update.curve));
+	}
+	if (update.set_dither) {
+		led->setDither(update.dither);
+	}
+	if ((update.set_curve || update.set_dither) && led->getProgramType() == PROGRAM_NONE && led->isEnabled()) {
+		module_manager->applyLedBrightness(update.module, update.led);
+	}
+
+	// Power budget settings, applied from the next frame
+	if (update.set_rated) {
+		led->setRatedCurrent(update.rated_ma);
+	}
+	if (update.set_priority) {
+		led->setPriority(update.priority);
+		module_manager->applyLedBrightness(update.module, update.led);
+	}
+
+	// Brightness is written only when not program-controlled
+	if (update.set_brightness) {
+		led->setBrightness(update.brightness);
+		if (led->getProgramType() == PROGRAM_NONE && led->isEnabled()) {
+			module_manager->applyLedBrightness(update.module, update.led);
+		}
+	}
+
+	return applied;
+}
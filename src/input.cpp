@@ -0,0 +1,526 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Jérôme SONRIER
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * @file input.cpp
+ * @brief Implementation of the layout inputs and triggers
+ *
+ * This file configures the GPIO inputs and MCP23017 expanders, queues
+ * their edges from the interrupt handlers and applies the trigger table
+ * from the main loop.
+ *
+ * See input.h for API documentation.
+ *
+ * @author  Jérôme SONRIER <jsid@emor3j.fr.eu.org>
+ * @date    2025-10-17
+ */
+
+#include "input.h"
+#include "config.h"
+#include "log.h"
+
+
+/// Global instance
+std::unique_ptr<InputManager> input_manager;
+
+QueueHandle_t InputManager::queue_ = nullptr;
+volatile uint32_t InputManager::overflows_ = 0;
+
+// === MCP23017 Registers (IOCON.BANK = 0, A and B interleaved) ===
+static const uint8_t MCP23017_IODIRA = 0x00;
+static const uint8_t MCP23017_GPINTENA = 0x04;
+static const uint8_t MCP23017_IOCON = 0x0A;
+static const uint8_t MCP23017_GPPUA = 0x0C;
+static const uint8_t MCP23017_GPIOA = 0x12;
+/// IOCON.MIRROR: INTA reports the changes of both ports
+static const uint8_t MCP23017_IOCON_MIRROR = 0x40;
+
+static const char* const EDGE_NAMES[] = {"active", "inactive", "change"};
+static const char* const ACTION_NAMES[] = {"start", "stop", "retrigger", "scene"};
+
+
+// === Constructor and Destructor ===
+
+InputManager::InputManager()
+	: wiring_()
+	, inputs_()
+	, expanders_()
+	, armed_()
+	, due_()
+	, armed_time_us_()
+	, armed_count_(0)
+	, attached_()
+	, contexts_()
+	, pending_wiring_()
+	, pending_(false)
+	, triggered_(false)
+	, stats_() {
+	if (!queue_) {
+		queue_ = xQueueCreate(QUEUE_LENGTH, sizeof(Event));
+	}
+	if (!queue_) {
+		LOG_ERROR("[INPUTMGR] Failed to create the input event queue\n");
+	}
+}
+
+InputManager::~InputManager() {
+	detachAll();
+}
+
+// === Wiring ===
+
+bool InputManager::isValidWiring(const Wiring& wiring, String& error) {
+	if (wiring.expander_count > EXPANDER_MAX || wiring.input_count > INPUT_MAX || wiring.trigger_count > TRIGGER_MAX) {
+		error = "Too many expanders, inputs or triggers";
+		return false;
+	}
+
+	// GPIOs used by the interrupts, each one once
+	uint64_t gpios = 0;
+	for (uint8_t e = 0; e < wiring.expander_count; e++) {
+		const Expander& expander = wiring.expanders[e];
+		if (expander.address < MCP23017_ADDRESS || expander.address > MCP23017_ADDRESS + 7 ||
+			expander.bus >= PCA9685Module::BUS_COUNT) {
+			error = "Invalid expander address or bus";
+			return false;
+		}
+		for (uint8_t other = 0; other < e; other++) {
+			if (wiring.expanders[other].address == expander.address && wiring.expanders[other].bus == expander.bus) {
+				error = "Duplicate expander";
+				return false;
+			}
+		}
+		if (expander.int_pin != INT_PIN_NONE) {
+			if (!config.isFreeInputPin(expander.int_pin) || (gpios & (1ULL << expander.int_pin))) {
+				error = "Invalid or duplicate expander INT pin";
+				return false;
+			}
+			gpios |= 1ULL << expander.int_pin;
+		}
+	}
+
+	uint16_t expander_pins[EXPANDER_MAX] = {};
+	for (uint8_t i = 0; i < wiring.input_count; i++) {
+		const Input& input = wiring.inputs[i];
+		if (input.debounce_ms > DEBOUNCE_MAX_MS) {
+			error = "Invalid debounce time";
+			return false;
+		}
+		if (input.source == SOURCE_GPIO) {
+			if (!config.isFreeInputPin(input.pin) || (gpios & (1ULL << input.pin))) {
+				error = "Invalid or duplicate input GPIO";
+				return false;
+			}
+			gpios |= 1ULL << input.pin;
+		} else {
+			if (input.source >= wiring.expander_count || input.pin >= 16 ||
+				(expander_pins[input.source] & (1u << input.pin))) {
+				error = "Invalid or duplicate expander pin";
+				return false;
+			}
+			expander_pins[input.source] |= 1u << input.pin;
+		}
+	}
+
+	for (uint8_t t = 0; t < wiring.trigger_count; t++) {
+		const Trigger& trigger = wiring.triggers[t];
+		bool scene = static_cast<TriggerAction>(trigger.action) == TRIGGER_SCENE;
+		if (trigger.input >= wiring.input_count || trigger.edge > EDGE_CHANGE || trigger.action > TRIGGER_SCENE ||
+			trigger.target >= (scene ? static_cast<uint8_t>(GroupManager::SCENE_MAX) : static_cast<uint8_t>(GroupManager::GROUP_MAX)) ||
+			trigger.program > PROGRAM_CUSTOM || trigger.delay_ms > DELAY_MAX_MS) {
+			error = "Invalid trigger " + String(t);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool InputManager::setWiring(const Wiring& wiring) {
+	String error;
+	if (!isValidWiring(wiring, error)) {
+		LOG_ERROR("[INPUTMGR] Invalid wiring: %s\n", error.c_str());
+		return false;
+	}
+
+	detachAll();
+	wiring_ = wiring;
+	for (uint8_t i = 0; i < wiring_.input_count; i++) {
+		wiring_.inputs[i].name[NAME_MAX] = '\0';
+	}
+	memset(inputs_, 0, sizeof(inputs_));
+	memset(armed_, 0, sizeof(armed_));
+	armed_count_ = 0;
+
+	// Expanders first, their inputs are read from the port registers
+	for (uint8_t e = 0; e < wiring_.expander_count; e++) {
+		expanders_[e] = ExpanderState();
+		expanders_[e].ready = setupExpander(e);
+		if (!expanders_[e].ready) {
+			LOG_ERROR("[INPUTMGR] MCP23017 0x%02X on bus %d not answering\n", wiring_.expanders[e].address, wiring_.expanders[e].bus);
+		}
+
+		uint8_t int_pin = wiring_.expanders[e].int_pin;
+		if (int_pin != INT_PIN_NONE) {
+			uint8_t source = INPUT_MAX + e;
+			contexts_[source].source = source;
+			contexts_[source].pin = int_pin;
+			pinMode(int_pin, INPUT_PULLUP);
+			attachInterruptArg(int_pin, onInterrupt, &contexts_[source], FALLING);
+			attached_[source] = true;
+		}
+	}
+
+	for (uint8_t i = 0; i < wiring_.input_count; i++) {
+		const Input& input = wiring_.inputs[i];
+		if (input.source == SOURCE_GPIO) {
+			// GPIO 34-39 have no pull-up, active low inputs need an external one there
+			contexts_[i].source = i;
+			contexts_[i].pin = input.pin;
+			pinMode(input.pin, input.active_low ? INPUT_PULLUP : INPUT);
+			attachInterruptArg(input.pin, onInterrupt, &contexts_[i], CHANGE);
+			attached_[i] = true;
+		}
+
+		// Current state taken without firing the triggers
+		inputs_[i].active = readInput(i);
+	}
+
+	// Events of the previous wiring are meaningless now
+	if (queue_) {
+		xQueueReset(queue_);
+	}
+
+	LOG_INFO("[INPUTMGR] %d inputs on %d expanders and GPIOs, %d triggers\n",
+		wiring_.input_count, wiring_.expander_count, wiring_.trigger_count);
+	return true;
+}
+
+bool InputManager::requestWiring(const Wiring& wiring) {
+	String error;
+	if (pending_ || !isValidWiring(wiring, error)) {
+		return false;
+	}
+
+	pending_wiring_ = wiring;
+	pending_ = true;
+	return true;
+}
+
+bool InputManager::isActive(uint8_t index) const {
+	return index < wiring_.input_count && inputs_[index].active;
+}
+
+void InputManager::detachAll() {
+	for (uint8_t i = 0; i < INPUT_MAX + EXPANDER_MAX; i++) {
+		if (attached_[i]) {
+			detachInterrupt(contexts_[i].pin);
+			attached_[i] = false;
+		}
+	}
+}
+
+// === Interrupts ===
+
+void IRAM_ATTR InputManager::onInterrupt(void* arg) {
+	const IsrContext* context = static_cast<const IsrContext*>(arg);
+
+	Event event;
+	event.source = context->source;
+	event.level = digitalRead(context->pin);
+	event.time_us = micros();
+
+	BaseType_t woken = pdFALSE;
+	if (xQueueSendFromISR(queue_, &event, &woken) != pdTRUE) {
+		overflows_ = overflows_ + 1;
+	}
+	if (woken) {
+		portYIELD_FROM_ISR();
+	}
+}
+
+// === Expanders ===
+
+bool InputManager::setupExpander(uint8_t index) {
+	const Expander& expander = wiring_.expanders[index];
+
+	uint16_t used = 0;
+	uint16_t pullups = 0;
+	for (uint8_t i = 0; i < wiring_.input_count; i++) {
+		const Input& input = wiring_.inputs[i];
+		if (input.source == index) {
+			used |= 1u << input.pin;
+			if (input.active_low) {
+				pullups |= 1u << input.pin;
+			}
+		}
+	}
+
+	// Every pin an input, interrupt on any change of the used ones
+	const uint8_t iocon[] = {MCP23017_IOCON, MCP23017_IOCON_MIRROR};
+	const uint8_t iodir[] = {MCP23017_IODIRA, 0xFF, 0xFF};
+	const uint8_t gppu[] = {MCP23017_GPPUA, static_cast<uint8_t>(pullups & 0xFF), static_cast<uint8_t>(pullups >> 8)};
+	const uint8_t gpinten[] = {MCP23017_GPINTENA, static_cast<uint8_t>(used & 0xFF), static_cast<uint8_t>(used >> 8)};
+	const uint8_t* writes[] = {iocon, iodir, gppu, gpinten};
+	const size_t sizes[] = {sizeof(iocon), sizeof(iodir), sizeof(gppu), sizeof(gpinten)};
+
+	// Not the bus task command buffers: the driver serializes with the frame flush
+	i2c_port_t port = static_cast<i2c_port_t>(expander.bus);
+	for (uint8_t w = 0; w < 4; w++) {
+		if (i2c_master_write_to_device(port, expander.address, writes[w], sizes[w],
+			pdMS_TO_TICKS(PCA9685Module::TRANSACTION_TIMEOUT_MS)) != ESP_OK) {
+			return false;
+		}
+	}
+
+	// Reading the ports releases INTA and gives the initial levels
+	uint8_t reg = MCP23017_GPIOA;
+	uint8_t levels[2];
+	if (i2c_master_write_read_device(port, expander.address, &reg, 1, levels, sizeof(levels),
+		pdMS_TO_TICKS(PCA9685Module::TRANSACTION_TIMEOUT_MS)) != ESP_OK) {
+		return false;
+	}
+	expanders_[index].levels = levels[0] | (levels[1] << 8);
+	expanders_[index].last_poll = millis();
+	return true;
+}
+
+void InputManager::readExpander(uint8_t index, uint32_t time_us) {
+	const Expander& expander = wiring_.expanders[index];
+	ExpanderState& state = expanders_[index];
+	state.last_poll = millis();
+
+	uint8_t reg = MCP23017_GPIOA;
+	uint8_t levels[2];
+	if (i2c_master_write_read_device(static_cast<i2c_port_t>(expander.bus), expander.address, &reg, 1, levels, sizeof(levels),
+		pdMS_TO_TICKS(PCA9685Module::TRANSACTION_TIMEOUT_MS)) != ESP_OK) {
+		stats_.expander_errors++;
+		return;
+	}
+
+	uint16_t current = levels[0] | (levels[1] << 8);
+	uint16_t changed = current ^ state.levels;
+	state.levels = current;
+	if (!changed) {
+		return;
+	}
+
+	for (uint8_t i = 0; i < wiring_.input_count; i++) {
+		const Input& input = wiring_.inputs[i];
+		if (input.source == index && (changed & (1u << input.pin))) {
+			onLevel(i, readInput(i), time_us);
+		}
+	}
+}
+
+// === Main Loop ===
+
+bool InputManager::handle() {
+	triggered_ = false;
+
+	if (pending_) {
+		setWiring(pending_wiring_);
+		pending_ = false;
+	}
+
+	// Edges queued by the interrupt handlers since the last iteration
+	Event event;
+	while (queue_ && xQueueReceive(queue_, &event, 0) == pdTRUE) {
+		stats_.interrupts++;
+		if (event.source < wiring_.input_count) {
+			bool high = event.level == HIGH;
+			onLevel(event.source, high != wiring_.inputs[event.source].active_low, event.time_us);
+		} else if (event.source >= INPUT_MAX && event.source - INPUT_MAX < wiring_.expander_count) {
+			readExpander(event.source - INPUT_MAX, event.time_us);
+		}
+	}
+
+	unsigned long now = millis();
+
+	// Expanders without INT line, with INTA still low, or not configured yet
+	for (uint8_t e = 0; e < wiring_.expander_count; e++) {
+		ExpanderState& state = expanders_[e];
+		uint8_t int_pin = wiring_.expanders[e].int_pin;
+		if (!state.ready) {
+			if (now - state.last_poll >= 1000) {
+				state.last_poll = now;
+				state.ready = setupExpander(e);
+			}
+		} else if (int_pin == INT_PIN_NONE ? now - state.last_poll >= POLL_INTERVAL_MS : digitalRead(int_pin) == LOW) {
+			readExpander(e, micros());
+		}
+	}
+
+	// Events lost on a full queue: read every input again
+	uint32_t overflows = overflows_;
+	bool resync = overflows != stats_.overflows;
+	stats_.overflows = overflows;
+
+	// End of the debounce times: catch a change hidden by the lock
+	for (uint8_t i = 0; i < wiring_.input_count; i++) {
+		InputState& state = inputs_[i];
+		if (state.locked && static_cast<long>(now - state.unlock) >= 0) {
+			state.locked = false;
+		} else if (!resync || state.locked) {
+			continue;
+		}
+		onLevel(i, readInput(i), micros());
+	}
+
+	// Delayed triggers
+	for (uint8_t t = 0; t < wiring_.trigger_count && armed_count_ > 0; t++) {
+		if (armed_[t] && static_cast<long>(now - due_[t]) >= 0) {
+			armed_[t] = false;
+			armed_count_--;
+			apply(t, armed_time_us_[t]);
+		}
+	}
+
+	return triggered_;
+}
+
+bool InputManager::readInput(uint8_t index) {
+	const Input& input = wiring_.inputs[index];
+	bool high;
+	if (input.source == SOURCE_GPIO) {
+		high = digitalRead(input.pin) == HIGH;
+	} else {
+		high = expanders_[input.source].levels & (1u << input.pin);
+	}
+	return high != input.active_low;
+}
+
+void InputManager::onLevel(uint8_t index, bool active, uint32_t time_us) {
+	InputState& state = inputs_[index];
+	if (active == state.active) {
+		return;
+	}
+	if (state.locked) {
+		stats_.bounces++;
+		return;
+	}
+
+	// Leading edge taken at once, the lock hides the bounces behind it
+	state.active = active;
+	uint16_t debounce_ms = wiring_.inputs[index].debounce_ms;
+	state.locked = debounce_ms > 0;
+	state.unlock = millis() + debounce_ms;
+	stats_.edges++;
+
+	LOG_DEBUG("[INPUTMGR] Input %d(%s) %s\n", index, wiring_.inputs[index].name, active ? "active" : "inactive");
+	onEdge(index, active, time_us);
+}
+
+void InputManager::onEdge(uint8_t index, bool active, uint32_t time_us) {
+	bool applied = false;
+	for (uint8_t t = 0; t < wiring_.trigger_count; t++) {
+		const Trigger& trigger = wiring_.triggers[t];
+		TriggerEdge edge = static_cast<TriggerEdge>(trigger.edge);
+		if (trigger.input != index || (edge == EDGE_ACTIVE && !active) || (edge == EDGE_INACTIVE && active)) {
+			continue;
+		}
+
+		// Each edge restarts the delay
+		if (trigger.delay_ms > 0) {
+			if (!armed_[t]) {
+				armed_[t] = true;
+				armed_count_++;
+			}
+			due_[t] = millis() + trigger.delay_ms;
+			armed_time_us_[t] = time_us;
+			continue;
+		}
+
+		apply(t, time_us);
+		applied = true;
+	}
+
+	if (applied) {
+		uint32_t latency = micros() - time_us;
+		stats_.last_latency_us = latency;
+		if (latency > stats_.max_latency_us) {
+			stats_.max_latency_us = latency;
+		}
+	}
+}
+
+void InputManager::apply(uint8_t index, uint32_t time_us) {
+	if (!group_manager) {
+		return;
+	}
+
+	const Trigger& trigger = wiring_.triggers[index];
+	TriggerAction type = static_cast<TriggerAction>(trigger.action);
+	GroupManager::Action action = {};
+	action.group = trigger.target;
+
+	if (type == TRIGGER_SCENE) {
+		group_manager->recallNow(trigger.target, 0, EASING_LINEAR);
+	} else if (type == TRIGGER_STOP) {
+		action.set_program = true;
+		action.program = PROGRAM_NONE;
+		action.set_brightness = true;
+		action.brightness = 0;
+		group_manager->applyNow(action);
+	} else {
+		// Starting a group cancels its delayed stops: a second train keeps the crossing running
+		for (uint8_t t = 0; t < wiring_.trigger_count; t++) {
+			const Trigger& other = wiring_.triggers[t];
+			if (armed_[t] && static_cast<TriggerAction>(other.action) == TRIGGER_STOP && other.target == trigger.target) {
+				armed_[t] = false;
+				armed_count_--;
+			}
+		}
+
+		// A new assignment starts the program from its beginning
+		if (type == TRIGGER_RETRIGGER) {
+			GroupManager::Action stop = {};
+			stop.group = trigger.target;
+			stop.set_program = true;
+			stop.program = PROGRAM_NONE;
+			group_manager->applyNow(stop);
+		}
+
+		action.set_enabled = true;
+		action.enabled = true;
+		action.set_program = true;
+		action.program = trigger.program;
+		group_manager->applyNow(action);
+	}
+
+	stats_.triggers++;
+	triggered_ = true;
+
+	LOG_DEBUG("[INPUTMGR] Trigger %d: %s %d, %lu us after the edge\n", index,
+		ACTION_NAMES[trigger.action], trigger.target, static_cast<unsigned long>(micros() - time_us));
+}
+
+// === Names ===
+
+const char* InputManager::getEdgeName(TriggerEdge edge) {
+	return edge <= EDGE_CHANGE ? EDGE_NAMES[edge] : "unknown";
+}
+
+bool InputManager::edgeFromName(const char* name, TriggerEdge& edge) {
+	for (uint8_t i = EDGE_ACTIVE; name && i <= EDGE_CHANGE; i++) {
+		if (strcmp(name, EDGE_NAMES[i]) == 0) {
+			edge = static_cast<TriggerEdge>(i);
+			return true;
+		}
+	}
+	return false;
+}
+
+const char* InputManager::getActionName(TriggerAction action) {
+	return action <= TRIGGER_SCENE ? ACTION_NAMES[action] : "unknown";
+}
+
+bool InputManager::actionFromName(const char* name, TriggerAction& action) {
+	for (uint8_t i = TRIGGER_START; name && i <= TRIGGER_SCENE; i++) {
+		if (strcmp(name, ACTION_NAMES[i]) == 0) {
+			action = static_cast<TriggerAction>(i);
+			return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,278 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Jérôme SONRIER
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * @file layer.cpp
+ * @brief Implementation of the layer stacks
+ *
+ * This file attaches the layer stacks to their channels, runs the overlay
+ * programs and measures the cost of the blending.
+ *
+ * See layer.h for API documentation.
+ *
+ * @author  Jérôme SONRIER <jsid@emor3j.fr.eu.org>
+ * @date    2025-10-17
+ */
+
+#include "layer.h"
+#include "pca9685.h"
+#include "log.h"
+
+
+/// Global instance
+std::unique_ptr<LayerStack> layer_stack;
+
+
+// === Constructor ===
+
+LayerStack::LayerStack()
+	: setup_()
+	, stacks_()
+	, masters_()
+	, pending_setup_()
+	, pending_master_(0)
+	, pending_level_(0)
+	, pending_rounds_(0)
+	, pending_(PendingType::NONE)
+	, bench_() {
+	for (uint8_t i = 0; i < MASTER_MAX; i++) {
+		setup_.masters[i] = LED::MAX_BRIGHTNESS;
+		masters_[i] = LED::MAX_BRIGHTNESS;
+	}
+}
+
+// === Layer Stacks ===
+
+bool LayerStack::isValidSetup(const Setup& setup, String& error) {
+	if (setup.count > STACK_MAX) {
+		error = "Too many layer stacks";
+		return false;
+	}
+	for (uint8_t i = 0; i < MASTER_MAX; i++) {
+		if (setup.masters[i] > LED::MAX_BRIGHTNESS) {
+			error = "Master level out of range";
+			return false;
+		}
+	}
+
+	for (uint8_t i = 0; i < setup.count; i++) {
+		const Layers& layers = setup.stacks[i];
+		if (layers.module >= PCA9685Module::MODULE_MAX || layers.led >= PCA9685Module::LED_MAX) {
+			error = "Channel out of range";
+			return false;
+		}
+		// The overlay LED has no effect slot of its own
+		if (layers.overlay_program >= PROGRAM_CUSTOM || layers.overlay_blend > BLEND_OVERRIDE ||
+			layers.master_blend > BLEND_OVERRIDE || (layers.master != MASTER_NONE && layers.master >= MASTER_MAX)) {
+			error = "Invalid overlay program, master or blend mode";
+			return false;
+		}
+		for (uint8_t j = 0; j < i; j++) {
+			if (setup.stacks[j].module == layers.module && setup.stacks[j].led == layers.led) {
+				error = "Channel with two layer stacks";
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+bool LayerStack::setSetup(const Setup& setup) {
+	String error;
+	if (!isValidSetup(setup, error)) {
+		LOG_ERROR("[LAYERSTACK] %s\n", error.c_str());
+		return false;
+	}
+
+	detach();
+	setup_ = setup;
+	memcpy(masters_, setup.masters, sizeof(masters_));
+
+	uint8_t attached = 0;
+	for (uint8_t i = 0; i < setup_.count; i++) {
+		Stack& stack = stacks_[i];
+		stack.layers = setup_.stacks[i];
+		stack.overlay.setEnabled(true);
+		stack.overlay.setBrightness(0);
+		ProgramManager::start_program(&stack.overlay, static_cast<ProgramType>(stack.layers.overlay_program));
+
+		// Channels of missing modules keep their stack for a later setup
+		LED* led = module_manager ? module_manager->getLED(stack.layers.module, stack.layers.led) : nullptr;
+		if (led) {
+			led->setLayers(i + 1);
+			module_manager->applyLedBrightness(stack.layers.module, stack.layers.led);
+			attached++;
+		}
+	}
+
+	LOG_INFO("[LAYERSTACK] %d layer stacks, %d attached\n", setup_.count, attached);
+	return true;
+}
+
+bool LayerStack::requestSetup(const Setup& setup) {
+	String error;
+	if (pending_ != PendingType::NONE || !isValidSetup(setup, error)) {
+		return false;
+	}
+
+	pending_setup_ = setup;
+	pending_ = PendingType::SETUP;
+	return true;
+}
+
+bool LayerStack::requestMaster(uint8_t index, uint16_t level) {
+	if (pending_ != PendingType::NONE || index >= MASTER_MAX || level > LED::MAX_BRIGHTNESS) {
+		return false;
+	}
+
+	pending_master_ = index;
+	pending_level_ = level;
+	pending_ = PendingType::MASTER;
+	return true;
+}
+
+void LayerStack::detach() {
+	for (uint8_t i = 0; i < setup_.count; i++) {
+		Stack& stack = stacks_[i];
+		ProgramManager::stop_program(&stack.overlay);
+
+		LED* led = module_manager ? module_manager->getLED(stack.layers.module, stack.layers.led) : nullptr;
+		if (led && led->getLayers() == i + 1) {
+			led->setLayers(0);
+			module_manager->applyLedBrightness(stack.layers.module, stack.layers.led);
+		}
+	}
+	setup_.count = 0;
+}
+
+void LayerStack::applyMaster(uint8_t index) {
+	for (uint8_t i = 0; i < setup_.count; i++) {
+		const Layers& layers = stacks_[i].layers;
+		if (layers.master == index) {
+			module_manager->applyLedBrightness(layers.module, layers.led);
+		}
+	}
+}
+
+// === Main Loop ===
+
+void LayerStack::updateOverlays(unsigned long current_millis) {
+	for (uint8_t i = 0; i < setup_.count; i++) {
+		Stack& stack = stacks_[i];
+		if (!stack.overlay.hasProgram()) {
+			continue;
+		}
+
+		// Overlays of disabled channels are not blended, no need to run them
+		const LED* led = module_manager->getLED(stack.layers.module, stack.layers.led);
+		if (led && led->isEnabled()) {
+			ProgramManager::run_program(&stack.overlay, stack.layers.module, stack.layers.led, current_millis);
+		}
+	}
+}
+
+void LayerStack::handle() {
+	PendingType type = pending_;
+	if (type == PendingType::NONE) {
+		return;
+	}
+
+	if (type == PendingType::SETUP) {
+		setSetup(pending_setup_);
+	} else if (type == PendingType::MASTER) {
+		masters_[pending_master_] = pending_level_;
+		applyMaster(pending_master_);
+		LOG_DEBUG("[LAYERSTACK] Master %d set to %d\n", pending_master_, pending_level_);
+	} else if (type == PendingType::BENCH) {
+		runBench(pending_rounds_);
+	}
+
+	pending_ = PendingType::NONE;
+}
+
+// === Benchmark ===
+
+bool LayerStack::requestBench(uint16_t rounds) {
+	if (pending_ != PendingType::NONE || rounds == 0 || rounds > BENCH_ROUNDS_MAX) {
+		return false;
+	}
+
+	pending_rounds_ = rounds;
+	pending_ = PendingType::BENCH;
+	return true;
+}
+
+void LayerStack::runBench(uint16_t rounds) {
+	// Synthetic channels on the stack: the benchmark itself must not allocate
+	Layers layers[STACK_MAX];
+	uint16_t bases[STACK_MAX];
+	uint16_t overlays[STACK_MAX];
+	uint16_t masters[MASTER_MAX];
+	for (uint8_t i = 0; i < MASTER_MAX; i++) {
+		masters[i] = static_cast<uint16_t>(random(LED::MAX_BRIGHTNESS + 1));
+	}
+	for (uint8_t i = 0; i < STACK_MAX; i++) {
+		bases[i] = static_cast<uint16_t>(random(LED::MAX_BRIGHTNESS + 1));
+		overlays[i] = static_cast<uint16_t>(random(LED::MAX_BRIGHTNESS + 1));
+	}
+
+	uint32_t free_heap = ESP.getFreeHeap();
+	uint16_t checksum = 0;
+	for (uint8_t count = 1; count <= LAYER_MAX; count++) {
+		for (uint8_t i = 0; i < STACK_MAX; i++) {
+			layers[i].module = 0;
+			layers[i].led = i % PCA9685Module::LED_MAX;
+			layers[i].overlay_program = count >= 2 ? PROGRAM_CANDLE_FLICKER : PROGRAM_NONE;
+			layers[i].overlay_blend = i % (BLEND_OVERRIDE + 1);
+			layers[i].master = count >= 3 ? i % MASTER_MAX : MASTER_NONE;
+			layers[i].master_blend = (i + 1) % (BLEND_OVERRIDE + 1);
+		}
+
+		uint32_t start = micros();
+		for (uint16_t r = 0; r < rounds; r++) {
+			for (uint8_t i = 0; i < STACK_MAX; i++) {
+				checksum += composeLevels(layers[i], (bases[i] + r) & LED::MAX_BRIGHTNESS, overlays[i], masters);
+			}
+		}
+		bench_.elapsed_us[count - 1] = micros() - start;
+	}
+
+	bench_.rounds = rounds;
+	bench_.heap_delta = static_cast<int32_t>(ESP.getFreeHeap()) - static_cast<int32_t>(free_heap);
+	bench_.checksum = checksum;
+
+	LOG_INFO("[LAYERSTACK] Blend benchmark, %d x %d channels: %lu / %lu / %lu us for 1 / 2 / 3 layers, heap %+ld bytes\n",
+		rounds, STACK_MAX, static_cast<unsigned long>(bench_.elapsed_us[0]), static_cast<unsigned long>(bench_.elapsed_us[1]),
+		static_cast<unsigned long>(bench_.elapsed_us[2]), static_cast<long>(bench_.heap_delta));
+}
+
+// === Names ===
+
+const char* LayerStack::getBlendName(BlendMode mode) {
+	switch (mode) {
+		case BLEND_MAX:
+			return "max";
+		case BLEND_MULTIPLY:
+			return "multiply";
+		case BLEND_ADD:
+			return "add";
+		case BLEND_OVERRIDE:
+			return "override";
+		default:
+			return "unknown";
+	}
+}
+
+bool LayerStack::blendFromName(const char* name, BlendMode& mode) {
+	if (!name) {
+		return false;
+	}
+
+	for (uint8_t m = BLEND_MAX; m <= BLEND_OVERRIDE; m++) {
+		if (strcmp(name, getBlendName(static_cast<BlendMode>(m))) == 0) {
+			mode = static_cast<BlendMode>(m);
+			return true;
+		}
+	}
+	return false;
+}
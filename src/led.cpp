@@ -16,6 +16,7 @@
 #include "led.h"
 #include "config.h"
 #include "program.h"
+#include "layer.h"
 #include "pca9685.h"
 
 
@@ -27,7 +28,15 @@ LED::LED() :
 	brightness_(0),
 	enabled_(false),
 	program_type_(PROGRAM_NONE),
-	program_state_(nullptr) {}
+	program_state_(nullptr),
+	curve_(CURVE_DEFAULT),
+	dither_(false),
+	rated_ma_(0),
+	priority_(0),
+	transition_(0),
+	fade_from_(0),
+	fade_delay_(0),
+	layers_(0) {}
 
 // Parametric constructor
 LED::LED(
@@ -40,7 +49,15 @@ LED::LED(
 	brightness_(brightness),
 	enabled_(enabled),
 	program_type_(program_type),
-	program_state_(program_state) {}
+	program_state_(program_state),
+	curve_(CURVE_DEFAULT),
+	dither_(false),
+	rated_ma_(0),
+	priority_(0),
+	transition_(0),
+	fade_from_(0),
+	fade_delay_(0),
+	layers_(0) {}
 
 // Copy constructor
 LED::LED(const LED& other) :
@@ -48,7 +65,15 @@ LED::LED(const LED& other) :
 	brightness_(other.brightness_),
 	enabled_(other.enabled_),
 	program_type_(other.program_type_),
-	program_state_(nullptr) {}
+	program_state_(nullptr),
+	curve_(other.curve_),
+	dither_(other.dither_),
+	rated_ma_(other.rated_ma_),
+	priority_(other.priority_),
+	transition_(0),
+	fade_from_(0),
+	fade_delay_(0),
+	layers_(0) {}
 
 // Assignment operator
 LED& LED::operator=(const LED& other) {
@@ -58,6 +83,14 @@ LED& LED::operator=(const LED& other) {
 		enabled_ = other.enabled_;
 		program_type_ = other.program_type_;
 		program_state_ = nullptr;
+		curve_ = other.curve_;
+		dither_ = other.dither_;
+		rated_ma_ = other.rated_ma_;
+		priority_ = other.priority_;
+		transition_ = 0;
+		fade_from_ = 0;
+		fade_delay_ = 0;
+		layers_ = 0;
 	}
 
 	return *this;
@@ -84,6 +117,22 @@ void LED::setProgram(ProgramType program_type, ProgramState* program_state) {
 	program_state_ = program_state;
 }
 
+bool LED::setRatedCurrent(uint16_t rated_ma) {
+	if (rated_ma > RATED_MA_MAX) {
+		return false;
+	}
+	rated_ma_ = rated_ma;
+	return true;
+}
+
+bool LED::setPriority(uint8_t priority) {
+	if (priority > PRIORITY_MAX) {
+		return false;
+	}
+	priority_ = priority;
+	return true;
+}
+
 // === Utility Methods ===
 
 float LED::getBrightnessPercent() const {
@@ -110,6 +159,7 @@ void LED::reset() {
 	enabled_ = false;
 	program_type_ = PROGRAM_NONE;
 	program_state_ = nullptr;
+	transition_ = 0;
 }
 
 bool LED::hasProgram() const {
@@ -121,4 +171,19 @@ bool LED::hasProgram() const {
 
 uint16_t LED::getEffectiveBrightness() const {
 	return enabled_ ? brightness_ : 0; 
+}
+
+uint16_t LED::getOutputBrightness() const {
+	uint16_t level = getEffectiveBrightness();
+	if (layers_ && enabled_ && layer_stack) {
+		level = layer_stack->compose(layers_, level);
+	}
+	if (!transition_) {
+		return level;
+	}
+	
+	// |delta| * weight stays below 2^28
+	int32_t weight = ProgramManager::get_transition_weight(transition_, fade_delay_);
+	int32_t delta = static_cast<int32_t>(level) - fade_from_;
+	return fade_from_ + delta * weight / static_cast<int32_t>(ProgramManager::TRANSITION_WEIGHT_ONE);
 }
\ No newline at end of file
@@ -14,6 +14,7 @@
  */
 
 #include "log.h"
+#include "log_sink.h"
 
 // === Static Members ===
 LogManager* LogManager::instance_ = nullptr;
@@ -53,7 +54,13 @@ static SimpleMutex simple_mutex;
 LogManager::LogManager() 
     : buffer_size_(500)
     , current_index_(0)
-    , buffer_full_(false) {
+    , buffer_full_(false)
+    , next_sequence_(1)
+    , buffer_mutex_(xSemaphoreCreateMutex())
+    , default_level_(LogLevel::DEBUG)
+    , tag_level_count_(0)
+    , lowest_level_(LogLevel::DEBUG)
+    , highest_level_(LogLevel::DEBUG) {
     log_buffer_.reserve(buffer_size_);
     temp_buffer_.reserve(512); // Reserve space for formatting
 }
@@ -66,18 +73,24 @@ LogManager& LogManager::getInstance() {
 }
 
 bool LogManager::initialize(size_t buffer_size) {
+    if (buffer_size == 0) {
+        return false;
+    }
     
+    lockBuffer();
     buffer_size_ = buffer_size;
     
     // Reserve buffer space for efficiency
     log_buffer_.clear();
+    log_buffer_.shrink_to_fit();
     log_buffer_.reserve(buffer_size_);
     
     current_index_ = 0;
     buffer_full_ = false;
     temp_buffer_.clear();
+    unlockBuffer();
     
-    return true;
+    return buffer_mutex_ != nullptr;
 }
 
 // === Non-template Logging Methods ===
@@ -101,84 +114,302 @@ void LogManager::log(LogLevel level, const char* message) {
     Serial.flush(); // Forcer l'envoi complet
 }
 
+// === Runtime Level Filtering ===
+
+bool LogManager::setTagLevel(const char* tag, LogLevel level) {
+    if (!tag) {
+        return false;
+    }
+    
+    // Accept both "TAG" and "[TAG]"
+    if (*tag == '[') {
+        tag++;
+    }
+    size_t length = 0;
+    while (tag[length] != '\0' && tag[length] != ']') {
+        length++;
+    }
+    if (length == 0 || length > TAG_LENGTH_MAX) {
+        return false;
+    }
+    
+    lockBuffer();
+    size_t index = findTag(tag, length);
+    if (index == TAG_LEVEL_MAX) {
+        if (tag_level_count_ >= TAG_LEVEL_MAX) {
+            unlockBuffer();
+            return false;
+        }
+        // Filled before it is counted, lookups never see a partial entry
+        index = tag_level_count_;
+        memcpy(tag_levels_[index].tag, tag, length);
+        tag_levels_[index].tag[length] = '\0';
+        tag_level_count_++;
+    }
+    tag_levels_[index].level = level;
+    
+    updateLevelBounds();
+    unlockBuffer();
+    return true;
+}
+
+bool LogManager::clearTagLevel(const char* tag) {
+    if (!tag) {
+        return false;
+    }
+    if (*tag == '[') {
+        tag++;
+    }
+    size_t length = 0;
+    while (tag[length] != '\0' && tag[length] != ']') {
+        length++;
+    }
+    
+    lockBuffer();
+    size_t index = findTag(tag, length);
+    if (index == TAG_LEVEL_MAX) {
+        unlockBuffer();
+        return false;
+    }
+    
+    // Keep the table compact: move the last entry into the freed slot
+    tag_level_count_--;
+    if (index != tag_level_count_) {
+        tag_levels_[index] = tag_levels_[tag_level_count_];
+    }
+    
+    updateLevelBounds();
+    unlockBuffer();
+    return true;
+}
+
+void LogManager::setDefaultLevel(LogLevel level) {
+    lockBuffer();
+    default_level_ = level;
+    updateLevelBounds();
+    unlockBuffer();
+}
+
+size_t LogManager::getTagLevels(TagLevel* out) const {
+    lockBuffer();
+    size_t count = tag_level_count_;
+    memcpy(out, tag_levels_, count * sizeof(TagLevel));
+    unlockBuffer();
+    return count;
+}
+
+bool LogManager::parseLevel(const char* name, LogLevel& level) {
+    if (!name) {
+        return false;
+    }
+    if (strcmp(name, "DEBUG") == 0) {
+        level = LogLevel::DEBUG;
+    } else if (strcmp(name, "INFO") == 0) {
+        level = LogLevel::INFO;
+    } else if (strcmp(name, "WARN") == 0 || strcmp(name, "WARNING") == 0) {
+        level = LogLevel::WARNING;
+    } else if (strcmp(name, "ERROR") == 0) {
+        level = LogLevel::ERROR;
+    } else if (strcmp(name, "NONE") == 0) {
+        level = LogLevel::NONE;
+    } else {
+        return false;
+    }
+    return true;
+}
+
 // === Private Implementation ===
 
+LogLevel LogManager::getLevelForFormat(const char* format) const {
+    if (!format || format[0] != '[' || tag_level_count_ == 0) {
+        return default_level_;
+    }
+    
+    // Tag is the text between the leading '[' and the first ']'
+    const char* tag = format + 1;
+    size_t length = 0;
+    while (length <= TAG_LENGTH_MAX && tag[length] != ']') {
+        if (tag[length] == '\0') {
+            return default_level_;
+        }
+        length++;
+    }
+    if (length > TAG_LENGTH_MAX) {
+        return default_level_;
+    }
+    
+    // clearTagLevel() moves entries around from the web server task
+    lockBuffer();
+    size_t index = findTag(tag, length);
+    LogLevel level = index == TAG_LEVEL_MAX ? default_level_ : tag_levels_[index].level;
+    unlockBuffer();
+    return level;
+}
+
+size_t LogManager::findTag(const char* tag, size_t length) const {
+    for (size_t i = 0; i < tag_level_count_; i++) {
+        if (strncmp(tag_levels_[i].tag, tag, length) == 0 && tag_levels_[i].tag[length] == '\0') {
+            return i;
+        }
+    }
+    return TAG_LEVEL_MAX;
+}
+
+void LogManager::updateLevelBounds() {
+    LogLevel lowest = default_level_;
+    LogLevel highest = default_level_;
+    
+    for (size_t i = 0; i < tag_level_count_; i++) {
+        if (tag_levels_[i].level < lowest) {
+            lowest = tag_levels_[i].level;
+        }
+        if (tag_levels_[i].level > highest) {
+            highest = tag_levels_[i].level;
+        }
+    }
+    
+    lowest_level_ = lowest;
+    highest_level_ = highest;
+}
+
 void LogManager::addLogEntry(LogLevel level, const std::string& message) {
     unsigned long timestamp = millis();
-    LogEntry entry(timestamp, level, message);
     
+    lockBuffer();
     if (log_buffer_.size() < buffer_size_) {
         // Buffer not full yet - just add
-        log_buffer_.push_back(entry);
+        log_buffer_.emplace_back(next_sequence_, timestamp, level, message);
     } else {
-        // Buffer full - circular replacement
-        log_buffer_[current_index_] = entry;
+        // Buffer full - circular replacement, reusing the slot's string storage
+        LogEntry& entry = log_buffer_[current_index_];
+        entry.sequence = next_sequence_;
+        entry.timestamp = timestamp;
+        entry.level = level;
+        entry.message.assign(message);
         current_index_ = (current_index_ + 1) % buffer_size_;
         buffer_full_ = true;
     }
+    
+    // Persistent sinks, under the same lock so their order matches sequences
+    RtcLogTail::append(next_sequence_, timestamp, level, message);
+    if (file_log_sink) {
+        file_log_sink->append(next_sequence_, timestamp, level, message);
+    }
+    next_sequence_++;
+    unlockBuffer();
 }
 
-// === Log Retrieval Implementation ===
+size_t LogManager::physicalIndex(size_t n) const {
+    // Once the buffer is full, current_index_ points to the oldest entry
+    if (log_buffer_.size() < buffer_size_) {
+        return n;
+    }
+    return (current_index_ + n) % buffer_size_;
+}
 
-std::vector<LogEntry> LogManager::getLogs() const {
-    if (!buffer_full_) {
-        // Buffer not full - return in order
-        return log_buffer_;
-    } else {
-        // Buffer full - reconstruct chronological order
-        std::vector<LogEntry> ordered_logs;
-        ordered_logs.reserve(buffer_size_);
-        
-        // Start from oldest entry (current_index_) and wrap around
-        for (size_t i = 0; i < buffer_size_; i++) {
-            size_t index = (current_index_ + i) % buffer_size_;
-            ordered_logs.push_back(log_buffer_[index]);
-        }
-        
-        return ordered_logs;
+void LogManager::lockBuffer() const {
+    // Global constructors may log before the scheduler runs: no locking needed then
+    if (buffer_mutex_ && xTaskGetSchedulerState() == taskSCHEDULER_RUNNING) {
+        xSemaphoreTake(buffer_mutex_, portMAX_DELAY);
     }
 }
 
-std::vector<LogEntry> LogManager::getRecentLogs(size_t count) const {
-    std::vector<LogEntry> all_logs = getLogs();
+void LogManager::unlockBuffer() const {
+    if (buffer_mutex_ && xTaskGetSchedulerState() == taskSCHEDULER_RUNNING) {
+        xSemaphoreGive(buffer_mutex_);
+    }
+}
+
+// === Log Retrieval Implementation ===
+
+std::vector<LogEntry> LogManager::getLogs() const {
+    std::vector<LogEntry> ordered_logs;
     
-    if (count >= all_logs.size()) {
-        return all_logs;
+    lockBuffer();
+    ordered_logs.reserve(log_buffer_.size());
+    for (size_t i = 0; i < log_buffer_.size(); i++) {
+        ordered_logs.push_back(log_buffer_[physicalIndex(i)]);
     }
+    unlockBuffer();
     
-    // Return last 'count' entries
+    return ordered_logs;
+}
+
+std::vector<LogEntry> LogManager::getRecentLogs(size_t count) const {
     std::vector<LogEntry> recent_logs;
-    recent_logs.reserve(count);
     
-    size_t start_index = all_logs.size() - count;
-    for (size_t i = start_index; i < all_logs.size(); i++) {
-        recent_logs.push_back(all_logs[i]);
+    lockBuffer();
+    size_t stored = log_buffer_.size();
+    size_t start = count >= stored ? 0 : stored - count;
+    
+    // Copy only the last 'count' entries
+    recent_logs.reserve(stored - start);
+    for (size_t i = start; i < stored; i++) {
+        recent_logs.push_back(log_buffer_[physicalIndex(i)]);
     }
+    unlockBuffer();
     
     return recent_logs;
 }
 
 std::vector<LogEntry> LogManager::getLogsSince(unsigned long since_timestamp) const {  
-    std::vector<LogEntry> all_logs = getLogs();
     std::vector<LogEntry> filtered_logs;
     
-    for (const auto& entry : all_logs) {
-        if (entry.timestamp > since_timestamp) {
-            filtered_logs.push_back(entry);
-        }
+    lockBuffer();
+    size_t stored = log_buffer_.size();
+    
+    // Timestamps are ordered: walk back from the newest entry to find the start
+    size_t start = stored;
+    while (start > 0 && log_buffer_[physicalIndex(start - 1)].timestamp > since_timestamp) {
+        start--;
     }
     
+    filtered_logs.reserve(stored - start);
+    for (size_t i = start; i < stored; i++) {
+        filtered_logs.push_back(log_buffer_[physicalIndex(i)]);
+    }
+    unlockBuffer();
+    
     return filtered_logs;
 }
 
+size_t LogManager::getLogsAfter(uint32_t cursor, size_t max_count, std::vector<LogEntry>& out) const {
+    lockBuffer();
+    size_t stored = log_buffer_.size();
+    uint32_t oldest_sequence = stored > 0 ? log_buffer_[physicalIndex(0)].sequence : next_sequence_;
+    
+    // Sequences are contiguous in the buffer: the start position is computed directly
+    size_t start = cursor < oldest_sequence ? 0 : cursor - oldest_sequence + 1;
+    if (start > stored) {
+        start = stored;
+    }
+    size_t count = stored - start;
+    if (count > max_count) {
+        count = max_count;
+    }
+    
+    out.reserve(out.size() + count);
+    for (size_t i = start; i < start + count; i++) {
+        out.push_back(log_buffer_[physicalIndex(i)]);
+    }
+    unlockBuffer();
+    
+    return count;
+}
+
 void LogManager::clearLogs() {   
+    // Sequence numbers keep increasing so that stream cursors stay valid
+    lockBuffer();
     log_buffer_.clear();
     current_index_ = 0;
     buffer_full_ = false;
+    unlockBuffer();
 }
 
 void LogManager::getBufferStats(size_t& total_entries, uint8_t& buffer_utilization) const {
-    total_entries = buffer_full_ ? buffer_size_ : log_buffer_.size();
+    lockBuffer();
+    total_entries = log_buffer_.size();
+    unlockBuffer();
     buffer_utilization = (total_entries * 100) / buffer_size_;
 }
 
@@ -188,6 +419,7 @@ const char* LogManager::getLevelString(LogLevel level) {
 		case LogLevel::INFO:    return "INFO";
 		case LogLevel::WARNING: return "WARN";
 		case LogLevel::ERROR:   return "ERROR";
+		case LogLevel::NONE:    return "NONE";
 		default:                return "UNKNOWN";
 	}
 }
\ No newline at end of file
@@ -0,0 +1,392 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Jérôme SONRIER
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * @file log_sink.cpp
+ * @brief Implementation of the persistent log sinks
+ *
+ * This file implements the RTC memory log tail and the LittleFS
+ * rotating log file.
+ *
+ * See log_sink.h for API documentation.
+ *
+ * @author  Jérôme SONRIER <jsid@emor3j.fr.eu.org>
+ * @date    2025-10-17
+ */
+
+#include "log_sink.h"
+
+/// Global file log sink instance
+std::unique_ptr<FileLogSink> file_log_sink;
+
+// === RTC Log Tail ===
+
+/// Marker of a valid RTC log area ("RLOG")
+static constexpr uint32_t RTC_LOG_MAGIC = 0x524C4F47;
+
+/**
+ * @struct RtcLogRecord
+ * @brief One log entry stored in RTC memory
+ */
+struct RtcLogRecord {
+	uint32_t sequence;					///< Entry sequence number
+	uint32_t timestamp;					///< Timestamp in milliseconds since boot
+	uint8_t level;						///< Log level
+	char message[RtcLogTail::MESSAGE_MAX + 1];		///< Truncated, null terminated message
+};
+
+/**
+ * @struct RtcLogArea
+ * @brief Ring of log entries stored in RTC memory
+ */
+struct RtcLogArea {
+	uint32_t magic;						///< RTC_LOG_MAGIC when the area is valid
+	uint32_t boot_count;					///< Boots since the last power-on
+	uint32_t head;						///< Next slot to write
+	uint32_t count;						///< Number of used slots
+	RtcLogRecord records[RtcLogTail::SLOT_COUNT];		///< Entry slots
+	uint32_t check;						///< Inverted XOR of the header fields
+};
+
+/// Live ring, not initialized by the bootloader so it survives resets
+RTC_NOINIT_ATTR static RtcLogArea rtc_log_area;
+/// Copy of the previous boot ring, taken before it is reused
+static RtcLogArea rtc_previous_area;
+/// Whether rtc_previous_area holds a valid tail
+static bool rtc_previous_valid = false;
+/// Whether begin() already ran for this boot
+static bool rtc_started = false;
+/// Reset reason of the current boot
+static esp_reset_reason_t rtc_reset_reason = ESP_RST_UNKNOWN;
+
+/**
+ * @brief Compute the consistency word of an RTC area
+ * @param area RTC area
+ * @return Expected value of area.check
+ */
+static uint32_t rtcAreaCheck(const RtcLogArea& area) {
+	return ~(area.magic ^ area.boot_count ^ area.head ^ area.count);
+}
+
+/**
+ * @brief Check that an RTC area was written by this firmware
+ * @param area RTC area
+ * @return true if the header is consistent
+ */
+static bool rtcAreaValid(const RtcLogArea& area) {
+	return area.magic == RTC_LOG_MAGIC &&
+		area.head < RtcLogTail::SLOT_COUNT &&
+		area.count <= RtcLogTail::SLOT_COUNT &&
+		area.check == rtcAreaCheck(area);
+}
+
+void RtcLogTail::begin() {
+	if (rtc_started) {
+		return;
+	}
+	rtc_started = true;
+	rtc_reset_reason = esp_reset_reason();
+
+	// RTC memory content is random after a power-on
+	bool valid = rtc_reset_reason != ESP_RST_POWERON && rtcAreaValid(rtc_log_area);
+	uint32_t boot_count = 1;
+
+	if (valid) {
+		rtc_previous_area = rtc_log_area;
+		rtc_previous_valid = rtc_previous_area.count > 0;
+		boot_count = rtc_log_area.boot_count + 1;
+	}
+
+	rtc_log_area.magic = RTC_LOG_MAGIC;
+	rtc_log_area.boot_count = boot_count;
+	rtc_log_area.head = 0;
+	rtc_log_area.count = 0;
+	rtc_log_area.check = rtcAreaCheck(rtc_log_area);
+}
+
+void RtcLogTail::append(uint32_t sequence, unsigned long timestamp, LogLevel level, const std::string& message) {
+	if (!rtc_started) {
+		begin();
+	}
+
+	RtcLogRecord& record = rtc_log_area.records[rtc_log_area.head];
+	record.sequence = sequence;
+	record.timestamp = timestamp;
+	record.level = static_cast<uint8_t>(level);
+
+	size_t length = message.length();
+	if (length > MESSAGE_MAX) {
+		length = MESSAGE_MAX;
+	}
+	memcpy(record.message, message.data(), length);
+	record.message[length] = '\0';
+
+	// Header is updated last so a reset in the middle leaves a consistent ring
+	uint32_t head = rtc_log_area.head + 1;
+	rtc_log_area.head = head < SLOT_COUNT ? head : 0;
+	if (rtc_log_area.count < SLOT_COUNT) {
+		rtc_log_area.count++;
+	}
+	rtc_log_area.check = rtcAreaCheck(rtc_log_area);
+}
+
+bool RtcLogTail::hasPreviousBoot() {
+	begin();
+	return rtc_previous_valid;
+}
+
+size_t RtcLogTail::getPreviousBoot(std::vector<LogEntry>& out) {
+	if (!hasPreviousBoot()) {
+		return 0;
+	}
+
+	const RtcLogArea& area = rtc_previous_area;
+	size_t first = (area.head + SLOT_COUNT - area.count) % SLOT_COUNT;
+	out.reserve(out.size() + area.count);
+
+	for (size_t i = 0; i < area.count; i++) {
+		const RtcLogRecord& record = area.records[(first + i) % SLOT_COUNT];
+		uint8_t level = record.level <= static_cast<uint8_t>(LogLevel::ERROR) ? record.level : static_cast<uint8_t>(LogLevel::INFO);
+
+		// The message may be unterminated if the reset hit in the middle of a write
+		std::string message(record.message, strnlen(record.message, MESSAGE_MAX));
+		out.emplace_back(record.sequence, record.timestamp, static_cast<LogLevel>(level), message);
+	}
+
+	return area.count;
+}
+
+esp_reset_reason_t RtcLogTail::getResetReason() {
+	begin();
+	return rtc_reset_reason;
+}
+
+const char* RtcLogTail::getResetReasonString(esp_reset_reason_t reason) {
+	switch (reason) {
+		case ESP_RST_POWERON:	return "POWERON";
+		case ESP_RST_EXT:	return "EXTERNAL";
+		case ESP_RST_SW:	return "SOFTWARE";
+		case ESP_RST_PANIC:	return "PANIC";
+		case ESP_RST_INT_WDT:	return "INT_WDT";
+		case ESP_RST_TASK_WDT:	return "TASK_WDT";
+		case ESP_RST_WDT:	return "WDT";
+		case ESP_RST_DEEPSLEEP:	return "DEEPSLEEP";
+		case ESP_RST_BROWNOUT:	return "BROWNOUT";
+		case ESP_RST_SDIO:	return "SDIO";
+		default:		return "UNKNOWN";
+	}
+}
+
+uint32_t RtcLogTail::getBootCount() {
+	begin();
+	return rtc_log_area.boot_count;
+}
+
+// === File Log Sink ===
+
+const char* FileLogSink::DIRECTORY = "/logs";
+const char* FileLogSink::CURRENT_PATH = "/logs/current.log";
+const char* FileLogSink::PREVIOUS_PATH = "/logs/previous.log";
+
+FileLogSink::FileLogSink() :
+	fill_{0, 0},
+	active_(0),
+	pending_(false),
+	mutex_(xSemaphoreCreateMutex()),
+	task_(nullptr),
+	stop_requested_(false),
+	dropped_(0),
+	written_bytes_(0) {
+}
+
+FileLogSink::~FileLogSink() {
+	end();
+	if (mutex_) {
+		vSemaphoreDelete(mutex_);
+	}
+}
+
+bool FileLogSink::begin() {
+	if (task_) {
+		return !stop_requested_;
+	}
+
+	if (!mutex_) {
+		LOG_ERROR("[LOGFILE] Failed to create mutex\n");
+		return false;
+	}
+
+	// Mounting twice is harmless if the web server already did it
+	if (!LittleFS.begin()) {
+		LOG_ERROR("[LOGFILE] Failed to mount LittleFS\n");
+		return false;
+	}
+
+	if (!LittleFS.exists(DIRECTORY)) {
+		LittleFS.mkdir(DIRECTORY);
+	}
+
+	file_ = LittleFS.open(CURRENT_PATH, "a");
+	if (!file_) {
+		LOG_ERROR("[LOGFILE] Failed to open %s\n", CURRENT_PATH);
+		return false;
+	}
+
+	if (!blocks_) {
+		blocks_.reset(new char[2 * BLOCK_SIZE]);
+	}
+	fill_[0] = 0;
+	fill_[1] = 0;
+	active_ = 0;
+	pending_ = false;
+	stop_requested_ = false;
+
+	// Low priority, on the core not running loop()
+	if (xTaskCreatePinnedToCore(taskEntry, "log_file", 4096, this, 1, &task_, 0) != pdPASS) {
+		task_ = nullptr;
+		file_.close();
+		LOG_ERROR("[LOGFILE] Failed to create writer task\n");
+		return false;
+	}
+
+	LOG_INFO("[LOGFILE] Writing logs to %s\n", CURRENT_PATH);
+	return true;
+}
+
+void FileLogSink::end() {
+	if (!task_) {
+		return;
+	}
+
+	// The task writes what is left, closes the file and clears task_
+	requestStop();
+	while (task_) {
+		vTaskDelay(pdMS_TO_TICKS(10));
+	}
+
+	LOG_INFO("[LOGFILE] Stopped\n");
+}
+
+void FileLogSink::requestStop() {
+	// The task clears task_ under the mutex before deleting itself
+	xSemaphoreTake(mutex_, portMAX_DELAY);
+	if (task_ && !stop_requested_) {
+		stop_requested_ = true;
+		xTaskNotifyGive(task_);
+	}
+	xSemaphoreGive(mutex_);
+}
+
+void FileLogSink::append(uint32_t sequence, unsigned long timestamp, LogLevel level, const std::string& message) {
+	if (!task_ || stop_requested_) {
+		return;
+	}
+
+	char header[40];
+	int header_length = snprintf(header, sizeof(header), "%lu %lu %s ",
+		(unsigned long)sequence, timestamp, LogManager::getLevelString(level));
+	if (header_length <= 0) {
+		return;
+	}
+
+	size_t message_length = message.length();
+	bool add_newline = message_length == 0 || message[message_length - 1] != '\n';
+	size_t needed = header_length + message_length + (add_newline ? 1 : 0);
+	if (needed > BLOCK_SIZE) {
+		message_length = BLOCK_SIZE - header_length - 1;
+		add_newline = true;
+		needed = BLOCK_SIZE;
+	}
+
+	xSemaphoreTake(mutex_, portMAX_DELAY);
+
+	// Checked again under the mutex: once stopping, the final write may be done
+	if (!task_ || stop_requested_) {
+		xSemaphoreGive(mutex_);
+		return;
+	}
+
+	if (fill_[active_] + needed > BLOCK_SIZE) {
+		if (pending_) {
+			// Writer still busy with the other block: drop rather than wait
+			dropped_++;
+			xSemaphoreGive(mutex_);
+			return;
+		}
+		pending_ = true;
+		active_ ^= 1;
+		xTaskNotifyGive(task_);
+	}
+
+	char* dest = blocks_.get() + active_ * BLOCK_SIZE + fill_[active_];
+	memcpy(dest, header, header_length);
+	memcpy(dest + header_length, message.data(), message_length);
+	if (add_newline) {
+		dest[header_length + message_length] = '\n';
+	}
+	fill_[active_] += needed;
+	xSemaphoreGive(mutex_);
+}
+
+void FileLogSink::taskEntry(void* param) {
+	static_cast<FileLogSink*>(param)->taskLoop();
+}
+
+void FileLogSink::taskLoop() {
+	while (!stop_requested_) {
+		// Woken by a full block, or periodically for partial blocks
+		uint32_t notified = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(FLUSH_INTERVAL_MS));
+		writePending(notified == 0 || stop_requested_);
+	}
+
+	// Both blocks may hold data when stopping
+	writePending(true);
+	writePending(true);
+	file_.close();
+
+	// No append() or requestStop() holds the handle past this point
+	xSemaphoreTake(mutex_, portMAX_DELAY);
+	task_ = nullptr;
+	xSemaphoreGive(mutex_);
+	vTaskDelete(NULL);
+}
+
+void FileLogSink::writePending(bool force) {
+	xSemaphoreTake(mutex_, portMAX_DELAY);
+	if (!pending_ && force && fill_[active_] > 0) {
+		pending_ = true;
+		active_ ^= 1;
+	}
+	bool write = pending_;
+	uint8_t block = active_ ^ 1;
+	size_t length = fill_[block];
+	xSemaphoreGive(mutex_);
+
+	if (!write) {
+		return;
+	}
+
+	// The pending block is not touched by append() until pending_ is cleared
+	if (length > 0 && file_) {
+		size_t written = file_.write(reinterpret_cast<const uint8_t*>(blocks_.get() + block * BLOCK_SIZE), length);
+		file_.flush();
+		written_bytes_ += written;
+		rotateIfNeeded();
+	}
+
+	xSemaphoreTake(mutex_, portMAX_DELAY);
+	fill_[block] = 0;
+	pending_ = false;
+	xSemaphoreGive(mutex_);
+}
+
+void FileLogSink::rotateIfNeeded() {
+	if (file_.size() < FILE_SIZE_MAX) {
+		return;
+	}
+
+	file_.close();
+	LittleFS.remove(PREVIOUS_PATH);
+	LittleFS.rename(CURRENT_PATH, PREVIOUS_PATH);
+	file_ = LittleFS.open(CURRENT_PATH, "a");
+}
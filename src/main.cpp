@@ -39,7 +39,13 @@
 #include "pca9685.h"
 #include "web_server.h"
 #include "program.h"
+#include "group.h"
+#include "schedule.h"
+#include "input.h"
+#include "show.h"
+#include "layer.h"
 #include "log.h"
+#include "log_sink.h"
 
 
 PCA9685Module* pca_modules;
@@ -56,9 +62,18 @@ void setup_i2c() {
 	LOG_INFO("[I2CBUS] Setting up I2C...\n");
 	
 	Wire.begin(config.getI2cSdaPin(), config.getI2cSclPin());
-	Wire.setClock(100000); // 100kHz for reliable communication
+	// Scan and init at 100kHz, ModuleManager then negotiates up to config.getI2cClockHz()
+	Wire.setClock(Config::I2C_CLOCK_STANDARD);
 	
 	LOG_INFO("[I2CBUS] I2C initialized - SDA: %d, SCL: %d\n", config.getI2cSdaPin(), config.getI2cSclPin());
+	
+	// Optional second bus on the other I2C controller
+	if (config.isI2c1Enabled()) {
+		Wire1.begin(config.getI2c1SdaPin(), config.getI2c1SclPin());
+		Wire1.setClock(Config::I2C_CLOCK_STANDARD);
+		
+		LOG_INFO("[I2CBUS] I2C bus 1 initialized - SDA: %d, SCL: %d\n", config.getI2c1SdaPin(), config.getI2c1SclPin());
+	}
 }
 
 void print_system_info() {
@@ -101,6 +116,13 @@ void setup() {
 		LOG_ERROR("[MAIN] Warning: LogManager initialization failed\n");
 	}
 	
+	// Report why we restarted; the previous boot tail is readable via /api/logs?source=rtc
+	LOG_INFO("[MAIN] Reset reason: %s (boot %u since power-on)\n",
+		RtcLogTail::getResetReasonString(RtcLogTail::getResetReason()), RtcLogTail::getBootCount());
+	if (RtcLogTail::hasPreviousBoot()) {
+		LOG_WARNING("[MAIN] Log tail of the previous boot recovered from RTC memory\n");
+	}
+	
 	LOG_INFO("=== INFORMATIONS SYSTÈME ESP32 ===\n");
 	
 	// ===== INFORMATIONS CHIP =====
@@ -179,9 +201,6 @@ void setup() {
 	// ===== CONFIGURATION =====
 	config.printConfiguration();
 
-	// Setup I2C bus
-	setup_i2c();
-
 	// Initialize storage manager
 	program_manager.reset(new ProgramManager());
 	if (storage_manager->initialize()) {
@@ -190,31 +209,48 @@ void setup() {
 		LOG_ERROR("[MAIN] Storage manager initialization failed\n");
 	}
 
+	// Start the LittleFS log file if enabled
+	file_log_sink.reset(new FileLogSink());
+	if (StorageManager::load_log_file_enabled()) {
+		file_log_sink->begin();
+	}
+
+	// Load I2C bus settings, then setup I2C buses
+	StorageManager::load_i2c_config();
+	StorageManager::load_curve_config();
+	StorageManager::load_power_config();
+	LOG_INFO("[MAIN] %d user effects loaded\n", StorageManager::load_effects());
+	setup_i2c();
+
 	// Setup PCA9685 modules
 	module_manager.reset(new ModuleManager());
 	if (module_manager->initialize()) {
 		LOG_INFO("[MAIN] PCA9685 modules initialized successfully\n");
-		LOG_INFO("[MAIN] Loading saved modules configurations...\n");
-		for (int i = 0; i < module_manager->getModuleCount(); i++) {
-			const PCA9685Module* module = module_manager->getModule(i);
-			if (module && module->isInitialized()) {
-				LOG_INFO("[MAIN] Loading module %d configuration\n", i);
-				storage_manager->load_module_config(i);
-
-				// Load LED configs for this module
-				LOG_INFO("[MAIN] Loading saved LEDs configurations for module %d...\n", i);
-				for (int j = 0; j < module->getLedCount(); j++) {
-					storage_manager->load_led_config(i, j);
-				}
-			} else {
-				LOG_WARNING("[MAIN] Skipping configuration load for module %d (not initialized)\n", i);
-			}
-		}
-		module_manager->printModuleInfo();
 	} else {
 		LOG_ERROR("[MAIN] PCA9685 modules initialization failed\n");
 	}
 
+	// Missing modules keep their configuration until they are plugged again
+	LOG_INFO("[MAIN] Loading saved modules configurations...\n");
+	for (int i = 0; i < module_manager->getModuleCount(); i++) {
+		const PCA9685Module* module = module_manager->getModule(i);
+		if (module) {
+			if (!module->isInitialized()) {
+				LOG_WARNING("[MAIN] Module %d not initialized, configuration kept for hot-plug\n", i);
+			}
+			LOG_INFO("[MAIN] Loading module %d configuration\n", i);
+			storage_manager->load_module_config(i);
+
+			// Load LED configs for this module
+			LOG_INFO("[MAIN] Loading saved LEDs configurations for module %d...\n", i);
+			for (int j = 0; j < module->getLedCount(); j++) {
+				storage_manager->load_led_config(i, j);
+			}
+		}
+	}
+	module_manager->applyBroadcastGroups();
+	module_manager->printModuleInfo();
+
 	// Initialize program manager
 	program_manager.reset(new ProgramManager());
 	if (program_manager->initialize()) {
@@ -223,6 +259,29 @@ void setup() {
 		LOG_ERROR("[MAIN] Program manager initialization failed\n");
 	}
 
+	// Overlay programs and masters blended over the LED channels
+	layer_stack.reset(new LayerStack());
+	if (!StorageManager::load_layers()) {
+		LOG_INFO("[MAIN] No layer stacks saved\n");
+	}
+
+	// LED groups and scenes
+	group_manager.reset(new GroupManager());
+	LOG_INFO("[MAIN] %d LED groups and scenes loaded\n", StorageManager::load_groups());
+
+	// Model clock and schedules
+	schedule_manager.reset(new ScheduleManager());
+	LOG_INFO("[MAIN] %d schedule events loaded\n", StorageManager::load_schedule());
+
+	// Layout inputs and their triggers
+	input_manager.reset(new InputManager());
+	if (!StorageManager::load_inputs()) {
+		LOG_INFO("[MAIN] No input wiring saved\n");
+	}
+
+	// Scripted shows, started from the web interface
+	show_player.reset(new ShowPlayer());
+
 	// Setup WiFi connection with storage-based credentials
 	network_manager.reset(new NetworkManager());
 
@@ -316,16 +375,37 @@ void setup() {
 void loop() {
     	unsigned long currentMillis = millis();
 
+	// === Inputs: triggers applied within this frame ===
+	bool triggered = input_manager->handle();
+
 	// === Program Manager Update ===
 	static unsigned long lastProgramUpdate = 0;
-	if (currentMillis - lastProgramUpdate >= 10) { // Update à 100Hz pour fluidité
+	if (triggered || currentMillis - lastProgramUpdate >= 10) { // Update à 100Hz pour fluidité, à chaque déclenchement
 		program_manager->update(currentMillis);
 		lastProgramUpdate = currentMillis;
 	}
+
+	// === Model clock schedules, applied with the group operations ===
+	schedule_manager->handle();
+
+	// === Show events due in this frame ===
+	show_player->handle();
+
+	// === Group operations and scene recalls, flushed with this frame ===
+	group_manager->handle();
+
+	// === Layer stacks and master levels, blended when the frame is built ===
+	layer_stack->handle();
+
+	// === Module Manager (bus speed negotiation, frame flush) ===
+	module_manager->handle();
 	
 	// === Check OTA ===
 	ota_manager->handle();
 
+	// === Push new log lines to stream clients ===
+	web_server.handle();
+
 	// === Handle DNS requests for captive portal ===
 	if (captive_dns_server && captive_dns_server->isActive()) {
 		captive_dns_server->handleRequests();
@@ -14,6 +14,9 @@
  * @date    2025-09-10
  */
 
+#include <algorithm>
+#include <cstring>
+
 #include "pca9685.h"
 #include "config.h"
 #include "storage.h"
@@ -24,6 +27,32 @@
 // Global instance
 std::unique_ptr<ModuleManager> module_manager;
 
+/// Command link buffer size for one write or write/read transaction
+static constexpr size_t CMD_BUFFER_SIZE = I2C_LINK_RECOMMENDED_SIZE(2);
+
+/// Native driver command link buffers, one per bus (each bus is flushed by a single task)
+alignas(4) static uint8_t bus_cmd_buffers[PCA9685Module::BUS_COUNT][CMD_BUFFER_SIZE];
+
+/// Native driver burst buffers: register address + 4 registers per channel
+alignas(4) static uint8_t bus_tx_buffers[PCA9685Module::BUS_COUNT][1 + 4 * PCA9685Module::LED_MAX];
+
+/**
+ * @brief Store ON/OFF counts as the 4 LEDn registers, low byte first
+ */
+static inline void encodeFrameChannel(uint8_t* regs, uint16_t on, uint16_t off) {
+	regs[0] = on & 0xFF;
+	regs[1] = on >> 8;
+	regs[2] = off & 0xFF;
+	regs[3] = off >> 8;
+}
+
+/// Bus speeds tried at bring-up, fastest first
+static const uint32_t BUS_SPEEDS[ModuleManager::BUS_SPEED_COUNT] = {
+	Config::I2C_CLOCK_FAST_PLUS,
+	Config::I2C_CLOCK_FAST,
+	Config::I2C_CLOCK_STANDARD
+};
+
 // =============================================================================
 // PCA9685Module Implementation
 // =============================================================================
@@ -31,16 +60,46 @@ std::unique_ptr<ModuleManager> module_manager;
 // === Constructor and Destructor ===
 
 // Default constructor
-PCA9685Module::PCA9685Module(uint8_t address, uint8_t led_count) :
+PCA9685Module::PCA9685Module(uint8_t address, uint8_t led_count, uint8_t bus) :
 	address_(address),
+	bus_(bus),
+	wire_(&getBusWire(bus)),
 	detected_(false),
 	initialized_(false),
 	name_(generateDefaultName()),
 	led_count_(led_count),
 	leds_(nullptr),
-	driver_(nullptr) {
+	driver_(nullptr),
+	dirty_mask_(0),
+	driver_type_(Driver::NATIVE),
+	broadcast_groups_(0),
+	broadcast_hold_(false),
+	phase_offsets_(),
+	frame_mask_(0),
+	health_(Health::OK),
+	health_stats_(),
+	expected_mode1_(MODE1_DEFAULT),
+	backoff_ms_(0),
+	retry_at_(0),
+	pwm_frequency_(PWM_FREQUENCY),
+	oscillator_hz_(OSCILLATOR_FREQUENCY),
+	camera_mode_(false),
+	prescale_(0),
+	curve_(CURVE_DEFAULT),
+	dither_error_(),
+	dither_mask_(0),
+	rated_ma_(RATED_MA_DEFAULT),
+	power_demand_() {
 	// Allocate LED array
 	leds_.reset(new LED[led_count]);
+	
+	// Output frame starts as the power-on state: every channel full off
+	for (uint8_t i = 0; i < LED_MAX; i++) {
+		encodeFrameChannel(frame_regs_[i], 0, PWM_STEPS);
+	}
+	for (uint8_t i = 0; i < POWER_PRIORITIES; i++) {
+		power_scale_[i] = POWER_SCALE_ONE;
+	}
 }
 
 // Destructor
@@ -51,12 +110,36 @@ PCA9685Module::~PCA9685Module() {
 // Move constructor
 PCA9685Module::PCA9685Module(PCA9685Module&& other) noexcept :
 	address_(other.address_),
+	bus_(other.bus_),
+	wire_(other.wire_),
 	detected_(other.detected_),
 	initialized_(other.initialized_),
 	name_(std::move(other.name_)),
 	led_count_(other.led_count_),
 	leds_(std::move(other.leds_)),
-	driver_(std::move(other.driver_)) {
+	driver_(std::move(other.driver_)),
+	dirty_mask_(other.dirty_mask_.exchange(0)),
+	driver_type_(other.driver_type_),
+	broadcast_groups_(other.broadcast_groups_),
+	broadcast_hold_(other.broadcast_hold_) {
+	memcpy(phase_offsets_, other.phase_offsets_, sizeof(phase_offsets_));
+	memcpy(frame_regs_, other.frame_regs_, sizeof(frame_regs_));
+	frame_mask_ = other.frame_mask_;
+	health_ = other.health_;
+	health_stats_ = other.health_stats_;
+	expected_mode1_ = other.expected_mode1_;
+	backoff_ms_ = other.backoff_ms_;
+	retry_at_ = other.retry_at_;
+	pwm_frequency_ = other.pwm_frequency_;
+	oscillator_hz_ = other.oscillator_hz_;
+	camera_mode_ = other.camera_mode_;
+	prescale_ = other.prescale_;
+	curve_ = other.curve_;
+	memcpy(dither_error_, other.dither_error_, sizeof(dither_error_));
+	dither_mask_ = other.dither_mask_;
+	rated_ma_ = other.rated_ma_;
+	memcpy(power_demand_, other.power_demand_, sizeof(power_demand_));
+	memcpy(power_scale_, other.power_scale_, sizeof(power_scale_));
 	// Reset other object
 	other.address_ = 0;
 	other.detected_ = false;
@@ -68,12 +151,36 @@ PCA9685Module::PCA9685Module(PCA9685Module&& other) noexcept :
 PCA9685Module& PCA9685Module::operator=(PCA9685Module&& other) noexcept {
 	if (this != &other) {
 		address_ = other.address_;
+		bus_ = other.bus_;
+		wire_ = other.wire_;
 		detected_ = other.detected_;
 		initialized_ = other.initialized_;
 		name_ = std::move(other.name_);
 		led_count_ = other.led_count_;
 		leds_ = std::move(other.leds_);
 		driver_ = std::move(other.driver_);
+		dirty_mask_.store(other.dirty_mask_.exchange(0));
+		driver_type_ = other.driver_type_;
+		broadcast_groups_ = other.broadcast_groups_;
+		broadcast_hold_ = other.broadcast_hold_;
+		memcpy(phase_offsets_, other.phase_offsets_, sizeof(phase_offsets_));
+		memcpy(frame_regs_, other.frame_regs_, sizeof(frame_regs_));
+		frame_mask_ = other.frame_mask_;
+		health_ = other.health_;
+		health_stats_ = other.health_stats_;
+		expected_mode1_ = other.expected_mode1_;
+		backoff_ms_ = other.backoff_ms_;
+		retry_at_ = other.retry_at_;
+		pwm_frequency_ = other.pwm_frequency_;
+		oscillator_hz_ = other.oscillator_hz_;
+		camera_mode_ = other.camera_mode_;
+		prescale_ = other.prescale_;
+		curve_ = other.curve_;
+		memcpy(dither_error_, other.dither_error_, sizeof(dither_error_));
+		dither_mask_ = other.dither_mask_;
+		rated_ma_ = other.rated_ma_;
+		memcpy(power_demand_, other.power_demand_, sizeof(power_demand_));
+		memcpy(power_scale_, other.power_scale_, sizeof(power_scale_));
 		
 		// Reset other object
 		other.address_ = 0;
@@ -109,35 +216,22 @@ bool PCA9685Module::initialize() {
 	
 	LOG_INFO("[PCA9685] Initializing module %s...\n", name_.c_str());
 
-	// Create driver instance
-	driver_.reset(new Adafruit_PWMServoDriver(address_));
+	// Create driver instance, kept as fallback when the native path is unavailable
+	driver_.reset(new Adafruit_PWMServoDriver(address_, *wire_));
 	
 	if (!driver_) {
 		LOG_ERROR("[PCA9685] Failed to create driver instance\n");
 		return false;
 	}
 	
-	// Initialize driver
-	driver_->begin();
-	
-	// Test initialization by setting oscillator frequency and PWM frequency
-	bool init_success = true;
-	try {
-		driver_->setOscillatorFrequency(27000000);
-		driver_->setPWMFreq(1600); // Good frequency for LEDs
-	} catch (...) {
-		init_success = false;
-	}
-	
-	if (!init_success) {
-		LOG_ERROR("[PCA9685] Failed to initialize PCA9685 at 0x%02X\n", address_);
-		driver_.reset(); // Clean up
+	if (!configureChip(true)) {
+		LOG_ERROR("[PCA9685] Failed to configure PCA9685 at 0x%02X\n", address_);
 		return false;
 	}
 	
 	initialized_ = true;
 	
-	LOG_INFO("[PCA9685] PCA9685 at 0x%02X initialized successfully\n", address_);
+	LOG_INFO("[PCA9685] PCA9685 at 0x%02X initialized successfully (%s driver)\n", address_, getDriverName());
 	
 	return true;
 }
@@ -147,26 +241,93 @@ bool PCA9685Module::applyLedBrightness(uint8_t led_index) {
 		return false;
 	}
 	
-	const LED* led = getLED(led_index);
-	if (!led) {
+	// Written by the next flush()
+	dirty_mask_.fetch_or(static_cast<uint16_t>(1u << led_index));
+	return true;
+}
+
+bool PCA9685Module::applyLedMask(uint16_t mask) {
+	if (!initialized_ || !driver_ || !leds_) {
 		return false;
 	}
 	
-	// FULL OFF case
-	if (!led->isEnabled() || led->getBrightness() == 0) {
-		driver_->setPWM(led_index, 0, 4096);
-		return true;
+	// LEDs past led_count_ do not exist
+	dirty_mask_.fetch_or(static_cast<uint16_t>(mask & ((1u << led_count_) - 1)));
+	return true;
+}
+
+bool PCA9685Module::flush() {
+	if (!initialized_ || !driver_ || !leds_) {
+		return false;
 	}
 	
-	// FULL ON case
-	if (led->getBrightness() == LED::MAX_BRIGHTNESS) {
-		driver_->setPWM(led_index, 4096, 0);
-		return true;
+	commitFrame();
+	return writeFrame();
+}
+
+bool PCA9685Module::commitFrame() {
+	// Outputs are owned by a broadcast, keep changes for the release
+	if (!initialized_ || !leds_ || broadcast_hold_) {
+		return frame_mask_ != 0;
 	}
 	
-	// Normal PWM case
-	driver_->setPWM(led_index, 0, led->getBrightness());
-	return true;
+	uint16_t dirty = dirty_mask_.exchange(0);
+	frame_mask_ |= dirty;
+	
+	// Dithered channels are revisited every frame, written only when their duty steps
+	uint16_t mask = dirty | dither_mask_;
+	while (mask) {
+		uint8_t led_index = __builtin_ctz(mask);
+		mask &= mask - 1;
+		if (led_index >= led_count_) {
+			continue;
+		}
+		
+		uint16_t on, off;
+		uint8_t regs[4];
+		getChannelPwm(led_index, on, off);
+		encodeFrameChannel(regs, on, off);
+		if (memcmp(regs, frame_regs_[led_index], sizeof(regs)) != 0) {
+			memcpy(frame_regs_[led_index], regs, sizeof(regs));
+			frame_mask_ |= static_cast<uint16_t>(1u << led_index);
+		}
+	}
+	
+	return frame_mask_ != 0;
+}
+
+bool PCA9685Module::writeFrame() {
+	if (!initialized_ || !driver_ || frame_mask_ == 0) {
+		return frame_mask_ == 0;
+	}
+	
+	// Held by a broadcast, or backed off: keep the frame for later
+	if (broadcast_hold_ || health_ == Health::OFFLINE) {
+		return false;
+	}
+	
+	// Failed channels stay pending for the next write
+	frame_mask_ = driver_type_ == Driver::NATIVE ? writeFrameNative() : writeFrameAdafruit();
+	
+	return frame_mask_ == 0;
+}
+
+size_t PCA9685Module::encodeFrame(uint8_t* out) const {
+	if (frame_mask_ == 0) {
+		return 0;
+	}
+	
+	// Contiguous range covering every pending channel, already encoded
+	uint8_t first = __builtin_ctz(frame_mask_);
+	uint8_t last = 31 - __builtin_clz(frame_mask_);
+	if (last >= led_count_) {
+		last = led_count_ - 1;
+	}
+	
+	out[0] = REG_LED0_ON_L + 4 * first;
+	memcpy(out + 1, frame_regs_[first], 4 * (last - first + 1));
+	
+	return 1 + 4 * (last - first + 1);
 }
 
 void PCA9685Module::setupDefaultLeds(uint8_t module_index) {
@@ -189,19 +350,19 @@ void PCA9685Module::setupDefaultLeds(uint8_t module_index) {
 	}
 }
 
-bool PCA9685Module::isPCA9685Device(uint8_t address) {
+bool PCA9685Module::isPCA9685Device(uint8_t address, TwoWire& wire) {
 	// Simple check: try to read the MODE1 register
-	Wire.beginTransmission(address);
-	Wire.write(0x00); // MODE1 register
-	uint8_t error = Wire.endTransmission();
+	wire.beginTransmission(address);
+	wire.write(0x00); // MODE1 register
+	uint8_t error = wire.endTransmission();
 	
 	if (error != 0) {
 		return false;
 	}
 	
-	Wire.requestFrom(address, static_cast<uint8_t>(1));
-	if (Wire.available()) {
-		uint8_t mode1 = Wire.read();
+	wire.requestFrom(address, static_cast<uint8_t>(1));
+	if (wire.available()) {
+		uint8_t mode1 = wire.read();
 		// MODE1 register should have reasonable values
 		return (mode1 & 0x80) == 0; // RESTART bit should be 0 normally
 	}
@@ -209,187 +370,1870 @@ bool PCA9685Module::isPCA9685Device(uint8_t address) {
 	return false;
 }
 
-// === Private functions ===
-
-String PCA9685Module::generateDefaultName() const {
-	return "PCA9685_" + String(address_, HEX);
+TwoWire& PCA9685Module::getBusWire(uint8_t bus) {
+	return bus == 1 ? Wire1 : Wire;
 }
 
+void PCA9685Module::setBroadcastHold(bool hold) {
+	broadcast_hold_ = hold;
+	if (!hold) {
+		dirty_mask_.fetch_or(static_cast<uint16_t>((1u << led_count_) - 1));
+	}
+}
 
-// =============================================================================
-// ModuleManager Implementation
-// =============================================================================
+void PCA9685Module::setPhaseOffset(uint8_t led_index, uint16_t offset) {
+	if (led_index >= LED_MAX) {
+		return;
+	}
+	
+	offset &= PWM_STEPS - 1;
+	if (phase_offsets_[led_index] != offset) {
+		phase_offsets_[led_index] = offset;
+		if (led_index < led_count_) {
+			dirty_mask_.fetch_or(static_cast<uint16_t>(1u << led_index));
+		}
+	}
+}
 
+bool PCA9685Module::setPwmFrequency(uint16_t frequency) {
+	if (frequency < PWM_FREQUENCY_MIN || frequency > PWM_FREQUENCY_MAX) {
+		return false;
+	}
+	pwm_frequency_ = frequency;
+	return true;
+}
 
-// === Constructor and Destructor ===
+bool PCA9685Module::setRatedCurrent(uint16_t rated_ma) {
+	if (rated_ma == 0 || rated_ma > LED::RATED_MA_MAX) {
+		return false;
+	}
+	rated_ma_ = rated_ma;
+	return true;
+}
 
-// Default constructor
-ModuleManager::ModuleManager() {
-	modules_.reserve(16); // Reserve space for up to 16 modules
+void PCA9685Module::setPowerScales(const uint32_t* scales) {
+	if (memcmp(power_scale_, scales, sizeof(power_scale_)) == 0) {
+		return;
+	}
+	memcpy(power_scale_, scales, sizeof(power_scale_));
+	dirty_mask_.fetch_or(static_cast<uint16_t>((1u << led_count_) - 1));
 }
 
-// === Getters ===
+void PCA9685Module::updatePowerDemand() {
+	memset(power_demand_, 0, sizeof(power_demand_));
+	if (!leds_) {
+		return;
+	}
+	
+	for (uint8_t i = 0; i < led_count_; i++) {
+		const LED& led = leds_[i];
+		uint16_t level = led.getOutputBrightness();
+		if (level == 0) {
+			continue;
+		}
+		uint32_t rated_ma = led.getRatedCurrent() ? led.getRatedCurrent() : rated_ma_;
+		power_demand_[led.getPriority()] += rated_ma * BrightnessCurve::applyIntensity(getLedCurve(i), level);
+	}
+}
 
-PCA9685Module* ModuleManager::getModule(uint8_t index) {
-	if (index >= modules_.size()) {
-		return nullptr;
+uint32_t PCA9685Module::getDemandCurrent() const {
+	uint64_t demand = 0;
+	for (uint8_t i = 0; i < POWER_PRIORITIES; i++) {
+		demand += power_demand_[i];
 	}
-	return modules_[index].get();
+	return demand / BrightnessCurve::INTENSITY_MAX;
 }
 
-const PCA9685Module* ModuleManager::getModule(uint8_t index) const {
-	if (index >= modules_.size()) {
-		return nullptr;
+uint32_t PCA9685Module::getEstimatedCurrent() const {
+	uint64_t estimated = 0;
+	for (uint8_t i = 0; i < POWER_PRIORITIES; i++) {
+		estimated += (static_cast<uint64_t>(power_demand_[i]) * power_scale_[i]) >> 16;
 	}
-	return modules_[index].get();
+	return estimated / BrightnessCurve::INTENSITY_MAX;
 }
 
-LED* ModuleManager::getLED(uint8_t module_index, uint8_t led_index) {
-	PCA9685Module* module = getModule(module_index);
-	if (!module) {
-		return nullptr;
+bool PCA9685Module::setOscillatorFrequency(uint32_t oscillator_hz) {
+	if (oscillator_hz < OSCILLATOR_MIN || oscillator_hz > OSCILLATOR_MAX) {
+		return false;
 	}
-	return module->getLED(led_index);
+	oscillator_hz_ = oscillator_hz;
+	return true;
 }
 
-const LED* ModuleManager::getLED(uint8_t module_index, uint8_t led_index) const {
-	const PCA9685Module* module = getModule(module_index);
-	if (!module) {
-		return nullptr;
+uint8_t PCA9685Module::computePrescale(uint32_t oscillator_hz, uint16_t frequency) {
+	if (frequency == 0) {
+		return 255;
 	}
-	return module->getLED(led_index);
+	
+	// Same prescale computation as Adafruit_PWMServoDriver::setPWMFreq()
+	float prescale_value = (static_cast<float>(oscillator_hz) / (frequency * static_cast<float>(PWM_STEPS))) + 0.5f - 1.0f;
+	if (prescale_value < PRESCALE_MIN) {
+		return PRESCALE_MIN;
+	}
+	return prescale_value > 255.0f ? 255 : static_cast<uint8_t>(prescale_value);
 }
 
-uint16_t ModuleManager::getTotalLedCount() const {
-	uint16_t total = 0;
-	for (const auto& module : modules_) {
-		if (module) {
-			total += module->getLedCount();
+bool PCA9685Module::applyPwmFrequency() {
+	if (!initialized_ || !driver_) {
+		return false;
+	}
+	
+	uint8_t prescale = getTargetPrescale();
+	if (driver_type_ == Driver::NATIVE) {
+		esp_err_t err = writePrescale(prescale);
+		recordTransaction(err);
+		if (err != ESP_OK) {
+			LOG_ERROR("[PCA9685] Failed to set prescale of %s (0x%02X): %s\n", name_.c_str(), address_, esp_err_to_name(err));
+			return false;
 		}
+	} else {
+		driver_->setOscillatorFrequency(oscillator_hz_);
+		driver_->setPWMFreq(getPrescaleFrequency(oscillator_hz_, prescale));
 	}
-	return total;
+	
+	prescale_ = prescale;
+	LOG_INFO("[PCA9685] Module %s (0x%02X): prescale %d, PWM %.1f Hz\n", name_.c_str(), address_, prescale_, getActualPwmFrequency());
+	
+	return true;
 }
 
-uint8_t ModuleManager::getInitializedModuleCount() const {
-	uint8_t count = 0;
-	for (const auto& module : modules_) {
-		if (module && module->isInitialized()) {
-			count++;
+uint32_t PCA9685Module::calibrateOscillator(uint8_t led_index, uint8_t pin) {
+	if (!initialized_ || !driver_ || led_index >= led_count_ || prescale_ == 0 ||
+		broadcast_hold_ || health_ == Health::OFFLINE) {
+		return 0;
+	}
+	
+	// 50% duty from tick 0, other channels keep running
+	const uint16_t half = PWM_STEPS / 2;
+	if (driver_type_ == Driver::NATIVE) {
+		uint8_t data[5] = {
+			static_cast<uint8_t>(REG_LED0_ON_L + 4 * led_index),
+			0, 0,
+			static_cast<uint8_t>(half & 0xFF), static_cast<uint8_t>(half >> 8)
+		};
+		if (writeBurst(data, sizeof(data)) != ESP_OK) {
+			return 0;
 		}
+	} else if (driver_->setPWM(led_index, 0, half) != 0) {
+		return 0;
 	}
-	return count;
+	
+	pinMode(pin, INPUT);
+	
+	// pulseIn() skips the pulse in progress, so high and low come from consecutive periods
+	uint64_t total_us = 0;
+	bool timed_out = false;
+	for (uint8_t i = 0; i < CALIBRATION_PERIODS; i++) {
+		unsigned long high_us = pulseIn(pin, HIGH, CALIBRATION_PULSE_TIMEOUT_US);
+		unsigned long low_us = pulseIn(pin, LOW, CALIBRATION_PULSE_TIMEOUT_US);
+		if (high_us == 0 || low_us == 0) {
+			timed_out = true;
+			break;
+		}
+		total_us += high_us + low_us;
+	}
+	
+	// Channel back to its frame value
+	frame_mask_ |= static_cast<uint16_t>(1u << led_index);
+	writeFrame();
+	
+	if (timed_out || total_us == 0) {
+		LOG_ERROR("[PCA9685] Calibration of %s: no PWM signal on GPIO %d\n", name_.c_str(), pin);
+		return 0;
+	}
+	
+	// period = PWM_STEPS * (prescale + 1) / oscillator
+	uint64_t oscillator_hz = (static_cast<uint64_t>(PWM_STEPS) * (prescale_ + 1) * 1000000ULL * CALIBRATION_PERIODS + total_us / 2) / total_us;
+	
+	LOG_INFO("[PCA9685] Calibration of %s: period %.1f us, oscillator %lu Hz\n",
+		name_.c_str(), static_cast<float>(total_us) / CALIBRATION_PERIODS, (unsigned long)oscillator_hz);
+	
+	if (oscillator_hz < OSCILLATOR_MIN || oscillator_hz > OSCILLATOR_MAX) {
+		LOG_ERROR("[PCA9685] Calibration of %s: %lu Hz out of range, wrong channel or GPIO?\n", name_.c_str(), (unsigned long)oscillator_hz);
+		return 0;
+	}
+	
+	return static_cast<uint32_t>(oscillator_hz);
 }
 
-uint16_t ModuleManager::getEnabledLedCount() const {
-	uint16_t count = 0;
-	for (const auto& module : modules_) {
-		if (module) {
-			for (uint8_t j = 0; j < module->getLedCount(); j++) {
-				const LED* led = module->getLED(j);
-				if (led && led->isEnabled()) {
-					count++;
-				}
-			}
-		}
+const char* PCA9685Module::getHealthName() const {
+	switch (health_) {
+		case Health::OK:        return "ok";
+		case Health::DEGRADED:  return "degraded";
+		case Health::OFFLINE:   return "offline";
+		default:                return "unknown";
 	}
-	return count;
 }
 
-// === Other functions ===
+void PCA9685Module::recordTransaction(esp_err_t err) {
+	if (err == ESP_OK) {
+		health_stats_.consecutive = 0;
+		if (health_ == Health::DEGRADED) {
+			health_ = Health::OK;
+		}
+		return;
+	}
+	
+	health_stats_.errors++;
+	if (err == ESP_FAIL) {
+		health_stats_.nacks++;
+	} else if (err == ESP_ERR_TIMEOUT) {
+		health_stats_.timeouts++;
+	}
+	if (health_stats_.consecutive < UINT8_MAX) {
+		health_stats_.consecutive++;
+	}
+	
+	if (health_ == Health::OFFLINE) {
+		// Still failing: wait twice as long before the next check
+		backoff_ms_ = std::min<uint32_t>(backoff_ms_ * 2, static_cast<uint32_t>(BACKOFF_MAX_MS));
+		retry_at_ = millis() + backoff_ms_;
+	} else if (health_stats_.consecutive >= FAILURE_THRESHOLD) {
+		health_ = Health::OFFLINE;
+		backoff_ms_ = BACKOFF_MIN_MS;
+		retry_at_ = millis() + backoff_ms_;
+		LOG_WARNING("[PCA9685] Module %s (0x%02X) offline after %d failed transactions (%s)\n",
+			name_.c_str(), address_, health_stats_.consecutive, esp_err_to_name(err));
+	} else {
+		health_ = Health::DEGRADED;
+	}
+}
 
-bool ModuleManager::initialize() {
-	LOG_INFO("[MODULEMGR] Setting up PCA9685 modules...\n");
+bool PCA9685Module::checkHealth() {
+	if (!initialized_) {
+		return false;
+	}
 	
-	// Clear existing modules
-	modules_.clear();
+	uint8_t mode1;
+	esp_err_t err = readMode1(mode1);
+	if (err != ESP_OK) {
+		recordTransaction(err);
+		return false;
+	}
 	
-	// Scan for modules
-	uint8_t found_count = scanModules();
-	if (found_count == 0) {
-		LOG_ERROR("[MODULEMGR] No PCA9685 modules found\n");
+	// Power-on MODE1 (sleep, no auto-increment) means the chip lost its configuration
+	if ((mode1 & ~MODE1_RESTART) != (expected_mode1_ & ~MODE1_RESTART)) {
+		health_stats_.resets++;
+		LOG_WARNING("[PCA9685] Module %s (0x%02X) was reset (MODE1 0x%02X), re-initializing\n", name_.c_str(), address_, mode1);
+		return recover();
+	}
+	
+	// Back on the bus without reset: replay what frames skipped
+	if (health_ == Health::OFFLINE) {
+		LOG_INFO("[PCA9685] Module %s (0x%02X) answers again\n", name_.c_str(), address_);
+		health_ = Health::OK;
+		health_stats_.consecutive = 0;
+		frame_mask_ = static_cast<uint16_t>((1u << led_count_) - 1);
+		return writeFrame();
+	}
+	
+	recordTransaction(ESP_OK);
+	return true;
+}
+
+bool PCA9685Module::recover() {
+	if (!configureChip(false)) {
+		recordTransaction(ESP_FAIL);
 		return false;
 	}
 	
-	// Initialize modules
-	uint8_t initialized_count = initializeModules();
+	applyBroadcastGroups();
 	
-	LOG_INFO("[MODULEMGR] PCA9685 modules initialized: %d/%d\n", initialized_count, found_count);
+	health_ = Health::OK;
+	health_stats_.consecutive = 0;
+	health_stats_.reinits++;
 	
-	return initialized_count > 0;
+	// Shadow registers: the output frame holds the last state of every channel
+	frame_mask_ = static_cast<uint16_t>((1u << led_count_) - 1);
+	bool success = writeFrame() || broadcast_hold_;
+	
+	LOG_INFO("[PCA9685] Module %s (0x%02X) re-initialized%s\n", name_.c_str(), address_, success ? "" : ", replay failed");
+	
+	return success;
 }
 
-bool ModuleManager::applyLedBrightness(uint8_t module_index, uint8_t led_index) {
-	PCA9685Module* module = getModule(module_index);
-	if (!module) {
+bool PCA9685Module::applyBroadcastGroups() {
+	if (!initialized_) {
 		return false;
 	}
-	return module->applyLedBrightness(led_index);
+	
+	// Non-members answer their own address on the unused SUBADR slot
+	const uint8_t data[] = {
+		REG_SUBADR1,
+		static_cast<uint8_t>((isInBroadcastGroup(1) ? config.getBroadcastGroupAddress(1) : address_) << 1),
+		static_cast<uint8_t>((isInBroadcastGroup(2) ? config.getBroadcastGroupAddress(2) : address_) << 1)
+	};
+	
+	if (driver_type_ != Driver::NATIVE) {
+		return writeWireRegister(data[0], data[1]) == ESP_OK &&
+			writeWireRegister(REG_SUBADR2, data[2]) == ESP_OK &&
+			writeWireRegister(REG_ALLCALLADR, ADDR_RESERVED_ALL_CALL << 1) == ESP_OK;
+	}
+	
+	return writeBurst(data, sizeof(data)) == ESP_OK &&
+		writeRegister(REG_ALLCALLADR, ADDR_RESERVED_ALL_CALL << 1) == ESP_OK;
 }
 
-void ModuleManager::printModuleInfo() const {
-	LOG_INFO("[MODULEMGR] === PCA9685 Module Information ===\n");
-	LOG_INFO("[MODULEMGR] Total modules: %d\n", modules_.size());
-	LOG_INFO("[MODULEMGR] Initialized modules: %d\n", getInitializedModuleCount());
-	LOG_INFO("[MODULEMGR] Total LEDs: %d\n", getTotalLedCount());
+esp_err_t PCA9685Module::writeBurstTo(uint8_t bus, uint8_t address, const uint8_t* data, size_t length) {
+	if (bus >= BUS_COUNT) {
+		return ESP_ERR_INVALID_ARG;
+	}
+	
+	i2c_cmd_handle_t cmd = i2c_cmd_link_create_static(bus_cmd_buffers[bus], CMD_BUFFER_SIZE);
+	if (!cmd) {
+		return ESP_ERR_NO_MEM;
+	}
+	
+	i2c_master_start(cmd);
+	i2c_master_write_byte(cmd, (address << 1) | I2C_MASTER_WRITE, true);
+	i2c_master_write(cmd, data, length, true);
+	i2c_master_stop(cmd);
+	
+	esp_err_t err = i2c_master_cmd_begin(static_cast<i2c_port_t>(bus), cmd, pdMS_TO_TICKS(TRANSACTION_TIMEOUT_MS));
+	i2c_cmd_link_delete_static(cmd);
+	
+	return err;
+}
 
-	for (size_t i = 0; i < modules_.size(); i++) {
-		const auto& module = modules_[i];
-		if (module) {
-			LOG_INFO("[MODULEMGR] Module %d: %s (0x%02X) - %s - %d LEDs\n",
-				i,
-				module->getName(),
-				module->getAddress(),
-				module->isInitialized() ? "INITIALIZED" : "FAILED",
-				module->getLedCount());
+bool PCA9685Module::verifyRegisters() {
+	// MODE1 must be readable
+	wire_->beginTransmission(address_);
+	wire_->write(REG_MODE1);
+	if (wire_->endTransmission() != 0 || wire_->requestFrom(address_, static_cast<uint8_t>(1)) != 1) {
+		return false;
+	}
+	wire_->read();
+	
+	// Save SUBADR3
+	wire_->beginTransmission(address_);
+	wire_->write(REG_SUBADR3);
+	if (wire_->endTransmission() != 0 || wire_->requestFrom(address_, static_cast<uint8_t>(1)) != 1) {
+		return false;
+	}
+	uint8_t original = wire_->read();
+	
+	// Write/readback with complementary patterns (bit 0 is read-only)
+	static const uint8_t patterns[] = {0xAA, 0x54};
+	bool success = true;
+	for (uint8_t pattern : patterns) {
+		wire_->beginTransmission(address_);
+		wire_->write(REG_SUBADR3);
+		wire_->write(pattern);
+		if (wire_->endTransmission() != 0) {
+			success = false;
+			break;
+		}
+		
+		wire_->beginTransmission(address_);
+		wire_->write(REG_SUBADR3);
+		if (wire_->endTransmission() != 0 || wire_->requestFrom(address_, static_cast<uint8_t>(1)) != 1 || wire_->read() != pattern) {
+			success = false;
+			break;
 		}
 	}
+	
+	// Restore SUBADR3
+	wire_->beginTransmission(address_);
+	wire_->write(REG_SUBADR3);
+	wire_->write(original);
+	if (wire_->endTransmission() != 0) {
+		success = false;
+	}
+	
+	return success;
 }
 
 // === Private functions ===
 
-uint8_t ModuleManager::scanModules() {
-	LOG_INFO("[MODULEMGR] Scanning for PCA9685 modules...\n");
-	
-	uint8_t found_count = 0;
-	
-	for (uint8_t addr = config.getPca9685AddrMin(); 
-		addr <= config.getPca9685AddrMax() && found_count < config.getPca9685ModuleMax(); 
-		addr++) {
-		
-		Wire.beginTransmission(addr);
-		uint8_t error = Wire.endTransmission();
+String PCA9685Module::generateDefaultName() const {
+	// Same address may be used on both buses
+	if (bus_ != 0) {
+		return "PCA9685_" + String(bus_) + "_" + String(address_, HEX);
+	}
+	return "PCA9685_" + String(address_, HEX);
+}
+
+bool PCA9685Module::configureChip(bool first_attach) {
+	if (driver_type_ == Driver::NATIVE) {
+		esp_err_t err = initializeNative();
+		if (err == ESP_OK) {
+			expected_mode1_ = MODE1_DEFAULT;
+			return true;
+		}
 		
-		if (error == 0) {
-			// Device found, check if it's a PCA9685
-			if (PCA9685Module::isPCA9685Device(addr)) {
-				// Create module instance
-				std::unique_ptr<PCA9685Module> module(new PCA9685Module(addr, config.getPca9685LedMax()));
-				module->setDetected(true); // Mark as detected
-				
-				LOG_INFO("[MODULEMGR] PCA9685 found at address 0x%02X\n", addr);
-				
-				modules_.push_back(std::move(module));
-				found_count++;
-			}
+		// Only a port without IDF driver rules the native path out for good
+		if (!first_attach || (err != ESP_ERR_INVALID_STATE && err != ESP_ERR_INVALID_ARG)) {
+			LOG_DEBUG("[PCA9685] Native init of 0x%02X failed (%s)\n", address_, esp_err_to_name(err));
+			return false;
 		}
+		
+		LOG_WARNING("[PCA9685] Native driver unavailable for 0x%02X (%s), using Adafruit driver\n", address_, esp_err_to_name(err));
+		driver_type_ = Driver::ADAFRUIT;
 	}
 	
-	LOG_INFO("[MODULEMGR] Total PCA9685 modules detected: %d\n", found_count);
+	// Initialize driver, at the frequency of the prescale the native path would write
+	uint8_t prescale = getTargetPrescale();
+	if (!driver_->begin()) {
+		return false;
+	}
+	driver_->setOscillatorFrequency(oscillator_hz_);
+	driver_->setPWMFreq(getPrescaleFrequency(oscillator_hz_, prescale));
+	prescale_ = prescale;
 	
-	return found_count;
+	// Same sub-addresses and MODE1 as the native path: broadcast MODE1 writes
+	// (SUB1 and SUB2 enabled) must not add the module to the power-on groups
+	if (writeWireRegister(REG_SUBADR1, address_ << 1) != ESP_OK ||
+		writeWireRegister(REG_SUBADR2, address_ << 1) != ESP_OK ||
+		writeWireRegister(REG_MODE1, MODE1_DEFAULT) != ESP_OK) {
+		return false;
+	}
+	expected_mode1_ = MODE1_DEFAULT;
+	return true;
 }
 
-uint8_t ModuleManager::initializeModules() {
-	uint8_t initialized_count = 0;
+esp_err_t PCA9685Module::readMode1(uint8_t& value) {
+	if (driver_type_ == Driver::NATIVE) {
+		return readRegister(REG_MODE1, value);
+	}
 	
-	for (size_t i = 0; i < modules_.size(); i++) {
-		auto& module = modules_[i];
-		if (module && module->initialize()) {
-			// Setup default LEDs with proper module index
-			module->setupDefaultLeds(i);
-			initialized_count++;
-		}
+	wire_->beginTransmission(address_);
+	wire_->write(REG_MODE1);
+	uint8_t error = wire_->endTransmission();
+	if (error != 0) {
+		return error == 5 ? ESP_ERR_TIMEOUT : ESP_FAIL;
+	}
+	if (wire_->requestFrom(address_, static_cast<uint8_t>(1)) != 1) {
+		return ESP_FAIL;
+	}
+	value = wire_->read();
+	return ESP_OK;
+}
+
+esp_err_t PCA9685Module::writeWireRegister(uint8_t reg, uint8_t value) {
+	wire_->beginTransmission(address_);
+	wire_->write(reg);
+	wire_->write(value);
+	uint8_t error = wire_->endTransmission();
+	if (error != 0) {
+		return error == 5 ? ESP_ERR_TIMEOUT : ESP_FAIL;
+	}
+	return ESP_OK;
+}
+
+esp_err_t PCA9685Module::initializeNative() {
+	uint8_t prescale = getTargetPrescale();
+	
+	// Chip must answer before being reconfigured
+	uint8_t mode1;
+	esp_err_t err = readRegister(REG_MODE1, mode1);
+	
+	// Group addresses are only answered once membership is set (applyBroadcastGroups())
+	// (single register writes: auto-increment is still off after power-on)
+	if (err == ESP_OK) {
+		err = writeRegister(REG_SUBADR1, address_ << 1);
+	}
+	if (err == ESP_OK) {
+		err = writeRegister(REG_SUBADR2, address_ << 1);
+	}
+	if (err == ESP_OK) {
+		err = writeRegister(REG_MODE2, MODE2_DEFAULT);
+	}
+	if (err == ESP_OK) {
+		err = writePrescale(prescale);
+	}
+	
+	if (err == ESP_OK) {
+		prescale_ = prescale;
+	}
+	return err;
+}
+
+esp_err_t PCA9685Module::writePrescale(uint8_t prescale) {
+	// Prescale can only be written while the oscillator is off
+	esp_err_t err = writeRegister(REG_MODE1, MODE1_DEFAULT | MODE1_SLEEP);
+	if (err == ESP_OK) {
+		err = writeRegister(REG_PRESCALE, prescale);
+	}
+	if (err == ESP_OK) {
+		err = writeRegister(REG_MODE1, MODE1_DEFAULT);
+	}
+	if (err != ESP_OK) {
+		return err;
+	}
+	
+	// Oscillator needs 500us to stabilize before restarting PWM
+	delayMicroseconds(500);
+	return writeRegister(REG_MODE1, MODE1_DEFAULT | MODE1_RESTART);
+}
+
+CurveType PCA9685Module::getLedCurve(uint8_t led_index) const {
+	CurveType curve = (leds_ && led_index < led_count_) ? leds_[led_index].getCurve() : CURVE_DEFAULT;
+	if (curve == CURVE_DEFAULT) {
+		curve = curve_;
+	}
+	return curve == CURVE_DEFAULT ? config.getDefaultCurve() : curve;
+}
+
+void PCA9685Module::getChannelPwm(uint8_t led_index, uint16_t& on, uint16_t& off) {
+	const LED& led = leds_[led_index];
+	uint16_t bit = static_cast<uint16_t>(1u << led_index);
+	uint16_t level = 0;
+	uint16_t fraction = 0;
+	
+	// A LED fading out keeps its output until the end of its transition
+	if (led.isEnabled() || led.getTransition()) {
+		uint16_t intensity = BrightnessCurve::applyIntensity(getLedCurve(led_index), led.getOutputBrightness());
+		intensity = (static_cast<uint32_t>(intensity) * power_scale_[led.getPriority()]) >> 16;
+		if (led.isDitherEnabled()) {
+			fraction = intensity & (BrightnessCurve::FRACTION_ONE - 1);
+			level = BrightnessCurve::ditherStep(intensity, dither_error_[led_index]);
+		} else {
+			level = BrightnessCurve::toDuty(intensity);
+		}
+	}
+	
+	// Only channels between two duty steps need a frame by frame update
+	if (fraction) {
+		dither_mask_ |= bit;
+	} else {
+		dither_mask_ &= ~bit;
+		dither_error_[led_index] = 0;
+	}
+	
+	encodePwm(level, phase_offsets_[led_index], on, off);
+}
+
+uint16_t PCA9685Module::writeFrameNative() {
+	uint8_t* tx = bus_tx_buffers[bus_];
+	size_t length = encodeFrame(tx);
+	
+	esp_err_t err = writeBurst(tx, length);
+	if (err == ESP_OK) {
+		recordTransaction(ESP_OK);
+		return 0;
+	}
+	
+	// No IDF driver on this port (e.g. Wire not started): keep going with Adafruit
+	if (err == ESP_ERR_INVALID_STATE || err == ESP_ERR_INVALID_ARG) {
+		LOG_WARNING("[PCA9685] Native driver unavailable for 0x%02X (%s), using Adafruit driver\n", address_, esp_err_to_name(err));
+		driver_type_ = Driver::ADAFRUIT;
+		return frame_mask_;
+	}
+	
+	recordTransaction(err);
+	return frame_mask_;
+}
+
+uint16_t PCA9685Module::writeFrameAdafruit() {
+	uint16_t mask = frame_mask_;
+	uint16_t failed = 0;
+	
+	while (mask) {
+		uint8_t led_index = __builtin_ctz(mask);
+		uint16_t bit = static_cast<uint16_t>(1u << led_index);
+		mask &= ~bit;
+		if (led_index >= led_count_) {
+			continue;
+		}
+		
+		const uint8_t* regs = frame_regs_[led_index];
+		uint16_t on = regs[0] | (regs[1] << 8);
+		uint16_t off = regs[2] | (regs[3] << 8);
+		
+		// Wire codes: 2/3 = NACK, 5 = timeout
+		uint8_t error = driver_->setPWM(led_index, on, off);
+		if (error != 0) {
+			failed |= bit;
+			recordTransaction(error == 5 ? ESP_ERR_TIMEOUT : (error == 2 || error == 3) ? ESP_FAIL : ESP_ERR_INVALID_RESPONSE);
+			if (health_ == Health::OFFLINE) {
+				return failed | mask;
+			}
+		}
+	}
+	
+	if (!failed) {
+		recordTransaction(ESP_OK);
+	}
+	return failed;
+}
+
+esp_err_t PCA9685Module::writeBurst(const uint8_t* data, size_t length) {
+	return writeBurstTo(bus_, address_, data, length);
+}
+
+esp_err_t PCA9685Module::writeRegister(uint8_t reg, uint8_t value) {
+	const uint8_t data[2] = {reg, value};
+	return writeBurst(data, sizeof(data));
+}
+
+esp_err_t PCA9685Module::readRegister(uint8_t reg, uint8_t& value) {
+	return i2c_master_write_read_device(static_cast<i2c_port_t>(bus_), address_, &reg, 1, &value, 1, pdMS_TO_TICKS(TRANSACTION_TIMEOUT_MS));
+}
+
+
+// =============================================================================
+// ModuleManager Implementation
+// =============================================================================
+
+
+// === Constructor and Destructor ===
+
+// Default constructor
+ModuleManager::ModuleManager() :
+	bus_clock_hz_(),
+	bus_speed_results_(),
+	bus_negotiation_requested_(false),
+	flush_tasks_(),
+	flush_done_(),
+	flush_contexts_(),
+	frame_stats_(),
+	late_counted_(),
+	linked_cmd_size_(),
+	last_health_check_(),
+	health_cursor_(),
+	last_scan_step_(),
+	scan_stats_(),
+	scan_found_(),
+	scan_pending_(),
+	bench_results_(),
+	bench_rounds_requested_(0),
+	broadcast_action_(BroadcastAction::NONE),
+	broadcast_group_(BROADCAST_ALL),
+	broadcast_level_(0),
+	phase_allocation_requested_(false),
+	pwm_update_requested_(false),
+	calibration_requested_(false),
+	calibration_(),
+	last_power_update_(0),
+	power_stats_() {
+	forget_requested_ = FORGET_NONE;
+	modules_.reserve(16); // Reserve space for up to 16 modules
+	for (uint8_t bus = 0; bus < PCA9685Module::BUS_COUNT; bus++) {
+		bus_clock_hz_[bus] = Config::I2C_CLOCK_STANDARD;
+		for (size_t i = 0; i < BUS_SPEED_COUNT; i++) {
+			bus_speed_results_[bus][i].clock_hz = BUS_SPEEDS[i];
+		}
+	}
+	for (uint8_t i = 0; i < PCA9685Module::POWER_PRIORITIES; i++) {
+		power_scale_[i] = PCA9685Module::POWER_SCALE_ONE;
+	}
+}
+
+// Destructor
+ModuleManager::~ModuleManager() {
+	for (uint8_t bus = 0; bus < PCA9685Module::BUS_COUNT; bus++) {
+		if (flush_tasks_[bus]) {
+			vTaskDelete(flush_tasks_[bus]);
+		}
+		if (flush_done_[bus]) {
+			vSemaphoreDelete(flush_done_[bus]);
+		}
+	}
+}
+
+// === Getters ===
+
+PCA9685Module* ModuleManager::getModule(uint8_t index) {
+	if (index >= modules_.size()) {
+		return nullptr;
+	}
+	return modules_[index].get();
+}
+
+const PCA9685Module* ModuleManager::getModule(uint8_t index) const {
+	if (index >= modules_.size()) {
+		return nullptr;
+	}
+	return modules_[index].get();
+}
+
+LED* ModuleManager::getLED(uint8_t module_index, uint8_t led_index) {
+	PCA9685Module* module = getModule(module_index);
+	if (!module) {
+		return nullptr;
+	}
+	return module->getLED(led_index);
+}
+
+const LED* ModuleManager::getLED(uint8_t module_index, uint8_t led_index) const {
+	const PCA9685Module* module = getModule(module_index);
+	if (!module) {
+		return nullptr;
+	}
+	return module->getLED(led_index);
+}
+
+uint16_t ModuleManager::getTotalLedCount() const {
+	uint16_t total = 0;
+	for (const auto& module : modules_) {
+		if (module) {
+			total += module->getLedCount();
+		}
+	}
+	return total;
+}
+
+uint8_t ModuleManager::getInitializedModuleCount() const {
+	uint8_t count = 0;
+	for (const auto& module : modules_) {
+		if (module && module->isInitialized()) {
+			count++;
+		}
+	}
+	return count;
+}
+
+uint16_t ModuleManager::getEnabledLedCount() const {
+	uint16_t count = 0;
+	for (const auto& module : modules_) {
+		if (module) {
+			for (uint8_t j = 0; j < module->getLedCount(); j++) {
+				const LED* led = module->getLED(j);
+				if (led && led->isEnabled()) {
+					count++;
+				}
+			}
+		}
+	}
+	return count;
+}
+
+// === Other functions ===
+
+bool ModuleManager::initialize() {
+	LOG_INFO("[MODULEMGR] Setting up PCA9685 modules...\n");
+	
+	// Clear existing modules, full capacity so that hot-plugged modules never move the others
+	modules_.clear();
+	modules_.reserve(config.getPca9685ModuleMax());
+	
+	// Known modules first, at their saved ID
+	uint8_t known_count = restoreModuleMap();
+	
+	// Scan each bus independently (new modules take free IDs, bus 0 first)
+	uint8_t found_count = 0;
+	for (uint8_t bus = 0; bus < PCA9685Module::BUS_COUNT; bus++) {
+		if (isBusEnabled(bus)) {
+			found_count += scanModules(bus);
+		}
+	}
+	
+	// New modules were appended or took a free ID
+	uint8_t module_count = 0;
+	for (const auto& module : modules_) {
+		if (module) {
+			module_count++;
+		}
+	}
+	if (module_count != known_count) {
+		StorageManager::save_module_map();
+	}
+	
+	// Initialize modules
+	uint8_t initialized_count = initializeModules();
+	
+	if (found_count == 0) {
+		LOG_ERROR("[MODULEMGR] No PCA9685 modules found\n");
+		return false;
+	}
+	
+	LOG_INFO("[MODULEMGR] PCA9685 modules initialized: %d/%d\n", initialized_count, found_count);
+	
+	allocatePhaseOffsets();
+	
+	// Scan and init ran at the safe speed, now go as fast as each bus allows
+	for (uint8_t bus = 0; bus < PCA9685Module::BUS_COUNT; bus++) {
+		if (getBusModuleCount(bus) > 0) {
+			negotiateBusSpeed(bus);
+		}
+	}
+	
+	startFlushTasks();
+	
+	return initialized_count > 0;
+}
+
+void ModuleManager::refreshAllLeds() {
+	for (auto& module : modules_) {
+		if (module && module->isInitialized()) {
+			for (uint8_t led_index = 0; led_index < module->getLedCount(); led_index++) {
+				module->applyLedBrightness(led_index);
+			}
+		}
+	}
+}
+
+bool ModuleManager::applyLedBrightness(uint8_t module_index, uint8_t led_index) {
+	PCA9685Module* module = getModule(module_index);
+	if (!module) {
+		return false;
+	}
+	return module->applyLedBrightness(led_index);
+}
+
+bool ModuleManager::isBusEnabled(uint8_t bus) {
+	if (bus == 0) {
+		return true;
+	}
+	return bus == 1 && config.isI2c1Enabled();
+}
+
+uint8_t ModuleManager::getBusModuleCount(uint8_t bus) const {
+	uint8_t count = 0;
+	for (const auto& module : modules_) {
+		if (module && module->getBus() == bus) {
+			count++;
+		}
+	}
+	return count;
+}
+
+uint32_t ModuleManager::negotiateBusSpeed(uint8_t bus) {
+	if (bus >= PCA9685Module::BUS_COUNT) {
+		return 0;
+	}
+	
+	TwoWire& wire = PCA9685Module::getBusWire(bus);
+	uint32_t max_clock = config.getI2cClockHz();
+	uint32_t selected = 0;
+	
+	LOG_INFO("[MODULEMGR] Negotiating I2C bus %d speed (max %lu Hz)...\n", bus, (unsigned long)max_clock);
+	
+	for (size_t i = 0; i < BUS_SPEED_COUNT; i++) {
+		BusSpeedResult& result = bus_speed_results_[bus][i];
+		result.tested = false;
+		result.verified = false;
+		result.flush_us = 0;
+		
+		if (result.clock_hz > max_clock) {
+			continue;
+		}
+		
+		result.tested = true;
+		wire.setClock(result.clock_hz);
+		
+		if (verifyAllModules(bus, BUS_VERIFY_ROUNDS)) {
+			result.verified = true;
+			result.flush_us = measureFlushTime(bus);
+			if (selected == 0) {
+				selected = result.clock_hz;
+			}
+			LOG_INFO("[MODULEMGR] Bus %d at %lu Hz: OK, frame flush %lu us\n", bus, (unsigned long)result.clock_hz, (unsigned long)result.flush_us);
+		} else {
+			LOG_WARNING("[MODULEMGR] Bus %d at %lu Hz: register check failed\n", bus, (unsigned long)result.clock_hz);
+		}
+	}
+	
+	if (selected == 0) {
+		selected = Config::I2C_CLOCK_STANDARD;
+		LOG_ERROR("[MODULEMGR] Bus %d: no speed passed the register check, using %lu Hz\n", bus, (unsigned long)selected);
+	}
+	
+	wire.setClock(selected);
+	bus_clock_hz_[bus] = selected;
+	
+	LOG_INFO("[MODULEMGR] I2C bus %d running at %lu Hz\n", bus, (unsigned long)selected);
+	
+	return selected;
+}
+
+uint32_t ModuleManager::measureFlushTime(uint8_t bus) {
+	// Mark every channel of the bus, then time the flush itself
+	for (auto& module : modules_) {
+		if (module && module->getBus() == bus && module->isInitialized()) {
+			for (uint8_t j = 0; j < module->getLedCount(); j++) {
+				module->applyLedBrightness(j);
+			}
+		}
+	}
+	
+	unsigned long start = micros();
+	flushBus(bus);
+	return micros() - start;
+}
+
+void ModuleManager::flush() {
+	// Budget once per frame with changes, before its first commit
+	bool budget_updated = false;
+	for (uint8_t bus = 0; bus < PCA9685Module::BUS_COUNT; bus++) {
+		if (!flush_tasks_[bus]) {
+			// No task for this bus: write from the calling task
+			if (getBusModuleCount(bus) > 0) {
+				if (!budget_updated && hasDirtyChannels(bus)) {
+					updatePowerBudget();
+					budget_updated = true;
+				}
+				flushBus(bus);
+				serviceHealth(bus);
+			}
+			serviceScan(bus);
+			continue;
+		}
+		
+		// Output frames are owned by the bus task until it gives flush_done_
+		if (xSemaphoreTake(flush_done_[bus], 0) != pdTRUE) {
+			// One late frame per write holding back changes, not per loop() pass
+			if (!late_counted_[bus] && hasDirtyChannels(bus)) {
+				frame_stats_[bus].late++;
+				late_counted_[bus] = true;
+			}
+			continue;
+		}
+		
+		if (!budget_updated && hasDirtyChannels(bus)) {
+			updatePowerBudget();
+			budget_updated = true;
+		}
+		late_counted_[bus] = false;
+		commitBus(bus);
+		xTaskNotifyGive(flush_tasks_[bus]);
+	}
+}
+
+bool ModuleManager::waitFlushIdle() {
+	bool idle = true;
+	for (uint8_t bus = 0; bus < PCA9685Module::BUS_COUNT; bus++) {
+		if (!flush_tasks_[bus]) {
+			continue;
+		}
+		
+		if (xSemaphoreTake(flush_done_[bus], pdMS_TO_TICKS(FLUSH_IDLE_TIMEOUT_MS)) == pdTRUE) {
+			xSemaphoreGive(flush_done_[bus]);
+		} else {
+			LOG_WARNING("[MODULEMGR] Bus %d flush timeout\n", bus);
+			idle = false;
+		}
+	}
+	return idle;
+}
+
+void ModuleManager::runDriverBench(uint8_t bus, uint16_t rounds) {
+	if (bus >= PCA9685Module::BUS_COUNT || rounds == 0 || getBusModuleCount(bus) == 0) {
+		return;
+	}
+	
+	// Remember drivers: the bench forces each one on every module
+	std::vector<PCA9685Module::Driver> saved;
+	saved.reserve(modules_.size());
+	for (auto& module : modules_) {
+		saved.push_back(module ? module->getDriver() : PCA9685Module::Driver::NATIVE);
+	}
+	
+	DriverBenchResult& result = bench_results_[bus];
+	result.clock_hz = bus_clock_hz_[bus];
+	result.rounds = rounds;
+	
+	const PCA9685Module::Driver drivers[] = {PCA9685Module::Driver::NATIVE, PCA9685Module::Driver::ADAFRUIT};
+	for (PCA9685Module::Driver driver : drivers) {
+		for (auto& module : modules_) {
+			if (module && module->getBus() == bus) {
+				module->setDriver(driver);
+			}
+		}
+		
+		uint32_t total_us = 0;
+		for (uint16_t round = 0; round < rounds; round++) {
+			total_us += measureFlushTime(bus);
+		}
+		
+		if (driver == PCA9685Module::Driver::NATIVE) {
+			result.native_us = total_us / rounds;
+		} else {
+			result.adafruit_us = total_us / rounds;
+		}
+	}
+	
+	for (size_t i = 0; i < modules_.size(); i++) {
+		if (modules_[i]) {
+			modules_[i]->setDriver(saved[i]);
+		}
+	}
+	result.run = true;
+	
+	LOG_INFO("[MODULEMGR] Bus %d driver bench at %lu Hz: native %lu us, adafruit %lu us per frame\n",
+		bus, (unsigned long)result.clock_hz, (unsigned long)result.native_us, (unsigned long)result.adafruit_us);
+}
+
+uint8_t ModuleManager::getBroadcastAddress(uint8_t group) {
+	return group == BROADCAST_ALL ? PCA9685Module::ADDR_RESERVED_ALL_CALL : config.getBroadcastGroupAddress(group);
+}
+
+bool ModuleManager::writeBroadcast(uint8_t group, const uint8_t* data, size_t length) {
+	uint8_t address = getBroadcastAddress(group);
+	if (address == 0) {
+		return false;
+	}
+	
+	bool success = true;
+	for (uint8_t bus = 0; bus < PCA9685Module::BUS_COUNT; bus++) {
+		if (!isGroupInUse(bus, group)) {
+			continue;
+		}
+		
+		esp_err_t err = PCA9685Module::writeBurstTo(bus, address, data, length);
+		if (err != ESP_OK) {
+			LOG_ERROR("[MODULEMGR] Broadcast to 0x%02X on bus %d failed: %s\n", address, bus, esp_err_to_name(err));
+			success = false;
+		}
+	}
+	
+	return success;
+}
+
+bool ModuleManager::broadcastLevel(uint16_t level, uint8_t group) {
+	// Same ON/OFF encoding as a single channel, without phase offset
+	uint16_t intensity = limitBroadcastIntensity(BrightnessCurve::applyIntensity(config.getDefaultCurve(), level), group);
+	uint16_t on, off;
+	PCA9685Module::encodePwm(BrightnessCurve::toDuty(intensity), 0, on, off);
+	
+	const uint8_t data[] = {
+		PCA9685Module::REG_ALL_LED_ON_L,
+		static_cast<uint8_t>(on & 0xFF), static_cast<uint8_t>(on >> 8),
+		static_cast<uint8_t>(off & 0xFF), static_cast<uint8_t>(off >> 8)
+	};
+	
+	// Suspend flushes first so that a frame cannot overwrite the broadcast
+	for (auto& module : modules_) {
+		if (module && module->isInBroadcastGroup(group)) {
+			module->setBroadcastHold(true);
+		}
+	}
+	
+	bool success = writeBroadcast(group, data, sizeof(data));
+	
+	LOG_DEBUG("[MODULEMGR] Broadcast level %d to group %d\n", level, group);
+	
+	return success;
+}
+
+uint16_t ModuleManager::limitBroadcastIntensity(uint16_t intensity, uint8_t group) const {
+	if (config.getPowerBudget() == 0 || intensity == 0) {
+		return intensity;
+	}
+	
+	// Full rating of the target LEDs, estimate of the modules still following their frames
+	uint64_t rated_ma = 0;
+	uint64_t others_ma = 0;
+	for (const auto& module : modules_) {
+		if (!module || !module->isInitialized()) {
+			continue;
+		}
+		if (!module->isInBroadcastGroup(group)) {
+			others_ma += module->getEstimatedCurrent();
+			continue;
+		}
+		for (uint8_t i = 0; i < module->getLedCount(); i++) {
+			const LED* led = module->getLED(i);
+			rated_ma += (led && led->getRatedCurrent()) ? led->getRatedCurrent() : module->getRatedCurrent();
+		}
+	}
+	
+	uint64_t budget = config.getPowerBudget();
+	uint64_t available = budget > others_ma ? budget - others_ma : 0;
+	if (rated_ma == 0 || rated_ma * intensity <= available * BrightnessCurve::INTENSITY_MAX) {
+		return intensity;
+	}
+	
+	uint16_t limited = (available * BrightnessCurve::INTENSITY_MAX) / rated_ma;
+	LOG_WARNING("[MODULEMGR] Broadcast to group %d limited to %d/%d by the %lu mA budget\n",
+		group, limited, intensity, (unsigned long)config.getPowerBudget());
+	return limited;
+}
+
+void ModuleManager::releaseBroadcast(uint8_t group) {
+	for (auto& module : modules_) {
+		if (module && module->isBroadcastHeld() && module->isInBroadcastGroup(group)) {
+			module->setBroadcastHold(false);
+		}
+	}
+}
+
+bool ModuleManager::syncPwmPhase(uint8_t group) {
+	const uint8_t sleep[] = {PCA9685Module::REG_MODE1, PCA9685Module::MODE1_DEFAULT | PCA9685Module::MODE1_SLEEP};
+	const uint8_t wake[] = {PCA9685Module::REG_MODE1, PCA9685Module::MODE1_DEFAULT};
+	const uint8_t restart[] = {PCA9685Module::REG_MODE1, PCA9685Module::MODE1_DEFAULT | PCA9685Module::MODE1_RESTART};
+	
+	if (!writeBroadcast(group, sleep, sizeof(sleep)) || !writeBroadcast(group, wake, sizeof(wake))) {
+		return false;
+	}
+	
+	// Oscillator needs 500us to stabilize before restarting PWM
+	delayMicroseconds(500);
+	bool success = writeBroadcast(group, restart, sizeof(restart));
+	
+	LOG_DEBUG("[MODULEMGR] PWM phase synchronized on group %d\n", group);
+	
+	return success;
+}
+
+bool ModuleManager::applyBroadcastGroups() {
+	bool success = true;
+	
+	for (auto& module : modules_) {
+		if (module && module->isInitialized() && !module->applyBroadcastGroups()) {
+			LOG_WARNING("[MODULEMGR] Could not set broadcast groups of %s\n", module->getName().c_str());
+			success = false;
+		}
+	}
+	
+	// A module strapped at a group address is written by every broadcast to the group
+	for (auto& module : modules_) {
+		uint8_t group = module ? getBroadcastGroupOf(module->getAddress()) : 0;
+		if (group && isGroupInUse(module->getBus(), group)) {
+			LOG_WARNING("[MODULEMGR] Module %s on bus %d uses the address of broadcast group %d, which has members on this bus\n",
+				module->getName().c_str(), module->getBus(), group);
+		}
+	}
+	
+	return success;
+}
+
+bool ModuleManager::isGroupInUse(uint8_t bus, uint8_t group) const {
+	for (const auto& module : modules_) {
+		if (module && module->getBus() == bus && module->isInitialized() && module->isInBroadcastGroup(group)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+uint8_t ModuleManager::getBroadcastGroupOf(uint8_t address) {
+	for (uint8_t group = 1; group <= PCA9685Module::BROADCAST_GROUP_COUNT; group++) {
+		if (config.getBroadcastGroupAddress(group) == address) {
+			return group;
+		}
+	}
+	return 0;
+}
+
+void ModuleManager::requestBroadcast(BroadcastAction action, uint8_t group, uint16_t level) {
+	broadcast_group_ = group;
+	broadcast_level_ = level;
+	broadcast_action_ = action;
+}
+
+void ModuleManager::allocatePhaseOffsets() {
+	uint16_t channels = getTotalLedCount();
+	uint16_t index = 0;
+	
+	for (auto& module : modules_) {
+		if (!module) {
+			continue;
+		}
+		for (uint8_t led_index = 0; led_index < module->getLedCount(); led_index++) {
+			module->setPhaseOffset(led_index, config.isPhaseStaggerEnabled() ? PwmPhase::getOffset(index, channels) : 0);
+			index++;
+		}
+	}
+	
+	LOG_INFO("[MODULEMGR] Phase offsets %s for %d channels\n", config.isPhaseStaggerEnabled() ? "spread" : "cleared", channels);
+}
+
+void ModuleManager::handle() {
+	// Requests below use the buses directly
+	bool scan_pending = false;
+	for (uint8_t bus = 0; bus < PCA9685Module::BUS_COUNT; bus++) {
+		scan_pending = scan_pending || scan_pending_[bus];
+	}
+	if ((phase_allocation_requested_ || broadcast_action_ != BroadcastAction::NONE ||
+		bench_rounds_requested_ || bus_negotiation_requested_ || scan_pending ||
+		pwm_update_requested_ || calibration_requested_ || forget_requested_ != FORGET_NONE) && !waitFlushIdle()) {
+		// A bus task still owns its bus: requests stay queued for the next loop
+		flush();
+		return;
+	}
+	
+	if (forget_requested_ != FORGET_NONE) {
+		uint8_t index = forget_requested_;
+		forget_requested_ = FORGET_NONE;
+		forgetModule(index);
+	}
+	
+	if (scan_pending && attachFoundModules() > 0) {
+		phase_allocation_requested_ = true;
+	}
+	
+	if (phase_allocation_requested_) {
+		phase_allocation_requested_ = false;
+		allocatePhaseOffsets();
+	}
+	
+	if (pwm_update_requested_) {
+		pwm_update_requested_ = false;
+		updatePwmFrequencies();
+	}
+	
+	if (calibration_requested_) {
+		calibration_requested_ = false;
+		runOscillatorCalibration();
+	}
+	
+	if (broadcast_action_ != BroadcastAction::NONE) {
+		BroadcastAction action = broadcast_action_;
+		broadcast_action_ = BroadcastAction::NONE;
+		
+		switch (action) {
+			case BroadcastAction::LEVEL:
+				broadcastLevel(broadcast_level_, broadcast_group_);
+				break;
+			case BroadcastAction::RELEASE:
+				releaseBroadcast(broadcast_group_);
+				break;
+			case BroadcastAction::SYNC:
+				syncPwmPhase(broadcast_group_);
+				break;
+			case BroadcastAction::APPLY_GROUPS:
+				applyBroadcastGroups();
+				break;
+			default:
+				break;
+		}
+	}
+	
+	if (bench_rounds_requested_) {
+		uint16_t rounds = bench_rounds_requested_;
+		bench_rounds_requested_ = 0;
+		for (uint8_t bus = 0; bus < PCA9685Module::BUS_COUNT; bus++) {
+			runDriverBench(bus, rounds);
+		}
+	}
+	
+	if (bus_negotiation_requested_) {
+		bus_negotiation_requested_ = false;
+		for (uint8_t bus = 0; bus < PCA9685Module::BUS_COUNT; bus++) {
+			if (getBusModuleCount(bus) > 0) {
+				negotiateBusSpeed(bus);
+			}
+		}
+	}
+	
+	flush();
+}
+
+void ModuleManager::updatePowerBudget() {
+	const uint8_t priorities = PCA9685Module::POWER_PRIORITIES;
+	
+	uint64_t demand[priorities] = {};
+	uint64_t total = 0;
+	for (auto& module : modules_) {
+		if (module && module->isInitialized()) {
+			module->updatePowerDemand();
+			const uint32_t* module_demand = module->getPowerDemand();
+			for (uint8_t i = 0; i < priorities; i++) {
+				demand[i] += module_demand[i];
+				total += module_demand[i];
+			}
+		}
+	}
+	
+	// Target scales, in the same units as the demand: no per-LED division
+	uint32_t target[priorities];
+	uint64_t budget = static_cast<uint64_t>(config.getPowerBudget()) * BrightnessCurve::INTENSITY_MAX;
+	bool limited = config.getPowerBudget() > 0 && total > budget;
+	for (uint8_t i = 0; i < priorities; i++) {
+		target[i] = PCA9685Module::POWER_SCALE_ONE;
+	}
+	if (limited && config.getPowerMode() == POWER_FAIR) {
+		for (uint8_t i = 0; i < priorities; i++) {
+			target[i] = (budget << 16) / total;
+		}
+	} else if (limited) {
+		// Highest priorities are served first, the rest share what remains
+		uint64_t remaining = budget;
+		for (int8_t i = priorities - 1; i >= 0; i--) {
+			if (demand[i] <= remaining) {
+				remaining -= demand[i];
+			} else {
+				target[i] = (remaining << 16) / demand[i];
+				remaining = 0;
+			}
+		}
+	}
+	
+	// Scale down at once to protect the supply, recover smoothly
+	unsigned long now = millis();
+	uint32_t elapsed = std::min<uint32_t>(now - last_power_update_, static_cast<uint32_t>(POWER_RELEASE_MS));
+	uint32_t recovery = (elapsed * PCA9685Module::POWER_SCALE_ONE) / POWER_RELEASE_MS;
+	last_power_update_ = now;
+	
+	uint64_t estimated = 0;
+	for (uint8_t i = 0; i < priorities; i++) {
+		if (target[i] < power_scale_[i]) {
+			power_scale_[i] = target[i];
+		} else {
+			power_scale_[i] = std::min(target[i], power_scale_[i] + recovery);
+		}
+		estimated += (demand[i] * power_scale_[i]) >> 16;
+	}
+	
+	for (auto& module : modules_) {
+		if (module && module->isInitialized()) {
+			module->setPowerScales(power_scale_);
+		}
+	}
+	
+	power_stats_.demand_ma = total / BrightnessCurve::INTENSITY_MAX;
+	power_stats_.estimated_ma = estimated / BrightnessCurve::INTENSITY_MAX;
+	if (limited) {
+		power_stats_.limited_frames++;
+		if (!power_stats_.limited) {
+			LOG_WARNING("[MODULEMGR] LED current %lu mA over the %lu mA budget, dimming\n", (unsigned long)power_stats_.demand_ma, (unsigned long)config.getPowerBudget());
+		}
+	}
+	power_stats_.limited = limited;
+}
+
+void ModuleManager::requestOscillatorCalibration(uint8_t module_index, uint8_t led_index, uint8_t pin) {
+	calibration_.run = false;
+	calibration_.success = false;
+	calibration_.module = module_index;
+	calibration_.led = led_index;
+	calibration_.pin = pin;
+	calibration_.oscillator_hz = 0;
+	calibration_requested_ = true;
+}
+
+bool ModuleManager::requestForget(uint8_t index) {
+	const PCA9685Module* module = getModule(index);
+	if (!module || module->isInitialized() || forget_requested_ != FORGET_NONE) {
+		return false;
+	}
+	forget_requested_ = index;
+	return true;
+}
+
+void ModuleManager::updatePwmFrequencies() {
+	for (auto& module : modules_) {
+		if (module && module->isInitialized() && module->getTargetPrescale() != module->getPrescale()) {
+			module->applyPwmFrequency();
+		}
+	}
+}
+
+void ModuleManager::runOscillatorCalibration() {
+	uint8_t module_index = calibration_.module;
+	PCA9685Module* module = getModule(module_index);
+	uint32_t oscillator_hz = module ? module->calibrateOscillator(calibration_.led, calibration_.pin) : 0;
+	
+	calibration_.oscillator_hz = oscillator_hz;
+	calibration_.success = oscillator_hz != 0 && module->setOscillatorFrequency(oscillator_hz);
+	calibration_.run = true;
+	
+	// Same frequency setting, now computed from the real oscillator
+	if (calibration_.success) {
+		module->applyPwmFrequency();
+		StorageManager::save_module_config(module_index);
+	}
+}
+
+void ModuleManager::printModuleInfo() const {
+	LOG_INFO("[MODULEMGR] === PCA9685 Module Information ===\n");
+	LOG_INFO("[MODULEMGR] Total modules: %d\n", modules_.size());
+	LOG_INFO("[MODULEMGR] Initialized modules: %d\n", getInitializedModuleCount());
+	LOG_INFO("[MODULEMGR] Total LEDs: %d\n", getTotalLedCount());
+
+	for (size_t i = 0; i < modules_.size(); i++) {
+		const auto& module = modules_[i];
+		if (module) {
+			LOG_INFO("[MODULEMGR] Module %d: %s (bus %d, 0x%02X) - %s - %d LEDs - %.1f Hz PWM\n",
+				i,
+				module->getName().c_str(),
+				module->getBus(),
+				module->getAddress(),
+				module->isInitialized() ? "INITIALIZED" : module->isDetected() ? "FAILED" : "MISSING",
+				module->getLedCount(),
+				module->getActualPwmFrequency());
+		}
+	}
+}
+
+// === Private functions ===
+
+uint8_t ModuleManager::scanModules(uint8_t bus) {
+	LOG_INFO("[MODULEMGR] Scanning I2C bus %d for PCA9685 modules...\n", bus);
+	
+	TwoWire& wire = PCA9685Module::getBusWire(bus);
+	uint8_t found_count = 0;
+	
+	for (uint8_t addr = config.getPca9685AddrMin(); addr <= config.getPca9685AddrMax(); addr++) {
+		if (!isScanCandidate(bus, addr)) {
+			continue;
+		}
+		
+		wire.beginTransmission(addr);
+		uint8_t error = wire.endTransmission();
+		
+		if (error == 0) {
+			// Device found, check if it's a PCA9685
+			if (PCA9685Module::isPCA9685Device(addr, wire)) {
+				int index = findModule(bus, addr);
+				if (index < 0) {
+					// New module, first free ID (isScanCandidate() checked there is one)
+					index = findFreeModuleIndex();
+					if (index == (int)modules_.size()) {
+						modules_.emplace_back();
+					}
+					modules_[index].reset(new PCA9685Module(addr, config.getPca9685LedMax(), bus));
+				}
+				modules_[index]->setDetected(true); // Mark as detected
+				
+				LOG_INFO("[MODULEMGR] PCA9685 found on bus %d at address 0x%02X (module %d)\n", bus, addr, index);
+				if (getBroadcastGroupOf(addr)) {
+					LOG_WARNING("[MODULEMGR] Module %d uses the address of broadcast group %d, keep that group empty on bus %d\n",
+						index, getBroadcastGroupOf(addr), bus);
+				}
+				
+				found_count++;
+			}
+		}
+	}
+	
+	LOG_INFO("[MODULEMGR] PCA9685 modules detected on bus %d: %d\n", bus, found_count);
+	
+	return found_count;
+}
+
+uint8_t ModuleManager::initializeModules() {
+	uint8_t initialized_count = 0;
+	
+	for (size_t i = 0; i < modules_.size(); i++) {
+		auto& module = modules_[i];
+		if (!module) {
+			continue;
+		}
+		
+		if (!module->isDetected()) {
+			LOG_WARNING("[MODULEMGR] Module %d (bus %d, 0x%02X) is missing\n", i, module->getBus(), module->getAddress());
+		} else if (module->initialize()) {
+			initialized_count++;
+		}
+		
+		// Setup default LEDs with proper module index
+		module->setupDefaultLeds(i);
 	}
 	
 	return initialized_count;
-}
\ No newline at end of file
+}
+
+uint8_t ModuleManager::restoreModuleMap() {
+	std::vector<uint8_t> entries;
+	if (!StorageManager::load_module_map(entries)) {
+		return 0;
+	}
+	
+	uint8_t restored_count = 0;
+	for (uint8_t entry : entries) {
+		if (modules_.size() >= config.getPca9685ModuleMax()) {
+			LOG_WARNING("[MODULEMGR] Module map longer than the module table, %d entries ignored\n", entries.size() - modules_.size());
+			break;
+		}
+		
+		// Forgotten module, free ID
+		if (entry == 0) {
+			modules_.emplace_back();
+			continue;
+		}
+		
+		// Not detected until the scan finds it
+		uint8_t bus = entry >> 7;
+		uint8_t address = entry & 0x7F;
+		modules_.emplace_back(new PCA9685Module(address, config.getPca9685LedMax(), bus));
+		restored_count++;
+	}
+	
+	LOG_INFO("[MODULEMGR] Module map restored: %d modules, %d IDs\n", restored_count, modules_.size());
+	
+	return restored_count;
+}
+
+int ModuleManager::findModule(uint8_t bus, uint8_t address) const {
+	for (size_t i = 0; i < modules_.size(); i++) {
+		const auto& module = modules_[i];
+		if (module && module->getBus() == bus && module->getAddress() == address) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+int ModuleManager::findFreeModuleIndex() const {
+	for (size_t i = 0; i < modules_.size(); i++) {
+		if (!modules_[i]) {
+			return i;
+		}
+	}
+	return modules_.size() < config.getPca9685ModuleMax() ? (int)modules_.size() : -1;
+}
+
+bool ModuleManager::forgetModule(uint8_t index) {
+	// The module may have come back since the request
+	PCA9685Module* module = getModule(index);
+	if (!module || module->isInitialized()) {
+		LOG_WARNING("[MODULEMGR] Module %d not forgotten: unknown or present\n", index);
+		return false;
+	}
+	
+	// Readers in other tasks may still hold the module: retire it, never delete it
+	retired_modules_.push_back(std::move(modules_[index]));
+	
+	StorageManager::clear_module_config(index);
+	StorageManager::save_module_map();
+	
+	LOG_INFO("[MODULEMGR] Module %d (bus %d, 0x%02X) forgotten, ID is free\n", index, module->getBus(), module->getAddress());
+	
+	return true;
+}
+
+bool ModuleManager::isScanCandidate(uint8_t bus, uint8_t address) const {
+	// Every PCA9685 answers "All Call" from power-on
+	if (address == PCA9685Module::ADDR_RESERVED_ALL_CALL) {
+		return false;
+	}
+	
+	// Group members answer the group address, other boards may be strapped there
+	uint8_t group = getBroadcastGroupOf(address);
+	if (group && isGroupInUse(bus, group)) {
+		return false;
+	}
+	
+	// Working modules are watched by the health checks
+	int index = findModule(bus, address);
+	if (index >= 0) {
+		return !modules_[index]->isInitialized();
+	}
+	
+	return findFreeModuleIndex() >= 0;
+}
+
+void ModuleManager::serviceScan(uint8_t bus) {
+	unsigned long now = millis();
+	if (!config.isHotplugScanEnabled() || !isBusEnabled(bus) || scan_pending_[bus] ||
+		now - last_scan_step_[bus] < SCAN_INTERVAL_MS) {
+		return;
+	}
+	last_scan_step_[bus] = now;
+	
+	TwoWire& wire = PCA9685Module::getBusWire(bus);
+	ScanStats& stats = scan_stats_[bus];
+	uint8_t addr_min = config.getPca9685AddrMin();
+	uint8_t addr_max = config.getPca9685AddrMax();
+	uint8_t range = addr_max - addr_min + 1;
+	
+	unsigned long start = micros();
+	uint8_t probes = 0;
+	for (uint8_t step = 0; step < range && probes < SCAN_PROBES_PER_STEP && micros() - start < SCAN_BUDGET_US; step++) {
+		if (stats.next_address < addr_min || stats.next_address > addr_max) {
+			stats.next_address = addr_min;
+		}
+		uint8_t address = stats.next_address++;
+		if (stats.next_address > addr_max) {
+			stats.passes++;
+		}
+		
+		if (!isScanCandidate(bus, address)) {
+			continue;
+		}
+		
+		probes++;
+		stats.probes++;
+		
+		wire.beginTransmission(address);
+		if (wire.endTransmission() == 0 && PCA9685Module::isPCA9685Device(address, wire)) {
+			scan_found_[bus][address >> 5] |= 1u << (address & 0x1F);
+			scan_pending_[bus] = true;
+			stats.found++;
+		}
+	}
+	
+	stats.last_step_us = micros() - start;
+}
+
+uint8_t ModuleManager::attachFoundModules() {
+	uint8_t attached_count = 0;
+	
+	for (uint8_t bus = 0; bus < PCA9685Module::BUS_COUNT; bus++) {
+		if (!scan_pending_[bus]) {
+			continue;
+		}
+		
+		uint8_t bus_attached = 0;
+		for (uint8_t address = 0; address < 128; address++) {
+			uint32_t bit = 1u << (address & 0x1F);
+			if (scan_found_[bus][address >> 5] & bit) {
+				scan_found_[bus][address >> 5] &= ~bit;
+				if (attachModule(bus, address)) {
+					bus_attached++;
+				}
+			}
+		}
+		scan_pending_[bus] = false;
+		
+		// Transaction buffers are sized for the module count
+		if (bus_attached > 0 && linked_cmd_[bus]) {
+			linked_cmd_[bus].reset();
+			linked_tx_[bus].reset();
+			allocateLinkedBuffers(bus);
+		}
+		attached_count += bus_attached;
+	}
+	
+	// A module on a bus that had none needs its task
+	if (attached_count > 0) {
+		startFlushTasks();
+	}
+	
+	return attached_count;
+}
+
+bool ModuleManager::attachModule(uint8_t bus, uint8_t address) {
+	int index = findModule(bus, address);
+	bool added = index < 0;
+	
+	if (added) {
+		index = findFreeModuleIndex();
+		if (index < 0) {
+			LOG_WARNING("[MODULEMGR] PCA9685 found on bus %d at 0x%02X but the module table is full\n", bus, address);
+			return false;
+		}
+		if (index == (int)modules_.size()) {
+			modules_.emplace_back();
+		}
+		modules_[index].reset(new PCA9685Module(address, config.getPca9685LedMax(), bus));
+	}
+	
+	PCA9685Module* module = modules_[index].get();
+	module->setDetected(true);
+	
+	// Tried again by the next scan pass on failure
+	if (!module->initialize()) {
+		return false;
+	}
+	
+	if (added) {
+		module->setupDefaultLeds(index);
+		StorageManager::save_module_map();
+	} else {
+		// Missing module: LEDs kept their configuration and programs, write them all
+		for (uint8_t led_index = 0; led_index < module->getLedCount(); led_index++) {
+			module->applyLedBrightness(led_index);
+		}
+	}
+	
+	module->applyBroadcastGroups();
+	
+	LOG_INFO("[MODULEMGR] PCA9685 %s on bus %d at 0x%02X as module %d\n", added ? "added" : "back", bus, address, index);
+	if (getBroadcastGroupOf(address)) {
+		LOG_WARNING("[MODULEMGR] Module %d uses the address of broadcast group %d, keep that group empty on bus %d\n",
+			index, getBroadcastGroupOf(address), bus);
+	}
+	
+	return true;
+}
+
+bool ModuleManager::verifyAllModules(uint8_t bus, uint8_t rounds) {
+	for (auto& module : modules_) {
+		if (!module || module->getBus() != bus || !module->isInitialized()) {
+			continue;
+		}
+		for (uint8_t round = 0; round < rounds; round++) {
+			if (!module->verifyRegisters()) {
+				return false;
+			}
+		}
+	}
+	
+	return true;
+}
+
+void ModuleManager::flushBus(uint8_t bus) {
+	commitBus(bus);
+	writeBus(bus);
+}
+
+void ModuleManager::commitBus(uint8_t bus) {
+	for (auto& module : modules_) {
+		if (module && module->getBus() == bus) {
+			module->commitFrame();
+		}
+	}
+}
+
+bool ModuleManager::hasDirtyChannels(uint8_t bus) const {
+	for (const auto& module : modules_) {
+		if (module && module->getBus() == bus && module->hasDirtyChannels()) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void ModuleManager::writeBus(uint8_t bus) {
+	if (config.isLinkedFramesEnabled() && linked_cmd_[bus]) {
+		writeBusLinked(bus);
+		return;
+	}
+	
+	for (auto& module : modules_) {
+		if (module && module->getBus() == bus && module->hasFrameToWrite()) {
+			module->writeFrame();
+		}
+	}
+}
+
+/**
+ * @internal
+ * The PCA9685 applies LED register writes at the STOP condition (MODE2 OCH
+ * cleared), including for a STOP that ends a transaction addressing several
+ * devices with repeated STARTs, which is how outputs of several chips are
+ * synchronized.
+ */
+void ModuleManager::writeBusLinked(uint8_t bus) {
+	std::vector<PCA9685Module*>& linked = linked_modules_[bus];
+	linked.clear();
+	
+	i2c_cmd_handle_t cmd = i2c_cmd_link_create_static(reinterpret_cast<uint8_t*>(linked_cmd_[bus].get()), linked_cmd_size_[bus]);
+	if (!cmd) {
+		return;
+	}
+	
+	uint8_t* out = linked_tx_[bus].get();
+	for (auto& module : modules_) {
+		if (!module || module->getBus() != bus || !module->hasFrameToWrite() ||
+			module->isBroadcastHeld() || module->getHealth() == PCA9685Module::Health::OFFLINE) {
+			continue;
+		}
+		
+		// Adafruit modules cannot join the transaction
+		if (module->getDriver() != PCA9685Module::Driver::NATIVE) {
+			module->writeFrame();
+			continue;
+		}
+		
+		size_t length = module->encodeFrame(out);
+		i2c_master_start(cmd);
+		i2c_master_write_byte(cmd, (module->getAddress() << 1) | I2C_MASTER_WRITE, true);
+		i2c_master_write(cmd, out, length, true);
+		out += length;
+		linked.push_back(module.get());
+	}
+	
+	esp_err_t err = ESP_OK;
+	if (!linked.empty()) {
+		i2c_master_stop(cmd);
+		err = i2c_master_cmd_begin(static_cast<i2c_port_t>(bus), cmd, pdMS_TO_TICKS(PCA9685Module::TRANSACTION_TIMEOUT_MS * linked.size()));
+	}
+	i2c_cmd_link_delete_static(cmd);
+	
+	if (err == ESP_OK) {
+		for (PCA9685Module* module : linked) {
+			module->markFrameWritten();
+			module->recordTransaction(ESP_OK);
+		}
+		return;
+	}
+	
+	// One missing module aborts the whole transaction, let the others through
+	frame_stats_[bus].linked_failures++;
+	for (PCA9685Module* module : linked) {
+		module->writeFrame();
+	}
+}
+
+void ModuleManager::serviceHealth(uint8_t bus) {
+	unsigned long now = millis();
+	if (now - last_health_check_[bus] < HEALTH_CHECK_INTERVAL_MS || modules_.empty()) {
+		return;
+	}
+	last_health_check_[bus] = now;
+	
+	// Offline modules whose back-off expired come first
+	for (auto& module : modules_) {
+		if (module && module->getBus() == bus && module->isInitialized() && module->isRetryDue()) {
+			module->checkHealth();
+			return;
+		}
+	}
+	
+	// Otherwise one module per interval, round robin
+	for (size_t tried = 0; tried < modules_.size(); tried++) {
+		uint8_t index = health_cursor_[bus];
+		health_cursor_[bus] = (index + 1) % modules_.size();
+		
+		auto& module = modules_[index];
+		if (module && module->getBus() == bus && module->isInitialized() &&
+			module->getHealth() != PCA9685Module::Health::OFFLINE) {
+			module->checkHealth();
+			return;
+		}
+	}
+}
+
+void ModuleManager::allocateLinkedBuffers(uint8_t bus) {
+	uint8_t count = getBusModuleCount(bus);
+	if (count == 0 || linked_cmd_[bus]) {
+		return;
+	}
+	
+	linked_cmd_size_[bus] = I2C_LINK_RECOMMENDED_SIZE(count);
+	linked_cmd_[bus].reset(new (std::nothrow) uint32_t[(linked_cmd_size_[bus] + 3) / 4]);
+	linked_tx_[bus].reset(new (std::nothrow) uint8_t[count * (1 + 4 * PCA9685Module::LED_MAX)]);
+	linked_modules_[bus].reserve(count);
+	
+	if (!linked_cmd_[bus] || !linked_tx_[bus]) {
+		linked_cmd_[bus].reset();
+		linked_tx_[bus].reset();
+		LOG_ERROR("[MODULEMGR] Not enough memory for bus %d linked frames\n", bus);
+	}
+}
+
+void ModuleManager::startFlushTasks() {
+	for (uint8_t bus = 0; bus < PCA9685Module::BUS_COUNT; bus++) {
+		if (flush_tasks_[bus] || !isBusEnabled(bus) || getBusModuleCount(bus) == 0) {
+			continue;
+		}
+		
+		allocateLinkedBuffers(bus);
+		
+		// Given while the bus is idle
+		if (!flush_done_[bus]) {
+			flush_done_[bus] = xSemaphoreCreateBinary();
+			if (flush_done_[bus]) {
+				xSemaphoreGive(flush_done_[bus]);
+			}
+		}
+		
+		flush_contexts_[bus].manager = this;
+		flush_contexts_[bus].bus = bus;
+		
+		// Same priority as loop(), on the other core so rendering goes on during transfers
+		char name[configMAX_TASK_NAME_LEN];
+		snprintf(name, sizeof(name), "i2c_bus%d", bus);
+		if (!flush_done_[bus] || xTaskCreatePinnedToCore(flushTaskEntry, name, 4096, &flush_contexts_[bus], 1, &flush_tasks_[bus], 0) != pdPASS) {
+			flush_tasks_[bus] = nullptr;
+			LOG_ERROR("[MODULEMGR] Failed to create bus %d flush task, bus will be flushed from loop()\n", bus);
+			continue;
+		}
+		
+		LOG_INFO("[MODULEMGR] Bus %d flush task started\n", bus);
+	}
+}
+
+void ModuleManager::flushTaskEntry(void* param) {
+	FlushTaskContext* context = static_cast<FlushTaskContext*>(param);
+	ModuleManager* manager = context->manager;
+	uint8_t bus = context->bus;
+	
+	for (;;) {
+		ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+		
+		unsigned long start = micros();
+		manager->writeBus(bus);
+		manager->frame_stats_[bus].last_write_us = micros() - start;
+		manager->frame_stats_[bus].frames++;
+		
+		manager->serviceHealth(bus);
+		manager->serviceScan(bus);
+		
+		xSemaphoreGive(manager->flush_done_[bus]);
+	}
+}
@@ -1,1045 +1,1838 @@
-/**
- * SPDX-FileCopyrightText: 2025 Jérôme SONRIER
- * SPDX-License-Identifier: GPL-3.0-or-later
- *
- * @file program.cpp
- * @brief Implementation of LED program management system
- * 
- * This file implements the ProgramManager class and all LED animation programs.
- * It provides various visual effects including welding simulation, heartbeat,
- * railway signals, level crossing warnings, and breathing effects.
- * 
- * The program manager works directly with LED objects in PCA9685 modules to
- * control brightness and create smooth animations with realistic timing.
- * 
- * See program.h for API documentation.
- * 
- * @author  Jérôme SONRIER <jsid@emor3j.fr.eu.org>
- * @date    2025-09-10
- */
-
-#include "program.h"
-#include "config.h"
-#include "pca9685.h"
-#include "storage.h"
-#include "log.h"
-
-
-/// Global instance
-std::unique_ptr<ProgramManager> program_manager;
-
-// === Welding Program Parameters ===
-/// @defgroup welding_params Welding Program Parameters
-/// @brief Configuration constants for the welding arc simulation effect
-/// @{
-
-/// Minimum interval between welding flashes (milliseconds)
-const unsigned long WELDING_MIN_INTERVAL = 10;
-/// Maximum interval between welding flashes (milliseconds)
-const unsigned long WELDING_MAX_INTERVAL = 300;
-/// Minimum duration of a welding flash (milliseconds)
-const unsigned long WELDING_MIN_DURATION = 10;
-/// Maximum duration of a welding flash (milliseconds)
-const unsigned long WELDING_MAX_DURATION = 100;
-/// Minimum intensity for welding flashes (0-4095)
-const uint16_t WELDING_MIN_INTENSITY = 10;
-/// Maximum intensity for welding flashes (0-4095)
-const uint16_t WELDING_MAX_INTENSITY = 3000;
-
-/// @}
-
-// === Heartbeat Program Parameters ===
-/// @defgroup heartbeat_params Heartbeat Program Parameters
-/// @brief Configuration constants for the heartbeat rhythm effect
-/// @{
-
-/// Total duration of one complete heartbeat cycle (milliseconds)
-const unsigned long HEARTBEAT_CYCLE_DURATION = 1000;
-/// Duration of the first heartbeat pulse (systole) (milliseconds)
-const unsigned long HEARTBEAT_BEAT1_DURATION = 100;
-/// Duration of pause after first beat (milliseconds)
-const unsigned long HEARTBEAT_PAUSE1_DURATION = 80;
-/// Duration of the second heartbeat pulse (diastole) (milliseconds)
-const unsigned long HEARTBEAT_BEAT2_DURATION = 60;
-/// Duration of pause after second beat (milliseconds)
-const unsigned long HEARTBEAT_PAUSE2_DURATION = 760;
-/// Maximum intensity for heartbeat pulses (0-4095)
-const uint16_t HEARTBEAT_INTENSITY = 3500;
-
-/// @}
-
-// === Breathing Program Parameters ===
-/// @defgroup breathing_params Breathing Program Parameters
-/// @brief Configuration constants for the breathing effect
-/// @{
-
-/// Total duration of one complete breathing cycle (milliseconds)
-const unsigned long BREATHING_CYCLE_DURATION = 4000;
-/// Duration of the inhale phase (fade in) (milliseconds)
-const unsigned long BREATHING_INHALE_DURATION = 1500;
-/// Duration of holding breath at maximum intensity (milliseconds)
-const unsigned long BREATHING_HOLD_DURATION = 500;
-/// Duration of the exhale phase (fade out) (milliseconds)
-const unsigned long BREATHING_EXHALE_DURATION = 1500;
-/// Duration of pause at minimum intensity (milliseconds)
-const unsigned long BREATHING_PAUSE_DURATION = 500;
-/// Maximum intensity during breathing cycle (0-4095)
-const uint16_t BREATHING_MAX_INTENSITY = 4095;
-/// Minimum intensity during breathing cycle (0-4095)
-const uint16_t BREATHING_MIN_INTENSITY = 0;
-
-/// @}
-
-// === Simple Blink Program Parameters ===
-/// @defgroup blink_params Simple Blink Program Parameters
-/// @brief Configuration constants for the simple blinking effect
-/// @{
-
-/// Duration of ON phase (milliseconds)
-const unsigned long SIMPLE_BLINK_ON_DURATION = 1000;
-/// Duration of OFF phase (milliseconds)
-const unsigned long SIMPLE_BLINK_OFF_DURATION = 1000;
-/// Intensity for blink ON state (0-4095)
-const uint16_t SIMPLE_BLINK_INTENSITY = 4095;
-
-/// @}
-
-// === TV Flicker Program Parameters ===
-/// @defgroup tv_flicker_params TV Flicker Program Parameters
-/// @brief Configuration constants for TV screen flickering effect
-/// @{
-
-/// Base intensity for TV flicker (0-4095)
-const uint16_t TV_FLICKER_BASE_INTENSITY = 800;
-/// Maximum intensity for TV flicker (0-4095)
-const uint16_t TV_FLICKER_MAX_INTENSITY = 2500;
-/// Minimum intensity for TV flicker (0-4095)
-const uint16_t TV_FLICKER_MIN_INTENSITY = 200;
-/// Minimum interval between flicker changes (milliseconds)
-const unsigned long TV_FLICKER_MIN_INTERVAL = 40;
-/// Maximum interval between flicker changes (milliseconds)
-const unsigned long TV_FLICKER_MAX_INTERVAL = 200;
-/// Probability of a bright flash (0-100)
-const uint8_t TV_FLICKER_FLASH_PROBABILITY = 15;
-/// Probability of a dim period (0-100)
-const uint8_t TV_FLICKER_DIM_PROBABILITY = 10;
-
-/// @}
-
-// === Firebox Glow Program Parameters ===
-/// @defgroup firebox_params Firebox Glow Program Parameters
-/// @brief Configuration constants for wood fire simulation effect
-/// @{
-
-/// Base intensity for wood fire (0-4095)
-const uint16_t FIREBOX_BASE_INTENSITY = 2200;
-/// Maximum intensity for wood fire (0-4095)
-const uint16_t FIREBOX_MAX_INTENSITY = 4095;
-/// Minimum intensity for wood fire (0-4095)
-const uint16_t FIREBOX_MIN_INTENSITY = 1200;
-/// Minimum interval between flame changes (milliseconds)
-const unsigned long FIREBOX_MIN_INTERVAL = 60;
-/// Maximum interval between flame changes (milliseconds)
-const unsigned long FIREBOX_MAX_INTERVAL = 400;
-/// Probability of ember pop/crack (0-100)
-const uint8_t FIREBOX_EMBER_POP_PROBABILITY = 15;
-/// Probability of strong flame surge (0-100)
-const uint8_t FIREBOX_FLAME_SURGE_PROBABILITY = 8;
-/// Probability of wind gust effect (0-100)
-const uint8_t FIREBOX_WIND_GUST_PROBABILITY = 5;
-/// Duration of ember pop effect (milliseconds)
-const unsigned long FIREBOX_EMBER_DURATION = 150;
-/// Duration of flame surge effect (milliseconds)
-const unsigned long FIREBOX_SURGE_DURATION = 800;
-/// Duration of wind gust effect (milliseconds)
-const unsigned long FIREBOX_WIND_DURATION = 1200;
-
-/// @}
-
-// === Candle Flicker Program Parameters ===
-/// @defgroup candle_params Candle Flicker Program Parameters
-/// @brief Configuration constants for candle flame flickering effect
-/// @{
-
-/// Base intensity for candle flame (0-4095)
-const uint16_t CANDLE_BASE_INTENSITY = 2800;
-/// Maximum intensity for candle flame (0-4095)
-const uint16_t CANDLE_MAX_INTENSITY = 3800;
-/// Minimum intensity for candle flame (0-4095)
-const uint16_t CANDLE_MIN_INTENSITY = 1800;
-/// Minimum interval between flicker changes (milliseconds)
-const unsigned long CANDLE_MIN_INTERVAL = 50;
-/// Maximum interval between flicker changes (milliseconds)
-const unsigned long CANDLE_MAX_INTERVAL = 300;
-/// Probability of a strong flicker (0-100)
-const uint8_t CANDLE_STRONG_FLICKER_PROBABILITY = 12;
-/// Probability of a gentle dip (0-100)
-const uint8_t CANDLE_DIP_PROBABILITY = 8;
-
-/// @}
-
-// === French Level Crossing Program Parameters ===
-/// @defgroup french_crossing_params French Level Crossing Program Parameters
-/// @brief Configuration constants for French railway level crossing light simulation
-/// @{
-
-/// Duration of ON phase (milliseconds)
-const unsigned long FRENCH_CROSSING_ON_DURATION = 500;
-/// Duration of OFF phase (milliseconds)
-const unsigned long FRENCH_CROSSING_OFF_DURATION = 500;
-/// Maximum intensity for French crossing light (0-4095)
-const uint16_t FRENCH_CROSSING_MAX_INTENSITY = 4095;
-/// Duration of filament warm-up (milliseconds)
-const unsigned long FRENCH_CROSSING_WARMUP_DURATION = 100;
-/// Duration of filament cool-down (milliseconds)
-const unsigned long FRENCH_CROSSING_COOLDOWN_DURATION = 150;
-/// Minimum intensity during warm-up (0-4095)
-const uint16_t FRENCH_CROSSING_WARMUP_MIN = 0;
-
-/// @}
-
-bool ProgramManager::initialize() {
-	// Get assigned program
-	JsonDocument assigned = get_assigned_programs();
-	JsonArray programs = assigned["assigned_programs"];
-	
-	// Initialise all assigned program
-	for (JsonObject program : programs) {
-		uint8_t module_id = program["module_id"];
-		uint8_t led_id = program["led_id"];
-		ProgramType program_type = program["program_type"];
-
-		LOG_DEBUG("[PROGRAMMGR] Initializing LED %d:%d with program %d (%s)\n",
-			module_id,
-			led_id,
-			(uint8_t)program_type,
-			get_program_name(program_type).c_str()
-		);
-		// Get LED
-		const PCA9685Module* module = module_manager->getModule(module_id);
-		if (!module || led_id >= module->getLedCount()) {
-			return false;
-		}
-		
-		LED* led_info = module_manager->getLED(module_id, led_id);
-		if (!led_info) {
-			return false;
-		}
-
-		// Create new program state
-		if (led_info->getProgramState() != nullptr) {
-			delete led_info->getProgramState();
-		}
-		led_info->setProgram(program_type, new ProgramState());
-		initialize_led_state(module_id, led_id);
-	}
-
-	return true;
-}
-
-void ProgramManager::update(unsigned long current_millis) {
-	if (!module_manager) return;
-	
-	for (uint8_t i = 0; i < module_manager->getModuleCount(); i++) {
-		const PCA9685Module* module = module_manager->getModule(i);
-		if (!module) continue;
-		
-		for (uint8_t j = 0; j < module->getLedCount(); j++) {
-			LED* led_info = module_manager->getLED(i, j);
-			if (!led_info) continue;
-			
-			// If LED is active and has assigned program
-			if (led_info->isEnabled() && led_info->getProgramType() != PROGRAM_NONE && led_info->getProgramState() != nullptr) {
-				switch (led_info->getProgramType()) {
-					case PROGRAM_WELDING:
-						update_welding_program(i, j, current_millis);
-						break;
-					case PROGRAM_HEARTBEAT:
-						update_heartbeat_program(i, j, current_millis);
-						break;
-					case PROGRAM_BREATHING:
-						update_breathing_program(i, j, current_millis);
-						break;
-					case PROGRAM_SIMPLE_BLINK:
-						update_simple_blink_program(i, j, current_millis);
-						break;
-					case PROGRAM_TV_FLICKER:
-						update_tv_flicker_program(i, j, current_millis);
-						break;
-					case PROGRAM_FIREBOX_GLOW:
-						update_firebox_glow_program(i, j, current_millis);
-						break;
-					case PROGRAM_CANDLE_FLICKER:
-						update_candle_flicker_program(i, j, current_millis);
-						break;
-					case PROGRAM_FRENCH_CROSSING:
-						update_french_crossing_program(i, j, current_millis);
-						break;
-					default:
-						break;
-				}
-			}
-		}
-	}
-}
-
-bool ProgramManager::assign_program(uint8_t module_id, uint8_t led_id, ProgramType program_type) {
-	if (!module_manager || module_id >= module_manager->getModuleCount()) {
-		return false;
-	}
-	
-	const PCA9685Module* module = module_manager->getModule(module_id);
-	if (!module || led_id >= module->getLedCount()) {
-		return false;
-	}
-	
-	LED* led_info = module_manager->getLED(module_id, led_id);
-	if (!led_info) {
-		return false;
-	}
-	
-	if (program_type == PROGRAM_NONE) {
-		return unassign_program(module_id, led_id);
-	}
-	
-	// Create new program state
-	if (led_info->getProgramState() != nullptr) {
-		delete led_info->getProgramState();
-	}
-	led_info->setProgram(program_type, new ProgramState());
-	initialize_led_state(module_id, led_id);
-	
-	LOG_INFO("[PROGRAMMGR] Program %d(%s) assigned to LED %d:%d\n", 
-		program_type,
-		get_program_name(program_type).c_str(), 
-		module_id, 
-		led_id);
-	
-	return true;
-}
-
-bool ProgramManager::unassign_program(uint8_t module_id, uint8_t led_id) {
-	if (!module_manager || module_id >= module_manager->getModuleCount()) {
-		return false;
-	}
-	
-	const PCA9685Module* module = module_manager->getModule(module_id);
-	if (!module || led_id >= module->getLedCount()) {
-		return false;
-	}
-	
-	LED* led_info = module_manager->getLED(module_id, led_id);
-	if (!led_info) {
-		return false;
-	}
-	
-	// Delete program state memory
-	if (led_info->getProgramState() != nullptr) {
-		delete led_info->getProgramState();
-		led_info->setProgram(led_info->getProgramType(), nullptr);
-	}
-	
-	led_info->setProgram(PROGRAM_NONE, led_info->getProgramState());
-	
-	LOG_INFO("[PROGRAMMGR] Program unassigned from LED %d:%d\n", module_id, led_id);
-	
-	return true;
-}
-
-bool ProgramManager::is_program_assigned(uint8_t module_id, uint8_t led_id) {
-	if (!module_manager || module_id >= module_manager->getModuleCount()) {
-		return false;
-	}
-	
-	const LED* led = module_manager->getLED(module_id, led_id);
-	return led ? (led->getProgramType() != PROGRAM_NONE) : false;
-}
-
-ProgramType ProgramManager::get_program_type(uint8_t module_id, uint8_t led_id) {
-	if (!module_manager || module_id >= module_manager->getModuleCount()) {
-		return PROGRAM_NONE;
-	}
-	
-	const LED* led = module_manager->getLED(module_id, led_id);
-	return led ? led->getProgramType() : PROGRAM_NONE;
-}
-
-JsonDocument ProgramManager::get_available_programs() {
-	JsonDocument doc;
-	JsonArray programs = doc["programs"].to<JsonArray>();
-	
-	// Welding
-	JsonObject welding = programs.add<JsonObject>();
-	welding["id"] = PROGRAM_WELDING;
-	welding["name"] = get_program_name(PROGRAM_WELDING);
-	welding["description"] = get_program_description(PROGRAM_WELDING);
-	
-	// Heartbeat
-	JsonObject heartbeat = programs.add<JsonObject>();
-	heartbeat["id"] = PROGRAM_HEARTBEAT;
-	heartbeat["name"] = get_program_name(PROGRAM_HEARTBEAT);
-	heartbeat["description"] = get_program_description(PROGRAM_HEARTBEAT);
-
-	// Breathing
-	JsonObject breathing = programs.add<JsonObject>();
-	breathing["id"] = PROGRAM_BREATHING;
-	breathing["name"] = get_program_name(PROGRAM_BREATHING);
-	breathing["description"] = get_program_description(PROGRAM_BREATHING);
-
-	// Simple blink
-	JsonObject simple_blink = programs.add<JsonObject>();
-	simple_blink["id"] = PROGRAM_SIMPLE_BLINK;
-	simple_blink["name"] = get_program_name(PROGRAM_SIMPLE_BLINK);
-	simple_blink["description"] = get_program_description(PROGRAM_SIMPLE_BLINK);
-
-	// TV flicler
-	JsonObject tv_flicker = programs.add<JsonObject>();
-	tv_flicker["id"] = PROGRAM_TV_FLICKER;
-	tv_flicker["name"] = get_program_name(PROGRAM_TV_FLICKER);
-	tv_flicker["description"] = get_program_description(PROGRAM_TV_FLICKER);
-
-	// Firebox glow
-	JsonObject firebox = programs.add<JsonObject>();
-	firebox["id"] = PROGRAM_FIREBOX_GLOW;
-	firebox["name"] = get_program_name(PROGRAM_FIREBOX_GLOW);
-	firebox["description"] = get_program_description(PROGRAM_FIREBOX_GLOW);
-
-	// Candle flicker
-	JsonObject candle = programs.add<JsonObject>();
-	candle["id"] = PROGRAM_CANDLE_FLICKER;
-	candle["name"] = get_program_name(PROGRAM_CANDLE_FLICKER);
-	candle["description"] = get_program_description(PROGRAM_CANDLE_FLICKER);
-
-	// French crossing
-	JsonObject french_crossing = programs.add<JsonObject>();
-	french_crossing["id"] = PROGRAM_FRENCH_CROSSING;
-	french_crossing["name"] = get_program_name(PROGRAM_FRENCH_CROSSING);
-	french_crossing["description"] = get_program_description(PROGRAM_FRENCH_CROSSING);
-	
-	doc["total"] = programs.size();
-	return doc;
-}
-
-JsonDocument ProgramManager::get_assigned_programs() {
-	JsonDocument doc;
-	JsonArray programs = doc["assigned_programs"].to<JsonArray>();
-	
-	if (module_manager) {
-		for (uint8_t i = 0; i < module_manager->getModuleCount(); i++) {
-			const PCA9685Module* module = module_manager->getModule(i);
-			if (module) {
-				for (uint8_t j = 0; j < module->getLedCount(); j++) {
-					const LED* led = module->getLED(j);
-					if (led && led->getProgramType() != PROGRAM_NONE) {
-						JsonObject program = programs.add<JsonObject>();
-						program["module_id"] = i;
-						program["led_id"] = j;
-						program["program_type"] = led->getProgramType();
-						program["program_name"] = get_program_name(led->getProgramType());
-						program["enabled"] = led->isEnabled();
-					}
-				}
-			}
-		}
-	}
-	
-	doc["total"] = programs.size();
-	return doc;
-}
-
-String ProgramManager::get_program_name(ProgramType type) {
-	switch (type) {
-		case PROGRAM_WELDING: return "Welding";
-		case PROGRAM_HEARTBEAT: return "Heartbeat";
-		case PROGRAM_BREATHING: return "Breathing";
-		case PROGRAM_SIMPLE_BLINK: return "Simple Blink";
-		case PROGRAM_TV_FLICKER: return "TV Flicker";
-		case PROGRAM_FIREBOX_GLOW: return "Firebox Glow";
-		case PROGRAM_CANDLE_FLICKER: return "Candle Flicker";
-		case PROGRAM_FRENCH_CROSSING: return "French Level Crossing";
-		default: return "None";
-	}
-}
-
-String ProgramManager::get_program_description(ProgramType type) {
-	switch (type) {
-		case PROGRAM_WELDING: return "Simulates welding arc flashes with random intensity and timing";
-		case PROGRAM_HEARTBEAT: return "Simulates a heartbeat rhythm with double pulse pattern";
-		case PROGRAM_BREATHING: return "Simulates breathing";
-		case PROGRAM_SIMPLE_BLINK: return "Simple 1 second on/off blinking pattern";
-		case PROGRAM_TV_FLICKER: return "Television screen flickering with blue tint and random intensity changes";
-		case PROGRAM_FIREBOX_GLOW: return "Wood fire simulation with crackling flames, ember pops and wind effects";
-		case PROGRAM_CANDLE_FLICKER: return "Gentle candle or gas lamp flame flickering with organic variations";
-		case PROGRAM_FRENCH_CROSSING: return "French railway level crossing light with realistic filament bulb behavior";
-		default: return "No program";
-	}
-}
-
-void ProgramManager::update_welding_program(uint8_t module_id, uint8_t led_id, unsigned long current_millis) {
-	LED* led_info = module_manager->getLED(module_id, led_id);
-	if (!led_info) return;
-	ProgramState* state = led_info->getProgramState();
-	
-	if (current_millis - state->last_update < 10) {
-		return; // Update à 100Hz maximum
-	}
-	
-	// Si aucun éclat n'est actif, vérifier s'il faut en déclencher un
-	if (!state->active && current_millis >= state->next_event) {
-		// Déclencher un nouvel éclat
-		state->active = true;
-		state->start_time = current_millis;
-		
-		// Intensité aléatoire pour cet éclat
-		state->current_intensity = random(WELDING_MIN_INTENSITY, WELDING_MAX_INTENSITY + 1);
-		
-		// Programmer le prochain éclat
-		unsigned long welding_duration = random(WELDING_MIN_DURATION, WELDING_MAX_DURATION + 1);
-		unsigned long next_interval = random(WELDING_MIN_INTERVAL, WELDING_MAX_INTERVAL + 1);
-		state->next_event = current_millis + welding_duration + next_interval;
-		
-		// Activer la LED immédiatement
-		led_info->setBrightness(state->current_intensity);
-		module_manager->applyLedBrightness(module_id, led_id);
-	}
-	
-	// Si un éclat est actif, gérer son évolution
-	if (state->active) {
-		unsigned long elapsed_time = current_millis - state->start_time;
-		unsigned long current_welding_duration = (WELDING_MIN_DURATION + WELDING_MAX_DURATION) / 2;
-		
-		if (elapsed_time < current_welding_duration * 0.7) {
-			// Phase d'intensité maximale avec micro-variations
-			uint16_t variation = random(-200, 201);
-			uint16_t current_brightness = constrain(state->current_intensity + variation, 0, 4095);
-			led_info->setBrightness(current_brightness);
-			
-		} else if (elapsed_time < current_welding_duration) {
-			// Phase de fondu
-			float fade_progress = (float)(elapsed_time - current_welding_duration * 0.7) / (current_welding_duration * 0.3);
-			uint16_t current_brightness = state->current_intensity * (1.0 - fade_progress);
-			led_info->setBrightness(current_brightness);
-			
-		} else {
-			// Éclat terminé
-			state->active = false;
-			led_info->setBrightness(0);
-		}
-		
-		module_manager->applyLedBrightness(module_id, led_id);
-	}
-	
-	state->last_update = current_millis;
-}
-
-void ProgramManager::update_heartbeat_program(uint8_t module_id, uint8_t led_id, unsigned long current_millis) {
-	LED* led_info = module_manager->getLED(module_id, led_id);
-	if (!led_info) return;
-	ProgramState* state = led_info->getProgramState();
-	
-	if (current_millis - state->last_update < 20) {
-		return; // Update à 50Hz pour fluidité
-	}
-	
-	// Initialiser le cycle si nécessaire
-	if (state->start_time == 0) {
-		state->start_time = current_millis;
-	}
-	
-	unsigned long cycle_time = (current_millis - state->start_time) % HEARTBEAT_CYCLE_DURATION;
-	uint16_t target_brightness = 0;
-	
-	// Phase 1: Premier battement (systole)
-	if (cycle_time < HEARTBEAT_BEAT1_DURATION) {
-		target_brightness = HEARTBEAT_INTENSITY;
-	}
-	// Phase 2: Pause courte
-	else if (cycle_time < HEARTBEAT_BEAT1_DURATION + HEARTBEAT_PAUSE1_DURATION) {
-		target_brightness = 0;
-	}
-	// Phase 3: Second battement (diastole) - plus faible
-	else if (cycle_time < HEARTBEAT_BEAT1_DURATION + HEARTBEAT_PAUSE1_DURATION + HEARTBEAT_BEAT2_DURATION) {
-		target_brightness = HEARTBEAT_INTENSITY * 0.6; // 60% de l'intensité du premier
-	}
-	// Phase 4: Pause longue
-	else {
-		target_brightness = 0;
-	}
-	
-	led_info->setBrightness(target_brightness);
-	module_manager->applyLedBrightness(module_id, led_id);
-	
-	state->last_update = current_millis;
-}
-
-void ProgramManager::update_breathing_program(uint8_t module_id, uint8_t led_id, unsigned long current_millis) {
-	LED* led_info = module_manager->getLED(module_id, led_id);
-	if (!led_info) return;
-	ProgramState* state = led_info->getProgramState();
-   
-	if (current_millis - state->last_update < 20) {
-		return; // Update à 50Hz pour fluidité
-	}
-   
-	// Initialiser le cycle si nécessaire
-	if (state->start_time == 0) {
-		state->start_time = current_millis;
-	}
-   
-	unsigned long cycle_time = (current_millis - state->start_time) % BREATHING_CYCLE_DURATION;
-	uint16_t target_brightness = 0;
-   
-	// Phase 1: Inspiration (montée progressive)
-	if (cycle_time < BREATHING_INHALE_DURATION) {
-		float progress = (float)cycle_time / BREATHING_INHALE_DURATION;
-		// Courbe sinusoïdale pour un effet plus naturel
-		float sine_progress = sin(progress * PI / 2);
-		target_brightness = BREATHING_MAX_INTENSITY * sine_progress;
-	}
-	// Phase 2: Rétention (maintien au maximum)
-	else if (cycle_time < BREATHING_INHALE_DURATION + BREATHING_HOLD_DURATION) {
-		target_brightness = BREATHING_MAX_INTENSITY;
-	}
-	// Phase 3: Expiration (descente progressive)
-	else if (cycle_time < BREATHING_INHALE_DURATION + BREATHING_HOLD_DURATION + BREATHING_EXHALE_DURATION) {
-		unsigned long exhale_time = cycle_time - BREATHING_INHALE_DURATION - BREATHING_HOLD_DURATION;
-		float progress = (float)exhale_time / BREATHING_EXHALE_DURATION;
-		// Courbe sinusoïdale inversée pour la descente
-		float sine_progress = cos(progress * PI / 2);
-		target_brightness = BREATHING_MAX_INTENSITY * sine_progress;
-	}
-	// Phase 4: Pause (minimum/éteint)
-	else {
-		target_brightness = BREATHING_MIN_INTENSITY; // Peut être 0 ou une valeur très faible
-	}
-   
-	led_info->setBrightness(target_brightness);
-	module_manager->applyLedBrightness(module_id, led_id);
-   
-	state->last_update = current_millis;
-}
-
-void ProgramManager::update_simple_blink_program(uint8_t module_id, uint8_t led_id, unsigned long current_millis) {
-	LED* led_info = module_manager->getLED(module_id, led_id);
-	if (!led_info) return;
-	ProgramState* state = led_info->getProgramState();
-	
-	if (current_millis - state->last_update < 50) {
-		return; // Update every 50ms
-	}
-	
-	// Initialize cycle if necessary
-	if (state->start_time == 0) {
-		state->start_time = current_millis;
-	}
-	
-	unsigned long cycle_time = (current_millis - state->start_time) % (SIMPLE_BLINK_ON_DURATION + SIMPLE_BLINK_OFF_DURATION);
-	uint16_t target_brightness = 0;
-	
-	// ON phase
-	if (cycle_time < SIMPLE_BLINK_ON_DURATION) {
-		target_brightness = SIMPLE_BLINK_INTENSITY;
-	}
-	// OFF phase
-	else {
-		target_brightness = 0;
-	}
-	
-	led_info->setBrightness(target_brightness);
-	module_manager->applyLedBrightness(module_id, led_id);
-	
-	state->last_update = current_millis;
-}
-
-void ProgramManager::update_tv_flicker_program(uint8_t module_id, uint8_t led_id, unsigned long current_millis) {
-	LED* led_info = module_manager->getLED(module_id, led_id);
-	if (!led_info) return;
-	ProgramState* state = led_info->getProgramState();
-	
-	if (current_millis - state->last_update < 20) {
-		return; // Update at 50Hz for smooth flickering
-	}
-	
-	// Check if it's time for next flicker change
-	if (!state->active || current_millis >= state->next_event) {
-		state->active = true;
-		
-		// Determine next change type
-		uint8_t random_value = random(0, 100);
-		
-		if (random_value < TV_FLICKER_FLASH_PROBABILITY) {
-			// Bright flash
-			state->current_intensity = random(TV_FLICKER_MAX_INTENSITY * 0.8, TV_FLICKER_MAX_INTENSITY + 1);
-		} else if (random_value < TV_FLICKER_FLASH_PROBABILITY + TV_FLICKER_DIM_PROBABILITY) {
-			// Dim period
-			state->current_intensity = random(TV_FLICKER_MIN_INTENSITY, TV_FLICKER_MIN_INTENSITY * 1.5);
-		} else {
-			// Normal variation around base intensity
-			int16_t variation = random(-200, 201);
-			state->current_intensity = constrain(TV_FLICKER_BASE_INTENSITY + variation, 
-				TV_FLICKER_MIN_INTENSITY, 
-				TV_FLICKER_MAX_INTENSITY);
-		}
-		
-		// Schedule next change with random interval
-		unsigned long next_interval = random(TV_FLICKER_MIN_INTERVAL, TV_FLICKER_MAX_INTERVAL + 1);
-		state->next_event = current_millis + next_interval;
-		
-		// Add some micro-variations for more realism
-		int16_t micro_variation = random(-50, 51);
-		uint16_t final_intensity = constrain(state->current_intensity + micro_variation, 
-			TV_FLICKER_MIN_INTENSITY, 
-			TV_FLICKER_MAX_INTENSITY);
-		
-		led_info->setBrightness(final_intensity);
-		module_manager->applyLedBrightness(module_id, led_id);
-	}
-	
-	state->last_update = current_millis;
-}
-
-void ProgramManager::update_firebox_glow_program(uint8_t module_id, uint8_t led_id, unsigned long current_millis) {
-	LED* led_info = module_manager->getLED(module_id, led_id);
-	if (!led_info) return;
-	ProgramState* state = led_info->getProgramState();
-	
-	if (current_millis - state->last_update < 20) {
-		return; // Update at 50Hz for realistic fire movement
-	}
-	
-	// Initialize if needed
-	if (state->start_time == 0) {
-		state->start_time = current_millis;
-		state->next_event = current_millis + random(FIREBOX_MIN_INTERVAL, FIREBOX_MAX_INTERVAL + 1);
-		state->current_intensity = FIREBOX_BASE_INTENSITY;
-		// Use parameters to track fire state: [0] = effect_type, [1] = effect_start_time
-		state->parameters["effect_type"] = 0;
-		state->parameters["effect_start_time"] = 0;
-	}
-	
-	uint16_t target_intensity = FIREBOX_BASE_INTENSITY;
-	uint8_t current_effect = state->parameters["effect_type"];
-	unsigned long effect_start = state->parameters["effect_start_time"];
-	
-	// Handle active effects
-	if (current_effect > 0) {
-		unsigned long effect_duration = current_millis - effect_start;
-		
-		switch (current_effect) {
-			case 1: // Ember pop
-				if (effect_duration < FIREBOX_EMBER_DURATION) {
-					// Quick bright flash then decay
-					float progress = (float)effect_duration / FIREBOX_EMBER_DURATION;
-					if (progress < 0.2) {
-						// Sharp rise
-						target_intensity = FIREBOX_BASE_INTENSITY + (1800 * (progress / 0.2));
-					} else {
-						// Quick decay
-						target_intensity = FIREBOX_BASE_INTENSITY + (1800 * (1.0 - (progress - 0.2) / 0.8));
-					}
-				} else {
-					// Effect finished
-					state->parameters["effect_type"] = 0;
-				}
-				break;
-				
-			case 2: // Flame surge
-				if (effect_duration < FIREBOX_SURGE_DURATION) {
-					// Gradual rise and fall
-					float progress = (float)effect_duration / FIREBOX_SURGE_DURATION;
-					float surge_intensity;
-					if (progress < 0.3) {
-						// Rising
-						surge_intensity = progress / 0.3;
-					} else if (progress < 0.7) {
-						// Sustained high
-						surge_intensity = 1.0 + 0.2 * sin(progress * PI * 8); // Flickering at peak
-					} else {
-						// Falling
-						surge_intensity = (1.0 - progress) / 0.3;
-					}
-					target_intensity = FIREBOX_BASE_INTENSITY + (1500 * surge_intensity);
-				} else {
-					// Effect finished
-					state->parameters["effect_type"] = 0;
-				}
-				break;
-				
-			case 3: // Wind gust
-				if (effect_duration < FIREBOX_WIND_DURATION) {
-					// Irregular dancing flames
-					float progress = (float)effect_duration / FIREBOX_WIND_DURATION;
-					float wind_factor = sin(progress * PI * 3) * sin(progress * PI * 7) * sin(progress * PI * 11);
-					wind_factor *= (1.0 - progress); // Decay over time
-					target_intensity = FIREBOX_BASE_INTENSITY + (800 * wind_factor);
-				} else {
-					// Effect finished
-					state->parameters["effect_type"] = 0;
-				}
-				break;
-		}
-	}
-	
-	// Check for new effects
-	if (current_effect == 0 && current_millis >= state->next_event) {
-		uint8_t random_value = random(0, 100);
-		
-		if (random_value < FIREBOX_EMBER_POP_PROBABILITY) {
-			// Start ember pop
-			state->parameters["effect_type"] = 1;
-			state->parameters["effect_start_time"] = current_millis;
-		} else if (random_value < FIREBOX_EMBER_POP_PROBABILITY + FIREBOX_FLAME_SURGE_PROBABILITY) {
-			// Start flame surge
-			state->parameters["effect_type"] = 2;
-			state->parameters["effect_start_time"] = current_millis;
-		} else if (random_value < FIREBOX_EMBER_POP_PROBABILITY + FIREBOX_FLAME_SURGE_PROBABILITY + FIREBOX_WIND_GUST_PROBABILITY) {
-			// Start wind gust
-			state->parameters["effect_type"] = 3;
-			state->parameters["effect_start_time"] = current_millis;
-		}
-		
-		// Schedule next potential event
-		state->next_event = current_millis + random(FIREBOX_MIN_INTERVAL, FIREBOX_MAX_INTERVAL + 1);
-	}
-	
-	// Add base fire variations (always active)
-	if (current_effect == 0) {
-		// Normal crackling variations
-		int16_t base_variation = random(-400, 401);
-		target_intensity = constrain(FIREBOX_BASE_INTENSITY + base_variation, 
-									FIREBOX_MIN_INTENSITY, 
-									FIREBOX_MAX_INTENSITY);
-	}
-	
-	// Add micro-variations for organic feel
-	int16_t micro_variation = random(-100, 101);
-	target_intensity = constrain(target_intensity + micro_variation, 
-								FIREBOX_MIN_INTENSITY, 
-								FIREBOX_MAX_INTENSITY);
-	
-	// Smooth large transitions
-	uint16_t current_brightness = led_info->getBrightness();
-	int16_t intensity_diff = target_intensity - current_brightness;
-	
-	if (abs(intensity_diff) > 300 && current_effect != 1) { // Don't smooth ember pops
-		// Large change - smooth it out
-		if (intensity_diff > 0) {
-			target_intensity = current_brightness + 150;
-		} else {
-			target_intensity = current_brightness - 150;
-		}
-	}
-	
-	led_info->setBrightness(target_intensity);
-	module_manager->applyLedBrightness(module_id, led_id);
-	
-	state->last_update = current_millis;
-}
-
-void ProgramManager::update_candle_flicker_program(uint8_t module_id, uint8_t led_id, unsigned long current_millis) {
-	LED* led_info = module_manager->getLED(module_id, led_id);
-	if (!led_info) return;
-	ProgramState* state = led_info->getProgramState();
-	
-	if (current_millis - state->last_update < 25) {
-		return; // Update at 40Hz for smooth organic movement
-	}
-	
-	// Initialize if needed
-	if (state->start_time == 0) {
-		state->start_time = current_millis;
-		state->next_event = current_millis + random(CANDLE_MIN_INTERVAL, CANDLE_MAX_INTERVAL + 1);
-		state->current_intensity = CANDLE_BASE_INTENSITY;
-	}
-	
-	// Check if it's time for a new flicker event
-	if (current_millis >= state->next_event) {
-		uint8_t random_value = random(0, 100);
-		
-		if (random_value < CANDLE_STRONG_FLICKER_PROBABILITY) {
-			// Strong upward flicker
-			state->current_intensity = random(CANDLE_MAX_INTENSITY * 0.9, CANDLE_MAX_INTENSITY + 1);
-		} else if (random_value < CANDLE_STRONG_FLICKER_PROBABILITY + CANDLE_DIP_PROBABILITY) {
-			// Gentle downward dip
-			state->current_intensity = random(CANDLE_MIN_INTENSITY, CANDLE_MIN_INTENSITY * 1.2);
-		} else {
-			// Gentle variation around base
-			int16_t gentle_variation = random(-150, 151);
-			state->current_intensity = constrain(CANDLE_BASE_INTENSITY + gentle_variation, 
-												CANDLE_MIN_INTENSITY, 
-												CANDLE_MAX_INTENSITY);
-		}
-		
-		// Schedule next flicker with variable timing
-		unsigned long next_interval = random(CANDLE_MIN_INTERVAL, CANDLE_MAX_INTERVAL + 1);
-		state->next_event = current_millis + next_interval;
-	}
-	
-	// Add continuous subtle variations for organic feel
-	int16_t subtle_variation = random(-30, 31);
-	uint16_t target_intensity = constrain(state->current_intensity + subtle_variation, 
-										 CANDLE_MIN_INTENSITY, 
-										 CANDLE_MAX_INTENSITY);
-	
-	// Smooth transitions to avoid harsh changes
-	uint16_t current_brightness = led_info->getBrightness();
-	int16_t intensity_diff = target_intensity - current_brightness;
-	
-	if (abs(intensity_diff) > 200) {
-		// Large change - smooth it out over multiple updates
-		if (intensity_diff > 0) {
-			target_intensity = current_brightness + 80;
-		} else {
-			target_intensity = current_brightness - 80;
-		}
-	} else if (abs(intensity_diff) > 50) {
-		// Medium change - partial step
-		target_intensity = current_brightness + (intensity_diff / 3);
-	}
-	
-	led_info->setBrightness(target_intensity);
-	module_manager->applyLedBrightness(module_id, led_id);
-	
-	state->last_update = current_millis;
-}
-
-void ProgramManager::update_french_crossing_program(uint8_t module_id, uint8_t led_id, unsigned long current_millis) {
-	LED* led_info = module_manager->getLED(module_id, led_id);
-	if (!led_info) return;
-	ProgramState* state = led_info->getProgramState();
-	
-	if (current_millis - state->last_update < 10) {
-		return; // Update at 100Hz for smooth filament effect
-	}
-	
-	// Initialize cycle if necessary
-	if (state->start_time == 0) {
-		state->start_time = current_millis;
-		// Use parameters to track filament state: [0] = phase_start_time, [1] = current_phase
-		state->parameters["phase_start_time"] = current_millis;
-		state->parameters["current_phase"] = 0; // 0 = OFF, 1 = ON
-	}
-	
-	unsigned long cycle_time = (current_millis - state->start_time) % (FRENCH_CROSSING_ON_DURATION + FRENCH_CROSSING_OFF_DURATION);
-	unsigned long phase_start = state->parameters["phase_start_time"];
-	uint8_t current_phase = state->parameters["current_phase"];
-	
-	// Detect phase transitions
-	bool should_be_on = (cycle_time < FRENCH_CROSSING_ON_DURATION);
-	
-	if ((should_be_on && current_phase == 0) || (!should_be_on && current_phase == 1)) {
-		// Phase change detected
-		state->parameters["phase_start_time"] = current_millis;
-		state->parameters["current_phase"] = should_be_on ? 1 : 0;
-		phase_start = current_millis;
-		current_phase = should_be_on ? 1 : 0;
-	}
-	
-	unsigned long phase_time = current_millis - phase_start;
-	uint16_t target_brightness = 0;
-	
-	if (current_phase == 1) {
-		// ON phase - filament heating up
-		if (phase_time < FRENCH_CROSSING_WARMUP_DURATION) {
-			// Filament warm-up: gradual increase with exponential curve
-			float warmup_progress = (float)phase_time / FRENCH_CROSSING_WARMUP_DURATION;
-			
-			// Exponential heating curve: faster start, slower finish
-			float exponential_progress = 1.0 - exp(-4.0 * warmup_progress);
-			
-			target_brightness = FRENCH_CROSSING_WARMUP_MIN + 
-							   (FRENCH_CROSSING_MAX_INTENSITY - FRENCH_CROSSING_WARMUP_MIN) * exponential_progress;
-		} else {
-			// Full intensity with slight filament stability variations
-			int16_t stability_variation = random(-25, 26);
-			target_brightness = constrain(FRENCH_CROSSING_MAX_INTENSITY + stability_variation, 
-										 FRENCH_CROSSING_MAX_INTENSITY - 50, 
-										 FRENCH_CROSSING_MAX_INTENSITY);
-		}
-	} else {	
-		if (phase_time < FRENCH_CROSSING_COOLDOWN_DURATION) {
-			// Filament cool-down: exponential decay (slower than heating)
-			float cooldown_progress = (float)phase_time / FRENCH_CROSSING_COOLDOWN_DURATION;
-			
-			// Exponential cooling curve: starts fast, then slower (thermal inertia)
-			float exponential_decay = exp(-2.0 * cooldown_progress); // Slower decay than heating
-			
-			target_brightness = FRENCH_CROSSING_WARMUP_MIN * exponential_decay;
-			
-			// Add slight red glow persistence for realism
-			//if (target_brightness < 50 && phase_time < FRENCH_CROSSING_COOLDOWN_DURATION * 0.8) {
-			//	target_brightness += random(5, 15); // Faint residual glow
-			//}
-		} else {
-			// Completely off
-			target_brightness = 0;
-		}
-	}
-	
-	led_info->setBrightness(target_brightness);
-	module_manager->applyLedBrightness(module_id, led_id);
-	
-	state->last_update = current_millis;
-}
-
-bool ProgramManager::initialize_led_state(uint8_t module_id, uint8_t led_id) {
-	if (!module_manager || module_id >= module_manager->getModuleCount()) {
-		return false;
-	}
-	
-	const PCA9685Module* module = module_manager->getModule(module_id);
-	if (!module || led_id >= module->getLedCount()) {
-		return false;
-	}
-	
-	LED* led_info = module_manager->getLED(module_id, led_id);
-	if (!led_info) {
-		return false;
-	}
-
-	switch (led_info->getProgramType()) {
-		case PROGRAM_WELDING:
-			initialize_welding_state(led_info->getProgramState());
-			break;
-		case PROGRAM_HEARTBEAT:
-			initialize_default_state(led_info->getProgramState());
-			break;
-		case PROGRAM_BREATHING:
-			initialize_default_state(led_info->getProgramState());
-			break;
-		case PROGRAM_SIMPLE_BLINK:
-			initialize_default_state(led_info->getProgramState());
-			break;
-		case PROGRAM_TV_FLICKER:
-			initialize_default_state(led_info->getProgramState());
-			break;
-		case PROGRAM_FIREBOX_GLOW:
-			initialize_default_state(led_info->getProgramState());
-			break;
-		case PROGRAM_CANDLE_FLICKER:
-			initialize_default_state(led_info->getProgramState());
-			break;
-		case PROGRAM_FRENCH_CROSSING:
-			initialize_default_state(led_info->getProgramState());
-			break;
-		default:
-			break;
-	}
-
-	return true;
-}
-
-void ProgramManager::initialize_default_state(ProgramState* state) {
-	state->last_update = 0;
-	state->start_time = millis();
-	state->active = true;
-	state->current_intensity = 0;
-}
-
-void ProgramManager::initialize_welding_state(ProgramState* state) {
-	state->last_update = 0;
-	state->next_event = millis() + random(1000, 3000); // Premier éclat dans 1-3 secondes
-	state->active = false;
-	state->start_time = 0;
-	state->current_intensity = 0;
-}
+/**
+ * SPDX-FileCopyrightText: 2025 Jérôme SONRIER
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * @file program.cpp
+ * @brief Implementation of LED program management system
+ * 
+ * This file implements the ProgramManager class and all LED animation programs.
+ * It provides various visual effects including welding simulation, heartbeat,
+ * railway signals, level crossing warnings, and breathing effects.
+ * 
+ * The program manager works directly with LED objects in PCA9685 modules to
+ * control brightness and create smooth animations with realistic timing.
+ * 
+ * See program.h for API documentation.
+ * 
+ * @author  Jérôme SONRIER <jsid@emor3j.fr.eu.org>
+ * @date    2025-09-10
+ */
+
+#include <algorithm>
+
+#include "program.h"
+#include "config.h"
+#include "pca9685.h"
+#include "layer.h"
+#include "storage.h"
+#include "log.h"
+
+
+/// Global instance
+std::unique_ptr<ProgramManager> program_manager;
+
+// === User effects ===
+EffectVM::Program ProgramManager::effects_[ProgramManager::EFFECT_SLOTS] = {};
+EffectVM::Stats ProgramManager::effect_stats_[ProgramManager::EFFECT_SLOTS] = {};
+EffectVM::Program ProgramManager::pending_effect_ = {};
+uint8_t ProgramManager::pending_effect_slot_ = 0;
+volatile bool ProgramManager::effect_pending_ = false;
+ProgramManager::EffectBenchResult ProgramManager::effect_bench_[ProgramManager::EFFECT_BENCH_COUNT] = {};
+uint16_t ProgramManager::effect_bench_rounds_ = 0;
+volatile bool ProgramManager::effect_bench_pending_ = false;
+
+// === Transitions ===
+ProgramManager::Transition ProgramManager::transitions_[ProgramManager::TRANSITION_SLOTS] = {};
+uint16_t ProgramManager::transition_serial_ = 0;
+
+// === Phase groups ===
+ProgramManager::PhaseGroup ProgramManager::phase_groups_[ProgramManager::PHASE_GROUPS] = {};
+
+// === Shared evaluation ===
+ProgramManager::SharedLevel ProgramManager::shared_levels_[ProgramManager::SHARED_LEVEL_SLOTS] = {};
+ProgramManager::SharedStats ProgramManager::shared_stats_ = {};
+
+// === Welding Program Parameters ===
+/// @defgroup welding_params Welding Program Parameters
+/// @brief Configuration constants for the welding arc simulation effect
+/// @{
+
+/// Minimum interval between welding flashes (milliseconds)
+const unsigned long WELDING_MIN_INTERVAL = 10;
+/// Maximum interval between welding flashes (milliseconds)
+const unsigned long WELDING_MAX_INTERVAL = 300;
+/// Minimum duration of a welding flash (milliseconds)
+const unsigned long WELDING_MIN_DURATION = 10;
+/// Maximum duration of a welding flash (milliseconds)
+const unsigned long WELDING_MAX_DURATION = 100;
+/// Minimum intensity for welding flashes (0-4095)
+const uint16_t WELDING_MIN_INTENSITY = 10;
+/// Maximum intensity for welding flashes (0-4095)
+const uint16_t WELDING_MAX_INTENSITY = 3000;
+
+/// @}
+
+// === Heartbeat Program Parameters ===
+/// @defgroup heartbeat_params Heartbeat Program Parameters
+/// @brief Configuration constants for the heartbeat rhythm effect
+/// @{
+
+/// Total duration of one complete heartbeat cycle (milliseconds)
+const unsigned long HEARTBEAT_CYCLE_DURATION = 1000;
+/// Duration of the first heartbeat pulse (systole) (milliseconds)
+const unsigned long HEARTBEAT_BEAT1_DURATION = 100;
+/// Duration of pause after first beat (milliseconds)
+const unsigned long HEARTBEAT_PAUSE1_DURATION = 80;
+/// Duration of the second heartbeat pulse (diastole) (milliseconds)
+const unsigned long HEARTBEAT_BEAT2_DURATION = 60;
+/// Duration of pause after second beat (milliseconds)
+const unsigned long HEARTBEAT_PAUSE2_DURATION = 760;
+/// Maximum intensity for heartbeat pulses (0-4095)
+const uint16_t HEARTBEAT_INTENSITY = 3500;
+
+/// @}
+
+// === Breathing Program Parameters ===
+/// @defgroup breathing_params Breathing Program Parameters
+/// @brief Configuration constants for the breathing effect
+/// @{
+
+/// Total duration of one complete breathing cycle (milliseconds)
+const unsigned long BREATHING_CYCLE_DURATION = 4000;
+/// Duration of the inhale phase (fade in) (milliseconds)
+const unsigned long BREATHING_INHALE_DURATION = 1500;
+/// Duration of holding breath at maximum intensity (milliseconds)
+const unsigned long BREATHING_HOLD_DURATION = 500;
+/// Duration of the exhale phase (fade out) (milliseconds)
+const unsigned long BREATHING_EXHALE_DURATION = 1500;
+/// Duration of pause at minimum intensity (milliseconds)
+const unsigned long BREATHING_PAUSE_DURATION = 500;
+/// Maximum intensity during breathing cycle (0-4095)
+const uint16_t BREATHING_MAX_INTENSITY = 4095;
+/// Minimum intensity during breathing cycle (0-4095)
+const uint16_t BREATHING_MIN_INTENSITY = 0;
+
+/// @}
+
+// === Simple Blink Program Parameters ===
+/// @defgroup blink_params Simple Blink Program Parameters
+/// @brief Configuration constants for the simple blinking effect
+/// @{
+
+/// Duration of ON phase (milliseconds)
+const unsigned long SIMPLE_BLINK_ON_DURATION = 1000;
+/// Duration of OFF phase (milliseconds)
+const unsigned long SIMPLE_BLINK_OFF_DURATION = 1000;
+/// Intensity for blink ON state (0-4095)
+const uint16_t SIMPLE_BLINK_INTENSITY = 4095;
+
+/// @}
+
+// === TV Flicker Program Parameters ===
+/// @defgroup tv_flicker_params TV Flicker Program Parameters
+/// @brief Configuration constants for TV screen flickering effect
+/// @{
+
+/// Base intensity for TV flicker (0-4095)
+const uint16_t TV_FLICKER_BASE_INTENSITY = 800;
+/// Maximum intensity for TV flicker (0-4095)
+const uint16_t TV_FLICKER_MAX_INTENSITY = 2500;
+/// Minimum intensity for TV flicker (0-4095)
+const uint16_t TV_FLICKER_MIN_INTENSITY = 200;
+/// Minimum interval between flicker changes (milliseconds)
+const unsigned long TV_FLICKER_MIN_INTERVAL = 40;
+/// Maximum interval between flicker changes (milliseconds)
+const unsigned long TV_FLICKER_MAX_INTERVAL = 200;
+/// Probability of a bright flash (0-100)
+const uint8_t TV_FLICKER_FLASH_PROBABILITY = 15;
+/// Probability of a dim period (0-100)
+const uint8_t TV_FLICKER_DIM_PROBABILITY = 10;
+
+/// @}
+
+// === Firebox Glow Program Parameters ===
+/// @defgroup firebox_params Firebox Glow Program Parameters
+/// @brief Configuration constants for wood fire simulation effect
+/// @{
+
+/// Base intensity for wood fire (0-4095)
+const uint16_t FIREBOX_BASE_INTENSITY = 2200;
+/// Maximum intensity for wood fire (0-4095)
+const uint16_t FIREBOX_MAX_INTENSITY = 4095;
+/// Minimum intensity for wood fire (0-4095)
+const uint16_t FIREBOX_MIN_INTENSITY = 1200;
+/// Minimum interval between flame changes (milliseconds)
+const unsigned long FIREBOX_MIN_INTERVAL = 60;
+/// Maximum interval between flame changes (milliseconds)
+const unsigned long FIREBOX_MAX_INTERVAL = 400;
+/// Probability of ember pop/crack (0-100)
+const uint8_t FIREBOX_EMBER_POP_PROBABILITY = 15;
+/// Probability of strong flame surge (0-100)
+const uint8_t FIREBOX_FLAME_SURGE_PROBABILITY = 8;
+/// Probability of wind gust effect (0-100)
+const uint8_t FIREBOX_WIND_GUST_PROBABILITY = 5;
+/// Duration of ember pop effect (milliseconds)
+const unsigned long FIREBOX_EMBER_DURATION = 150;
+/// Duration of flame surge effect (milliseconds)
+const unsigned long FIREBOX_SURGE_DURATION = 800;
+/// Duration of wind gust effect (milliseconds)
+const unsigned long FIREBOX_WIND_DURATION = 1200;
+
+/// @}
+
+// === Candle Flicker Program Parameters ===
+/// @defgroup candle_params Candle Flicker Program Parameters
+/// @brief Configuration constants for candle flame flickering effect
+/// @{
+
+/// Base intensity for candle flame (0-4095)
+const uint16_t CANDLE_BASE_INTENSITY = 2800;
+/// Maximum intensity for candle flame (0-4095)
+const uint16_t CANDLE_MAX_INTENSITY = 3800;
+/// Minimum intensity for candle flame (0-4095)
+const uint16_t CANDLE_MIN_INTENSITY = 1800;
+/// Minimum interval between flicker changes (milliseconds)
+const unsigned long CANDLE_MIN_INTERVAL = 50;
+/// Maximum interval between flicker changes (milliseconds)
+const unsigned long CANDLE_MAX_INTERVAL = 300;
+/// Probability of a strong flicker (0-100)
+const uint8_t CANDLE_STRONG_FLICKER_PROBABILITY = 12;
+/// Probability of a gentle dip (0-100)
+const uint8_t CANDLE_DIP_PROBABILITY = 8;
+
+/// @}
+
+// === French Level Crossing Program Parameters ===
+/// @defgroup french_crossing_params French Level Crossing Program Parameters
+/// @brief Configuration constants for French railway level crossing light simulation
+/// @{
+
+/// Duration of ON phase (milliseconds)
+const unsigned long FRENCH_CROSSING_ON_DURATION = 500;
+/// Duration of OFF phase (milliseconds)
+const unsigned long FRENCH_CROSSING_OFF_DURATION = 500;
+/// Maximum intensity for French crossing light (0-4095)
+const uint16_t FRENCH_CROSSING_MAX_INTENSITY = 4095;
+/// Duration of filament warm-up (milliseconds)
+const unsigned long FRENCH_CROSSING_WARMUP_DURATION = 100;
+/// Duration of filament cool-down (milliseconds)
+const unsigned long FRENCH_CROSSING_COOLDOWN_DURATION = 150;
+/// Minimum intensity during warm-up (0-4095)
+const uint16_t FRENCH_CROSSING_WARMUP_MIN = 0;
+
+/// @}
+
+// === Program Parameters ===
+
+const ProgramParams ProgramParams::DEFAULTS = {100, 100, 100, 0, 4095, 256, 256, 256, 256};
+
+ProgramState::~ProgramState() {
+	if (params != &ProgramParams::DEFAULTS) {
+		delete params;
+	}
+}
+
+/**
+ * @brief Scale and bound a program level by the LED parameters
+ * @param params Resolved parameters
+ * @param level Level computed from the program constants
+ * @return Level to set (0-4095)
+ */
+static inline uint16_t param_level(const ProgramParams* params, int32_t level) {
+	uint32_t scaled = level > 0 ? (static_cast<uint32_t>(level) * params->intensity_q8) >> 8 : 0;
+	return constrain(scaled, params->min_level, params->max_level);
+}
+
+/**
+ * @brief Convert elapsed real time into program time
+ * @param params Resolved parameters
+ * @param elapsed Elapsed time (milliseconds)
+ * @return Program time to compare with the program durations (milliseconds)
+ */
+static inline unsigned long param_time(const ProgramParams* params, unsigned long elapsed) {
+	return (static_cast<uint64_t>(elapsed) * params->time_q8) >> 8;
+}
+
+/**
+ * @brief Convert a program duration into real time
+ * @param params Resolved parameters
+ * @param duration Program duration (milliseconds)
+ * @return Real duration (milliseconds)
+ */
+static inline unsigned long param_interval(const ProgramParams* params, unsigned long duration) {
+	return (static_cast<uint64_t>(duration) * params->interval_q8) >> 8;
+}
+
+/**
+ * @brief Scale a program probability
+ * @param params Resolved parameters
+ * @param percent Program probability (0-100)
+ * @return Scaled probability (0-100)
+ */
+static inline uint8_t param_probability(const ProgramParams* params, uint8_t percent) {
+	return std::min<uint32_t>((static_cast<uint32_t>(percent) * params->probability_q8) >> 8, 100);
+}
+
+/**
+ * @brief Heartbeat level at a position in the cycle
+ * @param cycle_time Time in the cycle (program milliseconds)
+ * @return Level before the LED parameters (0-4095)
+ */
+static uint16_t heartbeat_level(unsigned long cycle_time) {
+	// Phase 1: Premier battement (systole)
+	if (cycle_time < HEARTBEAT_BEAT1_DURATION) {
+		return HEARTBEAT_INTENSITY;
+	}
+	// Phase 2: Pause courte
+	else if (cycle_time < HEARTBEAT_BEAT1_DURATION + HEARTBEAT_PAUSE1_DURATION) {
+		return 0;
+	}
+	// Phase 3: Second battement (diastole) - plus faible
+	else if (cycle_time < HEARTBEAT_BEAT1_DURATION + HEARTBEAT_PAUSE1_DURATION + HEARTBEAT_BEAT2_DURATION) {
+		return HEARTBEAT_INTENSITY * 0.6; // 60% de l'intensité du premier
+	}
+	// Phase 4: Pause longue
+	return 0;
+}
+
+/**
+ * @brief Breathing level at a position in the cycle
+ * @param cycle_time Time in the cycle (program milliseconds)
+ * @return Level before the LED parameters (0-4095)
+ */
+static uint16_t breathing_level(unsigned long cycle_time) {
+	// Phase 1: Inspiration (montée progressive)
+	if (cycle_time < BREATHING_INHALE_DURATION) {
+		float progress = (float)cycle_time / BREATHING_INHALE_DURATION;
+		// Courbe sinusoïdale pour un effet plus naturel
+		float sine_progress = sin(progress * PI / 2);
+		return BREATHING_MAX_INTENSITY * sine_progress;
+	}
+	// Phase 2: Rétention (maintien au maximum)
+	else if (cycle_time < BREATHING_INHALE_DURATION + BREATHING_HOLD_DURATION) {
+		return BREATHING_MAX_INTENSITY;
+	}
+	// Phase 3: Expiration (descente progressive)
+	else if (cycle_time < BREATHING_INHALE_DURATION + BREATHING_HOLD_DURATION + BREATHING_EXHALE_DURATION) {
+		unsigned long exhale_time = cycle_time - BREATHING_INHALE_DURATION - BREATHING_HOLD_DURATION;
+		float progress = (float)exhale_time / BREATHING_EXHALE_DURATION;
+		// Courbe sinusoïdale inversée pour la descente
+		float sine_progress = cos(progress * PI / 2);
+		return BREATHING_MAX_INTENSITY * sine_progress;
+	}
+	// Phase 4: Pause (minimum/éteint)
+	return BREATHING_MIN_INTENSITY; // Peut être 0 ou une valeur très faible
+}
+
+/**
+ * @brief Simple blink level at a position in the cycle
+ * @param cycle_time Time in the cycle (program milliseconds)
+ * @return Level before the LED parameters (0-4095)
+ */
+static uint16_t simple_blink_level(unsigned long cycle_time) {
+	return cycle_time < SIMPLE_BLINK_ON_DURATION ? SIMPLE_BLINK_INTENSITY : 0;
+}
+
+bool ProgramManager::initialize() {
+	// Get assigned program
+	JsonDocument assigned = get_assigned_programs();
+	JsonArray programs = assigned["assigned_programs"];
+	
+	// Initialise all assigned program
+	for (JsonObject program : programs) {
+		uint8_t module_id = program["module_id"];
+		uint8_t led_id = program["led_id"];
+		ProgramType program_type = program["program_type"];
+
+		LOG_DEBUG("[PROGRAMMGR] Initializing LED %d:%d with program %d (%s)\n",
+			module_id,
+			led_id,
+			(uint8_t)program_type,
+			get_program_name(program_type).c_str()
+		);
+		// Get LED
+		const PCA9685Module* module = module_manager->getModule(module_id);
+		if (!module || led_id >= module->getLedCount()) {
+			return false;
+		}
+		
+		LED* led_info = module_manager->getLED(module_id, led_id);
+		if (!led_info) {
+			return false;
+		}
+
+		// Create new program state, keeping the effect slot and parameters
+		led_info->setProgram(program_type, create_state(led_info->getProgramState()));
+		initialize_led_state(module_id, led_id);
+	}
+
+	return true;
+}
+
+void ProgramManager::update(unsigned long current_millis) {
+	if (!module_manager) return;
+
+	apply_pending_effect();
+	if (effect_bench_pending_) {
+		run_effect_bench();
+		effect_bench_pending_ = false;
+	}
+	update_transitions(current_millis);
+	
+	for (uint8_t i = 0; i < module_manager->getModuleCount(); i++) {
+		PCA9685Module* module = module_manager->getModule(i);
+		if (!module) continue;
+		
+		uint16_t fading = 0;
+		for (uint8_t j = 0; j < module->getLedCount(); j++) {
+			LED* led_info = module_manager->getLED(i, j);
+			if (!led_info) continue;
+			
+			// Fading LEDs follow the new weight, released at the end of their own fade
+			uint8_t transition = led_info->getTransition();
+			if (transition) {
+				const Transition& slot = transitions_[transition - 1];
+				if (!slot.active || slot.finished ||
+					(slot.elapsed >= led_info->getFadeDelay() && slot.elapsed - led_info->getFadeDelay() >= slot.duration)) {
+					led_info->setTransition(0, 0);
+				}
+				fading |= static_cast<uint16_t>(1u << j);
+			}
+			
+			// If LED is active and has assigned program
+			if (led_info->isEnabled() && led_info->getProgramType() != PROGRAM_NONE && led_info->getProgramState() != nullptr) {
+				run_program(led_info, i, j, current_millis);
+			}
+		}
+		
+		if (fading) {
+			module->applyLedMask(fading);
+		}
+	}
+	
+	// Overlay programs of the layer stacks
+	if (layer_stack) {
+		layer_stack->updateOverlays(current_millis);
+	}
+	
+	// Every LED of a finished transition has been released
+	for (Transition& slot : transitions_) {
+		if (slot.finished) {
+			slot.finished = false;
+			slot.active = false;
+		}
+	}
+}
+
+void ProgramManager::run_program(LED* led_info, uint8_t module_id, uint8_t led_id, unsigned long current_millis) {
+	switch (led_info->getProgramType()) {
+		case PROGRAM_WELDING:
+			update_welding_program(led_info, module_id, led_id, current_millis);
+			break;
+		case PROGRAM_HEARTBEAT:
+			update_heartbeat_program(led_info, module_id, led_id, current_millis);
+			break;
+		case PROGRAM_BREATHING:
+			update_breathing_program(led_info, module_id, led_id, current_millis);
+			break;
+		case PROGRAM_SIMPLE_BLINK:
+			update_simple_blink_program(led_info, module_id, led_id, current_millis);
+			break;
+		case PROGRAM_TV_FLICKER:
+			update_tv_flicker_program(led_info, module_id, led_id, current_millis);
+			break;
+		case PROGRAM_FIREBOX_GLOW:
+			update_firebox_glow_program(led_info, module_id, led_id, current_millis);
+			break;
+		case PROGRAM_CANDLE_FLICKER:
+			update_candle_flicker_program(led_info, module_id, led_id, current_millis);
+			break;
+		case PROGRAM_FRENCH_CROSSING:
+			update_french_crossing_program(led_info, module_id, led_id, current_millis);
+			break;
+		case PROGRAM_CUSTOM:
+			update_custom_program(led_info, module_id, led_id, current_millis);
+			break;
+		default:
+			break;
+	}
+}
+
+bool ProgramManager::assign_program(uint8_t module_id, uint8_t led_id, ProgramType program_type, bool quiet) {
+	if (!module_manager || module_id >= module_manager->getModuleCount()) {
+		return false;
+	}
+	
+	const PCA9685Module* module = module_manager->getModule(module_id);
+	if (!module || led_id >= module->getLedCount()) {
+		return false;
+	}
+	
+	LED* led_info = module_manager->getLED(module_id, led_id);
+	if (!led_info) {
+		return false;
+	}
+	
+	if (program_type == PROGRAM_NONE) {
+		return unassign_program(module_id, led_id, quiet);
+	}
+	
+	// Create new program state, keeping the effect slot and parameters
+	led_info->setProgram(program_type, create_state(led_info->getProgramState()));
+	initialize_led_state(module_id, led_id);
+	
+	if (!quiet) {
+		LOG_INFO("[PROGRAMMGR] Program %d(%s) assigned to LED %d:%d\n", 
+			program_type,
+			get_program_name(program_type).c_str(), 
+			module_id, 
+			led_id);
+	}
+	
+	return true;
+}
+
+bool ProgramManager::unassign_program(uint8_t module_id, uint8_t led_id, bool quiet) {
+	if (!module_manager || module_id >= module_manager->getModuleCount()) {
+		return false;
+	}
+	
+	const PCA9685Module* module = module_manager->getModule(module_id);
+	if (!module || led_id >= module->getLedCount()) {
+		return false;
+	}
+	
+	LED* led_info = module_manager->getLED(module_id, led_id);
+	if (!led_info) {
+		return false;
+	}
+	
+	// Delete program state memory
+	if (led_info->getProgramState() != nullptr) {
+		delete led_info->getProgramState();
+		led_info->setProgram(led_info->getProgramType(), nullptr);
+	}
+	
+	led_info->setProgram(PROGRAM_NONE, led_info->getProgramState());
+	
+	if (!quiet) {
+		LOG_INFO("[PROGRAMMGR] Program unassigned from LED %d:%d\n", module_id, led_id);
+	}
+	
+	return true;
+}
+
+bool ProgramManager::start_program(LED* led_info, ProgramType program_type) {
+	if (program_type == PROGRAM_NONE) {
+		stop_program(led_info);
+		return true;
+	}
+	if (program_type > PROGRAM_CUSTOM) {
+		return false;
+	}
+
+	led_info->setProgram(program_type, create_state(led_info->getProgramState()));
+	initialize_state(led_info);
+	return true;
+}
+
+void ProgramManager::stop_program(LED* led_info) {
+	delete led_info->getProgramState();
+	led_info->setProgram(PROGRAM_NONE, nullptr);
+}
+
+bool ProgramManager::is_program_assigned(uint8_t module_id, uint8_t led_id) {
+	if (!module_manager || module_id >= module_manager->getModuleCount()) {
+		return false;
+	}
+	
+	const LED* led = module_manager->getLED(module_id, led_id);
+	return led ? (led->getProgramType() != PROGRAM_NONE) : false;
+}
+
+ProgramType ProgramManager::get_program_type(uint8_t module_id, uint8_t led_id) {
+	if (!module_manager || module_id >= module_manager->getModuleCount()) {
+		return PROGRAM_NONE;
+	}
+	
+	const LED* led = module_manager->getLED(module_id, led_id);
+	return led ? led->getProgramType() : PROGRAM_NONE;
+}
+
+JsonDocument ProgramManager::get_available_programs() {
+	JsonDocument doc;
+	JsonArray programs = doc["programs"].to<JsonArray>();
+	
+	// Welding
+	JsonObject welding = programs.add<JsonObject>();
+	welding["id"] = PROGRAM_WELDING;
+	welding["name"] = get_program_name(PROGRAM_WELDING);
+	welding["description"] = get_program_description(PROGRAM_WELDING);
+	
+	// Heartbeat
+	JsonObject heartbeat = programs.add<JsonObject>();
+	heartbeat["id"] = PROGRAM_HEARTBEAT;
+	heartbeat["name"] = get_program_name(PROGRAM_HEARTBEAT);
+	heartbeat["description"] = get_program_description(PROGRAM_HEARTBEAT);
+
+	// Breathing
+	JsonObject breathing = programs.add<JsonObject>();
+	breathing["id"] = PROGRAM_BREATHING;
+	breathing["name"] = get_program_name(PROGRAM_BREATHING);
+	breathing["description"] = get_program_description(PROGRAM_BREATHING);
+
+	// Simple blink
+	JsonObject simple_blink = programs.add<JsonObject>();
+	simple_blink["id"] = PROGRAM_SIMPLE_BLINK;
+	simple_blink["name"] = get_program_name(PROGRAM_SIMPLE_BLINK);
+	simple_blink["description"] = get_program_description(PROGRAM_SIMPLE_BLINK);
+
+	// TV flicler
+	JsonObject tv_flicker = programs.add<JsonObject>();
+	tv_flicker["id"] = PROGRAM_TV_FLICKER;
+	tv_flicker["name"] = get_program_name(PROGRAM_TV_FLICKER);
+	tv_flicker["description"] = get_program_description(PROGRAM_TV_FLICKER);
+
+	// Firebox glow
+	JsonObject firebox = programs.add<JsonObject>();
+	firebox["id"] = PROGRAM_FIREBOX_GLOW;
+	firebox["name"] = get_program_name(PROGRAM_FIREBOX_GLOW);
+	firebox["description"] = get_program_description(PROGRAM_FIREBOX_GLOW);
+
+	// Candle flicker
+	JsonObject candle = programs.add<JsonObject>();
+	candle["id"] = PROGRAM_CANDLE_FLICKER;
+	candle["name"] = get_program_name(PROGRAM_CANDLE_FLICKER);
+	candle["description"] = get_program_description(PROGRAM_CANDLE_FLICKER);
+
+	// French crossing
+	JsonObject french_crossing = programs.add<JsonObject>();
+	french_crossing["id"] = PROGRAM_FRENCH_CROSSING;
+	french_crossing["name"] = get_program_name(PROGRAM_FRENCH_CROSSING);
+	french_crossing["description"] = get_program_description(PROGRAM_FRENCH_CROSSING);
+
+	// Custom effect
+	JsonObject custom = programs.add<JsonObject>();
+	custom["id"] = PROGRAM_CUSTOM;
+	custom["name"] = get_program_name(PROGRAM_CUSTOM);
+	custom["description"] = get_program_description(PROGRAM_CUSTOM);
+	
+	doc["total"] = programs.size();
+	return doc;
+}
+
+JsonDocument ProgramManager::get_assigned_programs() {
+	JsonDocument doc;
+	JsonArray programs = doc["assigned_programs"].to<JsonArray>();
+	
+	if (module_manager) {
+		for (uint8_t i = 0; i < module_manager->getModuleCount(); i++) {
+			const PCA9685Module* module = module_manager->getModule(i);
+			if (module) {
+				for (uint8_t j = 0; j < module->getLedCount(); j++) {
+					const LED* led = module->getLED(j);
+					if (led && led->getProgramType() != PROGRAM_NONE) {
+						JsonObject program = programs.add<JsonObject>();
+						program["module_id"] = i;
+						program["led_id"] = j;
+						program["program_type"] = led->getProgramType();
+						program["program_name"] = get_program_name(led->getProgramType());
+						program["enabled"] = led->isEnabled();
+					}
+				}
+			}
+		}
+	}
+	
+	doc["total"] = programs.size();
+	return doc;
+}
+
+String ProgramManager::get_program_name(ProgramType type) {
+	switch (type) {
+		case PROGRAM_WELDING: return "Welding";
+		case PROGRAM_HEARTBEAT: return "Heartbeat";
+		case PROGRAM_BREATHING: return "Breathing";
+		case PROGRAM_SIMPLE_BLINK: return "Simple Blink";
+		case PROGRAM_TV_FLICKER: return "TV Flicker";
+		case PROGRAM_FIREBOX_GLOW: return "Firebox Glow";
+		case PROGRAM_CANDLE_FLICKER: return "Candle Flicker";
+		case PROGRAM_FRENCH_CROSSING: return "French Level Crossing";
+		case PROGRAM_CUSTOM: return "Custom Effect";
+		default: return "None";
+	}
+}
+
+String ProgramManager::get_program_description(ProgramType type) {
+	switch (type) {
+		case PROGRAM_WELDING: return "Simulates welding arc flashes with random intensity and timing";
+		case PROGRAM_HEARTBEAT: return "Simulates a heartbeat rhythm with double pulse pattern";
+		case PROGRAM_BREATHING: return "Simulates breathing";
+		case PROGRAM_SIMPLE_BLINK: return "Simple 1 second on/off blinking pattern";
+		case PROGRAM_TV_FLICKER: return "Television screen flickering with blue tint and random intensity changes";
+		case PROGRAM_FIREBOX_GLOW: return "Wood fire simulation with crackling flames, ember pops and wind effects";
+		case PROGRAM_CANDLE_FLICKER: return "Gentle candle or gas lamp flame flickering with organic variations";
+		case PROGRAM_FRENCH_CROSSING: return "French railway level crossing light with realistic filament bulb behavior";
+		case PROGRAM_CUSTOM: return "User-defined keyframe effect uploaded as bytecode";
+		default: return "No program";
+	}
+}
+
+void ProgramManager::update_welding_program(LED* led_info, uint8_t module_id, uint8_t led_id, unsigned long current_millis) {
+	ProgramState* state = led_info->getProgramState();
+	const ProgramParams* params = state->params;
+	
+	if (current_millis - state->last_update < 10) {
+		return; // Update à 100Hz maximum
+	}
+	
+	// Si aucun éclat n'est actif, vérifier s'il faut en déclencher un
+	if (!state->active && current_millis >= state->next_event) {
+		// Déclencher un nouvel éclat
+		state->active = true;
+		state->start_time = current_millis;
+		
+		// Intensité aléatoire pour cet éclat
+		state->current_intensity = random(WELDING_MIN_INTENSITY, WELDING_MAX_INTENSITY + 1);
+		
+		// Programmer le prochain éclat
+		unsigned long welding_duration = param_interval(params, random(WELDING_MIN_DURATION, WELDING_MAX_DURATION + 1));
+		unsigned long next_interval = param_interval(params, random(WELDING_MIN_INTERVAL, WELDING_MAX_INTERVAL + 1));
+		state->next_event = current_millis + welding_duration + next_interval;
+		
+		// Activer la LED immédiatement
+		led_info->setBrightness(param_level(params, state->current_intensity));
+		module_manager->applyLedBrightness(module_id, led_id);
+	}
+	
+	// Si un éclat est actif, gérer son évolution
+	if (state->active) {
+		unsigned long elapsed_time = param_time(params, current_millis - state->start_time);
+		unsigned long current_welding_duration = (WELDING_MIN_DURATION + WELDING_MAX_DURATION) / 2;
+		
+		if (elapsed_time < current_welding_duration * 0.7) {
+			// Phase d'intensité maximale avec micro-variations
+			uint16_t variation = random(-200, 201);
+			uint16_t current_brightness = constrain(state->current_intensity + variation, 0, 4095);
+			led_info->setBrightness(param_level(params, current_brightness));
+			
+		} else if (elapsed_time < current_welding_duration) {
+			// Phase de fondu
+			float fade_progress = (float)(elapsed_time - current_welding_duration * 0.7) / (current_welding_duration * 0.3);
+			uint16_t current_brightness = state->current_intensity * (1.0 - fade_progress);
+			led_info->setBrightness(param_level(params, current_brightness));
+			
+		} else {
+			// Éclat terminé
+			state->active = false;
+			led_info->setBrightness(param_level(params, 0));
+		}
+		
+		module_manager->applyLedBrightness(module_id, led_id);
+	}
+	
+	state->last_update = current_millis;
+}
+
+void ProgramManager::update_heartbeat_program(LED* led_info, uint8_t module_id, uint8_t led_id, unsigned long current_millis) {
+	ProgramState* state = led_info->getProgramState();
+	const ProgramParams* params = state->params;
+	
+	if (!is_update_due(state, current_millis, 20)) {
+		return; // Update à 50Hz pour fluidité
+	}
+	
+	// Initialiser le cycle si nécessaire
+	if (state->start_time == 0) {
+		state->start_time = current_millis;
+	}
+	
+	unsigned long cycle_time = get_cycle_time(state, current_millis, HEARTBEAT_CYCLE_DURATION);
+	led_info->setBrightness(get_shared_level(PROGRAM_HEARTBEAT, params, current_millis, cycle_time));
+	module_manager->applyLedBrightness(module_id, led_id);
+	
+	state->last_update = current_millis;
+}
+
+void ProgramManager::update_breathing_program(LED* led_info, uint8_t module_id, uint8_t led_id, unsigned long current_millis) {
+	ProgramState* state = led_info->getProgramState();
+	const ProgramParams* params = state->params;
+   
+	if (!is_update_due(state, current_millis, 20)) {
+		return; // Update à 50Hz pour fluidité
+	}
+   
+	// Initialiser le cycle si nécessaire
+	if (state->start_time == 0) {
+		state->start_time = current_millis;
+	}
+   
+	unsigned long cycle_time = get_cycle_time(state, current_millis, BREATHING_CYCLE_DURATION);
+	led_info->setBrightness(get_shared_level(PROGRAM_BREATHING, params, current_millis, cycle_time));
+	module_manager->applyLedBrightness(module_id, led_id);
+   
+	state->last_update = current_millis;
+}
+
+void ProgramManager::update_simple_blink_program(LED* led_info, uint8_t module_id, uint8_t led_id, unsigned long current_millis) {
+	ProgramState* state = led_info->getProgramState();
+	const ProgramParams* params = state->params;
+	
+	if (!is_update_due(state, current_millis, 50)) {
+		return; // Update every 50ms
+	}
+	
+	// Initialize cycle if necessary
+	if (state->start_time == 0) {
+		state->start_time = current_millis;
+	}
+	
+	unsigned long cycle_time = get_cycle_time(state, current_millis, SIMPLE_BLINK_ON_DURATION + SIMPLE_BLINK_OFF_DURATION);
+	led_info->setBrightness(get_shared_level(PROGRAM_SIMPLE_BLINK, params, current_millis, cycle_time));
+	module_manager->applyLedBrightness(module_id, led_id);
+	
+	state->last_update = current_millis;
+}
+
+void ProgramManager::update_tv_flicker_program(LED* led_info, uint8_t module_id, uint8_t led_id, unsigned long current_millis) {
+	ProgramState* state = led_info->getProgramState();
+	const ProgramParams* params = state->params;
+	
+	if (current_millis - state->last_update < 20) {
+		return; // Update at 50Hz for smooth flickering
+	}
+	
+	// Check if it's time for next flicker change
+	if (!state->active || current_millis >= state->next_event) {
+		state->active = true;
+		
+		// Determine next change type
+		uint8_t random_value = random(0, 100);
+		uint8_t flash_probability = param_probability(params, TV_FLICKER_FLASH_PROBABILITY);
+		uint8_t dim_probability = param_probability(params, TV_FLICKER_DIM_PROBABILITY);
+		
+		if (random_value < flash_probability) {
+			// Bright flash
+			state->current_intensity = random(TV_FLICKER_MAX_INTENSITY * 0.8, TV_FLICKER_MAX_INTENSITY + 1);
+		} else if (random_value < flash_probability + dim_probability) {
+			// Dim period
+			state->current_intensity = random(TV_FLICKER_MIN_INTENSITY, TV_FLICKER_MIN_INTENSITY * 1.5);
+		} else {
+			// Normal variation around base intensity
+			int16_t variation = random(-200, 201);
+			state->current_intensity = constrain(TV_FLICKER_BASE_INTENSITY + variation, 
+				TV_FLICKER_MIN_INTENSITY, 
+				TV_FLICKER_MAX_INTENSITY);
+		}
+		
+		// Schedule next change with random interval
+		unsigned long next_interval = param_interval(params, random(TV_FLICKER_MIN_INTERVAL, TV_FLICKER_MAX_INTERVAL + 1));
+		state->next_event = current_millis + next_interval;
+		
+		// Add some micro-variations for more realism
+		int16_t micro_variation = random(-50, 51);
+		uint16_t final_intensity = constrain(state->current_intensity + micro_variation, 
+			TV_FLICKER_MIN_INTENSITY, 
+			TV_FLICKER_MAX_INTENSITY);
+		
+		led_info->setBrightness(param_level(params, final_intensity));
+		module_manager->applyLedBrightness(module_id, led_id);
+	}
+	
+	state->last_update = current_millis;
+}
+
+void ProgramManager::update_firebox_glow_program(LED* led_info, uint8_t module_id, uint8_t led_id, unsigned long current_millis) {
+	ProgramState* state = led_info->getProgramState();
+	const ProgramParams* params = state->params;
+	
+	if (current_millis - state->last_update < 20) {
+		return; // Update at 50Hz for realistic fire movement
+	}
+	
+	// Initialize if needed
+	if (state->start_time == 0) {
+		state->start_time = current_millis;
+		state->next_event = current_millis + param_interval(params, random(FIREBOX_MIN_INTERVAL, FIREBOX_MAX_INTERVAL + 1));
+		state->current_intensity = FIREBOX_BASE_INTENSITY;
+		// Use parameters to track fire state: [0] = effect_type, [1] = effect_start_time
+		state->parameters["effect_type"] = 0;
+		state->parameters["effect_start_time"] = 0;
+	}
+	
+	uint16_t target_intensity = FIREBOX_BASE_INTENSITY;
+	uint8_t current_effect = state->parameters["effect_type"];
+	unsigned long effect_start = state->parameters["effect_start_time"];
+	
+	// Handle active effects
+	if (current_effect > 0) {
+		unsigned long effect_duration = param_time(params, current_millis - effect_start);
+		
+		switch (current_effect) {
+			case 1: // Ember pop
+				if (effect_duration < FIREBOX_EMBER_DURATION) {
+					// Quick bright flash then decay
+					float progress = (float)effect_duration / FIREBOX_EMBER_DURATION;
+					if (progress < 0.2) {
+						// Sharp rise
+						target_intensity = FIREBOX_BASE_INTENSITY + (1800 * (progress / 0.2));
+					} else {
+						// Quick decay
+						target_intensity = FIREBOX_BASE_INTENSITY + (1800 * (1.0 - (progress - 0.2) / 0.8));
+					}
+				} else {
+					// Effect finished
+					state->parameters["effect_type"] = 0;
+				}
+				break;
+				
+			case 2: // Flame surge
+				if (effect_duration < FIREBOX_SURGE_DURATION) {
+					// Gradual rise and fall
+					float progress = (float)effect_duration / FIREBOX_SURGE_DURATION;
+					float surge_intensity;
+					if (progress < 0.3) {
+						// Rising
+						surge_intensity = progress / 0.3;
+					} else if (progress < 0.7) {
+						// Sustained high
+						surge_intensity = 1.0 + 0.2 * sin(progress * PI * 8); // Flickering at peak
+					} else {
+						// Falling
+						surge_intensity = (1.0 - progress) / 0.3;
+					}
+					target_intensity = FIREBOX_BASE_INTENSITY + (1500 * surge_intensity);
+				} else {
+					// Effect finished
+					state->parameters["effect_type"] = 0;
+				}
+				break;
+				
+			case 3: // Wind gust
+				if (effect_duration < FIREBOX_WIND_DURATION) {
+					// Irregular dancing flames
+					float progress = (float)effect_duration / FIREBOX_WIND_DURATION;
+					float wind_factor = sin(progress * PI * 3) * sin(progress * PI * 7) * sin(progress * PI * 11);
+					wind_factor *= (1.0 - progress); // Decay over time
+					target_intensity = FIREBOX_BASE_INTENSITY + (800 * wind_factor);
+				} else {
+					// Effect finished
+					state->parameters["effect_type"] = 0;
+				}
+				break;
+		}
+	}
+	
+	// Check for new effects
+	if (current_effect == 0 && current_millis >= state->next_event) {
+		uint8_t random_value = random(0, 100);
+		uint8_t ember_probability = param_probability(params, FIREBOX_EMBER_POP_PROBABILITY);
+		uint8_t surge_probability = param_probability(params, FIREBOX_FLAME_SURGE_PROBABILITY);
+		uint8_t wind_probability = param_probability(params, FIREBOX_WIND_GUST_PROBABILITY);
+		
+		if (random_value < ember_probability) {
+			// Start ember pop
+			state->parameters["effect_type"] = 1;
+			state->parameters["effect_start_time"] = current_millis;
+		} else if (random_value < ember_probability + surge_probability) {
+			// Start flame surge
+			state->parameters["effect_type"] = 2;
+			state->parameters["effect_start_time"] = current_millis;
+		} else if (random_value < ember_probability + surge_probability + wind_probability) {
+			// Start wind gust
+			state->parameters["effect_type"] = 3;
+			state->parameters["effect_start_time"] = current_millis;
+		}
+		
+		// Schedule next potential event
+		state->next_event = current_millis + param_interval(params, random(FIREBOX_MIN_INTERVAL, FIREBOX_MAX_INTERVAL + 1));
+	}
+	
+	// Add base fire variations (always active)
+	if (current_effect == 0) {
+		// Normal crackling variations
+		int16_t base_variation = random(-400, 401);
+		target_intensity = constrain(FIREBOX_BASE_INTENSITY + base_variation, 
+									FIREBOX_MIN_INTENSITY, 
+									FIREBOX_MAX_INTENSITY);
+	}
+	
+	// Add micro-variations for organic feel
+	int16_t micro_variation = random(-100, 101);
+	target_intensity = constrain(target_intensity + micro_variation, 
+								FIREBOX_MIN_INTENSITY, 
+								FIREBOX_MAX_INTENSITY);
+	
+	// Smooth large transitions
+	uint16_t current_brightness = state->output_level;
+	int16_t intensity_diff = target_intensity - current_brightness;
+	
+	if (abs(intensity_diff) > 300 && current_effect != 1) { // Don't smooth ember pops
+		// Large change - smooth it out
+		if (intensity_diff > 0) {
+			target_intensity = current_brightness + 150;
+		} else {
+			target_intensity = current_brightness - 150;
+		}
+	}
+	
+	state->output_level = target_intensity;
+	led_info->setBrightness(param_level(params, target_intensity));
+	module_manager->applyLedBrightness(module_id, led_id);
+	
+	state->last_update = current_millis;
+}
+
+void ProgramManager::update_candle_flicker_program(LED* led_info, uint8_t module_id, uint8_t led_id, unsigned long current_millis) {
+	ProgramState* state = led_info->getProgramState();
+	const ProgramParams* params = state->params;
+	
+	if (current_millis - state->last_update < 25) {
+		return; // Update at 40Hz for smooth organic movement
+	}
+	
+	// Initialize if needed
+	if (state->start_time == 0) {
+		state->start_time = current_millis;
+		state->next_event = current_millis + param_interval(params, random(CANDLE_MIN_INTERVAL, CANDLE_MAX_INTERVAL + 1));
+		state->current_intensity = CANDLE_BASE_INTENSITY;
+	}
+	
+	// Check if it's time for a new flicker event
+	if (current_millis >= state->next_event) {
+		uint8_t random_value = random(0, 100);
+		uint8_t strong_probability = param_probability(params, CANDLE_STRONG_FLICKER_PROBABILITY);
+		uint8_t dip_probability = param_probability(params, CANDLE_DIP_PROBABILITY);
+		
+		if (random_value < strong_probability) {
+			// Strong upward flicker
+			state->current_intensity = random(CANDLE_MAX_INTENSITY * 0.9, CANDLE_MAX_INTENSITY + 1);
+		} else if (random_value < strong_probability + dip_probability) {
+			// Gentle downward dip
+			state->current_intensity = random(CANDLE_MIN_INTENSITY, CANDLE_MIN_INTENSITY * 1.2);
+		} else {
+			// Gentle variation around base
+			int16_t gentle_variation = random(-150, 151);
+			state->current_intensity = constrain(CANDLE_BASE_INTENSITY + gentle_variation, 
+												CANDLE_MIN_INTENSITY, 
+												CANDLE_MAX_INTENSITY);
+		}
+		
+		// Schedule next flicker with variable timing
+		unsigned long next_interval = param_interval(params, random(CANDLE_MIN_INTERVAL, CANDLE_MAX_INTERVAL + 1));
+		state->next_event = current_millis + next_interval;
+	}
+	
+	// Add continuous subtle variations for organic feel
+	int16_t subtle_variation = random(-30, 31);
+	uint16_t target_intensity = constrain(state->current_intensity + subtle_variation, 
+										 CANDLE_MIN_INTENSITY, 
+										 CANDLE_MAX_INTENSITY);
+	
+	// Smooth transitions to avoid harsh changes
+	uint16_t current_brightness = state->output_level;
+	int16_t intensity_diff = target_intensity - current_brightness;
+	
+	if (abs(intensity_diff) > 200) {
+		// Large change - smooth it out over multiple updates
+		if (intensity_diff > 0) {
+			target_intensity = current_brightness + 80;
+		} else {
+			target_intensity = current_brightness - 80;
+		}
+	} else if (abs(intensity_diff) > 50) {
+		// Medium change - partial step
+		target_intensity = current_brightness + (intensity_diff / 3);
+	}
+	
+	state->output_level = target_intensity;
+	led_info->setBrightness(param_level(params, target_intensity));
+	module_manager->applyLedBrightness(module_id, led_id);
+	
+	state->last_update = current_millis;
+}
+
+void ProgramManager::update_french_crossing_program(LED* led_info, uint8_t module_id, uint8_t led_id, unsigned long current_millis) {
+	ProgramState* state = led_info->getProgramState();
+	const ProgramParams* params = state->params;
+	
+	if (!is_update_due(state, current_millis, 10)) {
+		return; // Update at 100Hz for smooth filament effect
+	}
+	
+	// Initialize cycle if necessary
+	if (state->start_time == 0) {
+		state->start_time = current_millis;
+		// Use parameters to track filament state: [0] = phase_start_time, [1] = current_phase
+		state->parameters["phase_start_time"] = current_millis;
+		state->parameters["current_phase"] = 0; // 0 = OFF, 1 = ON
+	}
+	
+	unsigned long cycle_time = get_cycle_time(state, current_millis, FRENCH_CROSSING_ON_DURATION + FRENCH_CROSSING_OFF_DURATION);
+	unsigned long phase_start = state->parameters["phase_start_time"];
+	uint8_t current_phase = state->parameters["current_phase"];
+	
+	// Detect phase transitions
+	bool should_be_on = (cycle_time < FRENCH_CROSSING_ON_DURATION);
+	
+	if ((should_be_on && current_phase == 0) || (!should_be_on && current_phase == 1)) {
+		// Phase change detected
+		state->parameters["phase_start_time"] = current_millis;
+		state->parameters["current_phase"] = should_be_on ? 1 : 0;
+		phase_start = current_millis;
+		current_phase = should_be_on ? 1 : 0;
+	}
+	
+	unsigned long phase_time = param_time(params, current_millis - phase_start);
+	uint16_t target_brightness = 0;
+	
+	if (current_phase == 1) {
+		// ON phase - filament heating up
+		if (phase_time < FRENCH_CROSSING_WARMUP_DURATION) {
+			// Filament warm-up: gradual increase with exponential curve
+			float warmup_progress = (float)phase_time / FRENCH_CROSSING_WARMUP_DURATION;
+			
+			// Exponential heating curve: faster start, slower finish
+			float exponential_progress = 1.0 - exp(-4.0 * warmup_progress);
+			
+			target_brightness = FRENCH_CROSSING_WARMUP_MIN + 
+							   (FRENCH_CROSSING_MAX_INTENSITY - FRENCH_CROSSING_WARMUP_MIN) * exponential_progress;
+		} else {
+			// Full intensity with slight filament stability variations
+			int16_t stability_variation = random(-25, 26);
+			target_brightness = constrain(FRENCH_CROSSING_MAX_INTENSITY + stability_variation, 
+										 FRENCH_CROSSING_MAX_INTENSITY - 50, 
+										 FRENCH_CROSSING_MAX_INTENSITY);
+		}
+	} else {	
+		if (phase_time < FRENCH_CROSSING_COOLDOWN_DURATION) {
+			// Filament cool-down: exponential decay (slower than heating)
+			float cooldown_progress = (float)phase_time / FRENCH_CROSSING_COOLDOWN_DURATION;
+			
+			// Exponential cooling curve: starts fast, then slower (thermal inertia)
+			float exponential_decay = exp(-2.0 * cooldown_progress); // Slower decay than heating
+			
+			target_brightness = FRENCH_CROSSING_WARMUP_MIN * exponential_decay;
+			
+			// Add slight red glow persistence for realism
+			//if (target_brightness < 50 && phase_time < FRENCH_CROSSING_COOLDOWN_DURATION * 0.8) {
+			//	target_brightness += random(5, 15); // Faint residual glow
+			//}
+		} else {
+			// Completely off
+			target_brightness = 0;
+		}
+	}
+	
+	led_info->setBrightness(param_level(params, target_brightness));
+	module_manager->applyLedBrightness(module_id, led_id);
+	
+	state->last_update = current_millis;
+}
+
+void ProgramManager::update_custom_program(LED* led_info, uint8_t module_id, uint8_t led_id, unsigned long current_millis) {
+	ProgramState* state = led_info->getProgramState();
+	const ProgramParams* params = state->params;
+
+	if (current_millis - state->last_update < 10) {
+		return; // Update at 100Hz, timing is kept by the interpreter
+	}
+
+	// The effect runs on program time, so that speed applies to it too
+	EffectVM::Stats* stats = state->effect_slot < EFFECT_SLOTS ? &effect_stats_[state->effect_slot] : nullptr;
+	unsigned long effect_millis = state->start_time + param_time(params, current_millis - state->start_time);
+	uint16_t level = EffectVM::step(state->effect, state->output_level, effect_millis, stats);
+
+	if (level != state->output_level) {
+		state->output_level = level;
+		led_info->setBrightness(param_level(params, level));
+		module_manager->applyLedBrightness(module_id, led_id);
+	}
+
+	state->last_update = current_millis;
+}
+
+bool ProgramManager::initialize_led_state(uint8_t module_id, uint8_t led_id) {
+	if (!module_manager || module_id >= module_manager->getModuleCount()) {
+		return false;
+	}
+	
+	const PCA9685Module* module = module_manager->getModule(module_id);
+	if (!module || led_id >= module->getLedCount()) {
+		return false;
+	}
+	
+	LED* led_info = module_manager->getLED(module_id, led_id);
+	if (!led_info || !led_info->getProgramState()) {
+		return false;
+	}
+
+	initialize_state(led_info);
+	return true;
+}
+
+void ProgramManager::initialize_state(LED* led_info) {
+	// Programs smoothing their output start from the current level
+	led_info->getProgramState()->output_level = led_info->getBrightness();
+
+	switch (led_info->getProgramType()) {
+		case PROGRAM_WELDING:
+			initialize_welding_state(led_info->getProgramState());
+			break;
+		case PROGRAM_HEARTBEAT:
+			initialize_default_state(led_info->getProgramState());
+			break;
+		case PROGRAM_BREATHING:
+			initialize_default_state(led_info->getProgramState());
+			break;
+		case PROGRAM_SIMPLE_BLINK:
+			initialize_default_state(led_info->getProgramState());
+			break;
+		case PROGRAM_TV_FLICKER:
+			initialize_default_state(led_info->getProgramState());
+			break;
+		case PROGRAM_FIREBOX_GLOW:
+			initialize_default_state(led_info->getProgramState());
+			break;
+		case PROGRAM_CANDLE_FLICKER:
+			initialize_default_state(led_info->getProgramState());
+			break;
+		case PROGRAM_FRENCH_CROSSING:
+			initialize_default_state(led_info->getProgramState());
+			break;
+		case PROGRAM_CUSTOM: {
+			ProgramState* state = led_info->getProgramState();
+			initialize_default_state(state);
+			EffectVM::start(state->effect, get_effect(state->effect_slot), state->start_time);
+			break;
+		}
+		default:
+			break;
+	}
+}
+
+void ProgramManager::initialize_default_state(ProgramState* state) {
+	state->last_update = 0;
+	state->start_time = millis();
+	state->active = true;
+	state->current_intensity = 0;
+}
+
+void ProgramManager::initialize_welding_state(ProgramState* state) {
+	state->last_update = 0;
+	state->next_event = millis() + random(1000, 3000); // Premier éclat dans 1-3 secondes
+	state->active = false;
+	state->start_time = 0;
+	state->current_intensity = 0;
+}
+
+// === Program Parameters ===
+
+ProgramState* ProgramManager::create_state(ProgramState* previous) {
+	ProgramState* state = new ProgramState();
+	if (previous) {
+		state->effect_slot = previous->effect_slot;
+		state->params = previous->params;
+		state->phase_group = previous->phase_group;
+		state->phase_offset = previous->phase_offset;
+		previous->params = &ProgramParams::DEFAULTS;
+		delete previous;
+	}
+	return state;
+}
+
+bool ProgramManager::resolve_params(ProgramParams& params) {
+	if (params.intensity_percent > ProgramParams::INTENSITY_MAX ||
+		params.probability_percent > ProgramParams::PROBABILITY_MAX ||
+		params.speed_percent < ProgramParams::SPEED_MIN || params.speed_percent > ProgramParams::SPEED_MAX ||
+		params.min_level > params.max_level || params.max_level > LED::MAX_BRIGHTNESS) {
+		return false;
+	}
+
+	params.intensity_q8 = (params.intensity_percent * 256 + 50) / 100;
+	params.probability_q8 = (params.probability_percent * 256 + 50) / 100;
+	params.time_q8 = (params.speed_percent * 256 + 50) / 100;
+	params.interval_q8 = (100 * 256 + params.speed_percent / 2) / params.speed_percent;
+	return true;
+}
+
+bool ProgramManager::is_default_params(const ProgramParams& params) {
+	const ProgramParams& defaults = ProgramParams::DEFAULTS;
+	return params.intensity_percent == defaults.intensity_percent &&
+		params.probability_percent == defaults.probability_percent &&
+		params.speed_percent == defaults.speed_percent &&
+		params.min_level == defaults.min_level &&
+		params.max_level == defaults.max_level;
+}
+
+bool ProgramManager::set_program_params(uint8_t module_id, uint8_t led_id, const ProgramParams& params) {
+	LED* led_info = module_manager ? module_manager->getLED(module_id, led_id) : nullptr;
+	if (!led_info || !led_info->getProgramState()) {
+		return false;
+	}
+
+	ProgramParams resolved = params;
+	if (!resolve_params(resolved)) {
+		return false;
+	}
+
+	// Defaults share the read-only instance, overrides are owned by the state
+	ProgramState* state = led_info->getProgramState();
+	const ProgramParams* previous = state->params;
+	if (is_default_params(resolved)) {
+		state->params = &ProgramParams::DEFAULTS;
+	} else {
+		state->params = new ProgramParams(resolved);
+	}
+	if (previous != &ProgramParams::DEFAULTS) {
+		delete previous;
+	}
+
+	LOG_INFO("[PROGRAMMGR] LED %d:%d parameters: intensity %d%%, speed %d%%, probability %d%%, levels %d-%d\n",
+		module_id, led_id, resolved.intensity_percent, resolved.speed_percent,
+		resolved.probability_percent, resolved.min_level, resolved.max_level);
+	return true;
+}
+
+const ProgramParams& ProgramManager::get_program_params(uint8_t module_id, uint8_t led_id) {
+	const LED* led_info = module_manager ? module_manager->getLED(module_id, led_id) : nullptr;
+	if (!led_info || !led_info->getProgramState()) {
+		return ProgramParams::DEFAULTS;
+	}
+	return *led_info->getProgramState()->params;
+}
+
+bool ProgramManager::params_from_json(JsonObjectConst json, ProgramParams& params) {
+	if ((!json["intensity"].isNull() && !json["intensity"].is<uint8_t>()) ||
+		(!json["probability"].isNull() && !json["probability"].is<uint8_t>()) ||
+		(!json["speed"].isNull() && !json["speed"].is<uint16_t>()) ||
+		(!json["min"].isNull() && !json["min"].is<uint16_t>()) ||
+		(!json["max"].isNull() && !json["max"].is<uint16_t>())) {
+		return false;
+	}
+
+	params.intensity_percent = json["intensity"] | params.intensity_percent;
+	params.probability_percent = json["probability"] | params.probability_percent;
+	params.speed_percent = json["speed"] | params.speed_percent;
+	params.min_level = json["min"] | params.min_level;
+	params.max_level = json["max"] | params.max_level;
+	return true;
+}
+
+void ProgramManager::params_to_json(const ProgramParams& params, JsonObject json) {
+	json["intensity"] = params.intensity_percent;
+	json["speed"] = params.speed_percent;
+	json["probability"] = params.probability_percent;
+	json["min"] = params.min_level;
+	json["max"] = params.max_level;
+}
+
+// === Phase Groups ===
+
+bool ProgramManager::set_phase_group(uint8_t module_id, uint8_t led_id, uint8_t group, uint16_t offset_degrees) {
+	LED* led_info = module_manager ? module_manager->getLED(module_id, led_id) : nullptr;
+	if (!led_info || !led_info->getProgramState() || group > PHASE_GROUPS || offset_degrees >= 360) {
+		return false;
+	}
+
+	// The timebase starts with the first member and is kept afterwards
+	if (group > 0 && !phase_groups_[group - 1].started) {
+		phase_groups_[group - 1].start = millis();
+		phase_groups_[group - 1].started = true;
+	}
+
+	ProgramState* state = led_info->getProgramState();
+	state->phase_group = group;
+	state->phase_offset = group > 0 ? ((static_cast<uint32_t>(offset_degrees) << 16) + 180) / 360 : 0;
+	state->last_update = 0;
+
+	LOG_INFO("[PROGRAMMGR] LED %d:%d phase group %d, offset %d degrees\n", module_id, led_id, group, offset_degrees);
+	return true;
+}
+
+uint8_t ProgramManager::get_phase_group(uint8_t module_id, uint8_t led_id, uint16_t& offset_degrees) {
+	const LED* led_info = module_manager ? module_manager->getLED(module_id, led_id) : nullptr;
+	offset_degrees = 0;
+	if (!led_info || !led_info->getProgramState()) {
+		return 0;
+	}
+
+	const ProgramState* state = led_info->getProgramState();
+	offset_degrees = (static_cast<uint32_t>(state->phase_offset) * 360 + 32768) >> 16;
+	return state->phase_group;
+}
+
+unsigned long ProgramManager::get_cycle_time(const ProgramState* state, unsigned long current_millis, unsigned long cycle) {
+	const ProgramParams* params = state->params;
+	if (state->phase_group == 0 || state->phase_group > PHASE_GROUPS) {
+		return param_time(params, current_millis - state->start_time) % cycle;
+	}
+
+	// Computed by the first member updated, reused by the others of this update
+	PhaseGroup& group = phase_groups_[state->phase_group - 1];
+	if (group.frame != current_millis || group.cycle != cycle || group.time_q8 != params->time_q8) {
+		group.phase = (static_cast<uint64_t>(param_time(params, current_millis - group.start) % cycle) << 16) / cycle;
+		group.frame = current_millis;
+		group.cycle = cycle;
+		group.time_q8 = params->time_q8;
+	}
+
+	uint16_t phase = group.phase + state->phase_offset;
+	return (static_cast<uint64_t>(phase) * cycle) >> 16;
+}
+
+bool ProgramManager::is_update_due(const ProgramState* state, unsigned long current_millis, unsigned long interval) {
+	if (state->phase_group == 0 || state->phase_group > PHASE_GROUPS) {
+		return current_millis - state->last_update >= interval;
+	}
+
+	// Same interval boundaries on the group timebase for every member
+	unsigned long start = phase_groups_[state->phase_group - 1].start;
+	return state->last_update == 0 || (current_millis - start) / interval != (state->last_update - start) / interval;
+}
+
+// === Shared Evaluation ===
+
+ProgramManager::SharedStats ProgramManager::get_shared_stats() {
+	return shared_stats_;
+}
+
+uint16_t ProgramManager::get_shared_level(ProgramType program, const ProgramParams* params, unsigned long current_millis, unsigned long cycle_time) {
+	// LEDs at the same point of the same curve with the same output mapping share a level
+	SharedLevel& entry = shared_levels_[(cycle_time * 31 + program) % SHARED_LEVEL_SLOTS];
+	if (entry.frame == current_millis && entry.program == static_cast<uint8_t>(program) && entry.cycle_time == cycle_time &&
+		entry.intensity_q8 == params->intensity_q8 && entry.min_level == params->min_level && entry.max_level == params->max_level) {
+		shared_stats_.reuses++;
+		return entry.level;
+	}
+
+	int32_t level = 0;
+	switch (program) {
+		case PROGRAM_HEARTBEAT:
+			level = heartbeat_level(cycle_time);
+			break;
+		case PROGRAM_BREATHING:
+			level = breathing_level(cycle_time);
+			break;
+		case PROGRAM_SIMPLE_BLINK:
+			level = simple_blink_level(cycle_time);
+			break;
+		default:
+			break;
+	}
+
+	entry.frame = current_millis;
+	entry.program = program;
+	entry.cycle_time = cycle_time;
+	entry.intensity_q8 = params->intensity_q8;
+	entry.min_level = params->min_level;
+	entry.max_level = params->max_level;
+	entry.level = param_level(params, level);
+	shared_stats_.evaluations++;
+	return entry.level;
+}
+
+// === User Effects ===
+
+bool ProgramManager::set_effect(uint8_t slot, const EffectVM::Program& effect) {
+	if (slot >= EFFECT_SLOTS) {
+		return false;
+	}
+
+	effects_[slot] = effect;
+	effect_stats_[slot] = EffectVM::Stats();
+	restart_effect(slot);
+
+	LOG_INFO("[PROGRAMMGR] Effect slot %d: %s (%d instructions)\n", slot, effect.name, effect.length);
+	return true;
+}
+
+bool ProgramManager::request_effect(uint8_t slot, const EffectVM::Program& effect) {
+	if (slot >= EFFECT_SLOTS || effect_pending_) {
+		return false;
+	}
+
+	pending_effect_ = effect;
+	pending_effect_slot_ = slot;
+	effect_pending_ = true;
+	return true;
+}
+
+const EffectVM::Program* ProgramManager::get_effect(uint8_t slot) {
+	if (slot >= EFFECT_SLOTS || effects_[slot].length == 0) {
+		return nullptr;
+	}
+	return &effects_[slot];
+}
+
+EffectVM::Stats ProgramManager::get_effect_stats(uint8_t slot) {
+	if (slot >= EFFECT_SLOTS) {
+		return EffectVM::Stats();
+	}
+	return effect_stats_[slot];
+}
+
+bool ProgramManager::assign_effect(uint8_t module_id, uint8_t led_id, uint8_t slot) {
+	if (slot >= EFFECT_SLOTS || !module_manager) {
+		return false;
+	}
+
+	LED* led_info = module_manager->getLED(module_id, led_id);
+	if (!led_info) {
+		return false;
+	}
+
+	if (led_info->getProgramType() != PROGRAM_CUSTOM || led_info->getProgramState() == nullptr) {
+		if (!assign_program(module_id, led_id, PROGRAM_CUSTOM)) {
+			return false;
+		}
+	}
+
+	led_info->getProgramState()->effect_slot = slot;
+	initialize_led_state(module_id, led_id);
+
+	LOG_INFO("[PROGRAMMGR] Effect slot %d assigned to LED %d:%d\n", slot, module_id, led_id);
+	return true;
+}
+
+void ProgramManager::restart_effect(uint8_t slot) {
+	if (!module_manager) return;
+
+	unsigned long now = millis();
+	for (uint8_t i = 0; i < module_manager->getModuleCount(); i++) {
+		const PCA9685Module* module = module_manager->getModule(i);
+		if (!module) continue;
+
+		for (uint8_t j = 0; j < module->getLedCount(); j++) {
+			LED* led_info = module_manager->getLED(i, j);
+			if (!led_info || led_info->getProgramType() != PROGRAM_CUSTOM) continue;
+
+			ProgramState* state = led_info->getProgramState();
+			if (state && state->effect_slot == slot) {
+				EffectVM::start(state->effect, get_effect(slot), now);
+			}
+		}
+	}
+}
+
+void ProgramManager::apply_pending_effect() {
+	if (!effect_pending_) {
+		return;
+	}
+
+	set_effect(pending_effect_slot_, pending_effect_);
+	effect_pending_ = false;
+}
+
+// === Effect Benchmark ===
+
+/**
+ * @brief Append one instruction to effect bytecode
+ *
+ * @param code Bytecode buffer
+ * @param size Current bytecode size, advanced by one instruction
+ * @param op Operation
+ * @param arg Loop counter or jump probability
+ * @param value Level, duration or target index
+ * @param param Duration, extra duration, maximum level or count
+ */
+static void emit_effect(uint8_t* code, size_t& size, EffectOp op, uint8_t arg, uint16_t value, uint16_t param) {
+	uint8_t* p = code + size;
+	p[0] = op;
+	p[1] = arg;
+	p[2] = value & 0xFF;
+	p[3] = value >> 8;
+	p[4] = param & 0xFF;
+	p[5] = param >> 8;
+	size += EffectVM::INSTRUCTION_SIZE;
+}
+
+/**
+ * @brief Build the bytecode equivalent of a native program
+ *
+ * Breathing fades linearly where the native program follows a sine.
+ *
+ * @param type PROGRAM_HEARTBEAT, PROGRAM_BREATHING or PROGRAM_SIMPLE_BLINK
+ * @param code Buffer of at least 9 instructions
+ * @return Bytecode size
+ */
+static size_t build_reference_effect(ProgramType type, uint8_t* code) {
+	size_t size = 0;
+	switch (type) {
+		case PROGRAM_HEARTBEAT:
+			emit_effect(code, size, EFFECT_SET, 0, HEARTBEAT_INTENSITY, 0);
+			emit_effect(code, size, EFFECT_HOLD, 0, HEARTBEAT_BEAT1_DURATION, 0);
+			emit_effect(code, size, EFFECT_SET, 0, 0, 0);
+			emit_effect(code, size, EFFECT_HOLD, 0, HEARTBEAT_PAUSE1_DURATION, 0);
+			emit_effect(code, size, EFFECT_SET, 0, HEARTBEAT_INTENSITY * 6 / 10, 0);
+			emit_effect(code, size, EFFECT_HOLD, 0, HEARTBEAT_BEAT2_DURATION, 0);
+			emit_effect(code, size, EFFECT_SET, 0, 0, 0);
+			emit_effect(code, size, EFFECT_HOLD, 0, HEARTBEAT_PAUSE2_DURATION, 0);
+			emit_effect(code, size, EFFECT_JUMP, 100, 0, 0);
+			break;
+		case PROGRAM_BREATHING:
+			emit_effect(code, size, EFFECT_RAMP, 0, BREATHING_MAX_INTENSITY, BREATHING_INHALE_DURATION);
+			emit_effect(code, size, EFFECT_HOLD, 0, BREATHING_HOLD_DURATION, 0);
+			emit_effect(code, size, EFFECT_RAMP, 0, BREATHING_MIN_INTENSITY, BREATHING_EXHALE_DURATION);
+			emit_effect(code, size, EFFECT_HOLD, 0, BREATHING_PAUSE_DURATION, 0);
+			emit_effect(code, size, EFFECT_JUMP, 100, 0, 0);
+			break;
+		case PROGRAM_SIMPLE_BLINK:
+			emit_effect(code, size, EFFECT_SET, 0, SIMPLE_BLINK_INTENSITY, 0);
+			emit_effect(code, size, EFFECT_HOLD, 0, SIMPLE_BLINK_ON_DURATION, 0);
+			emit_effect(code, size, EFFECT_SET, 0, 0, 0);
+			emit_effect(code, size, EFFECT_HOLD, 0, SIMPLE_BLINK_OFF_DURATION, 0);
+			emit_effect(code, size, EFFECT_JUMP, 100, 0, 0);
+			break;
+		default:
+			break;
+	}
+	return size;
+}
+
+bool ProgramManager::request_effect_bench(uint16_t rounds) {
+	if (rounds == 0 || rounds > EFFECT_BENCH_ROUNDS_MAX) {
+		return false;
+	}
+
+	effect_bench_rounds_ = rounds;
+	effect_bench_pending_ = true;
+	return true;
+}
+
+const ProgramManager::EffectBenchResult* ProgramManager::get_effect_bench(uint16_t& rounds) {
+	rounds = effect_bench_pending_ ? 0 : effect_bench_rounds_;
+	return effect_bench_;
+}
+
+void ProgramManager::run_effect_bench() {
+	// Simulated time between two updates, above every native rate limit
+	const unsigned long BENCH_STEP_MS = 50;
+	static const ProgramType natives[EFFECT_BENCH_COUNT] = {PROGRAM_HEARTBEAT, PROGRAM_BREATHING, PROGRAM_SIMPLE_BLINK};
+	static const char* const names[EFFECT_BENCH_COUNT] = {"Heartbeat", "Breathing", "Simple Blink"};
+	typedef void (*UpdateFunction)(LED*, uint8_t, uint8_t, unsigned long);
+	static const UpdateFunction updates[EFFECT_BENCH_COUNT] = {
+		update_heartbeat_program, update_breathing_program, update_simple_blink_program
+	};
+
+	memset(effect_bench_, 0, sizeof(effect_bench_));
+
+	// Borrow the first LED
+	uint8_t module_id = 0;
+	LED* led_info = nullptr;
+	for (uint8_t i = 0; i < module_manager->getModuleCount() && !led_info; i++) {
+		const PCA9685Module* module = module_manager->getModule(i);
+		if (module && module->getLedCount() > 0) {
+			led_info = module_manager->getLED(i, 0);
+			module_id = i;
+		}
+	}
+	if (!led_info) {
+		LOG_WARNING("[PROGRAMMGR] Effect benchmark needs at least one LED\n");
+		effect_bench_rounds_ = 0;
+		return;
+	}
+
+	ProgramType saved_type = led_info->getProgramType();
+	ProgramState* saved_state = led_info->getProgramState();
+	uint16_t saved_brightness = led_info->getBrightness();
+
+	std::unique_ptr<ProgramState> state(new ProgramState());
+	std::unique_ptr<EffectVM::Program> effect(new EffectVM::Program());
+	uint8_t code[16 * EffectVM::INSTRUCTION_SIZE];
+
+	for (uint8_t b = 0; b < EFFECT_BENCH_COUNT; b++) {
+		effect_bench_[b].name = names[b];
+
+		char error[EffectVM::ERROR_MAX];
+		size_t size = build_reference_effect(natives[b], code);
+		if (!EffectVM::compile(code, size, EffectVM::BUDGET_DEFAULT, *effect, error, sizeof(error))) {
+			LOG_ERROR("[PROGRAMMGR] Reference effect %s rejected: %s\n", names[b], error);
+			continue;
+		}
+
+		// Native program
+		unsigned long base = millis();
+		initialize_default_state(state.get());
+		led_info->setProgram(natives[b], state.get());
+		uint32_t start = micros();
+		for (uint16_t r = 1; r <= effect_bench_rounds_; r++) {
+			updates[b](led_info, module_id, 0, base + r * BENCH_STEP_MS);
+		}
+		effect_bench_[b].native_us = micros() - start;
+
+		// Equivalent effect
+		initialize_default_state(state.get());
+		state->effect_slot = EFFECT_SLOTS;
+		EffectVM::start(state->effect, effect.get(), base);
+		led_info->setProgram(PROGRAM_CUSTOM, state.get());
+		start = micros();
+		for (uint16_t r = 1; r <= effect_bench_rounds_; r++) {
+			update_custom_program(led_info, module_id, 0, base + r * BENCH_STEP_MS);
+		}
+		effect_bench_[b].effect_us = micros() - start;
+
+		LOG_INFO("[PROGRAMMGR] Effect benchmark %s: native %u us, effect %u us\n",
+			names[b], effect_bench_[b].native_us, effect_bench_[b].effect_us);
+	}
+
+	led_info->setProgram(saved_type, saved_state);
+	led_info->setBrightness(saved_brightness);
+	module_manager->applyLedBrightness(module_id, 0);
+}
+
+// === Transitions ===
+
+uint8_t ProgramManager::begin_transition(uint32_t duration_ms, TransitionEasing easing) {
+	if (duration_ms == 0 || duration_ms > TRANSITION_MS_MAX || easing > EASING_IN_OUT) {
+		return 0;
+	}
+	
+	for (uint8_t i = 0; i < TRANSITION_SLOTS; i++) {
+		Transition& slot = transitions_[i];
+		if (slot.active) {
+			continue;
+		}
+		slot.start = millis();
+		slot.duration = duration_ms;
+		slot.span = duration_ms;
+		slot.elapsed = 0;
+		slot.easing = easing;
+		slot.weight = 0;
+		if (++transition_serial_ == 0) {
+			transition_serial_ = 1; // 0 = not running
+		}
+		slot.serial = transition_serial_;
+		slot.finished = false;
+		slot.active = true;
+		return i + 1;
+	}
+	
+	LOG_WARNING("[PROGRAMMGR] No free transition slot, change applied at once\n");
+	return 0;
+}
+
+bool ProgramManager::add_to_transition(uint8_t slot, uint8_t module_id, uint8_t led_id) {
+	if (slot == 0 || slot > TRANSITION_SLOTS || !transitions_[slot - 1].active || !module_manager) {
+		return false;
+	}
+	
+	Transition& transition = transitions_[slot - 1];
+	uint32_t delay = millis() - transition.start;
+	if (transition.finished || delay > TRANSITION_JOIN_MS_MAX) {
+		return false;
+	}
+	
+	LED* led_info = module_manager->getLED(module_id, led_id);
+	if (!led_info) {
+		return false;
+	}
+	
+	// Start from what is output now, mixed if already fading; the slot runs until this fade ends
+	led_info->setTransition(slot, led_info->getOutputBrightness(), delay);
+	if (delay + transition.duration > transition.span) {
+		transition.span = delay + transition.duration;
+	}
+	return true;
+}
+
+uint32_t ProgramManager::get_transition_weight(uint8_t slot, uint16_t delay) {
+	if (slot == 0 || slot > TRANSITION_SLOTS || !transitions_[slot - 1].active) {
+		return TRANSITION_WEIGHT_ONE;
+	}
+	
+	// LEDs added at start share the weight computed once per update
+	const Transition& transition = transitions_[slot - 1];
+	if (delay == 0) {
+		return transition.weight;
+	}
+	if (transition.elapsed <= delay) {
+		return 0;
+	}
+	uint32_t elapsed = transition.elapsed - delay;
+	if (elapsed >= transition.duration) {
+		return TRANSITION_WEIGHT_ONE;
+	}
+	return ease(transition.easing, (static_cast<uint64_t>(elapsed) << 16) / transition.duration);
+}
+
+uint16_t ProgramManager::get_transition_serial(uint8_t slot) {
+	if (slot == 0 || slot > TRANSITION_SLOTS || !transitions_[slot - 1].active || transitions_[slot - 1].finished) {
+		return 0;
+	}
+	return transitions_[slot - 1].serial;
+}
+
+bool ProgramManager::can_join_transition(uint8_t slot, uint16_t serial) {
+	return serial != 0 && get_transition_serial(slot) == serial &&
+		millis() - transitions_[slot - 1].start <= TRANSITION_JOIN_MS_MAX;
+}
+
+uint8_t ProgramManager::get_transition_count() {
+	uint8_t count = 0;
+	for (const Transition& slot : transitions_) {
+		if (slot.active) {
+			count++;
+		}
+	}
+	return count;
+}
+
+const char* ProgramManager::get_easing_name(TransitionEasing easing) {
+	switch (easing) {
+		case EASING_LINEAR:  return "linear";
+		case EASING_IN:      return "in";
+		case EASING_OUT:     return "out";
+		case EASING_IN_OUT:  return "in_out";
+		default:             return "unknown";
+	}
+}
+
+bool ProgramManager::easing_from_name(const char* name, TransitionEasing& easing) {
+	if (!name) {
+		return false;
+	}
+	
+	for (uint8_t i = EASING_LINEAR; i <= EASING_IN_OUT; i++) {
+		if (strcmp(name, get_easing_name(static_cast<TransitionEasing>(i))) == 0) {
+			easing = static_cast<TransitionEasing>(i);
+			return true;
+		}
+	}
+	return false;
+}
+
+void ProgramManager::update_transitions(unsigned long current_millis) {
+	for (Transition& slot : transitions_) {
+		if (!slot.active || slot.finished) {
+			continue;
+		}
+		
+		// Time based: a late update jumps ahead instead of slowing the fade
+		uint32_t elapsed = current_millis - slot.start;
+		slot.elapsed = elapsed;
+		if (elapsed >= slot.duration) {
+			slot.weight = TRANSITION_WEIGHT_ONE;
+		} else {
+			slot.weight = ease(slot.easing, (static_cast<uint64_t>(elapsed) << 16) / slot.duration);
+		}
+		slot.finished = elapsed >= slot.span;
+	}
+}
+
+uint32_t ProgramManager::ease(TransitionEasing easing, uint32_t t) {
+	const uint64_t one = TRANSITION_WEIGHT_ONE;
+	uint64_t t2 = (static_cast<uint64_t>(t) * t) >> 16;
+	
+	switch (easing) {
+		case EASING_IN:
+			return t2;
+		case EASING_OUT:
+			return (static_cast<uint64_t>(t) * (2 * one - t)) >> 16;
+		case EASING_IN_OUT:
+			// 3t^2 - 2t^3
+			return (t2 * (3 * one - 2 * t)) >> 16;
+		default:
+			return t;
+	}
+}
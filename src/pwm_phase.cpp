@@ -0,0 +1,46 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Jérôme SONRIER
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * @file pwm_phase.cpp
+ * @brief Implementation of the PWM phase offsets
+ *
+ * See pwm_phase.h for API documentation.
+ *
+ * @author  Jérôme SONRIER <jsid@emor3j.fr.eu.org>
+ * @date    2025-10-17
+ */
+
+#include "pwm_phase.h"
+
+
+void PwmPhase::encode(uint16_t level, uint16_t offset, uint16_t& on, uint16_t& off) {
+	if (level == 0) {
+		// FULL OFF case
+		on = 0;
+		off = STEPS;
+	} else if (level >= LEVEL_MAX) {
+		// FULL ON case
+		on = STEPS;
+		off = 0;
+	} else {
+		// Normal PWM case, OFF before ON wraps around the period
+		on = offset;
+		off = (offset + level) & (STEPS - 1);
+	}
+}
+
+uint16_t PwmPhase::getOffset(uint16_t index, uint16_t channels) {
+	if (channels == 0) {
+		return 0;
+	}
+	return static_cast<uint32_t>(index) * STEPS / channels;
+}
+
+uint16_t PwmPhase::getExpectedPeak(uint16_t channels, uint16_t level) {
+	if (level >= LEVEL_MAX) {
+		return channels;
+	}
+	uint32_t overlap = (static_cast<uint32_t>(channels) * level + STEPS - 1) / STEPS;
+	return overlap + 1 < channels ? overlap + 1 : channels;
+}
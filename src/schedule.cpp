@@ -0,0 +1,361 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Jérôme SONRIER
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * @file schedule.cpp
+ * @brief Implementation of the model clock and schedules
+ *
+ * This file advances the model clock, expands the schedule events into
+ * the sorted firings of a model day and executes the due firings from the
+ * main loop.
+ *
+ * See schedule.h for API documentation.
+ *
+ * @author  Jérôme SONRIER <jsid@emor3j.fr.eu.org>
+ * @date    2025-10-17
+ */
+
+#include <algorithm>
+
+#include "schedule.h"
+#include "led.h"
+#include "log.h"
+
+
+/// Global instance
+std::unique_ptr<ScheduleManager> schedule_manager;
+
+
+// === Constructor ===
+
+ScheduleManager::ScheduleManager()
+	: anchor_time_(0)
+	, anchor_millis_(0)
+	, ratio_(RATIO_DEFAULT)
+	, running_(false)
+	, last_time_(0)
+	, events_()
+	, event_count_(0)
+	, firings_()
+	, firing_count_(0)
+	, next_(0)
+	, transitions_()
+	, pending_clock_()
+	, pending_events_()
+	, pending_count_(0)
+	, pending_(PendingType::NONE)
+	, stats_() {
+}
+
+// === Model Clock ===
+
+uint32_t ScheduleManager::getTime() const {
+	if (!running_) {
+		return anchor_time_;
+	}
+	return (anchor_time_ + static_cast<uint64_t>(millis() - anchor_millis_) * ratio_) % DAY_MS;
+}
+
+ScheduleManager::Clock ScheduleManager::getClock() const {
+	Clock clock;
+	clock.time_ms = getTime();
+	clock.ratio = ratio_;
+	clock.running = running_;
+	return clock;
+}
+
+bool ScheduleManager::setClock(const Clock& clock) {
+	if (clock.time_ms >= DAY_MS || clock.ratio == 0 || clock.ratio > RATIO_MAX) {
+		return false;
+	}
+
+	anchor_time_ = clock.time_ms;
+	anchor_millis_ = millis();
+	ratio_ = clock.ratio;
+	running_ = clock.running;
+
+	// The events between the old and the new time are skipped
+	last_time_ = clock.time_ms;
+	seek(last_time_);
+
+	char time[9];
+	formatTime(clock.time_ms, time, sizeof(time));
+	LOG_INFO("[SCHEDULEMGR] Model clock %s at %s, ratio %d\n", running_ ? "running" : "stopped", time, ratio_);
+	return true;
+}
+
+bool ScheduleManager::requestClock(const Clock& clock) {
+	if (pending_ != PendingType::NONE || clock.time_ms >= DAY_MS || clock.ratio == 0 || clock.ratio > RATIO_MAX) {
+		return false;
+	}
+
+	pending_clock_ = clock;
+	pending_ = PendingType::CLOCK;
+	return true;
+}
+
+// === Schedule ===
+
+bool ScheduleManager::isValidEvent(const Event& event) {
+	if (event.minute >= DAY_MS / 60000 || event.jitter > JITTER_MAX ||
+		event.action.transition_ms > ProgramManager::TRANSITION_MS_MAX || event.action.easing > EASING_IN_OUT) {
+		return false;
+	}
+
+	// Jitter spreads the LEDs of a group, a scene is recalled at once
+	if (event.scene) {
+		return event.scene_index < GroupManager::SCENE_MAX && event.jitter == 0;
+	}
+	return event.action.group < GroupManager::GROUP_MAX &&
+		(!event.action.set_brightness || event.action.brightness <= LED::MAX_BRIGHTNESS) &&
+		(!event.action.set_program || event.action.program <= PROGRAM_CUSTOM);
+}
+
+bool ScheduleManager::setEvents(const Event* events, uint8_t count) {
+	if (count > EVENT_MAX) {
+		return false;
+	}
+	for (uint8_t i = 0; i < count; i++) {
+		if (!isValidEvent(events[i])) {
+			return false;
+		}
+	}
+
+	memcpy(events_, events, count * sizeof(Event));
+	event_count_ = count;
+	memset(transitions_, 0, sizeof(transitions_));
+	buildFirings();
+	seek(last_time_);
+
+	LOG_INFO("[SCHEDULEMGR] %d events, %d firings per model day\n", event_count_, firing_count_);
+	return true;
+}
+
+bool ScheduleManager::requestEvents(const Event* events, uint8_t count) {
+	if (pending_ != PendingType::NONE || count > EVENT_MAX) {
+		return false;
+	}
+	for (uint8_t i = 0; i < count; i++) {
+		if (!isValidEvent(events[i])) {
+			return false;
+		}
+	}
+
+	memcpy(pending_events_, events, count * sizeof(Event));
+	pending_count_ = count;
+	pending_ = PendingType::EVENTS;
+	return true;
+}
+
+void ScheduleManager::refreshGroup(uint8_t group) {
+	bool used = false;
+	for (uint8_t e = 0; e < event_count_ && !used; e++) {
+		used = !events_[e].scene && events_[e].jitter > 0 && events_[e].action.group == group;
+	}
+	if (!used) {
+		return;
+	}
+
+	// Firings before the current model time are not executed again
+	buildFirings();
+	seek(last_time_);
+
+	LOG_INFO("[SCHEDULEMGR] Group %d changed, %d firings per model day\n", group, firing_count_);
+}
+
+bool ScheduleManager::getNextTime(uint32_t& time_ms) const {
+	uint16_t next = next_;
+	if (next >= firing_count_) {
+		return false;
+	}
+	time_ms = firings_[next].time;
+	return true;
+}
+
+void ScheduleManager::buildFirings() {
+	firing_count_ = 0;
+	stats_.dropped = 0;
+
+	for (uint8_t e = 0; e < event_count_; e++) {
+		const Event& event = events_[e];
+		uint32_t time = event.minute * 60000UL;
+		const GroupManager::Group* group = nullptr;
+		if (!event.scene && event.jitter > 0 && group_manager) {
+			group = group_manager->getGroup(event.action.group);
+		}
+
+		if (!group) {
+			if (firing_count_ < FIRING_MAX) {
+				firings_[firing_count_++] = {time, e, 0, WHOLE_EVENT};
+			} else {
+				stats_.dropped++;
+			}
+			continue;
+		}
+
+		// One firing per member, delays past midnight wrap to the start of the day
+		uint32_t spread = event.jitter * 60000UL;
+		for (uint8_t m = 0; m < PCA9685Module::MODULE_MAX; m++) {
+			for (uint16_t bits = group->masks[m]; bits; bits &= bits - 1) {
+				if (firing_count_ >= FIRING_MAX) {
+					stats_.dropped++;
+					continue;
+				}
+				Firing& firing = firings_[firing_count_++];
+				firing.time = (time + random(spread)) % DAY_MS;
+				firing.event = e;
+				firing.module = m;
+				firing.led = __builtin_ctz(bits);
+			}
+		}
+	}
+
+	// Events of the same time fire in their definition order
+	std::sort(firings_, firings_ + firing_count_, [](const Firing& a, const Firing& b) {
+		return a.time < b.time || (a.time == b.time && a.event < b.event);
+	});
+
+	stats_.firings = firing_count_;
+	next_ = 0;
+
+	if (stats_.dropped > 0) {
+		LOG_WARNING("[SCHEDULEMGR] Firing list full, %d jittered LEDs left out today\n", stats_.dropped);
+	}
+}
+
+void ScheduleManager::seek(uint32_t time_ms) {
+	const Firing* first = std::upper_bound(firings_, firings_ + firing_count_, time_ms, [](uint32_t time, const Firing& firing) {
+		return time < firing.time;
+	});
+	next_ = first - firings_;
+}
+
+// === Main Loop ===
+
+void ScheduleManager::handle() {
+	PendingType type = pending_;
+	if (type == PendingType::CLOCK) {
+		setClock(pending_clock_);
+		pending_ = PendingType::NONE;
+	} else if (type == PendingType::EVENTS) {
+		setEvents(pending_events_, pending_count_);
+		pending_ = PendingType::NONE;
+	}
+
+	if (!running_) {
+		return;
+	}
+
+	unsigned long now_millis = millis();
+	uint32_t now = (anchor_time_ + static_cast<uint64_t>(now_millis - anchor_millis_) * ratio_) % DAY_MS;
+	if (now == last_time_) {
+		return;
+	}
+
+	// Idle frames stop at the first comparison
+	bool midnight = now < last_time_;
+	if (!midnight && (next_ >= firing_count_ || firings_[next_].time > now)) {
+		last_time_ = now;
+		return;
+	}
+
+	unsigned long start = micros();
+	uint16_t fired = 0;
+	if (midnight) {
+		// Finish the day, then draw the firings of the new one
+		fired += fireUntil(DAY_MS);
+		anchor_time_ = now;
+		anchor_millis_ = now_millis;
+		buildFirings();
+	}
+	fired += fireUntil(now + 1);
+	last_time_ = now;
+
+	if (fired > 0) {
+		uint32_t elapsed = micros() - start;
+		stats_.last_us = elapsed;
+		if (elapsed > stats_.max_us) {
+			stats_.max_us = elapsed;
+		}
+	}
+}
+
+uint16_t ScheduleManager::fireUntil(uint32_t limit) {
+	uint16_t masks[PCA9685Module::MODULE_MAX];
+	bool batching = false;
+	uint8_t batch = 0;
+	uint16_t fired = 0;
+
+	while (next_ < firing_count_ && firings_[next_].time < limit) {
+		const Firing& firing = firings_[next_++];
+		fired++;
+
+		// LEDs of the same jittered event due together make one group change
+		if (batching && batch != firing.event) {
+			execute(batch, masks);
+			batching = false;
+		}
+		if (firing.led == WHOLE_EVENT) {
+			execute(firing.event, nullptr);
+			continue;
+		}
+		if (!batching) {
+			memset(masks, 0, sizeof(masks));
+			batch = firing.event;
+			batching = true;
+		}
+		masks[firing.module] |= static_cast<uint16_t>(1u << firing.led);
+	}
+
+	if (batching) {
+		execute(batch, masks);
+	}
+
+	stats_.fired += fired;
+	return fired;
+}
+
+void ScheduleManager::execute(uint8_t index, const uint16_t* masks) {
+	if (!group_manager || index >= event_count_) {
+		return;
+	}
+
+	const Event& event = events_[index];
+	uint16_t leds;
+	if (event.scene) {
+		leds = group_manager->recallNow(event.scene_index, event.action.transition_ms, static_cast<TransitionEasing>(event.action.easing));
+	} else {
+		// Jittered batches join the transition of the first one, one slot per event
+		EventTransition& transition = transitions_[index];
+		if (event.action.transition_ms && !ProgramManager::can_join_transition(transition.slot, transition.serial)) {
+			transition.slot = ProgramManager::begin_transition(event.action.transition_ms, static_cast<TransitionEasing>(event.action.easing));
+			transition.serial = ProgramManager::get_transition_serial(transition.slot);
+		}
+		leds = group_manager->applyNow(event.action, masks, event.action.transition_ms ? transition.slot : 0);
+	}
+
+	LOG_DEBUG("[SCHEDULEMGR] Event %d fired: %d LEDs\n", index, leds);
+}
+
+// === Time Formatting ===
+
+bool ScheduleManager::parseTime(const char* text, uint32_t& time_ms) {
+	unsigned int hours = 0;
+	unsigned int minutes = 0;
+	unsigned int seconds = 0;
+	if (!text || sscanf(text, "%u:%u:%u", &hours, &minutes, &seconds) < 2 ||
+		hours > 23 || minutes > 59 || seconds > 59) {
+		return false;
+	}
+
+	time_ms = ((hours * 60UL + minutes) * 60UL + seconds) * 1000UL;
+	return true;
+}
+
+void ScheduleManager::formatTime(uint32_t time_ms, char* buffer, size_t size) {
+	uint32_t seconds = (time_ms % DAY_MS) / 1000;
+	snprintf(buffer, size, "%02lu:%02lu:%02lu",
+		static_cast<unsigned long>(seconds / 3600),
+		static_cast<unsigned long>((seconds / 60) % 60),
+		static_cast<unsigned long>(seconds % 60));
+}
@@ -0,0 +1,451 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Jérôme SONRIER
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * @file show.cpp
+ * @brief Implementation of the show player
+ *
+ * This file reads the show files through two buffers refilled by a task on
+ * the other core, and applies the events due in each frame from the main
+ * loop.
+ *
+ * See show.h for API documentation.
+ *
+ * @author  Jérôme SONRIER <jsid@emor3j.fr.eu.org>
+ * @date    2025-10-17
+ */
+
+#include "show.h"
+#include "group.h"
+#include "led.h"
+#include "log.h"
+
+
+/// Global instance
+std::unique_ptr<ShowPlayer> show_player;
+
+const char* ShowPlayer::DIRECTORY = "/shows";
+const char* ShowPlayer::EXTENSION = ".show";
+
+
+/**
+ * @brief Read a little endian 16-bit value
+ */
+static uint16_t read_u16(const uint8_t* data) {
+	return static_cast<uint16_t>(data[0] | (data[1] << 8));
+}
+
+/**
+ * @brief Read a little endian 32-bit value
+ */
+static uint32_t read_u32(const uint8_t* data) {
+	return static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8) |
+		(static_cast<uint32_t>(data[2]) << 16) | (static_cast<uint32_t>(data[3]) << 24);
+}
+
+
+// === Constructor ===
+
+ShowPlayer::ShowPlayer()
+	: fill_{0, 0}
+	, ready_{false, false}
+	, eof_(false)
+	, front_(0)
+	, position_(0)
+	, next_fill_(0)
+	, task_(nullptr)
+	, stop_requested_(false)
+	, playing_(false)
+	, loop_(false)
+	, name_()
+	, event_count_(0)
+	, duration_ms_(0)
+	, start_millis_(0)
+	, start_ms_(0)
+	, pass_start_ms_(0)
+	, consumed_(0)
+	, played_(0)
+	, passes_(0)
+	, pending_name_()
+	, pending_loop_(false)
+	, pending_start_ms_(0)
+	, pending_(PendingType::NONE)
+	, stats_() {
+}
+
+ShowPlayer::~ShowPlayer() {
+	stop();
+}
+
+// === Playback ===
+
+bool ShowPlayer::play(const char* name, bool loop, uint32_t start_ms) {
+	if (!isValidName(name)) {
+		return false;
+	}
+	stop();
+
+	char path[48];
+	makePath(name, path, sizeof(path));
+	file_ = LittleFS.open(path, "r");
+	if (!file_) {
+		LOG_ERROR("[SHOWPLAYER] Failed to open %s\n", path);
+		return false;
+	}
+
+	uint8_t header[HEADER_SIZE];
+	if (file_.read(header, HEADER_SIZE) != HEADER_SIZE || !parseHeader(header, event_count_, duration_ms_) ||
+		event_count_ == 0 || start_ms > duration_ms_) {
+		LOG_ERROR("[SHOWPLAYER] %s is not a valid show, or starts after its end\n", path);
+		file_.close();
+		return false;
+	}
+
+	if (!buffers_) {
+		buffers_.reset(new uint8_t[2 * BUFFER_SIZE]);
+	}
+	// A pass without duration would replay forever in one frame
+	loop_ = loop && duration_ms_ > 0;
+	stats_ = Stats();
+	eof_ = false;
+	ready_[0] = false;
+	ready_[1] = false;
+	fillBuffer(0);
+	fillBuffer(1);
+	front_ = 0;
+	position_ = 0;
+	next_fill_ = 0;
+
+	// Low priority, on the core not running loop()
+	stop_requested_ = false;
+	if (xTaskCreatePinnedToCore(taskEntry, "show_reader", 3072, this, 1, &task_, 0) != pdPASS) {
+		task_ = nullptr;
+		file_.close();
+		LOG_ERROR("[SHOWPLAYER] Failed to create reader task\n");
+		return false;
+	}
+
+	snprintf(name_, sizeof(name_), "%s", name);
+	start_ms_ = start_ms;
+	start_millis_ = millis() - start_ms;
+	pass_start_ms_ = 0;
+	consumed_ = 0;
+	played_ = 0;
+	passes_ = 0;
+	playing_ = true;
+
+	LOG_INFO("[SHOWPLAYER] Playing %s from %lu ms: %lu events over %lu ms%s\n", name_,
+		static_cast<unsigned long>(start_ms), static_cast<unsigned long>(event_count_),
+		static_cast<unsigned long>(duration_ms_), loop_ ? ", looping" : "");
+	return true;
+}
+
+void ShowPlayer::stop() {
+	stopReader();
+
+	if (playing_) {
+		playing_ = false;
+		LOG_INFO("[SHOWPLAYER] Stopped %s after %lu events\n", name_, static_cast<unsigned long>(played_));
+	}
+}
+
+void ShowPlayer::stopReader() {
+	if (!task_) {
+		if (file_) {
+			file_.close();
+		}
+		return;
+	}
+
+	// The task closes the file and clears task_
+	stop_requested_ = true;
+	xTaskNotifyGive(task_);
+	while (task_) {
+		vTaskDelay(pdMS_TO_TICKS(1));
+	}
+}
+
+// === Requests ===
+
+bool ShowPlayer::requestPlay(const char* name, bool loop, uint32_t start_ms) {
+	if (pending_ != PendingType::NONE || !isValidName(name)) {
+		return false;
+	}
+
+	snprintf(pending_name_, sizeof(pending_name_), "%s", name);
+	pending_loop_ = loop;
+	pending_start_ms_ = start_ms;
+	pending_ = PendingType::PLAY;
+	return true;
+}
+
+bool ShowPlayer::requestStop() {
+	if (pending_ != PendingType::NONE) {
+		return false;
+	}
+
+	pending_ = PendingType::STOP;
+	return true;
+}
+
+// === Main Loop ===
+
+void ShowPlayer::handle() {
+	PendingType type = pending_;
+	if (type == PendingType::PLAY) {
+		play(pending_name_, pending_loop_, pending_start_ms_);
+		pending_ = PendingType::NONE;
+	} else if (type == PendingType::STOP) {
+		stop();
+		pending_ = PendingType::NONE;
+	}
+
+	if (!playing_) {
+		return;
+	}
+
+	uint32_t now = millis() - start_millis_;
+	uint8_t record[RECORD_SIZE + PCA9685Module::MODULE_MAX * CHANNEL_SIZE];
+	while (true) {
+		if (consumed_ >= event_count_) {
+			if (!loop_) {
+				LOG_INFO("[SHOWPLAYER] %s finished\n", name_);
+				stop();
+				return;
+			}
+			pass_start_ms_ += duration_ms_;
+			consumed_ = 0;
+			passes_++;
+		}
+
+		// Idle frames stop at the time of the next event
+		ReadResult result = peek(record, RECORD_SIZE);
+		uint32_t time = 0;
+		size_t size = RECORD_SIZE;
+		if (result == ReadResult::READY) {
+			time = pass_start_ms_ + read_u32(record);
+			if (time > now) {
+				return;
+			}
+			if (record[10] > PCA9685Module::MODULE_MAX) {
+				LOG_ERROR("[SHOWPLAYER] %s: invalid event %lu, stopping\n", name_, static_cast<unsigned long>(consumed_));
+				stats_.errors++;
+				stop();
+				return;
+			}
+			size += record[10] * CHANNEL_SIZE;
+			result = peek(record, size);
+		}
+		if (result == ReadResult::WAIT) {
+			stats_.underruns++;
+			return;
+		}
+		if (result == ReadResult::END) {
+			LOG_ERROR("[SHOWPLAYER] %s ends after %lu of %lu events\n", name_,
+				static_cast<unsigned long>(consumed_), static_cast<unsigned long>(event_count_));
+			stats_.errors++;
+			stop();
+			return;
+		}
+
+		consume(size);
+		consumed_++;
+		played_++;
+
+		// Events before the start position only restore the layout state
+		bool catching_up = time < start_ms_;
+		if (!catching_up) {
+			uint32_t late = now - time;
+			if (late > LATE_MS) {
+				stats_.late_events++;
+			}
+			if (late > stats_.max_late_ms) {
+				stats_.max_late_ms = late;
+			}
+		}
+		execute(record, !catching_up);
+	}
+}
+
+ShowPlayer::ReadResult ShowPlayer::peek(uint8_t* out, size_t length) {
+	const uint8_t* front = buffers_.get() + front_ * BUFFER_SIZE + position_;
+	size_t front_left = fill_[front_] - position_;
+	if (length <= front_left) {
+		memcpy(out, front, length);
+		return ReadResult::READY;
+	}
+
+	// The end of the file is only flagged after the last buffer is ready
+	uint8_t back = front_ ^ 1;
+	bool eof = eof_;
+	if (!ready_[back]) {
+		return eof ? ReadResult::END : ReadResult::WAIT;
+	}
+	if (length - front_left > fill_[back]) {
+		return ReadResult::END;
+	}
+
+	memcpy(out, front, front_left);
+	memcpy(out + front_left, buffers_.get() + back * BUFFER_SIZE, length - front_left);
+	return ReadResult::READY;
+}
+
+void ShowPlayer::consume(size_t length) {
+	position_ += length;
+
+	uint8_t back = front_ ^ 1;
+	if (position_ < fill_[front_] || !ready_[back]) {
+		return;
+	}
+
+	// Hand the emptied buffer back to the task
+	position_ -= fill_[front_];
+	ready_[front_] = false;
+	front_ = back;
+	xTaskNotifyGive(task_);
+}
+
+void ShowPlayer::execute(const uint8_t* record, bool transition) {
+	uint16_t transition_ms = read_u16(record + 4);
+	uint16_t value = read_u16(record + 6);
+	uint8_t easing = record[9];
+	uint8_t count = record[10];
+
+	GroupManager::Action action = {};
+	action.set_enabled = true;
+	action.enabled = true;
+	switch (static_cast<ShowAction>(record[8])) {
+		case SHOW_SET:
+			action.set_program = true;
+			action.program = PROGRAM_NONE;
+			action.set_brightness = true;
+			action.brightness = value;
+			break;
+		case SHOW_PROGRAM:
+			action.set_program = true;
+			action.program = static_cast<uint8_t>(value);
+			break;
+		case SHOW_OFF:
+			action.enabled = false;
+			break;
+		default:
+			stats_.errors++;
+			return;
+	}
+
+	if ((action.set_brightness && value > LED::MAX_BRIGHTNESS) ||
+		(action.set_program && value > PROGRAM_CUSTOM) || easing > EASING_IN_OUT || !group_manager) {
+		stats_.errors++;
+		return;
+	}
+	action.transition_ms = transition ? transition_ms : 0;
+	action.easing = easing;
+
+	uint16_t masks[PCA9685Module::MODULE_MAX] = {};
+	for (uint8_t i = 0; i < count; i++) {
+		const uint8_t* channel = record + RECORD_SIZE + i * CHANNEL_SIZE;
+		if (channel[0] < PCA9685Module::MODULE_MAX) {
+			masks[channel[0]] |= read_u16(channel + 1);
+		}
+	}
+	group_manager->applyMasksNow(action, masks);
+}
+
+// === Reader Task ===
+
+void ShowPlayer::fillBuffer(uint8_t index) {
+	uint8_t* dest = buffers_.get() + index * BUFFER_SIZE;
+	size_t fill = 0;
+	bool wrapped = false;
+	bool eof = false;
+	while (fill < BUFFER_SIZE) {
+		size_t read = file_.read(dest + fill, BUFFER_SIZE - fill);
+		if (read > 0) {
+			fill += read;
+			wrapped = false;
+			continue;
+		}
+		// A looping show goes on with its first event
+		if (!loop_ || wrapped || !file_.seek(HEADER_SIZE)) {
+			eof = true;
+			break;
+		}
+		wrapped = true;
+	}
+
+	fill_[index] = fill;
+	ready_[index] = fill > 0;
+	eof_ = eof;
+	stats_.refills++;
+}
+
+void ShowPlayer::taskEntry(void* param) {
+	static_cast<ShowPlayer*>(param)->taskLoop();
+}
+
+void ShowPlayer::taskLoop() {
+	while (!stop_requested_) {
+		ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+		// The main loop empties the buffers in the order they were filled
+		while (!stop_requested_ && !eof_ && !ready_[next_fill_]) {
+			fillBuffer(next_fill_);
+			next_fill_ ^= 1;
+		}
+	}
+
+	file_.close();
+	task_ = nullptr;
+	vTaskDelete(NULL);
+}
+
+// === Status ===
+
+ShowPlayer::Status ShowPlayer::getStatus() const {
+	Status status = {};
+	status.playing = playing_;
+	status.loop = loop_;
+	snprintf(status.name, sizeof(status.name), "%s", name_);
+	status.duration_ms = duration_ms_;
+	status.event_count = event_count_;
+	status.events_played = played_;
+	status.passes = passes_;
+	if (playing_) {
+		uint32_t elapsed = millis() - start_millis_;
+		status.position_ms = elapsed > pass_start_ms_ ? elapsed - pass_start_ms_ : 0;
+	}
+	return status;
+}
+
+// === Files ===
+
+bool ShowPlayer::isValidName(const char* name) {
+	if (!name) {
+		return false;
+	}
+
+	size_t length = strlen(name);
+	if (length == 0 || length > NAME_MAX) {
+		return false;
+	}
+	for (size_t i = 0; i < length; i++) {
+		if (!isalnum(static_cast<unsigned char>(name[i])) && name[i] != '-' && name[i] != '_') {
+			return false;
+		}
+	}
+	return true;
+}
+
+void ShowPlayer::makePath(const char* name, char* buffer, size_t size) {
+	snprintf(buffer, size, "%s/%s%s", DIRECTORY, name, EXTENSION);
+}
+
+bool ShowPlayer::parseHeader(const uint8_t* header, uint32_t& event_count, uint32_t& duration_ms) {
+	if (memcmp(header, "EMSH", 4) != 0 || header[4] != VERSION) {
+		return false;
+	}
+
+	event_count = read_u32(header + 8);
+	duration_ms = read_u32(header + 12);
+	return true;
+}
@@ -17,6 +17,10 @@
 #include "config.h"
 #include "pca9685.h"
 #include "program.h"
+#include "group.h"
+#include "schedule.h"
+#include "input.h"
+#include "layer.h"
 #include "log.h"
 
 
@@ -37,6 +41,16 @@ const char* StorageManager::NAMESPACE_CONFIG = "config";
 const char* StorageManager::NAMESPACE_MODULES = "modules";
 /// Namespace for individual LED configurations and states
 const char* StorageManager::NAMESPACE_LEDS = "leds";
+/// Namespace for user effect programs
+const char* StorageManager::NAMESPACE_EFFECTS = "effects";
+/// Namespace for LED groups and scenes
+const char* StorageManager::NAMESPACE_GROUPS = "groups";
+/// Namespace for the model clock and schedules
+const char* StorageManager::NAMESPACE_SCHEDULE = "schedule";
+/// Namespace for the layout inputs and triggers
+const char* StorageManager::NAMESPACE_INPUTS = "inputs";
+/// Namespace for the layer stacks and master levels
+const char* StorageManager::NAMESPACE_LAYERS = "layers";
 
 /// @}
 
@@ -65,13 +79,18 @@ bool StorageManager::initialize() {
  * - config: Global system settings
  * - modules: PCA9685 module configurations  
  * - leds: LED settings and states
+ * - effects: User effect programs
+ * - groups: LED groups and scenes
+ * - schedule: Model clock and schedule events
+ * - inputs: Layout inputs and triggers
+ * - layers: Layer stacks and master levels
  * @endinternal
  */
 void StorageManager::clear_configuration() {
 	LOG_INFO("[STORAGEMGR] Clearing all configuration...\n");
 	
 	// Clear all namespaces
-	const char* namespaces[] = {NAMESPACE_CONFIG, NAMESPACE_MODULES, NAMESPACE_LEDS};
+	const char* namespaces[] = {NAMESPACE_CONFIG, NAMESPACE_MODULES, NAMESPACE_LEDS, NAMESPACE_EFFECTS, NAMESPACE_GROUPS, NAMESPACE_SCHEDULE, NAMESPACE_INPUTS, NAMESPACE_LAYERS};
 	
 	for (const char* ns : namespaces) {
 		if (preferences.begin(ns, false)) {
@@ -92,6 +111,7 @@ void StorageManager::clear_configuration() {
  * Saved module properties:
  * - I2C address (for reference, though detected at runtime)
  * - User-assigned module name
+ * - PWM frequency, oscillator calibration and camera mode
  * - Detection status (for diagnostics)
  * - Initialization status (for diagnostics)
  * @endinternal
@@ -118,6 +138,12 @@ bool StorageManager::save_module_config(uint8_t module_index) {
 	doc["name"] = module->getName();
 	doc["detected"] = module->isDetected();
 	doc["initialized"] = module->isInitialized();
+	doc["broadcast_groups"] = module->getBroadcastGroups();
+	doc["pwm_frequency"] = module->getPwmFrequency();
+	doc["oscillator_hz"] = module->getOscillatorFrequency();
+	doc["camera_mode"] = module->isCameraMode();
+	doc["curve"] = module->getCurve();
+	doc["rated_ma"] = module->getRatedCurrent();
 	
 	// Serialize to string
 	String json_string;
@@ -141,6 +167,8 @@ bool StorageManager::save_module_config(uint8_t module_index) {
  * 
  * Loaded module properties:
  * - User-assigned module name (applied if present)
+ * - PWM frequency, oscillator calibration and camera mode (written to
+ *   the chip by the module manager main loop)
  * - Other user preferences (if any)
  * 
  * Properties NOT loaded (determined at runtime):
@@ -186,12 +214,102 @@ bool StorageManager::load_module_config(uint8_t module_index) {
 	if (doc["name"].is<String>()) {
 		module->setName(doc["name"].as<String>());
 	}
+	if (doc["broadcast_groups"].is<uint8_t>()) {
+		module->setBroadcastGroups(doc["broadcast_groups"].as<uint8_t>());
+	}
+	if (doc["pwm_frequency"].is<uint16_t>()) {
+		module->setPwmFrequency(doc["pwm_frequency"].as<uint16_t>());
+	}
+	if (doc["oscillator_hz"].is<uint32_t>()) {
+		module->setOscillatorFrequency(doc["oscillator_hz"].as<uint32_t>());
+	}
+	if (doc["camera_mode"].is<bool>()) {
+		module->setCameraMode(doc["camera_mode"].as<bool>());
+	}
+	if (doc["curve"].is<uint8_t>() && doc["curve"].as<uint8_t>() < BrightnessCurve::CURVE_TYPE_COUNT) {
+		module->setCurve(static_cast<CurveType>(doc["curve"].as<uint8_t>()));
+	}
+	if (doc["rated_ma"].is<uint16_t>()) {
+		module->setRatedCurrent(doc["rated_ma"].as<uint16_t>());
+	}
+	
+	// Modules whose prescale changed are restarted from the main loop
+	module_manager->requestPwmUpdate();
 	
 	LOG_INFO("[STORAGEMGR] Module %d configuration loaded\n", module_index);
 	
 	return true;
 }
 
+bool StorageManager::save_module_map() {
+	if (!module_manager) {
+		return false;
+	}
+	
+	std::vector<uint8_t> entries;
+	for (uint8_t i = 0; i < module_manager->getModuleCount(); i++) {
+		// Free ID: address 0 is reserved by I2C, never a module
+		const PCA9685Module* module = module_manager->getModule(i);
+		entries.push_back(module ? (module->getBus() << 7) | (module->getAddress() & 0x7F) : 0);
+	}
+	
+	if (!preferences.begin(NAMESPACE_MODULES, false)) {
+		return false;
+	}
+	
+	bool success = preferences.putBytes("module_map", entries.data(), entries.size()) == entries.size();
+	preferences.end();
+	
+	if (success) {
+		LOG_INFO("[STORAGEMGR] Module map saved (%d modules)\n", entries.size());
+	} else {
+		LOG_ERROR("[STORAGEMGR] Saving module map failed\n");
+	}
+	
+	return success;
+}
+
+bool StorageManager::load_module_map(std::vector<uint8_t>& entries) {
+	entries.clear();
+	
+	if (!preferences.begin(NAMESPACE_MODULES, true)) {
+		return false;
+	}
+	
+	size_t length = preferences.getBytesLength("module_map");
+	if (length > 0) {
+		entries.resize(length);
+		if (preferences.getBytes("module_map", entries.data(), length) != length) {
+			entries.clear();
+		}
+	}
+	preferences.end();
+	
+	return !entries.empty();
+}
+
+void StorageManager::clear_module_config(uint8_t module_index) {
+	if (preferences.begin(NAMESPACE_MODULES, false)) {
+		String key = get_module_key(module_index);
+		if (preferences.isKey(key.c_str())) {
+			preferences.remove(key.c_str());
+		}
+		preferences.end();
+	}
+	
+	if (preferences.begin(NAMESPACE_LEDS, false)) {
+		for (uint8_t led_index = 0; led_index < config.getPca9685LedMax(); led_index++) {
+			String key = get_led_key(module_index, led_index);
+			if (preferences.isKey(key.c_str())) {
+				preferences.remove(key.c_str());
+			}
+		}
+		preferences.end();
+	}
+	
+	LOG_INFO("[STORAGEMGR] Module %d configuration cleared\n", module_index);
+}
+
 /**
  * @internal
  * Serializes and saves all configuration data for a specific LED using
@@ -202,7 +320,7 @@ bool StorageManager::load_module_config(uint8_t module_index) {
  * - User-assigned name
  * - Enable/disable state
  * - Current brightness value (0-4095)
- * - Current program type assignment
+ * - Current program type assignment, effect slot and parameters
  * @endinternal
  */
 bool StorageManager::save_led_config(uint8_t module_index, uint8_t led_index) {
@@ -229,6 +347,22 @@ bool StorageManager::save_led_config(uint8_t module_index, uint8_t led_index) {
 	doc["enabled"] = led->isEnabled();
 	doc["brightness"] = led->getBrightness();
 	doc["program_type"] = led->getProgramType();
+	doc["curve"] = led->getCurve();
+	doc["dither"] = led->isDitherEnabled();
+	doc["rated_ma"] = led->getRatedCurrent();
+	doc["priority"] = led->getPriority();
+	if (led->getProgramType() == PROGRAM_CUSTOM && led->getProgramState()) {
+		doc["effect_slot"] = led->getProgramState()->effect_slot;
+	}
+	if (led->getProgramState() && !ProgramManager::is_default_params(*led->getProgramState()->params)) {
+		ProgramManager::params_to_json(*led->getProgramState()->params, doc["params"].to<JsonObject>());
+	}
+	uint16_t phase_offset;
+	uint8_t phase_group = ProgramManager::get_phase_group(module_index, led_index, phase_offset);
+	if (phase_group > 0) {
+		doc["phase_group"] = phase_group;
+		doc["phase_offset"] = phase_offset;
+	}
 	
 	// Serialize to string
 	String json_string;
@@ -261,7 +395,7 @@ bool StorageManager::save_led_config(uint8_t module_index, uint8_t led_index) {
  * - User-assigned name (if saved)
  * - Enable/disable state (if saved)
  * - Brightness value (if saved, applied to hardware)
- * - Program type assignment (if saved)
+ * - Program type assignment, effect slot and parameters (if saved)
  * @endinternal
  */
 bool StorageManager::load_led_config(uint8_t module_index, uint8_t led_index) {
@@ -317,9 +451,33 @@ bool StorageManager::load_led_config(uint8_t module_index, uint8_t led_index) {
 	if (doc["brightness"].is<uint16_t>()) {
 		led->setBrightness(doc["brightness"]);
 	}
+	if (doc["curve"].is<uint8_t>() && doc["curve"].as<uint8_t>() < BrightnessCurve::CURVE_TYPE_COUNT) {
+		led->setCurve(static_cast<CurveType>(doc["curve"].as<uint8_t>()));
+	}
+	if (doc["dither"].is<bool>()) {
+		led->setDither(doc["dither"].as<bool>());
+	}
+	if (doc["rated_ma"].is<uint16_t>()) {
+		led->setRatedCurrent(doc["rated_ma"].as<uint16_t>());
+	}
+	if (doc["priority"].is<uint8_t>()) {
+		led->setPriority(doc["priority"].as<uint8_t>());
+	}
 	if (doc["program_type"].is<int>()) {
 		led->setProgram(doc["program_type"], nullptr);
 		program_manager->assign_program(module_index, led_index, doc["program_type"]);
+		if (doc["effect_slot"].is<uint8_t>() && static_cast<ProgramType>(doc["program_type"].as<int>()) == PROGRAM_CUSTOM) {
+			program_manager->assign_effect(module_index, led_index, doc["effect_slot"].as<uint8_t>());
+		}
+		ProgramParams params = ProgramParams::DEFAULTS;
+		if (doc["params"].is<JsonObject>() && (!ProgramManager::params_from_json(doc["params"], params) ||
+			!program_manager->set_program_params(module_index, led_index, params))) {
+			LOG_ERROR("[STORAGEMGR] Ignoring invalid program parameters for LED %d_%d\n", module_index, led_index);
+		}
+		if (doc["phase_group"].is<uint8_t>() &&
+			!program_manager->set_phase_group(module_index, led_index, doc["phase_group"], doc["phase_offset"] | 0)) {
+			LOG_ERROR("[STORAGEMGR] Ignoring invalid phase group for LED %d_%d\n", module_index, led_index);
+		}
 	}
 	
 	// Apply the loaded brightness
@@ -438,6 +596,9 @@ bool StorageManager::load_configuration() {
 	
 	LOG_INFO("[STORAGEMGR] Loaded configuration for %d modules\n", loaded_modules);
 	
+	// Broadcast group membership may have changed, chips are updated from the main loop
+	module_manager->requestBroadcast(ModuleManager::BroadcastAction::APPLY_GROUPS);
+	
 	return loaded_modules > 0;
 }
 
@@ -524,4 +685,508 @@ bool StorageManager::clear_wifi_credentials() {
 	
 	LOG_INFO("[STORAGEMGR] WiFi credentials cleared\n");
 	return true;
-}
\ No newline at end of file
+}
+
+// === I2C Configuration Management ===
+
+bool StorageManager::save_i2c_config() {
+	if (!preferences.begin(NAMESPACE_CONFIG, false)) {
+		LOG_ERROR("[STORAGEMGR] Failed to open config namespace\n");
+		return false;
+	}
+	
+	bool success = preferences.putULong("i2c_clock", config.getI2cClockHz()) > 0;
+	success = preferences.putUChar("i2c1_sda", config.getI2c1SdaPin()) > 0 && success;
+	success = preferences.putUChar("i2c1_scl", config.getI2c1SclPin()) > 0 && success;
+	for (uint8_t group = 1; group <= Config::BROADCAST_GROUP_COUNT; group++) {
+		String key = "bcast_grp" + String(group);
+		success = preferences.putUChar(key.c_str(), config.getBroadcastGroupAddress(group)) > 0 && success;
+	}
+	success = preferences.putBool("phase_stagger", config.isPhaseStaggerEnabled()) > 0 && success;
+	success = preferences.putBool("i2c_linked", config.isLinkedFramesEnabled()) > 0 && success;
+	success = preferences.putBool("i2c_hotplug", config.isHotplugScanEnabled()) > 0 && success;
+	preferences.end();
+	
+	if (success) {
+		LOG_INFO("[STORAGEMGR] I2C configuration saved\n");
+	} else {
+		LOG_ERROR("[STORAGEMGR] Failed to save I2C configuration\n");
+	}
+	
+	return success;
+}
+
+bool StorageManager::load_i2c_config() {
+	if (!preferences.begin(NAMESPACE_CONFIG, true)) {
+		return false;
+	}
+	
+	uint32_t clock_hz = preferences.getULong("i2c_clock", 0);
+	uint8_t i2c1_sda = preferences.getUChar("i2c1_sda", Config::I2C_PIN_NONE);
+	uint8_t i2c1_scl = preferences.getUChar("i2c1_scl", Config::I2C_PIN_NONE);
+	uint8_t group_addr[Config::BROADCAST_GROUP_COUNT];
+	for (uint8_t group = 1; group <= Config::BROADCAST_GROUP_COUNT; group++) {
+		String key = "bcast_grp" + String(group);
+		group_addr[group - 1] = preferences.getUChar(key.c_str(), config.getBroadcastGroupAddress(group));
+	}
+	config.setPhaseStagger(preferences.getBool("phase_stagger", config.isPhaseStaggerEnabled()));
+	config.setLinkedFrames(preferences.getBool("i2c_linked", config.isLinkedFramesEnabled()));
+	config.setHotplugScan(preferences.getBool("i2c_hotplug", config.isHotplugScanEnabled()));
+	preferences.end();
+	
+	if (clock_hz == 0) {
+		return false;
+	}
+	
+	bool success = true;
+	if (!config.setI2cClockHz(clock_hz)) {
+		LOG_ERROR("[STORAGEMGR] Ignoring invalid saved I2C clock: %lu Hz\n", (unsigned long)clock_hz);
+		success = false;
+	}
+	if (!config.setI2c1Pins(i2c1_sda, i2c1_scl)) {
+		LOG_ERROR("[STORAGEMGR] Ignoring invalid saved I2C bus 1 pins: %d/%d\n", i2c1_sda, i2c1_scl);
+		success = false;
+	}
+	for (uint8_t group = 1; group <= Config::BROADCAST_GROUP_COUNT; group++) {
+		if (!config.setBroadcastGroupAddress(group, group_addr[group - 1])) {
+			LOG_ERROR("[STORAGEMGR] Ignoring invalid saved broadcast group %d address: 0x%02X\n", group, group_addr[group - 1]);
+			success = false;
+		}
+	}
+	
+	LOG_INFO("[STORAGEMGR] I2C configuration loaded: max clock %lu Hz, bus 1 %s\n",
+		(unsigned long)config.getI2cClockHz(), config.isI2c1Enabled() ? "enabled" : "disabled");
+	return success;
+}
+
+// === Curve Configuration Management ===
+
+bool StorageManager::save_curve_config() {
+	if (!preferences.begin(NAMESPACE_CONFIG, false)) {
+		LOG_ERROR("[STORAGEMGR] Failed to open config namespace\n");
+		return false;
+	}
+	
+	const size_t points_size = BrightnessCurve::CUSTOM_POINTS * sizeof(uint16_t);
+	bool success = preferences.putUChar("curve", config.getDefaultCurve()) > 0;
+	success = preferences.putBytes("curve_custom", BrightnessCurve::getCustomPoints(), points_size) == points_size && success;
+	preferences.end();
+	
+	if (!success) {
+		LOG_ERROR("[STORAGEMGR] Failed to save curve settings\n");
+	}
+	
+	return success;
+}
+
+bool StorageManager::load_curve_config() {
+	if (!preferences.begin(NAMESPACE_CONFIG, true)) {
+		return false;
+	}
+	
+	bool found = preferences.isKey("curve");
+	config.setDefaultCurve(static_cast<CurveType>(preferences.getUChar("curve", config.getDefaultCurve())));
+	
+	uint16_t points[BrightnessCurve::CUSTOM_POINTS];
+	if (preferences.getBytesLength("curve_custom") == sizeof(points) &&
+		preferences.getBytes("curve_custom", points, sizeof(points)) == sizeof(points) &&
+		!BrightnessCurve::setCustomPoints(points)) {
+		LOG_ERROR("[STORAGEMGR] Custom curve not restored\n");
+	}
+	preferences.end();
+	
+	return found;
+}
+
+// === Power Configuration Management ===
+
+bool StorageManager::save_power_config() {
+	if (!preferences.begin(NAMESPACE_CONFIG, false)) {
+		LOG_ERROR("[STORAGEMGR] Failed to open config namespace\n");
+		return false;
+	}
+	
+	bool success = preferences.putULong("power_budget", config.getPowerBudget()) > 0;
+	success = preferences.putUChar("power_mode", config.getPowerMode()) > 0 && success;
+	preferences.end();
+	
+	if (!success) {
+		LOG_ERROR("[STORAGEMGR] Failed to save power settings\n");
+	}
+	
+	return success;
+}
+
+bool StorageManager::load_power_config() {
+	if (!preferences.begin(NAMESPACE_CONFIG, true)) {
+		return false;
+	}
+	
+	bool found = preferences.isKey("power_budget");
+	uint32_t budget_ma = preferences.getULong("power_budget", config.getPowerBudget());
+	uint8_t mode = preferences.getUChar("power_mode", config.getPowerMode());
+	preferences.end();
+	
+	if (!config.setPowerBudget(budget_ma)) {
+		LOG_ERROR("[STORAGEMGR] Ignoring invalid saved power budget: %lu mA\n", (unsigned long)budget_ma);
+		found = false;
+	}
+	config.setPowerMode(static_cast<PowerMode>(mode) == POWER_PRIORITY ? POWER_PRIORITY : POWER_FAIR);
+	
+	return found;
+}
+
+// === Effect Management ===
+
+/**
+ * @internal
+ * Each slot is a blob under "fx_{slot}": the budget, the name padded to
+ * NAME_MAX + 1 bytes, then the bytecode.
+ * @endinternal
+ */
+bool StorageManager::save_effect(uint8_t slot, const EffectVM::Program& effect) {
+	if (slot >= ProgramManager::EFFECT_SLOTS) {
+		return false;
+	}
+	
+	if (!preferences.begin(NAMESPACE_EFFECTS, false)) {
+		LOG_ERROR("[STORAGEMGR] Failed to open effects namespace\n");
+		return false;
+	}
+	
+	String key = "fx_" + String(slot);
+	bool success;
+	if (effect.length == 0) {
+		success = !preferences.isKey(key.c_str()) || preferences.remove(key.c_str());
+	} else {
+		uint8_t blob[1 + EffectVM::NAME_MAX + 1 + EffectVM::INSTRUCTIONS_MAX * EffectVM::INSTRUCTION_SIZE];
+		blob[0] = effect.budget;
+		memcpy(blob + 1, effect.name, EffectVM::NAME_MAX + 1);
+		size_t size = 1 + EffectVM::NAME_MAX + 1 + EffectVM::encode(effect, blob + 1 + EffectVM::NAME_MAX + 1);
+		success = preferences.putBytes(key.c_str(), blob, size) == size;
+	}
+	preferences.end();
+	
+	if (success) {
+		LOG_INFO("[STORAGEMGR] Effect slot %d saved\n", slot);
+	} else {
+		LOG_ERROR("[STORAGEMGR] Saving effect slot %d failed\n", slot);
+	}
+	
+	return success;
+}
+
+uint8_t StorageManager::load_effects() {
+	if (!preferences.begin(NAMESPACE_EFFECTS, true)) {
+		return 0;
+	}
+	
+	uint8_t loaded = 0;
+	const size_t header_size = 1 + EffectVM::NAME_MAX + 1;
+	uint8_t blob[header_size + EffectVM::INSTRUCTIONS_MAX * EffectVM::INSTRUCTION_SIZE];
+	std::unique_ptr<EffectVM::Program> effect(new EffectVM::Program());
+	
+	for (uint8_t slot = 0; slot < ProgramManager::EFFECT_SLOTS; slot++) {
+		String key = "fx_" + String(slot);
+		size_t size = preferences.getBytesLength(key.c_str());
+		if (size <= header_size || size > sizeof(blob) || preferences.getBytes(key.c_str(), blob, size) != size) {
+			continue;
+		}
+		
+		char error[EffectVM::ERROR_MAX];
+		*effect = EffectVM::Program();
+		if (!EffectVM::compile(blob + header_size, size - header_size, blob[0], *effect, error, sizeof(error))) {
+			LOG_ERROR("[STORAGEMGR] Ignoring saved effect slot %d: %s\n", slot, error);
+			continue;
+		}
+		memcpy(effect->name, blob + 1, EffectVM::NAME_MAX);
+		effect->name[EffectVM::NAME_MAX] = '\0';
+		
+		program_manager->set_effect(slot, *effect);
+		loaded++;
+	}
+	preferences.end();
+	
+	return loaded;
+}
+
+// === Group and Scene Management ===
+
+bool StorageManager::save_group(uint8_t index) {
+	if (!group_manager || index >= GroupManager::GROUP_MAX) {
+		return false;
+	}
+	
+	if (!preferences.begin(NAMESPACE_GROUPS, false)) {
+		LOG_ERROR("[STORAGEMGR] Failed to open groups namespace\n");
+		return false;
+	}
+	
+	// Stored as is: name and one member word per module
+	String key = "grp_" + String(index);
+	const GroupManager::Group* group = group_manager->getGroup(index);
+	bool success;
+	if (!group) {
+		success = !preferences.isKey(key.c_str()) || preferences.remove(key.c_str());
+	} else {
+		success = preferences.putBytes(key.c_str(), group, sizeof(GroupManager::Group)) == sizeof(GroupManager::Group);
+	}
+	preferences.end();
+	
+	if (success) {
+		LOG_INFO("[STORAGEMGR] Group %d saved\n", index);
+	} else {
+		LOG_ERROR("[STORAGEMGR] Saving group %d failed\n", index);
+	}
+	
+	return success;
+}
+
+bool StorageManager::save_scene(uint8_t index) {
+	if (!group_manager || index >= GroupManager::SCENE_MAX) {
+		return false;
+	}
+	
+	if (!preferences.begin(NAMESPACE_GROUPS, false)) {
+		LOG_ERROR("[STORAGEMGR] Failed to open groups namespace\n");
+		return false;
+	}
+	
+	// Only the used entries are stored
+	String key = "scn_" + String(index);
+	const GroupManager::Scene* scene = group_manager->getScene(index);
+	bool success;
+	if (!scene) {
+		success = !preferences.isKey(key.c_str()) || preferences.remove(key.c_str());
+	} else {
+		size_t size = offsetof(GroupManager::Scene, entries) + scene->count * sizeof(GroupManager::SceneEntry);
+		success = preferences.putBytes(key.c_str(), scene, size) == size;
+	}
+	preferences.end();
+	
+	if (success) {
+		LOG_INFO("[STORAGEMGR] Scene %d saved\n", index);
+	} else {
+		LOG_ERROR("[STORAGEMGR] Saving scene %d failed\n", index);
+	}
+	
+	return success;
+}
+
+uint8_t StorageManager::load_groups() {
+	if (!group_manager || !preferences.begin(NAMESPACE_GROUPS, true)) {
+		return 0;
+	}
+	
+	uint8_t loaded = 0;
+	std::unique_ptr<GroupManager::Group> group(new GroupManager::Group());
+	for (uint8_t i = 0; i < GroupManager::GROUP_MAX; i++) {
+		String key = "grp_" + String(i);
+		if (preferences.getBytesLength(key.c_str()) != sizeof(GroupManager::Group) ||
+			preferences.getBytes(key.c_str(), group.get(), sizeof(GroupManager::Group)) != sizeof(GroupManager::Group)) {
+			continue;
+		}
+		if (group_manager->setGroup(i, *group)) {
+			loaded++;
+		}
+	}
+	
+	std::unique_ptr<GroupManager::Scene> scene(new GroupManager::Scene());
+	const size_t header_size = offsetof(GroupManager::Scene, entries);
+	for (uint8_t i = 0; i < GroupManager::SCENE_MAX; i++) {
+		String key = "scn_" + String(i);
+		size_t size = preferences.getBytesLength(key.c_str());
+		*scene = GroupManager::Scene();
+		if (size < header_size || size > sizeof(GroupManager::Scene) ||
+			preferences.getBytes(key.c_str(), scene.get(), size) != size ||
+			size != header_size + scene->count * sizeof(GroupManager::SceneEntry)) {
+			continue;
+		}
+		if (group_manager->setScene(i, *scene)) {
+			loaded++;
+		} else {
+			LOG_ERROR("[STORAGEMGR] Ignoring invalid saved scene %d\n", i);
+		}
+	}
+	preferences.end();
+	
+	return loaded;
+}
+
+// === Model Clock and Schedule Management ===
+
+bool StorageManager::save_model_clock(const ScheduleManager::Clock& clock) {
+	if (!preferences.begin(NAMESPACE_SCHEDULE, false)) {
+		LOG_ERROR("[STORAGEMGR] Failed to open schedule namespace\n");
+		return false;
+	}
+	
+	bool success = preferences.putBytes("clock", &clock, sizeof(clock)) == sizeof(clock);
+	preferences.end();
+	
+	if (!success) {
+		LOG_ERROR("[STORAGEMGR] Saving model clock failed\n");
+	}
+	
+	return success;
+}
+
+bool StorageManager::save_schedule(const ScheduleManager::Event* events, uint8_t count) {
+	if (count > ScheduleManager::EVENT_MAX) {
+		return false;
+	}
+	
+	if (!preferences.begin(NAMESPACE_SCHEDULE, false)) {
+		LOG_ERROR("[STORAGEMGR] Failed to open schedule namespace\n");
+		return false;
+	}
+	
+	// Stored as is, the number of events follows from the size
+	bool success;
+	size_t size = count * sizeof(ScheduleManager::Event);
+	if (count == 0) {
+		success = !preferences.isKey("events") || preferences.remove("events");
+	} else {
+		success = preferences.putBytes("events", events, size) == size;
+	}
+	preferences.end();
+	
+	if (success) {
+		LOG_INFO("[STORAGEMGR] %d schedule events saved\n", count);
+	} else {
+		LOG_ERROR("[STORAGEMGR] Saving schedule failed\n");
+	}
+	
+	return success;
+}
+
+uint8_t StorageManager::load_schedule() {
+	if (!schedule_manager || !preferences.begin(NAMESPACE_SCHEDULE, true)) {
+		return 0;
+	}
+	
+	ScheduleManager::Clock clock;
+	if (preferences.getBytesLength("clock") == sizeof(clock) &&
+		preferences.getBytes("clock", &clock, sizeof(clock)) == sizeof(clock) &&
+		!schedule_manager->setClock(clock)) {
+		LOG_ERROR("[STORAGEMGR] Ignoring invalid saved model clock\n");
+	}
+	
+	uint8_t count = 0;
+	size_t size = preferences.getBytesLength("events");
+	if (size > 0 && size % sizeof(ScheduleManager::Event) == 0 && size <= ScheduleManager::EVENT_MAX * sizeof(ScheduleManager::Event)) {
+		std::unique_ptr<ScheduleManager::Event[]> events(new ScheduleManager::Event[size / sizeof(ScheduleManager::Event)]);
+		if (preferences.getBytes("events", events.get(), size) == size &&
+			schedule_manager->setEvents(events.get(), size / sizeof(ScheduleManager::Event))) {
+			count = size / sizeof(ScheduleManager::Event);
+		} else {
+			LOG_ERROR("[STORAGEMGR] Ignoring invalid saved schedule\n");
+		}
+	}
+	preferences.end();
+	
+	return count;
+}
+
+// === Input Management ===
+
+bool StorageManager::save_inputs(const InputManager::Wiring& wiring) {
+	if (!preferences.begin(NAMESPACE_INPUTS, false)) {
+		LOG_ERROR("[STORAGEMGR] Failed to open inputs namespace\n");
+		return false;
+	}
+	
+	bool success = preferences.putBytes("wiring", &wiring, sizeof(wiring)) == sizeof(wiring);
+	preferences.end();
+	
+	if (success) {
+		LOG_INFO("[STORAGEMGR] Input wiring saved\n");
+	} else {
+		LOG_ERROR("[STORAGEMGR] Saving input wiring failed\n");
+	}
+	
+	return success;
+}
+
+bool StorageManager::load_inputs() {
+	if (!input_manager || !preferences.begin(NAMESPACE_INPUTS, true)) {
+		return false;
+	}
+	
+	std::unique_ptr<InputManager::Wiring> wiring(new InputManager::Wiring());
+	bool loaded = preferences.getBytesLength("wiring") == sizeof(InputManager::Wiring) &&
+		preferences.getBytes("wiring", wiring.get(), sizeof(InputManager::Wiring)) == sizeof(InputManager::Wiring);
+	preferences.end();
+	
+	if (loaded && !input_manager->setWiring(*wiring)) {
+		LOG_ERROR("[STORAGEMGR] Ignoring invalid saved input wiring\n");
+		loaded = false;
+	}
+	
+	return loaded;
+}
+
+bool StorageManager::save_layers(const LayerStack::Setup& setup) {
+	if (!preferences.begin(NAMESPACE_LAYERS, false)) {
+		LOG_ERROR("[STORAGEMGR] Failed to open layers namespace\n");
+		return false;
+	}
+	
+	bool success = preferences.putBytes("setup", &setup, sizeof(setup)) == sizeof(setup);
+	preferences.end();
+	
+	if (success) {
+		LOG_INFO("[STORAGEMGR] Layer stacks saved\n");
+	} else {
+		LOG_ERROR("[STORAGEMGR] Saving layer stacks failed\n");
+	}
+	
+	return success;
+}
+
+bool StorageManager::load_layers() {
+	if (!layer_stack || !preferences.begin(NAMESPACE_LAYERS, true)) {
+		return false;
+	}
+	
+	std::unique_ptr<LayerStack::Setup> setup(new LayerStack::Setup());
+	bool loaded = preferences.getBytesLength("setup") == sizeof(LayerStack::Setup) &&
+		preferences.getBytes("setup", setup.get(), sizeof(LayerStack::Setup)) == sizeof(LayerStack::Setup);
+	preferences.end();
+	
+	if (loaded && !layer_stack->setSetup(*setup)) {
+		LOG_ERROR("[STORAGEMGR] Ignoring invalid saved layer stacks\n");
+		loaded = false;
+	}
+	
+	return loaded;
+}
+
+// === Log Configuration Management ===
+
+bool StorageManager::save_log_file_enabled(bool enabled) {
+	if (!preferences.begin(NAMESPACE_CONFIG, false)) {
+		LOG_ERROR("[STORAGEMGR] Failed to open config namespace\n");
+		return false;
+	}
+	
+	bool success = preferences.putBool("log_file", enabled) > 0;
+	preferences.end();
+	
+	if (!success) {
+		LOG_ERROR("[STORAGEMGR] Failed to save log file setting\n");
+	}
+	
+	return success;
+}
+
+bool StorageManager::load_log_file_enabled() {
+	if (!preferences.begin(NAMESPACE_CONFIG, true)) {
+		return false;
+	}
+	
+	bool enabled = preferences.getBool("log_file", false);
+	preferences.end();
+	
+	return enabled;
+}
@@ -19,8 +19,14 @@
 #include "web_server.h"
 #include "config.h"
 #include "log.h"
+#include "log_sink.h"
 #include "network.h"
 #include "ota.h"
+#include "group.h"
+#include "schedule.h"
+#include "input.h"
+#include "show.h"
+#include "layer.h"
 #include "pca9685.h"
 #include "program.h"
 #include "storage.h"
@@ -30,6 +36,55 @@
 /// Global web server instance
 WebServer web_server(80);
 
+/**
+ * @brief Serialize one log entry as a stream event payload
+ * 
+ * @param entry Log entry to serialize
+ * @param payload Output JSON string
+ */
+static void serializeLogEvent(const LogEntry& entry, String& payload) {
+	JsonDocument doc;
+	doc["sequence"] = entry.sequence;
+	doc["timestamp"] = entry.timestamp;
+	doc["level"] = static_cast<int>(entry.level);
+	doc["message"] = entry.message;
+	
+	payload = "";
+	serializeJson(doc, payload);
+}
+
+/**
+ * @brief Read a group change from a request body
+ * 
+ * @param json Object with any of "enabled", "brightness", "program_type",
+ *        "transition_ms" and "easing"
+ * @param action Change to fill, its group is left unchanged
+ * @return Error message, or nullptr if the change is valid
+ */
+static const char* groupActionFromJson(JsonVariantConst json, GroupManager::Action& action) {
+	action.set_enabled = json["enabled"].is<bool>();
+	action.enabled = json["enabled"] | true;
+	action.set_brightness = !json["brightness"].isNull();
+	action.brightness = json["brightness"] | 0;
+	action.set_program = !json["program_type"].isNull();
+	action.program = json["program_type"] | 0;
+	if ((action.set_brightness && (!json["brightness"].is<uint16_t>() || action.brightness > LED::MAX_BRIGHTNESS)) ||
+		(action.set_program && (!json["program_type"].is<uint8_t>() || action.program > PROGRAM_CUSTOM))) {
+		return "Invalid brightness or program";
+	}
+	
+	TransitionEasing easing = EASING_LINEAR;
+	if ((!json["transition_ms"].isNull() &&
+		(!json["transition_ms"].is<uint32_t>() || json["transition_ms"].as<uint32_t>() > ProgramManager::TRANSITION_MS_MAX)) ||
+		(!json["easing"].isNull() && !ProgramManager::easing_from_name(json["easing"].as<const char*>(), easing))) {
+		return "Invalid transition duration or easing";
+	}
+	action.transition_ms = json["transition_ms"] | 0;
+	action.easing = easing;
+	
+	return nullptr;
+}
+
 // === Constructor and Destructor ===
 
 // Default constructor
@@ -37,7 +92,11 @@ WebServer::WebServer(uint16_t port) :
 	server_(port),
 	port_(port),
 	server_running_(false),
-	initialized_(false) {
+	initialized_(false),
+	log_events_("/api/logs/stream"),
+	log_stream_cursor_(0),
+	last_log_push_(0) {
+	log_stream_batch_.reserve(LOG_STREAM_BATCH_MAX);
 	LOG_INFO("[WEBSERVER] WebServer instance created on port %u\n", port);
 }
 
@@ -112,6 +171,38 @@ bool WebServer::start() {
 	return true;
 }
 
+void WebServer::handle() {
+	if (!server_running_) {
+		return;
+	}
+	
+	LogManager& log_manager = LogManager::getInstance();
+	
+	// Nobody listening: just follow the head of the log
+	if (log_events_.count() == 0) {
+		log_stream_cursor_ = log_manager.getLastSequence();
+		return;
+	}
+	
+	unsigned long now = millis();
+	if (now - last_log_push_ < LOG_STREAM_INTERVAL_MS || log_stream_cursor_ == log_manager.getLastSequence()) {
+		return;
+	}
+	last_log_push_ = now;
+	
+	// Copy only the entries created since the last push
+	log_stream_batch_.clear();
+	log_manager.getLogsAfter(log_stream_cursor_, LOG_STREAM_BATCH_MAX, log_stream_batch_);
+	
+	String payload;
+	for (const auto& entry : log_stream_batch_) {
+		serializeLogEvent(entry, payload);
+		log_events_.send(payload.c_str(), "log", entry.sequence);
+		log_stream_cursor_ = entry.sequence;
+	}
+	log_stream_batch_.clear();
+}
+
 void WebServer::stop() {
 	if (!server_running_) {
 		return;
@@ -141,12 +232,58 @@ void WebServer::setupApiRoutes() {
 	server_.on("/api/system", HTTP_GET, createSystemHandler());
 	
 	// Hardware management endpoints
+	server_.on("/api/modules/pwm", HTTP_POST, [](AsyncWebServerRequest *request){}, NULL, createUpdateModulePwmHandler());
+	server_.on("/api/modules/calibrate", HTTP_GET, createModuleCalibrationHandler());
+	server_.on("/api/modules/calibrate", HTTP_POST, [](AsyncWebServerRequest *request){}, NULL, createModuleCalibrateHandler());
 	server_.on("/api/modules", HTTP_GET, createModulesHandler());
+	server_.on("/api/modules", HTTP_DELETE, createForgetModuleHandler());
 	server_.on("/api/leds", HTTP_GET, createLedsHandler());
 	server_.on("/api/leds", HTTP_POST, [](AsyncWebServerRequest *request){}, NULL, createUpdateLedHandler());
+	server_.on("/api/i2c/bench", HTTP_POST, [](AsyncWebServerRequest *request){}, NULL, createI2cBenchHandler());
+	server_.on("/api/i2c", HTTP_GET, createI2cHandler());
+	server_.on("/api/i2c", HTTP_POST, [](AsyncWebServerRequest *request){}, NULL, createUpdateI2cHandler());
+	server_.on("/api/broadcast/groups", HTTP_POST, [](AsyncWebServerRequest *request){}, NULL, createUpdateBroadcastGroupsHandler());
+	server_.on("/api/broadcast", HTTP_GET, createBroadcastHandler());
+	server_.on("/api/broadcast", HTTP_POST, [](AsyncWebServerRequest *request){}, NULL, createBroadcastActionHandler());
+	server_.on("/api/power", HTTP_GET, createPowerHandler());
+	server_.on("/api/power", HTTP_POST, [](AsyncWebServerRequest *request){}, NULL, createUpdatePowerHandler());
+	server_.on("/api/curves", HTTP_GET, createCurvesHandler());
+	server_.on("/api/curves", HTTP_POST, [](AsyncWebServerRequest *request){}, NULL, createUpdateCurvesHandler());
 
 	// Program management endpoints
 	server_.on("/api/programs", HTTP_GET, createProgramsHandler());
+	server_.on("/api/effects/bench", HTTP_GET, createEffectBenchResultsHandler());
+	server_.on("/api/effects/bench", HTTP_POST, [](AsyncWebServerRequest *request){}, NULL, createEffectBenchHandler());
+	server_.on("/api/effects", HTTP_GET, createEffectsHandler());
+	server_.on("/api/effects", HTTP_POST, [](AsyncWebServerRequest *request){}, NULL, createUpdateEffectHandler());
+
+	// LED group and scene endpoints
+	server_.on("/api/groups/apply", HTTP_POST, [](AsyncWebServerRequest *request){}, NULL, createApplyGroupHandler());
+	server_.on("/api/groups", HTTP_GET, createGroupsHandler());
+	server_.on("/api/groups", HTTP_POST, [](AsyncWebServerRequest *request){}, NULL, createUpdateGroupHandler());
+	server_.on("/api/scenes/recall", HTTP_POST, [](AsyncWebServerRequest *request){}, NULL, createRecallSceneHandler());
+	server_.on("/api/scenes", HTTP_GET, createScenesHandler());
+	server_.on("/api/scenes", HTTP_POST, [](AsyncWebServerRequest *request){}, NULL, createUpdateSceneHandler());
+	server_.on("/api/clock", HTTP_GET, createClockHandler());
+	server_.on("/api/clock", HTTP_POST, [](AsyncWebServerRequest *request){}, NULL, createUpdateClockHandler());
+	server_.on("/api/schedule", HTTP_GET, createScheduleHandler());
+	server_.on("/api/schedule", HTTP_POST, [](AsyncWebServerRequest *request){}, NULL, createUpdateScheduleHandler());
+	server_.on("/api/inputs", HTTP_GET, createInputsHandler());
+	server_.on("/api/inputs", HTTP_POST, [](AsyncWebServerRequest *request){}, NULL, createUpdateInputsHandler());
+
+	// Show endpoints (sub-paths first, "/api/shows" also matches "/api/shows/*")
+	server_.on("/api/shows/play", HTTP_POST, [](AsyncWebServerRequest *request){}, NULL, createPlayShowHandler());
+	server_.on("/api/shows/stop", HTTP_POST, createStopShowHandler());
+	server_.on("/api/shows/upload", HTTP_POST, createShowUploadedHandler(), createShowUploadHandler());
+	server_.on("/api/shows", HTTP_GET, createShowsHandler());
+	server_.on("/api/shows", HTTP_DELETE, createDeleteShowHandler());
+
+	// Layer endpoints (sub-paths first)
+	server_.on("/api/layers/master", HTTP_POST, [](AsyncWebServerRequest *request){}, NULL, createLayerMasterHandler());
+	server_.on("/api/layers/bench", HTTP_GET, createLayerBenchResultsHandler());
+	server_.on("/api/layers/bench", HTTP_POST, [](AsyncWebServerRequest *request){}, NULL, createLayerBenchHandler());
+	server_.on("/api/layers", HTTP_GET, createLayersHandler());
+	server_.on("/api/layers", HTTP_POST, [](AsyncWebServerRequest *request){}, NULL, createUpdateLayersHandler());
 
 	// OTA update endpoints
 	server_.on("/api/ota/status", HTTP_GET, createOtaStatusHandler());
@@ -171,7 +308,15 @@ void WebServer::setupApiRoutes() {
 		createOtaUploadHandler()
 	);
 
-	// System logs endpoints
+	// System logs endpoints (sub-paths first, "/api/logs" also matches "/api/logs/*")
+	log_events_.onConnect([this](AsyncEventSourceClient *client) {
+		this->handleLogStreamConnect(client);
+	});
+	server_.addHandler(&log_events_);
+	server_.on("/api/logs/levels", HTTP_GET, createLogLevelsHandler());
+	server_.on("/api/logs/levels", HTTP_POST, [](AsyncWebServerRequest *request){}, NULL, createUpdateLogLevelsHandler());
+	server_.on("/api/logs/file", HTTP_GET, createLogFileHandler());
+	server_.on("/api/logs/file", HTTP_POST, [](AsyncWebServerRequest *request){}, NULL, createUpdateLogFileHandler());
 	server_.on("/api/logs", HTTP_GET, createLogsHandler());
 	server_.on("/api/logs", HTTP_DELETE, createClearLogsHandler());
 
@@ -293,6 +438,14 @@ void WebServer::handleGetHealth(AsyncWebServerRequest *request) {
 	uint8_t total_modules = module_manager ? module_manager->getModuleCount() : 0;
 	bool modules_ok = (initialized_modules == total_modules) && (total_modules > 0);
 	
+	// Modules dropped off the bus are waiting for automatic re-initialization
+	for (uint8_t i = 0; module_manager && i < total_modules; i++) {
+		const PCA9685Module* module = module_manager->getModule(i);
+		if (module && module->getHealth() == PCA9685Module::Health::OFFLINE) {
+			modules_ok = false;
+		}
+	}
+	
 	// Determine overall system status
 	if (memory_critical) {
 		overall_status = "critical";
@@ -390,7 +543,14 @@ void WebServer::handleGetSystem(AsyncWebServerRequest *request) {
 	JsonObject i2c = doc["i2c"].to<JsonObject>();
 	i2c["sda_pin"] = config.getI2cSdaPin();
 	i2c["scl_pin"] = config.getI2cSclPin();
-	i2c["clock_hz"] = 100000;
+	i2c["clock_hz"] = module_manager ? module_manager->getBusClockHz(0) : Config::I2C_CLOCK_STANDARD;
+	i2c["max_clock_hz"] = config.getI2cClockHz();
+	i2c["bus1_enabled"] = config.isI2c1Enabled();
+	if (config.isI2c1Enabled()) {
+		i2c["bus1_sda_pin"] = config.getI2c1SdaPin();
+		i2c["bus1_scl_pin"] = config.getI2c1SclPin();
+		i2c["bus1_clock_hz"] = module_manager ? module_manager->getBusClockHz(1) : Config::I2C_CLOCK_STANDARD;
+	}
 	i2c["addr_min"] = "0x" + String(config.getPca9685AddrMin(), HEX);
 	i2c["addr_max"] = "0x" + String(config.getPca9685AddrMax(), HEX);
 	
@@ -432,6 +592,36 @@ void WebServer::handleGetModules(AsyncWebServerRequest *request) {
 				JsonObject module_obj = pca9685.add<JsonObject>();
 				module_obj["id"] = i;
 				module_obj["address"] = "0x" + String(module->getAddress(), HEX);
+				module_obj["bus"] = module->getBus();
+				module_obj["driver"] = module->getDriverName();
+				module_obj["broadcast_groups"] = module->getBroadcastGroups();
+				module_obj["broadcast_hold"] = module->isBroadcastHeld();
+				
+				const PCA9685Module::HealthStats& stats = module->getHealthStats();
+				JsonObject health = module_obj["health"].to<JsonObject>();
+				health["state"] = module->getHealthName();
+				health["errors"] = stats.errors;
+				health["nacks"] = stats.nacks;
+				health["timeouts"] = stats.timeouts;
+				health["resets"] = stats.resets;
+				health["reinits"] = stats.reinits;
+				health["consecutive_failures"] = stats.consecutive;
+				health["retry_in_ms"] = module->getRetryInMs();
+				
+				JsonObject pwm = module_obj["pwm"].to<JsonObject>();
+				pwm["frequency"] = module->getPwmFrequency();
+				pwm["actual_frequency"] = module->getActualPwmFrequency();
+				pwm["oscillator_hz"] = module->getOscillatorFrequency();
+				pwm["prescale"] = module->getPrescale();
+				pwm["camera_mode"] = module->isCameraMode();
+				pwm["frequency_forced"] = module->isFrequencyForced();
+				
+				module_obj["curve"] = BrightnessCurve::getName(module->getCurve());
+				
+				JsonObject power = module_obj["power"].to<JsonObject>();
+				power["rated_ma"] = module->getRatedCurrent();
+				power["demand_ma"] = module->getDemandCurrent();
+				power["estimated_ma"] = module->getEstimatedCurrent();
 				module_obj["name"] = module->getName();
 				module_obj["detected"] = module->isDetected();
 				module_obj["initialized"] = module->isInitialized();
@@ -451,6 +641,137 @@ void WebServer::handleGetModules(AsyncWebServerRequest *request) {
 	request->send(200, "application/json", response);
 }
 
+void WebServer::handleForgetModule(AsyncWebServerRequest *request) {
+	int module_id = request->hasParam("module") ? request->getParam("module")->value().toInt() : -1;
+	if (!module_manager || module_id < 0 || module_id >= module_manager->getModuleCount() ||
+		!module_manager->getModule(module_id)) {
+		request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid module\"}");
+		return;
+	}
+	
+	// Applied by the main loop once the bus tasks are idle
+	if (!module_manager->requestForget(module_id)) {
+		request->send(409, "application/json", "{\"success\":false,\"error\":\"Module is present or a request is pending\"}");
+		return;
+	}
+	
+	LOG_INFO("[WEBSERVER] Module %d forget requested\n", module_id);
+	request->send(200, "application/json", "{\"success\":true}");
+}
+
+void WebServer::handleUpdateModulePwm(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+	JsonDocument doc;
+	if (deserializeJson(doc, (const char*)data, len)) {
+		request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid JSON\"}");
+		return;
+	}
+	
+	if (!module_manager) {
+		request->send(503, "application/json", "{\"success\":false,\"error\":\"Module manager not available\"}");
+		return;
+	}
+	
+	uint8_t module_id = doc["module"].as<uint8_t>();
+	PCA9685Module* module = doc["module"].is<int>() ? module_manager->getModule(module_id) : nullptr;
+	if (!module) {
+		request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid module\"}");
+		return;
+	}
+	
+	// Validate everything before changing anything
+	if ((!doc["frequency"].isNull() && (!doc["frequency"].is<int>() ||
+			doc["frequency"].as<int>() < PCA9685Module::PWM_FREQUENCY_MIN ||
+			doc["frequency"].as<int>() > PCA9685Module::PWM_FREQUENCY_MAX)) ||
+		(!doc["oscillator_hz"].isNull() && (!doc["oscillator_hz"].is<uint32_t>() ||
+			doc["oscillator_hz"].as<uint32_t>() < PCA9685Module::OSCILLATOR_MIN ||
+			doc["oscillator_hz"].as<uint32_t>() > PCA9685Module::OSCILLATOR_MAX))) {
+		request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid frequency or oscillator\"}");
+		return;
+	}
+	
+	if (doc["frequency"].is<int>()) {
+		module->setPwmFrequency(doc["frequency"].as<uint16_t>());
+	}
+	if (doc["oscillator_hz"].is<uint32_t>()) {
+		module->setOscillatorFrequency(doc["oscillator_hz"].as<uint32_t>());
+	}
+	if (doc["camera_mode"].is<bool>()) {
+		module->setCameraMode(doc["camera_mode"].as<bool>());
+	}
+	
+	StorageManager::save_module_config(module_id);
+	module_manager->requestPwmUpdate();
+	
+	JsonDocument response_doc;
+	response_doc["success"] = true;
+	response_doc["module"] = module_id;
+	response_doc["prescale"] = module->getTargetPrescale();
+	response_doc["actual_frequency"] = PCA9685Module::getPrescaleFrequency(module->getOscillatorFrequency(), module->getTargetPrescale());
+	response_doc["frequency_forced"] = module->isFrequencyForced();
+	
+	String response;
+	serializeJson(response_doc, response);
+	request->send(200, "application/json", response);
+}
+
+void WebServer::handleModuleCalibrate(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+	JsonDocument doc;
+	if (deserializeJson(doc, (const char*)data, len)) {
+		request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid JSON\"}");
+		return;
+	}
+	
+	if (!module_manager) {
+		request->send(503, "application/json", "{\"success\":false,\"error\":\"Module manager not available\"}");
+		return;
+	}
+	
+	if (!doc["module"].is<int>() || !doc["led"].is<int>() || !doc["pin"].is<int>()) {
+		request->send(400, "application/json", "{\"success\":false,\"error\":\"module, led and pin required\"}");
+		return;
+	}
+	
+	uint8_t module_id = doc["module"].as<uint8_t>();
+	uint8_t led_id = doc["led"].as<uint8_t>();
+	uint8_t pin = doc["pin"].as<uint8_t>();
+	
+	const PCA9685Module* module = module_manager->getModule(module_id);
+	if (!module || !module->isInitialized() || led_id >= module->getLedCount()) {
+		request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid module or LED\"}");
+		return;
+	}
+	if (!config.isFreeInputPin(pin)) {
+		request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid pin\"}");
+		return;
+	}
+	
+	// Calibration runs from the main loop, result reported by GET /api/modules/calibrate
+	module_manager->requestOscillatorCalibration(module_id, led_id, pin);
+	
+	request->send(202, "application/json", "{\"success\":true}");
+}
+
+void WebServer::handleGetModuleCalibration(AsyncWebServerRequest *request) {
+	if (!module_manager) {
+		request->send(503, "application/json", "{\"success\":false,\"error\":\"Module manager not available\"}");
+		return;
+	}
+	
+	const ModuleManager::CalibrationResult& result = module_manager->getCalibrationResult();
+	
+	JsonDocument doc;
+	doc["run"] = result.run;
+	doc["success"] = result.success;
+	doc["module"] = result.module;
+	doc["led"] = result.led;
+	doc["pin"] = result.pin;
+	doc["oscillator_hz"] = result.oscillator_hz;
+	
+	String response;
+	serializeJson(doc, response);
+	request->send(200, "application/json", response);
+}
+
 void WebServer::handleGetLeds(AsyncWebServerRequest *request) {
 	JsonDocument doc;
 	JsonArray leds = doc["leds"].to<JsonArray>();
@@ -468,9 +789,21 @@ void WebServer::handleGetLeds(AsyncWebServerRequest *request) {
 						led_obj["name"] = led->getName();
 						led_obj["enabled"] = led->isEnabled();
 						led_obj["brightness"] = led->getBrightness();
+						led_obj["curve"] = BrightnessCurve::getName(led->getCurve());
+						led_obj["dither"] = led->isDitherEnabled();
+						led_obj["rated_ma"] = led->getRatedCurrent();
+						led_obj["priority"] = led->getPriority();
 						led_obj["program_type"] = led->getProgramType();
 						led_obj["program_name"] = program_manager->get_program_name(led->getProgramType());
+						if (led->getProgramType() == PROGRAM_CUSTOM && led->getProgramState()) {
+							led_obj["effect_slot"] = led->getProgramState()->effect_slot;
+						}
+						program_manager->params_to_json(program_manager->get_program_params(i, j), led_obj["params"].to<JsonObject>());
+						uint16_t phase_offset;
+						led_obj["phase_group"] = program_manager->get_phase_group(i, j, phase_offset);
+						led_obj["phase_offset"] = phase_offset;
 						led_obj["is_controlled_by_program"] = (led->getProgramType() != PROGRAM_NONE);
+						led_obj["in_transition"] = led->getTransition() != 0;
 					}
 				}
 			}
@@ -508,156 +841,1825 @@ void WebServer::handleUpdateLed(AsyncWebServerRequest *request, uint8_t *data, s
 		return;
 	}
 
-	LED* led_info = module_manager->getLED(module, led);
+	const LED* led_info = module_manager->getLED(module, led);
 	if (!led_info) {
 		request->send(400, "application/json", "{\"error\":\"LED not found\"}");
 		return;
 	}
+	if ((!doc["enabled"].isNull() && !doc["enabled"].is<bool>()) ||
+		(!doc["brightness"].isNull() && (!doc["brightness"].is<uint16_t>() || doc["brightness"].as<uint16_t>() > LED::MAX_BRIGHTNESS)) ||
+		(!doc["program_type"].isNull() && (!doc["program_type"].is<uint8_t>() || doc["program_type"].as<uint8_t>() > PROGRAM_CUSTOM))) {
+		request->send(400, "application/json", "{\"error\":\"Invalid enabled state, brightness or program\"}");
+		return;
+	}
+	if (!doc["effect_slot"].isNull() &&
+		(!doc["effect_slot"].is<uint8_t>() || doc["effect_slot"].as<uint8_t>() >= ProgramManager::EFFECT_SLOTS)) {
+		request->send(400, "application/json", "{\"error\":\"Invalid effect slot\"}");
+		return;
+	}
+	TransitionEasing easing = EASING_LINEAR;
+	if ((!doc["transition_ms"].isNull() &&
+		(!doc["transition_ms"].is<uint32_t>() || doc["transition_ms"].as<uint32_t>() > ProgramManager::TRANSITION_MS_MAX)) ||
+		(!doc["easing"].isNull() && !ProgramManager::easing_from_name(doc["easing"].as<const char*>(), easing))) {
+		request->send(400, "application/json", "{\"error\":\"Invalid transition duration or easing\"}");
+		return;
+	}
+	CurveType curve = CURVE_DEFAULT;
+	if ((!doc["curve"].isNull() && !BrightnessCurve::fromName(doc["curve"].as<const char*>(), curve)) ||
+		(!doc["dither"].isNull() && !doc["dither"].is<bool>())) {
+		request->send(400, "application/json", "{\"error\":\"Invalid curve or dither\"}");
+		return;
+	}
+	if ((!doc["rated_ma"].isNull() && (!doc["rated_ma"].is<uint16_t>() || doc["rated_ma"].as<uint16_t>() > LED::RATED_MA_MAX)) ||
+		(!doc["priority"].isNull() && (!doc["priority"].is<uint8_t>() || doc["priority"].as<uint8_t>() > LED::PRIORITY_MAX))) {
+		request->send(400, "application/json", "{\"error\":\"Invalid rated current or priority\"}");
+		return;
+	}
 	
-	// Process individual property updates
-	if (!doc["name"].isNull()) {
-		led_info->setName(doc["name"].as<String>());
+	GroupManager::LedUpdate update = {};
+	update.module = module;
+	update.led = led;
+	
+	// Parameters and phase need the program the LED has once the update is applied
+	bool has_program = doc["program_type"].isNull() ? led_info->getProgramType() != PROGRAM_NONE : doc["program_type"].as<uint8_t>() != PROGRAM_NONE;
+	has_program = has_program || !doc["effect_slot"].isNull();
+	
+	// Program parameters, merged with the current ones
+	update.set_params = !doc["params"].isNull();
+	if (update.set_params) {
+		update.params = program_manager->get_program_params(module, led);
+		bool valid = has_program && doc["params"].is<JsonObject>() && program_manager->params_from_json(doc["params"], update.params);
+		ProgramParams resolved = update.params;
+		if (!valid || !program_manager->resolve_params(resolved)) {
+			request->send(400, "application/json", "{\"error\":\"Invalid program parameters or no program assigned\"}");
+			return;
+		}
 	}
 	
-	// Handle enable/disable state changes
-	if (!doc["enabled"].isNull()) {
-		led_info->setEnabled(doc["enabled"]);
-		if (!led_info->isEnabled()) {
-			led_info->setBrightness(0);
-			module_manager->applyLedBrightness(module, led);
-		} else {
-			// Restore brightness
-			module_manager->applyLedBrightness(module, led);
+	// Phase group membership, the offset alone keeps the group
+	update.set_phase = !doc["phase_group"].isNull() || !doc["phase_offset"].isNull();
+	if (update.set_phase) {
+		uint16_t offset;
+		uint8_t group = program_manager->get_phase_group(module, led, offset);
+		update.phase_group = doc["phase_group"] | group;
+		update.phase_offset = doc["phase_offset"] | offset;
+		if (!has_program ||
+			(!doc["phase_group"].isNull() && !doc["phase_group"].is<uint8_t>()) ||
+			(!doc["phase_offset"].isNull() && !doc["phase_offset"].is<uint16_t>()) ||
+			update.phase_group > ProgramManager::PHASE_GROUPS || update.phase_offset >= 360) {
+			request->send(400, "application/json", "{\"error\":\"Invalid phase group or offset, or no program assigned\"}");
+			return;
 		}
 	}
+	
+	update.set_name = !doc["name"].isNull();
+	if (update.set_name) {
+		update.name = doc["name"].as<String>();
+	}
+	update.set_enabled = !doc["enabled"].isNull();
+	update.enabled = doc["enabled"] | true;
+	update.set_program = !doc["program_type"].isNull();
+	update.program = doc["program_type"] | 0;
+	update.set_effect = !doc["effect_slot"].isNull();
+	update.effect_slot = doc["effect_slot"] | 0;
+	update.set_curve = !doc["curve"].isNull();
+	update.curve = curve;
+	update.set_dither = !doc["dither"].isNull();
+	update.dither = doc["dither"] | false;
+	update.set_rated = !doc["rated_ma"].isNull();
+	update.rated_ma = doc["rated_ma"] | 0;
+	update.set_priority = !doc["priority"].isNull();
+	update.priority = doc["priority"] | 0;
+	update.set_brightness = !doc["brightness"].isNull();
+	update.brightness = doc["brightness"] | 0;
+	update.transition_ms = doc["transition_ms"] | 0;
+	update.easing = easing;
+	
+	// Applied by the main loop, which owns the program states and transitions
+	if (!group_manager->requestLed(update)) {
+		request->send(409, "application/json", "{\"success\":false,\"error\":\"LED update in progress\"}");
+		return;
+	}
+	
+	request->send(200, "application/json", "{\"success\":true}");
+}
 
-	// Handle program assignment changes
-	if (!doc["program_type"].isNull()) {
-		ProgramType new_program = (ProgramType)doc["program_type"].as<int>();
+void WebServer::handleGetI2c(AsyncWebServerRequest *request) {
+	JsonDocument doc;
+	doc["max_clock_hz"] = config.getI2cClockHz();
+	doc["phase_stagger"] = config.isPhaseStaggerEnabled();
+	doc["linked_frames"] = config.isLinkedFramesEnabled();
+	doc["hotplug_scan"] = config.isHotplugScanEnabled();
+	
+	JsonArray buses = doc["buses"].to<JsonArray>();
+	for (uint8_t bus = 0; bus < PCA9685Module::BUS_COUNT; bus++) {
+		JsonObject bus_obj = buses.add<JsonObject>();
+		bus_obj["bus"] = bus;
+		bus_obj["enabled"] = ModuleManager::isBusEnabled(bus);
+		bus_obj["sda_pin"] = bus == 0 ? config.getI2cSdaPin() : config.getI2c1SdaPin();
+		bus_obj["scl_pin"] = bus == 0 ? config.getI2cSclPin() : config.getI2c1SclPin();
 		
-		if (new_program == PROGRAM_NONE) {
-			program_manager->unassign_program(module, led);
-		} else {
-			program_manager->assign_program(module, led, new_program);
+		if (!module_manager) {
+			continue;
+		}
+		
+		bus_obj["module_count"] = module_manager->getBusModuleCount(bus);
+		bus_obj["clock_hz"] = module_manager->getBusClockHz(bus);
+		
+		JsonArray speeds = bus_obj["speeds"].to<JsonArray>();
+		size_t count;
+		const ModuleManager::BusSpeedResult* results = module_manager->getBusSpeedResults(bus, count);
+		for (size_t i = 0; i < count; i++) {
+			JsonObject speed = speeds.add<JsonObject>();
+			speed["clock_hz"] = results[i].clock_hz;
+			speed["tested"] = results[i].tested;
+			speed["verified"] = results[i].verified;
+			speed["flush_us"] = results[i].flush_us;
+		}
+		
+		const ModuleManager::FrameStats& stats = module_manager->getFrameStats(bus);
+		JsonObject frames_obj = bus_obj["frames"].to<JsonObject>();
+		frames_obj["written"] = stats.frames;
+		frames_obj["late"] = stats.late;
+		frames_obj["linked_failures"] = stats.linked_failures;
+		frames_obj["last_write_us"] = stats.last_write_us;
+		
+		const ModuleManager::ScanStats& scan = module_manager->getScanStats(bus);
+		JsonObject scan_obj = bus_obj["scan"].to<JsonObject>();
+		scan_obj["next_address"] = "0x" + String(scan.next_address, HEX);
+		scan_obj["passes"] = scan.passes;
+		scan_obj["probes"] = scan.probes;
+		scan_obj["found"] = scan.found;
+		scan_obj["last_step_us"] = scan.last_step_us;
+		
+		const ModuleManager::DriverBenchResult& bench = module_manager->getDriverBenchResult(bus);
+		if (bench.run) {
+			JsonObject bench_obj = bus_obj["bench"].to<JsonObject>();
+			bench_obj["clock_hz"] = bench.clock_hz;
+			bench_obj["rounds"] = bench.rounds;
+			bench_obj["native_us"] = bench.native_us;
+			bench_obj["adafruit_us"] = bench.adafruit_us;
 		}
 	}
+	
+	String response;
+	serializeJson(doc, response);
+	request->send(200, "application/json", response);
+}
 
-	// Handle brightness updates (only when not program-controlled)
-	if (!doc["brightness"].isNull()) {
-		led_info->setBrightness(doc["brightness"]);
-		if (led_info->getProgramType() == PROGRAM_NONE && led_info->isEnabled()) {
-			module_manager->applyLedBrightness(module, led);
+void WebServer::handleUpdateI2c(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+	JsonDocument doc;
+	if (deserializeJson(doc, (const char*)data, len)) {
+		request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid JSON\"}");
+		return;
+	}
+	
+	bool renegotiate = false;
+	bool restart_required = false;
+	
+	// Read by the bus tasks at the start of each frame
+	if (doc["linked_frames"].is<bool>()) {
+		config.setLinkedFrames(doc["linked_frames"].as<bool>());
+	}
+	if (doc["hotplug_scan"].is<bool>()) {
+		config.setHotplugScan(doc["hotplug_scan"].as<bool>());
+	}
+	
+	if (doc["phase_stagger"].is<bool>()) {
+		config.setPhaseStagger(doc["phase_stagger"].as<bool>());
+		if (module_manager) {
+			module_manager->requestPhaseAllocation();
+		}
+	}
+	
+	if (!doc["clock_hz"].isNull()) {
+		if (!config.setI2cClockHz(doc["clock_hz"].as<uint32_t>())) {
+			request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid clock (100000, 400000 or 1000000)\"}");
+			return;
+		}
+		renegotiate = true;
+	}
+	
+	// Second bus pins, applied at next boot (scan happens at bring-up)
+	if (doc["bus1_enabled"].is<bool>() && !doc["bus1_enabled"].as<bool>()) {
+		config.setI2c1Pins(Config::I2C_PIN_NONE, Config::I2C_PIN_NONE);
+		restart_required = true;
+	} else if (doc["bus1_sda_pin"].is<int>() || doc["bus1_scl_pin"].is<int>()) {
+		if (!doc["bus1_sda_pin"].is<int>() || !doc["bus1_scl_pin"].is<int>() ||
+			!config.setI2c1Pins(doc["bus1_sda_pin"].as<uint8_t>(), doc["bus1_scl_pin"].as<uint8_t>())) {
+			request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid bus 1 pins\"}");
+			return;
 		}
+		restart_required = true;
+	}
+	
+	StorageManager::save_i2c_config();
+	
+	// Bus traffic stays in the loop task
+	if (renegotiate && module_manager) {
+		module_manager->requestBusNegotiation();
 	}
 	
-	// Build comprehensive response
+	LOG_INFO("[WEBSERVER] I2C configuration updated (max clock %lu Hz)\n", (unsigned long)config.getI2cClockHz());
+	
 	JsonDocument response_doc;
 	response_doc["success"] = true;
-	response_doc["led_info"]["module_id"] = module;
-	response_doc["led_info"]["led_id"] = led;
-	response_doc["led_info"]["name"] = led_info->getName();
-	response_doc["led_info"]["enabled"] = led_info->isEnabled();
-	response_doc["led_info"]["brightness"] = led_info->getBrightness();
-	response_doc["led_info"]["program_type"] = led_info->getProgramType();
-	response_doc["led_info"]["program_name"] = program_manager->get_program_name(led_info->getProgramType());
-	response_doc["led_info"]["is_controlled_by_program"] = (led_info->getProgramType() != PROGRAM_NONE);
-	
-	String response_str;
-	serializeJson(response_doc, response_str);
+	response_doc["renegotiating"] = renegotiate;
+	response_doc["restart_required"] = restart_required;
 	
-	request->send(200, "application/json", response_str);
+	String response;
+	serializeJson(response_doc, response);
+	request->send(200, "application/json", response);
 }
 
-void WebServer::handleGetPrograms(AsyncWebServerRequest *request) {
-	JsonDocument doc;
+void WebServer::handleI2cBench(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+	uint16_t rounds = I2C_BENCH_ROUNDS_DEFAULT;
 	
-	// Available programs
-	JsonDocument available = program_manager->get_available_programs();
-	doc["available_programs"] = available["programs"];
+	if (len > 0) {
+		JsonDocument doc;
+		if (deserializeJson(doc, (const char*)data, len)) {
+			request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid JSON\"}");
+			return;
+		}
+		if (doc["rounds"].is<int>()) {
+			int requested = doc["rounds"].as<int>();
+			if (requested < 1 || requested > I2C_BENCH_ROUNDS_MAX) {
+				request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid rounds\"}");
+				return;
+			}
+			rounds = requested;
+		}
+	}
 	
-	// Assigned programs
-	JsonDocument assigned = program_manager->get_assigned_programs();
-	doc["assigned_programs"] = assigned["assigned_programs"];
+	if (!module_manager) {
+		request->send(503, "application/json", "{\"success\":false,\"error\":\"Module manager not available\"}");
+		return;
+	}
 	
-	// Statistics
-	doc["stats"]["total_available"] = available["total"];
-	doc["stats"]["total_assigned"] = assigned["total"];
-	doc["timestamp"] = millis();
+	// Bench runs from the main loop, results are reported by GET /api/i2c
+	module_manager->requestDriverBench(rounds);
+	
+	JsonDocument response_doc;
+	response_doc["success"] = true;
+	response_doc["rounds"] = rounds;
 	
 	String response;
-	serializeJson(doc, response);
-	request->send(200, "application/json", response);
+	serializeJson(response_doc, response);
+	request->send(202, "application/json", response);
 }
 
-void WebServer::handleOtaStatus(AsyncWebServerRequest *request) {
+void WebServer::handleGetBroadcast(AsyncWebServerRequest *request) {
 	JsonDocument doc;
+	doc["all_call_address"] = ModuleManager::getBroadcastAddress(ModuleManager::BROADCAST_ALL);
 	
-	doc["ota_active"] = ota_manager->isActive();
-	doc["ota_status"] = ota_manager->getStatusString();
-	doc["ota_updating"] = ota_manager->isUpdating();
-	doc["ota_progress"] = ota_manager->getProgress();
-	doc["ota_hostname"] = ota_manager->getHostname();
-	doc["ota_port"] = ota_manager->getPort();
-	doc["last_error"] = ota_manager->getLastError();
+	JsonArray groups = doc["groups"].to<JsonArray>();
+	for (uint8_t group = 1; group <= Config::BROADCAST_GROUP_COUNT; group++) {
+		JsonObject group_obj = groups.add<JsonObject>();
+		group_obj["group"] = group;
+		group_obj["address"] = config.getBroadcastGroupAddress(group);
+		
+		JsonArray members = group_obj["modules"].to<JsonArray>();
+		if (module_manager) {
+			for (uint8_t i = 0; i < module_manager->getModuleCount(); i++) {
+				const PCA9685Module* module = module_manager->getModule(i);
+				if (module && module->isInBroadcastGroup(group)) {
+					members.add(i);
+				}
+			}
+		}
+	}
 	
-	// System health check for OTA
-	bool memory_ok = ESP.getFreeHeap() > 50000; // Need enough memory for OTA
-	doc["memory_sufficient"] = memory_ok;
-	doc["wifi_connected"] = WiFi.isConnected();
-	doc["wifi_rssi"] = WiFi.RSSI();
-	doc["ready_for_ota"] = memory_ok && WiFi.isConnected() && ota_manager->isActive();
+	JsonArray held = doc["held_modules"].to<JsonArray>();
+	if (module_manager) {
+		for (uint8_t i = 0; i < module_manager->getModuleCount(); i++) {
+			const PCA9685Module* module = module_manager->getModule(i);
+			if (module && module->isBroadcastHeld()) {
+				held.add(i);
+			}
+		}
+	}
 	
 	String response;
 	serializeJson(doc, response);
 	request->send(200, "application/json", response);
 }
 
-void WebServer::handleOtaUpload(AsyncWebServerRequest *request, String filename, size_t index, uint8_t *data, size_t len, bool final) {
-	static bool ota_started = false;
-	static size_t total_size = 0;
-	static unsigned long start_time = 0;
+void WebServer::handleBroadcastAction(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+	JsonDocument doc;
+	if (deserializeJson(doc, (const char*)data, len)) {
+		request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid JSON\"}");
+		return;
+	}
 	
-	// First chunk - initialize OTA
-	if (index == 0) {
-		ota_started = false;
-		total_size = request->contentLength();
-		start_time = millis();
-		
-		LOG_INFO("[WEBSERVER] Starting OTA update: %s (%zu bytes)\n", filename.c_str(), total_size);
-		
-		// Check available space
-		size_t free_space = ESP.getFreeSketchSpace();
-		if (total_size > free_space) {
-			LOG_INFO("[WEBSERVER] Error: Not enough space. Need: %zu, Available: %zu\n", total_size, free_space);
-			request->send(507, "application/json", "{\"success\":false,\"error\":\"Insufficient storage space\"}");
-			return;
-		}
-		
-		// Start update
-		if (!Update.begin(total_size)) {
-			LOG_ERROR("[WEBSERVER] Cannot start update: %s\n", Update.errorString());
-			request->send(500, "application/json", "{\"success\":false,\"error\":\"Cannot start update\"}");
-			return;
-		}
-		
-		ota_started = true;
-		LOG_INFO("[WEBSERVER] OTA update started successfully\n");
+	if (!module_manager) {
+		request->send(503, "application/json", "{\"success\":false,\"error\":\"Module manager not available\"}");
+		return;
 	}
 	
-	// Write data chunk
-	if (ota_started && len > 0) {
-		size_t written = Update.write(data, len);
-		if (written != len) {
-			LOG_ERROR("[WEBSERVER] Error: Write failed. Expected: %zu, Written: %zu\n", len, written);
-			Update.abort();
-			request->send(500, "application/json", "{\"success\":false,\"error\":\"Write failed\"}");
+	uint8_t group = doc["group"].is<int>() ? doc["group"].as<uint8_t>() : static_cast<uint8_t>(ModuleManager::BROADCAST_ALL);
+	if (group > Config::BROADCAST_GROUP_COUNT) {
+		request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid group\"}");
+		return;
+	}
+	
+	String action = doc["action"].is<const char*>() ? doc["action"].as<String>() : String();
+	uint16_t level = 0;
+	ModuleManager::BroadcastAction broadcast_action;
+	
+	if (action == "off") {
+		broadcast_action = ModuleManager::BroadcastAction::LEVEL;
+		level = 0;
+	} else if (action == "on") {
+		broadcast_action = ModuleManager::BroadcastAction::LEVEL;
+		level = LED::MAX_BRIGHTNESS;
+	} else if (action == "level") {
+		if (!doc["level"].is<int>() || doc["level"].as<int>() < 0 || doc["level"].as<int>() > LED::MAX_BRIGHTNESS) {
+			request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid level\"}");
 			return;
 		}
-		
-		// Progress logging (every 10%)
-		static uint8_t last_progress = 0;
-		uint8_t current_progress = (index + len) * 100 / total_size;
-		if (current_progress >= last_progress + 10) {
+		broadcast_action = ModuleManager::BroadcastAction::LEVEL;
+		level = doc["level"].as<uint16_t>();
+	} else if (action == "release") {
+		broadcast_action = ModuleManager::BroadcastAction::RELEASE;
+	} else if (action == "sync") {
+		broadcast_action = ModuleManager::BroadcastAction::SYNC;
+	} else {
+		request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid action (off, on, level, release or sync)\"}");
+		return;
+	}
+	
+	// Bus traffic stays in the loop task
+	module_manager->requestBroadcast(broadcast_action, group, level);
+	
+	LOG_INFO("[WEBSERVER] Broadcast %s requested for group %d\n", action.c_str(), group);
+	
+	request->send(202, "application/json", "{\"success\":true}");
+}
+
+void WebServer::handleUpdateBroadcastGroups(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+	JsonDocument doc;
+	if (deserializeJson(doc, (const char*)data, len)) {
+		request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid JSON\"}");
+		return;
+	}
+	
+	if (!module_manager) {
+		request->send(503, "application/json", "{\"success\":false,\"error\":\"Module manager not available\"}");
+		return;
+	}
+	
+	// Group address
+	if (doc["group"].is<int>() && doc["address"].is<int>()) {
+		uint8_t group = doc["group"].as<uint8_t>();
+		uint8_t address = doc["address"].as<uint8_t>();
+		
+		for (uint8_t i = 0; i < module_manager->getModuleCount(); i++) {
+			const PCA9685Module* module = module_manager->getModule(i);
+			if (module && module->getAddress() == address) {
+				request->send(400, "application/json", "{\"success\":false,\"error\":\"Address used by a module\"}");
+				return;
+			}
+		}
+		
+		if (!config.setBroadcastGroupAddress(group, address)) {
+			request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid group or address\"}");
+			return;
+		}
+		StorageManager::save_i2c_config();
+	}
+	
+	// Module membership: {"module": 0, "groups": [1, 2]}
+	if (doc["module"].is<int>()) {
+		uint8_t module_id = doc["module"].as<uint8_t>();
+		PCA9685Module* module = module_manager->getModule(module_id);
+		if (!module || !doc["groups"].is<JsonArrayConst>()) {
+			request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid module or groups\"}");
+			return;
+		}
+		
+		uint8_t mask = 0;
+		for (JsonVariantConst group : doc["groups"].as<JsonArrayConst>()) {
+			uint8_t group_id = group.as<uint8_t>();
+			if (group_id < 1 || group_id > Config::BROADCAST_GROUP_COUNT) {
+				request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid group\"}");
+				return;
+			}
+			mask |= 1 << (group_id - 1);
+		}
+		
+		module->setBroadcastGroups(mask);
+		StorageManager::save_module_config(module_id);
+	}
+	
+	module_manager->requestBroadcast(ModuleManager::BroadcastAction::APPLY_GROUPS);
+	
+	request->send(200, "application/json", "{\"success\":true}");
+}
+
+void WebServer::handleGetCurves(AsyncWebServerRequest *request) {
+	JsonDocument doc;
+	doc["default"] = BrightnessCurve::getName(config.getDefaultCurve());
+	
+	JsonArray curves = doc["curves"].to<JsonArray>();
+	for (uint8_t i = 0; i < BrightnessCurve::CURVE_TYPE_COUNT; i++) {
+		curves.add(BrightnessCurve::getName(static_cast<CurveType>(i)));
+	}
+	
+	const uint16_t* points = BrightnessCurve::getCustomPoints();
+	JsonArray custom = doc["custom"].to<JsonArray>();
+	for (uint8_t i = 0; i < BrightnessCurve::CUSTOM_POINTS; i++) {
+		custom.add(points[i]);
+	}
+	
+	String response;
+	serializeJson(doc, response);
+	request->send(200, "application/json", response);
+}
+
+void WebServer::handleGetPower(AsyncWebServerRequest *request) {
+	JsonDocument doc;
+	doc["budget_ma"] = config.getPowerBudget();
+	doc["mode"] = config.getPowerMode() == POWER_PRIORITY ? "priority" : "fair";
+	
+	if (!module_manager) {
+		String response;
+		serializeJson(doc, response);
+		request->send(200, "application/json", response);
+		return;
+	}
+	
+	const ModuleManager::PowerStats& stats = module_manager->getPowerStats();
+	doc["demand_ma"] = stats.demand_ma;
+	doc["estimated_ma"] = stats.estimated_ma;
+	doc["limited"] = stats.limited;
+	doc["limited_frames"] = stats.limited_frames;
+	
+	// Scales as percentages, one per priority (0 = dimmed first)
+	JsonArray scales = doc["scale_percent"].to<JsonArray>();
+	for (uint8_t i = 0; i < PCA9685Module::POWER_PRIORITIES; i++) {
+		scales.add((module_manager->getPowerScale(i) * 100 + PCA9685Module::POWER_SCALE_ONE / 2) >> 16);
+	}
+	
+	JsonArray modules = doc["modules"].to<JsonArray>();
+	for (uint8_t i = 0; i < module_manager->getModuleCount(); i++) {
+		const PCA9685Module* module = module_manager->getModule(i);
+		if (module) {
+			JsonObject module_obj = modules.add<JsonObject>();
+			module_obj["id"] = i;
+			module_obj["rated_ma"] = module->getRatedCurrent();
+			module_obj["demand_ma"] = module->getDemandCurrent();
+			module_obj["estimated_ma"] = module->getEstimatedCurrent();
+		}
+	}
+	
+	String response;
+	serializeJson(doc, response);
+	request->send(200, "application/json", response);
+}
+
+void WebServer::handleUpdatePower(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+	JsonDocument doc;
+	if (deserializeJson(doc, (const char*)data, len)) {
+		request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid JSON\"}");
+		return;
+	}
+	
+	if (!module_manager) {
+		request->send(503, "application/json", "{\"success\":false,\"error\":\"Module manager not available\"}");
+		return;
+	}
+	
+	// Validate everything before changing anything
+	const char* mode = doc["mode"].as<const char*>();
+	if ((!doc["budget_ma"].isNull() && (!doc["budget_ma"].is<uint32_t>() || doc["budget_ma"].as<uint32_t>() > Config::POWER_BUDGET_MAX_MA)) ||
+		(!doc["mode"].isNull() && (!mode || (strcmp(mode, "fair") != 0 && strcmp(mode, "priority") != 0)))) {
+		request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid budget or mode\"}");
+		return;
+	}
+	
+	PCA9685Module* module = nullptr;
+	if (!doc["module"].isNull()) {
+		module = doc["module"].is<int>() ? module_manager->getModule(doc["module"].as<uint8_t>()) : nullptr;
+		if (!module || !doc["rated_ma"].is<uint16_t>() ||
+			doc["rated_ma"].as<uint16_t>() == 0 || doc["rated_ma"].as<uint16_t>() > LED::RATED_MA_MAX) {
+			request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid module or rated current\"}");
+			return;
+		}
+	}
+	
+	if (doc["budget_ma"].is<uint32_t>()) {
+		config.setPowerBudget(doc["budget_ma"].as<uint32_t>());
+	}
+	if (mode) {
+		config.setPowerMode(strcmp(mode, "priority") == 0 ? POWER_PRIORITY : POWER_FAIR);
+	}
+	StorageManager::save_power_config();
+	
+	if (module) {
+		module->setRatedCurrent(doc["rated_ma"].as<uint16_t>());
+		StorageManager::save_module_config(doc["module"].as<uint8_t>());
+	}
+	
+	request->send(200, "application/json", "{\"success\":true}");
+}
+
+void WebServer::handleUpdateCurves(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+	JsonDocument doc;
+	if (deserializeJson(doc, (const char*)data, len)) {
+		request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid JSON\"}");
+		return;
+	}
+	
+	if (!module_manager) {
+		request->send(503, "application/json", "{\"success\":false,\"error\":\"Module manager not available\"}");
+		return;
+	}
+	
+	// Validate everything before changing anything
+	CurveType default_curve = config.getDefaultCurve();
+	if (!doc["default"].isNull() &&
+		(!BrightnessCurve::fromName(doc["default"].as<const char*>(), default_curve) || default_curve == CURVE_DEFAULT)) {
+		request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid default curve\"}");
+		return;
+	}
+	
+	uint16_t points[BrightnessCurve::CUSTOM_POINTS];
+	bool has_custom = !doc["custom"].isNull();
+	if (has_custom) {
+		JsonArray custom = doc["custom"].as<JsonArray>();
+		bool valid = custom.size() == BrightnessCurve::CUSTOM_POINTS;
+		for (uint8_t i = 0; valid && i < BrightnessCurve::CUSTOM_POINTS; i++) {
+			valid = custom[i].is<uint16_t>() && custom[i].as<uint16_t>() <= LED::MAX_BRIGHTNESS;
+			points[i] = custom[i].as<uint16_t>();
+		}
+		if (!valid) {
+			request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid custom curve points\"}");
+			return;
+		}
+	}
+	
+	PCA9685Module* module = nullptr;
+	CurveType module_curve = CURVE_DEFAULT;
+	if (!doc["module"].isNull()) {
+		module = doc["module"].is<int>() ? module_manager->getModule(doc["module"].as<uint8_t>()) : nullptr;
+		if (!module || !BrightnessCurve::fromName(doc["curve"].as<const char*>(), module_curve)) {
+			request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid module or curve\"}");
+			return;
+		}
+	}
+	
+	if (has_custom && !BrightnessCurve::setCustomPoints(points)) {
+		request->send(500, "application/json", "{\"success\":false,\"error\":\"Failed to set custom curve\"}");
+		return;
+	}
+	config.setDefaultCurve(default_curve);
+	StorageManager::save_curve_config();
+	
+	if (module) {
+		module->setCurve(module_curve);
+		StorageManager::save_module_config(doc["module"].as<uint8_t>());
+	}
+	
+	// Frames are rebuilt with the new curves on the next commit
+	module_manager->refreshAllLeds();
+	
+	request->send(200, "application/json", "{\"success\":true}");
+}
+
+void WebServer::handleGetPrograms(AsyncWebServerRequest *request) {
+	JsonDocument doc;
+	
+	// Available programs
+	JsonDocument available = program_manager->get_available_programs();
+	doc["available_programs"] = available["programs"];
+	
+	// Assigned programs
+	JsonDocument assigned = program_manager->get_assigned_programs();
+	doc["assigned_programs"] = assigned["assigned_programs"];
+	
+	// Statistics
+	doc["stats"]["total_available"] = available["total"];
+	doc["stats"]["total_assigned"] = assigned["total"];
+	doc["timestamp"] = millis();
+	
+	// Crossfades
+	doc["transitions"]["active"] = program_manager->get_transition_count();
+	doc["transitions"]["slots"] = static_cast<uint8_t>(ProgramManager::TRANSITION_SLOTS);
+	doc["transitions"]["duration_max_ms"] = static_cast<uint32_t>(ProgramManager::TRANSITION_MS_MAX);
+	JsonArray easings = doc["transitions"]["easings"].to<JsonArray>();
+	for (uint8_t i = EASING_LINEAR; i <= EASING_IN_OUT; i++) {
+		easings.add(program_manager->get_easing_name(static_cast<TransitionEasing>(i)));
+	}
+	
+	// Shared curve evaluation
+	ProgramManager::SharedStats shared = program_manager->get_shared_stats();
+	doc["shared"]["evaluations"] = shared.evaluations;
+	doc["shared"]["reuses"] = shared.reuses;
+	
+	String response;
+	serializeJson(doc, response);
+	request->send(200, "application/json", response);
+}
+
+void WebServer::handleGetEffects(AsyncWebServerRequest *request) {
+	JsonDocument doc;
+	doc["slot_count"] = static_cast<uint8_t>(ProgramManager::EFFECT_SLOTS);
+	doc["instructions_max"] = static_cast<uint8_t>(EffectVM::INSTRUCTIONS_MAX);
+	doc["budget_default"] = static_cast<uint8_t>(EffectVM::BUDGET_DEFAULT);
+	doc["budget_max"] = static_cast<uint8_t>(EffectVM::BUDGET_MAX);
+	
+	uint8_t code[EffectVM::INSTRUCTIONS_MAX * EffectVM::INSTRUCTION_SIZE];
+	JsonArray slots = doc["slots"].to<JsonArray>();
+	for (uint8_t slot = 0; slot < ProgramManager::EFFECT_SLOTS; slot++) {
+		const EffectVM::Program* effect = program_manager->get_effect(slot);
+		JsonObject slot_obj = slots.add<JsonObject>();
+		slot_obj["slot"] = slot;
+		if (!effect) {
+			slot_obj["empty"] = true;
+			continue;
+		}
+		
+		slot_obj["empty"] = false;
+		slot_obj["name"] = effect->name;
+		slot_obj["budget"] = effect->budget;
+		slot_obj["length"] = effect->length;
+		
+		size_t size = EffectVM::encode(*effect, code);
+		String hex;
+		hex.reserve(size * 2);
+		for (size_t i = 0; i < size; i++) {
+			char byte[3];
+			snprintf(byte, sizeof(byte), "%02x", code[i]);
+			hex += byte;
+		}
+		slot_obj["code"] = hex;
+		
+		JsonArray disassembly = slot_obj["disassembly"].to<JsonArray>();
+		for (uint8_t i = 0; i < effect->length; i++) {
+			const EffectInstruction& ins = effect->code[i];
+			char line[48];
+			snprintf(line, sizeof(line), "%02u: %s %u %u %u", i, EffectVM::getOpName(ins.op), ins.arg, ins.value, ins.param);
+			disassembly.add(line);
+		}
+		
+		EffectVM::Stats stats = program_manager->get_effect_stats(slot);
+		JsonObject stats_obj = slot_obj["stats"].to<JsonObject>();
+		stats_obj["updates"] = stats.updates;
+		stats_obj["instructions"] = stats.instructions;
+		stats_obj["overruns"] = stats.overruns;
+		stats_obj["max_per_update"] = stats.max_per_update;
+	}
+	
+	String response;
+	serializeJson(doc, response);
+	request->send(200, "application/json", response);
+}
+
+void WebServer::handleUpdateEffect(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+	JsonDocument doc;
+	if (deserializeJson(doc, (const char*)data, len)) {
+		request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid JSON\"}");
+		return;
+	}
+	
+	if (!doc["slot"].is<uint8_t>() || doc["slot"].as<uint8_t>() >= ProgramManager::EFFECT_SLOTS ||
+		!doc["code"].is<const char*>()) {
+		request->send(400, "application/json", "{\"success\":false,\"error\":\"slot and code required\"}");
+		return;
+	}
+	uint8_t slot = doc["slot"].as<uint8_t>();
+	
+	std::unique_ptr<EffectVM::Program> effect(new EffectVM::Program());
+	uint8_t code[EffectVM::INSTRUCTIONS_MAX * EffectVM::INSTRUCTION_SIZE];
+	size_t size;
+	if (!EffectVM::parseHex(doc["code"].as<const char*>(), code, sizeof(code), size)) {
+		request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid hexadecimal code\"}");
+		return;
+	}
+	
+	// Empty code clears the slot
+	if (size > 0) {
+		uint8_t budget = EffectVM::BUDGET_DEFAULT;
+		if (!doc["budget"].isNull()) {
+			budget = doc["budget"].is<uint8_t>() ? doc["budget"].as<uint8_t>() : 0;
+		}
+		
+		char error[EffectVM::ERROR_MAX];
+		if (!EffectVM::compile(code, size, budget, *effect, error, sizeof(error))) {
+			JsonDocument error_doc;
+			error_doc["success"] = false;
+			error_doc["error"] = error;
+			String response;
+			serializeJson(error_doc, response);
+			request->send(400, "application/json", response);
+			return;
+		}
+		snprintf(effect->name, sizeof(effect->name), "%s", doc["name"] | "Effect");
+	}
+	
+	// Installed from the main loop, between two program updates
+	if (!program_manager->request_effect(slot, *effect)) {
+		request->send(409, "application/json", "{\"success\":false,\"error\":\"Effect update in progress\"}");
+		return;
+	}
+	StorageManager::save_effect(slot, *effect);
+	
+	JsonDocument response_doc;
+	response_doc["success"] = true;
+	response_doc["slot"] = slot;
+	response_doc["length"] = effect->length;
+	
+	String response;
+	serializeJson(response_doc, response);
+	request->send(200, "application/json", response);
+}
+
+void WebServer::handleGetEffectBench(AsyncWebServerRequest *request) {
+	uint16_t rounds;
+	const ProgramManager::EffectBenchResult* results = program_manager->get_effect_bench(rounds);
+	
+	JsonDocument doc;
+	doc["pending"] = program_manager->is_effect_bench_pending();
+	doc["rounds"] = rounds;
+	doc["max_ratio"] = static_cast<float>(ProgramManager::EFFECT_BENCH_RATIO_MAX);
+	
+	bool passed = rounds > 0;
+	JsonArray programs = doc["programs"].to<JsonArray>();
+	for (uint8_t i = 0; rounds > 0 && i < ProgramManager::EFFECT_BENCH_COUNT; i++) {
+		JsonObject program = programs.add<JsonObject>();
+		program["name"] = results[i].name;
+		program["native_us"] = results[i].native_us;
+		program["effect_us"] = results[i].effect_us;
+		program["native_ns_per_update"] = (uint64_t)results[i].native_us * 1000 / rounds;
+		program["effect_ns_per_update"] = (uint64_t)results[i].effect_us * 1000 / rounds;
+		
+		float ratio = results[i].native_us > 0 ? (float)results[i].effect_us / results[i].native_us : 0.0f;
+		program["ratio"] = ratio;
+		if (results[i].effect_us == 0 || ratio > ProgramManager::EFFECT_BENCH_RATIO_MAX) {
+			passed = false;
+		}
+	}
+	doc["passed"] = passed;
+	
+	String response;
+	serializeJson(doc, response);
+	request->send(200, "application/json", response);
+}
+
+void WebServer::handleEffectBench(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+	uint16_t rounds = ProgramManager::EFFECT_BENCH_ROUNDS;
+	
+	if (len > 0) {
+		JsonDocument doc;
+		if (deserializeJson(doc, (const char*)data, len)) {
+			request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid JSON\"}");
+			return;
+		}
+		if (doc["rounds"].is<int>()) {
+			int requested = doc["rounds"].as<int>();
+			if (requested < 1 || requested > ProgramManager::EFFECT_BENCH_ROUNDS_MAX) {
+				request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid rounds\"}");
+				return;
+			}
+			rounds = requested;
+		}
+	}
+	
+	// Bench runs from the main loop, results are reported by GET /api/effects/bench
+	program_manager->request_effect_bench(rounds);
+	
+	JsonDocument response_doc;
+	response_doc["success"] = true;
+	response_doc["rounds"] = rounds;
+	
+	String response;
+	serializeJson(response_doc, response);
+	request->send(202, "application/json", response);
+}
+
+void WebServer::handleGetGroups(AsyncWebServerRequest *request) {
+	JsonDocument doc;
+	doc["group_max"] = static_cast<uint8_t>(GroupManager::GROUP_MAX);
+	doc["channel_count"] = static_cast<uint16_t>(GroupManager::CHANNEL_COUNT);
+	
+	JsonArray groups = doc["groups"].to<JsonArray>();
+	for (uint8_t i = 0; i < GroupManager::GROUP_MAX; i++) {
+		const GroupManager::Group* group = group_manager->getGroup(i);
+		JsonObject group_obj = groups.add<JsonObject>();
+		group_obj["index"] = i;
+		if (!group) {
+			group_obj["empty"] = true;
+			continue;
+		}
+		
+		group_obj["empty"] = false;
+		group_obj["name"] = group->name;
+		group_obj["count"] = GroupManager::countMembers(*group);
+		JsonArray members = group_obj["members"].to<JsonArray>();
+		for (uint8_t m = 0; m < PCA9685Module::MODULE_MAX; m++) {
+			for (uint16_t bits = group->masks[m]; bits; bits &= bits - 1) {
+				JsonArray member = members.add<JsonArray>();
+				member.add(m);
+				member.add(__builtin_ctz(bits));
+			}
+		}
+	}
+	
+	const GroupManager::Stats& stats = group_manager->getStats();
+	JsonObject stats_obj = doc["stats"].to<JsonObject>();
+	stats_obj["pending"] = group_manager->isPending();
+	stats_obj["operations"] = stats.operations;
+	stats_obj["last_leds"] = stats.last_leds;
+	stats_obj["last_us"] = stats.last_us;
+	stats_obj["max_us"] = stats.max_us;
+	
+	String response;
+	serializeJson(doc, response);
+	request->send(200, "application/json", response);
+}
+
+void WebServer::handleUpdateGroup(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+	JsonDocument doc;
+	if (deserializeJson(doc, (const char*)data, len)) {
+		request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid JSON\"}");
+		return;
+	}
+	
+	if (!doc["index"].is<uint8_t>() || doc["index"].as<uint8_t>() >= GroupManager::GROUP_MAX) {
+		request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid group index\"}");
+		return;
+	}
+	uint8_t group_index = doc["index"].as<uint8_t>();
+	
+	// Members are [module, led] pairs, an empty name removes the group
+	std::unique_ptr<GroupManager::Group> group(new GroupManager::Group());
+	snprintf(group->name, sizeof(group->name), "%s", doc["name"] | "");
+	if (group->name[0] != '\0') {
+		for (JsonVariantConst member : doc["members"].as<JsonArrayConst>()) {
+			if (!member[0].is<uint8_t>() || !member[1].is<uint8_t>() ||
+				!GroupManager::setMember(*group, member[0].as<uint8_t>(), member[1].as<uint8_t>(), true)) {
+				request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid member\"}");
+				return;
+			}
+		}
+	}
+	
+	// Applied and saved by the main loop, which reads the masks
+	if (!group_manager->requestGroup(group_index, *group)) {
+		request->send(409, "application/json", "{\"success\":false,\"error\":\"Group operation in progress\"}");
+		return;
+	}
+	
+	JsonDocument response_doc;
+	response_doc["success"] = true;
+	response_doc["index"] = group_index;
+	response_doc["count"] = GroupManager::countMembers(*group);
+	
+	String response;
+	serializeJson(response_doc, response);
+	request->send(200, "application/json", response);
+}
+
+void WebServer::handleApplyGroup(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+	JsonDocument doc;
+	if (deserializeJson(doc, (const char*)data, len)) {
+		request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid JSON\"}");
+		return;
+	}
+	
+	if (!doc["group"].is<uint8_t>() || !group_manager->getGroup(doc["group"].as<uint8_t>())) {
+		request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid group\"}");
+		return;
+	}
+	
+	GroupManager::Action action = {};
+	action.group = doc["group"].as<uint8_t>();
+	const char* error = groupActionFromJson(doc.as<JsonVariantConst>(), action);
+	if (error) {
+		request->send(400, "application/json", String("{\"success\":false,\"error\":\"") + error + "\"}");
+		return;
+	}
+	
+	// Applied by the main loop, right before the frame is flushed
+	if (!group_manager->requestAction(action)) {
+		request->send(409, "application/json", "{\"success\":false,\"error\":\"Group operation in progress\"}");
+		return;
+	}
+	
+	request->send(200, "application/json", "{\"success\":true}");
+}
+
+void WebServer::handleGetScenes(AsyncWebServerRequest *request) {
+	JsonDocument doc;
+	doc["scene_max"] = static_cast<uint8_t>(GroupManager::SCENE_MAX);
+	
+	JsonArray scenes = doc["scenes"].to<JsonArray>();
+	for (uint8_t i = 0; i < GroupManager::SCENE_MAX; i++) {
+		const GroupManager::Scene* scene = group_manager->getScene(i);
+		JsonObject scene_obj = scenes.add<JsonObject>();
+		scene_obj["index"] = i;
+		if (!scene) {
+			scene_obj["empty"] = true;
+			continue;
+		}
+		
+		scene_obj["empty"] = false;
+		scene_obj["name"] = scene->name;
+		JsonArray entries = scene_obj["entries"].to<JsonArray>();
+		for (uint8_t e = 0; e < scene->count; e++) {
+			const GroupManager::SceneEntry& entry = scene->entries[e];
+			JsonObject entry_obj = entries.add<JsonObject>();
+			entry_obj["group"] = entry.group;
+			entry_obj["enabled"] = entry.enabled;
+			entry_obj["brightness"] = entry.brightness;
+			entry_obj["program_type"] = entry.program;
+			entry_obj["program_name"] = program_manager->get_program_name(static_cast<ProgramType>(entry.program));
+		}
+	}
+	
+	String response;
+	serializeJson(doc, response);
+	request->send(200, "application/json", response);
+}
+
+void WebServer::handleUpdateScene(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+	JsonDocument doc;
+	if (deserializeJson(doc, (const char*)data, len)) {
+		request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid JSON\"}");
+		return;
+	}
+	
+	if (!doc["index"].is<uint8_t>() || doc["index"].as<uint8_t>() >= GroupManager::SCENE_MAX) {
+		request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid scene index\"}");
+		return;
+	}
+	uint8_t scene_index = doc["index"].as<uint8_t>();
+	
+	std::unique_ptr<GroupManager::Scene> scene(new GroupManager::Scene());
+	snprintf(scene->name, sizeof(scene->name), "%s", doc["name"] | "");
+	if (scene->name[0] != '\0') {
+		JsonArrayConst entries = doc["entries"].as<JsonArrayConst>();
+		if (entries.size() > GroupManager::GROUP_MAX) {
+			request->send(400, "application/json", "{\"success\":false,\"error\":\"Too many entries\"}");
+			return;
+		}
+		
+		// Missing fields are a snapshot of the group as it is now
+		for (JsonVariantConst entry_doc : entries) {
+			GroupManager::SceneEntry& entry = scene->entries[scene->count];
+			if (!entry_doc["group"].is<uint8_t>() || !group_manager->captureEntry(entry_doc["group"].as<uint8_t>(), entry)) {
+				request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid or empty group\"}");
+				return;
+			}
+			entry.enabled = entry_doc["enabled"] | entry.enabled;
+			entry.brightness = entry_doc["brightness"] | entry.brightness;
+			entry.program = entry_doc["program_type"] | entry.program;
+			scene->count++;
+		}
+	}
+	
+	if (!group_manager->setScene(scene_index, *scene)) {
+		request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid brightness or program\"}");
+		return;
+	}
+	StorageManager::save_scene(scene_index);
+	
+	JsonDocument response_doc;
+	response_doc["success"] = true;
+	response_doc["index"] = scene_index;
+	response_doc["count"] = scene->count;
+	
+	String response;
+	serializeJson(response_doc, response);
+	request->send(200, "application/json", response);
+}
+
+void WebServer::handleRecallScene(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+	JsonDocument doc;
+	if (deserializeJson(doc, (const char*)data, len)) {
+		request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid JSON\"}");
+		return;
+	}
+	
+	if (!doc["index"].is<uint8_t>() || !group_manager->getScene(doc["index"].as<uint8_t>())) {
+		request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid scene\"}");
+		return;
+	}
+	
+	TransitionEasing easing = EASING_LINEAR;
+	if ((!doc["transition_ms"].isNull() &&
+		(!doc["transition_ms"].is<uint32_t>() || doc["transition_ms"].as<uint32_t>() > ProgramManager::TRANSITION_MS_MAX)) ||
+		(!doc["easing"].isNull() && !ProgramManager::easing_from_name(doc["easing"].as<const char*>(), easing))) {
+		request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid transition duration or easing\"}");
+		return;
+	}
+	
+	// Applied by the main loop, right before the frame is flushed
+	if (!group_manager->requestScene(doc["index"].as<uint8_t>(), doc["transition_ms"] | 0, easing)) {
+		request->send(409, "application/json", "{\"success\":false,\"error\":\"Group operation in progress\"}");
+		return;
+	}
+	
+	request->send(200, "application/json", "{\"success\":true}");
+}
+
+void WebServer::handleGetClock(AsyncWebServerRequest *request) {
+	JsonDocument doc;
+	ScheduleManager::Clock clock = schedule_manager->getClock();
+	char time[9];
+	ScheduleManager::formatTime(clock.time_ms, time, sizeof(time));
+	doc["time"] = time;
+	doc["time_ms"] = clock.time_ms;
+	doc["ratio"] = clock.ratio;
+	doc["ratio_max"] = static_cast<uint16_t>(ScheduleManager::RATIO_MAX);
+	doc["running"] = clock.running;
+	doc["pending"] = schedule_manager->isPending();
+	
+	uint32_t next;
+	if (schedule_manager->getNextTime(next)) {
+		ScheduleManager::formatTime(next, time, sizeof(time));
+		doc["next_event"] = time;
+	} else {
+		doc["next_event"] = nullptr;
+	}
+	
+	String response;
+	serializeJson(doc, response);
+	request->send(200, "application/json", response);
+}
+
+void WebServer::handleUpdateClock(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+	JsonDocument doc;
+	if (deserializeJson(doc, (const char*)data, len)) {
+		request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid JSON\"}");
+		return;
+	}
+	
+	// Missing fields keep their current value
+	ScheduleManager::Clock clock = schedule_manager->getClock();
+	if ((!doc["time"].isNull() && !ScheduleManager::parseTime(doc["time"].as<const char*>(), clock.time_ms)) ||
+		(!doc["ratio"].isNull() && (!doc["ratio"].is<uint16_t>() || doc["ratio"].as<uint16_t>() == 0 ||
+			doc["ratio"].as<uint16_t>() > ScheduleManager::RATIO_MAX)) ||
+		(!doc["running"].isNull() && !doc["running"].is<bool>())) {
+		request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid time, ratio or running state\"}");
+		return;
+	}
+	clock.ratio = doc["ratio"] | clock.ratio;
+	clock.running = doc["running"] | clock.running;
+	
+	// Applied by the main loop
+	if (!schedule_manager->requestClock(clock)) {
+		request->send(409, "application/json", "{\"success\":false,\"error\":\"Schedule change in progress\"}");
+		return;
+	}
+	StorageManager::save_model_clock(clock);
+	
+	request->send(200, "application/json", "{\"success\":true}");
+}
+
+void WebServer::handleGetSchedule(AsyncWebServerRequest *request) {
+	JsonDocument doc;
+	doc["event_max"] = static_cast<uint8_t>(ScheduleManager::EVENT_MAX);
+	doc["jitter_max"] = static_cast<uint8_t>(ScheduleManager::JITTER_MAX);
+	
+	uint8_t count;
+	const ScheduleManager::Event* events = schedule_manager->getEvents(count);
+	JsonArray events_array = doc["events"].to<JsonArray>();
+	for (uint8_t i = 0; i < count; i++) {
+		const ScheduleManager::Event& event = events[i];
+		JsonObject event_obj = events_array.add<JsonObject>();
+		char time[9];
+		ScheduleManager::formatTime(event.minute * 60000UL, time, sizeof(time));
+		time[5] = '\0';
+		event_obj["time"] = time;
+		if (event.scene) {
+			event_obj["scene"] = event.scene_index;
+		} else {
+			event_obj["group"] = event.action.group;
+			event_obj["jitter"] = event.jitter;
+			if (event.action.set_enabled) {
+				event_obj["enabled"] = event.action.enabled;
+			}
+			if (event.action.set_brightness) {
+				event_obj["brightness"] = event.action.brightness;
+			}
+			if (event.action.set_program) {
+				event_obj["program_type"] = event.action.program;
+			}
+		}
+		event_obj["transition_ms"] = event.action.transition_ms;
+		event_obj["easing"] = program_manager->get_easing_name(static_cast<TransitionEasing>(event.action.easing));
+	}
+	
+	const ScheduleManager::Stats& stats = schedule_manager->getStats();
+	JsonObject stats_obj = doc["stats"].to<JsonObject>();
+	stats_obj["pending"] = schedule_manager->isPending();
+	stats_obj["firings"] = stats.firings;
+	stats_obj["firing_max"] = static_cast<uint16_t>(ScheduleManager::FIRING_MAX);
+	stats_obj["dropped"] = stats.dropped;
+	stats_obj["fired"] = stats.fired;
+	stats_obj["last_us"] = stats.last_us;
+	stats_obj["max_us"] = stats.max_us;
+	
+	String response;
+	serializeJson(doc, response);
+	request->send(200, "application/json", response);
+}
+
+void WebServer::handleUpdateSchedule(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+	JsonDocument doc;
+	if (deserializeJson(doc, (const char*)data, len)) {
+		request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid JSON\"}");
+		return;
+	}
+	
+	JsonArrayConst events_array = doc["events"].as<JsonArrayConst>();
+	if (events_array.size() > ScheduleManager::EVENT_MAX) {
+		request->send(400, "application/json", "{\"success\":false,\"error\":\"Too many events\"}");
+		return;
+	}
+	
+	std::unique_ptr<ScheduleManager::Event[]> events(new ScheduleManager::Event[ScheduleManager::EVENT_MAX]());
+	uint8_t count = 0;
+	for (JsonVariantConst event_doc : events_array) {
+		ScheduleManager::Event& event = events[count];
+		uint32_t time_ms;
+		if (!ScheduleManager::parseTime(event_doc["time"].as<const char*>(), time_ms) ||
+			(!event_doc["jitter"].isNull() && (!event_doc["jitter"].is<uint8_t>() ||
+				event_doc["jitter"].as<uint8_t>() > ScheduleManager::JITTER_MAX))) {
+			request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid time or jitter\"}");
+			return;
+		}
+		event.minute = time_ms / 60000;
+		event.jitter = event_doc["jitter"] | 0;
+		
+		const char* error = groupActionFromJson(event_doc, event.action);
+		if (error) {
+			request->send(400, "application/json", String("{\"success\":false,\"error\":\"") + error + "\"}");
+			return;
+		}
+		
+		// A scene is recalled at once, a group may spread its LEDs
+		event.scene = !event_doc["scene"].isNull();
+		if (event.scene) {
+			if (!event_doc["scene"].is<uint8_t>() || !group_manager->getScene(event_doc["scene"].as<uint8_t>()) || event.jitter > 0) {
+				request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid scene, or jitter on a scene\"}");
+				return;
+			}
+			event.scene_index = event_doc["scene"].as<uint8_t>();
+		} else {
+			if (!event_doc["group"].is<uint8_t>() || !group_manager->getGroup(event_doc["group"].as<uint8_t>())) {
+				request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid group\"}");
+				return;
+			}
+			event.action.group = event_doc["group"].as<uint8_t>();
+		}
+		count++;
+	}
+	
+	// Applied by the main loop
+	if (!schedule_manager->requestEvents(events.get(), count)) {
+		request->send(409, "application/json", "{\"success\":false,\"error\":\"Schedule change in progress\"}");
+		return;
+	}
+	StorageManager::save_schedule(events.get(), count);
+	
+	JsonDocument response_doc;
+	response_doc["success"] = true;
+	response_doc["count"] = count;
+	
+	String response;
+	serializeJson(response_doc, response);
+	request->send(200, "application/json", response);
+}
+
+void WebServer::handleGetInputs(AsyncWebServerRequest *request) {
+	JsonDocument doc;
+	doc["expander_max"] = static_cast<uint8_t>(InputManager::EXPANDER_MAX);
+	doc["input_max"] = static_cast<uint8_t>(InputManager::INPUT_MAX);
+	doc["trigger_max"] = static_cast<uint8_t>(InputManager::TRIGGER_MAX);
+	
+	const InputManager::Wiring& wiring = input_manager->getWiring();
+	JsonArray expanders = doc["expanders"].to<JsonArray>();
+	for (uint8_t e = 0; e < wiring.expander_count; e++) {
+		const InputManager::Expander& expander = wiring.expanders[e];
+		JsonObject expander_obj = expanders.add<JsonObject>();
+		expander_obj["address"] = expander.address;
+		expander_obj["bus"] = expander.bus;
+		if (expander.int_pin == InputManager::INT_PIN_NONE) {
+			expander_obj["int_pin"] = nullptr;
+		} else {
+			expander_obj["int_pin"] = expander.int_pin;
+		}
+	}
+	
+	JsonArray inputs = doc["inputs"].to<JsonArray>();
+	for (uint8_t i = 0; i < wiring.input_count; i++) {
+		const InputManager::Input& input = wiring.inputs[i];
+		JsonObject input_obj = inputs.add<JsonObject>();
+		input_obj["name"] = input.name;
+		if (input.source == InputManager::SOURCE_GPIO) {
+			input_obj["gpio"] = input.pin;
+		} else {
+			input_obj["expander"] = input.source;
+			input_obj["pin"] = input.pin;
+		}
+		input_obj["active_low"] = input.active_low;
+		input_obj["debounce_ms"] = input.debounce_ms;
+		input_obj["active"] = input_manager->isActive(i);
+	}
+	
+	JsonArray triggers = doc["triggers"].to<JsonArray>();
+	for (uint8_t t = 0; t < wiring.trigger_count; t++) {
+		const InputManager::Trigger& trigger = wiring.triggers[t];
+		JsonObject trigger_obj = triggers.add<JsonObject>();
+		TriggerAction action = static_cast<TriggerAction>(trigger.action);
+		trigger_obj["input"] = trigger.input;
+		trigger_obj["edge"] = InputManager::getEdgeName(static_cast<TriggerEdge>(trigger.edge));
+		trigger_obj["action"] = InputManager::getActionName(action);
+		if (action == TRIGGER_SCENE) {
+			trigger_obj["scene"] = trigger.target;
+		} else {
+			trigger_obj["group"] = trigger.target;
+		}
+		if (action == TRIGGER_START || action == TRIGGER_RETRIGGER) {
+			trigger_obj["program_type"] = trigger.program;
+		}
+		trigger_obj["delay_ms"] = trigger.delay_ms;
+	}
+	
+	const InputManager::Stats& stats = input_manager->getStats();
+	JsonObject stats_obj = doc["stats"].to<JsonObject>();
+	stats_obj["pending"] = input_manager->isPending();
+	stats_obj["interrupts"] = stats.interrupts;
+	stats_obj["edges"] = stats.edges;
+	stats_obj["bounces"] = stats.bounces;
+	stats_obj["triggers"] = stats.triggers;
+	stats_obj["overflows"] = stats.overflows;
+	stats_obj["expander_errors"] = stats.expander_errors;
+	stats_obj["last_latency_us"] = stats.last_latency_us;
+	stats_obj["max_latency_us"] = stats.max_latency_us;
+	
+	String response;
+	serializeJson(doc, response);
+	request->send(200, "application/json", response);
+}
+
+void WebServer::handleUpdateInputs(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+	JsonDocument doc;
+	if (deserializeJson(doc, (const char*)data, len)) {
+		request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid JSON\"}");
+		return;
+	}
+	
+	JsonArrayConst expanders = doc["expanders"].as<JsonArrayConst>();
+	JsonArrayConst inputs = doc["inputs"].as<JsonArrayConst>();
+	JsonArrayConst triggers = doc["triggers"].as<JsonArrayConst>();
+	if (expanders.size() > InputManager::EXPANDER_MAX || inputs.size() > InputManager::INPUT_MAX ||
+		triggers.size() > InputManager::TRIGGER_MAX) {
+		request->send(400, "application/json", "{\"success\":false,\"error\":\"Too many expanders, inputs or triggers\"}");
+		return;
+	}
+	
+	std::unique_ptr<InputManager::Wiring> wiring(new InputManager::Wiring());
+	for (JsonVariantConst expander_doc : expanders) {
+		InputManager::Expander& expander = wiring->expanders[wiring->expander_count++];
+		if (!expander_doc["address"].is<uint8_t>() || (!expander_doc["int_pin"].isNull() && !expander_doc["int_pin"].is<uint8_t>())) {
+			request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid expander\"}");
+			return;
+		}
+		expander.address = expander_doc["address"].as<uint8_t>();
+		expander.bus = expander_doc["bus"] | 0;
+		expander.int_pin = expander_doc["int_pin"] | static_cast<uint8_t>(InputManager::INT_PIN_NONE);
+	}
+	
+	for (JsonVariantConst input_doc : inputs) {
+		InputManager::Input& input = wiring->inputs[wiring->input_count++];
+		snprintf(input.name, sizeof(input.name), "%s", input_doc["name"] | "");
+		if (input_doc["gpio"].is<uint8_t>()) {
+			input.source = InputManager::SOURCE_GPIO;
+			input.pin = input_doc["gpio"].as<uint8_t>();
+		} else if (input_doc["expander"].is<uint8_t>() && input_doc["pin"].is<uint8_t>() &&
+			input_doc["expander"].as<uint8_t>() != InputManager::SOURCE_GPIO) {
+			input.source = input_doc["expander"].as<uint8_t>();
+			input.pin = input_doc["pin"].as<uint8_t>();
+		} else {
+			request->send(400, "application/json", "{\"success\":false,\"error\":\"Input needs gpio, or expander and pin\"}");
+			return;
+		}
+		input.active_low = input_doc["active_low"] | true;
+		input.debounce_ms = input_doc["debounce_ms"] | static_cast<uint16_t>(InputManager::DEBOUNCE_DEFAULT_MS);
+	}
+	
+	for (JsonVariantConst trigger_doc : triggers) {
+		InputManager::Trigger& trigger = wiring->triggers[wiring->trigger_count++];
+		TriggerEdge edge = EDGE_ACTIVE;
+		TriggerAction action = TRIGGER_START;
+		if (!trigger_doc["input"].is<uint8_t>() ||
+			(!trigger_doc["edge"].isNull() && !InputManager::edgeFromName(trigger_doc["edge"].as<const char*>(), edge)) ||
+			!InputManager::actionFromName(trigger_doc["action"].as<const char*>(), action)) {
+			request->send(400, "application/json", "{\"success\":false,\"error\":\"Trigger needs input and action, with a valid edge\"}");
+			return;
+		}
+		
+		const char* target = action == TRIGGER_SCENE ? "scene" : "group";
+		if (!trigger_doc[target].is<uint8_t>() ||
+			(!trigger_doc["program_type"].isNull() && !trigger_doc["program_type"].is<uint8_t>()) ||
+			(!trigger_doc["delay_ms"].isNull() && !trigger_doc["delay_ms"].is<uint32_t>())) {
+			request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid trigger target, program or delay\"}");
+			return;
+		}
+		trigger.input = trigger_doc["input"].as<uint8_t>();
+		trigger.edge = edge;
+		trigger.action = action;
+		trigger.target = trigger_doc[target].as<uint8_t>();
+		trigger.program = trigger_doc["program_type"] | 0;
+		trigger.delay_ms = trigger_doc["delay_ms"] | 0;
+	}
+	
+	// Checked in full here, applied by the main loop
+	String error;
+	if (!InputManager::isValidWiring(*wiring, error)) {
+		request->send(400, "application/json", String("{\"success\":false,\"error\":\"") + error + "\"}");
+		return;
+	}
+	if (!input_manager->requestWiring(*wiring)) {
+		request->send(409, "application/json", "{\"success\":false,\"error\":\"Input change in progress\"}");
+		return;
+	}
+	StorageManager::save_inputs(*wiring);
+	
+	request->send(200, "application/json", "{\"success\":true}");
+}
+
+void WebServer::handleGetShows(AsyncWebServerRequest *request) {
+	JsonDocument doc;
+	doc["directory"] = ShowPlayer::DIRECTORY;
+	
+	// Only the headers are read, shows can be larger than RAM
+	JsonArray shows = doc["shows"].to<JsonArray>();
+	File directory = LittleFS.open(ShowPlayer::DIRECTORY);
+	if (directory && directory.isDirectory()) {
+		size_t extension_length = strlen(ShowPlayer::EXTENSION);
+		for (File file = directory.openNextFile(); file; file = directory.openNextFile()) {
+			String name = file.name();
+			int slash = name.lastIndexOf('/');
+			if (slash >= 0) {
+				name = name.substring(slash + 1);
+			}
+			if (file.isDirectory() || !name.endsWith(ShowPlayer::EXTENSION)) {
+				continue;
+			}
+			name = name.substring(0, name.length() - extension_length);
+			
+			JsonObject show_obj = shows.add<JsonObject>();
+			show_obj["name"] = name;
+			show_obj["size"] = file.size();
+			uint8_t header[ShowPlayer::HEADER_SIZE];
+			uint32_t event_count = 0;
+			uint32_t duration_ms = 0;
+			bool valid = file.read(header, sizeof(header)) == sizeof(header) &&
+				ShowPlayer::parseHeader(header, event_count, duration_ms);
+			show_obj["valid"] = valid;
+			if (valid) {
+				show_obj["event_count"] = event_count;
+				show_obj["duration_ms"] = duration_ms;
+			}
+		}
+	}
+	
+	ShowPlayer::Status status = show_player->getStatus();
+	JsonObject status_obj = doc["status"].to<JsonObject>();
+	status_obj["playing"] = status.playing;
+	if (status.playing) {
+		status_obj["name"] = status.name;
+		status_obj["loop"] = status.loop;
+		status_obj["position_ms"] = status.position_ms;
+		status_obj["duration_ms"] = status.duration_ms;
+		status_obj["event_count"] = status.event_count;
+		status_obj["events_played"] = status.events_played;
+		status_obj["passes"] = status.passes;
+	}
+	
+	const ShowPlayer::Stats& stats = show_player->getStats();
+	JsonObject stats_obj = doc["stats"].to<JsonObject>();
+	stats_obj["underruns"] = stats.underruns;
+	stats_obj["refills"] = stats.refills;
+	stats_obj["late_events"] = stats.late_events;
+	stats_obj["max_late_ms"] = stats.max_late_ms;
+	stats_obj["errors"] = stats.errors;
+	
+	String response;
+	serializeJson(doc, response);
+	request->send(200, "application/json", response);
+}
+
+void WebServer::handlePlayShow(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+	JsonDocument doc;
+	if (deserializeJson(doc, (const char*)data, len)) {
+		request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid JSON\"}");
+		return;
+	}
+	
+	const char* name = doc["name"] | "";
+	if (!ShowPlayer::isValidName(name) ||
+		(!doc["start_ms"].isNull() && !doc["start_ms"].is<uint32_t>())) {
+		request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid show name or start position\"}");
+		return;
+	}
+	
+	char path[48];
+	ShowPlayer::makePath(name, path, sizeof(path));
+	if (!LittleFS.exists(path)) {
+		request->send(404, "application/json", "{\"success\":false,\"error\":\"Show not found\"}");
+		return;
+	}
+	
+	// Started by the main loop
+	if (!show_player->requestPlay(name, doc["loop"] | false, doc["start_ms"] | 0)) {
+		request->send(409, "application/json", "{\"success\":false,\"error\":\"Show change in progress\"}");
+		return;
+	}
+	
+	request->send(200, "application/json", "{\"success\":true}");
+}
+
+void WebServer::handleStopShow(AsyncWebServerRequest *request) {
+	if (!show_player->requestStop()) {
+		request->send(409, "application/json", "{\"success\":false,\"error\":\"Show change in progress\"}");
+		return;
+	}
+	
+	request->send(200, "application/json", "{\"success\":true}");
+}
+
+void WebServer::handleDeleteShow(AsyncWebServerRequest *request) {
+	String name = request->hasParam("name") ? request->getParam("name")->value() : String();
+	if (!ShowPlayer::isValidName(name.c_str())) {
+		request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid show name\"}");
+		return;
+	}
+	if (show_player->isPlaying(name.c_str())) {
+		request->send(409, "application/json", "{\"success\":false,\"error\":\"Show is playing\"}");
+		return;
+	}
+	
+	char path[48];
+	ShowPlayer::makePath(name.c_str(), path, sizeof(path));
+	if (!LittleFS.remove(path)) {
+		request->send(404, "application/json", "{\"success\":false,\"error\":\"Show not found\"}");
+		return;
+	}
+	
+	LOG_INFO("[WEBSERVER] Show %s deleted\n", name.c_str());
+	request->send(200, "application/json", "{\"success\":true}");
+}
+
+void WebServer::handleShowUpload(AsyncWebServerRequest *request, String filename, size_t index, uint8_t *data, size_t len, bool final) {
+	char path[48];
+	
+	// First chunk - check the name and the header, open a temporary file
+	if (index == 0) {
+		show_upload_error_ = "";
+		show_upload_name_ = filename;
+		if (show_upload_name_.endsWith(ShowPlayer::EXTENSION)) {
+			show_upload_name_ = show_upload_name_.substring(0, show_upload_name_.length() - strlen(ShowPlayer::EXTENSION));
+		}
+		
+		uint32_t event_count = 0;
+		uint32_t duration_ms = 0;
+		if (!ShowPlayer::isValidName(show_upload_name_.c_str())) {
+			show_upload_error_ = "Invalid show name";
+		} else if (show_player->isPlaying(show_upload_name_.c_str())) {
+			show_upload_error_ = "Show is playing";
+		} else if (len < ShowPlayer::HEADER_SIZE || !ShowPlayer::parseHeader(data, event_count, duration_ms)) {
+			show_upload_error_ = "Not a show file";
+		} else {
+			if (!LittleFS.exists(ShowPlayer::DIRECTORY)) {
+				LittleFS.mkdir(ShowPlayer::DIRECTORY);
+			}
+			snprintf(path, sizeof(path), "%s/%s.tmp", ShowPlayer::DIRECTORY, show_upload_name_.c_str());
+			show_upload_ = LittleFS.open(path, "w");
+			if (!show_upload_) {
+				show_upload_error_ = "Cannot create file";
+			}
+		}
+		
+		if (show_upload_error_.length() > 0) {
+			LOG_ERROR("[WEBSERVER] Show upload %s rejected: %s\n", filename.c_str(), show_upload_error_.c_str());
+		} else {
+			LOG_INFO("[WEBSERVER] Uploading show %s: %lu events over %lu ms\n", show_upload_name_.c_str(),
+				static_cast<unsigned long>(event_count), static_cast<unsigned long>(duration_ms));
+		}
+	}
+	
+	if (show_upload_error_.length() > 0) {
+		return;
+	}
+	
+	// Write data chunk
+	if (len > 0 && show_upload_.write(data, len) != len) {
+		show_upload_error_ = "Write failed, filesystem full?";
+		LOG_ERROR("[WEBSERVER] Show upload %s: write failed at %zu bytes\n", show_upload_name_.c_str(), index);
+	}
+	
+	// Final chunk - replace the previous version of the show
+	if (final || show_upload_error_.length() > 0) {
+		show_upload_.close();
+		char temp_path[48];
+		snprintf(temp_path, sizeof(temp_path), "%s/%s.tmp", ShowPlayer::DIRECTORY, show_upload_name_.c_str());
+		ShowPlayer::makePath(show_upload_name_.c_str(), path, sizeof(path));
+		if (show_upload_error_.length() > 0) {
+			LittleFS.remove(temp_path);
+			return;
+		}
+		LittleFS.remove(path);
+		if (!LittleFS.rename(temp_path, path)) {
+			show_upload_error_ = "Cannot rename file";
+			LittleFS.remove(temp_path);
+			return;
+		}
+		LOG_INFO("[WEBSERVER] Show %s stored (%zu bytes)\n", show_upload_name_.c_str(), index + len);
+	}
+}
+
+void WebServer::handleShowUploaded(AsyncWebServerRequest *request) {
+	JsonDocument doc;
+	bool success = show_upload_error_.length() == 0 && show_upload_name_.length() > 0;
+	doc["success"] = success;
+	if (success) {
+		doc["name"] = show_upload_name_;
+	} else {
+		doc["error"] = show_upload_error_.length() > 0 ? show_upload_error_ : String("No file received");
+	}
+	
+	String response;
+	serializeJson(doc, response);
+	request->send(success ? 200 : 400, "application/json", response);
+	show_upload_name_ = "";
+}
+
+void WebServer::handleGetLayers(AsyncWebServerRequest *request) {
+	const LayerStack::Setup& setup = layer_stack->getSetup();
+	
+	JsonDocument doc;
+	doc["pending"] = layer_stack->isPending();
+	doc["stack_max"] = static_cast<uint8_t>(LayerStack::STACK_MAX);
+	
+	JsonArray blends = doc["blend_modes"].to<JsonArray>();
+	for (uint8_t m = BLEND_MAX; m <= BLEND_OVERRIDE; m++) {
+		blends.add(LayerStack::getBlendName(static_cast<BlendMode>(m)));
+	}
+	
+	JsonArray masters = doc["masters"].to<JsonArray>();
+	for (uint8_t i = 0; i < LayerStack::MASTER_MAX; i++) {
+		JsonObject master = masters.add<JsonObject>();
+		master["index"] = i;
+		master["boot_level"] = setup.masters[i];
+		master["level"] = layer_stack->getMaster(i);
+	}
+	
+	JsonArray stacks = doc["stacks"].to<JsonArray>();
+	for (uint8_t i = 0; i < setup.count; i++) {
+		const LayerStack::Layers& layers = setup.stacks[i];
+		JsonObject stack = stacks.add<JsonObject>();
+		stack["module"] = layers.module;
+		stack["led"] = layers.led;
+		stack["attached"] = module_manager->getLED(layers.module, layers.led) != nullptr;
+		if (layers.overlay_program != PROGRAM_NONE) {
+			stack["overlay_program"] = layers.overlay_program;
+			stack["overlay_blend"] = LayerStack::getBlendName(static_cast<BlendMode>(layers.overlay_blend));
+			stack["overlay_level"] = layer_stack->getOverlayLevel(i);
+		}
+		if (layers.master != LayerStack::MASTER_NONE) {
+			stack["master"] = layers.master;
+			stack["master_blend"] = LayerStack::getBlendName(static_cast<BlendMode>(layers.master_blend));
+		}
+	}
+	
+	String response;
+	serializeJson(doc, response);
+	request->send(200, "application/json", response);
+}
+
+void WebServer::handleUpdateLayers(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+	JsonDocument doc;
+	if (deserializeJson(doc, (const char*)data, len)) {
+		request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid JSON\"}");
+		return;
+	}
+	
+	JsonArrayConst stacks = doc["stacks"].as<JsonArrayConst>();
+	JsonArrayConst masters = doc["masters"].as<JsonArrayConst>();
+	if (stacks.size() > LayerStack::STACK_MAX || masters.size() > LayerStack::MASTER_MAX) {
+		request->send(400, "application/json", "{\"success\":false,\"error\":\"Too many layer stacks or masters\"}");
+		return;
+	}
+	
+	std::unique_ptr<LayerStack::Setup> setup(new LayerStack::Setup());
+	for (uint8_t i = 0; i < LayerStack::MASTER_MAX; i++) {
+		setup->masters[i] = LED::MAX_BRIGHTNESS;
+	}
+	uint8_t master_index = 0;
+	for (JsonVariantConst master : masters) {
+		if (!master.is<uint16_t>()) {
+			request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid master level\"}");
+			return;
+		}
+		setup->masters[master_index++] = master.as<uint16_t>();
+	}
+	
+	for (JsonVariantConst stack_doc : stacks) {
+		LayerStack::Layers& layers = setup->stacks[setup->count++];
+		BlendMode overlay_blend = BLEND_MAX;
+		BlendMode master_blend = BLEND_MULTIPLY;
+		if (!stack_doc["module"].is<uint8_t>() || !stack_doc["led"].is<uint8_t>() ||
+			(!stack_doc["overlay_program"].isNull() && !stack_doc["overlay_program"].is<uint8_t>()) ||
+			(!stack_doc["master"].isNull() && !stack_doc["master"].is<uint8_t>()) ||
+			(!stack_doc["overlay_blend"].isNull() && !LayerStack::blendFromName(stack_doc["overlay_blend"].as<const char*>(), overlay_blend)) ||
+			(!stack_doc["master_blend"].isNull() && !LayerStack::blendFromName(stack_doc["master_blend"].as<const char*>(), master_blend))) {
+			request->send(400, "application/json", "{\"success\":false,\"error\":\"Layer stack needs module and led, with valid layers\"}");
+			return;
+		}
+		layers.module = stack_doc["module"].as<uint8_t>();
+		layers.led = stack_doc["led"].as<uint8_t>();
+		layers.overlay_program = stack_doc["overlay_program"] | static_cast<uint8_t>(PROGRAM_NONE);
+		layers.overlay_blend = overlay_blend;
+		layers.master = stack_doc["master"] | static_cast<uint8_t>(LayerStack::MASTER_NONE);
+		layers.master_blend = master_blend;
+	}
+	
+	// Checked in full here, applied by the main loop
+	String error;
+	if (!LayerStack::isValidSetup(*setup, error)) {
+		request->send(400, "application/json", String("{\"success\":false,\"error\":\"") + error + "\"}");
+		return;
+	}
+	if (!layer_stack->requestSetup(*setup)) {
+		request->send(409, "application/json", "{\"success\":false,\"error\":\"Layer change in progress\"}");
+		return;
+	}
+	StorageManager::save_layers(*setup);
+	
+	request->send(200, "application/json", "{\"success\":true}");
+}
+
+void WebServer::handleLayerMaster(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+	JsonDocument doc;
+	if (deserializeJson(doc, (const char*)data, len)) {
+		request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid JSON\"}");
+		return;
+	}
+	
+	if (!doc["master"].is<uint8_t>() || !doc["level"].is<uint16_t>() ||
+		doc["master"].as<uint8_t>() >= LayerStack::MASTER_MAX || doc["level"].as<uint16_t>() > LED::MAX_BRIGHTNESS) {
+		request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid master or level\"}");
+		return;
+	}
+	
+	// Applied by the main loop, every channel of the master follows in the next frame
+	if (!layer_stack->requestMaster(doc["master"].as<uint8_t>(), doc["level"].as<uint16_t>())) {
+		request->send(409, "application/json", "{\"success\":false,\"error\":\"Layer change in progress\"}");
+		return;
+	}
+	
+	request->send(200, "application/json", "{\"success\":true}");
+}
+
+void WebServer::handleGetLayerBench(AsyncWebServerRequest *request) {
+	const LayerStack::Bench& bench = layer_stack->getBench();
+	
+	JsonDocument doc;
+	doc["pending"] = layer_stack->isPending();
+	doc["rounds"] = bench.rounds;
+	doc["channels"] = static_cast<uint8_t>(LayerStack::STACK_MAX);
+	
+	if (bench.rounds > 0) {
+		uint32_t updates = static_cast<uint32_t>(bench.rounds) * LayerStack::STACK_MAX;
+		JsonArray layers = doc["layers"].to<JsonArray>();
+		for (uint8_t i = 0; i < LayerStack::LAYER_MAX; i++) {
+			JsonObject layer = layers.add<JsonObject>();
+			layer["count"] = i + 1;
+			layer["elapsed_us"] = bench.elapsed_us[i];
+			layer["ns_per_channel"] = (uint64_t)bench.elapsed_us[i] * 1000 / updates;
+			// Cost of the layer added over the previous count, close for every layer when linear
+			if (i > 0) {
+				layer["added_ns_per_channel"] = ((int64_t)bench.elapsed_us[i] - bench.elapsed_us[i - 1]) * 1000 / updates;
+			}
+		}
+		doc["heap_delta"] = bench.heap_delta;
+		doc["allocation_free"] = bench.heap_delta == 0;
+		doc["checksum"] = bench.checksum;
+	}
+	
+	String response;
+	serializeJson(doc, response);
+	request->send(200, "application/json", response);
+}
+
+void WebServer::handleLayerBench(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+	uint16_t rounds = 100;
+	
+	if (len > 0) {
+		JsonDocument doc;
+		if (deserializeJson(doc, (const char*)data, len)) {
+			request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid JSON\"}");
+			return;
+		}
+		if (doc["rounds"].is<int>()) {
+			int requested = doc["rounds"].as<int>();
+			if (requested < 1 || requested > LayerStack::BENCH_ROUNDS_MAX) {
+				request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid rounds\"}");
+				return;
+			}
+			rounds = requested;
+		}
+	}
+	
+	// Bench runs from the main loop, results are reported by GET /api/layers/bench
+	if (!layer_stack->requestBench(rounds)) {
+		request->send(409, "application/json", "{\"success\":false,\"error\":\"Layer change in progress\"}");
+		return;
+	}
+	
+	JsonDocument response_doc;
+	response_doc["success"] = true;
+	response_doc["rounds"] = rounds;
+	
+	String response;
+	serializeJson(response_doc, response);
+	request->send(202, "application/json", response);
+}
+
+void WebServer::handleOtaStatus(AsyncWebServerRequest *request) {
+	JsonDocument doc;
+	
+	doc["ota_active"] = ota_manager->isActive();
+	doc["ota_status"] = ota_manager->getStatusString();
+	doc["ota_updating"] = ota_manager->isUpdating();
+	doc["ota_progress"] = ota_manager->getProgress();
+	doc["ota_hostname"] = ota_manager->getHostname();
+	doc["ota_port"] = ota_manager->getPort();
+	doc["last_error"] = ota_manager->getLastError();
+	
+	// System health check for OTA
+	bool memory_ok = ESP.getFreeHeap() > 50000; // Need enough memory for OTA
+	doc["memory_sufficient"] = memory_ok;
+	doc["wifi_connected"] = WiFi.isConnected();
+	doc["wifi_rssi"] = WiFi.RSSI();
+	doc["ready_for_ota"] = memory_ok && WiFi.isConnected() && ota_manager->isActive();
+	
+	String response;
+	serializeJson(doc, response);
+	request->send(200, "application/json", response);
+}
+
+void WebServer::handleOtaUpload(AsyncWebServerRequest *request, String filename, size_t index, uint8_t *data, size_t len, bool final) {
+	static bool ota_started = false;
+	static size_t total_size = 0;
+	static unsigned long start_time = 0;
+	
+	// First chunk - initialize OTA
+	if (index == 0) {
+		ota_started = false;
+		total_size = request->contentLength();
+		start_time = millis();
+		
+		LOG_INFO("[WEBSERVER] Starting OTA update: %s (%zu bytes)\n", filename.c_str(), total_size);
+		
+		// Check available space
+		size_t free_space = ESP.getFreeSketchSpace();
+		if (total_size > free_space) {
+			LOG_INFO("[WEBSERVER] Error: Not enough space. Need: %zu, Available: %zu\n", total_size, free_space);
+			request->send(507, "application/json", "{\"success\":false,\"error\":\"Insufficient storage space\"}");
+			return;
+		}
+		
+		// Start update
+		if (!Update.begin(total_size)) {
+			LOG_ERROR("[WEBSERVER] Cannot start update: %s\n", Update.errorString());
+			request->send(500, "application/json", "{\"success\":false,\"error\":\"Cannot start update\"}");
+			return;
+		}
+		
+		ota_started = true;
+		LOG_INFO("[WEBSERVER] OTA update started successfully\n");
+	}
+	
+	// Write data chunk
+	if (ota_started && len > 0) {
+		size_t written = Update.write(data, len);
+		if (written != len) {
+			LOG_ERROR("[WEBSERVER] Error: Write failed. Expected: %zu, Written: %zu\n", len, written);
+			Update.abort();
+			request->send(500, "application/json", "{\"success\":false,\"error\":\"Write failed\"}");
+			return;
+		}
+		
+		// Progress logging (every 10%)
+		static uint8_t last_progress = 0;
+		uint8_t current_progress = (index + len) * 100 / total_size;
+		if (current_progress >= last_progress + 10) {
 			unsigned long elapsed = millis() - start_time;
 			size_t speed = elapsed > 0 ? ((index + len) * 1000) / elapsed : 0;
 			LOG_INFO("[WEBSERVER] OTA Progress: %u%% (%zu/%zu bytes) Speed: %zu B/s\n", 
@@ -682,14 +2684,75 @@ void WebServer::handleOtaUpload(AsyncWebServerRequest *request, String filename,
 		} else {
 			LOG_ERROR("[WEBSERVER] OTA was not properly started\n");
 		}
-		ota_started = false;
+		ota_started = false;
+	}
+}
+
+void WebServer::handleGetLogs(AsyncWebServerRequest *request) {
+	String source = request->hasParam("source") ? request->getParam("source")->value() : String("ram");
+	
+	// LittleFS log file, streamed as text by the async server
+	if (source == "file") {
+		bool previous = request->hasParam("file") && request->getParam("file")->value() == "previous";
+		const char* path = previous ? FileLogSink::PREVIOUS_PATH : FileLogSink::CURRENT_PATH;
+		if (!LittleFS.exists(path)) {
+			request->send(404, "application/json", "{\"success\":false,\"error\":\"Log file not found\"}");
+			return;
+		}
+		request->send(LittleFS, path, "text/plain");
+		return;
+	}
+	
+	// Tail of the previous boot kept in RTC memory
+	if (source == "rtc") {
+		std::vector<LogEntry> logs;
+		RtcLogTail::getPreviousBoot(logs);
+		
+		JsonDocument doc;
+		doc["source"] = "rtc";
+		doc["reset_reason"] = RtcLogTail::getResetReasonString(RtcLogTail::getResetReason());
+		doc["boot_count"] = RtcLogTail::getBootCount();
+		doc["available"] = RtcLogTail::hasPreviousBoot();
+		
+		JsonArray logs_array = doc["logs"].to<JsonArray>();
+		for (const auto& entry : logs) {
+			JsonObject log_obj = logs_array.add<JsonObject>();
+			log_obj["sequence"] = entry.sequence;
+			log_obj["timestamp"] = entry.timestamp;
+			log_obj["level"] = static_cast<int>(entry.level);
+			log_obj["message"] = entry.message;
+		}
+		doc["count"] = logs.size();
+		
+		String response;
+		serializeJson(doc, response);
+		request->send(200, "application/json", response);
+		return;
 	}
-}
-
-void WebServer::handleGetLogs(AsyncWebServerRequest *request) {
+	
+	if (source != "ram") {
+		request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid source\"}");
+		return;
+	}
+	
 	// Parse query parameters
 	int count = 0;
 	unsigned long since_timestamp = 0;
+	bool use_cursor = false;
+	uint32_t cursor = 0;
+	size_t limit = 100;
+	
+	if (request->hasParam("cursor")) {
+		use_cursor = true;
+		cursor = request->getParam("cursor")->value().toInt();
+	}
+	
+	if (request->hasParam("limit")) {
+		long value = request->getParam("limit")->value().toInt();
+		if (value > 0) {
+			limit = value;
+		}
+	}
 	
 	if (request->hasParam("count")) {
 		count = request->getParam("count")->value().toInt();
@@ -700,13 +2763,16 @@ void WebServer::handleGetLogs(AsyncWebServerRequest *request) {
 	}
 	
 	// Get logs from LogManager
+	LogManager& log_manager = LogManager::getInstance();
 	std::vector<LogEntry> logs;
-	if (since_timestamp > 0) {
-		logs = LogManager::getInstance().getLogsSince(since_timestamp);
+	if (use_cursor) {
+		log_manager.getLogsAfter(cursor, limit, logs);
+	} else if (since_timestamp > 0) {
+		logs = log_manager.getLogsSince(since_timestamp);
 	} else if (count > 0) {
-		logs = LogManager::getInstance().getRecentLogs(count);
+		logs = log_manager.getRecentLogs(count);
 	} else {
-		logs = LogManager::getInstance().getLogs();
+		logs = log_manager.getLogs();
 	}
 	
 	// Build JSON response
@@ -715,6 +2781,7 @@ void WebServer::handleGetLogs(AsyncWebServerRequest *request) {
 	
 	for (const auto& entry : logs) {
 		JsonObject log_obj = logs_array.add<JsonObject>();
+		log_obj["sequence"] = entry.sequence;
 		log_obj["timestamp"] = entry.timestamp;
 		log_obj["level"] = static_cast<int>(entry.level);
 		log_obj["message"] = entry.message;
@@ -724,19 +2791,45 @@ void WebServer::handleGetLogs(AsyncWebServerRequest *request) {
 	JsonObject stats = doc["stats"].to<JsonObject>();
 	size_t total_entries;
 	uint8_t buffer_utilization;
-	LogManager::getInstance().getBufferStats(total_entries, buffer_utilization);
+	log_manager.getBufferStats(total_entries, buffer_utilization);
 	
 	stats["total_entries"] = total_entries;
 	stats["buffer_utilization"] = buffer_utilization;
 	
 	doc["timestamp"] = millis();
 	doc["count"] = logs.size();
+	doc["last_sequence"] = log_manager.getLastSequence();
+	if (use_cursor) {
+		doc["next_cursor"] = logs.empty() ? cursor : logs.back().sequence;
+		// Entries between the cursor and the first returned one were overwritten
+		doc["gap"] = !logs.empty() && logs.front().sequence > cursor + 1;
+	}
 	
 	String response;
 	serializeJson(doc, response);
 	request->send(200, "application/json", response);
 }
 
+void WebServer::handleLogStreamConnect(AsyncEventSourceClient *client) {
+	LogManager& log_manager = LogManager::getInstance();
+	
+	// Resume after the last event the browser received, or send the recent tail
+	uint32_t cursor = client->lastId();
+	uint32_t last_sequence = log_manager.getLastSequence();
+	if (cursor == 0 || cursor > last_sequence) {
+		cursor = last_sequence > LOG_STREAM_REPLAY_MAX ? last_sequence - LOG_STREAM_REPLAY_MAX : 0;
+	}
+	
+	std::vector<LogEntry> replay;
+	log_manager.getLogsAfter(cursor, LOG_STREAM_REPLAY_MAX, replay);
+	
+	String payload;
+	for (const auto& entry : replay) {
+		serializeLogEvent(entry, payload);
+		client->send(payload.c_str(), "log", entry.sequence);
+	}
+}
+
 void WebServer::handleClearLogs(AsyncWebServerRequest *request) {
 	LogManager::getInstance().clearLogs();
 	
@@ -750,6 +2843,121 @@ void WebServer::handleClearLogs(AsyncWebServerRequest *request) {
 	request->send(200, "application/json", response);
 }
 
+void WebServer::handleGetLogLevels(AsyncWebServerRequest *request) {
+	LogManager& log_manager = LogManager::getInstance();
+	
+	JsonDocument doc;
+	doc["compiled_min_level"] = LogManager::getLevelString(static_cast<LogLevel>(LOG_MIN_LEVEL));
+	doc["default"] = LogManager::getLevelString(log_manager.getDefaultLevel());
+	
+	JsonArray tags = doc["tags"].to<JsonArray>();
+	LogManager::TagLevel tag_levels[LogManager::TAG_LEVEL_MAX];
+	size_t tag_count = log_manager.getTagLevels(tag_levels);
+	for (size_t i = 0; i < tag_count; i++) {
+		JsonObject tag_obj = tags.add<JsonObject>();
+		tag_obj["tag"] = tag_levels[i].tag;
+		tag_obj["level"] = LogManager::getLevelString(tag_levels[i].level);
+	}
+	
+	String response;
+	serializeJson(doc, response);
+	request->send(200, "application/json", response);
+}
+
+void WebServer::handleUpdateLogLevels(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+	JsonDocument doc;
+	if (deserializeJson(doc, (const char*)data, len)) {
+		request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid JSON\"}");
+		return;
+	}
+	
+	LogManager& log_manager = LogManager::getInstance();
+	LogLevel level;
+	
+	if (!doc["default"].isNull()) {
+		if (!LogManager::parseLevel(doc["default"].as<const char*>(), level)) {
+			request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid default level\"}");
+			return;
+		}
+		log_manager.setDefaultLevel(level);
+	}
+	
+	if (!doc["tag"].isNull()) {
+		const char* tag = doc["tag"].as<const char*>();
+		if (doc["level"].isNull()) {
+			log_manager.clearTagLevel(tag);
+		} else if (!LogManager::parseLevel(doc["level"].as<const char*>(), level)) {
+			request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid tag level\"}");
+			return;
+		} else if (!log_manager.setTagLevel(tag, level)) {
+			request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid tag or tag table full\"}");
+			return;
+		}
+	}
+	
+	LOG_INFO("[WEBSERVER] Log levels updated\n");
+	handleGetLogLevels(request);
+}
+
+void WebServer::handleGetLogFile(AsyncWebServerRequest *request) {
+	JsonDocument doc;
+	doc["enabled"] = StorageManager::load_log_file_enabled();
+	doc["running"] = file_log_sink && file_log_sink->isRunning();
+	doc["stopping"] = file_log_sink && file_log_sink->isStopping();
+	doc["written_bytes"] = file_log_sink ? file_log_sink->getWrittenBytes() : 0;
+	doc["dropped_lines"] = file_log_sink ? file_log_sink->getDroppedCount() : 0;
+	doc["max_file_size"] = static_cast<uint32_t>(FileLogSink::FILE_SIZE_MAX);
+	
+	JsonObject files = doc["files"].to<JsonObject>();
+	const char* paths[] = {FileLogSink::CURRENT_PATH, FileLogSink::PREVIOUS_PATH};
+	const char* names[] = {"current", "previous"};
+	for (size_t i = 0; i < 2; i++) {
+		File file = LittleFS.open(paths[i], "r");
+		files[names[i]] = file ? file.size() : 0;
+		if (file) {
+			file.close();
+		}
+	}
+	
+	String response;
+	serializeJson(doc, response);
+	request->send(200, "application/json", response);
+}
+
+void WebServer::handleUpdateLogFile(AsyncWebServerRequest *request, uint8_t *data, size_t len, size_t index, size_t total) {
+	JsonDocument doc;
+	if (deserializeJson(doc, (const char*)data, len) || !doc["enabled"].is<bool>()) {
+		request->send(400, "application/json", "{\"success\":false,\"error\":\"Invalid JSON\"}");
+		return;
+	}
+	
+	bool enabled = doc["enabled"].as<bool>();
+	if (enabled && file_log_sink && file_log_sink->isStopping()) {
+		request->send(409, "application/json", "{\"success\":false,\"error\":\"Log file still stopping\"}");
+		return;
+	}
+	if (!StorageManager::save_log_file_enabled(enabled)) {
+		request->send(500, "application/json", "{\"success\":false,\"error\":\"Failed to save setting\"}");
+		return;
+	}
+	
+	if (enabled) {
+		if (!file_log_sink) {
+			file_log_sink.reset(new FileLogSink());
+		}
+		if (!file_log_sink->begin()) {
+			request->send(500, "application/json", "{\"success\":false,\"error\":\"Failed to start log file\"}");
+			return;
+		}
+	} else if (file_log_sink) {
+		// The writer task finishes the file on its own, the request does not wait
+		file_log_sink->requestStop();
+	}
+	
+	LOG_INFO("[WEBSERVER] Log file %s\n", enabled ? "enabled" : "disabled");
+	handleGetLogFile(request);
+}
+
 // Config handlers
 
 void WebServer::handleConfigPage(AsyncWebServerRequest *request) {
@@ -931,12 +3139,36 @@ std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> We
 	};
 }
 
+std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> WebServer::createUpdateModulePwmHandler() {
+	return [this](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
+		this->handleUpdateModulePwm(request, data, len, index, total);
+	};
+}
+
+std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> WebServer::createModuleCalibrateHandler() {
+	return [this](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
+		this->handleModuleCalibrate(request, data, len, index, total);
+	};
+}
+
+std::function<void(AsyncWebServerRequest*)> WebServer::createModuleCalibrationHandler() {
+	return [this](AsyncWebServerRequest* request) {
+		this->handleGetModuleCalibration(request);
+	};
+}
+
 std::function<void(AsyncWebServerRequest*)> WebServer::createModulesHandler() {
 	return [this](AsyncWebServerRequest* request) {
 		this->handleGetModules(request);
 	};
 }
 
+std::function<void(AsyncWebServerRequest*)> WebServer::createForgetModuleHandler() {
+	return [this](AsyncWebServerRequest* request) {
+		this->handleForgetModule(request);
+	};
+}
+
 std::function<void(AsyncWebServerRequest*)> WebServer::createLedsHandler() {
 	return [this](AsyncWebServerRequest* request) {
 		this->handleGetLeds(request);
@@ -949,6 +3181,228 @@ std::function<void(AsyncWebServerRequest*)> WebServer::createProgramsHandler() {
 	};
 }
 
+std::function<void(AsyncWebServerRequest*)> WebServer::createEffectsHandler() {
+	return [this](AsyncWebServerRequest* request) {
+		this->handleGetEffects(request);
+	};
+}
+
+std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> WebServer::createUpdateEffectHandler() {
+	return [this](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
+		this->handleUpdateEffect(request, data, len, index, total);
+	};
+}
+
+std::function<void(AsyncWebServerRequest*)> WebServer::createEffectBenchResultsHandler() {
+	return [this](AsyncWebServerRequest* request) {
+		this->handleGetEffectBench(request);
+	};
+}
+
+std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> WebServer::createEffectBenchHandler() {
+	return [this](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
+		this->handleEffectBench(request, data, len, index, total);
+	};
+}
+
+std::function<void(AsyncWebServerRequest*)> WebServer::createGroupsHandler() {
+	return [this](AsyncWebServerRequest* request) {
+		this->handleGetGroups(request);
+	};
+}
+
+std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> WebServer::createUpdateGroupHandler() {
+	return [this](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
+		this->handleUpdateGroup(request, data, len, index, total);
+	};
+}
+
+std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> WebServer::createApplyGroupHandler() {
+	return [this](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
+		this->handleApplyGroup(request, data, len, index, total);
+	};
+}
+
+std::function<void(AsyncWebServerRequest*)> WebServer::createScenesHandler() {
+	return [this](AsyncWebServerRequest* request) {
+		this->handleGetScenes(request);
+	};
+}
+
+std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> WebServer::createUpdateSceneHandler() {
+	return [this](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
+		this->handleUpdateScene(request, data, len, index, total);
+	};
+}
+
+std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> WebServer::createRecallSceneHandler() {
+	return [this](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
+		this->handleRecallScene(request, data, len, index, total);
+	};
+}
+
+std::function<void(AsyncWebServerRequest*)> WebServer::createClockHandler() {
+	return [this](AsyncWebServerRequest* request) {
+		this->handleGetClock(request);
+	};
+}
+
+std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> WebServer::createUpdateClockHandler() {
+	return [this](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
+		this->handleUpdateClock(request, data, len, index, total);
+	};
+}
+
+std::function<void(AsyncWebServerRequest*)> WebServer::createScheduleHandler() {
+	return [this](AsyncWebServerRequest* request) {
+		this->handleGetSchedule(request);
+	};
+}
+
+std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> WebServer::createUpdateScheduleHandler() {
+	return [this](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
+		this->handleUpdateSchedule(request, data, len, index, total);
+	};
+}
+
+std::function<void(AsyncWebServerRequest*)> WebServer::createInputsHandler() {
+	return [this](AsyncWebServerRequest* request) {
+		this->handleGetInputs(request);
+	};
+}
+
+std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> WebServer::createUpdateInputsHandler() {
+	return [this](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
+		this->handleUpdateInputs(request, data, len, index, total);
+	};
+}
+
+std::function<void(AsyncWebServerRequest*)> WebServer::createShowsHandler() {
+	return [this](AsyncWebServerRequest* request) {
+		this->handleGetShows(request);
+	};
+}
+
+std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> WebServer::createPlayShowHandler() {
+	return [this](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
+		this->handlePlayShow(request, data, len, index, total);
+	};
+}
+
+std::function<void(AsyncWebServerRequest*)> WebServer::createStopShowHandler() {
+	return [this](AsyncWebServerRequest* request) {
+		this->handleStopShow(request);
+	};
+}
+
+std::function<void(AsyncWebServerRequest*)> WebServer::createDeleteShowHandler() {
+	return [this](AsyncWebServerRequest* request) {
+		this->handleDeleteShow(request);
+	};
+}
+
+std::function<void(AsyncWebServerRequest*, String, size_t, uint8_t*, size_t, bool)> WebServer::createShowUploadHandler() {
+	return [this](AsyncWebServerRequest* request, String filename, size_t index, uint8_t* data, size_t len, bool final) {
+		this->handleShowUpload(request, filename, index, data, len, final);
+	};
+}
+
+std::function<void(AsyncWebServerRequest*)> WebServer::createShowUploadedHandler() {
+	return [this](AsyncWebServerRequest* request) {
+		this->handleShowUploaded(request);
+	};
+}
+
+std::function<void(AsyncWebServerRequest*)> WebServer::createLayersHandler() {
+	return [this](AsyncWebServerRequest* request) {
+		this->handleGetLayers(request);
+	};
+}
+
+std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> WebServer::createUpdateLayersHandler() {
+	return [this](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
+		this->handleUpdateLayers(request, data, len, index, total);
+	};
+}
+
+std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> WebServer::createLayerMasterHandler() {
+	return [this](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
+		this->handleLayerMaster(request, data, len, index, total);
+	};
+}
+
+std::function<void(AsyncWebServerRequest*)> WebServer::createLayerBenchResultsHandler() {
+	return [this](AsyncWebServerRequest* request) {
+		this->handleGetLayerBench(request);
+	};
+}
+
+std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> WebServer::createLayerBenchHandler() {
+	return [this](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
+		this->handleLayerBench(request, data, len, index, total);
+	};
+}
+
+std::function<void(AsyncWebServerRequest*)> WebServer::createI2cHandler() {
+	return [this](AsyncWebServerRequest* request) {
+		this->handleGetI2c(request);
+	};
+}
+
+std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> WebServer::createUpdateI2cHandler() {
+	return [this](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
+		this->handleUpdateI2c(request, data, len, index, total);
+	};
+}
+
+std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> WebServer::createI2cBenchHandler() {
+	return [this](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
+		this->handleI2cBench(request, data, len, index, total);
+	};
+}
+
+std::function<void(AsyncWebServerRequest*)> WebServer::createBroadcastHandler() {
+	return [this](AsyncWebServerRequest* request) {
+		this->handleGetBroadcast(request);
+	};
+}
+
+std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> WebServer::createBroadcastActionHandler() {
+	return [this](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
+		this->handleBroadcastAction(request, data, len, index, total);
+	};
+}
+
+std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> WebServer::createUpdateBroadcastGroupsHandler() {
+	return [this](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
+		this->handleUpdateBroadcastGroups(request, data, len, index, total);
+	};
+}
+
+std::function<void(AsyncWebServerRequest*)> WebServer::createCurvesHandler() {
+	return [this](AsyncWebServerRequest* request) {
+		this->handleGetCurves(request);
+	};
+}
+
+std::function<void(AsyncWebServerRequest*)> WebServer::createPowerHandler() {
+	return [this](AsyncWebServerRequest* request) {
+		this->handleGetPower(request);
+	};
+}
+
+std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> WebServer::createUpdatePowerHandler() {
+	return [this](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
+		this->handleUpdatePower(request, data, len, index, total);
+	};
+}
+
+std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> WebServer::createUpdateCurvesHandler() {
+	return [this](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
+		this->handleUpdateCurves(request, data, len, index, total);
+	};
+}
+
 std::function<void(AsyncWebServerRequest*)> WebServer::createOtaStatusHandler() {
 	return [this](AsyncWebServerRequest* request) {
 		this->handleOtaStatus(request);
@@ -973,6 +3427,30 @@ std::function<void(AsyncWebServerRequest*)> WebServer::createClearLogsHandler()
 	};
 }
 
+std::function<void(AsyncWebServerRequest*)> WebServer::createLogLevelsHandler() {
+	return [this](AsyncWebServerRequest* request) {
+		this->handleGetLogLevels(request);
+	};
+}
+
+std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> WebServer::createUpdateLogLevelsHandler() {
+	return [this](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
+		this->handleUpdateLogLevels(request, data, len, index, total);
+	};
+}
+
+std::function<void(AsyncWebServerRequest*)> WebServer::createLogFileHandler() {
+	return [this](AsyncWebServerRequest* request) {
+		this->handleGetLogFile(request);
+	};
+}
+
+std::function<void(AsyncWebServerRequest*, uint8_t*, size_t, size_t, size_t)> WebServer::createUpdateLogFileHandler() {
+	return [this](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
+		this->handleUpdateLogFile(request, data, len, index, total);
+	};
+}
+
 std::function<void(AsyncWebServerRequest*)> WebServer::createConfigPageHandler() {
 	return [this](AsyncWebServerRequest* request) {
 		this->handleConfigPage(request);
@@ -0,0 +1,156 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Jérôme SONRIER
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * @file test_curve.cpp
+ * @brief Host tests of the brightness transfer curves and temporal dithering
+ *
+ * Run with: pio test -e native
+ *
+ * @author  Jérôme SONRIER <jsid@emor3j.fr.eu.org>
+ * @date    2025-10-17
+ */
+
+#include <string.h>
+#include <unity.h>
+
+#include "curve.h"
+
+
+/// Curves with a table of their own
+static const CurveType CURVES[] = {CURVE_LINEAR, CURVE_GAMMA22, CURVE_CIE, CURVE_CUSTOM};
+
+/// Frames averaged per level by the dithering test
+static const uint16_t DITHER_FRAMES = 64;
+
+void setUp() {}
+
+void tearDown() {}
+
+// === Curves ===
+
+void test_linear_is_identity() {
+	for (uint16_t level = 0; level < BrightnessCurve::LEVELS; level++) {
+		TEST_ASSERT_EQUAL_UINT16(level << BrightnessCurve::FRACTION_BITS, BrightnessCurve::applyIntensity(CURVE_LINEAR, level));
+		TEST_ASSERT_EQUAL_UINT16(level, BrightnessCurve::apply(CURVE_LINEAR, level));
+	}
+}
+
+void test_tables_are_monotonic_and_keep_lit_levels_lit() {
+	for (CurveType curve : CURVES) {
+		TEST_ASSERT_EQUAL_UINT16(0, BrightnessCurve::applyIntensity(curve, 0));
+		TEST_ASSERT_EQUAL_UINT16(BrightnessCurve::INTENSITY_MAX, BrightnessCurve::applyIntensity(curve, BrightnessCurve::LEVEL_MAX));
+
+		uint16_t previous = 0;
+		for (uint16_t level = 1; level < BrightnessCurve::LEVELS; level++) {
+			uint16_t intensity = BrightnessCurve::applyIntensity(curve, level);
+			TEST_ASSERT_TRUE(intensity >= previous);
+			TEST_ASSERT_TRUE(BrightnessCurve::apply(curve, level) > 0);
+			previous = intensity;
+		}
+	}
+}
+
+void test_levels_above_range_are_clamped() {
+	TEST_ASSERT_EQUAL_UINT16(BrightnessCurve::INTENSITY_MAX, BrightnessCurve::applyIntensity(CURVE_GAMMA22, 5000));
+	TEST_ASSERT_EQUAL_UINT16(BrightnessCurve::LEVEL_MAX, BrightnessCurve::apply(CURVE_LINEAR, 0xFFFF));
+}
+
+void test_to_duty_rounds_and_keeps_one_step() {
+	TEST_ASSERT_EQUAL_UINT16(0, BrightnessCurve::toDuty(0));
+	TEST_ASSERT_EQUAL_UINT16(1, BrightnessCurve::toDuty(1));
+	TEST_ASSERT_EQUAL_UINT16(1, BrightnessCurve::toDuty(23));
+	TEST_ASSERT_EQUAL_UINT16(2, BrightnessCurve::toDuty(24));
+	TEST_ASSERT_EQUAL_UINT16(BrightnessCurve::LEVEL_MAX, BrightnessCurve::toDuty(BrightnessCurve::INTENSITY_MAX));
+}
+
+// === Custom curve ===
+
+void test_custom_points_are_interpolated() {
+	uint16_t points[BrightnessCurve::CUSTOM_POINTS];
+	for (uint8_t i = 0; i < BrightnessCurve::CUSTOM_POINTS; i++) {
+		points[i] = (i + 1 == BrightnessCurve::CUSTOM_POINTS) ? BrightnessCurve::LEVEL_MAX : i * BrightnessCurve::CUSTOM_POINT_STEP / 2;
+	}
+	TEST_ASSERT_TRUE(BrightnessCurve::setCustomPoints(points));
+
+	// On the points, then halfway between two of them
+	TEST_ASSERT_EQUAL_UINT16(points[1], BrightnessCurve::apply(CURVE_CUSTOM, BrightnessCurve::CUSTOM_POINT_STEP));
+	TEST_ASSERT_EQUAL_UINT16((points[1] + points[2]) << (BrightnessCurve::FRACTION_BITS - 1),
+		BrightnessCurve::applyIntensity(CURVE_CUSTOM, BrightnessCurve::CUSTOM_POINT_STEP * 3 / 2));
+	TEST_ASSERT_EQUAL_MEMORY(points, BrightnessCurve::getCustomPoints(), sizeof(points));
+}
+
+void test_custom_points_out_of_range_are_rejected() {
+	uint16_t points[BrightnessCurve::CUSTOM_POINTS] = {};
+	points[3] = BrightnessCurve::LEVELS;
+	TEST_ASSERT_FALSE(BrightnessCurve::setCustomPoints(points));
+	TEST_ASSERT_FALSE(BrightnessCurve::setCustomPoints(nullptr));
+}
+
+// === Dithering ===
+
+void test_dither_average_error_within_half_step() {
+	for (CurveType curve : CURVES) {
+		for (uint16_t level = 0; level < BrightnessCurve::LEVELS; level++) {
+			uint16_t intensity = BrightnessCurve::applyIntensity(curve, level);
+
+			// Every starting state, as a channel would have mid-fade
+			for (uint8_t start = 0; start < BrightnessCurve::FRACTION_ONE; start++) {
+				uint8_t error = start;
+				uint32_t sum = 0;
+				for (uint16_t frame = 0; frame < DITHER_FRAMES; frame++) {
+					uint16_t duty = BrightnessCurve::ditherStep(intensity, error);
+					TEST_ASSERT_TRUE(duty == (intensity >> BrightnessCurve::FRACTION_BITS) ||
+						duty == (intensity >> BrightnessCurve::FRACTION_BITS) + 1);
+					sum += duty;
+				}
+
+				// |average - exact| <= 1/2 step, in intensity units
+				int32_t deviation = static_cast<int32_t>(sum << BrightnessCurve::FRACTION_BITS) - static_cast<int32_t>(intensity) * DITHER_FRAMES;
+				TEST_ASSERT_TRUE(deviation <= BrightnessCurve::FRACTION_ONE / 2 * DITHER_FRAMES);
+				TEST_ASSERT_TRUE(-deviation <= BrightnessCurve::FRACTION_ONE / 2 * DITHER_FRAMES);
+			}
+		}
+	}
+}
+
+void test_dither_is_exact_over_one_cycle() {
+	for (uint16_t intensity = 0; intensity <= BrightnessCurve::INTENSITY_MAX; intensity++) {
+		uint8_t error = 0;
+		uint32_t sum = 0;
+		for (uint8_t frame = 0; frame < BrightnessCurve::FRACTION_ONE; frame++) {
+			sum += BrightnessCurve::ditherStep(intensity, error);
+		}
+		TEST_ASSERT_EQUAL_UINT32(intensity, sum);
+		TEST_ASSERT_EQUAL_UINT8(0, error);
+	}
+}
+
+// === Names ===
+
+void test_names_round_trip() {
+	for (uint8_t i = 0; i < BrightnessCurve::CURVE_TYPE_COUNT; i++) {
+		CurveType curve = CURVE_LINEAR;
+		TEST_ASSERT_TRUE(BrightnessCurve::fromName(BrightnessCurve::getName(static_cast<CurveType>(i)), curve));
+		TEST_ASSERT_EQUAL_UINT8(i, curve);
+	}
+
+	CurveType curve = CURVE_LINEAR;
+	TEST_ASSERT_FALSE(BrightnessCurve::fromName("gamma", curve));
+	TEST_ASSERT_FALSE(BrightnessCurve::fromName(nullptr, curve));
+	TEST_ASSERT_EQUAL_UINT8(CURVE_LINEAR, curve);
+}
+
+int main(int argc, char** argv) {
+	UNITY_BEGIN();
+	RUN_TEST(test_linear_is_identity);
+	RUN_TEST(test_tables_are_monotonic_and_keep_lit_levels_lit);
+	RUN_TEST(test_levels_above_range_are_clamped);
+	RUN_TEST(test_to_duty_rounds_and_keeps_one_step);
+	RUN_TEST(test_custom_points_are_interpolated);
+	RUN_TEST(test_custom_points_out_of_range_are_rejected);
+	RUN_TEST(test_dither_average_error_within_half_step);
+	RUN_TEST(test_dither_is_exact_over_one_cycle);
+	RUN_TEST(test_names_round_trip);
+	return UNITY_END();
+}
@@ -0,0 +1,320 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Jérôme SONRIER
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * @file test_effect.cpp
+ * @brief Host tests of the effect bytecode compiler and interpreter
+ *
+ * Run with: pio test -e native
+ *
+ * @author  Jérôme SONRIER <jsid@emor3j.fr.eu.org>
+ * @date    2025-10-17
+ */
+
+#include <string.h>
+#include <unity.h>
+
+#include "effect.h"
+
+
+/// Bytecode under construction
+static uint8_t code[EffectVM::INSTRUCTIONS_MAX * EffectVM::INSTRUCTION_SIZE + EffectVM::INSTRUCTION_SIZE];
+
+/// Number of bytes of the bytecode under construction
+static size_t code_size;
+
+/// Last compilation error
+static char error[EffectVM::ERROR_MAX];
+
+static EffectVM::Program program;
+static EffectVM::State state;
+static EffectVM::Stats stats;
+
+void setUp() {
+	code_size = 0;
+	error[0] = '\0';
+	memset(&program, 0, sizeof(program));
+	memset(&stats, 0, sizeof(stats));
+}
+
+void tearDown() {}
+
+/**
+ * @brief Append one instruction to the bytecode
+ */
+static void emit(uint8_t op, uint8_t arg, uint16_t value, uint16_t param) {
+	uint8_t* p = code + code_size;
+	p[0] = op;
+	p[1] = arg;
+	p[2] = value & 0xFF;
+	p[3] = value >> 8;
+	p[4] = param & 0xFF;
+	p[5] = param >> 8;
+	code_size += EffectVM::INSTRUCTION_SIZE;
+}
+
+static bool compile(uint8_t budget = EffectVM::BUDGET_DEFAULT) {
+	return EffectVM::compile(code, code_size, budget, program, error, sizeof(error));
+}
+
+// === Compilation ===
+
+void test_rejects_bad_size_and_budget() {
+	TEST_ASSERT_FALSE(compile());
+
+	emit(EFFECT_END, 0, 0, 0);
+	TEST_ASSERT_FALSE(EffectVM::compile(code, code_size - 1, EffectVM::BUDGET_DEFAULT, program, error, sizeof(error)));
+	TEST_ASSERT_FALSE(compile(0));
+	TEST_ASSERT_FALSE(compile(EffectVM::BUDGET_MAX + 1));
+	TEST_ASSERT_TRUE(compile(EffectVM::BUDGET_MAX));
+
+	for (uint8_t i = 0; i < EffectVM::INSTRUCTIONS_MAX; i++) {
+		emit(EFFECT_END, 0, 0, 0);
+	}
+	TEST_ASSERT_FALSE(compile());
+}
+
+void test_rejects_invalid_operands() {
+	emit(EFFECT_HOLD, 0, 100, 0);
+	emit(EFFECT_SET, 0, EffectVM::LEVEL_MAX + 1, 0);
+	emit(EFFECT_END, 0, 0, 0);
+	TEST_ASSERT_FALSE(compile());
+	TEST_ASSERT_EQUAL_STRING("Instruction 1: level out of range", error);
+
+	setUp();
+	emit(EFFECT_RANDOM, 0, 200, 100);
+	emit(EFFECT_END, 0, 0, 0);
+	TEST_ASSERT_FALSE(compile());
+
+	// Loops go backwards only, on one of the counters
+	setUp();
+	emit(EFFECT_HOLD, 0, 100, 0);
+	emit(EFFECT_LOOP, 0, 2, 0);
+	emit(EFFECT_END, 0, 0, 0);
+	TEST_ASSERT_FALSE(compile());
+
+	setUp();
+	emit(EFFECT_HOLD, 0, 100, 0);
+	emit(EFFECT_LOOP, EffectVM::LOOP_COUNTERS, 0, 0);
+	TEST_ASSERT_FALSE(compile());
+
+	setUp();
+	emit(EFFECT_JUMP, 101, 0, 0);
+	emit(EFFECT_END, 0, 0, 0);
+	TEST_ASSERT_FALSE(compile());
+
+	setUp();
+	emit(EFFECT_JUMP, 50, 2, 0);
+	emit(EFFECT_END, 0, 0, 0);
+	TEST_ASSERT_FALSE(compile());
+
+	setUp();
+	emit(7, 0, 0, 0);
+	TEST_ASSERT_FALSE(compile());
+	TEST_ASSERT_EQUAL_STRING("Instruction 0: unknown operation 7", error);
+}
+
+void test_rejects_running_past_the_end() {
+	emit(EFFECT_SET, 0, 100, 0);
+	TEST_ASSERT_FALSE(compile());
+
+	// A finite loop falls through once done
+	setUp();
+	emit(EFFECT_HOLD, 0, 100, 0);
+	emit(EFFECT_LOOP, 0, 0, 3);
+	TEST_ASSERT_FALSE(compile());
+
+	setUp();
+	emit(EFFECT_HOLD, 0, 100, 0);
+	emit(EFFECT_LOOP, 0, 0, 0);
+	TEST_ASSERT_TRUE(compile());
+}
+
+void test_rejects_loops_without_timed_instruction() {
+	emit(EFFECT_SET, 0, 100, 0);
+	emit(EFFECT_RAMP, 0, 0, 0);
+	emit(EFFECT_JUMP, 100, 0, 0);
+	TEST_ASSERT_FALSE(compile());
+	TEST_ASSERT_EQUAL_STRING("Instruction 0: loop without ramp or hold", error);
+
+	// A hold with only a random extra may take no time either
+	setUp();
+	emit(EFFECT_HOLD, 0, 0, 100);
+	emit(EFFECT_LOOP, 0, 0, 0);
+	TEST_ASSERT_FALSE(compile());
+
+	setUp();
+	emit(EFFECT_SET, 0, 100, 0);
+	emit(EFFECT_RAMP, 0, 0, 10);
+	emit(EFFECT_JUMP, 100, 0, 0);
+	TEST_ASSERT_TRUE(compile());
+}
+
+void test_encode_round_trip() {
+	emit(EFFECT_SET, 0, 1000, 0);
+	emit(EFFECT_RAMP, 0, 4095, 250);
+	emit(EFFECT_HOLD, 0, 300, 1200);
+	emit(EFFECT_RANDOM, 0, 10, 20);
+	emit(EFFECT_JUMP, 30, 0, 0);
+	emit(EFFECT_LOOP, 2, 1, 0);
+	TEST_ASSERT_TRUE(compile(8));
+	TEST_ASSERT_EQUAL_UINT8(6, program.length);
+	TEST_ASSERT_EQUAL_UINT8(8, program.budget);
+
+	uint8_t out[sizeof(code)];
+	TEST_ASSERT_EQUAL_UINT32(code_size, EffectVM::encode(program, out));
+	TEST_ASSERT_EQUAL_MEMORY(code, out, code_size);
+}
+
+void test_parse_hex() {
+	uint8_t out[4];
+	size_t size;
+	TEST_ASSERT_TRUE(EffectVM::parseHex("01 ff\n0A", out, sizeof(out), size));
+	TEST_ASSERT_EQUAL_UINT32(3, size);
+	TEST_ASSERT_EQUAL_UINT8(0x01, out[0]);
+	TEST_ASSERT_EQUAL_UINT8(0xFF, out[1]);
+	TEST_ASSERT_EQUAL_UINT8(0x0A, out[2]);
+
+	TEST_ASSERT_FALSE(EffectVM::parseHex("012", out, sizeof(out), size));
+	TEST_ASSERT_FALSE(EffectVM::parseHex("0g", out, sizeof(out), size));
+	TEST_ASSERT_FALSE(EffectVM::parseHex("0102030405", out, sizeof(out), size));
+	TEST_ASSERT_FALSE(EffectVM::parseHex(nullptr, out, sizeof(out), size));
+}
+
+// === Execution ===
+
+void test_ramps_and_loops() {
+	emit(EFFECT_SET, 0, 1000, 0);
+	emit(EFFECT_RAMP, 0, 0, 100);
+	emit(EFFECT_RAMP, 0, 1000, 100);
+	emit(EFFECT_LOOP, 0, 1, 3);
+	emit(EFFECT_END, 0, 0, 0);
+	TEST_ASSERT_TRUE(compile());
+	EffectVM::start(state, &program, 0);
+
+	uint16_t level = EffectVM::step(state, 0, 0, &stats);
+	TEST_ASSERT_EQUAL_UINT16(1000, level);
+	TEST_ASSERT_EQUAL_UINT16(500, EffectVM::step(state, level, 50, &stats));
+	TEST_ASSERT_EQUAL_UINT16(0, EffectVM::step(state, level, 100, &stats));
+	TEST_ASSERT_EQUAL_UINT16(500, EffectVM::step(state, level, 150, &stats));
+
+	// Three passes of the block end at 600 ms
+	TEST_ASSERT_EQUAL_UINT16(0, EffectVM::step(state, level, 500, &stats));
+	TEST_ASSERT_FALSE(state.halted);
+	TEST_ASSERT_EQUAL_UINT16(1000, EffectVM::step(state, level, 600, &stats));
+	TEST_ASSERT_TRUE(state.halted);
+
+	// The LED keeps its level once halted
+	TEST_ASSERT_EQUAL_UINT16(1234, EffectVM::step(state, 1234, 700, &stats));
+}
+
+void test_late_updates_catch_up_without_drift() {
+	emit(EFFECT_SET, 0, 1000, 0);
+	emit(EFFECT_RAMP, 0, 0, 100);
+	emit(EFFECT_RAMP, 0, 1000, 100);
+	emit(EFFECT_LOOP, 0, 1, 3);
+	emit(EFFECT_END, 0, 0, 0);
+	TEST_ASSERT_TRUE(compile());
+	EffectVM::start(state, &program, 0);
+
+	uint16_t level = EffectVM::step(state, 0, 0, &stats);
+	TEST_ASSERT_EQUAL_UINT16(1000, EffectVM::step(state, level, 650, &stats));
+	TEST_ASSERT_TRUE(state.halted);
+}
+
+void test_far_late_updates_resync() {
+	emit(EFFECT_HOLD, 0, 100, 0);
+	emit(EFFECT_SET, 0, 4000, 0);
+	emit(EFFECT_HOLD, 0, 100, 0);
+	emit(EFFECT_SET, 0, 0, 0);
+	emit(EFFECT_END, 0, 0, 0);
+	TEST_ASSERT_TRUE(compile());
+	EffectVM::start(state, &program, 0);
+
+	uint16_t level = EffectVM::step(state, 0, 0, &stats);
+	uint32_t late = 100 + EffectVM::RESYNC_MS + 400;
+
+	// Timing restarts from now: the second hold runs in full
+	level = EffectVM::step(state, level, late, &stats);
+	TEST_ASSERT_EQUAL_UINT16(4000, level);
+	TEST_ASSERT_EQUAL_UINT16(4000, EffectVM::step(state, level, late + 99, &stats));
+	TEST_ASSERT_EQUAL_UINT16(0, EffectVM::step(state, level, late + 100, &stats));
+	TEST_ASSERT_TRUE(state.halted);
+}
+
+void test_random_levels_stay_in_range() {
+	emit(EFFECT_RANDOM, 0, 100, 200);
+	emit(EFFECT_HOLD, 0, 10, 5);
+	emit(EFFECT_LOOP, 0, 0, 0);
+	TEST_ASSERT_TRUE(compile());
+	EffectVM::start(state, &program, 0);
+
+	uint16_t level = 0;
+	for (uint32_t now = 0; now < 10000; now += 5) {
+		level = EffectVM::step(state, level, now, &stats);
+		TEST_ASSERT_TRUE(level >= 100 && level <= 200);
+	}
+	TEST_ASSERT_FALSE(state.halted);
+}
+
+void test_jump_probabilities() {
+	emit(EFFECT_JUMP, 0, 0, 0);
+	emit(EFFECT_JUMP, 100, 3, 0);
+	emit(EFFECT_SET, 0, 1, 0);
+	emit(EFFECT_SET, 0, 7, 0);
+	emit(EFFECT_END, 0, 0, 0);
+	TEST_ASSERT_TRUE(compile());
+	EffectVM::start(state, &program, 0);
+
+	TEST_ASSERT_EQUAL_UINT16(7, EffectVM::step(state, 0, 0, &stats));
+	TEST_ASSERT_TRUE(state.halted);
+	TEST_ASSERT_EQUAL_UINT32(4, stats.instructions);
+}
+
+void test_budget_limits_instructions_per_update() {
+	for (uint8_t i = 0; i < 20; i++) {
+		emit(EFFECT_SET, 0, i * 10, 0);
+	}
+	emit(EFFECT_END, 0, 0, 0);
+	TEST_ASSERT_TRUE(compile(4));
+	EffectVM::start(state, &program, 0);
+
+	uint16_t level = EffectVM::step(state, 0, 0, &stats);
+	TEST_ASSERT_EQUAL_UINT16(30, level);
+	TEST_ASSERT_EQUAL_UINT32(1, stats.overruns);
+	TEST_ASSERT_EQUAL_UINT8(4, stats.max_per_update);
+
+	// The remaining instructions run over the next updates
+	for (uint8_t i = 0; i < 5; i++) {
+		level = EffectVM::step(state, level, 0, &stats);
+	}
+	TEST_ASSERT_EQUAL_UINT16(190, level);
+	TEST_ASSERT_TRUE(state.halted);
+	TEST_ASSERT_EQUAL_UINT32(6, stats.updates);
+	TEST_ASSERT_EQUAL_UINT32(21, stats.instructions);
+	TEST_ASSERT_EQUAL_UINT32(5, stats.overruns);
+}
+
+void test_stopped_effect_keeps_level() {
+	EffectVM::start(state, nullptr, 0);
+	TEST_ASSERT_EQUAL_UINT16(42, EffectVM::step(state, 42, 100, &stats));
+	TEST_ASSERT_EQUAL_UINT32(0, stats.updates);
+}
+
+int main(int argc, char** argv) {
+	UNITY_BEGIN();
+	RUN_TEST(test_rejects_bad_size_and_budget);
+	RUN_TEST(test_rejects_invalid_operands);
+	RUN_TEST(test_rejects_running_past_the_end);
+	RUN_TEST(test_rejects_loops_without_timed_instruction);
+	RUN_TEST(test_encode_round_trip);
+	RUN_TEST(test_parse_hex);
+	RUN_TEST(test_ramps_and_loops);
+	RUN_TEST(test_late_updates_catch_up_without_drift);
+	RUN_TEST(test_far_late_updates_resync);
+	RUN_TEST(test_random_levels_stay_in_range);
+	RUN_TEST(test_jump_probabilities);
+	RUN_TEST(test_budget_limits_instructions_per_update);
+	RUN_TEST(test_stopped_effect_keeps_level);
+	return UNITY_END();
+}
@@ -0,0 +1,109 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Jérôme SONRIER
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * @file test_layer.cpp
+ * @brief Host tests of the layer blend modes
+ *
+ * Run with: pio test -e native
+ *
+ * @author  Jérôme SONRIER <jsid@emor3j.fr.eu.org>
+ * @date    2025-10-17
+ */
+
+#include <unity.h>
+
+#include "blend.h"
+
+
+/// Every blend mode
+static const BlendMode MODES[] = {BLEND_MAX, BLEND_MULTIPLY, BLEND_ADD, BLEND_OVERRIDE};
+
+/// Level step of the range sweeps
+static const uint16_t SWEEP_STEP = 7;
+
+void setUp() {}
+
+void tearDown() {}
+
+// === Modes ===
+
+void test_max_keeps_the_brighter_level() {
+	TEST_ASSERT_EQUAL_UINT16(LayerBlend::LEVEL_MAX, LayerBlend::blend(BLEND_MAX, 0, LayerBlend::LEVEL_MAX));
+	TEST_ASSERT_EQUAL_UINT16(LayerBlend::LEVEL_MAX, LayerBlend::blend(BLEND_MAX, LayerBlend::LEVEL_MAX, 0));
+	TEST_ASSERT_EQUAL_UINT16(200, LayerBlend::blend(BLEND_MAX, 100, 200));
+	TEST_ASSERT_EQUAL_UINT16(0, LayerBlend::blend(BLEND_MAX, 0, 0));
+}
+
+void test_multiply_full_is_identity_and_zero_is_off() {
+	for (uint16_t level = 0; level <= LayerBlend::LEVEL_MAX; level++) {
+		TEST_ASSERT_EQUAL_UINT16(level, LayerBlend::blend(BLEND_MULTIPLY, level, LayerBlend::LEVEL_MAX));
+		TEST_ASSERT_EQUAL_UINT16(level, LayerBlend::blend(BLEND_MULTIPLY, LayerBlend::LEVEL_MAX, level));
+		TEST_ASSERT_EQUAL_UINT16(0, LayerBlend::blend(BLEND_MULTIPLY, level, 0));
+		TEST_ASSERT_EQUAL_UINT16(0, LayerBlend::blend(BLEND_MULTIPLY, 0, level));
+	}
+}
+
+void test_multiply_scales_linearly() {
+	// Half level: within one step of lower / 2
+	for (uint16_t level = 0; level <= LayerBlend::LEVEL_MAX; level++) {
+		int32_t half = LayerBlend::blend(BLEND_MULTIPLY, level, 2047);
+		TEST_ASSERT_TRUE(half - level / 2 >= -1 && half - level / 2 <= 1);
+	}
+}
+
+void test_add_clamps_to_full_level() {
+	TEST_ASSERT_EQUAL_UINT16(3000, LayerBlend::blend(BLEND_ADD, 1000, 2000));
+	TEST_ASSERT_EQUAL_UINT16(LayerBlend::LEVEL_MAX, LayerBlend::blend(BLEND_ADD, 4000, 200));
+	TEST_ASSERT_EQUAL_UINT16(LayerBlend::LEVEL_MAX, LayerBlend::blend(BLEND_ADD, 4000, 95));
+	TEST_ASSERT_EQUAL_UINT16(LayerBlend::LEVEL_MAX, LayerBlend::blend(BLEND_ADD, LayerBlend::LEVEL_MAX, LayerBlend::LEVEL_MAX));
+	TEST_ASSERT_EQUAL_UINT16(1234, LayerBlend::blend(BLEND_ADD, 1234, 0));
+}
+
+void test_override_with_zero_keeps_lower() {
+	TEST_ASSERT_EQUAL_UINT16(1234, LayerBlend::blend(BLEND_OVERRIDE, 1234, 0));
+	TEST_ASSERT_EQUAL_UINT16(1, LayerBlend::blend(BLEND_OVERRIDE, 1234, 1));
+	TEST_ASSERT_EQUAL_UINT16(LayerBlend::LEVEL_MAX, LayerBlend::blend(BLEND_OVERRIDE, 0, LayerBlend::LEVEL_MAX));
+	TEST_ASSERT_EQUAL_UINT16(0, LayerBlend::blend(BLEND_OVERRIDE, 0, 0));
+}
+
+void test_unknown_mode_keeps_lower() {
+	TEST_ASSERT_EQUAL_UINT16(1234, LayerBlend::blend(BLEND_OVERRIDE + 1, 1234, 4000));
+	TEST_ASSERT_EQUAL_UINT16(1234, LayerBlend::blend(0xFF, 1234, 0));
+}
+
+// === Range ===
+
+void test_results_stay_in_range() {
+	for (BlendMode mode : MODES) {
+		for (uint32_t lower = 0; lower <= LayerBlend::LEVEL_MAX; lower += SWEEP_STEP) {
+			for (uint32_t upper = 0; upper <= LayerBlend::LEVEL_MAX; upper += SWEEP_STEP) {
+				TEST_ASSERT_TRUE(LayerBlend::blend(mode, lower, upper) <= LayerBlend::LEVEL_MAX);
+			}
+		}
+	}
+}
+
+void test_stacked_layers() {
+	// Candle at 3000, flash overlay at 4000 (max), district master at half (multiply)
+	uint16_t level = LayerBlend::blend(BLEND_MAX, 3000, 4000);
+	level = LayerBlend::blend(BLEND_MULTIPLY, level, 2047);
+	TEST_ASSERT_EQUAL_UINT16(2000, level);
+
+	// Master off turns the channel off whatever the layers below
+	level = LayerBlend::blend(BLEND_ADD, 3000, 4000);
+	TEST_ASSERT_EQUAL_UINT16(0, LayerBlend::blend(BLEND_MULTIPLY, level, 0));
+}
+
+int main(int argc, char** argv) {
+	UNITY_BEGIN();
+	RUN_TEST(test_max_keeps_the_brighter_level);
+	RUN_TEST(test_multiply_full_is_identity_and_zero_is_off);
+	RUN_TEST(test_multiply_scales_linearly);
+	RUN_TEST(test_add_clamps_to_full_level);
+	RUN_TEST(test_override_with_zero_keeps_lower);
+	RUN_TEST(test_unknown_mode_keeps_lower);
+	RUN_TEST(test_results_stay_in_range);
+	RUN_TEST(test_stacked_layers);
+	return UNITY_END();
+}
@@ -0,0 +1,167 @@
+/**
+ * SPDX-FileCopyrightText: 2025 Jérôme SONRIER
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ *
+ * @file test_pwm_phase.cpp
+ * @brief Host tests of the PWM phase offsets
+ *
+ * Simulates one PWM period of every channel, as the PCA9685 counters run
+ * when synchronized, and checks that the phase offsets bring the number of
+ * channels on at once down to the expected bound.
+ *
+ * Run with: pio test -e native
+ *
+ * @author  Jérôme SONRIER <jsid@emor3j.fr.eu.org>
+ * @date    2025-10-17
+ */
+
+#include <string.h>
+#include <unity.h>
+
+#include "pwm_phase.h"
+
+
+/// Channel counts simulated: one module, a small and a full layout
+static const uint16_t CHANNEL_COUNTS[] = {16, 100, 256};
+
+/// Uniform levels simulated
+static const uint16_t LEVELS[] = {1, 256, 1024, 2048, 3072, 4000};
+
+/// Per-tick difference of the number of channels on (one extra entry for the period end)
+static int16_t ticks[PwmPhase::STEPS + 1];
+
+void setUp() {
+	memset(ticks, 0, sizeof(ticks));
+}
+
+void tearDown() {}
+
+/**
+ * @brief Add the ON interval of a channel to the tick differences
+ *
+ * +1 at the ON tick and -1 at the OFF tick, two intervals when OFF wraps
+ * before ON.
+ */
+static void addChannel(uint16_t on, uint16_t off) {
+	if (on == PwmPhase::STEPS) {
+		// FULL ON
+		ticks[0]++;
+		ticks[PwmPhase::STEPS]--;
+	} else if (off == PwmPhase::STEPS || on == off) {
+		// FULL OFF
+	} else if (on < off) {
+		ticks[on]++;
+		ticks[off]--;
+	} else {
+		ticks[on]++;
+		ticks[PwmPhase::STEPS]--;
+		ticks[0]++;
+		ticks[off]--;
+	}
+}
+
+/**
+ * @brief Simulate a uniform level on every channel
+ * @param channels Channel count
+ * @param level Level of every channel
+ * @param staggered true to use the phase offsets, false for ON at tick 0
+ * @return Peak number of channels on at once
+ */
+static uint16_t simulatePeak(uint16_t channels, uint16_t level, bool staggered) {
+	memset(ticks, 0, sizeof(ticks));
+	for (uint16_t i = 0; i < channels; i++) {
+		uint16_t on, off;
+		PwmPhase::encode(level, staggered ? PwmPhase::getOffset(i, channels) : 0, on, off);
+		addChannel(on, off);
+	}
+
+	int16_t count = 0;
+	uint16_t peak = 0;
+	for (uint16_t tick = 0; tick < PwmPhase::STEPS; tick++) {
+		count += ticks[tick];
+		if (count > peak) {
+			peak = count;
+		}
+	}
+	return peak;
+}
+
+// === Encoding ===
+
+void test_encode_full_off_and_full_on() {
+	uint16_t on, off;
+	PwmPhase::encode(0, 1000, on, off);
+	TEST_ASSERT_EQUAL_UINT16(0, on);
+	TEST_ASSERT_EQUAL_UINT16(PwmPhase::STEPS, off);
+
+	PwmPhase::encode(PwmPhase::LEVEL_MAX, 1000, on, off);
+	TEST_ASSERT_EQUAL_UINT16(PwmPhase::STEPS, on);
+	TEST_ASSERT_EQUAL_UINT16(0, off);
+}
+
+void test_encode_wraps_off_around_the_period() {
+	uint16_t on, off;
+	PwmPhase::encode(1000, 100, on, off);
+	TEST_ASSERT_EQUAL_UINT16(100, on);
+	TEST_ASSERT_EQUAL_UINT16(1100, off);
+
+	PwmPhase::encode(1000, 3500, on, off);
+	TEST_ASSERT_EQUAL_UINT16(3500, on);
+	TEST_ASSERT_EQUAL_UINT16(404, off);
+}
+
+// === Offsets ===
+
+void test_offsets_are_evenly_spaced() {
+	for (uint16_t channels : CHANNEL_COUNTS) {
+		TEST_ASSERT_EQUAL_UINT16(0, PwmPhase::getOffset(0, channels));
+		for (uint16_t i = 1; i < channels; i++) {
+			uint16_t gap = PwmPhase::getOffset(i, channels) - PwmPhase::getOffset(i - 1, channels);
+			TEST_ASSERT_TRUE(gap == PwmPhase::STEPS / channels || gap == PwmPhase::STEPS / channels + 1);
+		}
+		TEST_ASSERT_TRUE(PwmPhase::getOffset(channels - 1, channels) < PwmPhase::STEPS);
+	}
+	TEST_ASSERT_EQUAL_UINT16(0, PwmPhase::getOffset(0, 0));
+}
+
+// === Simulated load ===
+
+void test_aligned_channels_all_switch_on_together() {
+	for (uint16_t channels : CHANNEL_COUNTS) {
+		for (uint16_t level : LEVELS) {
+			TEST_ASSERT_EQUAL_UINT16(channels, simulatePeak(channels, level, false));
+		}
+	}
+}
+
+void test_staggered_peak_within_expected_bound() {
+	for (uint16_t channels : CHANNEL_COUNTS) {
+		for (uint16_t level : LEVELS) {
+			uint16_t peak = simulatePeak(channels, level, true);
+			TEST_ASSERT_TRUE(peak <= PwmPhase::getExpectedPeak(channels, level));
+		}
+	}
+}
+
+void test_staggered_peak_drops_at_low_levels() {
+	// 256 channels at 1/16 duty: 16 overlap instead of 256
+	TEST_ASSERT_EQUAL_UINT16(256, simulatePeak(256, 256, false));
+	TEST_ASSERT_TRUE(simulatePeak(256, 256, true) <= 17);
+}
+
+void test_full_on_is_not_staggered() {
+	TEST_ASSERT_EQUAL_UINT16(100, simulatePeak(100, PwmPhase::LEVEL_MAX, true));
+	TEST_ASSERT_EQUAL_UINT16(100, PwmPhase::getExpectedPeak(100, PwmPhase::LEVEL_MAX));
+}
+
+int main(int argc, char** argv) {
+	UNITY_BEGIN();
+	RUN_TEST(test_encode_full_off_and_full_on);
+	RUN_TEST(test_encode_wraps_off_around_the_period);
+	RUN_TEST(test_offsets_are_evenly_spaced);
+	RUN_TEST(test_aligned_channels_all_switch_on_together);
+	RUN_TEST(test_staggered_peak_within_expected_bound);
+	RUN_TEST(test_staggered_peak_drops_at_low_levels);
+	RUN_TEST(test_full_on_is_not_staggered);
+	return UNITY_END();
+}
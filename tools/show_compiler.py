@@ -0,0 +1,245 @@
+#!/usr/bin/env python3
+# SPDX-FileCopyrightText: 2025 Jérôme SONRIER
+# SPDX-License-Identifier: GPL-3.0-or-later
+"""
+Compile a human-readable light show timeline into the binary format
+played by ShowPlayer (see include/show.h).
+
+Timeline syntax, one statement per line, '#' starts a comment:
+
+    duration 02:30                      # length of one pass (default: last event)
+    define windows 0:0-7, 1:0-3         # named channel set
+    define street 2:*
+
+    00:00      off      windows,street
+    00:01.500  set      windows  50%    fade 2s  in_out
+    00:04      program  street   french_crossing
+    00:10.250  set      0:5      4095
+    00:12      off      windows  fade 500ms
+
+Times are [[HH:]MM:]SS[.mmm] from the start of the show. Channels are
+"module:led", "module:first-last", "module:*" or defined names, separated
+by commas. "set" takes a brightness (0-4095 or a percentage), "program" a
+program number or name, "off" nothing. "set" and "off" accept
+"fade <duration>" (ms or s suffix, 65535 ms at most) and an easing
+(linear, in, out, in_out).
+
+Usage: show_compiler.py timeline.txt [-o evening.show]
+       show_compiler.py --dump evening.show
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+MAGIC = b"EMSH"
+VERSION = 1
+HEADER = struct.Struct("<4sBBHII")
+RECORD = struct.Struct("<IHHBBBB")
+CHANNEL = struct.Struct("<BH")
+
+MODULE_MAX = 62
+LED_MAX = 16
+MAX_BRIGHTNESS = 4095
+TRANSITION_MAX_MS = 0xFFFF
+
+ACTIONS = {"set": 0, "program": 1, "off": 2}
+EASINGS = {"linear": 0, "in": 1, "out": 2, "in_out": 3}
+PROGRAMS = {
+    "none": 0, "welding": 1, "heartbeat": 2, "breathing": 3, "simple_blink": 4,
+    "tv_flicker": 5, "firebox_glow": 6, "candle_flicker": 7,
+    "french_crossing": 8, "custom": 9,
+}
+
+
+class TimelineError(Exception):
+    pass
+
+
+def parse_time(text):
+    match = re.fullmatch(r"(?:(?:(\d+):)?(\d+):)?(\d+)(?:\.(\d{1,3}))?", text)
+    if not match:
+        raise TimelineError(f"invalid time '{text}'")
+    hours, minutes, seconds, fraction = match.groups()
+    millis = int((fraction or "0").ljust(3, "0"))
+    return ((int(hours or 0) * 60 + int(minutes or 0)) * 60 + int(seconds)) * 1000 + millis
+
+
+def parse_duration(text):
+    match = re.fullmatch(r"(\d+(?:\.\d+)?)(ms|s)", text)
+    if not match:
+        raise TimelineError(f"invalid duration '{text}' (use 500ms or 1.5s)")
+    value = float(match.group(1)) * (1000 if match.group(2) == "s" else 1)
+    if value > TRANSITION_MAX_MS:
+        raise TimelineError(f"fade '{text}' longer than {TRANSITION_MAX_MS} ms")
+    return int(round(value))
+
+
+def parse_channels(text, defines):
+    """Return {module: mask} for a comma separated channel list."""
+    masks = {}
+    for item in (part.strip() for part in text.split(",")):
+        if not item:
+            continue
+        if item in defines:
+            for module, mask in defines[item].items():
+                masks[module] = masks.get(module, 0) | mask
+            continue
+        match = re.fullmatch(r"(\d+):(\*|\d+)(?:-(\d+))?", item)
+        if not match:
+            raise TimelineError(f"invalid channel '{item}'")
+        module = int(match.group(1))
+        if match.group(2) == "*":
+            first, last = 0, LED_MAX - 1
+        else:
+            first = int(match.group(2))
+            last = int(match.group(3)) if match.group(3) else first
+        if module >= MODULE_MAX or first > last or last >= LED_MAX:
+            raise TimelineError(f"channel '{item}' out of range")
+        mask = ((1 << (last + 1)) - 1) & ~((1 << first) - 1)
+        masks[module] = masks.get(module, 0) | mask
+    if not masks:
+        raise TimelineError("empty channel set")
+    return masks
+
+
+def parse_value(action, text):
+    if action == "set":
+        if text.endswith("%"):
+            value = round(float(text[:-1]) * MAX_BRIGHTNESS / 100)
+        else:
+            value = int(text)
+        if not 0 <= value <= MAX_BRIGHTNESS:
+            raise TimelineError(f"brightness '{text}' out of range")
+        return value
+    value = PROGRAMS.get(text.lower())
+    if value is None:
+        value = int(text) if text.isdigit() else -1
+    if not 0 <= value <= max(PROGRAMS.values()):
+        raise TimelineError(f"unknown program '{text}'")
+    return value
+
+
+def compile_timeline(lines):
+    defines = {}
+    events = []
+    duration = None
+
+    for number, raw in enumerate(lines, 1):
+        line = raw.split("#", 1)[0].strip()
+        if not line:
+            continue
+        try:
+            words = line.split(None, 2)
+            if words[0] == "duration":
+                duration = parse_time(words[1])
+                continue
+            if words[0] == "define":
+                if len(words) < 3:
+                    raise TimelineError("define needs a name and channels")
+                defines[words[1]] = parse_channels(words[2], defines)
+                continue
+
+            time = parse_time(words[0])
+            action = words[1].lower() if len(words) > 1 else ""
+            if action not in ACTIONS:
+                raise TimelineError(f"unknown action '{action}'")
+            rest = words[2].split() if len(words) > 2 else []
+            if not rest:
+                raise TimelineError("missing channels")
+
+            # Channel lists may contain spaces after commas
+            channels = rest.pop(0)
+            while channels.endswith(",") and rest:
+                channels += rest.pop(0)
+            masks = parse_channels(channels, defines)
+
+            value = 0
+            if action != "off":
+                if not rest:
+                    raise TimelineError(f"{action} needs a value")
+                value = parse_value(action, rest.pop(0))
+
+            transition = 0
+            easing = 0
+            while rest:
+                word = rest.pop(0).lower()
+                if word == "fade" and rest and action != "program":
+                    transition = parse_duration(rest.pop(0))
+                elif word in EASINGS:
+                    easing = EASINGS[word]
+                else:
+                    raise TimelineError(f"unexpected '{word}'")
+
+            events.append((time, number, ACTIONS[action], easing, value, transition, masks))
+        except (TimelineError, ValueError, IndexError) as error:
+            raise TimelineError(f"line {number}: {error}") from None
+
+    # Stable by line for events of the same time
+    events.sort(key=lambda event: (event[0], event[1]))
+    last = events[-1][0] if events else 0
+    if duration is None:
+        duration = last
+    elif duration < last:
+        raise TimelineError(f"duration {duration} ms ends before the last event ({last} ms)")
+    return events, duration
+
+
+def encode(events, duration):
+    out = bytearray(HEADER.pack(MAGIC, VERSION, 0, 0, len(events), duration))
+    for time, _, action, easing, value, transition, masks in events:
+        out += RECORD.pack(time, transition, value, action, easing, len(masks), 0)
+        for module in sorted(masks):
+            out += CHANNEL.pack(module, masks[module])
+    return bytes(out)
+
+
+def dump(data):
+    magic, version, _, _, count, duration = HEADER.unpack_from(data, 0)
+    if magic != MAGIC or version != VERSION:
+        raise TimelineError("not a show file")
+    print(f"{count} events, {duration} ms")
+    names = {value: name for name, value in ACTIONS.items()}
+    offset = HEADER.size
+    for _ in range(count):
+        time, transition, value, action, easing, channels, _ = RECORD.unpack_from(data, offset)
+        offset += RECORD.size
+        masks = []
+        for _ in range(channels):
+            module, mask = CHANNEL.unpack_from(data, offset)
+            offset += CHANNEL.size
+            masks.append(f"{module}:{mask:016b}")
+        print(f"{time:>9} {names.get(action, action):<8} {value:>5} {transition:>6}ms {' '.join(masks)}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compile a light show timeline for ShowPlayer")
+    parser.add_argument("input", help="timeline text file, or show file with --dump")
+    parser.add_argument("-o", "--output", help="output file (default: input name with .show)")
+    parser.add_argument("--dump", action="store_true", help="print the events of a compiled show")
+    args = parser.parse_args()
+
+    try:
+        if args.dump:
+            with open(args.input, "rb") as file:
+                dump(file.read())
+            return 0
+
+        with open(args.input, encoding="utf-8") as file:
+            events, duration = compile_timeline(file)
+        if not events:
+            raise TimelineError("no events")
+        output = args.output or re.sub(r"\.[^./]*$", "", args.input) + ".show"
+        data = encode(events, duration)
+        with open(output, "wb") as file:
+            file.write(data)
+        print(f"{output}: {len(events)} events, {duration} ms, {len(data)} bytes")
+        return 0
+    except TimelineError as error:
+        print(f"error: {error}", file=sys.stderr)
+        return 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())